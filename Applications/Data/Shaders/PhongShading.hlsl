@@ -21,6 +21,15 @@ cbuffer LightParameters
 	float4 LightColor;
 };
 
+#ifdef INSTANCED
+// When instanced, the world matrix of each instance is read from the vertex
+// input instead, and combined with the shared view projection matrix.
+cbuffer InstanceTransforms
+{
+	matrix ViewProjMatrix;
+};
+#endif
+
 
 
 //--------------------------------------------------------------------------------
@@ -29,7 +38,17 @@ cbuffer LightParameters
 struct VS_INPUT
 {
 	float3 position 		: POSITION;
+#ifdef OCTAHEDRAL_NORMALS
+	float2 normal			: NORMAL;
+#else
 	float3 normal			: NORMAL;
+#endif
+#ifdef INSTANCED
+	float4 world0			: INSTANCE_WORLD0;
+	float4 world1			: INSTANCE_WORLD1;
+	float4 world2			: INSTANCE_WORLD2;
+	float4 world3			: INSTANCE_WORLD3;
+#endif
 };
 //--------------------------------------------------------------------------------
 struct VS_OUTPUT
@@ -38,13 +57,33 @@ struct VS_OUTPUT
 	float4 color			: COLOR;
 };
 //--------------------------------------------------------------------------------
+float3 DecodeOctahedral( float2 e )
+{
+	// Geometry packed with VertexPacking::Octahedral stores its normals as two
+	// snorm values, which unfold back into a unit vector here.
+	float3 n = float3( e.xy, 1.0f - abs( e.x ) - abs( e.y ) );
+	float t = saturate( -n.z );
+	n.xy += ( n.xy >= 0.0f ) ? -t : t;
+	return( normalize( n ) );
+}
+//--------------------------------------------------------------------------------
 VS_OUTPUT VSMAIN( in VS_INPUT input )
 {
 	VS_OUTPUT output;
 	
+#ifdef INSTANCED
+	matrix World = matrix( input.world0, input.world1, input.world2, input.world3 );
+	output.position = mul( mul( float4( input.position, 1.0f ), World ), ViewProjMatrix );
+#else
+	matrix World = WorldMatrix;
 	output.position = mul( float4( input.position, 1.0f ), WorldViewProjMatrix );
+#endif
 
-	float3 NormalWS = mul( input.normal, (float3x3)WorldMatrix );
+#ifdef OCTAHEDRAL_NORMALS
+	float3 NormalWS = mul( DecodeOctahedral( input.normal ), (float3x3)World );
+#else
+	float3 NormalWS = mul( input.normal, (float3x3)World );
+#endif
 	//float diffuse = dot( normalize( LightPositionWS ), NormalWS );
 	float diffuse = dot( normalize( float3( 1.0f, 1.0f, -1.0f ) ), NormalWS );
 
@@ -75,7 +75,7 @@ void ViewGBuffer::ExecuteTask( PipelineManagerDX11* pPipelineManager, IParameter
 		SetRenderParams( pParamManager );
 
 		// Run through the graph and render each of the entities
-		m_pScene->GetRoot()->Render( pPipelineManager, pParamManager, VT_GBUFFER );
+		RenderScene( pPipelineManager, pParamManager, VT_GBUFFER );
 	}
 }
 //--------------------------------------------------------------------------------
@@ -75,7 +75,7 @@ void ViewFinalPass::ExecuteTask( PipelineManagerDX11* pPipelineManager, IParamet
         SetRenderParams( pParamManager );
 
         // Run through the graph and render each of the entities
-        m_pScene->GetRoot()->Render( pPipelineManager, pParamManager, VT_FINALPASS );
+        RenderScene( pPipelineManager, pParamManager, VT_FINALPASS );
     }
 }
 //--------------------------------------------------------------------------------
@@ -127,7 +127,7 @@ void ViewGBuffer::ExecuteTask( PipelineManagerDX11* pPipelineManager, IParameter
 		SetRenderParams( pParamManager );
 
 		// Run through the graph and render each of the entities
-		m_pScene->GetRoot()->Render( pPipelineManager, pParamManager, VT_GBUFFER );
+		RenderScene( pPipelineManager, pParamManager, VT_GBUFFER );
 
         // Now that we've filled the G-Buffer, we'll generate a stencil mask
         // that masks out all pixels where the individual sub-samples aren't
@@ -0,0 +1,104 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "AdjacencyBenchmark.h"
+#include "GeometryDX11.h"
+
+#include <sstream>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+AdjacencyBenchmark::AdjacencyBenchmark( unsigned int triangles, unsigned int threads ) :
+	m_uiTriangles( triangles ),
+	m_uiThreads( threads > 0 ? threads : 1 ),
+	m_uiOpenEdges( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+std::wstring AdjacencyBenchmark::GetName()
+{
+	std::wstringstream name;
+	name << L"Adjacency/" << m_uiTriangles << L"/" << m_uiThreads << ( m_uiThreads > 1 ? L" threads" : L" thread" );
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+unsigned int AdjacencyBenchmark::GetIterations()
+{
+	return( 10 );
+}
+//--------------------------------------------------------------------------------
+bool AdjacencyBenchmark::Setup( App& app )
+{
+	app.SetThreadCount( m_uiThreads );
+
+	// A square grid with two triangles per cell, and at least the requested
+	// number of triangles.
+
+	unsigned int cells = 1;
+	while ( 2 * cells * cells < m_uiTriangles )
+		cells++;
+
+	const unsigned int side = cells + 1;
+
+	m_Indices.clear();
+	m_Indices.reserve( 6 * cells * cells );
+
+	for ( unsigned int y = 0; y < cells; y++ )
+	{
+		for ( unsigned int x = 0; x < cells; x++ )
+		{
+			const UINT corner = y * side + x;
+
+			m_Indices.push_back( corner );
+			m_Indices.push_back( corner + side );
+			m_Indices.push_back( corner + 1 );
+
+			m_Indices.push_back( corner + 1 );
+			m_Indices.push_back( corner + side );
+			m_Indices.push_back( corner + side + 1 );
+		}
+	}
+
+	m_Adjacent.resize( m_Indices.size() );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void AdjacencyBenchmark::Run( App& app )
+{
+	GeometryDX11::FindAdjacentVertices( &m_Indices[0], static_cast<unsigned int>( m_Indices.size() ), &m_Adjacent[0] );
+}
+//--------------------------------------------------------------------------------
+void AdjacencyBenchmark::Shutdown( App& app )
+{
+	// An edge without a neighbour gets its own start vertex.
+
+	m_uiOpenEdges = 0;
+
+	for ( unsigned int i = 0; i < m_Adjacent.size(); i++ )
+	{
+		if ( m_Adjacent[i] == m_Indices[i] )
+			m_uiOpenEdges++;
+	}
+
+	m_Indices.clear();
+	m_Adjacent.clear();
+
+	app.SetThreadCount( 0 );
+}
+//--------------------------------------------------------------------------------
+std::wstring AdjacencyBenchmark::GetReport()
+{
+	std::wstringstream report;
+	report << L"Open edges: " << m_uiOpenEdges;
+
+	return( report.str() );
+}
+//--------------------------------------------------------------------------------
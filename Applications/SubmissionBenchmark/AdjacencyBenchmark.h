@@ -0,0 +1,50 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// AdjacencyBenchmark
+//
+// Finds the adjacent vertices of every triangle of a grid mesh with
+// GeometryDX11::FindAdjacentVertices, which is what GenerateAdjacency and the
+// PLY loader use.  The case runs with a given number of threads, where a single
+// thread runs without a job system, to show how the search scales.  The report
+// gives the number of edges without a neighbour, which are the edges around
+// the border of the grid.
+//--------------------------------------------------------------------------------
+#ifndef AdjacencyBenchmark_h
+#define AdjacencyBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+//--------------------------------------------------------------------------------
+class AdjacencyBenchmark : public BenchmarkCase
+{
+public:
+	AdjacencyBenchmark( unsigned int triangles, unsigned int threads );
+
+	virtual std::wstring GetName();
+	virtual unsigned int GetIterations();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+	virtual std::wstring GetReport();
+
+protected:
+	unsigned int		m_uiTriangles;
+	unsigned int		m_uiThreads;
+	unsigned int		m_uiOpenEdges;
+
+	std::vector<UINT>	m_Indices;
+	std::vector<UINT>	m_Adjacent;
+};
+//--------------------------------------------------------------------------------
+#endif // AdjacencyBenchmark_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,310 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "App.h"
+#include "Log.h"
+#include "ParameterNameTable.h"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include "Texture2dConfigDX11.h"
+#include "SceneFrameBenchmark.h"
+#include "EventQueueBenchmark.h"
+#include "MatrixBenchmark.h"
+#include "SceneUpdateBenchmark.h"
+#include "ParameterLookupBenchmark.h"
+#include "StateArrayBenchmark.h"
+#include "LogThroughputBenchmark.h"
+#include "AdjacencyBenchmark.h"
+#include "PackingBenchmark.h"
+#include "GeometryCacheBenchmark.h"
+#include "StreamingBenchmark.h"
+#include "StlBenchmark.h"
+#include "ObjBenchmark.h"
+#include "PlyBenchmark.h"
+#include "SkeletonBenchmark.h"
+#include "TaskGraphBenchmark.h"
+#include "BvhBenchmark.h"
+#include "RingAllocatorBenchmark.h"
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+int wmain( int argc, wchar_t* argv[] )
+{
+	App app;
+
+	if ( !app.ConfigureEngineComponents() )
+	{
+		app.ShutdownEngineComponents();
+		return( -1 );
+	}
+
+	// Create the benchmark cases.  They are run in the order that they are
+	// added here.
+
+	app.AddBenchmark( new SceneFrameBenchmark( 1000 ) );
+	app.AddBenchmark( new SceneFrameBenchmark( 10000 ) );
+	app.AddBenchmark( new SceneFrameBenchmark( 100000 ) );
+	app.AddBenchmark( new EventQueueBenchmark( 1, 100000 ) );
+	app.AddBenchmark( new EventQueueBenchmark( 4, 100000 ) );
+
+	app.AddBenchmark( new ParameterLookupBenchmark( 10000, false ) );
+	app.AddBenchmark( new ParameterLookupBenchmark( 10000, true ) );
+
+	app.AddBenchmark( new StateArrayBenchmark( 10000, false ) );
+	app.AddBenchmark( new StateArrayBenchmark( 10000, true ) );
+
+	app.AddBenchmark( new LogThroughputBenchmark( 1, 1000 ) );
+	app.AddBenchmark( new LogThroughputBenchmark( 4, 1000 ) );
+
+	app.AddBenchmark( new MatrixBenchmark( MATRIX_MULTIPLY, 100000 ) );
+	app.AddBenchmark( new MatrixBenchmark( MATRIX_INVERSE, 100000 ) );
+	app.AddBenchmark( new MatrixBenchmark( MATRIX_TRANSFORM_LOOP, 100000 ) );
+	app.AddBenchmark( new MatrixBenchmark( MATRIX_TRANSFORM_VECTORS, 100000 ) );
+	app.AddBenchmark( new MatrixBenchmark( MATRIX_TRANSFORM_POINTS, 100000 ) );
+
+	app.AddBenchmark( new PackingBenchmark( 1024 ) );
+
+	app.AddBenchmark( new RingAllocatorBenchmark( 1024 * 1024, 3 ) );
+	app.AddBenchmark( new RingAllocatorBenchmark( 256 * 1024, 6 ) );
+
+	app.AddBenchmark( new GeometryCacheBenchmark( L"Sample_Scene.ms3d", false ) );
+	app.AddBenchmark( new GeometryCacheBenchmark( L"Sample_Scene.ms3d", true ) );
+	app.AddBenchmark( new GeometryCacheBenchmark( L"suzanne.ply", false ) );
+	app.AddBenchmark( new GeometryCacheBenchmark( L"suzanne.ply", true ) );
+
+	app.AddBenchmark( new StreamingBenchmark( L"Sample_Scene.ms3d" ) );
+
+	app.AddBenchmark( new StlBenchmark( 1000000, false, true ) );
+	app.AddBenchmark( new StlBenchmark( 1000000, false, false ) );
+	app.AddBenchmark( new StlBenchmark( 1000000, true, true ) );
+
+	app.AddBenchmark( new ObjBenchmark( 1000000, true ) );
+	app.AddBenchmark( new ObjBenchmark( 1000000, false ) );
+
+	app.AddBenchmark( new PlyBenchmark( 1000000, true ) );
+	app.AddBenchmark( new PlyBenchmark( 1000000, false ) );
+
+	app.AddBenchmark( new BvhBenchmark( 100000, 1000, false ) );
+	app.AddBenchmark( new BvhBenchmark( 100000, 1000, true ) );
+
+	// The scene update, the adjacency search and the skeletons are measured 
+	// with one thread, and then doubling the threads up to the number of 
+	// hardware threads.
+
+	const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+
+	for ( unsigned int threads = 1; threads == 1 || threads <= hardwareThreads; threads *= 2 )
+		app.AddBenchmark( new SceneUpdateBenchmark( 100000, threads ) );
+
+	for ( unsigned int threads = 1; threads == 1 || threads <= hardwareThreads; threads *= 2 )
+		app.AddBenchmark( new AdjacencyBenchmark( 1000000, threads ) );
+
+	for ( unsigned int threads = 1; threads == 1 || threads <= hardwareThreads; threads *= 2 )
+		app.AddBenchmark( new SkeletonBenchmark( 1000, 64, threads ) );
+
+	// The render task schedules are compared for each worker count that the
+	// renderer supports.
+
+	for ( unsigned int workers = 1; workers <= NUM_THREADS; workers++ )
+	{
+		app.AddBenchmark( new TaskGraphBenchmark( 24, workers, true ) );
+		app.AddBenchmark( new TaskGraphBenchmark( 24, workers, false ) );
+	}
+
+	app.RunBenchmarks( argc > 1 ? argv[1] : L"" );
+	app.ShutdownEngineComponents();
+
+	return( 0 );
+}
+//--------------------------------------------------------------------------------
+App::App() :
+	m_pRenderer11( nullptr ),
+	m_pRecorder( nullptr ),
+	m_pJobs( new JobSystem() )
+{
+	Log::Get().Open();
+}
+//--------------------------------------------------------------------------------
+App::~App()
+{
+	for ( auto pCase : m_vBenchmarks )
+		delete pCase;
+
+	SAFE_DELETE( m_pJobs );
+
+	Log::Get().Close();
+}
+//--------------------------------------------------------------------------------
+bool App::ConfigureEngineComponents()
+{
+	// The null driver creates resources and shaders as usual, but can't draw
+	// anything.  This is all that the recorder needs.
+
+	m_pRenderer11 = new RendererDX11();
+
+	if ( !m_pRenderer11->Initialize( D3D_DRIVER_TYPE_NULL, D3D_FEATURE_LEVEL_11_0 ) )
+	{
+		std::wcout << L"Could not create a null Direct3D 11 device - the benchmarks will not be run!" << std::endl;
+		return( false );
+	}
+
+	// Render tasks are executed directly on the immediate pipeline, instead of
+	// being recorded into deferred contexts, so that all of their calls reach
+	// the recorder.
+
+	m_pRenderer11->MultiThreadingConfig.SetConfiguration( false );
+
+	// The recorder only counts the calls, since keeping the commands of every
+	// iteration would add a growing amount of memory traffic to the timings.
+
+	m_pRecorder = new RecordingDeviceContextDX11( m_pRenderer11->GetDevice() );
+	m_pRecorder->SetRecordingEnabled( false );
+
+	DeviceContextComPtr pContext;
+	pContext.Attach( m_pRecorder );
+	m_pRenderer11->pImmPipeline->SetDeviceContext( pContext, m_pRenderer11->GetCurrentFeatureLevel() );
+
+	// Create the render targets that the render views draw into.
+
+	Texture2dConfigDX11 ColorConfig;
+	ColorConfig.SetColorBuffer( Width, Height );
+	ColorConfig.SetBindFlags( D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET );
+	m_RenderTarget = m_pRenderer11->CreateTexture2D( &ColorConfig, 0 );
+
+	Texture2dConfigDX11 DepthConfig;
+	DepthConfig.SetDepthBuffer( Width, Height );
+	m_DepthTarget = m_pRenderer11->CreateTexture2D( &DepthConfig, 0 );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void App::ShutdownEngineComponents()
+{
+	m_RenderTarget = nullptr;
+	m_DepthTarget = nullptr;
+
+	if ( m_pRenderer11 )
+	{
+		m_pRenderer11->Shutdown();
+		SAFE_DELETE( m_pRenderer11 );
+	}
+
+	// The recorder was released together with the immediate pipeline.
+
+	m_pRecorder = nullptr;
+}
+//--------------------------------------------------------------------------------
+void App::AddBenchmark( BenchmarkCase* pCase )
+{
+	m_vBenchmarks.push_back( pCase );
+}
+//--------------------------------------------------------------------------------
+void App::SetThreadCount( unsigned int threads )
+{
+	// The old job system has to be gone before the new one is created, since
+	// only the first instance is registered as JobSystem::Get().
+
+	SAFE_DELETE( m_pJobs );
+
+	if ( threads != 1 )
+		m_pJobs = new JobSystem( threads > 1 ? threads - 1 : 0 );
+}
+//--------------------------------------------------------------------------------
+std::wstring App::GetTempFilename( const std::wstring& name )
+{
+	wchar_t folder[MAX_PATH];
+
+	if ( GetTempPathW( MAX_PATH, folder ) == 0 )
+		return( name );
+
+	return( std::wstring( folder ) + L"Hieroglyph3_" + name );
+}
+//--------------------------------------------------------------------------------
+void App::RunBenchmarks( const std::wstring& filter )
+{
+	for ( auto pCase : m_vBenchmarks )
+	{
+		if ( pCase->GetName().find( filter ) != std::wstring::npos )
+			RunBenchmark( pCase );
+	}
+}
+//--------------------------------------------------------------------------------
+void App::RunBenchmark( BenchmarkCase* pCase )
+{
+	std::wstringstream out;
+	out << pCase->GetName() << L": ";
+
+	if ( !pCase->Setup( *this ) )
+	{
+		out << L"setup failed, skipped";
+		pCase->Shutdown( *this );
+
+		std::wcout << out.str() << std::endl;
+		Log::Get().Write( out.str() );
+		return;
+	}
+
+	// The first iteration creates whatever is created lazily, such as cached
+	// states and constant buffers, and is left out of the timings.  Afterwards
+	// the pipeline and the recorder are cleared together, so that their view
+	// of the bound state stays the same.  The parameter name lookups are
+	// counted from here on as well.
+
+	pCase->Run( *this );
+
+	m_pRenderer11->pImmPipeline->ClearPipelineState();
+	m_pRecorder->Reset();
+	ParameterNameTable::Get()->ResetLookupCount();
+
+	const unsigned int iterations = pCase->GetIterations() > 0 ? pCase->GetIterations() : 1;
+
+	LARGE_INTEGER frequency, start, end;
+	QueryPerformanceFrequency( &frequency );
+	QueryPerformanceCounter( &start );
+
+	for ( unsigned int i = 0; i < iterations; i++ )
+		pCase->Run( *this );
+
+	QueryPerformanceCounter( &end );
+
+	const unsigned int lookups = ParameterNameTable::Get()->GetLookupCount();
+
+	pCase->Shutdown( *this );
+
+	// Report the average of the iterations.
+
+	const double ms = 1000.0 * static_cast<double>( end.QuadPart - start.QuadPart )
+		/ static_cast<double>( frequency.QuadPart ) / iterations;
+
+	const RecordingStatisticsDX11& stats = m_pRecorder->GetStatistics();
+	const double draws = static_cast<double>( stats.draws ) / iterations;
+
+	out << std::fixed << std::setprecision( 3 )
+		<< ms << L" ms per iteration (" << iterations << L" iterations)"
+		<< L", Draws: " << draws
+		<< L", Draws per ms: " << std::setprecision( 1 ) << ( ms > 0.0 ? draws / ms : 0.0 )
+		<< L", Bind calls: " << static_cast<double>( stats.bindCalls ) / iterations
+		<< L", Redundant slots: " << static_cast<double>( stats.redundantSlots ) / iterations
+		<< L", Maps: " << static_cast<double>( stats.maps ) / iterations
+		<< L", Mapped bytes: " << static_cast<double>( stats.mappedBytes ) / iterations
+		<< L", Name lookups: " << static_cast<double>( lookups ) / iterations;
+
+	const std::wstring report = pCase->GetReport();
+
+	if ( !report.empty() )
+		out << L", " << report;
+
+	std::wcout << out.str() << std::endl;
+	Log::Get().Write( out.str() );
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,103 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// SubmissionBenchmark
+//
+// A console application that measures the CPU side of the engine without a GPU
+// or a window.  The renderer is created on a D3D_DRIVER_TYPE_NULL device, and
+// its immediate pipeline is switched over to a RecordingDeviceContextDX11, so
+// that each frame runs the complete submission path while only counting the
+// calls that reach the context.
+//
+// Each benchmark case is set up once, run once to warm up, and then timed over
+// a number of iterations.  The average time per iteration is printed together
+// with the recorder statistics and the parameter name lookups of one iteration.  Passing a name on the command
+// line only runs the cases whose names contain it.
+//--------------------------------------------------------------------------------
+#ifndef App_h
+#define App_h
+//--------------------------------------------------------------------------------
+#include "RendererDX11.h"
+#include "RecordingDeviceContextDX11.h"
+#include "JobSystem.h"
+#include "EventManager.h"
+#include "ParameterNameTable.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+
+class App;
+
+class BenchmarkCase
+{
+public:
+	virtual ~BenchmarkCase() {}
+
+	virtual std::wstring GetName() = 0;
+	virtual unsigned int GetIterations() { return( 100 ); }
+
+	virtual bool Setup( App& app ) { return( true ); }
+	virtual void Run( App& app ) = 0;
+	virtual void Shutdown( App& app ) {}
+
+	// Any results of the case itself, which are printed after the timings.
+	virtual std::wstring GetReport() { return( L"" ); }
+};
+
+class App
+{
+public:
+	App();
+	~App();
+
+	bool ConfigureEngineComponents();
+	void ShutdownEngineComponents();
+
+	void AddBenchmark( BenchmarkCase* pCase );
+	void RunBenchmarks( const std::wstring& filter );
+
+	// Replaces the job system with one that runs work on the given number of
+	// threads, counting the calling thread, which then becomes JobSystem::Get().
+	// With one thread there is no job system at all, and zero selects the
+	// default number of threads.
+
+	void SetThreadCount( unsigned int threads );
+
+	// Returns the full path of a file with the given name in the temporary
+	// folder, for the cases that generate their input files.
+
+	static std::wstring GetTempFilename( const std::wstring& name );
+
+	// The size of the render targets that the cases draw into.
+
+	static const unsigned int Width = 1280;
+	static const unsigned int Height = 720;
+
+	RendererDX11*					m_pRenderer11;
+	RecordingDeviceContextDX11*		m_pRecorder;
+
+	ResourcePtr						m_RenderTarget;
+	ResourcePtr						m_DepthTarget;
+
+protected:
+	void RunBenchmark( BenchmarkCase* pCase );
+
+	// The engine reports errors to the first event manager that is created,
+	// so the application creates one before any of the cases do.  The name
+	// table has to exist before the renderer interns its parameter names.
+
+	ParameterNameTable				m_NameTable;
+	EventManager					m_EvtManager;
+	JobSystem*						m_pJobs;
+	std::vector<BenchmarkCase*>		m_vBenchmarks;
+};
+//--------------------------------------------------------------------------------
+#endif // App_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,180 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "BvhBenchmark.h"
+#include "Actor.h"
+#include "SceneGraph.h"
+
+#include <algorithm>
+#include <sstream>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+// The number of rays along each side of the grid of pick rays.
+//--------------------------------------------------------------------------------
+static const unsigned int RaysPerSide = 16;
+//--------------------------------------------------------------------------------
+static double Seconds( const LARGE_INTEGER& start, const LARGE_INTEGER& end )
+{
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency( &frequency );
+
+	return( static_cast<double>( end.QuadPart - start.QuadPart ) / static_cast<double>( frequency.QuadPart ) );
+}
+//--------------------------------------------------------------------------------
+BvhBenchmark::BvhBenchmark( unsigned int entities, unsigned int moving, bool bBruteForce ) :
+	m_uiEntities( entities ),
+	m_uiMoving( std::min( moving, entities ) ),
+	m_bBruteForce( bBruteForce ),
+	m_pScene( nullptr ),
+	m_uiFrame( 0 ),
+	m_uiHits( 0 ),
+	m_UpdateSeconds( 0.0 ),
+	m_PickSeconds( 0.0 )
+{
+}
+//--------------------------------------------------------------------------------
+std::wstring BvhBenchmark::GetName()
+{
+	std::wstringstream name;
+	name << L"Bvh/" << m_uiEntities << L"/" << m_uiMoving << L" moving" 
+		<< ( m_bBruteForce ? L"/brute force" : L"/hierarchy" );
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+bool BvhBenchmark::Setup( App& app )
+{
+	// The entities fill a cube, and are owned by one actor that is deleted
+	// together with the scene.
+
+	unsigned int side = 1;
+	while ( side * side * side < m_uiEntities )
+		side++;
+
+	const float spacing = 3.0f;
+
+	m_pScene = new Scene();
+	Actor* pActor = new Actor();
+	m_pScene->AddActor( pActor );
+
+	for ( unsigned int i = 0; i < m_uiEntities; i++ )
+	{
+		const Vector3f position( spacing * static_cast<float>( i % side ),
+			spacing * static_cast<float>( ( i / side ) % side ),
+			spacing * static_cast<float>( i / ( side * side ) ) );
+
+		Entity3D* pEntity = new Entity3D();
+		pEntity->Transform.Position() = position;
+		pEntity->Shape.AddSphere( Sphere3f( Vector3f( 0.0f, 0.0f, 0.0f ), 1.0f ) );
+
+		pActor->GetNode()->AttachChild( pEntity );
+		pActor->AddElement( pEntity );
+
+		m_Entities.push_back( pEntity );
+		m_Positions.push_back( position );
+	}
+
+	// One ray through each column of the cube on a grid across its front face.
+
+	const float extent = spacing * static_cast<float>( side - 1 );
+
+	for ( unsigned int y = 0; y < RaysPerSide; y++ )
+	{
+		for ( unsigned int x = 0; x < RaysPerSide; x++ )
+		{
+			const float u = extent * static_cast<float>( x ) / static_cast<float>( RaysPerSide - 1 );
+			const float v = extent * static_cast<float>( y ) / static_cast<float>( RaysPerSide - 1 );
+
+			m_Rays.push_back( Ray3f( Vector3f( u, v, -10.0f ), Vector3f( 0.0f, 0.0f, 1.0f ) ) );
+		}
+	}
+
+	m_pScene->Update( 0.0f );
+
+	m_uiFrame = 0;
+	m_UpdateSeconds = 0.0;
+	m_PickSeconds = 0.0;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void BvhBenchmark::Run( App& app )
+{
+	LARGE_INTEGER start, updated, picked;
+	QueryPerformanceCounter( &start );
+
+	// The moving entities bob up and down by more than the margin of their fat
+	// boxes, so some of them are reinserted in every iteration.
+
+	const float time = static_cast<float>( ++m_uiFrame ) / 60.0f;
+
+	for ( unsigned int i = 0; i < m_uiMoving; i++ ) {
+		m_Entities[i]->Transform.Position() = m_Positions[i] 
+			+ Vector3f( 0.0f, 2.0f * sinf( time + 0.1f * static_cast<float>( i ) ), 0.0f );
+	}
+
+	m_pScene->Update( 1.0f / 60.0f );
+
+	QueryPerformanceCounter( &updated );
+
+	unsigned int hits = 0;
+
+	if ( m_bBruteForce )
+	{
+		for ( auto& ray : m_Rays )
+		{
+			std::vector<Entity3D*> set;
+			GetAllEntities( m_pScene->GetRoot(), set );
+
+			std::vector<PickRecord> records;
+			for ( auto pEntity : set )
+				AddPickRecord( pEntity, ray, records );
+
+			hits += static_cast<unsigned int>( records.size() );
+		}
+	}
+	else
+	{
+		std::vector< std::vector<PickRecord> > records;
+		m_pScene->BuildPickRecords( m_Rays, records );
+
+		for ( auto& record : records )
+			hits += static_cast<unsigned int>( record.size() );
+	}
+
+	QueryPerformanceCounter( &picked );
+
+	m_UpdateSeconds += Seconds( start, updated );
+	m_PickSeconds += Seconds( updated, picked );
+	m_uiHits = hits;
+}
+//--------------------------------------------------------------------------------
+void BvhBenchmark::Shutdown( App& app )
+{
+	SAFE_DELETE( m_pScene );
+
+	m_Entities.clear();
+	m_Positions.clear();
+	m_Rays.clear();
+}
+//--------------------------------------------------------------------------------
+std::wstring BvhBenchmark::GetReport()
+{
+	const double runs = m_uiFrame > 0 ? static_cast<double>( m_uiFrame ) : 1.0;
+
+	std::wstringstream report;
+	report << L"Update ms: " << 1000.0 * m_UpdateSeconds / runs
+		<< L", pick ms: " << 1000.0 * m_PickSeconds / runs
+		<< L" for " << RaysPerSide * RaysPerSide << L" rays"
+		<< L", hits: " << m_uiHits;
+
+	return( report.str() );
+}
+//--------------------------------------------------------------------------------
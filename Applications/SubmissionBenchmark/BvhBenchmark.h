@@ -0,0 +1,61 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// BvhBenchmark
+//
+// Updates a scene of entities with one sphere shape each, of which a given 
+// number move in every iteration, and then picks it with a grid of rays.  The
+// scene update includes refitting the bounding volume hierarchy, which only 
+// visits the entities that have moved.  The picking either goes through 
+// Scene::BuildPickRecords, which only tests the entities whose bounds are hit,
+// or tests every entity below the root for each ray, the way that picking was 
+// done before the scene had a bounding volume hierarchy.
+//
+// Both parts are timed by the case itself, and the report gives the average
+// time of each along with the number of hits.
+//--------------------------------------------------------------------------------
+#ifndef BvhBenchmark_h
+#define BvhBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+#include "Scene.h"
+//--------------------------------------------------------------------------------
+class BvhBenchmark : public BenchmarkCase
+{
+public:
+	BvhBenchmark( unsigned int entities, unsigned int moving, bool bBruteForce );
+
+	virtual std::wstring GetName();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+	virtual std::wstring GetReport();
+
+protected:
+	unsigned int					m_uiEntities;
+	unsigned int					m_uiMoving;
+	bool							m_bBruteForce;
+
+	Glyph3::Scene*					m_pScene;
+	std::vector<Glyph3::Entity3D*>	m_Entities;
+	std::vector<Glyph3::Vector3f>	m_Positions;
+	std::vector<Glyph3::Ray3f>		m_Rays;
+
+	unsigned int					m_uiFrame;
+	unsigned int					m_uiHits;
+	double							m_UpdateSeconds;
+	double							m_PickSeconds;
+};
+//--------------------------------------------------------------------------------
+#endif // BvhBenchmark_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,172 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "EventQueueBenchmark.h"
+#include "EventPool.h"
+
+#include <sstream>
+#include <thread>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+// The event that the producers queue.  It uses an existing event type, since
+// only the listener of the benchmark's own event manager receives it.
+//--------------------------------------------------------------------------------
+class EvtBenchmark : public IEvent
+{
+public:
+	EvtBenchmark( unsigned int producer, unsigned int sequence, long long ticks ) :
+		m_uiProducer( producer ),
+		m_uiSequence( sequence ),
+		m_iTicks( ticks )
+	{
+	}
+
+	virtual std::wstring GetEventName( ) { return( std::wstring( L"benchmark" ) ); }
+	virtual eEVENT GetEventType( ) { return( INFO_MESSAGE ); }
+
+	unsigned int	m_uiProducer;
+	unsigned int	m_uiSequence;
+	long long		m_iTicks;
+};
+//--------------------------------------------------------------------------------
+EventQueueBenchmark::EventQueueBenchmark( unsigned int producers, unsigned int events ) :
+	m_uiProducers( producers ),
+	m_uiEvents( events ),
+	m_pEvents( nullptr ),
+	m_uiReceived( 0 ),
+	m_uiDispatched( 0 ),
+	m_uiOrderErrors( 0 ),
+	m_iLatencyTicks( 0 ),
+	m_iMaxLatencyTicks( 0 ),
+	m_iFrequency( 1 )
+{
+	RequestEvent( INFO_MESSAGE );
+}
+//--------------------------------------------------------------------------------
+EventQueueBenchmark::~EventQueueBenchmark()
+{
+}
+//--------------------------------------------------------------------------------
+std::wstring EventQueueBenchmark::GetName()
+{
+	std::wstringstream name;
+	name << L"EventQueue/" << m_uiProducers << L"x" << m_uiEvents;
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+unsigned int EventQueueBenchmark::GetIterations()
+{
+	return( 20 );
+}
+//--------------------------------------------------------------------------------
+bool EventQueueBenchmark::Setup( App& app )
+{
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency( &frequency );
+	m_iFrequency = frequency.QuadPart;
+
+	m_pEvents = new EventManager();
+	SetEventManager( m_pEvents );
+
+	m_uiDispatched = 0;
+	m_uiOrderErrors = 0;
+	m_iLatencyTicks = 0;
+	m_iMaxLatencyTicks = 0;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void EventQueueBenchmark::Run( App& app )
+{
+	m_LastSequences.assign( m_uiProducers, 0 );
+	m_uiReceived = 0;
+
+	EventManager* pEvents = m_pEvents;
+	const unsigned int events = m_uiEvents;
+
+	std::vector<std::thread> producers;
+
+	for ( unsigned int p = 0; p < m_uiProducers; p++ )
+	{
+		producers.push_back( std::thread( [pEvents,events,p]()
+		{
+			for ( unsigned int s = 1; s <= events; s++ )
+			{
+				LARGE_INTEGER now;
+				QueryPerformanceCounter( &now );
+
+				EventPtr pEvent = MakeEvent<EvtBenchmark>( p, s, now.QuadPart );
+
+				while ( !pEvents->QueueEvent( pEvent ) )
+					std::this_thread::yield();
+			}
+		} ) );
+	}
+
+	// Dispatch the events as they arrive, like a message loop that does
+	// nothing else.
+
+	const unsigned int total = m_uiProducers * m_uiEvents;
+
+	while ( m_uiReceived < total )
+		m_pEvents->ProcessEventQueue();
+
+	for ( auto& producer : producers )
+		producer.join();
+}
+//--------------------------------------------------------------------------------
+void EventQueueBenchmark::Shutdown( App& app )
+{
+	SetEventManager( nullptr );
+	SAFE_DELETE( m_pEvents );
+}
+//--------------------------------------------------------------------------------
+std::wstring EventQueueBenchmark::GetReport()
+{
+	const double microseconds = 1000000.0 / static_cast<double>( m_iFrequency );
+
+	std::wstringstream report;
+	report << L"Events: " << m_uiDispatched
+		<< L", Mean latency: " << ( m_uiDispatched > 0 ? microseconds * m_iLatencyTicks / m_uiDispatched : 0.0 ) << L" us"
+		<< L", Max latency: " << microseconds * m_iMaxLatencyTicks << L" us"
+		<< L", Out of order: " << m_uiOrderErrors;
+
+	return( report.str() );
+}
+//--------------------------------------------------------------------------------
+bool EventQueueBenchmark::HandleEvent( EventPtr pEvent )
+{
+	LARGE_INTEGER now;
+	QueryPerformanceCounter( &now );
+
+	EvtBenchmark* pBenchmark = static_cast<EvtBenchmark*>( pEvent.get() );
+
+	// Each producer queues its events in order, so they have to be dispatched
+	// in that order as well.
+
+	if ( pBenchmark->m_uiSequence != m_LastSequences[pBenchmark->m_uiProducer] + 1 )
+		m_uiOrderErrors++;
+
+	m_LastSequences[pBenchmark->m_uiProducer] = pBenchmark->m_uiSequence;
+
+	const long long latency = now.QuadPart - pBenchmark->m_iTicks;
+
+	m_iLatencyTicks += latency;
+
+	if ( latency > m_iMaxLatencyTicks )
+		m_iMaxLatencyTicks = latency;
+
+	m_uiReceived++;
+	m_uiDispatched++;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,63 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// EventQueueBenchmark
+//
+// A number of producer threads create events with MakeEvent and queue them on
+// an event manager, while the benchmark thread processes the queue until all
+// of them have been dispatched.  Each event carries the time that it was
+// queued, and the number of its producer and its position in that producer's
+// sequence.  The report gives the latency from queueing to dispatch, and the
+// number of events that arrived out of order for their producer, which should
+// always be zero.
+//--------------------------------------------------------------------------------
+#ifndef EventQueueBenchmark_h
+#define EventQueueBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+#include "IEventListener.h"
+//--------------------------------------------------------------------------------
+class EventQueueBenchmark : public BenchmarkCase, public IEventListener
+{
+public:
+	EventQueueBenchmark( unsigned int producers, unsigned int events );
+	virtual ~EventQueueBenchmark();
+
+	virtual std::wstring GetName();
+	virtual unsigned int GetIterations();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+	virtual std::wstring GetReport();
+
+	virtual bool HandleEvent( EventPtr pEvent );
+
+protected:
+	unsigned int				m_uiProducers;
+	unsigned int				m_uiEvents;
+	EventManager*				m_pEvents;
+
+	// The last sequence number that was received from each producer, and the
+	// totals over all of the iterations.
+
+	std::vector<unsigned int>	m_LastSequences;
+	unsigned int				m_uiReceived;
+	unsigned long long			m_uiDispatched;
+	unsigned long long			m_uiOrderErrors;
+	long long					m_iLatencyTicks;
+	long long					m_iMaxLatencyTicks;
+	long long					m_iFrequency;
+};
+//--------------------------------------------------------------------------------
+#endif // EventQueueBenchmark_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,83 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "GeometryCacheBenchmark.h"
+#include "GeometryCacheDX11.h"
+#include "GeometryLoaderDX11.h"
+
+#include <sstream>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+GeometryCacheBenchmark::GeometryCacheBenchmark( const std::wstring& model, bool bCached ) :
+	m_Model( model ),
+	m_bCached( bCached ),
+	m_iVertices( 0 ),
+	m_uiIndices( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+std::wstring GeometryCacheBenchmark::GetName()
+{
+	return( L"GeometryCache/" + m_Model + ( m_bCached ? L"/cached" : L"/parsed" ) );
+}
+//--------------------------------------------------------------------------------
+unsigned int GeometryCacheBenchmark::GetIterations()
+{
+	return( 20 );
+}
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryCacheBenchmark::Load()
+{
+	const size_t extension = m_Model.find_last_of( L'.' );
+
+	if ( extension != std::wstring::npos && m_Model.substr( extension ) == L".ply" )
+		return( GeometryLoaderDX11::loadStanfordPlyFile( m_Model ) );
+
+	return( GeometryLoaderDX11::loadMS3DFile2( m_Model ) );
+}
+//--------------------------------------------------------------------------------
+bool GeometryCacheBenchmark::Setup( App& app )
+{
+	// The first load writes the cache when it is enabled, and the warm up run
+	// then already reads it.
+
+	GeometryCacheDX11::SetEnabled( m_bCached );
+
+	GeometryPtr pGeometry = Load();
+
+	if ( !pGeometry ) {
+		GeometryCacheDX11::SetEnabled( true );
+		return( false );
+	}
+
+	m_iVertices = pGeometry->CalculateVertexCount();
+	m_uiIndices = pGeometry->GetIndexCount();
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void GeometryCacheBenchmark::Run( App& app )
+{
+	GeometryPtr pGeometry = Load();
+}
+//--------------------------------------------------------------------------------
+void GeometryCacheBenchmark::Shutdown( App& app )
+{
+	GeometryCacheDX11::SetEnabled( true );
+}
+//--------------------------------------------------------------------------------
+std::wstring GeometryCacheBenchmark::GetReport()
+{
+	std::wstringstream report;
+	report << L"Vertices: " << m_iVertices << L", indices: " << m_uiIndices;
+
+	return( report.str() );
+}
+//--------------------------------------------------------------------------------
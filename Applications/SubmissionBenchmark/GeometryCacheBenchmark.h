@@ -0,0 +1,49 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// GeometryCacheBenchmark
+//
+// Loads a model from the models folder with the geometry loaders, either with
+// the geometry cache disabled so that every load parses the model, or after
+// the cache has been written so that every load maps the cache file.  The two
+// cases of a model show what the cache saves per load.
+//--------------------------------------------------------------------------------
+#ifndef GeometryCacheBenchmark_h
+#define GeometryCacheBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+#include "GeometryDX11.h"
+//--------------------------------------------------------------------------------
+class GeometryCacheBenchmark : public BenchmarkCase
+{
+public:
+	GeometryCacheBenchmark( const std::wstring& model, bool bCached );
+
+	virtual std::wstring GetName();
+	virtual unsigned int GetIterations();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+	virtual std::wstring GetReport();
+
+protected:
+	Glyph3::GeometryPtr Load();
+
+	std::wstring		m_Model;
+	bool				m_bCached;
+	int					m_iVertices;
+	unsigned int		m_uiIndices;
+};
+//--------------------------------------------------------------------------------
+#endif // GeometryCacheBenchmark_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,98 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "LogThroughputBenchmark.h"
+#include "Log.h"
+
+#include <sstream>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+LogThroughputBenchmark::LogThroughputBenchmark( unsigned int threads, unsigned int messages ) :
+	m_uiThreads( threads > 0 ? threads : 1 ),
+	m_uiMessages( messages ),
+	m_ullWritten( 0 ),
+	m_iTicks( 0 ),
+	m_iFrequency( 1 )
+{
+}
+//--------------------------------------------------------------------------------
+std::wstring LogThroughputBenchmark::GetName()
+{
+	std::wstringstream name;
+	name << L"LogThroughput/" << m_uiThreads << L"x" << m_uiMessages;
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+unsigned int LogThroughputBenchmark::GetIterations()
+{
+	// Every iteration adds its messages to the log file.
+
+	return( 10 );
+}
+//--------------------------------------------------------------------------------
+bool LogThroughputBenchmark::Setup( App& app )
+{
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency( &frequency );
+	m_iFrequency = frequency.QuadPart;
+
+	m_ullWritten = 0;
+	m_iTicks = 0;
+
+	app.SetThreadCount( m_uiThreads );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void LogThroughputBenchmark::Run( App& app )
+{
+	LARGE_INTEGER start, end;
+	QueryPerformanceCounter( &start );
+
+	const unsigned int messages = m_uiMessages;
+
+	auto write = [messages]( unsigned int begin, unsigned int end )
+	{
+		for ( unsigned int t = begin; t < end; t++ )
+		{
+			for ( unsigned int i = 0; i < messages; i++ )
+				Log::Get().Write( L"Benchmark message " + std::to_wstring( i ) + L" from writer " + std::to_wstring( t ) );
+		}
+	};
+
+	if ( m_uiThreads > 1 )
+		JobSystem::Get()->ParallelFor( m_uiThreads, 1, write );
+	else
+		write( 0, 1 );
+
+	Log::Get().Flush();
+
+	QueryPerformanceCounter( &end );
+
+	m_ullWritten += m_uiThreads * m_uiMessages;
+	m_iTicks += end.QuadPart - start.QuadPart;
+}
+//--------------------------------------------------------------------------------
+void LogThroughputBenchmark::Shutdown( App& app )
+{
+	app.SetThreadCount( 0 );
+}
+//--------------------------------------------------------------------------------
+std::wstring LogThroughputBenchmark::GetReport()
+{
+	const double seconds = static_cast<double>( m_iTicks ) / static_cast<double>( m_iFrequency );
+
+	std::wstringstream report;
+	report << L"Messages per second: " << ( seconds > 0.0 ? static_cast<double>( m_ullWritten ) / seconds : 0.0 );
+
+	return( report.str() );
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,53 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// LogThroughputBenchmark
+//
+// Writes messages to the log from a number of threads at once, and then flushes
+// the log, so that each iteration includes getting the messages into the file.
+// The messages are all different, which keeps the rate limit from dropping
+// them.  The report gives the messages written per second over all of the
+// iterations.
+//
+// The writers are the threads of a job system with the given number of threads,
+// rather than new threads for each iteration, since the log keeps a buffer for
+// every thread that has written to it.
+//--------------------------------------------------------------------------------
+#ifndef LogThroughputBenchmark_h
+#define LogThroughputBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+//--------------------------------------------------------------------------------
+class LogThroughputBenchmark : public BenchmarkCase
+{
+public:
+	LogThroughputBenchmark( unsigned int threads, unsigned int messages );
+
+	virtual std::wstring GetName();
+	virtual unsigned int GetIterations();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+	virtual std::wstring GetReport();
+
+protected:
+	unsigned int		m_uiThreads;
+	unsigned int		m_uiMessages;
+
+	unsigned long long	m_ullWritten;
+	long long			m_iTicks;
+	long long			m_iFrequency;
+};
+//--------------------------------------------------------------------------------
+#endif // LogThroughputBenchmark_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,98 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "MatrixBenchmark.h"
+
+#include <sstream>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+MatrixBenchmark::MatrixBenchmark( MatrixKernel kernel, unsigned int count ) :
+	m_Kernel( kernel ),
+	m_uiCount( count )
+{
+}
+//--------------------------------------------------------------------------------
+std::wstring MatrixBenchmark::GetName()
+{
+	static const wchar_t* names[] = { L"Multiply", L"Inverse", L"TransformLoop", L"TransformVectors", L"TransformPoints" };
+
+	std::wstringstream name;
+	name << L"Matrix4f/" << ( GLYPH_SSE_MATH ? L"SSE" : L"Scalar" ) << L"/" << names[m_Kernel] << L"/" << m_uiCount;
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+bool MatrixBenchmark::Setup( App& app )
+{
+	// Rigid transforms like those of the scene graph, which can all be
+	// inverted.
+
+	m_Matrices.resize( m_uiCount );
+	m_Products.resize( m_uiCount );
+	m_Vectors.resize( m_uiCount );
+	m_TransformedVectors.resize( m_uiCount );
+	m_Points.resize( m_uiCount );
+	m_TransformedPoints.resize( m_uiCount );
+
+	for ( unsigned int i = 0; i < m_uiCount; i++ )
+	{
+		const float f = static_cast<float>( i );
+
+		m_Matrices[i] = Matrix4f::RotationMatrixXYZ( 0.1f * f, 0.2f * f, 0.3f * f );
+		m_Matrices[i].SetTranslation( Vector3f( f, -f, 0.5f * f ) );
+
+		m_Vectors[i] = Vector4f( f, 1.0f - f, 0.25f * f, 1.0f );
+		m_Points[i] = Vector3f( f, 1.0f - f, 0.25f * f );
+	}
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void MatrixBenchmark::Run( App& app )
+{
+	const Matrix4f& transform = m_Matrices[0];
+
+	switch ( m_Kernel )
+	{
+	case MATRIX_MULTIPLY:
+		for ( unsigned int i = 0; i + 1 < m_uiCount; i++ )
+			m_Products[i] = m_Matrices[i] * m_Matrices[i+1];
+		break;
+
+	case MATRIX_INVERSE:
+		for ( unsigned int i = 0; i < m_uiCount; i++ )
+			m_Products[i] = m_Matrices[i].Inverse();
+		break;
+
+	case MATRIX_TRANSFORM_LOOP:
+		for ( unsigned int i = 0; i < m_uiCount; i++ )
+			m_TransformedVectors[i] = transform * m_Vectors[i];
+		break;
+
+	case MATRIX_TRANSFORM_VECTORS:
+		transform.TransformVectors( &m_Vectors[0], &m_TransformedVectors[0], m_uiCount );
+		break;
+
+	case MATRIX_TRANSFORM_POINTS:
+		transform.TransformPoints( &m_Points[0], &m_TransformedPoints[0], m_uiCount );
+		break;
+	}
+}
+//--------------------------------------------------------------------------------
+void MatrixBenchmark::Shutdown( App& app )
+{
+	m_Matrices.clear();
+	m_Products.clear();
+	m_Vectors.clear();
+	m_TransformedVectors.clear();
+	m_Points.clear();
+	m_TransformedPoints.clear();
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,59 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// MatrixBenchmark
+//
+// Times one of the Matrix4f kernels over an array of matrices or vectors.  The
+// name of the case includes whether the library was built with the SSE or the
+// scalar kernels (GLYPH_SSE_MATH), so that the two builds can be compared case
+// by case.  The vector cases transform the same array once with a loop over
+// operator* and once with the batch functions.
+//--------------------------------------------------------------------------------
+#ifndef MatrixBenchmark_h
+#define MatrixBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+#include "Matrix4f.h"
+//--------------------------------------------------------------------------------
+enum MatrixKernel
+{
+	MATRIX_MULTIPLY,
+	MATRIX_INVERSE,
+	MATRIX_TRANSFORM_LOOP,
+	MATRIX_TRANSFORM_VECTORS,
+	MATRIX_TRANSFORM_POINTS
+};
+
+class MatrixBenchmark : public BenchmarkCase
+{
+public:
+	MatrixBenchmark( MatrixKernel kernel, unsigned int count );
+
+	virtual std::wstring GetName();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+protected:
+	MatrixKernel				m_Kernel;
+	unsigned int				m_uiCount;
+
+	std::vector<Matrix4f>		m_Matrices;
+	std::vector<Matrix4f>		m_Products;
+	std::vector<Vector4f>		m_Vectors;
+	std::vector<Vector4f>		m_TransformedVectors;
+	std::vector<Vector3f>		m_Points;
+	std::vector<Vector3f>		m_TransformedPoints;
+};
+//--------------------------------------------------------------------------------
+#endif // MatrixBenchmark_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,172 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "ObjBenchmark.h"
+#include "ObjImporterDX11.h"
+#include "MeshOBJ.h"
+
+#include <sstream>
+#include <fstream>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+ObjBenchmark::ObjBenchmark( unsigned int quads, bool bImporter ) :
+	m_uiQuads( quads ),
+	m_bImporter( bImporter ),
+	m_FileSize( 0 ),
+	m_BytesParsed( 0 ),
+	m_Seconds( 0.0 ),
+	m_uiVertices( 0 ),
+	m_uiIndices( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+std::wstring ObjBenchmark::GetName()
+{
+	std::wstringstream name;
+	name << L"Obj/" << m_uiQuads << ( m_bImporter ? L"/importer" : L"/MeshOBJ" );
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+unsigned int ObjBenchmark::GetIterations()
+{
+	return( 5 );
+}
+//--------------------------------------------------------------------------------
+bool ObjBenchmark::WriteFile()
+{
+	unsigned int side = 1;
+	while ( side * side < m_uiQuads )
+		side++;
+
+	std::ofstream file( m_Filename, std::ios::out | std::ios::binary | std::ios::trunc );
+
+	if ( !file.is_open() )
+		return( false );
+
+	// One vertex for each corner of the grid, with the same index for all of
+	// its attributes.
+
+	char line[256];
+
+	for ( unsigned int z = 0; z <= side; z++ )
+	{
+		for ( unsigned int x = 0; x <= side; x++ )
+		{
+			const float u = static_cast<float>( x ) / static_cast<float>( side );
+			const float v = static_cast<float>( z ) / static_cast<float>( side );
+			const float height = 0.25f * sinf( 0.1f * x ) * cosf( 0.1f * z );
+
+			sprintf_s( line, "v %f %f %f\nvt %f %f\nvn %f %f %f\n",
+				static_cast<float>( x ), height, static_cast<float>( z ), u, v, 0.0f, 1.0f, 0.0f );
+			file << line;
+		}
+	}
+
+	// The rows are split between two objects, each with its own material.
+
+	const unsigned int rows = ( m_uiQuads + side - 1 ) / side;
+	unsigned int written = 0;
+
+	for ( unsigned int z = 0; z < rows; z++ )
+	{
+		if ( z == 0 || z == rows / 2 ) {
+			file << ( z == 0 ? "o first\nusemtl stone\n" : "o second\nusemtl grass\n" );
+		}
+
+		for ( unsigned int x = 0; x < side && written < m_uiQuads; x++, written++ )
+		{
+			const unsigned int a = z * ( side + 1 ) + x + 1;
+			const unsigned int b = a + 1;
+			const unsigned int c = a + side + 2;
+			const unsigned int d = a + side + 1;
+
+			sprintf_s( line, "f %u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, c, c, c, d, d, d );
+			file << line;
+		}
+	}
+
+	m_FileSize = static_cast<unsigned long long>( file.tellp() );
+
+	return( file.good() );
+}
+//--------------------------------------------------------------------------------
+bool ObjBenchmark::Setup( App& app )
+{
+	std::wstringstream filename;
+	filename << L"Obj_" << m_uiQuads << L".obj";
+	m_Filename = App::GetTempFilename( filename.str() );
+
+	m_BytesParsed = 0;
+	m_Seconds = 0.0;
+
+	return( WriteFile() );
+}
+//--------------------------------------------------------------------------------
+void ObjBenchmark::Run( App& app )
+{
+	LARGE_INTEGER frequency, start, end;
+	QueryPerformanceFrequency( &frequency );
+	QueryPerformanceCounter( &start );
+
+	unsigned int vertices = 0;
+	unsigned int indices = 0;
+
+	if ( m_bImporter )
+	{
+		std::vector<ObjImporterDX11::Part> parts;
+		ObjImporterDX11::Load( m_Filename, parts );
+
+		QueryPerformanceCounter( &end );
+
+		for ( auto& part : parts ) {
+			vertices += static_cast<unsigned int>( part.geometry->CalculateVertexCount() );
+			indices += part.geometry->GetIndexCount();
+		}
+	}
+	else
+	{
+		OBJ::MeshOBJ mesh( m_Filename );
+
+		QueryPerformanceCounter( &end );
+
+		vertices = static_cast<unsigned int>( mesh.positions.size() );
+
+		for ( auto& object : mesh.objects )
+			for ( auto& subobject : object.subobjects )
+				for ( auto& face : subobject.faces )
+					if ( face.positionIndices.size() >= 3 )
+						indices += 3 * static_cast<unsigned int>( face.positionIndices.size() - 2 );
+	}
+
+	m_Seconds += static_cast<double>( end.QuadPart - start.QuadPart ) / static_cast<double>( frequency.QuadPart );
+	m_BytesParsed += m_FileSize;
+	m_uiVertices = vertices;
+	m_uiIndices = indices;
+}
+//--------------------------------------------------------------------------------
+void ObjBenchmark::Shutdown( App& app )
+{
+	if ( !m_Filename.empty() )
+		DeleteFileW( m_Filename.c_str() );
+}
+//--------------------------------------------------------------------------------
+std::wstring ObjBenchmark::GetReport()
+{
+	const double megabytes = static_cast<double>( m_BytesParsed ) / ( 1024.0 * 1024.0 );
+
+	std::wstringstream report;
+	report << L"File: " << m_FileSize / ( 1024 * 1024 ) << L" MB"
+		<< L", MB/s: " << ( m_Seconds > 0.0 ? megabytes / m_Seconds : 0.0 )
+		<< L", vertices: " << m_uiVertices << L", indices: " << m_uiIndices;
+
+	return( report.str() );
+}
+//--------------------------------------------------------------------------------
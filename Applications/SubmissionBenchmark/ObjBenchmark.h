@@ -0,0 +1,59 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// ObjBenchmark
+//
+// Writes a generated OBJ file to the temporary folder, and parses it either
+// with ObjImporterDX11 or with MeshOBJ.  The file is a grid of quads with 
+// positions, texture coordinates and normals, split into two objects with a
+// material each, so both the polygon splitting and the vertex merging of the
+// importer are exercised.
+//
+// Each load is timed by the case itself, and the report gives the parsing rate
+// in MB/s over all loads, along with the vertex and index counts.  MeshOBJ
+// keeps the indices of the faces as they are in the file, so its counts are 
+// the positions and the corners of the faces split into triangles.
+//--------------------------------------------------------------------------------
+#ifndef ObjBenchmark_h
+#define ObjBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+//--------------------------------------------------------------------------------
+class ObjBenchmark : public BenchmarkCase
+{
+public:
+	ObjBenchmark( unsigned int quads, bool bImporter );
+
+	virtual std::wstring GetName();
+	virtual unsigned int GetIterations();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+	virtual std::wstring GetReport();
+
+protected:
+	bool WriteFile();
+
+	unsigned int		m_uiQuads;
+	bool				m_bImporter;
+
+	std::wstring		m_Filename;
+	unsigned long long	m_FileSize;
+	unsigned long long	m_BytesParsed;
+	double				m_Seconds;
+	unsigned int		m_uiVertices;
+	unsigned int		m_uiIndices;
+};
+//--------------------------------------------------------------------------------
+#endif // ObjBenchmark_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,111 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "PackingBenchmark.h"
+#include "GeometryGeneratorDX11.h"
+#include "GlyphString.h"
+
+#include <sstream>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+PackingBenchmark::PackingBenchmark( unsigned int rings ) :
+	m_uiRings( rings ),
+	m_uiVertices( 0 ),
+	m_uiUnpackedSize( 0 ),
+	m_uiPackedSize( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+std::wstring PackingBenchmark::GetName()
+{
+	std::wstringstream name;
+	name << L"Packing/" << m_uiRings << L" rings";
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+unsigned int PackingBenchmark::GetIterations()
+{
+	return( 10 );
+}
+//--------------------------------------------------------------------------------
+bool PackingBenchmark::Setup( App& app )
+{
+	m_pGeometry = GeometryPtr( new GeometryDX11() );
+	GeometryGeneratorDX11::GenerateWeightedSkinnedCone( m_pGeometry, 64, m_uiRings, 1.0f, 10.0f, 8 );
+
+	m_uiVertices = m_pGeometry->CalculateVertexCount();
+	m_uiUnpackedSize = m_pGeometry->CalculateVertexSize();
+
+	// Elements whose data doesn't fit their default packing stay unpacked, as
+	// they would when the geometry is loaded to its buffers.
+
+	std::wstringstream errors;
+
+	for ( int i = 0; i < m_pGeometry->GetElementCount(); i++ )
+	{
+		VertexElementDX11* pElement = m_pGeometry->GetElement( i );
+		VertexPacking packing = VertexPackerDX11::GetDefaultPacking( pElement->m_SemanticName );
+
+		if ( !VertexPackerDX11::CanPack( pElement, packing ) )
+			packing = VertexPacking::None;
+
+		m_pGeometry->SetPacking( pElement->m_SemanticName, packing );
+
+		errors << L" " << GlyphString::ToUnicode( pElement->m_SemanticName ) << L": ";
+
+		if ( packing == VertexPacking::None ) {
+			errors << L"unpacked";
+		} else if ( packing == VertexPacking::Octahedral ) {
+			errors << VertexPackerDX11::MeasureError( pElement, packing ) * 180.0f / 3.14159265f << L" deg";
+		} else {
+			errors << VertexPackerDX11::MeasureError( pElement, packing );
+		}
+	}
+
+	m_Errors = errors.str();
+	m_uiPackedSize = m_pGeometry->CalculateVertexSize();
+	m_Bytes.resize( m_uiPackedSize * m_uiVertices );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void PackingBenchmark::Run( App& app )
+{
+	char* pBytes = &m_Bytes[0];
+
+	for ( unsigned int v = 0; v < m_uiVertices; v++ )
+	{
+		for ( int i = 0; i < m_pGeometry->GetElementCount(); i++ )
+		{
+			VertexElementDX11* pElement = m_pGeometry->GetElement( i );
+
+			VertexPackerDX11::Pack( pElement, pElement->m_Packing, v, pBytes );
+			pBytes += VertexPackerDX11::GetSize( pElement, pElement->m_Packing );
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+void PackingBenchmark::Shutdown( App& app )
+{
+	m_pGeometry = nullptr;
+	m_Bytes.clear();
+}
+//--------------------------------------------------------------------------------
+std::wstring PackingBenchmark::GetReport()
+{
+	std::wstringstream report;
+	report << L"Vertices: " << m_uiVertices
+		<< L", bytes/vertex: " << m_uiUnpackedSize << L" -> " << m_uiPackedSize
+		<< L", max error:" << m_Errors;
+
+	return( report.str() );
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,52 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// PackingBenchmark
+//
+// Packs the vertices of a weighted skinned cone with the default packing of
+// each of its elements, in the same way that GeometryDX11::LoadToBuffers fills
+// a vertex buffer.  The report gives the vertex size with and without packing,
+// and the maximum round trip error of every element that could be packed, with
+// the error of octahedral normals given in degrees.
+//--------------------------------------------------------------------------------
+#ifndef PackingBenchmark_h
+#define PackingBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+#include "GeometryDX11.h"
+//--------------------------------------------------------------------------------
+class PackingBenchmark : public BenchmarkCase
+{
+public:
+	PackingBenchmark( unsigned int rings );
+
+	virtual std::wstring GetName();
+	virtual unsigned int GetIterations();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+	virtual std::wstring GetReport();
+
+protected:
+	unsigned int				m_uiRings;
+	unsigned int				m_uiVertices;
+	unsigned int				m_uiUnpackedSize;
+	unsigned int				m_uiPackedSize;
+
+	Glyph3::GeometryPtr			m_pGeometry;
+	std::vector<char>			m_Bytes;
+	std::wstring				m_Errors;
+};
+//--------------------------------------------------------------------------------
+#endif // PackingBenchmark_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,108 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "ParameterLookupBenchmark.h"
+#include "ParameterNameTable.h"
+#include "IParameterManager.h"
+
+#include <sstream>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+// The number of parameters that each draw looks up.
+//--------------------------------------------------------------------------------
+static const unsigned int ParameterCount = 16;
+//--------------------------------------------------------------------------------
+ParameterLookupBenchmark::ParameterLookupBenchmark( unsigned int draws, bool byID ) :
+	m_uiDraws( draws ),
+	m_bByID( byID ),
+	m_pContainer( nullptr ),
+	m_uiMissing( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+std::wstring ParameterLookupBenchmark::GetName()
+{
+	std::wstringstream name;
+	name << L"ParameterLookup/" << ( m_bByID ? L"ID" : L"Name" ) << L"/" << m_uiDraws;
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+bool ParameterLookupBenchmark::Setup( App& app )
+{
+	IParameterManager* pParamMgr = app.m_pRenderer11->m_pParamMgr;
+
+	m_pContainer = new ParameterContainer();
+
+	Vector4f value( 1.0f, 1.0f, 1.0f, 1.0f );
+
+	for ( unsigned int i = 0; i < ParameterCount; i++ )
+	{
+		std::wstringstream name;
+		name << L"BenchmarkParameter" << i;
+
+		m_Names.push_back( name.str() );
+		m_pContainer->SetVectorParameter( name.str(), value );
+		pParamMgr->SetVectorParameter( name.str(), &value );
+
+		m_NameIDs.push_back( ParameterNameTable::Get()->Find( name.str() ) );
+	}
+
+	m_uiMissing = 0;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void ParameterLookupBenchmark::Run( App& app )
+{
+	IParameterManager* pParamMgr = app.m_pRenderer11->m_pParamMgr;
+
+	for ( unsigned int draw = 0; draw < m_uiDraws; draw++ )
+	{
+		for ( unsigned int i = 0; i < ParameterCount; i++ )
+		{
+			ParameterWriter* pWriter = nullptr;
+			RenderParameterDX11* pParameter = nullptr;
+
+			if ( m_bByID )
+			{
+				pWriter = m_pContainer->GetRenderParameter( m_NameIDs[i] );
+				pParameter = pParamMgr->GetParameterRef( m_NameIDs[i] );
+			}
+			else
+			{
+				pWriter = m_pContainer->GetRenderParameter( m_Names[i] );
+				pParameter = pParamMgr->GetParameterRef( m_Names[i] );
+			}
+
+			if ( pWriter == nullptr || pParameter == nullptr )
+				m_uiMissing++;
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+void ParameterLookupBenchmark::Shutdown( App& app )
+{
+	SAFE_DELETE( m_pContainer );
+
+	m_Names.clear();
+	m_NameIDs.clear();
+}
+//--------------------------------------------------------------------------------
+std::wstring ParameterLookupBenchmark::GetReport()
+{
+	// Every lookup should find its parameter, so this stays zero.
+
+	std::wstringstream report;
+	report << L"Missing parameters: " << m_uiMissing;
+
+	return( report.str() );
+}
+//--------------------------------------------------------------------------------
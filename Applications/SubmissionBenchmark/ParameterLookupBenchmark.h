@@ -0,0 +1,50 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// ParameterLookupBenchmark
+//
+// Looks up the writers of a parameter container and the parameters of the
+// renderer's parameter manager, as a material does for each draw.  The lookups
+// are either made by name, which goes through the parameter name table, or by
+// the name IDs that were interned beforehand, which doesn't.  The name lookups
+// per iteration are printed with the statistics of every case.
+//--------------------------------------------------------------------------------
+#ifndef ParameterLookupBenchmark_h
+#define ParameterLookupBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+#include "ParameterContainer.h"
+//--------------------------------------------------------------------------------
+class ParameterLookupBenchmark : public BenchmarkCase
+{
+public:
+	ParameterLookupBenchmark( unsigned int draws, bool byID );
+
+	virtual std::wstring GetName();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+	virtual std::wstring GetReport();
+
+protected:
+	unsigned int				m_uiDraws;
+	bool						m_bByID;
+
+	ParameterContainer*			m_pContainer;
+	std::vector<std::wstring>	m_Names;
+	std::vector<unsigned int>	m_NameIDs;
+	unsigned int				m_uiMissing;
+};
+//--------------------------------------------------------------------------------
+#endif // ParameterLookupBenchmark_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,455 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "PlyBenchmark.h"
+#include "GeometryLoaderDX11.h"
+#include "MemoryMappedFile.h"
+
+#include <sstream>
+#include <fstream>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+// The stream based reader, reduced to what the generated file needs.  Every
+// value is still parsed through its own string stream into its own allocation.
+//--------------------------------------------------------------------------------
+enum LegacyType
+{
+	LEGACY_CHAR,
+	LEGACY_UCHAR,
+	LEGACY_SHORT,
+	LEGACY_USHORT,
+	LEGACY_INT,
+	LEGACY_UINT,
+	LEGACY_FLOAT,
+	LEGACY_DOUBLE
+};
+
+struct LegacyProperty
+{
+	LegacyType		type;
+	LegacyType		listLengthType;
+	bool			isList;
+	std::string		name;
+};
+
+struct LegacyElement
+{
+	std::string						name;
+	int								count;
+	std::vector<LegacyProperty>		properties;
+	std::vector<void**>				data;
+};
+
+template<typename T>
+struct LegacyArray
+{
+	int		length;
+	T*		data;
+};
+//--------------------------------------------------------------------------------
+static LegacyType ParseLegacyType( const std::string& name )
+{
+	if ( name == "char" )	return( LEGACY_CHAR );
+	if ( name == "uchar" )	return( LEGACY_UCHAR );
+	if ( name == "short" )	return( LEGACY_SHORT );
+	if ( name == "ushort" )	return( LEGACY_USHORT );
+	if ( name == "int" )	return( LEGACY_INT );
+	if ( name == "uint" )	return( LEGACY_UINT );
+	if ( name == "double" )	return( LEGACY_DOUBLE );
+	return( LEGACY_FLOAT );
+}
+//--------------------------------------------------------------------------------
+template<typename T>
+static void* ExtractScalar( const std::string& token )
+{
+	T* t = new T;
+	std::istringstream iss( token );
+	iss >> *t;
+	return( t );
+}
+//--------------------------------------------------------------------------------
+template<typename T>
+static void* ExtractArray( int length, std::vector<std::string>::const_iterator it )
+{
+	LegacyArray<T>* t = new LegacyArray<T>;
+	t->length = length;
+	t->data = new T[length];
+
+	for ( int i = 0; i < length; ++i ) {
+		std::istringstream iss( *( ++it ) );
+		iss >> t->data[i];
+	}
+
+	return( t );
+}
+//--------------------------------------------------------------------------------
+template<typename T>
+static void ReleaseValue( void* p, bool isList )
+{
+	if ( isList ) {
+		LegacyArray<T>* pArray = static_cast<LegacyArray<T>*>( p );
+		delete[] pArray->data;
+		delete pArray;
+	} else {
+		delete static_cast<T*>( p );
+	}
+}
+//--------------------------------------------------------------------------------
+static void* ExtractValue( const LegacyProperty& prop, std::vector<std::string>::const_iterator& it )
+{
+	if ( prop.isList )
+	{
+		int length = 0;
+		std::istringstream iss( *it );
+		iss >> length;
+
+		void* p = nullptr;
+
+		switch ( prop.type )
+		{
+		case LEGACY_CHAR:	p = ExtractArray<char>( length, it ); break;
+		case LEGACY_UCHAR:	p = ExtractArray<unsigned char>( length, it ); break;
+		case LEGACY_SHORT:	p = ExtractArray<short>( length, it ); break;
+		case LEGACY_USHORT:	p = ExtractArray<unsigned short>( length, it ); break;
+		case LEGACY_INT:	p = ExtractArray<int>( length, it ); break;
+		case LEGACY_UINT:	p = ExtractArray<unsigned int>( length, it ); break;
+		case LEGACY_FLOAT:	p = ExtractArray<float>( length, it ); break;
+		case LEGACY_DOUBLE:	p = ExtractArray<double>( length, it ); break;
+		}
+
+		it += length;
+		return( p );
+	}
+
+	switch ( prop.type )
+	{
+	case LEGACY_CHAR:	return( ExtractScalar<char>( *it ) );
+	case LEGACY_UCHAR:	return( ExtractScalar<unsigned char>( *it ) );
+	case LEGACY_SHORT:	return( ExtractScalar<short>( *it ) );
+	case LEGACY_USHORT:	return( ExtractScalar<unsigned short>( *it ) );
+	case LEGACY_INT:	return( ExtractScalar<int>( *it ) );
+	case LEGACY_UINT:	return( ExtractScalar<unsigned int>( *it ) );
+	case LEGACY_FLOAT:	return( ExtractScalar<float>( *it ) );
+	default:			return( ExtractScalar<double>( *it ) );
+	}
+}
+//--------------------------------------------------------------------------------
+static void ReleaseElement( LegacyElement& element )
+{
+	for ( auto raw : element.data )
+	{
+		for ( size_t p = 0; p < element.properties.size(); p++ )
+		{
+			const LegacyProperty& prop = element.properties[p];
+
+			switch ( prop.type )
+			{
+			case LEGACY_CHAR:	ReleaseValue<char>( raw[p], prop.isList ); break;
+			case LEGACY_UCHAR:	ReleaseValue<unsigned char>( raw[p], prop.isList ); break;
+			case LEGACY_SHORT:	ReleaseValue<short>( raw[p], prop.isList ); break;
+			case LEGACY_USHORT:	ReleaseValue<unsigned short>( raw[p], prop.isList ); break;
+			case LEGACY_INT:	ReleaseValue<int>( raw[p], prop.isList ); break;
+			case LEGACY_UINT:	ReleaseValue<unsigned int>( raw[p], prop.isList ); break;
+			case LEGACY_FLOAT:	ReleaseValue<float>( raw[p], prop.isList ); break;
+			case LEGACY_DOUBLE:	ReleaseValue<double>( raw[p], prop.isList ); break;
+			}
+		}
+
+		delete[] raw;
+	}
+
+	element.data.clear();
+}
+//--------------------------------------------------------------------------------
+static int FindLegacyProperty( const LegacyElement& element, const std::string& name )
+{
+	for ( size_t i = 0; i < element.properties.size(); i++ )
+		if ( element.properties[i].name == name )
+			return( static_cast<int>( i ) );
+
+	return( -1 );
+}
+//--------------------------------------------------------------------------------
+PlyBenchmark::PlyBenchmark( unsigned int triangles, bool bMapped ) :
+	m_uiTriangles( triangles ),
+	m_bMapped( bMapped ),
+	m_FileSize( 0 ),
+	m_BytesParsed( 0 ),
+	m_Seconds( 0.0 ),
+	m_iVertices( 0 ),
+	m_uiIndices( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+std::wstring PlyBenchmark::GetName()
+{
+	std::wstringstream name;
+	name << L"Ply/" << m_uiTriangles << ( m_bMapped ? L"/mapped" : L"/streamed" );
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+unsigned int PlyBenchmark::GetIterations()
+{
+	return( 5 );
+}
+//--------------------------------------------------------------------------------
+bool PlyBenchmark::WriteFile()
+{
+	// Two triangles for each cell of a square grid over a gently curved surface.
+
+	unsigned int side = 1;
+	while ( 2 * side * side < m_uiTriangles )
+		side++;
+
+	const unsigned int vertices = ( side + 1 ) * ( side + 1 );
+
+	std::ofstream file( m_Filename, std::ios::out | std::ios::binary | std::ios::trunc );
+
+	if ( !file.is_open() )
+		return( false );
+
+	file << "ply\nformat ascii 1.0\ncomment generated by the submission benchmark\n"
+		<< "element vertex " << vertices << "\n"
+		<< "property float x\nproperty float y\nproperty float z\n"
+		<< "property float nx\nproperty float ny\nproperty float nz\n"
+		<< "element face " << m_uiTriangles << "\n"
+		<< "property list uchar int vertex_indices\nend_header\n";
+
+	char line[256];
+
+	for ( unsigned int z = 0; z <= side; z++ )
+	{
+		for ( unsigned int x = 0; x <= side; x++ )
+		{
+			const float height = 0.25f * sinf( 0.1f * x ) * cosf( 0.1f * z );
+
+			sprintf_s( line, "%f %f %f %f %f %f\n",
+				static_cast<float>( x ), height, static_cast<float>( z ), 0.0f, 1.0f, 0.0f );
+			file << line;
+		}
+	}
+
+	for ( unsigned int i = 0; i < m_uiTriangles; i++ )
+	{
+		const unsigned int a = ( i / 2 / side ) * ( side + 1 ) + ( i / 2 ) % side;
+
+		if ( i & 1 )
+			sprintf_s( line, "3 %u %u %u\n", a, a + side + 2, a + 1 );
+		else
+			sprintf_s( line, "3 %u %u %u\n", a, a + side + 1, a + side + 2 );
+
+		file << line;
+	}
+
+	m_FileSize = static_cast<unsigned long long>( file.tellp() );
+
+	return( file.good() );
+}
+//--------------------------------------------------------------------------------
+GeometryPtr PlyBenchmark::LoadStreamed()
+{
+	std::ifstream fin( m_Filename.c_str(), std::ios::in );
+
+	if ( !fin.is_open() )
+		return( nullptr );
+
+	std::string txt;
+	std::getline( fin, txt );
+	std::getline( fin, txt );
+
+	if ( txt != "format ascii 1.0" )
+		return( nullptr );
+
+	// Header: each element line is followed by its property lines.
+
+	std::vector<LegacyElement> elements;
+
+	while ( std::getline( fin, txt ) && txt != "end_header" )
+	{
+		if ( 0 == txt.compare( 0, 7, "element" ) )
+		{
+			LegacyElement element;
+
+			const size_t split = txt.find_first_of( ' ', 8 );
+			element.name = txt.substr( 8, split - 8 );
+
+			std::istringstream count( txt.substr( txt.rfind( ' ' ) ) );
+			count >> element.count;
+
+			elements.push_back( element );
+		}
+		else if ( 0 == txt.compare( 0, 13, "property list" ) && !elements.empty() )
+		{
+			// property list <length_type> <element_type> <name>
+			std::istringstream is( txt.substr( 14 ) );
+			std::string lengthType, type, name;
+			is >> lengthType >> type >> name;
+
+			LegacyProperty prop = { ParseLegacyType( type ), ParseLegacyType( lengthType ), true, name };
+			elements.back().properties.push_back( prop );
+		}
+		else if ( 0 == txt.compare( 0, 8, "property" ) && !elements.empty() )
+		{
+			// property <type> <name>
+			std::istringstream is( txt.substr( 9 ) );
+			std::string type, name;
+			is >> type >> name;
+
+			LegacyProperty prop = { ParseLegacyType( type ), LEGACY_UCHAR, false, name };
+			elements.back().properties.push_back( prop );
+		}
+	}
+
+	// Body: one line per element, split into tokens, with every value on the
+	// heap.
+
+	for ( auto& element : elements )
+	{
+		for ( int i = 0; i < element.count; ++i )
+		{
+			std::getline( fin, txt );
+
+			std::vector<std::string> tokens;
+			std::istringstream is( txt );
+			std::string token;
+			while ( is >> token )
+				tokens.push_back( token );
+
+			void** raw = new void*[element.properties.size()];
+			memset( raw, 0, sizeof( void* ) * element.properties.size() );
+
+			std::vector<std::string>::const_iterator it = tokens.begin();
+
+			for ( size_t p = 0; p < element.properties.size() && it != tokens.end(); p++, ++it )
+				raw[p] = ExtractValue( element.properties[p], it );
+
+			element.data.push_back( raw );
+		}
+	}
+
+	// Copy the values into the geometry.  The generated file only has float
+	// vertex properties and int indices.
+
+	GeometryPtr pGeometry = GeometryPtr( new GeometryDX11() );
+	pGeometry->SetPrimitiveType( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+
+	for ( auto& element : elements )
+	{
+		if ( element.name == "vertex" )
+		{
+			const char* semantics[2] = { "x", "nx" };
+
+			for ( unsigned int s = 0; s < 2; s++ )
+			{
+				const int index = FindLegacyProperty( element, semantics[s] );
+				if ( index < 0 )
+					continue;
+
+				VertexElementDX11* pElement = new VertexElementDX11( 3, element.count );
+				pElement->m_SemanticName = s == 0 ? VertexElementDX11::PositionSemantic : VertexElementDX11::NormalSemantic;
+				pElement->m_uiSemanticIndex = 0;
+				pElement->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
+				pElement->m_uiInputSlot = 0;
+				pElement->m_uiAlignedByteOffset = s == 0 ? 0 : D3D11_APPEND_ALIGNED_ELEMENT;
+				pElement->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+				pElement->m_uiInstanceDataStepRate = 0;
+
+				Vector3f* pData = pElement->Get3f( 0 );
+
+				for ( int v = 0; v < element.count; ++v )
+				{
+					void** raw = element.data[v];
+					pData[v] = Vector3f( *static_cast<float*>( raw[index] ),
+						*static_cast<float*>( raw[index + 1] ),
+						*static_cast<float*>( raw[index + 2] ) );
+				}
+
+				pGeometry->AddElement( pElement );
+			}
+		}
+		else if ( element.name == "face" && !element.properties.empty() && element.properties[0].type == LEGACY_INT )
+		{
+			for ( int f = 0; f < element.count; ++f )
+			{
+				LegacyArray<int>* pIndices = static_cast<LegacyArray<int>*>( element.data[f][0] );
+
+				for ( int i = 0; i < pIndices->length; ++i )
+					pGeometry->AddIndex( pIndices->data[i] );
+			}
+		}
+
+		ReleaseElement( element );
+	}
+
+	return( pGeometry );
+}
+//--------------------------------------------------------------------------------
+bool PlyBenchmark::Setup( App& app )
+{
+	std::wstringstream filename;
+	filename << L"Ply_" << m_uiTriangles << L".ply";
+	m_Filename = App::GetTempFilename( filename.str() );
+
+	m_BytesParsed = 0;
+	m_Seconds = 0.0;
+
+	return( WriteFile() );
+}
+//--------------------------------------------------------------------------------
+void PlyBenchmark::Run( App& app )
+{
+	LARGE_INTEGER frequency, start, end;
+	QueryPerformanceFrequency( &frequency );
+	QueryPerformanceCounter( &start );
+
+	GeometryPtr pGeometry;
+
+	if ( m_bMapped )
+	{
+		MemoryMappedFile file;
+
+		if ( file.Open( m_Filename ) )
+			pGeometry = GeometryLoaderDX11::loadStanfordPlyFromMemory( reinterpret_cast<const char*>( file.GetData() ), file.GetSize() );
+	}
+	else
+	{
+		pGeometry = LoadStreamed();
+	}
+
+	QueryPerformanceCounter( &end );
+
+	m_Seconds += static_cast<double>( end.QuadPart - start.QuadPart ) / static_cast<double>( frequency.QuadPart );
+	m_BytesParsed += m_FileSize;
+
+	if ( pGeometry ) {
+		m_iVertices = pGeometry->CalculateVertexCount();
+		m_uiIndices = pGeometry->GetIndexCount();
+	}
+}
+//--------------------------------------------------------------------------------
+void PlyBenchmark::Shutdown( App& app )
+{
+	if ( !m_Filename.empty() )
+		DeleteFileW( m_Filename.c_str() );
+}
+//--------------------------------------------------------------------------------
+std::wstring PlyBenchmark::GetReport()
+{
+	const double megabytes = static_cast<double>( m_BytesParsed ) / ( 1024.0 * 1024.0 );
+
+	std::wstringstream report;
+	report << L"File: " << m_FileSize / ( 1024 * 1024 ) << L" MB"
+		<< L", MB/s: " << ( m_Seconds > 0.0 ? megabytes / m_Seconds : 0.0 )
+		<< L", vertices: " << m_iVertices << L", indices: " << m_uiIndices;
+
+	return( report.str() );
+}
+//--------------------------------------------------------------------------------
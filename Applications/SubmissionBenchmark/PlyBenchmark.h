@@ -0,0 +1,60 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// PlyBenchmark
+//
+// Writes a generated ASCII PLY file with positions, normals and triangles to
+// the temporary folder, and parses it either from a memory mapped view with
+// GeometryLoaderDX11, or with a copy of the stream based reader that the 
+// loader used before.  That reader took each line into a string, split it with
+// a string stream, and allocated every value on the heap before copying it 
+// into the geometry.  It only read ASCII files, so that is what is compared.
+//
+// Neither side uses the geometry cache or creates buffers, and each load is
+// timed by the case itself to report the parsing rate in MB/s.
+//--------------------------------------------------------------------------------
+#ifndef PlyBenchmark_h
+#define PlyBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+#include "GeometryDX11.h"
+//--------------------------------------------------------------------------------
+class PlyBenchmark : public BenchmarkCase
+{
+public:
+	PlyBenchmark( unsigned int triangles, bool bMapped );
+
+	virtual std::wstring GetName();
+	virtual unsigned int GetIterations();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+	virtual std::wstring GetReport();
+
+protected:
+	bool WriteFile();
+	Glyph3::GeometryPtr LoadStreamed();
+
+	unsigned int		m_uiTriangles;
+	bool				m_bMapped;
+
+	std::wstring		m_Filename;
+	unsigned long long	m_FileSize;
+	unsigned long long	m_BytesParsed;
+	double				m_Seconds;
+	int					m_iVertices;
+	unsigned int		m_uiIndices;
+};
+//--------------------------------------------------------------------------------
+#endif // PlyBenchmark_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,164 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "RingAllocatorBenchmark.h"
+
+#include <sstream>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+// The frames that each run simulates, and the constant buffers of each frame.
+// The buffers are between 64 bytes and 1 KB, and are aligned like the offsets 
+// of the constant buffer binding methods.
+//--------------------------------------------------------------------------------
+static const unsigned int FramesPerRun = 100;
+static const unsigned int MinBuffersPerFrame = 64;
+static const unsigned int MaxBuffersPerFrame = 320;
+static const unsigned int Alignment = 256;
+//--------------------------------------------------------------------------------
+RingAllocatorBenchmark::RingAllocatorBenchmark( unsigned int capacity, unsigned int latency ) :
+	m_uiCapacity( ( capacity / Alignment ) * Alignment ),
+	m_uiLatency( latency > 0 ? latency : 1 ),
+	m_pAllocator( nullptr ),
+	m_ullFrame( 0 ),
+	m_ullCompleted( 0 ),
+	m_uiSeed( 1 ),
+	m_ullAllocations( 0 ),
+	m_ullFailures( 0 ),
+	m_ullOverlaps( 0 ),
+	m_uiPeakUsed( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+std::wstring RingAllocatorBenchmark::GetName()
+{
+	std::wstringstream name;
+	name << L"RingAllocator/" << m_uiCapacity / 1024 << L" KB/" << m_uiLatency << L" frames latency";
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+bool RingAllocatorBenchmark::Setup( App& app )
+{
+	m_pAllocator = new RingAllocator( m_uiCapacity, Alignment );
+
+	m_Owners.assign( m_uiCapacity / Alignment, 0 );
+	m_Live.clear();
+
+	m_ullFrame = 0;
+	m_ullCompleted = 0;
+	m_uiSeed = 1;
+
+	m_ullAllocations = 0;
+	m_ullFailures = 0;
+	m_ullOverlaps = 0;
+	m_uiPeakUsed = 0;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void RingAllocatorBenchmark::Run( App& app )
+{
+	for ( unsigned int i = 0; i < FramesPerRun; i++ )
+	{
+		// The GPU finishes the frames in order, lagging between one frame and
+		// the full latency behind the frame that has just been presented.
+
+		m_ullFrame++;
+		m_pAllocator->BeginFrame( m_ullFrame );
+
+		const unsigned int lag = 1 + Random() % m_uiLatency;
+
+		if ( m_ullFrame > lag && m_ullFrame - lag > m_ullCompleted ) {
+			m_ullCompleted = m_ullFrame - lag;
+			m_pAllocator->RetireFrames( m_ullCompleted );
+			Retire( m_ullCompleted );
+		}
+
+		const unsigned int buffers = MinBuffersPerFrame + Random() % ( MaxBuffersPerFrame - MinBuffersPerFrame + 1 );
+
+		for ( unsigned int j = 0; j < buffers; j++ )
+		{
+			const unsigned int size = 64 + 16 * ( Random() % 61 );
+			unsigned int offset = 0;
+
+			m_ullAllocations++;
+
+			if ( !m_pAllocator->Allocate( size, offset ) ) {
+				m_ullFailures++;
+				continue;
+			}
+
+			// The range has to lie within the ring, and must not touch a block
+			// that a frame the GPU may still be reading owns.
+
+			const unsigned int aligned = ( ( size + Alignment - 1 ) / Alignment ) * Alignment;
+
+			if ( offset % Alignment != 0 || offset + aligned > m_uiCapacity ) {
+				m_ullOverlaps++;
+				continue;
+			}
+
+			for ( unsigned int block = offset / Alignment; block < ( offset + aligned ) / Alignment; block++ )
+			{
+				if ( m_Owners[block] != 0 )
+					m_ullOverlaps++;
+
+				m_Owners[block] = m_ullFrame;
+			}
+
+			Range range = { m_ullFrame, offset, aligned };
+			m_Live.push_back( range );
+		}
+
+		m_uiPeakUsed = std::max( m_uiPeakUsed, m_pAllocator->GetUsedSize() );
+	}
+}
+//--------------------------------------------------------------------------------
+void RingAllocatorBenchmark::Shutdown( App& app )
+{
+	SAFE_DELETE( m_pAllocator );
+
+	m_Owners.clear();
+	m_Live.clear();
+}
+//--------------------------------------------------------------------------------
+std::wstring RingAllocatorBenchmark::GetReport()
+{
+	std::wstringstream report;
+	report << L"Allocations: " << m_ullAllocations
+		<< L", ring full: " << m_ullFailures
+		<< L", overlaps: " << m_ullOverlaps
+		<< L", peak use: " << m_uiPeakUsed / 1024 << L" KB";
+
+	return( report.str() );
+}
+//--------------------------------------------------------------------------------
+unsigned int RingAllocatorBenchmark::Random()
+{
+	m_uiSeed = m_uiSeed * 1664525 + 1013904223;
+	return( m_uiSeed >> 8 );
+}
+//--------------------------------------------------------------------------------
+void RingAllocatorBenchmark::Retire( unsigned long long frame )
+{
+	while ( !m_Live.empty() && m_Live.front().frame <= frame )
+	{
+		const Range& range = m_Live.front();
+
+		for ( unsigned int block = range.offset / Alignment; block < ( range.offset + range.size ) / Alignment; block++ )
+		{
+			if ( m_Owners[block] == range.frame )
+				m_Owners[block] = 0;
+		}
+
+		m_Live.pop_front();
+	}
+}
+//--------------------------------------------------------------------------------
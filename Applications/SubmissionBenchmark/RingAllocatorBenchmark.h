@@ -0,0 +1,76 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// RingAllocatorBenchmark
+//
+// Drives a RingAllocator the way the renderer drives the constant buffer rings,
+// with a burst of constant buffer sized allocations in each frame.  The frames
+// are retired by a simulated GPU that falls behind by a varying number of 
+// frames, up to the given latency, and only ever catches up in order.
+//
+// Every allocation is checked against the ranges that are still live, so the 
+// case also serves as a test of the allocator.  The report gives the number of
+// allocations, the ones that failed because the ring was full, the overlaps
+// with a live range (which must be zero) and the peak use of the ring.
+//--------------------------------------------------------------------------------
+#ifndef RingAllocatorBenchmark_h
+#define RingAllocatorBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+#include "RingAllocator.h"
+#include <deque>
+//--------------------------------------------------------------------------------
+class RingAllocatorBenchmark : public BenchmarkCase
+{
+public:
+	RingAllocatorBenchmark( unsigned int capacity, unsigned int latency );
+
+	virtual std::wstring GetName();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+	virtual std::wstring GetReport();
+
+protected:
+	struct Range
+	{
+		unsigned long long	frame;
+		unsigned int		offset;
+		unsigned int		size;
+	};
+
+	unsigned int Random();
+	void Retire( unsigned long long frame );
+
+	unsigned int					m_uiCapacity;
+	unsigned int					m_uiLatency;
+
+	Glyph3::RingAllocator*			m_pAllocator;
+
+	// The frame that owns each aligned block of the ring, or zero when it is
+	// free, and the live ranges from the oldest to the newest.
+	std::vector<unsigned long long>	m_Owners;
+	std::deque<Range>				m_Live;
+
+	unsigned long long				m_ullFrame;
+	unsigned long long				m_ullCompleted;
+	unsigned int					m_uiSeed;
+
+	unsigned long long				m_ullAllocations;
+	unsigned long long				m_ullFailures;
+	unsigned long long				m_ullOverlaps;
+	unsigned int					m_uiPeakUsed;
+};
+//--------------------------------------------------------------------------------
+#endif // RingAllocatorBenchmark_h
+//--------------------------------------------------------------------------------
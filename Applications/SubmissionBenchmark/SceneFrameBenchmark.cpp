@@ -0,0 +1,142 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "SceneFrameBenchmark.h"
+#include "Actor.h"
+#include "ViewPerspective.h"
+#include "RenderQueue.h"
+#include "GeometryGeneratorDX11.h"
+#include "MaterialGeneratorDX11.h"
+
+#include <sstream>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+SceneFrameBenchmark::SceneFrameBenchmark( unsigned int entities ) :
+	m_uiEntities( entities ),
+	m_pScene( nullptr ),
+	m_pCamera( nullptr ),
+	m_uiDraws( 0 ),
+	m_uiBatches( 0 ),
+	m_uiStateChanges( 0 )
+{
+	memset( &m_Statistics, 0, sizeof( m_Statistics ) );
+}
+//--------------------------------------------------------------------------------
+std::wstring SceneFrameBenchmark::GetName()
+{
+	std::wstringstream name;
+	name << L"SceneFrame/" << m_uiEntities;
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+bool SceneFrameBenchmark::Setup( App& app )
+{
+	RendererDX11* pRenderer = app.m_pRenderer11;
+
+	GeometryPtr pGeometry = GeometryPtr( new GeometryDX11() );
+	GeometryGeneratorDX11::GenerateSphere( pGeometry, 16, 8, 1.0f );
+	pGeometry->LoadToBuffers();
+
+	MaterialPtr pMaterial = MaterialGeneratorDX11::GeneratePhong( *pRenderer );
+
+	// Lay out the entities in a cube, with one node for each row of it.  The
+	// actor owns all of them, and is deleted together with the scene.
+
+	unsigned int side = 1;
+	while ( side * side * side < m_uiEntities )
+		side++;
+
+	const float spacing = 3.0f;
+	const float offset = 0.5f * spacing * static_cast<float>( side - 1 );
+
+	m_pScene = new Scene();
+	Actor* pActor = new Actor();
+
+	Node3D* pRow = nullptr;
+
+	for ( unsigned int i = 0; i < m_uiEntities; i++ )
+	{
+		if ( i % side == 0 )
+		{
+			pRow = new Node3D();
+			pActor->GetNode()->AttachChild( pRow );
+			pActor->AddElement( pRow );
+		}
+
+		// The bounding sphere of the unit sphere geometry, without which the
+		// entity could never be culled.
+
+		Entity3D* pEntity = new Entity3D();
+		pEntity->Visual.SetGeometry( pGeometry );
+		pEntity->Visual.SetMaterial( pMaterial );
+		pEntity->Shape.AddSphere( Sphere3f( Vector3f( 0.0f, 0.0f, 0.0f ), 1.0f ) );
+		pEntity->Transform.Position() = Vector3f(
+			static_cast<float>( i % side ) * spacing - offset,
+			static_cast<float>( ( i / side ) % side ) * spacing - offset,
+			static_cast<float>( i / ( side * side ) ) * spacing - offset );
+
+		pRow->AttachChild( pEntity );
+		pActor->AddElement( pEntity );
+	}
+
+	m_pScene->AddActor( pActor );
+
+	// The camera looks along the z-axis from the center of the cube, so that
+	// about half of the entities are outside of its view.
+
+	m_pCamera = new Camera();
+	m_pCamera->Spatial().SetTranslation( Vector3f( 0.0f, 0.0f, 0.0f ) );
+	m_pCamera->SetCameraView( new ViewPerspective( *pRenderer, app.m_RenderTarget, app.m_DepthTarget ) );
+	m_pCamera->SetProjectionParams( 0.1f, 1000.0f, static_cast<float>( App::Width ) / static_cast<float>( App::Height ),
+		static_cast<float>( GLYPH_PI ) / 4.0f );
+
+	m_pScene->AddCamera( m_pCamera );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void SceneFrameBenchmark::Run( App& app )
+{
+	m_pScene->Update( 1.0f / 60.0f );
+	m_pScene->Render( app.m_pRenderer11 );
+}
+//--------------------------------------------------------------------------------
+void SceneFrameBenchmark::Shutdown( App& app )
+{
+	// The scene deletes its actors, including the camera and its render view,
+	// so the culling and sorting results of the last frame are kept for the
+	// report.
+
+	SceneRenderTask* pView = m_pCamera->GetCameraView();
+	const RenderQueue& queue = pView->GetRenderQueue();
+
+	m_Statistics = pView->GetCullStatistics();
+	m_uiDraws = queue.GetCount();
+	m_uiBatches = queue.GetBatchCount();
+	m_uiStateChanges = queue.GetStateChangeCount();
+
+	SAFE_DELETE( m_pScene );
+	m_pCamera = nullptr;
+}
+//--------------------------------------------------------------------------------
+std::wstring SceneFrameBenchmark::GetReport()
+{
+	std::wstringstream report;
+	report << L"Drawn: " << m_Statistics.drawn
+		<< L", Culled: " << m_Statistics.culled
+		<< L", Nodes culled: " << m_Statistics.nodesCulled
+		<< L", Spheres tested: " << m_Statistics.spheresTested
+		<< L", Batches: " << m_uiBatches << L" for " << m_uiDraws << L" draws"
+		<< L", State changes: " << m_uiStateChanges;
+
+	return( report.str() );
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,53 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// SceneFrameBenchmark
+//
+// Updates and renders a complete frame of a scene with a grid of entities that
+// share one geometry and material.  The entities are grouped below a node per
+// row, and the camera sits in the middle of the grid so that part of it is
+// culled.  This covers the scene update, the bounds, the render queue and the
+// application of the pipeline state for each draw.  The report gives the
+// culling results of the camera's view in the last frame.
+//--------------------------------------------------------------------------------
+#ifndef SceneFrameBenchmark_h
+#define SceneFrameBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+#include "Scene.h"
+#include "Camera.h"
+#include "SceneRenderTask.h"
+//--------------------------------------------------------------------------------
+class SceneFrameBenchmark : public BenchmarkCase
+{
+public:
+	SceneFrameBenchmark( unsigned int entities );
+
+	virtual std::wstring GetName();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+	virtual std::wstring GetReport();
+
+protected:
+	unsigned int	m_uiEntities;
+	Scene*			m_pScene;
+	Camera*			m_pCamera;
+	CullStatistics	m_Statistics;
+	unsigned int	m_uiDraws;
+	unsigned int	m_uiBatches;
+	unsigned int	m_uiStateChanges;
+};
+//--------------------------------------------------------------------------------
+#endif // SceneFrameBenchmark_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,95 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "SceneUpdateBenchmark.h"
+#include "Actor.h"
+#include "RotationController.h"
+
+#include <sstream>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+// The shape of the graph: the subtrees below the root, and the entities that
+// each rotating node carries.
+//--------------------------------------------------------------------------------
+static const unsigned int SubtreeCount = 64;
+static const unsigned int EntitiesPerNode = 15;
+//--------------------------------------------------------------------------------
+SceneUpdateBenchmark::SceneUpdateBenchmark( unsigned int objects, unsigned int threads ) :
+	m_uiObjects( objects ),
+	m_uiThreads( threads > 0 ? threads : 1 ),
+	m_pScene( nullptr )
+{
+}
+//--------------------------------------------------------------------------------
+std::wstring SceneUpdateBenchmark::GetName()
+{
+	std::wstringstream name;
+	name << L"SceneUpdate/" << m_uiObjects << L"/" << m_uiThreads << ( m_uiThreads > 1 ? L" threads" : L" thread" );
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+bool SceneUpdateBenchmark::Setup( App& app )
+{
+	app.SetThreadCount( m_uiThreads );
+
+	m_pScene = new Scene();
+	m_pScene->SetParallelUpdate( m_uiThreads > 1 );
+
+	// Each subtree is an actor, which owns its nodes and entities and is
+	// deleted together with the scene.  The nodes are dealt out to the
+	// subtrees in turn.
+
+	std::vector<Actor*> subtrees;
+
+	for ( unsigned int i = 0; i < SubtreeCount; i++ )
+	{
+		subtrees.push_back( new Actor() );
+		m_pScene->AddActor( subtrees.back() );
+	}
+
+	const unsigned int nodes = m_uiObjects / ( EntitiesPerNode + 1 );
+
+	for ( unsigned int i = 0; i < nodes; i++ )
+	{
+		Actor* pActor = subtrees[i % SubtreeCount];
+
+		Node3D* pNode = new Node3D();
+		pNode->Transform.Position() = Vector3f( static_cast<float>( i % 100 ), static_cast<float>( i / 100 ), 0.0f );
+		pNode->Controllers.Attach( new RotationController<Node3D>( Vector3f( 0.0f, 1.0f, 0.0f ), 1.0f ) );
+
+		pActor->GetNode()->AttachChild( pNode );
+		pActor->AddElement( pNode );
+
+		for ( unsigned int j = 0; j < EntitiesPerNode; j++ )
+		{
+			Entity3D* pEntity = new Entity3D();
+			pEntity->Transform.Position() = Vector3f( static_cast<float>( j ), 0.0f, 0.0f );
+
+			pNode->AttachChild( pEntity );
+			pActor->AddElement( pEntity );
+		}
+	}
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void SceneUpdateBenchmark::Run( App& app )
+{
+	m_pScene->Update( 1.0f / 60.0f );
+}
+//--------------------------------------------------------------------------------
+void SceneUpdateBenchmark::Shutdown( App& app )
+{
+	SAFE_DELETE( m_pScene );
+
+	app.SetThreadCount( 0 );
+}
+//--------------------------------------------------------------------------------
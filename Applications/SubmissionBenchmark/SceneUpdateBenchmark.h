@@ -0,0 +1,45 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// SceneUpdateBenchmark
+//
+// Updates a synthetic scene graph with a given number of threads, to show how
+// the parallel scene update scales.  The graph is split into many subtrees
+// below the root, each made of nodes that are turned by a rotation controller
+// and carry a few entities, so that every transform is rebuilt in every frame.
+// One thread runs the serial update, and more threads run the parallel update
+// on a job system with one worker less, since the calling thread takes part.
+//--------------------------------------------------------------------------------
+#ifndef SceneUpdateBenchmark_h
+#define SceneUpdateBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+#include "Scene.h"
+//--------------------------------------------------------------------------------
+class SceneUpdateBenchmark : public BenchmarkCase
+{
+public:
+	SceneUpdateBenchmark( unsigned int objects, unsigned int threads );
+
+	virtual std::wstring GetName();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+protected:
+	unsigned int	m_uiObjects;
+	unsigned int	m_uiThreads;
+	Scene*			m_pScene;
+};
+//--------------------------------------------------------------------------------
+#endif // SceneUpdateBenchmark_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,121 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "SkeletonBenchmark.h"
+#include "JobSystem.h"
+
+#include <sstream>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+// The number of chains that start at the root bone.
+//--------------------------------------------------------------------------------
+static const unsigned int ChainCount = 5;
+//--------------------------------------------------------------------------------
+SkeletonBenchmark::SkeletonBenchmark( unsigned int actors, unsigned int bones, unsigned int threads ) :
+	m_uiActors( actors ),
+	m_uiBones( bones > 0 ? bones : 1 ),
+	m_uiThreads( threads > 0 ? threads : 1 ),
+	m_uiFrame( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+std::wstring SkeletonBenchmark::GetName()
+{
+	std::wstringstream name;
+	name << L"Skeleton/" << ( GLYPH_SSE_MATH ? L"SSE" : L"Scalar" ) << L"/" << m_uiActors << L"x" << m_uiBones
+		<< L"/" << m_uiThreads << ( m_uiThreads > 1 ? L" threads" : L" thread" );
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+bool SkeletonBenchmark::Setup( App& app )
+{
+	app.SetThreadCount( m_uiThreads );
+
+	// Bone zero is the root, and the others are dealt out to the chains in
+	// turn, each one the child of the previous bone of its chain.
+
+	std::vector<int> parents( m_uiBones );
+
+	for ( unsigned int i = 0; i < m_uiBones; i++ )
+		parents[i] = ( i == 0 ) ? -1 : ( i <= ChainCount ? 0 : static_cast<int>( i - ChainCount ) );
+
+	for ( unsigned int a = 0; a < m_uiActors; a++ )
+	{
+		SkeletonEvaluator* pSkeleton = new SkeletonEvaluator();
+		m_Skeletons.push_back( pSkeleton );
+
+		if ( !pSkeleton->SetParents( parents ) )
+			return( false );
+
+		for ( unsigned int i = 0; i < m_uiBones; i++ )
+		{
+			Matrix4f inverse = Matrix4f::TranslationMatrix( 0.0f, -0.5f * static_cast<float>( i ), 0.0f );
+			pSkeleton->SetInverseBindPose( i, inverse );
+		}
+	}
+
+	m_SkinMatrices.resize( m_uiActors * m_uiBones );
+	m_NormalMatrices.resize( m_uiActors * m_uiBones );
+	m_uiFrame = 0;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void SkeletonBenchmark::Run( App& app )
+{
+	const float time = static_cast<float>( m_uiFrame++ ) / 60.0f;
+
+	auto UpdateSkeletons = [&]( unsigned int begin, unsigned int end )
+	{
+		for ( unsigned int a = begin; a < end; a++ )
+		{
+			SkeletonEvaluator* pSkeleton = m_Skeletons[a];
+
+			for ( unsigned int i = 0; i < m_uiBones; i++ )
+			{
+				const float phase = time + 0.1f * static_cast<float>( i + a );
+				pSkeleton->SetLocalPose( i, Vector3f( 0.0f, 0.5f, 0.0f ),
+					Vector3f( 0.3f * sinf( phase ), 0.2f * cosf( phase ), 0.1f * sinf( 2.0f * phase ) ),
+					Vector3f( 1.0f, 1.0f, 1.0f ) );
+			}
+
+			pSkeleton->Evaluate( Matrix4f::Identity(), &m_SkinMatrices[a * m_uiBones], &m_NormalMatrices[a * m_uiBones] );
+		}
+	};
+
+	JobSystem* pJobs = JobSystem::Get();
+
+	if ( pJobs )
+		pJobs->ParallelFor( m_uiActors, 16, UpdateSkeletons );
+	else
+		UpdateSkeletons( 0, m_uiActors );
+}
+//--------------------------------------------------------------------------------
+void SkeletonBenchmark::Shutdown( App& app )
+{
+	for ( auto pSkeleton : m_Skeletons )
+		delete pSkeleton;
+	m_Skeletons.clear();
+
+	m_SkinMatrices.clear();
+	m_NormalMatrices.clear();
+
+	app.SetThreadCount( 0 );
+}
+//--------------------------------------------------------------------------------
+std::wstring SkeletonBenchmark::GetReport()
+{
+	std::wstringstream report;
+	report << L"Bones per iteration: " << m_uiActors * m_uiBones;
+
+	return( report.str() );
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,56 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// SkeletonBenchmark
+//
+// Poses and evaluates a number of skeletons once per iteration, the way that
+// SkinnedActor::SetSkinningMatrices does for the skinned actors of a frame:
+// the skeletons are split across the job system in batches, and each one 
+// writes its skinning and normal matrices.  Each bone's rotation changes with
+// every iteration, so the local poses are rebuilt as they are when animating.
+//
+// The bones of a skeleton form a few chains from the root, like the limbs of a
+// character.  As with MatrixBenchmark, the name includes whether the library 
+// was built with the SSE or the scalar kernels (GLYPH_SSE_MATH), and the
+// thread counts follow SceneUpdateBenchmark.
+//--------------------------------------------------------------------------------
+#ifndef SkeletonBenchmark_h
+#define SkeletonBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+#include "SkeletonEvaluator.h"
+//--------------------------------------------------------------------------------
+class SkeletonBenchmark : public BenchmarkCase
+{
+public:
+	SkeletonBenchmark( unsigned int actors, unsigned int bones, unsigned int threads );
+
+	virtual std::wstring GetName();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+	virtual std::wstring GetReport();
+
+protected:
+	unsigned int						m_uiActors;
+	unsigned int						m_uiBones;
+	unsigned int						m_uiThreads;
+	unsigned int						m_uiFrame;
+
+	std::vector<Glyph3::SkeletonEvaluator*>	m_Skeletons;
+	std::vector<Glyph3::Matrix4f>		m_SkinMatrices;
+	std::vector<Glyph3::Matrix4f>		m_NormalMatrices;
+};
+//--------------------------------------------------------------------------------
+#endif // SkeletonBenchmark_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,117 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "StateArrayBenchmark.h"
+
+#include <sstream>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+// The slots that each material sets, like a few textures at the start and an
+// environment map that is bound to a fixed slot further up.  Both materials
+// also share the resource in between, such as a shadow map.
+//--------------------------------------------------------------------------------
+static const unsigned int MaterialSlots[] = { 0, 1, 2, 3, 16 };
+static const unsigned int MaterialSlotCount = sizeof( MaterialSlots ) / sizeof( MaterialSlots[0] );
+static const unsigned int SharedSlot = 8;
+//--------------------------------------------------------------------------------
+StateArrayBenchmark::StateArrayBenchmark( unsigned int draws, bool diff ) :
+	m_uiDraws( draws ),
+	m_bDiff( diff ),
+	m_pDesired( nullptr ),
+	m_pCurrent( nullptr ),
+	m_ullBindCalls( 0 ),
+	m_ullBoundSlots( 0 ),
+	m_ullDraws( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+StateArrayBenchmark::~StateArrayBenchmark()
+{
+}
+//--------------------------------------------------------------------------------
+std::wstring StateArrayBenchmark::GetName()
+{
+	std::wstringstream name;
+	name << L"StateArray/" << ( m_bDiff ? L"Diff" : L"Copy" ) << L"/" << m_uiDraws;
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+bool StateArrayBenchmark::Setup( App& app )
+{
+	m_pDesired = new SlotMonitor( 0 );
+	m_pCurrent = new SlotMonitor( 0 );
+	m_pDesired->SetSister( m_pCurrent );
+
+	m_ullBindCalls = 0;
+	m_ullBoundSlots = 0;
+	m_ullDraws = 0;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void StateArrayBenchmark::Run( App& app )
+{
+	for ( unsigned int draw = 0; draw < m_uiDraws; draw++ )
+	{
+		const int material = static_cast<int>( draw & 1 ) + 1;
+
+		for ( unsigned int i = 0; i < MaterialSlotCount; i++ )
+			m_pDesired->SetState( MaterialSlots[i], material * 100 + static_cast<int>( i ) );
+
+		m_pDesired->SetState( SharedSlot, 1 );
+
+		if ( !m_pDesired->IsUpdateNeeded() )
+			continue;
+
+		if ( m_bDiff )
+		{
+			unsigned int start = 0;
+			unsigned int count = 0;
+
+			while ( m_pDesired->GetNextRange( start, count ) )
+			{
+				m_ullBindCalls++;
+				m_ullBoundSlots += count;
+				start += count;
+			}
+
+			m_pDesired->CommitToSister();
+		}
+		else
+		{
+			m_ullBindCalls++;
+			m_ullBoundSlots += m_pDesired->GetRange();
+
+			*m_pCurrent = *m_pDesired;
+			m_pDesired->ResetTracking();
+		}
+	}
+
+	m_ullDraws += m_uiDraws;
+}
+//--------------------------------------------------------------------------------
+void StateArrayBenchmark::Shutdown( App& app )
+{
+	SAFE_DELETE( m_pDesired );
+	SAFE_DELETE( m_pCurrent );
+}
+//--------------------------------------------------------------------------------
+std::wstring StateArrayBenchmark::GetReport()
+{
+	const double draws = m_ullDraws > 0 ? static_cast<double>( m_ullDraws ) : 1.0;
+
+	std::wstringstream report;
+	report << L"Bind calls per draw: " << static_cast<double>( m_ullBindCalls ) / draws
+		<< L", Bound slots per draw: " << static_cast<double>( m_ullBoundSlots ) / draws;
+
+	return( report.str() );
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,65 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// StateArrayBenchmark
+//
+// Applies the shader resource slots of a series of draws with a pair of
+// TStateArrayMonitors, as a shader stage does with its desired and current
+// states.  Consecutive draws alternate between two materials, which use a few
+// slots at the start of the array and one slot further up, and share a slot in
+// between.
+//
+// The diff mode binds the merged ranges of changed slots and commits only those
+// slots to the current state.  The copy mode binds everything between the first
+// and the last changed slot and then copies the whole desired state, as the
+// stages did before slot tracking.  The report gives the bind calls and bound
+// slots per draw.
+//--------------------------------------------------------------------------------
+#ifndef StateArrayBenchmark_h
+#define StateArrayBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+#include "TStateArrayMonitor.h"
+//--------------------------------------------------------------------------------
+class StateArrayBenchmark : public BenchmarkCase
+{
+public:
+	StateArrayBenchmark( unsigned int draws, bool diff );
+	virtual ~StateArrayBenchmark();
+
+	virtual std::wstring GetName();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+	virtual std::wstring GetReport();
+
+	// The size of the shader resource view array of a stage.
+
+	static const unsigned int SlotCount = D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT;
+
+protected:
+	typedef TStateArrayMonitor<int, SlotCount> SlotMonitor;
+
+	unsigned int		m_uiDraws;
+	bool				m_bDiff;
+
+	SlotMonitor*		m_pDesired;
+	SlotMonitor*		m_pCurrent;
+
+	unsigned long long	m_ullBindCalls;
+	unsigned long long	m_ullBoundSlots;
+	unsigned long long	m_ullDraws;
+};
+//--------------------------------------------------------------------------------
+#endif // StateArrayBenchmark_h
+//--------------------------------------------------------------------------------
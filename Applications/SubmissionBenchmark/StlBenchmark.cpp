@@ -0,0 +1,194 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "StlBenchmark.h"
+#include "StlImporterDX11.h"
+#include "MeshSTL.h"
+
+#include <sstream>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <psapi.h>
+
+#pragma comment( lib, "psapi.lib" )
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+static unsigned long long GetPrivateBytes()
+{
+	PROCESS_MEMORY_COUNTERS_EX counters;
+	counters.cb = sizeof( counters );
+
+	if ( !GetProcessMemoryInfo( GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>( &counters ), sizeof( counters ) ) )
+		return( 0 );
+
+	return( counters.PrivateUsage );
+}
+//--------------------------------------------------------------------------------
+StlBenchmark::StlBenchmark( unsigned int facets, bool bAscii, bool bImporter ) :
+	m_uiFacets( facets ),
+	m_bAscii( bAscii ),
+	m_bImporter( bImporter ),
+	m_FileSize( 0 ),
+	m_PeakBytes( 0 ),
+	m_uiVertices( 0 ),
+	m_uiTriangles( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+std::wstring StlBenchmark::GetName()
+{
+	std::wstringstream name;
+	name << L"Stl/" << m_uiFacets << ( m_bAscii ? L"/ascii" : L"/binary" ) 
+		<< ( m_bImporter ? L"/importer" : L"/MeshSTL" );
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+unsigned int StlBenchmark::GetIterations()
+{
+	return( 5 );
+}
+//--------------------------------------------------------------------------------
+bool StlBenchmark::WriteFile()
+{
+	// The facets are the two triangles of each cell of a square grid over a 
+	// gently curved surface, with the facet normals written to the file.
+
+	unsigned int side = 1;
+	while ( 2 * side * side < m_uiFacets )
+		side++;
+
+	std::ofstream file( m_Filename, std::ios::out | std::ios::binary | std::ios::trunc );
+
+	if ( !file.is_open() )
+		return( false );
+
+	if ( m_bAscii ) {
+		file << "solid benchmark\n";
+	} else {
+		char header[80] = { 0 };
+		file.write( header, sizeof( header ) );
+		file.write( reinterpret_cast<const char*>( &m_uiFacets ), sizeof( m_uiFacets ) );
+	}
+
+	unsigned int written = 0;
+	char line[512];
+
+	for ( unsigned int i = 0; written < m_uiFacets; i++ )
+	{
+		const unsigned int x = ( i / 2 ) % side;
+		const unsigned int z = ( i / 2 ) / side;
+
+		Vector3f corners[4];
+		for ( unsigned int c = 0; c < 4; c++ ) {
+			const float cx = static_cast<float>( x + ( c & 1 ) );
+			const float cz = static_cast<float>( z + ( c >> 1 ) );
+			corners[c] = Vector3f( cx, 0.25f * sinf( 0.1f * cx ) * cosf( 0.1f * cz ), cz );
+		}
+
+		Vector3f facet[4];
+		facet[1] = corners[0];
+		facet[2] = ( i & 1 ) ? corners[3] : corners[2];
+		facet[3] = ( i & 1 ) ? corners[1] : corners[3];
+		facet[0] = Vector3f::Normalize( Vector3f::Cross( facet[2] - facet[1], facet[3] - facet[1] ) );
+
+		if ( m_bAscii ) {
+			sprintf_s( line, "facet normal %e %e %e\n outer loop\n  vertex %e %e %e\n  vertex %e %e %e\n  vertex %e %e %e\n endloop\nendfacet\n",
+				facet[0].x, facet[0].y, facet[0].z, facet[1].x, facet[1].y, facet[1].z,
+				facet[2].x, facet[2].y, facet[2].z, facet[3].x, facet[3].y, facet[3].z );
+			file << line;
+		} else {
+			const unsigned short attributes = 0;
+			file.write( reinterpret_cast<const char*>( facet ), sizeof( facet ) );
+			file.write( reinterpret_cast<const char*>( &attributes ), sizeof( attributes ) );
+		}
+
+		written++;
+	}
+
+	if ( m_bAscii )
+		file << "endsolid benchmark\n";
+
+	m_FileSize = static_cast<unsigned long long>( file.tellp() );
+
+	return( file.good() );
+}
+//--------------------------------------------------------------------------------
+bool StlBenchmark::Setup( App& app )
+{
+	if ( m_bAscii && !m_bImporter )
+		return( false );
+
+	std::wstringstream filename;
+	filename << L"Stl_" << m_uiFacets << ( m_bAscii ? L"_ascii" : L"_binary" ) << L".stl";
+	m_Filename = App::GetTempFilename( filename.str() );
+
+	m_PeakBytes = 0;
+
+	return( WriteFile() );
+}
+//--------------------------------------------------------------------------------
+void StlBenchmark::Run( App& app )
+{
+	const unsigned long long baseline = GetPrivateBytes();
+	unsigned long long peak = baseline;
+	std::atomic<bool> bDone( false );
+
+	std::thread sampler( [&]()
+	{
+		while ( !bDone ) {
+			peak = std::max( peak, GetPrivateBytes() );
+			Sleep( 1 );
+		}
+	} );
+
+	// The result is kept until the sampling has stopped, so that it counts
+	// towards the peak as well.
+
+	GeometryPtr pGeometry;
+	std::unique_ptr<STL::MeshSTL> pMesh;
+
+	if ( m_bImporter )
+		pGeometry = StlImporterDX11::Load( m_Filename );
+	else
+		pMesh.reset( new STL::MeshSTL( m_Filename ) );
+
+	bDone = true;
+	sampler.join();
+
+	peak = std::max( peak, GetPrivateBytes() );
+	m_PeakBytes = std::max( m_PeakBytes, peak - baseline );
+
+	if ( pGeometry ) {
+		m_uiVertices = static_cast<unsigned int>( pGeometry->CalculateVertexCount() );
+		m_uiTriangles = pGeometry->GetIndexCount() / 3;
+	} else if ( pMesh ) {
+		m_uiVertices = 3 * static_cast<unsigned int>( pMesh->faces.size() );
+		m_uiTriangles = static_cast<unsigned int>( pMesh->faces.size() );
+	}
+}
+//--------------------------------------------------------------------------------
+void StlBenchmark::Shutdown( App& app )
+{
+	if ( !m_Filename.empty() )
+		DeleteFileW( m_Filename.c_str() );
+}
+//--------------------------------------------------------------------------------
+std::wstring StlBenchmark::GetReport()
+{
+	std::wstringstream report;
+	report << L"File: " << m_FileSize / ( 1024 * 1024 ) << L" MB"
+		<< L", vertices: " << m_uiVertices << L", triangles: " << m_uiTriangles
+		<< L", peak private bytes: " << m_PeakBytes / ( 1024 * 1024 ) << L" MB";
+
+	return( report.str() );
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,59 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// StlBenchmark
+//
+// Writes a generated STL file with the given number of facets to the temporary
+// folder, and then loads it either with StlImporterDX11 or with MeshSTL.  The 
+// facets form a grid, so the importer welds the corners to about half as many
+// positions as there are facets.  MeshSTL only reads binary files, so the 
+// ASCII file is only loaded by the importer.
+//
+// Besides the load time, the report gives the peak of the private bytes of the
+// process above what it used before the load, including the loaded result.  It
+// is sampled every millisecond on a separate thread, so it may miss a short 
+// lived peak, but it is the same for both loaders.
+//--------------------------------------------------------------------------------
+#ifndef StlBenchmark_h
+#define StlBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+//--------------------------------------------------------------------------------
+class StlBenchmark : public BenchmarkCase
+{
+public:
+	StlBenchmark( unsigned int facets, bool bAscii, bool bImporter );
+
+	virtual std::wstring GetName();
+	virtual unsigned int GetIterations();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+	virtual std::wstring GetReport();
+
+protected:
+	bool WriteFile();
+
+	unsigned int		m_uiFacets;
+	bool				m_bAscii;
+	bool				m_bImporter;
+
+	std::wstring		m_Filename;
+	unsigned long long	m_FileSize;
+	unsigned long long	m_PeakBytes;
+	unsigned int		m_uiVertices;
+	unsigned int		m_uiTriangles;
+};
+//--------------------------------------------------------------------------------
+#endif // StlBenchmark_h
+//--------------------------------------------------------------------------------
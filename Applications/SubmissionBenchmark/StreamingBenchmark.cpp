@@ -0,0 +1,120 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "StreamingBenchmark.h"
+#include "GeometryStreamRequestDX11.h"
+#include "TextureStreamRequestDX11.h"
+
+#include <sstream>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+static const wchar_t* Textures[] =
+{
+	L"EyeOfHorus.png",
+	L"Hex.png",
+	L"Hex_Normal.png",
+	L"Outcrop.png",
+	L"Tiles.png",
+	L"fruit.png"
+};
+//--------------------------------------------------------------------------------
+StreamingBenchmark::StreamingBenchmark( const std::wstring& model ) :
+	m_Model( model ),
+	m_pStreamer( nullptr ),
+	m_uiFrames( 0 ),
+	m_uiRuns( 0 )
+{
+	memset( &m_Statistics, 0, sizeof( m_Statistics ) );
+}
+//--------------------------------------------------------------------------------
+std::wstring StreamingBenchmark::GetName()
+{
+	return( L"Streaming/" + m_Model );
+}
+//--------------------------------------------------------------------------------
+unsigned int StreamingBenchmark::GetIterations()
+{
+	return( 10 );
+}
+//--------------------------------------------------------------------------------
+bool StreamingBenchmark::Setup( App& app )
+{
+	m_pStreamer = new ResourceStreamer();
+	m_pStreamer->SetHitchThreshold( 1000.0f / 60.0f );
+
+	m_uiFrames = 0;
+	m_uiRuns = 0;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void StreamingBenchmark::Run( App& app )
+{
+	std::vector<StreamRequestPtr> requests;
+
+	requests.push_back( StreamRequestPtr( new GeometryStreamRequestDX11( m_Model ) ) );
+
+	for ( auto texture : Textures )
+		requests.push_back( StreamRequestPtr( new TextureStreamRequestDX11( texture ) ) );
+
+	for ( auto& pRequest : requests )
+		m_pStreamer->Submit( pRequest );
+
+	// One update per frame until every request is done, and one more to end the
+	// last streaming frame.
+
+	bool bDone = false;
+
+	while ( !bDone )
+	{
+		m_pStreamer->Update();
+		m_uiFrames++;
+
+		bDone = true;
+		for ( auto& pRequest : requests )
+			bDone = bDone && pRequest->IsDone();
+	}
+
+	m_pStreamer->Update();
+	m_uiRuns++;
+
+	// The textures are registered with the renderer, so they are released
+	// again to keep the runs alike.
+
+	for ( unsigned int i = 1; i < requests.size(); i++ )
+	{
+		ResourcePtr texture = static_cast<TextureStreamRequestDX11*>( requests[i].get() )->GetTexture();
+
+		if ( texture )
+			app.m_pRenderer11->DeleteResource( texture );
+	}
+}
+//--------------------------------------------------------------------------------
+void StreamingBenchmark::Shutdown( App& app )
+{
+	m_Statistics = m_pStreamer->GetStatistics();
+
+	delete m_pStreamer;
+	m_pStreamer = nullptr;
+}
+//--------------------------------------------------------------------------------
+std::wstring StreamingBenchmark::GetReport()
+{
+	std::wstringstream report;
+	report << L"Frames/run: " << ( m_uiRuns > 0 ? m_uiFrames / m_uiRuns : 0 )
+		<< L", completed: " << m_Statistics.completed
+		<< L", failed: " << m_Statistics.failed
+		<< L", hitch frames: " << m_Statistics.hitchFrames << L"/" << m_Statistics.streamingFrames
+		<< L", max frame: " << m_Statistics.maximumFrameTime << L" ms"
+		<< L", max finalize: " << m_Statistics.maximumFinalizeTime << L" ms";
+
+	return( report.str() );
+}
+//--------------------------------------------------------------------------------
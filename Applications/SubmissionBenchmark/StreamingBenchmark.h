@@ -0,0 +1,50 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// StreamingBenchmark
+//
+// Streams a model and a set of textures with a ResourceStreamer, and updates
+// the streamer once per frame until everything is loaded, the way that the
+// application does.  Nothing else happens in a frame, so the frame time is the
+// time spent in Update finalizing requests.  The report gives the streamer
+// statistics over all of the runs, with the hitch threshold set to a 60 Hz
+// frame.
+//--------------------------------------------------------------------------------
+#ifndef StreamingBenchmark_h
+#define StreamingBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+#include "ResourceStreamer.h"
+//--------------------------------------------------------------------------------
+class StreamingBenchmark : public BenchmarkCase
+{
+public:
+	StreamingBenchmark( const std::wstring& model );
+
+	virtual std::wstring GetName();
+	virtual unsigned int GetIterations();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+	virtual std::wstring GetReport();
+
+protected:
+	std::wstring							m_Model;
+	Glyph3::ResourceStreamer*				m_pStreamer;
+	unsigned int							m_uiFrames;
+	unsigned int							m_uiRuns;
+	Glyph3::ResourceStreamer::Statistics	m_Statistics;
+};
+//--------------------------------------------------------------------------------
+#endif // StreamingBenchmark_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,188 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+#include "TaskGraphBenchmark.h"
+#include "JobSystem.h"
+
+#include <sstream>
+
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+// The number of matrix products of the shortest task.  The others take up to
+// four times as long.
+//--------------------------------------------------------------------------------
+static const unsigned int TaskSteps = 20000;
+//--------------------------------------------------------------------------------
+TaskGraphBenchmark::TaskGraphBenchmark( unsigned int tasks, unsigned int workers, bool bGraph ) :
+	m_uiTasks( tasks ),
+	m_uiWorkers( workers > 0 ? workers : 1 ),
+	m_bGraph( bGraph ),
+	m_fChecksum( 0.0f )
+{
+}
+//--------------------------------------------------------------------------------
+std::wstring TaskGraphBenchmark::GetName()
+{
+	std::wstringstream name;
+	name << L"TaskGraph/" << m_uiTasks << ( m_bGraph ? L"/graph/" : L"/chunked/" ) 
+		<< m_uiWorkers << ( m_uiWorkers > 1 ? L" workers" : L" worker" );
+
+	return( name.str() );
+}
+//--------------------------------------------------------------------------------
+DWORD WINAPI TaskGraphBenchmark::ChunkWorkerProc( void* pParameter )
+{
+	ChunkWorker* pWorker = static_cast<ChunkWorker*>( pParameter );
+
+	for ( ; ; )
+	{
+		WaitForSingleObject( pWorker->hBegin, INFINITE );
+
+		if ( pWorker->bQuit )
+			break;
+
+		pWorker->pCase->RecordTask( pWorker->task );
+
+		SetEvent( pWorker->hEnd );
+	}
+
+	return( 0 );
+}
+//--------------------------------------------------------------------------------
+void TaskGraphBenchmark::RecordTask( unsigned int task )
+{
+	const unsigned int steps = TaskSteps * ( 1 + ( task * 7 ) % 4 );
+	const Matrix4f rotation = Matrix4f::RotationMatrixY( 0.001f * static_cast<float>( task + 1 ) );
+
+	Matrix4f result = Matrix4f::Identity();
+
+	for ( unsigned int i = 0; i < steps; i++ )
+		result = result * rotation;
+
+	m_Results[task] = result;
+}
+//--------------------------------------------------------------------------------
+void TaskGraphBenchmark::PlayTask( unsigned int task )
+{
+	m_fChecksum += m_Results[task]( 0, 0 );
+}
+//--------------------------------------------------------------------------------
+bool TaskGraphBenchmark::Setup( App& app )
+{
+	m_Results.resize( m_uiTasks );
+	m_fChecksum = 0.0f;
+
+	if ( m_bGraph )
+	{
+		// The calling thread only helps out while it waits for the next result,
+		// so the job system gets the full number of workers.
+
+		app.SetThreadCount( m_uiWorkers + 1 );
+
+		return( true );
+	}
+
+	// The chunked scheme doesn't use the job system at all.
+
+	app.SetThreadCount( 1 );
+
+	m_ChunkWorkers.resize( m_uiWorkers );
+
+	for ( auto& worker : m_ChunkWorkers )
+	{
+		worker.pCase = this;
+		worker.hBegin = CreateEvent( nullptr, FALSE, FALSE, nullptr );
+		worker.hEnd = CreateEvent( nullptr, FALSE, FALSE, nullptr );
+		worker.task = 0;
+		worker.bQuit = false;
+		worker.hThread = CreateThread( nullptr, 0, ChunkWorkerProc, &worker, 0, nullptr );
+
+		m_ChunkEnds.push_back( worker.hEnd );
+
+		if ( !worker.hBegin || !worker.hEnd || !worker.hThread )
+			return( false );
+	}
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void TaskGraphBenchmark::Run( App& app )
+{
+	if ( m_bGraph )
+	{
+		// The renderer builds its graph anew for every frame, so that is timed
+		// as well.
+
+		JobSystem* pJobs = JobSystem::Get();
+
+		m_Graph.Clear();
+
+		for ( unsigned int i = 0; i < m_uiTasks; i++ )
+			m_Graph.AddNode();
+
+		m_Graph.Execute( pJobs, pJobs ? pJobs->GetWorkerCount() : 1, [this]( unsigned int node, unsigned int slot ) { RecordTask( node ); } );
+
+		for ( auto node : m_Graph.GetOrder() )
+		{
+			m_Graph.WaitForNode( node );
+			PlayTask( node );
+		}
+
+		m_Graph.Wait();
+		return;
+	}
+
+	for ( unsigned int first = 0; first < m_uiTasks; first += m_uiWorkers )
+	{
+		const unsigned int count = std::min( m_uiWorkers, m_uiTasks - first );
+
+		for ( unsigned int j = 0; j < count; j++ ) {
+			m_ChunkWorkers[j].task = first + j;
+			SetEvent( m_ChunkWorkers[j].hBegin );
+		}
+
+		WaitForMultipleObjects( count, &m_ChunkEnds[0], TRUE, INFINITE );
+
+		for ( unsigned int j = 0; j < count; j++ )
+			PlayTask( first + j );
+	}
+}
+//--------------------------------------------------------------------------------
+void TaskGraphBenchmark::Shutdown( App& app )
+{
+	for ( auto& worker : m_ChunkWorkers )
+	{
+		if ( worker.hThread ) {
+			worker.bQuit = true;
+			SetEvent( worker.hBegin );
+			WaitForSingleObject( worker.hThread, INFINITE );
+			CloseHandle( worker.hThread );
+		}
+
+		if ( worker.hBegin )
+			CloseHandle( worker.hBegin );
+		if ( worker.hEnd )
+			CloseHandle( worker.hEnd );
+	}
+
+	m_ChunkWorkers.clear();
+	m_ChunkEnds.clear();
+	m_Graph.Clear();
+
+	app.SetThreadCount( 0 );
+}
+//--------------------------------------------------------------------------------
+std::wstring TaskGraphBenchmark::GetReport()
+{
+	std::wstringstream report;
+	report << L"Tasks: " << m_uiTasks << L", checksum: " << m_fChecksum;
+
+	return( report.str() );
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,75 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// TaskGraphBenchmark
+//
+// Records a queue of independent tasks of uneven length on a number of worker
+// threads, and plays their results back in queue order on the calling thread,
+// the way that RendererDX11::ProcessTaskQueue does with the render views.  The
+// tasks stand in for recording a view with a chain of matrix products.
+//
+// The graph case uses a TaskGraph on a job system with the given number of
+// workers, and plays each result back as soon as it is ready.  The chunked case
+// is the scheme that ProcessTaskQueue used before: a pool of worker threads 
+// that are started through events on one chunk of tasks at a time, with the 
+// calling thread waiting for the whole chunk before playing it back and 
+// starting the next one.
+//--------------------------------------------------------------------------------
+#ifndef TaskGraphBenchmark_h
+#define TaskGraphBenchmark_h
+//--------------------------------------------------------------------------------
+#include "App.h"
+#include "TaskGraph.h"
+#include "Matrix4f.h"
+//--------------------------------------------------------------------------------
+class TaskGraphBenchmark : public BenchmarkCase
+{
+public:
+	TaskGraphBenchmark( unsigned int tasks, unsigned int workers, bool bGraph );
+
+	virtual std::wstring GetName();
+
+	virtual bool Setup( App& app );
+	virtual void Run( App& app );
+	virtual void Shutdown( App& app );
+
+	virtual std::wstring GetReport();
+
+protected:
+	struct ChunkWorker
+	{
+		TaskGraphBenchmark*		pCase;
+		HANDLE					hThread;
+		HANDLE					hBegin;
+		HANDLE					hEnd;
+		unsigned int			task;
+		bool					bQuit;
+	};
+
+	static DWORD WINAPI ChunkWorkerProc( void* pParameter );
+
+	void RecordTask( unsigned int task );
+	void PlayTask( unsigned int task );
+
+	unsigned int					m_uiTasks;
+	unsigned int					m_uiWorkers;
+	bool							m_bGraph;
+
+	Glyph3::TaskGraph				m_Graph;
+	std::vector<ChunkWorker>		m_ChunkWorkers;
+	std::vector<HANDLE>				m_ChunkEnds;
+
+	std::vector<Glyph3::Matrix4f>	m_Results;
+	float							m_fChecksum;
+};
+//--------------------------------------------------------------------------------
+#endif // TaskGraphBenchmark_h
+//--------------------------------------------------------------------------------
@@ -187,7 +187,7 @@ void ViewRiftHighlight::ExecuteTask( PipelineManagerDX11* pPipelineManager, IPar
 			pPipelineManager->ClearBuffers( Vector4f( 0.0f, 0.0f, 0.0f, 0.0f ), 1.0f );
 
 			// Run through the graph and render each of the entities
-			m_pScene->GetRoot()->Render( pPipelineManager, pParamManager, VT_SILHOUETTE );
+			RenderScene( pPipelineManager, pParamManager, VT_SILHOUETTE );
 
 
 
@@ -210,23 +210,9 @@ void ViewRiftHighlight::ExecuteTask( PipelineManagerDX11* pPipelineManager, IPar
 			pPipelineManager->ClearPipelineResources();
 
 
-			// Run through the graph and render each of the entities.  This will sort the entities 
-			// based on whether or not they are transparent.
-		
-			std::vector<Entity3D*> entity_list;
-			GetAllEntities( m_pScene->GetRoot(), entity_list );
-
-			auto const transparent_check = []( Entity3D* entity) { 
-				return entity->Visual.iPass != Renderable::ALPHA;
-			};
-
-			// We use stable partition to sort, and return the first transparent entity.
-			auto const iter_first_alpha = std::stable_partition(begin(entity_list), end(entity_list), transparent_check);
-
-			// Now we can render all entities in the sorted order.
-			for ( auto& entity : entity_list ) {
-				entity->Render( pPipelineManager, pParamManager, VT_PERSPECTIVE );
-			}
+			// Run through the graph and render each of the entities.  The render queue
+			// sorts them by state, and draws the transparent entities last.
+			RenderScene( pPipelineManager, pParamManager, VT_PERSPECTIVE );
 
 
 			// Set the silhouette buffer as a shader resource, then draw the full screen
@@ -17,7 +17,7 @@
 // program is exited.
 //
 // The application currently supports Input, Sound, Rendering, Logging, Timing, 
-// and profiling.  These are all available to the user when building an 
+// resource streaming and profiling.  These are all available to the user when building an 
 // application.
 //
 // 06.02.2012: BeforeRegisterWindowClass method added by Francois Piette.
@@ -34,6 +34,9 @@
 #include "Log.h"
 #include "Timer.h"
 #include "EventManager.h"
+#include "JobSystem.h"
+#include "ParameterNameTable.h"
+#include "ResourceStreamer.h"
 #include "IEventListener.h"
 #include "IWindowProc.h"
 #include "Scene.h"
@@ -89,7 +92,10 @@ namespace Glyph3
 		Timer* m_pTimer;
 
 		// Engine Components
+		ParameterNameTable NameTable;
 		EventManager EvtManager;
+		JobSystem Jobs;
+		ResourceStreamer Streamer;
 
 		Scene* m_pScene;
 
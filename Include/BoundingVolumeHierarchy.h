@@ -0,0 +1,131 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// BoundingVolumeHierarchy
+//
+// A dynamic tree of axis aligned boxes around the world space bounding spheres
+// of a set of entities.  The bounding sphere of each entity is taken from its
+// CompositeShape, so only entities with at least one shape are added to the
+// tree.  This provides logarithmic time ray, sphere and frustum queries instead
+// of testing every entity in the scene.
+//
+// Leaves are inserted incrementally with a surface area cost heuristic, and the
+// tree is kept balanced with rotations as it is modified.  Each leaf is stored
+// with an enlarged ('fat') box, so that an entity can move a small distance
+// without changing the tree at all.  Only when it leaves its fat box is it
+// removed and reinserted.
+//
+// The tree is kept in sync with a list of entities by calling Update once per
+// frame, together with the entities whose transform revision or number of 
+// shapes has changed, as TransformHierarchy::UpdateBounds reports them.  Only
+// those are refit, so the cost of maintaining the tree follows the number of 
+// moving entities rather than the size of the scene.  Modifying the existing
+// spheres of a CompositeShape in place is not detected.
+//
+// The query methods only return candidates whose bounds intersect the query,
+// and the caller is responsible for any exact intersection testing.
+//--------------------------------------------------------------------------------
+#ifndef BoundingVolumeHierarchy_h
+#define BoundingVolumeHierarchy_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "AxisAlignedBox.h"
+#include "Sphere3f.h"
+#include "Ray3f.h"
+#include "Frustum3f.h"
+#include <unordered_map>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class Entity3D;
+
+	class BoundingVolumeHierarchy
+	{
+	public:
+		BoundingVolumeHierarchy();
+		~BoundingVolumeHierarchy();
+
+		// Synchronizes the tree with the given list of entities.  The list may
+		// contain nullptr entries, which are ignored.  The membership of the tree
+		// is only re-evaluated when the revision number changes, and then the
+		// bounds of the changed entities are refit.  Entities that are inserted
+		// take their current bounds, so they don't need to be listed as changed.
+
+		void Update( const std::vector<Entity3D*>& entities, unsigned int revision,
+					const std::vector<Entity3D*>& changed );
+
+		void Insert( Entity3D* pEntity );
+		void Remove( Entity3D* pEntity );
+
+		// Updates the bounds of the given entities, skipping those that aren't in
+		// the tree or haven't changed since they were last fit.
+		void Refit( const std::vector<Entity3D*>& entities );
+		void Clear( );
+
+		// Queries
+
+		void QueryRay( const Ray3f& ray, std::vector<Entity3D*>& set ) const;
+		void QuerySphere( const Sphere3f& bounds, std::vector<Entity3D*>& set ) const;
+		void QueryFrustum( const Frustum3f& bounds, std::vector<Entity3D*>& set ) const;
+
+		// Performs one ray query per element of 'rays', with the results written
+		// to the corresponding element of 'sets'.  Large batches are split across
+		// the JobSystem.
+
+		void QueryRays( const std::vector<Ray3f>& rays, std::vector< std::vector<Entity3D*> >& sets ) const;
+
+		unsigned int GetEntityCount( ) const;
+		int GetHeight( ) const;
+
+	protected:
+		struct Node
+		{
+			AxisAlignedBox	box;
+			int				parent;		// The next free node when on the free list.
+			int				child1;
+			int				child2;
+			int				height;		// Leaves have a height of 0, free nodes -1.
+			Entity3D*		pEntity;
+
+			bool IsLeaf( ) const { return( child1 == -1 ); }
+		};
+
+		struct Record
+		{
+			int				leaf;		// -1 when the entity has no shapes.
+			unsigned int	revision;	// The transform revision used for the bounds.
+			int				shapes;		// The number of shapes used for the bounds.
+		};
+
+		int AllocateNode( );
+		void FreeNode( int index );
+
+		void InsertLeaf( int leaf );
+		void RemoveLeaf( int leaf );
+		int Balance( int index );
+
+		void UpdateRecord( Entity3D* pEntity, Record& record );
+
+		template <typename TBoxTest, typename TLeafTest>
+		void Query( const TBoxTest& boxTest, const TLeafTest& leafTest, std::vector<Entity3D*>& set ) const;
+
+		std::vector< Node >		m_Nodes;
+		int						m_iRoot;
+		int						m_iFreeList;
+
+		std::unordered_map< Entity3D*, Record >	m_Records;
+		unsigned int							m_uiRevision;
+		bool									m_bSynchronized;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // BoundingVolumeHierarchy_h
+//--------------------------------------------------------------------------------
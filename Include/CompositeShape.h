@@ -17,6 +17,7 @@
 //--------------------------------------------------------------------------------
 #include "Ray3f.h"
 #include "Sphere3f.h"
+#include "Matrix4f.h"
 //--------------------------------------------------------------------------------
 namespace Glyph3
 {
@@ -31,6 +32,11 @@ namespace Glyph3
 
 		int GetNumberOfShapes() const;
 
+		// Computes a single sphere enclosing all of the shapes after they have been
+		// transformed by the given matrix (typically the entity's world matrix).
+		// Returns false if there are no shapes.
+		bool GetBoundingSphere( const Matrix4f& transform, Sphere3f& bounds ) const;
+
 		std::vector<Sphere3f> m_spheres;
 	};
 };
@@ -11,6 +11,11 @@
 //--------------------------------------------------------------------------------
 // ConsoleActor
 //
+// Besides the Lua statements typed into it, the console provides two commands
+// for the CPU profiler.  'profile()' toggles the profiler together with a table
+// of the most expensive zones below the console history, which is refreshed at
+// the start of every frame.  'trace()' starts a capture, and the next 'trace()'
+// writes it to ProfileTrace.json in the Chrome trace format.
 //--------------------------------------------------------------------------------
 
 //--------------------------------------------------------------------------------
@@ -37,9 +42,18 @@ namespace Glyph3
 		TextActor textActor;
 
 		static const size_t MAX_ENTRY_DISPLAY = 10;
+		static const unsigned int MAX_PROFILE_DISPLAY = 12;
+
+		void SetProfileVisible( bool visible );
+		bool IsProfileVisible() const;
 
 	private:
 		void printText();
+
+		static int ToggleProfile( lua_State* L );
+		static int ToggleTrace( lua_State* L );
+
+		bool m_bShowProfile;
     };
 };
 //--------------------------------------------------------------------------------
@@ -31,6 +31,8 @@ namespace Glyph3
 
 
 
+	class ConstantBufferRingDX11;
+
 	class ConstantBufferDX11 : public BufferDX11
 	{
 	public:
@@ -47,10 +49,22 @@ namespace Glyph3
 		void						SetAutoUpdate( bool enable );
 		bool						GetAutoUpdate( );
 
+		// Returns the window of the ring that holds the latest contents of this
+		// buffer, if they were written into the given ring since its last
+		// discard.  Otherwise the buffer itself holds its contents.
+		bool						GetRingLocation( ConstantBufferRingDX11* pRing, ID3D11Buffer*& pBuffer, UINT& firstConstant, UINT& numConstants );
+
 	protected:
+		void						WriteMappings( void* pData, IParameterManager* pParamManager );
+
 		bool									m_bAutoUpdate;
 		std::vector< ConstantBufferMapping >	m_Mappings;
 
+		ConstantBufferRingDX11*					m_pRing;
+		unsigned int							m_uiRingGeneration;
+		UINT									m_uiFirstConstant;
+		UINT									m_uiNumConstants;
+
 		friend RendererDX11;
 	};
 };
@@ -0,0 +1,76 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// ConstantBufferRingDX11
+//
+// A single large dynamic constant buffer that the constant buffers of a pipeline
+// manager are sub-allocated from.  Instead of mapping each constant buffer with
+// D3D11_MAP_WRITE_DISCARD, their contents are written one after the other into
+// the ring, and each one is bound as a window into the ring with the Direct3D
+// 11.1 offset binding methods.
+//
+// The ring is mapped with D3D11_MAP_WRITE_NO_OVERWRITE, since the space of a
+// frame is only reused once the frame has been retired.  The renderer retires
+// the frames that an event query shows the GPU to have finished.  The first map, and the first map after a
+// command list has been finished, use D3D11_MAP_WRITE_DISCARD instead, because
+// deferred contexts don't keep the contents of dynamic buffers between command
+// lists.  The generation is advanced at each new frame and command list, and
+// constant buffers written in an older generation are written again.
+//--------------------------------------------------------------------------------
+#ifndef ConstantBufferRingDX11_h
+#define ConstantBufferRingDX11_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "RingAllocator.h"
+#include "ResourceProxyDX11.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class PipelineManagerDX11;
+
+	class ConstantBufferRingDX11
+	{
+	public:
+		ConstantBufferRingDX11( unsigned int capacity );
+		~ConstantBufferRingDX11();
+
+		// Maps room for 'size' bytes and returns a pointer to it, along with the
+		// window to bind in units of constants.  Returns nullptr when the ring
+		// is full, in which case nothing has to be unmapped.
+		void* Map( PipelineManagerDX11* pPipeline, unsigned int size, UINT& firstConstant, UINT& numConstants );
+		void Unmap( PipelineManagerDX11* pPipeline );
+
+		// Starts a new frame.  The space of the earlier frames stays in use until
+		// they are retired.
+		void BeginFrame( unsigned long long frame );
+
+		// Frees the space of every frame up to and including 'frame', which the
+		// GPU must have finished reading.
+		void RetireFrames( unsigned long long frame );
+		void RequireDiscard( );
+
+		ID3D11Buffer* GetBuffer( );
+		unsigned int GetGeneration( ) const;
+
+		// Offsets have to be a multiple of 16 constants of 16 bytes each.
+		static const unsigned int Alignment = 256;
+
+	private:
+		RingAllocator		m_Allocator;
+		ResourcePtr			m_Buffer;
+
+		unsigned int		m_uiGeneration;
+		bool				m_bDiscard;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // ConstantBufferRingDX11_h
+//--------------------------------------------------------------------------------
@@ -11,6 +11,16 @@
 //--------------------------------------------------------------------------------
 // EventManager
 //
+// Events can either be processed immediately with ProcessEvent, or queued with
+// QueueEvent to be dispatched later by ProcessEventQueue.  Queueing is lock free
+// and may be done from any thread, while the queue is processed by the thread
+// that owns the listeners (normally once per frame from the message loop).
+//
+// The queue is a fixed size ring buffer of slots, each with a sequence number
+// that tells producers and the consumer whether the slot is free or filled.
+// No memory is allocated when an event is queued, and QueueEvent returns false
+// if the queue is full.  Events created with MakeEvent (see EventPool.h) are
+// taken from a pool as well, so queueing them doesn't touch the heap at all.
 //--------------------------------------------------------------------------------
 #ifndef EventManager_h
 #define EventManager_h
@@ -18,13 +28,14 @@
 #include "PCH.h"
 #include "IEvent.h"
 #include "IEventListener.h"
+#include <atomic>
 //--------------------------------------------------------------------------------
 namespace Glyph3
 {
 	class EventManager
 	{
 	public:
-		EventManager( );
+		EventManager( unsigned int uiQueueCapacity = 4096 );
 		virtual ~EventManager( );
 
 		bool AddEventListener( eEVENT EventID, IEventListener* pListener );
@@ -32,15 +43,34 @@ namespace Glyph3
 
 		bool ProcessEvent( EventPtr pEvent );
 		bool QueueEvent( EventPtr pEvent );
-		bool ProcessEventQueue( );
+
+		// Dispatches at most uiMaxEvents of the queued events, in the order that
+		// they were queued.  Events queued while processing are left for the 
+		// next call.  Returns true if the queue was emptied.
+		bool ProcessEventQueue( unsigned int uiMaxEvents = 1024 );
 
 		static EventManager* Get( );
 
 	protected:
 		std::vector< IEventListener* > m_EventHandlers[NUM_EVENTS];
-		std::vector< EventPtr > m_EventQueue;
+
+		struct QueueSlot
+		{
+			std::atomic<unsigned int>	Sequence;
+			EventPtr					pEvent;
+		};
+
+		QueueSlot*					m_pEventQueue;
+		unsigned int				m_uiQueueMask;
+		std::atomic<unsigned int>	m_uiQueueTail;	// Shared by the producers.
+		unsigned int				m_uiQueueHead;	// Only used by the consumer.
 
 		static EventManager* m_spEventManager;
+
+	private:
+		// The manager owns its queue, so it can't be copied.
+		EventManager( const EventManager& );
+		EventManager& operator=( const EventManager& );
 	};
 };
 //--------------------------------------------------------------------------------
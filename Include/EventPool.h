@@ -0,0 +1,216 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// EventPool
+//
+// Creates events without going to the heap.  MakeEvent constructs the event
+// with std::allocate_shared, so the event and the reference counts of its
+// shared_ptr live in a single block, which is taken from a pool:
+//
+//   EvtMouseMovePtr pEvent = MakeEvent<EvtMouseMove>( hwnd, wparam, lparam );
+//   EvtManager.QueueEvent( pEvent );
+//
+// There is one pool for each block size (rounded up to 16 bytes), holding a
+// fixed number of blocks in a lock free free list.  Blocks can be taken and
+// returned from any thread, so an event may be created by a producer and
+// released by the thread that processes the queue.  When a pool is empty the
+// block is allocated from the heap instead, and is deleted again when the
+// event is released.
+//
+// The free list head packs the index of the first free block together with a
+// counter that changes with every update, which prevents a block from being
+// popped with a stale successor (the ABA problem).  The storage of a pool is
+// created by the first allocation, and is kept until the process exits.
+//--------------------------------------------------------------------------------
+#ifndef EventPool_h
+#define EventPool_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include <atomic>
+#include <type_traits>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	template <unsigned int BlockSize>
+	class EventBlockPool
+	{
+	public:
+		static const unsigned int BlockCount = 1024;
+
+		static void* Allocate( );
+		static void Deallocate( void* p );
+
+	protected:
+		typedef typename std::aligned_storage<BlockSize, 16>::type Block;
+
+		// The head holds the index of the first free block plus one in its low
+		// 32 bits (zero when the list is empty), and the update counter in its
+		// high 32 bits.  Each entry of Next holds the following free block in
+		// the same form.
+
+		struct Storage
+		{
+			std::atomic<unsigned long long>	Head;
+			std::atomic<unsigned int>		Next[BlockCount];
+			Block							Blocks[BlockCount];
+		};
+
+		static Storage* GetStorage( );
+
+		static std::atomic<Storage*> s_pStorage;
+	};
+
+	template <unsigned int BlockSize>
+	std::atomic<typename EventBlockPool<BlockSize>::Storage*> EventBlockPool<BlockSize>::s_pStorage;
+
+	//--------------------------------------------------------------------------------
+	template <unsigned int BlockSize>
+	typename EventBlockPool<BlockSize>::Storage* EventBlockPool<BlockSize>::GetStorage( )
+	{
+		Storage* pStorage = s_pStorage.load( std::memory_order_acquire );
+
+		if ( pStorage != nullptr )
+			return( pStorage );
+
+		// Function local statics aren't initialized thread safely by every
+		// compiler, so the storage is installed with a compare-and-swap.  If
+		// another thread gets there first, its storage is used instead.
+
+		Storage* pNew = new Storage();
+
+		for ( unsigned int i = 0; i < BlockCount; i++ )
+			pNew->Next[i].store( i + 1 < BlockCount ? i + 2 : 0, std::memory_order_relaxed );
+
+		pNew->Head.store( 1, std::memory_order_relaxed );
+
+		if ( s_pStorage.compare_exchange_strong( pStorage, pNew, std::memory_order_acq_rel ) )
+			return( pNew );
+
+		delete pNew;
+		return( pStorage );
+	}
+	//--------------------------------------------------------------------------------
+	template <unsigned int BlockSize>
+	void* EventBlockPool<BlockSize>::Allocate( )
+	{
+		Storage* pStorage = GetStorage();
+
+		unsigned long long head = pStorage->Head.load( std::memory_order_acquire );
+
+		for ( ;; )
+		{
+			const unsigned int first = static_cast<unsigned int>( head );
+
+			if ( first == 0 )
+				return( ::operator new( BlockSize ) );
+
+			const unsigned int next = pStorage->Next[first-1].load( std::memory_order_relaxed );
+			const unsigned long long desired = ( ( ( head >> 32 ) + 1 ) << 32 ) | next;
+
+			if ( pStorage->Head.compare_exchange_weak( head, desired, std::memory_order_acquire ) )
+				return( &pStorage->Blocks[first-1] );
+		}
+	}
+	//--------------------------------------------------------------------------------
+	template <unsigned int BlockSize>
+	void EventBlockPool<BlockSize>::Deallocate( void* p )
+	{
+		Storage* pStorage = s_pStorage.load( std::memory_order_acquire );
+
+		Block* pBlock = static_cast<Block*>( p );
+
+		if ( pStorage == nullptr || pBlock < pStorage->Blocks || pBlock >= pStorage->Blocks + BlockCount )
+		{
+			::operator delete( p );
+			return;
+		}
+
+		const unsigned int index = static_cast<unsigned int>( pBlock - pStorage->Blocks );
+
+		unsigned long long head = pStorage->Head.load( std::memory_order_relaxed );
+		unsigned long long desired;
+
+		do
+		{
+			pStorage->Next[index].store( static_cast<unsigned int>( head ), std::memory_order_relaxed );
+			desired = ( ( ( head >> 32 ) + 1 ) << 32 ) | ( index + 1 );
+		}
+		while ( !pStorage->Head.compare_exchange_weak( head, desired, std::memory_order_release ) );
+	}
+	//--------------------------------------------------------------------------------
+	// The allocator given to std::allocate_shared.  It is rebound to the type
+	// that holds the event together with its reference counts, and takes that
+	// type's blocks from the pool of the matching size.
+	//--------------------------------------------------------------------------------
+	template <typename T>
+	class EventAllocator
+	{
+	public:
+		typedef T					value_type;
+		typedef T*					pointer;
+		typedef const T*			const_pointer;
+		typedef T&					reference;
+		typedef const T&			const_reference;
+		typedef size_t				size_type;
+		typedef ptrdiff_t			difference_type;
+
+		template <typename U>
+		struct rebind
+		{
+			typedef EventAllocator<U> other;
+		};
+
+		EventAllocator( ) {}
+
+		template <typename U>
+		EventAllocator( const EventAllocator<U>& ) {}
+
+		T* allocate( size_t n )
+		{
+			if ( n != 1 )
+				return( static_cast<T*>( ::operator new( n * sizeof( T ) ) ) );
+
+			return( static_cast<T*>( EventBlockPool<PoolBlockSize>::Allocate() ) );
+		}
+
+		void deallocate( T* p, size_t n )
+		{
+			if ( n != 1 )
+				::operator delete( p );
+			else
+				EventBlockPool<PoolBlockSize>::Deallocate( p );
+		}
+
+		size_t max_size( ) const
+		{
+			return( static_cast<size_t>( -1 ) / sizeof( T ) );
+		}
+
+	private:
+		static const unsigned int PoolBlockSize = ( sizeof( T ) + 15 ) & ~15u;
+	};
+
+	template <typename T, typename U>
+	bool operator==( const EventAllocator<T>&, const EventAllocator<U>& ) { return( true ); }
+
+	template <typename T, typename U>
+	bool operator!=( const EventAllocator<T>&, const EventAllocator<U>& ) { return( false ); }
+
+	//--------------------------------------------------------------------------------
+	template <typename T, typename... Args>
+	std::shared_ptr<T> MakeEvent( Args&&... args )
+	{
+		return( std::allocate_shared<T>( EventAllocator<T>(), std::forward<Args>( args )... ) );
+	}
+};
+//--------------------------------------------------------------------------------
+#endif // EventPool_h
+//--------------------------------------------------------------------------------
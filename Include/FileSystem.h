@@ -39,6 +39,12 @@ namespace Glyph3
 		bool OperatingOnXP();
 
 		std::wstring GetLogFolder();
+
+		// Files generated from the data, such as the geometry caches, are kept
+		// per user unless a different folder is set.  The folder is created
+		// when it is first requested.
+		std::wstring GetCacheFolder();
+		void SetCacheFolder( const std::wstring& folder );
 		
 		std::wstring GetDataFolder();
 		std::wstring GetModelsFolder();
@@ -62,6 +68,7 @@ namespace Glyph3
 		static std::wstring sScriptsSubFolder;
 		static std::wstring sShaderSubFolder;
 		static std::wstring sTextureSubFolder;
+		static std::wstring sCacheFolder;
 	};
 };
 //--------------------------------------------------------------------------------
@@ -40,6 +40,10 @@ namespace Glyph3
 		bool Intersects( const Sphere3f& test ) const;
 		bool Envelops( const Sphere3f& test ) const;
 
+		// Tests a whole array of spheres, writing the result of Intersects for
+		// each one.  The spheres are tested four at a time with SSE.
+		void Intersects( const Sphere3f* pSpheres, unsigned int count, bool* pResults ) const;
+
 		std::array<Plane3f,6> planes;
 	};
 };
@@ -0,0 +1,90 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// GeometryCacheDX11
+//
+// Reads and writes a compact binary copy of a GeometryDX11 object.  The file
+// holds a header, a description of each vertex element including its packing,
+// the raw float data of each element and finally the index list.  The geometry
+// loaders write a cache file to the FileSystem cache folder after parsing a
+// model, and on later loads the cache is memory mapped and copied directly into
+// the vertex elements, skipping the text parsing entirely.
+//
+// A cache file is only used while it is newer than its source file and has the
+// current format version, so editing the model or changing the format causes
+// the cache to be rebuilt.  Caching can be disabled globally with SetEnabled.
+//
+// The loaders may run on several threads at once, such as the decode threads
+// of the ResourceStreamer.  Only one thread writes a given cache file at a time,
+// and a cache file is replaced as a whole once it is complete.
+//--------------------------------------------------------------------------------
+#ifndef GeometryCacheDX11_h
+#define GeometryCacheDX11_h
+//--------------------------------------------------------------------------------
+#include "GeometryDX11.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class GeometryCacheDX11
+	{
+	public:
+		// The filenames are full paths, not relative to the models folder.
+
+		static bool Write( GeometryPtr pGeometry, const std::wstring& filename );
+		static GeometryPtr Read( const std::wstring& filename );
+
+		// Reads a cache file that is already in memory.  The name is only used in
+		// log messages.
+		static GeometryPtr ReadFromMemory( const unsigned char* pData, size_t size, const std::wstring& name );
+
+		// Returns the default cache file used for a source file, which is named
+		// after a hash of its full path, and whether a cache file exists and is
+		// newer than its source.
+		static std::wstring GetCacheFilename( const std::wstring& source );
+		static bool IsCacheValid( const std::wstring& source, const std::wstring& cache );
+
+		static void SetEnabled( bool bEnabled );
+		static bool IsEnabled( );
+
+	private:
+		GeometryCacheDX11();
+
+		static bool WriteContents( GeometryPtr pGeometry, const std::wstring& filename );
+
+		struct FileHeader
+		{
+			char			id[4];
+			unsigned int	version;
+			unsigned int	topology;
+			unsigned int	elementCount;
+			unsigned int	indexCount;
+		};
+
+		struct ElementHeader
+		{
+			char			semantic[32];
+			unsigned int	semanticIndex;
+			unsigned int	format;
+			unsigned int	inputSlot;
+			unsigned int	alignedByteOffset;
+			unsigned int	inputSlotClass;
+			unsigned int	instanceDataStepRate;
+			unsigned int	packing;
+			unsigned int	tuple;
+			unsigned int	count;
+		};
+
+		static bool sbEnabled;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // GeometryCacheDX11_h
+//--------------------------------------------------------------------------------
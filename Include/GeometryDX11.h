@@ -30,6 +30,14 @@ namespace Glyph3
 	class VertexBufferDX11;
 	class IndexBufferDX11;
 
+	enum AdjacencyLayout
+	{
+		// v0, v1, v2, a0, a1, a2 as a six control point patch
+		ADJACENCY_PATCH,
+		// v0, a0, v1, a1, v2, a2 as a triangle list with adjacency
+		ADJACENCY_TRIANGLE_LIST
+	};
+
 	class GeometryDX11 : public PipelineExecutorDX11
 	{
 	public:
@@ -38,6 +46,12 @@ namespace Glyph3
 	
 		virtual void Execute( PipelineManagerDX11* pPipeline, IParameterManager* pParamManager );
 
+		// Indexed geometry with a vertex buffer can be drawn instanced.  The
+		// input layouts used for this include the instance world matrix.
+		virtual bool SupportsInstancing( );
+		virtual void ExecuteInstanced( PipelineManagerDX11* pPipeline, IParameterManager* pParamManager,
+			int instances, UINT start, UINT count );
+
 		void AddElement( VertexElementDX11* element );
 		void AddFace( TriangleIndices& face );
 		void AddLine( LineIndices& line );
@@ -67,11 +81,31 @@ namespace Glyph3
 
 		void LoadToBuffers( );
 
+		// Selects the packed vertex buffer format of an element, or of every
+		// element with a standard semantic.  This takes effect the next time
+		// that LoadToBuffers is called.
+		void SetPacking( std::string semantic, VertexPacking packing );
+		void SetDefaultPacking( );
+
         bool ComputeTangentFrame( std::string positionSemantic = VertexElementDX11::PositionSemantic,
                                   std::string normalSemantic = VertexElementDX11::NormalSemantic,
                                   std::string texCoordSemantic = VertexElementDX11::TexCoordSemantic, 
                                   std::string tangentSemantic = VertexElementDX11::TangentSemantic );
 
+		// Replaces a triangle list with the same triangles plus the vertex across
+		// each of their edges, in the given layout.  Returns false if the geometry
+		// isn't a triangle list.
+		bool GenerateAdjacency( AdjacencyLayout layout );
+
+		// Finds the neighbours of every triangle in a triangle list.  For triangle
+		// t, pAdjacent[3t+k] receives the vertex opposite to the edge from corner
+		// k to corner k+1 in the other triangle that shares that edge, or the
+		// edge's start vertex when there is no such triangle.  If an edge is
+		// shared by more than two triangles, the one that comes first in the list
+		// is used, and triangles with the same three vertices are not counted as
+		// neighbours of each other.
+		static void FindAdjacentVertices( const UINT* pIndices, unsigned int indexCount, UINT* pAdjacent );
+
 		std::vector<VertexElementDX11*>		m_vElements;
 		std::vector<UINT>					m_vIndices;
 		
@@ -84,6 +118,13 @@ namespace Glyph3
 
 		// The type of primitives listed in the index buffer
 		D3D11_PRIMITIVE_TOPOLOGY m_ePrimType;
+
+	protected:
+		void GetLayoutElements( std::vector<D3D11_INPUT_ELEMENT_DESC>& elements );
+		int GetInstancedInputLayout( int ShaderID );
+		void ReleaseInputLayouts( );
+
+		std::map<int,InputLayoutKey*>		m_InstancedInputLayouts;
 	};
 
 	typedef std::shared_ptr<GeometryDX11> GeometryPtr;
@@ -17,6 +17,7 @@
 //--------------------------------------------------------------------------------
 #include "GeometryDX11.h"
 #include "SkinnedActor.h"
+#include "ms3dspec.h"
 #include <string>
 //--------------------------------------------------------------------------------
 namespace Glyph3
@@ -34,45 +35,116 @@ namespace Glyph3
 		//static void removeWhiteSpace( std::wstring& s );
 		//static std::wstring getElementName( int usage, int index );
 
+		// Loads ascii, binary_little_endian and binary_big_endian PLY files.  The 
+		// positions, normals and face indices are read from the file.
 		static GeometryPtr loadStanfordPlyFile( std::wstring filename, bool withAdjacency = false );
 
+		// Parse the contents of a file that is already in memory, such as one that
+		// was read by a stream request.  These don't use the geometry cache, and
+		// leave creating the buffers to the caller.  The name is only used in log
+		// messages.
+		static GeometryPtr loadMS3DFromMemory( const unsigned char* pData, size_t size, const std::wstring& name );
+		static GeometryPtr loadStanfordPlyFromMemory( const char* pData, size_t size, bool withAdjacency = false );
+
 	private:
 		GeometryLoaderDX11();
 
-		struct PlyElementPropertyDeclaration
+		enum PlyFormat
+		{
+			PLY_ASCII,
+			PLY_BINARY_LITTLE_ENDIAN,
+			PLY_BINARY_BIG_ENDIAN
+		};
+
+		enum PlyScalarType
+		{
+			PLY_INVALID,
+			PLY_CHAR,
+			PLY_UCHAR,
+			PLY_SHORT,
+			PLY_USHORT,
+			PLY_INT,
+			PLY_UINT,
+			PLY_FLOAT,
+			PLY_DOUBLE
+		};
+
+		struct PlyPropertyDesc
 		{
 			std::string name;
 			bool isList;
-			std::string type;
-			std::string listLengthType;
+			PlyScalarType type;
+			PlyScalarType listLengthType;
 		};
 
 		struct PlyElementDesc
 		{
 			std::string name;
-			int elementCount;
-			std::vector< PlyElementPropertyDeclaration > dataFormat;
-			std::vector< void** > data;
+			unsigned int elementCount;
+			std::vector< PlyPropertyDesc > properties;
+		};
+
+		// The read position within a memory mapped PLY file.  Reads never go past
+		// the end of the data, and set the error flag instead.
+		struct PlyCursor
+		{
+			const char* pCurrent;
+			const char* pEnd;
+			PlyFormat format;
+			bool error;
+		};
+
+		static void ParsePlyHeader( PlyCursor& cursor, std::vector<PlyElementDesc>& elements );
+		static PlyScalarType ParsePlyScalarType( const std::string& name );
+		static double ReadPlyValue( PlyCursor& cursor, PlyScalarType type );
+		static double ReadPlyAsciiValue( PlyCursor& cursor );
+		static void SkipPlyProperty( PlyCursor& cursor, const PlyPropertyDesc& prop );
+		static size_t GetPlyMinimumSize( const PlyCursor& cursor, const PlyElementDesc& desc );
+		static void SkipPlyElement( PlyCursor& cursor, const PlyElementDesc& desc );
+		static void ReadPlyVertices( PlyCursor& cursor, const PlyElementDesc& desc, GeometryPtr pGeometry );
+		static void ReadPlyFaces( PlyCursor& cursor, const PlyElementDesc& desc, unsigned int vertexCount, std::vector<UINT>& indices, int& faceSize );
+		static int FindPlyElementIndex( const std::vector<PlyElementDesc>& elems, const std::string& name );
+		static int FindPlyPropertyIndex( const std::vector<PlyPropertyDesc>& props, const std::string& name );
+
+		// The parts of an MS3D file that are used by the loaders.  The keyframes
+		// of each joint are kept in the vectors, and the pointers in the joint
+		// structure are left null.
+		struct MS3DJointData
+		{
+			MS3DKeyframeJoint					joint;
+			std::vector<MS3DKeyframeRotation>	rotations;
+			std::vector<MS3DKeyframePosition>	positions;
 		};
 
-		template<typename T>
-		struct PlyDataArray
+		struct MS3DModel
 		{
-			unsigned int length;
-			T* data;
+			std::vector<MS3DVertex>		vertices;
+			std::vector<MS3DTriangle>	triangles;
+			std::vector<MS3DJointData>	joints;
 		};
 
-		static int FindAdjacentIndex( int edgeStart, int edgeEnd, int triV, int* pRaw, int rawLen);
-		static PlyElementDesc ParsePLYElementHeader(std::string headerLine, std::ifstream& input);
-		static PlyElementPropertyDeclaration ParsePLYElementProperty(std::string desc);
-		static PlyElementPropertyDeclaration ParsePLYElementPropertyList(std::string desc);
-		static std::vector<void**> ReadPLYElementData(std::ifstream& input, const PlyElementDesc& desc);
-		static void** ParsePLYElementData(std::string text, const std::vector<PlyElementPropertyDeclaration>& desc);
-		template<typename T> static T* ExtractDataPtr(std::string input);
-		template<typename T> static T ExtractDataVal(std::string input);
-		template<typename T> static PlyDataArray<T>* ExtractDataPtrArray(int length, std::vector<std::string>::iterator iterator);
-		static int FindPlyElementIndex(std::vector<PlyElementDesc> elems, std::string name);
-		static int FindPlyElementPropertyIndex(std::vector<PlyElementPropertyDeclaration> elems, std::string name);
+		// The read position within a memory mapped MS3D file, which works the
+		// same way as the PLY cursor.
+		struct MS3DCursor
+		{
+			const unsigned char* pCurrent;
+			const unsigned char* pEnd;
+			bool error;
+		};
+
+		// Reads the whole file from one mapped view.  The joints are only read
+		// when requested, since the groups and materials in front of them have to
+		// be skipped to get there.  Returns false if the file can't be opened or
+		// is truncated.
+		static bool ReadMS3DFile( const std::wstring& filename, MS3DModel& model, bool withJoints );
+		static bool ReadMS3DData( const unsigned char* pData, size_t size, const std::wstring& name, MS3DModel& model, bool withJoints );
+		static void ReadMS3DBytes( MS3DCursor& cursor, void* pData, size_t size );
+		static void SkipMS3DBytes( MS3DCursor& cursor, size_t size );
+
+		// Creates an indexed geometry from the triangles of the model.  The file
+		// stores the normal and texture coordinates per triangle corner, so the
+		// corners with identical data are welded into one vertex.
+		static GeometryPtr BuildMS3DGeometry( const MS3DModel& model, bool withBoneIDs );
 	};
 };
 #endif // GeometryLoaderDX11_h
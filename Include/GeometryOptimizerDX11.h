@@ -0,0 +1,71 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// GeometryOptimizerDX11
+//
+// Reorders the vertices and indices of a geometry object so that it renders more
+// efficiently, without changing the triangles that it describes.  There are
+// three separate stages, which are normally applied in the order of the
+// Optimize method:
+//
+//  - WeldVertices merges vertices whose data is identical in every element.
+//  - OptimizeVertexCache reorders the triangles so that the vertices that they
+//    reference are likely to still be in the post-transform vertex cache, using
+//    Tom Forsyth's linear-speed vertex cache optimization.
+//  - OptimizeVertexFetch reorders the vertices into the order in which they are
+//    first referenced, so that the vertex buffer is read mostly sequentially.
+//
+// The vertex cache size has to be at least 4, otherwise the triangle order is
+// left unchanged.  When the log writes debug messages, the ACMR before and after
+// the cache optimization of a geometry object is logged.
+//
+// Only triangle lists (including three control point patch lists) are modified,
+// and any other topology is left untouched.  The vertex stages rebuild every
+// vertex element, so they must be applied after all of the elements have been
+// added, and before the geometry is loaded to buffers.
+//
+// The average cache miss ratio (ACMR, misses per triangle) and average
+// transform to vertex ratio (ATVR, misses per referenced vertex) of an index
+// list can be calculated with a simulated FIFO cache to measure the result.
+//--------------------------------------------------------------------------------
+#ifndef GeometryOptimizerDX11_h
+#define GeometryOptimizerDX11_h
+//--------------------------------------------------------------------------------
+#include "GeometryDX11.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class GeometryOptimizerDX11
+	{
+	public:
+		static void Optimize( GeometryPtr pGeometry );
+
+		// Returns the number of vertices that were removed.
+		static unsigned int WeldVertices( GeometryPtr pGeometry );
+		static void OptimizeVertexCache( GeometryPtr pGeometry, unsigned int cacheSize = 32 );
+		static void OptimizeVertexFetch( GeometryPtr pGeometry );
+
+		static void OptimizeVertexCache( std::vector<UINT>& indices, unsigned int vertexCount, unsigned int cacheSize = 32 );
+
+		static float CalculateACMR( const std::vector<UINT>& indices, unsigned int cacheSize = 16 );
+		static float CalculateATVR( const std::vector<UINT>& indices, unsigned int cacheSize = 16 );
+
+	private:
+		GeometryOptimizerDX11();
+
+		static bool IsTriangleList( GeometryPtr pGeometry );
+		static unsigned int CountCacheMisses( const std::vector<UINT>& indices, unsigned int cacheSize );
+		static void RemapVertices( GeometryPtr pGeometry, const std::vector<UINT>& remap, unsigned int vertexCount );
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // GeometryOptimizerDX11_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,58 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// GeometryStreamRequestDX11
+//
+// Streams a model with the ResourceStreamer.  The I/O thread reads the model
+// file, or its geometry cache when that is up to date, and the decode thread
+// parses it from memory with the loader for its file extension.  The main
+// thread only creates the buffers with LoadToBuffers.
+//
+// MS3D and PLY files are parsed with GeometryLoaderDX11, and the result is
+// written to their geometry cache, while STL files are parsed with
+// StlImporterDX11.  Several requests for the same model may be decoded at once,
+// in which case the first one to finish writes the cache file.
+//--------------------------------------------------------------------------------
+#ifndef GeometryStreamRequestDX11_h
+#define GeometryStreamRequestDX11_h
+//--------------------------------------------------------------------------------
+#include "StreamRequest.h"
+#include "GeometryDX11.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class GeometryStreamRequestDX11 : public StreamRequest
+	{
+	public:
+		// The filename is relative to the models folder, like the filenames of
+		// the GeometryLoaderDX11 functions.
+		GeometryStreamRequestDX11( const std::wstring& filename );
+		virtual ~GeometryStreamRequestDX11();
+
+		// Returns nullptr until the request is complete.
+		GeometryPtr GetGeometry( ) const;
+
+	protected:
+		virtual unsigned long long EstimateMemoryCost( );
+		virtual bool Read( );
+		virtual bool Decode( );
+		virtual bool Finalize( );
+
+		std::wstring		m_ModelName;
+		std::wstring		m_Extension;
+		std::wstring		m_CacheFilename;
+		bool				m_bFromCache;
+		GeometryPtr			m_pGeometry;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // GeometryStreamRequestDX11_h
+//--------------------------------------------------------------------------------
@@ -28,6 +28,11 @@ namespace Glyph3
 		static std::vector<std::string> &split(const std::string &s, char delim, std::vector<std::string> &elems);
 		static std::vector<std::string> split(const std::string &s, char delim);
 
+		// Parses a decimal floating point number that starts at p, after any
+		// spaces or tabs, without looking beyond pEnd.  Returns the character
+		// after the number, or nullptr if there is no number.
+		static const char* ParseFloat( const char* p, const char* pEnd, float& value );
+
 	private:
 		GlyphString();
 		
@@ -57,6 +57,7 @@ namespace Glyph3
 		virtual void SetMatrixArrayParameter( RenderParameterDX11* pParameter, int count, Matrix4f* pMatrices ) = 0;
 
 		virtual RenderParameterDX11* GetParameterRef( const std::wstring& name ) = 0;
+		virtual RenderParameterDX11* GetParameterRef( unsigned int nameID ) = 0;
 		virtual VectorParameterDX11* GetVectorParameterRef( const std::wstring& name ) = 0;
 		virtual MatrixParameterDX11* GetMatrixParameterRef( const std::wstring& name ) = 0;
 		virtual ShaderResourceParameterDX11* GetShaderResourceParameterRef( const std::wstring& name ) = 0;
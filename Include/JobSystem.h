@@ -0,0 +1,123 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// JobSystem
+//
+// A portable work stealing job scheduler built on std::thread.  Each worker 
+// thread owns a queue of jobs, and pops its own work in LIFO order (which keeps
+// recently submitted, cache-warm work local) while idle workers steal from the
+// opposite end of the other queues.  Threads that are not workers (i.e. the
+// main thread) submit into a shared queue that all workers steal from.
+//
+// Jobs are grouped with a Counter, which is waited on to synchronize with the 
+// completion of the group.  A waiting thread executes pending jobs instead of
+// blocking, so jobs may themselves submit and wait on nested jobs, and only
+// sleeps once the remaining jobs of its group are all running elsewhere.  A job
+// that throws still completes its counter, so its waiters don't hang.
+//
+// The first instance that is created is available through JobSystem::Get(),
+// following the pattern of the EventManager.
+//--------------------------------------------------------------------------------
+#ifndef JobSystem_h
+#define JobSystem_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <functional>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class JobSystem
+	{
+	public:
+		typedef std::function<void()> Job;
+
+		class Counter
+		{
+		public:
+			Counter() : m_iPending( 0 ) {}
+			bool IsComplete() const { return( m_iPending.load() == 0 ); }
+
+		private:
+			std::atomic<int> m_iPending;
+			friend class JobSystem;
+		};
+
+		// A worker count of zero selects one worker less than the number of 
+		// hardware threads, leaving a core for the thread that submits the work.
+
+		JobSystem( unsigned int uiWorkers = 0 );
+		virtual ~JobSystem();
+
+		void Submit( const Job& job, Counter& counter );
+		void Wait( Counter& counter );
+
+		// Executes a single pending job on the calling thread, if there is one.
+		// This lets a thread that waits on something other than a counter help
+		// out with the work in the meantime.
+
+		bool ExecutePending( );
+
+		// Splits the range [0,count) into chunks of at most 'grain' elements and
+		// calls func( begin, end ) for each of them in parallel.  The calling 
+		// thread processes the first chunk itself, and the call returns once all
+		// chunks have completed.
+
+		template <typename F>
+		void ParallelFor( unsigned int count, unsigned int grain, const F& func );
+
+		unsigned int GetWorkerCount() const;
+
+		static JobSystem* Get( );
+
+	protected:
+		struct Entry
+		{
+			Job			job;
+			Counter*	pCounter;
+		};
+
+		struct WorkQueue
+		{
+			std::mutex			Lock;
+			std::deque<Entry>	Jobs;
+		};
+
+		void WorkerProc( unsigned int index );
+		bool ExecuteOne( unsigned int queue );
+		void Complete( Counter& counter );
+		bool PopLocal( unsigned int queue, Entry& entry );
+		bool Steal( unsigned int queue, Entry& entry );
+		unsigned int CurrentQueue( ) const;
+
+		// Queue zero is shared by all non-worker threads, and worker i owns queue
+		// i+1.
+
+		std::vector< WorkQueue* >	m_Queues;
+		std::vector< std::thread >	m_Threads;
+
+		std::mutex					m_SleepLock;
+		std::condition_variable		m_WakeCondition;
+		std::atomic<int>			m_iQueuedJobs;
+		std::atomic<bool>			m_bShutdown;
+
+		static JobSystem* m_spJobSystem;
+	};
+
+	#include "JobSystem.inl"
+};
+//--------------------------------------------------------------------------------
+#endif // JobSystem_h
+//--------------------------------------------------------------------------------
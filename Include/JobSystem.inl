@@ -0,0 +1,40 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+template <typename F>
+void JobSystem::ParallelFor( unsigned int count, unsigned int grain, const F& func )
+{
+	if ( grain == 0 )
+		grain = 1;
+
+	// Small ranges aren't worth the scheduling overhead, so they are processed
+	// directly on the calling thread.
+
+	if ( count <= grain || m_Threads.empty() )
+	{
+		if ( count > 0 ) 
+			func( 0, count );
+		return;
+	}
+
+	Counter counter;
+
+	for ( unsigned int begin = grain; begin < count; begin += grain )
+	{
+		unsigned int end = std::min( begin + grain, count );
+		Submit( [&func, begin, end]() { func( begin, end ); }, counter );
+	}
+
+	func( 0, grain );
+
+	Wait( counter );
+}
+//--------------------------------------------------------------------------------
@@ -13,18 +13,66 @@
 //
 // The log class is a singleton that allows the application to write messages to 
 // a file.
+//
+// Writing a message doesn't touch the file.  Each thread copies its messages into
+// its own ring buffer without taking a lock, and a background thread started by
+// Open collects the messages of all threads, sorts them by the order they were
+// written in, and writes them out in batches.  A thread that writes more than
+// BufferSize messages before the writer catches up loses the extra messages,
+// which is noted in the log, except for errors, which wait for room in the
+// buffer.
+//
+// Messages below the minimum level are discarded right away.  Identical messages
+// that are repeated more often than the rate limit within one second are only
+// counted, and the count is written when the second is over.
+//
+// Flush blocks until everything written so far is in the file.  Errors are
+// flushed as soon as they are written, and the log is also flushed when the
+// process crashes with an unhandled exception and when it is closed.
 //--------------------------------------------------------------------------------
 #ifndef Log_h
 #define Log_h
 //--------------------------------------------------------------------------------
 #include "PCH.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 //--------------------------------------------------------------------------------
 namespace Glyph3
 {
-	class Log 
+	enum LogLevel
+	{
+		LOG_DEBUG = 0,
+		LOG_INFO,
+		LOG_WARNING,
+		LOG_ERROR
+	};
+
+	class Log
 	{
+	public:
+		static const unsigned int BufferSize = 1024;
+
+		struct Message
+		{
+			unsigned long long	sequence;
+			LogLevel			level;
+			std::wstring		text;
+		};
+
+		struct ThreadBuffer
+		{
+			// The owning thread writes the messages and advances the head, and
+			// only the writer thread reads them and advances the tail.
+			std::atomic<unsigned int>	head;
+			std::atomic<unsigned int>	tail;
+			Message						messages[BufferSize];
+		};
+
 	protected:
 		Log();
+		~Log();
 
 		std::wofstream	AppLog;
 
@@ -35,11 +83,63 @@ namespace Glyph3
 		bool Open( );
 		bool Close( );
 
-		bool Write( const wchar_t *TextString );
-		bool Write( std::wstring& TextString );
+		bool Write( const wchar_t *TextString, LogLevel level = LOG_INFO );
+		bool Write( const std::wstring& TextString, LogLevel level = LOG_INFO );
 		bool WriteSeparater( );
+
+		bool Flush( );
+
+		// Flushes the log, but gives up after the given time.  This is meant for
+		// a process that is crashing, where the lock might never be released.
+		bool FlushWithin( unsigned int milliseconds );
+
+		void SetMinimumLevel( LogLevel level );
+		LogLevel GetMinimumLevel( ) const;
+
+		// The number of identical messages that are written per second, or zero
+		// to write all of them.
+		void SetRateLimit( unsigned int messages );
+		unsigned int GetRateLimit( ) const;
+
+	protected:
+		struct RepeatCount
+		{
+			unsigned int	written;
+			unsigned int	suppressed;
+		};
+
+		ThreadBuffer* GetThreadBuffer( );
+		bool WaitForWriter( std::unique_lock<std::mutex>& lock, unsigned int milliseconds );
+
+		void WriterThread( );
+		void WriteBatch( );
+		void WriteMessage( LogLevel level, const std::wstring& text );
+		void WriteRepeatCounts( );
+
+		std::atomic<int>					m_MinimumLevel;
+		std::atomic<unsigned int>			m_uiRateLimit;
+		std::atomic<unsigned long long>		m_Sequence;
+		std::atomic<unsigned int>			m_uiDropped;
+		std::atomic<bool>					m_bWakeRequested;
+
+		std::mutex							m_Lock;
+		std::condition_variable				m_Wake;
+		std::condition_variable				m_Flushed;
+		std::thread							m_Writer;
+		bool								m_bRunning;
+		bool								m_bStopping;
+		unsigned int						m_uiFlushRequested;
+		unsigned int						m_uiFlushCompleted;
+		std::vector<ThreadBuffer*>			m_Buffers;
+
+		// Only used by the writer thread.
+		std::vector<ThreadBuffer*>			m_Draining;
+		std::vector<unsigned int>			m_Heads;
+		std::vector<Message*>				m_Batch;
+		std::map<std::wstring, RepeatCount>	m_Repeats;
+		unsigned long long					m_RepeatWindow;
 	};
 };
 //--------------------------------------------------------------------------------
 #endif // Log_h
-//--------------------------------------------------------------------------------
\ No newline at end of file
+//--------------------------------------------------------------------------------
@@ -30,6 +30,11 @@ namespace Glyph3
 		bool					bRender;
 		RenderEffectDX11*		pEffect;
 		std::vector<Task*>		Tasks;
+
+		// An optional variant of the effect that reads the world matrix from the
+		// INSTANCE_WORLD vertex input.  When it is set, entities that share the
+		// material and geometry are drawn together with one instanced draw.
+		RenderEffectDX11*		pInstancedEffect;
 	};
 
 	class MaterialDX11
@@ -29,7 +29,9 @@ namespace Glyph3
 		static MaterialPtr GenerateSkinnedTextured( RendererDX11& Renderer );
 		static MaterialPtr GenerateSkinnedSolid( RendererDX11& Renderer );
 
-		static MaterialPtr GeneratePhong( RendererDX11& Renderer );
+		// Geometry whose normals use VertexPacking::Octahedral needs the
+		// material that decodes them.
+		static MaterialPtr GeneratePhong( RendererDX11& Renderer, bool bOctahedralNormals = false );
 		static MaterialPtr GenerateSolidColor( RendererDX11& Renderer );
 
 		static MaterialPtr GenerateFromFile( RendererDX11& Renderer, std::wstring& file, unsigned int shaders );
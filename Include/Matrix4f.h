@@ -109,6 +109,12 @@ namespace Glyph3
 		// matrix - vector operations
 		Vector4f operator* ( const Vector4f& V ) const;  // M * v
 
+		// batch matrix - vector operations.  The input and output arrays may be
+		// the same array, but must not otherwise overlap.
+		void TransformVectors( const Vector4f* pIn, Vector4f* pOut, unsigned int uiCount ) const;
+		void TransformPoints( const Vector3f* pIn, Vector3f* pOut, unsigned int uiCount ) const;	// w = 1
+		void TransformDirections( const Vector3f* pIn, Vector3f* pOut, unsigned int uiCount ) const;	// w = 0
+
 		static const int m11 = 0;
 		static const int m12 = 1;
 		static const int m13 = 2;
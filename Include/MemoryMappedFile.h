@@ -0,0 +1,53 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// MemoryMappedFile
+//
+// Maps the complete contents of a file into the address space of the process
+// for reading.  This lets file loaders parse directly from the operating
+// system's file cache instead of copying the data through stream buffers.  The
+// view is released when the object is closed or destroyed.
+//--------------------------------------------------------------------------------
+#ifndef MemoryMappedFile_h
+#define MemoryMappedFile_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class MemoryMappedFile
+	{
+	public:
+		MemoryMappedFile();
+		~MemoryMappedFile();
+
+		// The filename is a full path.  Empty files can't be mapped, so opening
+		// them fails just like opening a missing file.
+		bool Open( const std::wstring& filename );
+		void Close( );
+
+		bool IsOpen( ) const;
+		const unsigned char* GetData( ) const;
+		size_t GetSize( ) const;
+
+	private:
+		MemoryMappedFile( const MemoryMappedFile& );
+		MemoryMappedFile& operator=( const MemoryMappedFile& );
+
+		HANDLE					m_hFile;
+		HANDLE					m_hMapping;
+		const unsigned char*	m_pData;
+		size_t					m_uiSize;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // MemoryMappedFile_h
+//--------------------------------------------------------------------------------
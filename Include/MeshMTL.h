@@ -27,7 +27,7 @@
 //--------------------------------------------------------------------------------
 namespace Glyph3 { namespace MTL {
 //--------------------------------------------------------------------------------
-Vector3f toVec3( const std::vector<std::string>& tokens )
+inline Vector3f toVec3( const std::vector<std::string>& tokens )
 {
 	assert( tokens.size() >= 4 );
 
@@ -36,7 +36,7 @@ Vector3f toVec3( const std::vector<std::string>& tokens )
 					 std::stof( tokens[3] ) );
 }
 //--------------------------------------------------------------------------------
-int toIllumModel( const std::vector<std::string>& tokens )
+inline int toIllumModel( const std::vector<std::string>& tokens )
 {
 	assert( tokens.size() == 2 );
 
@@ -61,16 +61,39 @@ namespace Glyph3
 		const std::vector<Entity3D*>& Leafs();
 		const std::vector<Node3D*>& Nodes();
 
+		// The structure revision is incremented on the root of a graph each time
+		// that a child is attached or detached anywhere within the graph.  This 
+		// lets flattened representations of the graph detect when to rebuild.
+
+		unsigned int GetStructureRevision( ) const;
+
+		// The world space bounds of the entities with geometry below this node,
+		// as of the last scene update.  A subtree can't be bounded when one of
+		// its entities has no shapes, in which case GetSubtreeBounds returns
+		// false.  The entity count includes the entities of all child nodes.
+
+		void SetSubtreeBounds( const Sphere3f& bounds, bool bBounded, unsigned int entities );
+		bool GetSubtreeBounds( Sphere3f& bounds ) const;
+		unsigned int GetSubtreeEntityCount( ) const;
+
 		Transform3D Transform;
 		ControllerPack<Node3D> Controllers;
 	
 	protected:
+		void StructureChanged( );
+
 		std::wstring m_Name;
 
 		std::vector< Entity3D* > m_Leafs;
 		std::vector< Node3D* > m_Nodes;
 
 		Node3D* m_pParent;
+
+		unsigned int m_uiStructureRevision;
+
+		Sphere3f m_SubtreeBounds;
+		bool m_bSubtreeBounded;
+		unsigned int m_uiSubtreeEntities;
 	};
 };
 //--------------------------------------------------------------------------------
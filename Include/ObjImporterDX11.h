@@ -0,0 +1,128 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// ObjImporterDX11
+//
+// Loads an OBJ file straight into GeometryDX11 objects, one for each material
+// used by each object in the file.  Unlike MeshOBJ, which keeps the raw data of
+// every face for the application to interpret, this produces indexed triangle
+// lists that are ready to be loaded to buffers.
+//
+// The file is memory mapped and split into chunks at line boundaries, and the
+// chunks are parsed in parallel on the JobSystem.  Each chunk collects its own
+// vertex data and triangles, and merges the position / texture coordinate /
+// normal triplets that are used more than once into a single vertex.  The
+// chunks are then stitched together: the relative indices are resolved, and
+// the vertices of all chunks are merged once more for each part.  Apart from
+// the object and material names, nothing is allocated per line or per face.
+//
+// Polygons are split into triangle fans, and lines and points are skipped.  The
+// texture coordinate and normal elements are only created for the parts that
+// use them.  The material libraries named in the file are loaded with MeshMTL
+// from the folder of the OBJ file, and the properties of each part's material
+// are copied into it when they are found.
+//--------------------------------------------------------------------------------
+#ifndef ObjImporterDX11_h
+#define ObjImporterDX11_h
+//--------------------------------------------------------------------------------
+#include "GeometryDX11.h"
+#include "MeshMTL.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class ObjImporterDX11
+	{
+	public:
+		struct Part
+		{
+			std::string						object;
+			std::string						material;
+			MTL::MeshMTL::material_t		properties;
+			GeometryPtr						geometry;
+		};
+
+		// The filename is a full path.  Returns false, with no parts, if the
+		// file can't be opened or contains invalid data.
+		static bool Load( const std::wstring& filename, std::vector<Part>& parts );
+
+	private:
+		ObjImporterDX11();
+
+		enum EventType
+		{
+			OBJ_OBJECT,
+			OBJ_MATERIAL
+		};
+
+		// A change of the current object or material, which takes effect from
+		// the given triangle corner of the chunk onwards.
+		struct Event
+		{
+			EventType		type;
+			unsigned int	corner;
+			std::string		name;
+			unsigned int	part;
+		};
+
+		// The indices of one triangle corner.  Positive indices from the file are
+		// stored zero based.  Negative indices are stored relative to the start
+		// of the chunk, which isn't known until all chunks are parsed, and are
+		// marked with the bit of the attribute in 'relative'.  A missing texture
+		// coordinate or normal is -1.
+		struct Corner
+		{
+			int				index[3];
+			unsigned int	relative;
+		};
+
+		// A unique triplet within a chunk, which is merged with the vertices of
+		// the other chunks in the same part.
+		struct Vertex
+		{
+			unsigned int	part;
+			int				index[3];
+		};
+
+		struct Chunk
+		{
+			const char*					pBegin;
+			const char*					pEnd;
+			bool						error;
+
+			std::vector<float>			positions;
+			std::vector<float>			texcoords;
+			std::vector<float>			normals;
+			std::vector<Corner>			corners;
+			std::vector<Event>			events;
+			std::vector<std::string>	libraries;
+
+			// The number of each attribute in the chunks before this one.
+			unsigned int				base[3];
+			unsigned int				firstPart;
+
+			std::vector<Vertex>			vertices;
+			std::vector<UINT>			indices;
+			std::vector<UINT>			remap;
+			std::vector<unsigned int>	partCorners;
+			std::vector<unsigned int>	partOffsets;
+		};
+
+		static void ParseChunk( Chunk& chunk );
+		static void ResolveChunk( Chunk& chunk, const unsigned int* pTotals );
+		static void WeldChunk( Chunk& chunk, unsigned int partCount );
+
+		static const char* ParseInt( const char* p, const char* pEnd, int& value );
+		static std::string ParseName( const char* p, const char* pEnd );
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // ObjImporterDX11_h
+//--------------------------------------------------------------------------------
@@ -49,10 +49,26 @@
 #define SAFE_DELETE( x ) {if(x){delete (x);(x)=NULL;}}
 #define SAFE_DELETE_ARRAY( x ) {if(x){delete[] (x);(x)=NULL;}}
 
-// Define the number of threads to use for 
-#define NUM_THREADS 4
+// Define the maximum number of threads that render tasks are recorded on.  Each
+// of them has its own slot in the render parameters, and the renderer uses as
+// many of them as the job system has threads.  Constant buffers are only created
+// for the slots that the renderer uses.
+#define NUM_THREADS 8
 
 #define GLYPH_PI 3.14159265f
 
+// Thread local storage qualifier, for the few places that need per-thread state.
+#if defined(_MSC_VER)
+#define GLYPH_THREAD_LOCAL __declspec(thread)
+#else
+#define GLYPH_THREAD_LOCAL __thread
+#endif
+
+// Select the SSE implementation of the Matrix4f kernels.  Define this as 0 to
+// build the library with the scalar reference implementation instead.
+#ifndef GLYPH_SSE_MATH
+#define GLYPH_SSE_MATH 1
+#endif
+
 
 #endif // PCH_h
\ No newline at end of file
@@ -42,6 +42,7 @@ namespace Glyph3
 		//       new writer instead of returning nullptr, as there is no alternative - 
 		//       you have no choice but to create a new writer.
 		ParameterWriter* GetRenderParameter( const std::wstring& name );
+		ParameterWriter* GetRenderParameter( unsigned int nameID );
 		ConstantBufferParameterWriterDX11* GetConstantBufferParameterWriter( const std::wstring& name );
 		MatrixArrayParameterWriterDX11* GetMatrixArrayParameterWriter( const std::wstring& name );
 		MatrixParameterWriterDX11* GetMatrixParameterWriter( const std::wstring& name );
@@ -61,13 +62,21 @@ namespace Glyph3
 		UnorderedAccessParameterWriterDX11* SetUnorderedAccessParameter( const std::wstring& name, const ResourcePtr& value );
 		VectorParameterWriterDX11* SetVectorParameter( const std::wstring& name, const Vector4f& value );
 
+		unsigned int GetRenderParameterCount( ) const;
+
 		// Apply the parameters in this container to a parameter manager.
 		void SetRenderParams( IParameterManager* pParamManager );
 		void InitRenderParams( );
 
 	protected:
 
+		static bool CompareID( const std::pair< unsigned int, ParameterWriter* >& entry, unsigned int nameID );
+
+		// The writers are applied in the order that they were added, and are also
+		// indexed by the name ID of their parameter, sorted for a binary search.
+
 		std::vector< ParameterWriter* > m_RenderParameters;
+		std::vector< std::pair< unsigned int, ParameterWriter* > > m_Index;
 	};
 };
 //--------------------------------------------------------------------------------
@@ -55,6 +55,7 @@ namespace Glyph3
 		// References to parameters are acquired by simply querying for them by name.
 
 		virtual RenderParameterDX11* GetParameterRef( const std::wstring& name );
+		virtual RenderParameterDX11* GetParameterRef( unsigned int nameID );
 		virtual VectorParameterDX11* GetVectorParameterRef( const std::wstring& name );
 		virtual MatrixParameterDX11* GetMatrixParameterRef( const std::wstring& name );
 		virtual ShaderResourceParameterDX11* GetShaderResourceParameterRef( const std::wstring& name );
@@ -93,11 +94,13 @@ namespace Glyph3
 		void SetViewMatrixParameter( Matrix4f* pMatrix );
 		void SetProjMatrixParameter( Matrix4f* pMatrix );
 
-		// All rendering parameters are stored in a map and are accessed by name.  This may
-		// be modified to allow faster random access in the future, possibly using a hash 
-		// table to reference an array.
+		// All rendering parameters are stored in an array indexed by the ID of their
+		// name in the ParameterNameTable.  A name is converted to its ID with a single
+		// hash table lookup, and the ID can be kept to skip even that lookup.
 
-		static std::map< std::wstring, RenderParameterDX11* >	m_Parameters;
+		static unsigned int GetNameID( const std::wstring& name );
+
+		static std::vector< RenderParameterDX11* >	m_Parameters;
 
 		void AttachParent( IParameterManager* pParent );
 		void DetachParent( );
@@ -109,6 +112,10 @@ namespace Glyph3
 
 	protected:
 
+		static RenderParameterDX11* FindParameter( unsigned int nameID );
+		static RenderParameterDX11* FindParameter( const std::wstring& name );
+		static void StoreParameter( RenderParameterDX11* pParameter );
+
 		IParameterManager*	m_pParent;
 		unsigned int m_ID;
 
@@ -0,0 +1,90 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// ParameterNameTable
+//
+// Interns the names of the rendering parameters, assigning each distinct name a
+// small integer ID.  IDs are handed out sequentially starting from zero and are
+// never reused, so they can be used directly as array indices and stored for
+// the lifetime of the application.
+//
+// The names are located with an open addressed hash table using linear
+// probing, which stores only the IDs and is kept at most half full.  The table
+// is shared by all threads and is protected by a reader/writer lock, so that
+// lookups of names which are already interned only contend with the insertion
+// of new names.  Callers on a hot path should still look up an ID once and then
+// keep it rather than repeating the lookup.
+//
+// The first instance that is created is available through 
+// ParameterNameTable::Get(), following the pattern of the EventManager.  The 
+// application creates it before any of the rendering components, which intern
+// their parameter names as they are created.
+//--------------------------------------------------------------------------------
+#ifndef ParameterNameTable_h
+#define ParameterNameTable_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include <deque>
+#include <atomic>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class ParameterNameTable
+	{
+	public:
+		static const unsigned int InvalidID = 0xffffffff;
+
+		ParameterNameTable();
+		~ParameterNameTable();
+
+		static ParameterNameTable* Get( );
+
+		// Returns the ID of the name, adding it to the table if needed.
+		unsigned int Intern( const std::wstring& name );
+
+		// Returns the ID of the name, or InvalidID if it has not been interned.
+		unsigned int Find( const std::wstring& name ) const;
+
+		// The returned reference remains valid for the lifetime of the table.
+		const std::wstring& GetName( unsigned int id ) const;
+		unsigned int GetCount( ) const;
+
+		// The number of name lookups that have been performed, which is useful
+		// for verifying that a frame doesn't perform any string lookups.
+		unsigned int GetLookupCount( ) const;
+		void ResetLookupCount( );
+
+	protected:
+		static unsigned int Hash( const std::wstring& name );
+
+		unsigned int FindSlot( const std::wstring& name, unsigned int hash ) const;
+		void Grow( );
+
+		// The slots hold ID+1, with zero marking an empty slot.  The size of the
+		// slot array is always a power of two.
+
+		std::vector< unsigned int >		m_Slots;
+		std::vector< unsigned int >		m_Hashes;
+		std::deque< std::wstring >		m_Names;
+
+		mutable std::atomic<unsigned int>	m_uiLookups;
+		mutable SRWLOCK					m_Lock;
+
+		static ParameterNameTable*		m_spNameTable;
+
+	private:
+		ParameterNameTable( const ParameterNameTable& );
+		ParameterNameTable& operator=( const ParameterNameTable& );
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // ParameterNameTable_h
+//--------------------------------------------------------------------------------
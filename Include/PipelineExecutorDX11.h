@@ -43,6 +43,14 @@ namespace Glyph3
 		virtual void GenerateInputLayout( int ShaderID );
 		virtual int GetInputLayout( int ShaderID );
 
+		// Executors that can draw many copies of themselves with one draw call
+		// take a vertex buffer of per-instance world matrices, which is bound to
+		// slot 1 as four float4 rows with the INSTANCE_WORLD semantic.
+
+		virtual bool SupportsInstancing( );
+		virtual void ExecuteInstanced( PipelineManagerDX11* pPipeline, IParameterManager* pParamManager,
+			int instances, UINT start, UINT count );
+
 	protected:
 
 		// A description of our vertex elements
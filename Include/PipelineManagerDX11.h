@@ -34,8 +34,10 @@ namespace Glyph3
 {
 
 	class CommandListDX11;
+	class ConstantBufferRingDX11;
 
 	typedef Microsoft::WRL::ComPtr<ID3DUserDefinedAnnotation> UserDefinedAnnotationComPtr;
+	typedef Microsoft::WRL::ComPtr<ID3D11DeviceContext1> DeviceContext1ComPtr;
 
 	class PipelineManagerDX11
 	{
@@ -47,6 +49,14 @@ namespace Glyph3
 
 		void SetDeviceContext( DeviceContextComPtr pContext, D3D_FEATURE_LEVEL level );
 
+		// Automatically updated constant buffers are written into a ring of the
+		// given size and bound with an offset, instead of being mapped one by one.
+		// This needs the constant buffer offsetting of Direct3D 11.1, so false is
+		// returned when the device doesn't support it.
+
+		bool CreateConstantBufferRing( unsigned int capacity );
+		ConstantBufferRingDX11* GetConstantBufferRing();
+
 		// All of the 'Bind/Unbind' functions below are used to bind various resources to the
 		// pipeline.  Currently only the CS can accept unordered access views.  A method is
 		// provided to apply the resource changes as an optimization, which allows for the
@@ -216,7 +226,9 @@ namespace Glyph3
 		D3D_FEATURE_LEVEL						m_FeatureLevel;
 		
 		DeviceContextComPtr			            m_pContext;
+		DeviceContext1ComPtr					m_pContext1;
 		UserDefinedAnnotationComPtr				m_pAnnotation;
+		ConstantBufferRingDX11*					m_pConstantRing;
 		
         static const int                        NumQueries = 3;
         int                                     m_iCurrentQuery;
@@ -0,0 +1,187 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// Profiler
+//
+// A CPU profiler for timing named zones of code on any thread.  A zone is opened
+// with the GLYPH_PROFILE_SCOPE macro, and closed when the enclosing scope ends:
+//
+//   void Scene::Update( float time )
+//   {
+//       GLYPH_PROFILE_SCOPE( "Scene::Update" );
+//       ...
+//   }
+//
+// The zone name must be a string literal (or otherwise outlive the profiler),
+// since only the pointer is stored.
+//
+// Each thread writes its completed zones into its own ring buffer, with a single
+// atomic store per zone and no locks.  Once per frame, EndFrame collects the
+// zones of all threads and updates a rolling table of per-zone statistics over
+// the last HistoryFrames frames.  While a capture is active, the collected zones
+// are also kept so that they can be written out as a Chrome trace, which can be
+// opened in chrome://tracing or similar tools.
+//
+// The profiler starts out disabled.  A disabled zone only costs a relaxed atomic
+// load, and defining GLYPH_PROFILING as 0 removes the zones altogether.  The
+// cost of a zone in the current state can be checked with MeasureOverhead.
+//--------------------------------------------------------------------------------
+#ifndef Profiler_h
+#define Profiler_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include <atomic>
+#include <mutex>
+//--------------------------------------------------------------------------------
+#ifndef GLYPH_PROFILING
+#define GLYPH_PROFILING 1
+#endif
+
+#if GLYPH_PROFILING
+#define GLYPH_PROFILE_CONCAT_INNER( a, b ) a##b
+#define GLYPH_PROFILE_CONCAT( a, b ) GLYPH_PROFILE_CONCAT_INNER( a, b )
+#define GLYPH_PROFILE_SCOPE( name ) Glyph3::ProfileScope GLYPH_PROFILE_CONCAT( profileScope, __LINE__ )( name )
+#else
+#define GLYPH_PROFILE_SCOPE( name )
+#endif
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class Profiler
+	{
+	public:
+		static const unsigned int BufferSize = 4096;
+		static const unsigned int HistoryFrames = 64;
+
+		struct Event
+		{
+			const char*				name;
+			unsigned long long		begin;
+			unsigned long long		end;
+			unsigned int			depth;
+			unsigned int			thread;
+		};
+
+		struct ThreadBuffer
+		{
+			unsigned int				thread;
+			unsigned int				depth;
+
+			// The owning thread writes the events and advances the head, and
+			// only EndFrame reads them and advances the tail.
+			std::atomic<unsigned int>	head;
+			unsigned int				tail;
+			Event						events[BufferSize];
+		};
+
+		struct ZoneStatistics
+		{
+			std::string		name;
+			unsigned int	calls;
+			float			frameTime;
+			float			averageTime;
+			float			maximumTime;
+			float			history[HistoryFrames];
+		};
+
+		static Profiler& Get( );
+
+		void SetEnabled( bool enable );
+		bool IsEnabled( ) const;
+
+		// Collects the zones that were completed since the last call, and
+		// advances the statistics by one frame.
+		void EndFrame( );
+
+		void BeginCapture( );
+		void EndCapture( );
+		bool IsCapturing( ) const;
+		bool WriteChromeTrace( const std::wstring& filename );
+
+		// The statistics are sorted by their average time, with the most
+		// expensive zone first.  Times are in milliseconds.
+		std::vector<ZoneStatistics> GetStatistics( ) const;
+		std::wstring GetStatisticsTable( unsigned int rows ) const;
+
+		// Returns the number of zones that were lost because a thread completed
+		// more than BufferSize zones between two frames.
+		unsigned int GetDroppedEvents( ) const;
+
+		// Times the given number of empty zones on the calling thread with the
+		// profiler in its current state, and returns the cost of one zone in
+		// nanoseconds.  The zones that the calling thread completed since the
+		// last frame are discarded, so this should be called between frames.
+		double MeasureOverhead( unsigned int iterations );
+
+		static unsigned long long GetTimestamp( );
+		static double GetTimestampFrequency( );
+
+		// Used by ProfileScope.
+		ThreadBuffer* EnterZone( );
+		void LeaveZone( ThreadBuffer* pBuffer, const char* name, unsigned long long begin );
+
+		static std::atomic<bool>	ms_bEnabled;
+
+	protected:
+		Profiler( );
+		~Profiler( );
+
+		void Collect( ThreadBuffer* pBuffer, std::vector<Event>& events );
+		ZoneStatistics& GetZone( const char* name );
+
+		mutable std::mutex						m_Lock;
+		std::vector<ThreadBuffer*>				m_Buffers;
+
+		std::vector<ZoneStatistics>				m_Zones;
+		std::map<const char*, unsigned int>		m_ZoneLookup;
+		std::map<std::string, unsigned int>		m_ZoneNames;
+		unsigned int							m_uiFrame;
+		unsigned int							m_uiDropped;
+
+		bool									m_bCapturing;
+		unsigned long long						m_CaptureStart;
+		std::vector<Event>						m_Capture;
+
+		static Profiler							ms_Profiler;
+	};
+
+	class ProfileScope
+	{
+	public:
+		ProfileScope( const char* name ) :
+			m_pBuffer( nullptr )
+		{
+			if ( Profiler::ms_bEnabled.load( std::memory_order_relaxed ) )
+			{
+				m_pBuffer = Profiler::Get().EnterZone();
+				m_pName = name;
+				m_Begin = Profiler::GetTimestamp();
+			}
+		}
+
+		~ProfileScope()
+		{
+			if ( m_pBuffer )
+				Profiler::Get().LeaveZone( m_pBuffer, m_pName, m_Begin );
+		}
+
+	private:
+		ProfileScope( const ProfileScope& );
+		ProfileScope& operator=( const ProfileScope& );
+
+		Profiler::ThreadBuffer*		m_pBuffer;
+		const char*					m_pName;
+		unsigned long long			m_Begin;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // Profiler_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,323 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// RecordingDeviceContextDX11
+//
+// A device context that doesn't submit anything to a GPU.  Instead, every bind,
+// map and draw is written into a compact command stream, and counted in a set
+// of statistics.  Since it implements ID3D11DeviceContext1, it can be given to
+// PipelineManagerDX11::SetDeviceContext in place of a real context, and all of
+// the CPU side submission code runs unchanged on top of it:
+//
+//   ComPtr<ID3D11DeviceContext> pRecorder;
+//   pRecorder.Attach( new RecordingDeviceContextDX11( pDevice ) );
+//   pPipeline->SetDeviceContext( pRecorder, level );
+//
+// The resources are still created with a device, which can use the
+// D3D_DRIVER_TYPE_NULL driver when no GPU is available.  The device is only
+// returned from GetDevice, and isn't needed otherwise.
+//
+// Mapping a resource returns memory owned by the recorder, so that constant
+// buffers and other dynamic resources can be filled as usual.  The recorder
+// also keeps the values bound to each slot, and counts the slots that are
+// bound to the value they already had as redundant.  The Get* methods don't
+// report this state, and always return empty values.
+//
+// Recording the command stream can be disabled, in which case only the
+// statistics are kept.  This keeps long benchmarks from growing the stream.
+//--------------------------------------------------------------------------------
+#ifndef RecordingDeviceContextDX11_h
+#define RecordingDeviceContextDX11_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	enum class RecordedCommandType : unsigned char
+	{
+		SetShader,
+		SetConstantBuffers,
+		SetSamplers,
+		SetShaderResources,
+		SetUnorderedAccessViews,
+		SetInputLayout,
+		SetVertexBuffers,
+		SetIndexBuffer,
+		SetPrimitiveTopology,
+		SetRasterizerState,
+		SetViewports,
+		SetScissorRects,
+		SetBlendState,
+		SetDepthStencilState,
+		SetRenderTargets,
+		SetStreamOutputTargets,
+		Map,
+		Unmap,
+		Draw,
+		DrawIndexed,
+		DrawInstanced,
+		DrawIndexedInstanced,
+		DrawIndirect,
+		Dispatch,
+		DispatchIndirect,
+		Clear,
+		Copy,
+		Update,
+		Query,
+		Other
+	};
+
+	// Each command takes 16 bytes.  The meaning of the fields depends on the
+	// command: binds store their start slot and slot count, draws their counts
+	// in 'start', 'count' and 'args', and maps their map type.  The stage is the
+	// ShaderType of the shader stage commands, and zero otherwise.
+
+	struct RecordedCommandDX11
+	{
+		RecordedCommandType		type;
+		unsigned char			stage;
+		unsigned short			count;
+		unsigned int			start;
+		unsigned int			args[2];
+	};
+
+	struct RecordingStatisticsDX11
+	{
+		unsigned int	commands;
+		unsigned int	draws;
+		unsigned int	dispatches;
+		unsigned int	bindCalls;
+		unsigned int	boundSlots;
+		unsigned int	redundantSlots;
+		unsigned int	maps;
+		unsigned int	mappedBytes;
+	};
+
+	class RecordingDeviceContextDX11 : public ID3D11DeviceContext1
+	{
+	public:
+		RecordingDeviceContextDX11( ID3D11Device* pDevice = nullptr );
+		virtual ~RecordingDeviceContextDX11();
+
+		// Clears the command stream, the statistics and the bound state.
+		void Reset();
+
+		void SetRecordingEnabled( bool enable );
+		bool IsRecordingEnabled() const;
+
+		const std::vector<RecordedCommandDX11>& GetCommands() const;
+		const RecordingStatisticsDX11& GetStatistics() const;
+
+		std::wstring PrintStatistics() const;
+
+		// IUnknown
+
+		virtual HRESULT STDMETHODCALLTYPE QueryInterface( REFIID riid, void** ppvObject );
+		virtual ULONG STDMETHODCALLTYPE AddRef();
+		virtual ULONG STDMETHODCALLTYPE Release();
+
+		// ID3D11DeviceChild
+
+		virtual void STDMETHODCALLTYPE GetDevice( ID3D11Device** ppDevice );
+		virtual HRESULT STDMETHODCALLTYPE GetPrivateData( REFGUID guid, UINT* pDataSize, void* pData );
+		virtual HRESULT STDMETHODCALLTYPE SetPrivateData( REFGUID guid, UINT DataSize, const void* pData );
+		virtual HRESULT STDMETHODCALLTYPE SetPrivateDataInterface( REFGUID guid, const IUnknown* pData );
+
+		// ID3D11DeviceContext
+
+		virtual void STDMETHODCALLTYPE VSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+		virtual void STDMETHODCALLTYPE PSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+		virtual void STDMETHODCALLTYPE PSSetShader( ID3D11PixelShader* pPixelShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+		virtual void STDMETHODCALLTYPE PSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+		virtual void STDMETHODCALLTYPE VSSetShader( ID3D11VertexShader* pVertexShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+		virtual void STDMETHODCALLTYPE DrawIndexed( UINT IndexCount, UINT StartIndexLocation, INT BaseVertexLocation );
+		virtual void STDMETHODCALLTYPE Draw( UINT VertexCount, UINT StartVertexLocation );
+		virtual HRESULT STDMETHODCALLTYPE Map( ID3D11Resource* pResource, UINT Subresource, D3D11_MAP MapType, UINT MapFlags, D3D11_MAPPED_SUBRESOURCE* pMappedResource );
+		virtual void STDMETHODCALLTYPE Unmap( ID3D11Resource* pResource, UINT Subresource );
+		virtual void STDMETHODCALLTYPE PSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+		virtual void STDMETHODCALLTYPE IASetInputLayout( ID3D11InputLayout* pInputLayout );
+		virtual void STDMETHODCALLTYPE IASetVertexBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppVertexBuffers, const UINT* pStrides, const UINT* pOffsets );
+		virtual void STDMETHODCALLTYPE IASetIndexBuffer( ID3D11Buffer* pIndexBuffer, DXGI_FORMAT Format, UINT Offset );
+		virtual void STDMETHODCALLTYPE DrawIndexedInstanced( UINT IndexCountPerInstance, UINT InstanceCount, UINT StartIndexLocation, INT BaseVertexLocation, UINT StartInstanceLocation );
+		virtual void STDMETHODCALLTYPE DrawInstanced( UINT VertexCountPerInstance, UINT InstanceCount, UINT StartVertexLocation, UINT StartInstanceLocation );
+		virtual void STDMETHODCALLTYPE GSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+		virtual void STDMETHODCALLTYPE GSSetShader( ID3D11GeometryShader* pShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+		virtual void STDMETHODCALLTYPE IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY Topology );
+		virtual void STDMETHODCALLTYPE VSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+		virtual void STDMETHODCALLTYPE VSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+		virtual void STDMETHODCALLTYPE Begin( ID3D11Asynchronous* pAsync );
+		virtual void STDMETHODCALLTYPE End( ID3D11Asynchronous* pAsync );
+		virtual HRESULT STDMETHODCALLTYPE GetData( ID3D11Asynchronous* pAsync, void* pData, UINT DataSize, UINT GetDataFlags );
+		virtual void STDMETHODCALLTYPE SetPredication( ID3D11Predicate* pPredicate, BOOL PredicateValue );
+		virtual void STDMETHODCALLTYPE GSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+		virtual void STDMETHODCALLTYPE GSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+		virtual void STDMETHODCALLTYPE OMSetRenderTargets( UINT NumViews, ID3D11RenderTargetView* const* ppRenderTargetViews, ID3D11DepthStencilView* pDepthStencilView );
+		virtual void STDMETHODCALLTYPE OMSetRenderTargetsAndUnorderedAccessViews( UINT NumRTVs, ID3D11RenderTargetView* const* ppRenderTargetViews, ID3D11DepthStencilView* pDepthStencilView, UINT UAVStartSlot, UINT NumUAVs, ID3D11UnorderedAccessView* const* ppUnorderedAccessViews, const UINT* pUAVInitialCounts );
+		virtual void STDMETHODCALLTYPE OMSetBlendState( ID3D11BlendState* pBlendState, const FLOAT BlendFactor[4], UINT SampleMask );
+		virtual void STDMETHODCALLTYPE OMSetDepthStencilState( ID3D11DepthStencilState* pDepthStencilState, UINT StencilRef );
+		virtual void STDMETHODCALLTYPE SOSetTargets( UINT NumBuffers, ID3D11Buffer* const* ppSOTargets, const UINT* pOffsets );
+		virtual void STDMETHODCALLTYPE DrawAuto();
+		virtual void STDMETHODCALLTYPE DrawIndexedInstancedIndirect( ID3D11Buffer* pBufferForArgs, UINT AlignedByteOffsetForArgs );
+		virtual void STDMETHODCALLTYPE DrawInstancedIndirect( ID3D11Buffer* pBufferForArgs, UINT AlignedByteOffsetForArgs );
+		virtual void STDMETHODCALLTYPE Dispatch( UINT ThreadGroupCountX, UINT ThreadGroupCountY, UINT ThreadGroupCountZ );
+		virtual void STDMETHODCALLTYPE DispatchIndirect( ID3D11Buffer* pBufferForArgs, UINT AlignedByteOffsetForArgs );
+		virtual void STDMETHODCALLTYPE RSSetState( ID3D11RasterizerState* pRasterizerState );
+		virtual void STDMETHODCALLTYPE RSSetViewports( UINT NumViewports, const D3D11_VIEWPORT* pViewports );
+		virtual void STDMETHODCALLTYPE RSSetScissorRects( UINT NumRects, const D3D11_RECT* pRects );
+		virtual void STDMETHODCALLTYPE CopySubresourceRegion( ID3D11Resource* pDstResource, UINT DstSubresource, UINT DstX, UINT DstY, UINT DstZ, ID3D11Resource* pSrcResource, UINT SrcSubresource, const D3D11_BOX* pSrcBox );
+		virtual void STDMETHODCALLTYPE CopyResource( ID3D11Resource* pDstResource, ID3D11Resource* pSrcResource );
+		virtual void STDMETHODCALLTYPE UpdateSubresource( ID3D11Resource* pDstResource, UINT DstSubresource, const D3D11_BOX* pDstBox, const void* pSrcData, UINT SrcRowPitch, UINT SrcDepthPitch );
+		virtual void STDMETHODCALLTYPE CopyStructureCount( ID3D11Buffer* pDstBuffer, UINT DstAlignedByteOffset, ID3D11UnorderedAccessView* pSrcView );
+		virtual void STDMETHODCALLTYPE ClearRenderTargetView( ID3D11RenderTargetView* pRenderTargetView, const FLOAT ColorRGBA[4] );
+		virtual void STDMETHODCALLTYPE ClearUnorderedAccessViewUint( ID3D11UnorderedAccessView* pUnorderedAccessView, const UINT Values[4] );
+		virtual void STDMETHODCALLTYPE ClearUnorderedAccessViewFloat( ID3D11UnorderedAccessView* pUnorderedAccessView, const FLOAT Values[4] );
+		virtual void STDMETHODCALLTYPE ClearDepthStencilView( ID3D11DepthStencilView* pDepthStencilView, UINT ClearFlags, FLOAT Depth, UINT8 Stencil );
+		virtual void STDMETHODCALLTYPE GenerateMips( ID3D11ShaderResourceView* pShaderResourceView );
+		virtual void STDMETHODCALLTYPE SetResourceMinLOD( ID3D11Resource* pResource, FLOAT MinLOD );
+		virtual FLOAT STDMETHODCALLTYPE GetResourceMinLOD( ID3D11Resource* pResource );
+		virtual void STDMETHODCALLTYPE ResolveSubresource( ID3D11Resource* pDstResource, UINT DstSubresource, ID3D11Resource* pSrcResource, UINT SrcSubresource, DXGI_FORMAT Format );
+		virtual void STDMETHODCALLTYPE ExecuteCommandList( ID3D11CommandList* pCommandList, BOOL RestoreContextState );
+		virtual void STDMETHODCALLTYPE HSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+		virtual void STDMETHODCALLTYPE HSSetShader( ID3D11HullShader* pHullShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+		virtual void STDMETHODCALLTYPE HSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+		virtual void STDMETHODCALLTYPE HSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+		virtual void STDMETHODCALLTYPE DSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+		virtual void STDMETHODCALLTYPE DSSetShader( ID3D11DomainShader* pDomainShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+		virtual void STDMETHODCALLTYPE DSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+		virtual void STDMETHODCALLTYPE DSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+		virtual void STDMETHODCALLTYPE CSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews );
+		virtual void STDMETHODCALLTYPE CSSetUnorderedAccessViews( UINT StartSlot, UINT NumUAVs, ID3D11UnorderedAccessView* const* ppUnorderedAccessViews, const UINT* pUAVInitialCounts );
+		virtual void STDMETHODCALLTYPE CSSetShader( ID3D11ComputeShader* pComputeShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances );
+		virtual void STDMETHODCALLTYPE CSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+		virtual void STDMETHODCALLTYPE CSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers );
+		virtual void STDMETHODCALLTYPE VSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers );
+		virtual void STDMETHODCALLTYPE PSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews );
+		virtual void STDMETHODCALLTYPE PSGetShader( ID3D11PixelShader** ppPixelShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances );
+		virtual void STDMETHODCALLTYPE PSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers );
+		virtual void STDMETHODCALLTYPE VSGetShader( ID3D11VertexShader** ppVertexShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances );
+		virtual void STDMETHODCALLTYPE PSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers );
+		virtual void STDMETHODCALLTYPE IAGetInputLayout( ID3D11InputLayout** ppInputLayout );
+		virtual void STDMETHODCALLTYPE IAGetVertexBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppVertexBuffers, UINT* pStrides, UINT* pOffsets );
+		virtual void STDMETHODCALLTYPE IAGetIndexBuffer( ID3D11Buffer** pIndexBuffer, DXGI_FORMAT* Format, UINT* Offset );
+		virtual void STDMETHODCALLTYPE GSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers );
+		virtual void STDMETHODCALLTYPE GSGetShader( ID3D11GeometryShader** ppGeometryShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances );
+		virtual void STDMETHODCALLTYPE IAGetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY* pTopology );
+		virtual void STDMETHODCALLTYPE VSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews );
+		virtual void STDMETHODCALLTYPE VSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers );
+		virtual void STDMETHODCALLTYPE GetPredication( ID3D11Predicate** ppPredicate, BOOL* pPredicateValue );
+		virtual void STDMETHODCALLTYPE GSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews );
+		virtual void STDMETHODCALLTYPE GSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers );
+		virtual void STDMETHODCALLTYPE OMGetRenderTargets( UINT NumViews, ID3D11RenderTargetView** ppRenderTargetViews, ID3D11DepthStencilView** ppDepthStencilView );
+		virtual void STDMETHODCALLTYPE OMGetRenderTargetsAndUnorderedAccessViews( UINT NumRTVs, ID3D11RenderTargetView** ppRenderTargetViews, ID3D11DepthStencilView** ppDepthStencilView, UINT UAVStartSlot, UINT NumUAVs, ID3D11UnorderedAccessView** ppUnorderedAccessViews );
+		virtual void STDMETHODCALLTYPE OMGetBlendState( ID3D11BlendState** ppBlendState, FLOAT BlendFactor[4], UINT* pSampleMask );
+		virtual void STDMETHODCALLTYPE OMGetDepthStencilState( ID3D11DepthStencilState** ppDepthStencilState, UINT* pStencilRef );
+		virtual void STDMETHODCALLTYPE SOGetTargets( UINT NumBuffers, ID3D11Buffer** ppSOTargets );
+		virtual void STDMETHODCALLTYPE RSGetState( ID3D11RasterizerState** ppRasterizerState );
+		virtual void STDMETHODCALLTYPE RSGetViewports( UINT* pNumViewports, D3D11_VIEWPORT* pViewports );
+		virtual void STDMETHODCALLTYPE RSGetScissorRects( UINT* pNumRects, D3D11_RECT* pRects );
+		virtual void STDMETHODCALLTYPE HSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews );
+		virtual void STDMETHODCALLTYPE HSGetShader( ID3D11HullShader** ppHullShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances );
+		virtual void STDMETHODCALLTYPE HSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers );
+		virtual void STDMETHODCALLTYPE HSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers );
+		virtual void STDMETHODCALLTYPE DSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews );
+		virtual void STDMETHODCALLTYPE DSGetShader( ID3D11DomainShader** ppDomainShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances );
+		virtual void STDMETHODCALLTYPE DSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers );
+		virtual void STDMETHODCALLTYPE DSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers );
+		virtual void STDMETHODCALLTYPE CSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews );
+		virtual void STDMETHODCALLTYPE CSGetUnorderedAccessViews( UINT StartSlot, UINT NumUAVs, ID3D11UnorderedAccessView** ppUnorderedAccessViews );
+		virtual void STDMETHODCALLTYPE CSGetShader( ID3D11ComputeShader** ppComputeShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances );
+		virtual void STDMETHODCALLTYPE CSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers );
+		virtual void STDMETHODCALLTYPE CSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers );
+		virtual void STDMETHODCALLTYPE ClearState();
+		virtual void STDMETHODCALLTYPE Flush();
+		virtual D3D11_DEVICE_CONTEXT_TYPE STDMETHODCALLTYPE GetType();
+		virtual UINT STDMETHODCALLTYPE GetContextFlags();
+		virtual HRESULT STDMETHODCALLTYPE FinishCommandList( BOOL RestoreDeferredContextState, ID3D11CommandList** ppCommandList );
+
+		// ID3D11DeviceContext1
+
+		virtual void STDMETHODCALLTYPE CopySubresourceRegion1( ID3D11Resource* pDstResource, UINT DstSubresource, UINT DstX, UINT DstY, UINT DstZ, ID3D11Resource* pSrcResource, UINT SrcSubresource, const D3D11_BOX* pSrcBox, UINT CopyFlags );
+		virtual void STDMETHODCALLTYPE UpdateSubresource1( ID3D11Resource* pDstResource, UINT DstSubresource, const D3D11_BOX* pDstBox, const void* pSrcData, UINT SrcRowPitch, UINT SrcDepthPitch, UINT CopyFlags );
+		virtual void STDMETHODCALLTYPE DiscardResource( ID3D11Resource* pResource );
+		virtual void STDMETHODCALLTYPE DiscardView( ID3D11View* pResourceView );
+		virtual void STDMETHODCALLTYPE VSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+		virtual void STDMETHODCALLTYPE HSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+		virtual void STDMETHODCALLTYPE DSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+		virtual void STDMETHODCALLTYPE GSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+		virtual void STDMETHODCALLTYPE PSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+		virtual void STDMETHODCALLTYPE CSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants );
+		virtual void STDMETHODCALLTYPE VSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants );
+		virtual void STDMETHODCALLTYPE HSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants );
+		virtual void STDMETHODCALLTYPE DSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants );
+		virtual void STDMETHODCALLTYPE GSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants );
+		virtual void STDMETHODCALLTYPE PSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants );
+		virtual void STDMETHODCALLTYPE CSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants );
+		virtual void STDMETHODCALLTYPE SwapDeviceContextState( ID3DDeviceContextState* pState, ID3DDeviceContextState** ppPreviousState );
+		virtual void STDMETHODCALLTYPE ClearView( ID3D11View* pView, const FLOAT Color[4], const D3D11_RECT* pRect, UINT NumRects );
+		virtual void STDMETHODCALLTYPE DiscardView1( ID3D11View* pResourceView, const D3D11_RECT* pRects, UINT NumRects );
+
+	private:
+		struct StageState
+		{
+			void*						pShader;
+			ID3D11Buffer*				ConstantBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+			UINT						FirstConstants[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+			UINT						NumConstants[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];
+			ID3D11SamplerState*			Samplers[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
+			ID3D11ShaderResourceView*	ShaderResourceViews[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
+			ID3D11UnorderedAccessView*	UnorderedAccessViews[D3D11_PS_CS_UAV_REGISTER_COUNT];
+		};
+
+		void Record( RecordedCommandType type, unsigned int stage, unsigned int start, unsigned int count,
+			unsigned int arg0 = 0, unsigned int arg1 = 0 );
+
+		// Each of these records a bind, and compares the new values against
+		// the values that are already bound.
+		void SetShader( unsigned int stage, void* pShader );
+		void SetConstantBuffers( unsigned int stage, UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers,
+			const UINT* pFirstConstant, const UINT* pNumConstants );
+		void SetSamplers( unsigned int stage, UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers );
+		void SetShaderResources( unsigned int stage, UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppViews );
+		void SetUnorderedAccessViews( unsigned int stage, UINT StartSlot, UINT NumUAVs, ID3D11UnorderedAccessView* const* ppViews );
+		void SetState( RecordedCommandType type, void** ppBound, void* pState );
+
+		void CountBind( unsigned int slots, unsigned int redundant );
+
+		UINT GetMappedSize( ID3D11Resource* pResource, UINT& rowPitch, UINT& depthPitch );
+
+		ULONG										m_uiReferences;
+		ID3D11Device*								m_pDevice;
+
+		bool										m_bRecording;
+		std::vector<RecordedCommandDX11>			m_Commands;
+		RecordingStatisticsDX11						m_Statistics;
+
+		StageState									m_Stages[6];
+		void*										m_pInputLayout;
+		ID3D11Buffer*								m_VertexBuffers[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+		UINT										m_VertexStrides[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+		UINT										m_VertexOffsets[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+		ID3D11Buffer*								m_pIndexBuffer;
+		DXGI_FORMAT									m_IndexFormat;
+		UINT										m_uiIndexOffset;
+		D3D11_PRIMITIVE_TOPOLOGY					m_Topology;
+		void*										m_pRasterizerState;
+		void*										m_pBlendState;
+		void*										m_pDepthStencilState;
+		UINT										m_uiStencilRef;
+
+		// The memory that is handed out when a resource is mapped.
+		std::map<ID3D11Resource*, std::vector<unsigned char>>	m_MappedMemory;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // RecordingDeviceContextDX11_h
+//--------------------------------------------------------------------------------
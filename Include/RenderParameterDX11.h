@@ -41,6 +41,11 @@ namespace Glyph3
 		void SetName( const std::wstring& name );
 		std::wstring& GetName();
 
+		// Setting the name also interns it in the ParameterNameTable.  The ID is
+		// unique to the name, and is used to look up the parameter without any
+		// string comparisons.
+		unsigned int GetNameID();
+
 		// Each parameter type will implement this method for a simple way
 		// to tell what kind of data it uses.  This is important for handling
 		// the parameters in a generic way, but still being able to perform
@@ -82,6 +87,7 @@ namespace Glyph3
 
 	protected:
 		std::wstring	m_sParameterName;
+		unsigned int	m_uiNameID;
 		unsigned int	m_auiValueID[NUM_THREADS+1];
 	};
 };
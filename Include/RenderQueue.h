@@ -0,0 +1,158 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// RenderQueue
+//
+// Collects the entities that a scene render task will draw, and orders them by a
+// 64-bit sort key before submitting them.  The key is built so that sorting it
+// groups the draws by their pass, then by shader program, pipeline state and
+// material, and finally by depth:
+//
+//   opaque:  | pass:2 | program:14 | state:12 | material:12 | depth:24 |
+//   alpha:   | pass:2 | inverted depth:24 | program:14 | state:12 | material:12 |
+//
+// The passes are drawn in the order BACKGROUND, GEOMETRY, SKY and ALPHA.
+// Opaque draws within a program, state and material group are drawn front to
+// back, while alpha draws are drawn strictly back to front so that blending is
+// still correct.  The program, state and material fields are small identifiers
+// that are assigned in the order they are first seen while collecting.
+//
+// The keys are sorted with an LSD radix sort, which skips any byte that is the
+// same for every key.  GetStateChangeCount reports how many times the program,
+// state or material changes between consecutive draws in the current order, so
+// the effect of sorting can be measured without a device.
+//
+// When a frustum is given while collecting a node, the queue culls against it.
+// Nodes whose subtree bounds are outside of the frustum are skipped entirely,
+// nodes that are completely inside are collected without any further tests,
+// and the remaining entities are tested in batches with Frustum3f's SSE test.
+// Entities without any shapes can't be tested, and are always collected.
+//
+// Before drawing, the sorted draws are grouped into batches.  Within each run of
+// opaque draws that share their pass, program, state and material, the draws of
+// the same executor are moved next to each other.  Runs of two or more draws of
+// one executor become a single instanced draw when the material provides an
+// instanced effect for the view, the executor supports instancing, and the
+// entities have no parameters of their own.  Their world matrices are gathered
+// into one growable instance buffer per queue.  Alpha draws are only batched
+// with their direct neighbors, so they stay in back to front order.
+//--------------------------------------------------------------------------------
+#ifndef RenderQueue_h
+#define RenderQueue_h
+//--------------------------------------------------------------------------------
+#include "SceneRenderTask.h"
+#include "Matrix4f.h"
+#include "Sphere3f.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class Entity3D;
+	class Node3D;
+	struct Frustum3f;
+	class RenderEffectDX11;
+	class MaterialDX11;
+	class PipelineManagerDX11;
+	class IParameterManager;
+	class PipelineExecutorDX11;
+	template <class T> class TGrowableVertexBufferDX11;
+
+	class RenderQueue
+	{
+	public:
+		struct Batch
+		{
+			unsigned int	first;
+			unsigned int	count;
+			bool			bInstanced;
+		};
+
+		RenderQueue();
+		~RenderQueue();
+
+		void Clear();
+
+		// Adds an entity if it has something to draw in this view.  The depth of
+		// the entity is taken from its world position in view space.
+		void Add( Entity3D* pEntity, VIEWTYPE view, const Matrix4f& viewMatrix );
+		void Add( Node3D* pNode, VIEWTYPE view, const Matrix4f& viewMatrix, const Frustum3f* pFrustum = nullptr );
+
+		void Sort();
+		void Render( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view );
+
+		// Groups the sorted draws into batches, which may reorder the draws
+		// within a group.  Render does this itself, but it doesn't need a device
+		// so the grouping can also be inspected on its own.
+		void BuildBatches( VIEWTYPE view );
+		unsigned int GetBatchCount() const;
+		const Batch& GetBatch( unsigned int index ) const;
+
+		unsigned int GetCount() const;
+		Entity3D* GetEntity( unsigned int index ) const;
+		unsigned long long GetKey( unsigned int index ) const;
+		unsigned int GetStateChangeCount() const;
+		const CullStatistics& GetStatistics() const;
+
+		static unsigned long long MakeKey( int pass, unsigned int program, unsigned int state,
+			unsigned int material, float depth );
+
+	private:
+		struct Item
+		{
+			unsigned long long	key;
+			Entity3D*			pEntity;
+			unsigned int		program;
+			unsigned int		state;
+			unsigned int		material;
+		};
+
+		struct ProgramKey
+		{
+			int shaders[6];
+			bool operator<( const ProgramKey& other ) const;
+		};
+
+		struct StateKey
+		{
+			int blend;
+			int depthStencil;
+			int rasterizer;
+			bool operator<( const StateKey& other ) const;
+		};
+
+		unsigned int GetProgramID( RenderEffectDX11* pEffect );
+		unsigned int GetStateID( RenderEffectDX11* pEffect );
+		unsigned int GetMaterialID( MaterialDX11* pMaterial );
+
+		bool IsDrawable( Entity3D* pEntity, VIEWTYPE view ) const;
+		bool IsInstanceable( const Item& item, VIEWTYPE view );
+		bool IsSameGroup( const Item& a, const Item& b ) const;
+		void GroupByExecutor( unsigned int begin, unsigned int end );
+
+		std::vector<Item>						m_Items;
+		std::vector<Item>						m_Scratch;
+		std::vector<Batch>						m_Batches;
+		std::vector<unsigned int>				m_Ranks;
+		std::map<PipelineExecutorDX11*,unsigned int>	m_Executors;
+
+		TGrowableVertexBufferDX11<Matrix4f>*	m_pInstanceBuffer;
+
+		std::map<ProgramKey,unsigned int>		m_Programs;
+		std::map<StateKey,unsigned int>			m_States;
+		std::map<MaterialDX11*,unsigned int>	m_Materials;
+
+		CullStatistics							m_Statistics;
+		std::vector<Entity3D*>					m_Candidates;
+		std::vector<Sphere3f>					m_Spheres;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // RenderQueue_h
+//--------------------------------------------------------------------------------
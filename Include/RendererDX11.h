@@ -18,6 +18,7 @@
 #include "PCH.h"
 
 #include "TConfiguration.h"
+#include "TaskGraph.h"
 
 #include "Vector2f.h"
 #include "Vector3f.h"
@@ -102,11 +103,8 @@ namespace Glyph3
 	struct ThreadPayLoad
 	{
 		int id;
-		bool bComplete;
 		PipelineManagerDX11* pPipeline;
 		IParameterManager* pParamManager;
-		Task* pTask;
-		CommandListDX11* pList;
 	};
 
 
@@ -133,6 +131,13 @@ namespace Glyph3
 
 		UINT64 GetAvailableVideoMemory();
 
+		// The number of thread payloads that render tasks are recorded with,
+		// which is known once the renderer has been initialized.  The render
+		// parameters use one slot for each of them after the slot of the
+		// immediate pipeline.
+
+		unsigned int GetPayloadCount();
+
 		// Renderer initialization and shutdown methods.  These methods
 		// obtain and release all of the hardware specific resources that
 		// are used during rendering.
@@ -255,6 +260,13 @@ namespace Glyph3
 		void QueueTask( Task* pTask );
 		void ProcessTaskQueue( );
 
+		// Declares that a queued task has to be rendered after another one in the
+		// current frame.  Without any dependencies, the tasks are rendered in the
+		// reverse of the order they were queued in, so a view that queues the
+		// views it uses after itself doesn't need to declare them.
+
+		void QueueTaskDependency( Task* pTask, Task* pPrerequisite );
+
 		// This method is here for allowing easy integration with other libraries
 		// which require access to the device.  Do not use this interface to create 
 		// objects unless those objects are then registered with this renderer class!!!
@@ -355,19 +367,32 @@ namespace Glyph3
 
 		D3D_FEATURE_LEVEL			m_FeatureLevel;
 
+		// Counts the presented frames, which are used to retire the space of the
+		// constant buffer rings.  An event query is issued at the end of each
+		// frame, and the frames before m_CompletedFrames are known to be done
+		// on the GPU.  The queries are reused in turn, which limits the number
+		// of frames in flight.
+		unsigned long long			m_FrameIndex;
+		unsigned long long			m_CompletedFrames;
+		std::vector<QueryComPtr>	m_vFrameQueries;
+
 		std::vector<Task*>			m_vQueuedTasks;
+		std::vector<std::pair<Task*,Task*>>	m_vTaskDependencies;
+
+		// The queued tasks are recorded on the job system with one node per task,
+		// using one of the thread payloads for each running node.  Every node gets
+		// its own command list, which is played back in the order of the graph.
+		TaskGraph					m_TaskGraph;
+		std::vector<CommandListDX11*>	m_vCommandLists;
+		unsigned int				m_uiPayloads;
 
 		friend GeometryDX11;
 	};
 };
 
-unsigned int WINAPI _TaskThreadProc( void* lpParameter );
 
 // Multithreading support objects
-extern HANDLE						g_aThreadHandles[NUM_THREADS];
 extern Glyph3::ThreadPayLoad		g_aPayload[NUM_THREADS];
-extern HANDLE						g_aBeginEventHandle[NUM_THREADS];
-extern HANDLE						g_aEndEventHandle[NUM_THREADS];
 
 template <class T>
 void LogObjectVector( std::vector<T> objects );
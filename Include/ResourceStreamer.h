@@ -0,0 +1,149 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// ResourceStreamer
+//
+// Loads StreamRequests in the background, so that loading models and textures
+// doesn't stall the frames of the main thread.  The streamer has a fixed number
+// of I/O threads, which read the files, and decode threads, which do the CPU
+// work on the data that was read.  These are separate from the JobSystem, whose
+// workers shouldn't block on the disk or be occupied by a long parse while a
+// frame is waiting on them.  The threads are started by the first Submit, so
+// an application that never streams anything doesn't have them.  The decode
+// threads are in the multithreaded COM apartment for their whole lifetime, so a
+// decoder can use WIC directly.  An exception that escapes a stage fails its
+// request, and the thread carries on with the next one.
+//
+// Each stage takes the waiting request of the highest priority class first, and
+// the requests of a class in the order they were submitted.  A request is only
+// read once its memory cost fits into the memory budget along with the other
+// requests in flight, which bounds the memory that is held by the files that
+// have been read but not yet finalized.  A request that is larger than the
+// whole budget is read when nothing else is in flight.
+//
+// Update is called once per frame on the main thread.  It finalizes the decoded
+// requests until the finalize budget for the frame is used up, and measures the
+// time between frames while anything is streaming, so that the hitches caused by
+// streaming show up in the statistics.  The stages are also profiled as zones.
+//--------------------------------------------------------------------------------
+#ifndef ResourceStreamer_h
+#define ResourceStreamer_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "StreamRequest.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class ResourceStreamer
+	{
+	public:
+		struct Statistics
+		{
+			unsigned int		queued;
+			unsigned int		inFlight;
+			unsigned long long	bytesInFlight;
+
+			unsigned int		completed;
+			unsigned int		failed;
+			unsigned int		cancelled;
+
+			// The frames that ended while something was streaming, and how many of
+			// them took longer than the hitch threshold.  Times are in
+			// milliseconds.
+			unsigned int		streamingFrames;
+			unsigned int		hitchFrames;
+			float				averageFrameTime;
+			float				maximumFrameTime;
+
+			float				lastFinalizeTime;
+			float				maximumFinalizeTime;
+		};
+
+		ResourceStreamer( unsigned int uiReadThreads = 1, unsigned int uiDecodeThreads = 2 );
+		virtual ~ResourceStreamer();
+
+		// Returns false if the request was already submitted.
+		bool Submit( StreamRequestPtr pRequest, StreamPriority priority = STREAM_PRIORITY_NORMAL );
+
+		// Finalizes the decoded requests, for at most the finalize budget unless
+		// nothing has been finalized yet.  Call this once per frame on the main
+		// thread.
+		void Update( );
+
+		// Waits for all submitted requests to finish, finalizing them on the
+		// calling thread, which must be the main thread.
+		void Flush( );
+
+		// Cancels all submitted requests and waits for the stages that are in
+		// progress to stop.  This must be called before the renderer that the
+		// requests use is destroyed.
+		void CancelAll( );
+
+		void SetMemoryBudget( unsigned long long bytes );
+		unsigned long long GetMemoryBudget( ) const;
+
+		void SetFinalizeBudget( float milliseconds );
+		float GetFinalizeBudget( ) const;
+
+		void SetHitchThreshold( float milliseconds );
+		float GetHitchThreshold( ) const;
+
+		Statistics GetStatistics( ) const;
+		void ResetStatistics( );
+
+	protected:
+		typedef std::deque<StreamRequestPtr> RequestQueue;
+
+		void StartThreads( );
+		void ReadThread( );
+		void DecodeThread( );
+		bool RunStage( StreamRequest& request, bool ( StreamRequest::*pStage )( ) );
+
+		bool FinalizeOne( );
+		void Finish( const StreamRequestPtr& pRequest, StreamState state );
+		bool Pop( RequestQueue* pQueues, StreamRequestPtr& pRequest );
+		bool IsEmpty( const RequestQueue* pQueues ) const;
+
+		mutable std::mutex				m_Lock;
+		std::condition_variable			m_ReadWake;
+		std::condition_variable			m_DecodeWake;
+		std::condition_variable			m_Progress;
+		bool							m_bShutdown;
+		bool							m_bCancelling;
+
+		RequestQueue					m_ReadQueues[STREAM_PRIORITY_COUNT];
+		RequestQueue					m_DecodeQueues[STREAM_PRIORITY_COUNT];
+		RequestQueue					m_FinalizeQueues[STREAM_PRIORITY_COUNT];
+
+		unsigned int					m_uiQueued;
+		unsigned int					m_uiInFlight;
+		unsigned long long				m_ullBytesInFlight;
+		unsigned long long				m_ullMemoryBudget;
+
+		float							m_fFinalizeBudget;
+		float							m_fHitchThreshold;
+		unsigned long long				m_LastUpdate;
+		bool							m_bStreamingLastFrame;
+		double							m_dTotalFrameTime;
+		Statistics						m_Statistics;
+
+		unsigned int					m_uiReadThreads;
+		unsigned int					m_uiDecodeThreads;
+		std::vector<std::thread>		m_Threads;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // ResourceStreamer_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,80 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// RingAllocator
+//
+// Hands out aligned ranges of a fixed size block in a linear order, wrapping
+// back to the start of the block when the end is reached.  Every allocation
+// belongs to the frame that was current when it was made, and the space of a
+// frame is only reused once that frame has been retired.  This lets the GPU
+// keep reading the data of the frames it hasn't finished yet, while the CPU
+// writes the data of the current frame after it.
+//
+// When a range doesn't fit into the space left at the end of the block, the
+// remainder is skipped and counted towards the current frame, so that it is
+// returned together with the frame's own allocations.
+//
+// The allocator only manages offsets, so it doesn't depend on any API and can
+// be used for any kind of buffer.
+//--------------------------------------------------------------------------------
+#ifndef RingAllocator_h
+#define RingAllocator_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class RingAllocator
+	{
+	public:
+		RingAllocator( unsigned int capacity, unsigned int alignment );
+		~RingAllocator();
+
+		// Returns false if the range would overwrite a frame that hasn't been
+		// retired yet.  Sizes are rounded up to the alignment.
+		bool Allocate( unsigned int size, unsigned int& offset );
+
+		// Starts a new frame.  Frame indices must increase from frame to frame.
+		void BeginFrame( unsigned long long frame );
+
+		// Frees the space of every frame up to and including 'frame'.  The
+		// current frame is never retired, since it is still being written.
+		void RetireFrames( unsigned long long frame );
+
+		// Frees everything, including the current frame.
+		void Reset();
+
+		unsigned long long GetFrame() const;
+		unsigned int GetCapacity() const;
+		unsigned int GetAlignment() const;
+		unsigned int GetUsedSize() const;
+		unsigned int GetFramesInFlight() const;
+
+	private:
+		struct Frame
+		{
+			unsigned long long	index;
+			unsigned int		size;
+		};
+
+		unsigned int			m_uiCapacity;
+		unsigned int			m_uiAlignment;
+		unsigned int			m_uiHead;
+		unsigned int			m_uiUsed;
+
+		// The frames are ordered from the oldest to the current one, which is
+		// always the last entry.
+		std::vector<Frame>		m_Frames;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // RingAllocator_h
+//--------------------------------------------------------------------------------
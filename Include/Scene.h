@@ -21,6 +21,8 @@
 #include "Camera.h"
 #include "Light.h"
 #include "ParameterContainer.h"
+#include "TransformHierarchy.h"
+#include "BoundingVolumeHierarchy.h"
 //--------------------------------------------------------------------------------
 namespace Glyph3
 {
@@ -45,8 +47,19 @@ namespace Glyph3
 		void AddActor( Actor* actor );
 		void RemoveActor( Actor* actor );
 
-		// Geometric queries
+		// Allows the actors in the scene to be updated in parallel.  This should
+		// only be enabled if the controllers of each actor don't access any other
+		// actors.
+		void SetParallelUpdate( bool bParallel );
+
+		// Geometric queries.  These use the bounding volume hierarchy of the scene,
+		// which reflects the state of the entities as of the last call to Update.
+		// Entities that have been attached or detached since then are added to or
+		// removed from it first, so a detached entity is never returned.
 		void BuildPickRecord( Ray3f& ray, std::vector<PickRecord>& record );
+		void BuildPickRecords( const std::vector<Ray3f>& rays, std::vector< std::vector<PickRecord> >& records );
+		void GetIntersectingEntities( std::vector< Entity3D* >& set, Sphere3f& bounds );
+		void GetIntersectingEntities( std::vector< Entity3D* >& set, Frustum3f& bounds );
 
 		Node3D* GetRoot();
 
@@ -54,7 +67,11 @@ namespace Glyph3
 		ParameterContainer Parameters;
 
 	protected:
+		void SynchronizeBounds( );
+
 		Node3D* m_pRoot;
+		TransformHierarchy m_Hierarchy;
+		BoundingVolumeHierarchy m_Bounds;
 		std::vector< Camera* > m_vCameras;
 		std::vector< Light* > m_vLights;
 		std::vector< Actor* > m_vActors;
@@ -63,11 +63,12 @@ namespace Glyph3
 
 	void GetAllEntities( Node3D* node, std::vector< Entity3D* >& set );
 
-	// The pick record is the correct way to build a list of the entities that are 
-	// intersecting the ray.  The other two methods are just as valid, but perform
-	// a different type of query than the pick record.
+	// Adds a record for the entity if the ray hits one of its shapes.  Picking a
+	// whole scene is done with Scene::BuildPickRecord, which only tests the
+	// entities whose bounds are hit by the ray.  The other two methods perform a
+	// different type of query than the pick record.
 
-	void BuildPickRecord( Node3D* node, const Ray3f& ray, std::vector<PickRecord>& record );
+	void AddPickRecord( Entity3D* entity, const Ray3f& ray, std::vector<PickRecord>& record );
 	bool EntityInSubTree( Node3D* node, Entity3D* entity );
 	void GetIntersectingEntities( Node3D* node, std::vector< Entity3D* >& set, Sphere3f& bounds );
 	void GetIntersectingEntities( Node3D* node, std::vector< Entity3D* >& set, Frustum3f& bounds );
@@ -33,6 +33,7 @@ namespace Glyph3
 	class Entity3D;
 	class Scene;
 	class BoundsVisualizerActor;
+	class RenderQueue;
 
 	// The view type is used to allow a view to identify what type of
 	// view it is.  This identifier is also used by objects to specify
@@ -51,6 +52,18 @@ namespace Glyph3
 		VT_NUM_VIEW_TYPES
 	};    
 
+	// The visibility results of the last scene rendering of a task.  Entities
+	// are counted when they have geometry to draw, and the entities of a culled
+	// subtree are counted as culled without being visited.
+
+	struct CullStatistics
+	{
+		unsigned int drawn;
+		unsigned int culled;
+		unsigned int nodesCulled;
+		unsigned int spheresTested;
+	};
+
 	class SceneRenderTask : public Task
 	{
 	public:
@@ -104,12 +117,34 @@ namespace Glyph3
 		void SetDebugViewEnabled( bool debug );
 		bool IsDebugViewEnabled();
 
+		// Entities outside of the view frustum are skipped while the scene is
+		// rendered, together with any node whose bounds are completely outside.
+		// A cull distance greater than zero also skips entities that are
+		// farther than that from the camera.
+
+		void SetCullingEnabled( bool enable );
+		bool IsCullingEnabled();
+		void SetCullDistance( float distance );
+		float GetCullDistance();
+		const CullStatistics& GetCullStatistics();
+
+		// The queue keeps the draws of the last frame until the next one is
+		// collected, so they can be inspected after rendering.
+
+		const RenderQueue& GetRenderQueue();
+
 	protected:
 
+		// Draws the entities of the scene through the render queue, which sorts
+		// them to minimize the state changes between draws.
+
+		void RenderScene( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view );
+
 		Entity3D* m_pEntity;
 		Scene* m_pScene;
 
 		BoundsVisualizerActor* m_pDebugVisualizer;
+		RenderQueue* m_pRenderQueue;
 
 		Vector4f		m_BufferClearColor;
 		float			m_fDepthClearValue;
@@ -124,6 +159,8 @@ namespace Glyph3
 		Matrix4f ProjMatrix;
 
 		bool m_bDebugViewEnabled;
+		bool m_bCullingEnabled;
+		float m_fCullDistance;
 	};
 };
 //--------------------------------------------------------------------------------
@@ -47,6 +47,7 @@ namespace Glyph3
 		std::wstring							Function;
 		std::wstring							ShaderModel;
 		std::string								ShaderText;
+		bool									HasDefines;
 		ID3DBlob*								m_pCompiledShader;
 		ShaderReflectionDX11*					m_pReflection;
 	};
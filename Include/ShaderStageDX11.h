@@ -28,6 +28,10 @@ namespace Glyph3
 
 		void SetFeatureLevel( D3D_FEATURE_LEVEL level );
 
+		// Binds the constant buffers with their offsets and sizes through the
+		// given context.  Without it, constant buffers are always bound whole.
+		void EnableConstantBufferOffsets( ID3D11DeviceContext1* pContext );
+
 		void ClearDesiredState( );
 		void ClearCurrentState( );
 		void ApplyDesiredState( ID3D11DeviceContext* pContext );
@@ -55,6 +59,10 @@ namespace Glyph3
 
 		D3D_FEATURE_LEVEL			m_FeatureLevel;
 
+		// This is the same context that the pipeline manager uses, and it is
+		// owned by the pipeline manager.
+		ID3D11DeviceContext1*		m_pContext1;
+
 		// The current state of the API is used to allow for caching and elimination
 		// of redundant API calls.  This should make it possible to minimize the number
 		// of settings that need to be performed.
@@ -35,9 +35,18 @@ namespace Glyph3
 
 		void SetSisterState( ShaderStageStateDX11* pState );
 		void ResetUpdateFlags( );
+		void CommitToSister( );
+
+		// Finds the next range of constant buffer slots whose buffer, offset or
+		// size has changed.  Buffers sub-allocated from a ring share the same
+		// buffer object, so the buffer alone doesn't show every change.
+		bool GetNextConstantBufferRange( unsigned int& start, unsigned int& count ) const;
+		bool IsConstantBufferUpdateNeeded( ) const;
 
 		TStateMonitor< int > ShaderProgram;
 		TStateArrayMonitor< ID3D11Buffer*, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT >  ConstantBuffers;
+		TStateArrayMonitor< UINT, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT >  ConstantBufferOffsets;
+		TStateArrayMonitor< UINT, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT >  ConstantBufferSizes;
 		TStateArrayMonitor< ID3D11SamplerState*, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT > SamplerStates;
 		TStateArrayMonitor< ID3D11ShaderResourceView*, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT > ShaderResourceViews;
 		TStateArrayMonitor< ID3D11UnorderedAccessView*, D3D11_PS_CS_UAV_REGISTER_COUNT > UnorderedAccessViews;
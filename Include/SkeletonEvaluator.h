@@ -0,0 +1,108 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// SkeletonEvaluator
+//
+// Computes the skinning matrix palette of a skeleton in one batch.  The local
+// pose of each bone is stored as separate arrays of positions, Euler rotations
+// and scales, so that the local matrices of four bones are built at once with
+// SSE.  The global poses are then accumulated in a single pass over the bones
+// in parent order, and finally multiplied with the inverse bind poses.
+//
+// The local matrices follow Transform3D, with the rotation built in the same
+// order as Matrix3f::Rotation, so the results match those of the equivalent
+// node hierarchy.
+//
+// The normal matrices are the inverse transpose of the skinning matrices.  They
+// are computed with the inverse of an affine matrix, which is all that a bone
+// transform can be, rather than with the general 4x4 inverse.
+//
+// The static skinning functions apply a matrix palette to vertices on the CPU,
+// for things like picking and bounds, with up to four influences per vertex.
+//--------------------------------------------------------------------------------
+#ifndef SkeletonEvaluator_h
+#define SkeletonEvaluator_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "Matrix4f.h"
+#include "Vector3f.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class SkeletonEvaluator
+	{
+	public:
+		SkeletonEvaluator();
+		~SkeletonEvaluator();
+
+		// Sets up the skeleton with the parent of each bone, where -1 marks a bone
+		// that is attached to the root.  The bones may be listed in any order,
+		// but returns false if the parents don't form a hierarchy.
+		bool SetParents( const std::vector<int>& parents );
+		unsigned int GetBoneCount( ) const;
+
+		void SetLocalPose( unsigned int bone, const Vector3f& position, const Vector3f& rotation,
+							const Vector3f& scale );
+		void SetInverseBindPose( unsigned int bone, const Matrix4f& inverse );
+
+		// Computes the global pose of every bone, with the given matrix as the
+		// parent of the root bones, and writes the skinning matrices and their
+		// normal matrices in bone order.  The normal matrices are optional.
+		void Evaluate( const Matrix4f& root, Matrix4f* pSkinMatrices, Matrix4f* pNormalMatrices );
+
+		const Matrix4f& GetGlobalPose( unsigned int bone ) const;
+
+		// Blends the points or directions with the given number of influences per
+		// vertex.  The bone indices and the weights are stored with 'influences'
+		// entries per vertex, and the weights may be nullptr when there is only
+		// one influence.  Indices outside of the palette are ignored.  Skinned
+		// directions are not renormalized.
+		static void SkinPoints( const Matrix4f* pPalette, unsigned int paletteSize,
+								const Vector3f* pIn, const unsigned int* pBones, const float* pWeights,
+								unsigned int influences, Vector3f* pOut, unsigned int count );
+		static void SkinDirections( const Matrix4f* pPalette, unsigned int paletteSize,
+								const Vector3f* pIn, const unsigned int* pBones, const float* pWeights,
+								unsigned int influences, Vector3f* pOut, unsigned int count );
+
+		// Finds the bounds of the skinned points without storing them.  Returns
+		// false when there are no points.
+		static bool SkinBounds( const Matrix4f* pPalette, unsigned int paletteSize,
+								const Vector3f* pIn, const unsigned int* pBones, const float* pWeights,
+								unsigned int influences, unsigned int count, Vector3f& mins, Vector3f& maxs );
+
+	protected:
+		void BuildLocalPoses( );
+
+		unsigned int					m_uiBoneCount;
+
+		// The local pose arrays are padded to a multiple of four bones, and the
+		// padding holds the identity pose.
+		std::vector<float>				m_PositionX;
+		std::vector<float>				m_PositionY;
+		std::vector<float>				m_PositionZ;
+		std::vector<float>				m_RotationX;
+		std::vector<float>				m_RotationY;
+		std::vector<float>				m_RotationZ;
+		std::vector<float>				m_ScaleX;
+		std::vector<float>				m_ScaleY;
+		std::vector<float>				m_ScaleZ;
+
+		std::vector<int>				m_Parents;
+		std::vector<unsigned int>		m_Order;
+
+		std::vector<Matrix4f>			m_InverseBindPoses;
+		std::vector<Matrix4f>			m_LocalPoses;
+		std::vector<Matrix4f>			m_GlobalPoses;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // SkeletonEvaluator_h
+//--------------------------------------------------------------------------------
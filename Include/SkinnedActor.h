@@ -11,6 +11,14 @@
 //--------------------------------------------------------------------------------
 // SkinnedActor
 //
+// The skinning matrices are computed with a SkeletonEvaluator from the animated
+// local pose of each bone controller, rather than from the world matrices of the
+// bone nodes.  This requires the root bones to share a single parent node, which
+// is the case for the skeletons built by the geometry loaders.  Otherwise each
+// bone's transform is read from its controller as before.
+//
+// The static SetSkinningMatrices spreads the work for many actors over the
+// JobSystem.
 //--------------------------------------------------------------------------------
 #ifndef SkinnedActor_h
 #define SkinnedActor_h
@@ -19,6 +27,7 @@
 #include "SkinnedBoneController.h"
 #include "AnimationStream.h"
 #include "MatrixArrayParameterWriterDX11.h"
+#include "SkeletonEvaluator.h"
 //--------------------------------------------------------------------------------
 namespace Glyph3
 {
@@ -37,18 +46,28 @@ namespace Glyph3
 						AnimationStream<Vector3f>* pRotations = 0 ); 
 		void SetBindPose( );
 		void SetSkinningMatrices( RendererDX11& Renderer );
+		static void SetSkinningMatrices( const std::vector<SkinnedActor*>& actors );
 		void PlayAnimation( int index );
 		void PlayAnimation( std::wstring& name );
 		void PlayAllAnimations( );
 
 		Entity3D* GetGeometryEntity();
 
+		// Skins the body's geometry with the current skinning matrices on the CPU,
+		// and returns the bounds of the skinned positions.
+		bool GetSkinnedBounds( Vector3f& mins, Vector3f& maxs );
+
 	protected:
+		void UpdateSkinningMatrices( );
+
 		std::vector<SkinnedBoneController<Node3D>*>		m_Bones;
 		Matrix4f*										m_pMatrices;
 		Matrix4f*										m_pNormalMatrices;
 		Entity3D*										m_pGeometryEntity;
 
+		SkeletonEvaluator								m_Skeleton;
+		Node3D*											m_pSkeletonRoot;
+
 		MatrixArrayParameterWriterDX11*					m_pSkinMatrixWriter;
 		MatrixArrayParameterWriterDX11*					m_pNormalMatrixWriter;
 	};
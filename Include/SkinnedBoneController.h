@@ -42,6 +42,12 @@ namespace Glyph3
 		void SetBindRotation( Vector3f rotation );
 		Vector3f GetBindPosition( );
 		Vector3f GetBindRotation( );
+
+		// The animated local position and rotation that were last applied to the
+		// entity, and the inverse of the entity's world matrix in the bind pose.
+		const Vector3f& GetPosition( ) const;
+		const Vector3f& GetRotation( ) const;
+		const Matrix4f& GetInverseBindPose( ) const;
 		
 		void SetLocalSkeleton( );
 		void SetGlobalSkeleton( );
@@ -59,6 +65,8 @@ namespace Glyph3
 		AnimationStream<Vector3f>*	m_pRotationStream;
 		Vector3f					m_kBindPosition;
 		Vector3f					m_kBindRotation;
+		Vector3f					m_kPosition;
+		Vector3f					m_kRotation;
 		bool						m_bActivate;
 	};
 
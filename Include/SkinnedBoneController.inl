@@ -14,6 +14,8 @@ SkinnedBoneController<T>::SkinnedBoneController()
 {
 	m_kBindPosition.MakeZero();
 	m_kBindRotation.MakeZero();
+	m_kPosition.MakeZero();
+	m_kRotation.MakeZero();
 	m_pPositionStream = 0;
 	m_pRotationStream = 0;
 
@@ -51,7 +53,8 @@ void SkinnedBoneController<T>::Update( float fTime )
 		m_pPositionStream->Update( fTime );
 
 		// Update the entity's position, which is the bind pose plus the current animated position.
-		m_pEntity->Transform.Position() = m_kBindPosition + m_pPositionStream->GetState();
+		m_kPosition = m_kBindPosition + m_pPositionStream->GetState();
+		m_pEntity->Transform.Position() = m_kPosition;
 	}
 
 	if ( m_pRotationStream )
@@ -60,7 +63,8 @@ void SkinnedBoneController<T>::Update( float fTime )
 		m_pRotationStream->Update( fTime );
 
 		// Update the entity's rotation, which is the bind pose plus the current animated rotation.
-		m_pEntity->Transform.Rotation().Rotation( m_kBindRotation + m_pRotationStream->GetState() );
+		m_kRotation = m_kBindRotation + m_pRotationStream->GetState();
+		m_pEntity->Transform.Rotation().Rotation( m_kRotation );
 	}
 }
 //--------------------------------------------------------------------------------
@@ -149,12 +153,14 @@ template <typename T>
 void SkinnedBoneController<T>::SetBindPosition( Vector3f position )
 {
 	m_kBindPosition = position;
+	m_kPosition = position;
 }
 //--------------------------------------------------------------------------------
 template <typename T>
 void SkinnedBoneController<T>::SetBindRotation( Vector3f rotation )
 {
 	m_kBindRotation = rotation;
+	m_kRotation = rotation;
 }
 //--------------------------------------------------------------------------------
 template <typename T>
@@ -170,6 +176,24 @@ Vector3f SkinnedBoneController<T>::GetBindRotation( )
 }
 //--------------------------------------------------------------------------------
 template <typename T>
+const Vector3f& SkinnedBoneController<T>::GetPosition( ) const
+{
+	return( m_kPosition );
+}
+//--------------------------------------------------------------------------------
+template <typename T>
+const Vector3f& SkinnedBoneController<T>::GetRotation( ) const
+{
+	return( m_kRotation );
+}
+//--------------------------------------------------------------------------------
+template <typename T>
+const Matrix4f& SkinnedBoneController<T>::GetInverseBindPose( ) const
+{
+	return( m_InvBindPose );
+}
+//--------------------------------------------------------------------------------
+template <typename T>
 void SkinnedBoneController<T>::SetParentBone( SkinnedBoneController* pParent )
 {
 	this->m_pParentBone = pParent;
@@ -30,6 +30,9 @@ namespace Glyph3
 		bool Intersects( const Sphere3f& test ) const;
 		bool Envelops( const Sphere3f& test ) const;
 
+		// Grows the sphere to the smallest sphere enclosing both spheres.
+		void Merge( const Sphere3f& other );
+
 		void SamplePosition( Vector3f& position, float theta, float phi ) const;
 		void SampleNormal( Vector3f& normal, float theta, float phi ) const;
 		void SamplePositionAndNormal( Vector3f& position, Vector3f& normal, float theta, float phi ) const;
@@ -0,0 +1,114 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// StlImporterDX11
+//
+// Loads a binary or ASCII STL file straight into an indexed GeometryDX11 with
+// positions and normals.  MeshSTL keeps the three corners of every facet for
+// the application to interpret, which is fine for small parts, but scanned and
+// CAD models easily have tens of millions of facets.
+//
+// The file is memory mapped, and the corners are welded while the facets are
+// read, so only the unique positions and three indices per triangle are kept.
+// Positions are welded through a hash of a grid with cells of twice the
+// tolerance, which puts every position within the tolerance of a corner in one
+// of the eight cells closest to it.  ASCII files are parsed in parallel on the
+// JobSystem a few chunks at a time, and the facets are still welded in file
+// order, so the result doesn't depend on the number of threads.  Triangles
+// that lose an edge to the welding are dropped.
+//
+// The normals are either the facet normals of the file, or are generated from
+// the area weighted normals of the faces around each position, leaving out the
+// faces that meet the corner's face at more than the crease angle.  Either way,
+// a position gets one vertex for each distinct normal that its corners use.
+//--------------------------------------------------------------------------------
+#ifndef StlImporterDX11_h
+#define StlImporterDX11_h
+//--------------------------------------------------------------------------------
+#include "GeometryDX11.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class StlImporterDX11
+	{
+	public:
+		// The filename is a full path.  Positions that are within the tolerance of
+		// each other on every axis are welded, and a tolerance of zero only welds
+		// identical positions.  Unless smoothNormals is set, each facet keeps the
+		// normal from the file.  Otherwise the normals are generated, and faces
+		// that meet at more than the crease angle, in radians, keep a sharp edge.
+		// Returns nullptr if the file can't be opened, contains invalid data, or
+		// has no triangles.
+		static GeometryPtr Load( const std::wstring& filename, float tolerance = 0.0f,
+								bool smoothNormals = false, float creaseAngle = GLYPH_PI / 6.0f );
+
+		// Loads the contents of a file that is already in memory, such as one that
+		// was read by a stream request.  The name is only used in log messages.
+		static GeometryPtr LoadFromMemory( const char* pData, size_t size, const std::wstring& name,
+								float tolerance = 0.0f, bool smoothNormals = false, float creaseAngle = GLYPH_PI / 6.0f );
+
+	private:
+		StlImporterDX11();
+
+		// The facet layout of binary files: the normal followed by the corners.
+		struct Facet
+		{
+			float			values[12];
+		};
+
+		// A part of an ASCII file that starts at a facet and ends with one.
+		struct Chunk
+		{
+			const char*				pBegin;
+			const char*				pEnd;
+			bool					error;
+			std::vector<Facet>		facets;
+		};
+
+		// Each used slot of the weld table holds the latest position that was
+		// added to a cell, along with the hash of the cell.  The other positions
+		// of the cell are linked from it through 'next'.
+		struct Slot
+		{
+			UINT			position;
+			unsigned int	hash;
+		};
+
+		struct Mesh
+		{
+			float						tolerance;
+			double						cellScale;
+			bool						smoothNormals;
+
+			std::vector<float>			positions;
+			std::vector<UINT>			next;
+			std::vector<Slot>			slots;
+			unsigned int				usedSlots;
+
+			// Three positions for each triangle, and the face normal, which is
+			// normalized unless it is generated.
+			std::vector<UINT>			triangles;
+			std::vector<float>			normals;
+		};
+
+		static bool AddFacet( Mesh& mesh, const Facet& facet );
+		static UINT WeldPosition( Mesh& mesh, const float* pPosition );
+		static unsigned int FindSlot( const Mesh& mesh, const long long* pCell, unsigned int hash );
+		static void CellOf( const Mesh& mesh, const float* pPosition, long long* pCell );
+		static void GrowSlots( Mesh& mesh );
+
+		static void ParseChunk( Chunk& chunk );
+		static GeometryPtr BuildGeometry( Mesh& mesh, float creaseAngle );
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // StlImporterDX11_h
+//--------------------------------------------------------------------------------
@@ -0,0 +1,121 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// StreamRequest
+//
+// The base class of the resources that are loaded by the ResourceStreamer.  A
+// request goes through three stages, each of which is a virtual function:
+//
+//   Read     - runs on an I/O thread and loads the file into memory.
+//   Decode   - runs on a decode thread and does the CPU work of turning the
+//              file contents into the resource, such as parsing a model.
+//   Finalize - runs on the main thread during ResourceStreamer::Update, for the
+//              parts that have to go through the renderer.
+//
+// The default Read loads the whole file into m_Data.  A subclass that reads a
+// different file, such as a cache of the resource, picks it when its memory
+// cost is estimated and loads it with LoadFile.  Subclasses implement
+// Decode and Finalize, and keep the results in their own members.  Nothing in
+// this class depends on the device, so the CPU stages of a request can be run
+// and tested without a renderer by leaving Finalize trivial.
+//
+// The application keeps a shared pointer to the request as its handle, and
+// polls GetState or waits with ResourceStreamer::Flush.  Cancel may be called
+// from any thread.  A cancelled request stops at the next stage boundary, and
+// never reaches Finalize.
+//--------------------------------------------------------------------------------
+#ifndef StreamRequest_h
+#define StreamRequest_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include <atomic>
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	enum StreamPriority
+	{
+		STREAM_PRIORITY_HIGH = 0,
+		STREAM_PRIORITY_NORMAL,
+		STREAM_PRIORITY_LOW,
+		STREAM_PRIORITY_COUNT
+	};
+
+	enum StreamState
+	{
+		STREAM_IDLE = 0,
+		STREAM_QUEUED,
+		STREAM_READING,
+		STREAM_DECODING,
+		STREAM_FINALIZING,
+		STREAM_COMPLETE,
+		STREAM_FAILED,
+		STREAM_CANCELLED
+	};
+
+	class StreamRequest
+	{
+	public:
+		// The filename is a full path.
+		StreamRequest( const std::wstring& filename );
+		virtual ~StreamRequest();
+
+		const std::wstring& GetFilename( ) const;
+		StreamPriority GetPriority( ) const;
+		StreamState GetState( ) const;
+
+		// Returns true once the request is complete, has failed or was cancelled.
+		bool IsDone( ) const;
+
+		void Cancel( );
+		bool IsCancelled( ) const;
+
+		// The number of bytes that the request holds while it is in flight, which
+		// is counted against the memory budget of the streamer.
+		unsigned long long GetMemoryCost( ) const;
+
+	protected:
+		// Runs on an I/O thread before the request is read.  The default returns
+		// the size of the file.
+		virtual unsigned long long EstimateMemoryCost( );
+
+		virtual bool Read( );
+		virtual bool Decode( ) = 0;
+		virtual bool Finalize( ) = 0;
+
+		// Load a whole file into m_Data, and return the size of a file or zero
+		// if it can't be opened.
+		bool LoadFile( const std::wstring& filename );
+		static unsigned long long GetFileLength( const std::wstring& filename );
+
+		std::wstring				m_Filename;
+		std::vector<char>			m_Data;
+
+	private:
+		StreamRequest( const StreamRequest& );
+		StreamRequest& operator=( const StreamRequest& );
+
+		// These are only changed by the streamer, under its lock.
+		StreamPriority				m_Priority;
+		unsigned long long			m_ullMemoryCost;
+		bool						m_bCostKnown;
+		bool						m_bCharged;
+
+		std::atomic<int>			m_State;
+		std::atomic<bool>			m_bCancelled;
+
+		friend class ResourceStreamer;
+	};
+
+	typedef std::shared_ptr<StreamRequest> StreamRequestPtr;
+};
+//--------------------------------------------------------------------------------
+#endif // StreamRequest_h
+//--------------------------------------------------------------------------------
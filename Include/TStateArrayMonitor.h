@@ -11,6 +11,16 @@
 //--------------------------------------------------------------------------------
 // TStateArrayMonitor
 //
+// Monitors an array of pipeline states against a sister array, which holds the
+// states currently bound to the pipeline.  Each slot that differs from its
+// sister is marked in a bitmask, so the slots that need to be bound can be found
+// without comparing the whole array.  After binding, CommitToSister copies only
+// the marked slots into the sister and clears the marks.
+//
+// The marked slots can either be bound as a single range from the start slot to
+// the end slot, or as a set of smaller ranges with GetNextRange.  Ranges that are
+// separated by only a few unchanged slots are merged, since rebinding a few
+// slots costs less than an additional API call.
 //--------------------------------------------------------------------------------
 #ifndef TStateArrayMonitor_h
 #define TStateArrayMonitor_h
@@ -31,27 +41,36 @@ namespace Glyph3
 		
 		void SetState( unsigned int slot, T state );
 	
-		bool IsUpdateNeeded();
+		bool IsUpdateNeeded() const;
+		bool IsSlotUpdateNeeded( unsigned int slot ) const;
 		unsigned int GetStartSlot();
 		unsigned int GetEndSlot();
 		unsigned int GetRange();
 
+		// Finds the next range of slots to bind, starting the search at 'start'.
+		// Returns false when there are no more slots to bind.
+		bool GetNextRange( unsigned int& start, unsigned int& count ) const;
+
 		T GetState( unsigned int slot ) const;
 		T* GetFirstSlotLocation();
 		T* GetSlotLocation( unsigned int slot );
 
 		void InitializeStates();
 		void ResetTracking();
+		void CommitToSister();
+
+		// Ranges separated by at most this many unchanged slots are merged.
+		static const unsigned int MergeDistance = 4;
 
 	private:
 
-		void SearchFromBelow();
-		void SearchFromAbove();
+		static const unsigned int WordCount = ( N + 31 ) / 32;
+
+		// Returns the first marked slot at or above 'slot', or N if there is none.
+		unsigned int FindMarkedSlot( unsigned int slot ) const;
 
-		// The monitoring varaibles
-		unsigned int m_uiStartSlot;
-		unsigned int m_uiEndSlot;
-		bool m_bUploadNeeded;
+		// The monitoring variables, with one bit per slot.
+		unsigned int m_uiMarkedSlots[WordCount];
 
 		// The state data
 		T m_InitialState;
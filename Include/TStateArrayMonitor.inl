@@ -11,12 +11,12 @@
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
 TStateArrayMonitor<T,N>::TStateArrayMonitor( T initialState ) : 
-	m_uiStartSlot( 0 ),
-	m_uiEndSlot( 0 ),
-	m_bUploadNeeded( false ),
 	m_InitialState( initialState ),
 	m_pSister( nullptr )
 {
+	// The marks are cleared before the states are first set, since setting them
+	// without a sister marks every slot.
+	ResetTracking();
 	InitializeStates();
 	ResetTracking();
 }
@@ -39,175 +39,139 @@ void TStateArrayMonitor<T,N>::SetState( unsigned int slot, T state )
 
 	m_States[slot] = state;
 
-	// Ensure that a sister state has been set, and if so then use it to manage
-	// which slots need to be set in the next update to the pipeline.
-
 	// If there is no sister state, then we default to always requiring an upload
 	// of the entire array.
 
 	if ( m_pSister == nullptr )
 	{
-		m_bUploadNeeded = true;
-		m_uiStartSlot = 0;
-		m_uiEndSlot = N-1;
+		for ( unsigned int i = 0; i < N; i++ )
+			m_uiMarkedSlots[i >> 5] |= 1u << ( i & 31 );
 
 		return;
 	}
 
-	// Our actions will depend on if this new state matches the sister state or not.
-
-	bool bSameAsSister = SameAsSister( slot );
-
-
-	// Begin by checking if any states changes are already pending.  If not, then if
-	// the current state change differs from the sister state, then we have a new 
-	// start and end slot.
-
-	if ( !m_bUploadNeeded && !bSameAsSister )
-	{
-		m_bUploadNeeded = true;
-		m_uiStartSlot = slot;
-		m_uiEndSlot = slot;
-	}
+	// Otherwise the slot only needs to be bound when it differs from the sister,
+	// which is checked again on every change so that setting a slot back to its
+	// current value removes it from the update.
 
+	const unsigned int bit = 1u << ( slot & 31 );
 
-	// If there is already an upload needed, then we need to update the status of
-	// our list.
+	if ( SameAsSister( slot ) )
+		m_uiMarkedSlots[slot >> 5] &= ~bit;
+	else
+		m_uiMarkedSlots[slot >> 5] |= bit;
+}
+//--------------------------------------------------------------------------------
+template <class T, unsigned int N>
+bool TStateArrayMonitor<T,N>::SameAsSister( unsigned int slot )
+{
+	assert( slot < N );
 
-	if ( m_bUploadNeeded )
-	{
-		// Updating slot below the current range
-		if ( slot < m_uiStartSlot )
-		{
-			// If the slot is lower than our current start slot, then if the state is
-			// different we should consider this the new start state.
-			if ( !bSameAsSister ) {
-				m_uiStartSlot = slot;
-			}
-		}
-		// Updating slot at the lower end point
-		else if ( slot == m_uiStartSlot )
-		{
-			// If the states don't match, then we retain the same starting slot.
-			// Otherwise, we search toward the end state and see if we can reduce
-			// the range of the states that need to be set.
-			if ( bSameAsSister ) {
-				SearchFromBelow();
-			}
-		}
-		// Updating slot inside the current range
-		else if ( m_uiStartSlot < slot && slot < m_uiEndSlot ) 
-		{
-			// If the change is between our two endpoints, it doesn't matter.  
-			// Regardless of if they are the same or not, we still have to bind
-			// the same number of states anyways.
-		}
-		// Updating slot at the upper end point
-		else if ( slot == m_uiEndSlot )
-		{
-			// If the states don't match, then we retain the same ending slot.
-			// Otherwise, we search toward the start slot and see if we can reduce
-			// the range of the states that need to be set.
-			if ( bSameAsSister ) {
-				SearchFromAbove();
-			}
-		}
-		// Updating slot above the current range
-		else if ( m_uiEndSlot < slot )
-		{
-			// If the slot is lower than our current start slot, then if the state is
-			// different we should consider this the new start state.
-			if ( !bSameAsSister ) {
-				m_uiEndSlot = slot;
-			}
-		}
-	}
+	return( m_States[slot] == m_pSister->m_States[slot] );
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
-void TStateArrayMonitor<T,N>::SearchFromBelow()
+unsigned int TStateArrayMonitor<T,N>::FindMarkedSlot( unsigned int slot ) const
 {
-	// Here we start from the current start slot location, and iterate upward
-	// until we encounter the end slot.  As soon as we find a difference, we
-	// terminate the iteration, which will automatically make the start slot update
-	// to the appropriate location.
-	//
-	// Note that the iteration will not allow the StartSlot and EndSlot to go past
-	// eachother.  Instead, they can end at the same location, and then the final
-	// check is made after the loop to see if that last slot is the same or not.
+	// Whole words without any marks are skipped at once.
 
-	for ( ; m_uiStartSlot < m_uiEndSlot; m_uiStartSlot++ )
+	while ( slot < N )
 	{
-		if ( !SameAsSister( m_uiStartSlot ) )
-			break;
-	}
+		const unsigned int bits = m_uiMarkedSlots[slot >> 5] >> ( slot & 31 );
 
-	// If no differences have been found, we compare the last available slot.  If
-	// they are the same, we update the status to reflect that.  This means 
-	// resetting the update flag and the slot markers.
-	
-	if ( m_uiStartSlot == m_uiEndSlot && SameAsSister( m_uiStartSlot ) ) {
-		ResetTracking();
+		if ( bits == 0 ) {
+			slot = ( slot | 31 ) + 1;
+			continue;
+		}
+
+		unsigned int offset = 0;
+		while ( ( ( bits >> offset ) & 1 ) == 0 )
+			offset++;
+
+		return( slot + offset );
 	}
+
+	return( N );
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
-void TStateArrayMonitor<T,N>::SearchFromAbove()
+bool TStateArrayMonitor<T,N>::IsUpdateNeeded() const
 {
-	// Here we start from the current end slot location, and iterate downward
-	// until we encounter the start slot.  As soon as we find a difference, we
-	// terminate the iteration, which will automatically make the end slot update
-	// to the appropriate location.
-	//
-	// Note that the iteration will not allow the StartSlot and EndSlot to go past
-	// eachother.  Instead, they can end at the same location, and then the final
-	// check is made after the loop to see if that last slot is the same or not.
-
-	for ( ; m_uiEndSlot > m_uiStartSlot; m_uiEndSlot-- )
+	for ( unsigned int i = 0; i < WordCount; i++ )
 	{
-		if ( !SameAsSister( m_uiEndSlot ) )
-			break;
+		if ( m_uiMarkedSlots[i] != 0 )
+			return( true );
 	}
 
-	// If no differences have been found, we compare the last available slot.  If
-	// they are the same, we update the status to reflect that.  This means 
-	// resetting the update flag and the slot markers.
-	
-	if ( m_uiStartSlot == m_uiEndSlot && SameAsSister( m_uiEndSlot ) ) {
-		ResetTracking();
-	}
+	return( false );
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
-bool TStateArrayMonitor<T,N>::SameAsSister( unsigned int slot )
+bool TStateArrayMonitor<T,N>::IsSlotUpdateNeeded( unsigned int slot ) const
 {
 	assert( slot < N );
 
-	return( m_States[slot] == m_pSister->m_States[slot] );
+	return( ( ( m_uiMarkedSlots[slot >> 5] >> ( slot & 31 ) ) & 1 ) != 0 );
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
-bool TStateArrayMonitor<T,N>::IsUpdateNeeded()
+unsigned int TStateArrayMonitor<T,N>::GetStartSlot()
 {
-	return( m_bUploadNeeded );
+	const unsigned int slot = FindMarkedSlot( 0 );
+
+	return( slot < N ? slot : 0 );
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
-unsigned int TStateArrayMonitor<T,N>::GetStartSlot()
+unsigned int TStateArrayMonitor<T,N>::GetEndSlot()
 {
-	return( m_uiStartSlot );
+	for ( unsigned int i = WordCount; i-- > 0; )
+	{
+		const unsigned int bits = m_uiMarkedSlots[i];
+
+		if ( bits == 0 )
+			continue;
+
+		unsigned int offset = 31;
+		while ( ( ( bits >> offset ) & 1 ) == 0 )
+			offset--;
+
+		return( i * 32 + offset );
+	}
+
+	return( 0 );
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
-unsigned int TStateArrayMonitor<T,N>::GetEndSlot()
+unsigned int TStateArrayMonitor<T,N>::GetRange()
 {
-	return( m_uiEndSlot );
+	return( GetEndSlot() - GetStartSlot() + 1 );
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
-unsigned int TStateArrayMonitor<T,N>::GetRange()
+bool TStateArrayMonitor<T,N>::GetNextRange( unsigned int& start, unsigned int& count ) const
 {
-	return( m_uiEndSlot - m_uiStartSlot + 1 );
+	const unsigned int first = FindMarkedSlot( start );
+
+	if ( first >= N )
+		return( false );
+
+	// Extend the range over each following marked slot, as long as the gap of
+	// unchanged slots in between is small enough.
+
+	unsigned int last = first;
+	unsigned int next = FindMarkedSlot( first + 1 );
+
+	while ( next < N && next - last - 1 <= MergeDistance )
+	{
+		last = next;
+		next = FindMarkedSlot( next + 1 );
+	}
+
+	start = first;
+	count = last - first + 1;
+
+	return( true );
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
@@ -220,9 +184,23 @@ void TStateArrayMonitor<T,N>::InitializeStates()
 template <class T, unsigned int N>
 void TStateArrayMonitor<T,N>::ResetTracking()
 {
-	m_uiStartSlot = 0;
-	m_uiEndSlot = 0;
-	m_bUploadNeeded = false;
+	for ( unsigned int i = 0; i < WordCount; i++ )
+		m_uiMarkedSlots[i] = 0;
+}
+//--------------------------------------------------------------------------------
+template <class T, unsigned int N>
+void TStateArrayMonitor<T,N>::CommitToSister()
+{
+	// Once the marked slots have been bound, the sister only needs those slots
+	// to be copied to match this state again.
+
+	if ( m_pSister != nullptr )
+	{
+		for ( unsigned int slot = FindMarkedSlot( 0 ); slot < N; slot = FindMarkedSlot( slot + 1 ) )
+			m_pSister->m_States[slot] = m_States[slot];
+	}
+
+	ResetTracking();
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
@@ -236,7 +214,7 @@ T TStateArrayMonitor<T,N>::GetState( unsigned int slot ) const
 template <class T, unsigned int N>
 T* TStateArrayMonitor<T,N>::GetFirstSlotLocation()
 {
-	return( &m_States[m_uiStartSlot] );
+	return( &m_States[GetStartSlot()] );
 }
 //--------------------------------------------------------------------------------
 template <class T, unsigned int N>
@@ -35,6 +35,7 @@ namespace Glyph3
 		bool IsUpdateNeeded();
 		void InitializeState();
 		void ResetTracking();
+		void CommitToSister();
 
 	private:
 
@@ -82,6 +82,15 @@ void TStateMonitor<T>::ResetTracking()
 }
 //--------------------------------------------------------------------------------
 template <class T>
+void TStateMonitor<T>::CommitToSister()
+{
+	if ( m_bUploadNeeded && m_pSister != nullptr )
+		m_pSister->m_State = m_State;
+
+	ResetTracking();
+}
+//--------------------------------------------------------------------------------
+template <class T>
 T TStateMonitor<T>::GetState() const
 {
 	return( m_State );
@@ -0,0 +1,93 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// TaskGraph
+//
+// Schedules a set of nodes with dependencies between them on the JobSystem.  A
+// node is started as soon as all of its prerequisites have completed, so that
+// independent nodes run in parallel without waiting for each other in batches.
+//
+// Each running node is given one of a fixed number of slots, and no two nodes
+// use the same slot at the same time.  This lets the nodes use per-slot state,
+// like a deferred context, without knowing which thread they run on.
+//
+// The graph also provides an order of the nodes that respects the dependencies,
+// which can be followed while the nodes are still executing to consume their
+// results as soon as they are available.  Whenever the dependencies allow it,
+// nodes with a lower index come first in this order and are started first.
+//
+// Without a job system, the nodes are executed on the calling thread in that
+// order, all with slot zero.
+//--------------------------------------------------------------------------------
+#ifndef TaskGraph_h
+#define TaskGraph_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "JobSystem.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class TaskGraph
+	{
+	public:
+		typedef std::function<void( unsigned int node, unsigned int slot )> NodeFunction;
+
+		TaskGraph();
+		~TaskGraph();
+
+		unsigned int AddNode( );
+		void AddDependency( unsigned int node, unsigned int prerequisite );
+
+		// Removes all of the nodes.  The graph must not be executing.
+		void Clear( );
+
+		// Starts executing the nodes.  Returns false without executing anything
+		// when the dependencies contain a cycle.  When a job system is used, the
+		// call returns right away, and the nodes have to be waited on.
+		bool Execute( JobSystem* pJobs, unsigned int slots, const NodeFunction& function );
+
+		bool IsComplete( unsigned int node );
+		void WaitForNode( unsigned int node );
+		void Wait( );
+
+		unsigned int GetNodeCount( ) const;
+		const std::vector<unsigned int>& GetOrder( ) const;
+
+	protected:
+		struct Node
+		{
+			std::vector<unsigned int>	Dependents;
+			unsigned int				Prerequisites;
+			unsigned int				Remaining;
+			bool						Complete;
+		};
+
+		bool Sort( );
+		void Dispatch( );
+		void RunNode( unsigned int node, unsigned int slot );
+
+		std::vector<Node>				m_Nodes;
+		std::vector<unsigned int>		m_Order;
+
+		// The nodes that can be started, kept as a heap with the lowest index on
+		// top, and the slots that aren't in use.
+		std::vector<unsigned int>		m_Ready;
+		std::vector<unsigned int>		m_FreeSlots;
+
+		std::mutex						m_Lock;
+		JobSystem*						m_pJobs;
+		JobSystem::Counter				m_Counter;
+		NodeFunction					m_Function;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // TaskGraph_h
+//--------------------------------------------------------------------------------
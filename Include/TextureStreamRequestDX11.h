@@ -0,0 +1,55 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// TextureStreamRequestDX11
+//
+// Streams a texture file with the ResourceStreamer, as the asynchronous version
+// of RendererDX11::LoadTexture.  The file is read on an I/O thread, and the
+// texture is decoded and created on a decode thread, which is possible since
+// the device is free threaded.  Only the registration of the texture with the
+// renderer is left for the main thread.
+//
+// DDS files are created with the mip maps that they contain.  Other images are
+// decoded with WIC, but without the generated mip maps of LoadTexture, since
+// generating them needs the immediate context.
+//--------------------------------------------------------------------------------
+#ifndef TextureStreamRequestDX11_h
+#define TextureStreamRequestDX11_h
+//--------------------------------------------------------------------------------
+#include "StreamRequest.h"
+#include "ResourceProxyDX11.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class TextureStreamRequestDX11 : public StreamRequest
+	{
+	public:
+		// The filename is relative to the texture folder, like the filename of
+		// LoadTexture.  The renderer is the one that RendererDX11::Get returns.
+		TextureStreamRequestDX11( const std::wstring& filename, bool sRGB = false );
+		virtual ~TextureStreamRequestDX11();
+
+		// Returns nullptr until the request is complete.
+		ResourcePtr GetTexture( ) const;
+
+	protected:
+		virtual bool Decode( );
+		virtual bool Finalize( );
+
+		RendererDX11*								m_pRenderer;
+		bool										m_bSRGB;
+		Microsoft::WRL::ComPtr<ID3D11Texture2D>		m_pTexture;
+		ResourcePtr									m_Texture;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // TextureStreamRequestDX11_h
+//--------------------------------------------------------------------------------
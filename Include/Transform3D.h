@@ -33,9 +33,26 @@ namespace Glyph3
 		Matrix3f& Rotation( );
 		Vector3f& Scale( );
 
-		void UpdateLocal( );
+		// The update methods track whether anything has changed since the last
+		// update.  The local matrix is only rebuilt when the position, rotation or
+		// scale have been modified, and the world matrix is only rebuilt when the
+		// local matrix or the parent's world matrix has changed.  Each of them
+		// returns true if its matrix was rebuilt.
+
+		bool UpdateLocal( );
 		void UpdateWorld( const Matrix4f& parent );
-		void UpdateWorld( );
+		bool UpdateWorld( const Transform3D& parent );
+		bool UpdateWorld( );
+
+		// Forces the local and world matrices to be rebuilt on the next update, even
+		// if no modifications have been detected.
+
+		void MakeDirty( );
+
+		// The revision is incremented each time the world matrix changes, which
+		// allows dependent objects to cheaply detect a change.
+
+		unsigned int GetRevision( ) const;
 
 		const Matrix4f& LocalMatrix( ) const;
 		const Matrix4f& WorldMatrix( ) const;
@@ -59,6 +76,15 @@ namespace Glyph3
 		Matrix4f m_mWorld;			// with the new local matrix and the entity's parent
 		Matrix4f m_mLocal;			// world matrix.
 
+		Vector3f m_vLastTranslation;	// The components used to build the current
+		Matrix3f m_mLastRotation;		// local matrix, for detecting modifications.
+		Vector3f m_vLastScale;
+
+		bool m_bLocalChanged;
+		unsigned int m_uiRevision;
+
+		const Transform3D* m_pLastParent;	// The parent and its revision that were
+		unsigned int m_uiLastParentRevision;	// used to build the world matrix.
 	};
 };
 //--------------------------------------------------------------------------------
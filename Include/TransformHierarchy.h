@@ -0,0 +1,125 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// TransformHierarchy
+//
+// This class holds a flattened copy of a scene graph, which allows the graph to
+// be updated with a single linear pass instead of a recursive traversal.  The 
+// objects are stored in topological order (each parent appears before all of 
+// its children) together with the index of their parent.  This is the same 
+// order in which Node3D::Update visits the graph, so controllers observe the
+// same update ordering with either method.
+//
+// Only the transforms that have actually changed, or whose parent's world 
+// matrix has changed, are rebuilt during the update.  A static scene therefore
+// costs little more than a change check per object each frame.
+//
+// The flattened arrays are rebuilt automatically whenever the structure 
+// revision of the root node indicates that the graph has been modified.
+//
+// When parallel updates are enabled, the subtrees below the root are updated as
+// independent jobs on the JobSystem.  Since the subtrees are then processed 
+// concurrently, this must only be enabled when no controller reads or writes
+// the state of objects outside of its own subtree.  Material updates are always
+// performed serially after the transforms have been updated.
+//--------------------------------------------------------------------------------
+#ifndef TransformHierarchy_h
+#define TransformHierarchy_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "Transform3D.h"
+#include "Sphere3f.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class Node3D;
+	class Entity3D;
+
+	class TransformHierarchy
+	{
+	public:
+		TransformHierarchy();
+		~TransformHierarchy();
+
+		void Build( Node3D* pRoot );
+		void Update( float time );
+
+		// Brings the bounds of every node up to date with the world space
+		// bounding spheres of the entities below it, and stores them in the node.
+		// The sphere of each entity is cached with the transform revision and
+		// number of shapes that it was computed from, and only the ancestors of
+		// the entities whose spheres changed are merged again.
+
+		void UpdateBounds( );
+
+		void SetParallel( bool bParallel );
+		bool IsParallel( ) const;
+
+		unsigned int GetObjectCount( ) const;
+		unsigned int GetUpdatedCount( ) const;
+
+		// The structure revision of the root at the time of the last build, and
+		// the entities of the flattened graph in update order.  Indices that
+		// refer to nodes hold nullptr in the entity list.
+
+		unsigned int GetStructureRevision( ) const;
+		const std::vector< Entity3D* >& GetEntities( ) const;
+
+		// The entities whose transform revision or shapes were found to have
+		// changed by the last call to UpdateBounds, in update order.  After the
+		// graph has been rebuilt, this holds every entity once.
+
+		const std::vector< Entity3D* >& GetChangedEntities( ) const;
+
+	protected:
+		void AddObject( Node3D* pNode, Entity3D* pEntity, Transform3D* pTransform, int parent );
+		unsigned int UpdateRange( unsigned int begin, unsigned int end, float time );
+
+		Node3D* m_pRoot;
+		unsigned int m_uiStructureRevision;
+		unsigned int m_uiUpdatedCount;
+		bool m_bParallel;
+
+		// The root and its entities are always updated first, followed by the 
+		// batches of subtrees, which are stored as [begin,end) index ranges.
+
+		unsigned int m_uiHeadCount;
+		std::vector< std::pair< unsigned int, unsigned int > > m_Batches;
+
+		// Each index refers to one object, which is either a node or an entity.
+		// The unused pointer for each index is set to nullptr.
+
+		std::vector< Transform3D* > m_Transforms;
+		std::vector< int > m_ParentIndices;
+		std::vector< Node3D* > m_Nodes;
+		std::vector< Entity3D* > m_Entities;
+
+		// The bounds and entity counts of each object, and for the entities the
+		// transform revision and number of shapes that the bounds were computed
+		// from.  Entities that aren't drawn are recorded with -1 minus their
+		// number of shapes, so that their shapes are still tracked.  Each
+		// object's subtree ends at its entry in m_SubtreeEnds.
+
+		std::vector< Sphere3f > m_Bounds;
+		std::vector< unsigned char > m_BoundsStates;
+		std::vector< unsigned int > m_EntityCounts;
+		std::vector< unsigned int > m_BoundsRevisions;
+		std::vector< int > m_BoundsShapes;
+		std::vector< unsigned int > m_SubtreeEnds;
+		std::vector< unsigned char > m_BoundsDirty;
+		std::vector< unsigned int > m_DirtyNodes;
+		std::vector< Entity3D* > m_ChangedEntities;
+		bool m_bBoundsValid;
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // TransformHierarchy_h
+//--------------------------------------------------------------------------------
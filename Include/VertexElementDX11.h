@@ -27,6 +27,7 @@
 #include "Vector2f.h"
 #include "Vector3f.h"
 #include "Vector4f.h"
+#include "VertexPackerDX11.h"
 //--------------------------------------------------------------------------------
 namespace Glyph3
 {
@@ -73,6 +74,9 @@ namespace Glyph3
 		D3D11_INPUT_CLASSIFICATION		m_InputSlotClass;
 		UINT							m_uiInstanceDataStepRate;
 
+		// The format that the data is converted to in the vertex buffer.
+		VertexPacking					m_Packing;
+
 	protected:
 		VertexElementDX11();
 
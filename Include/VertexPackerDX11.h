@@ -0,0 +1,96 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+// VertexPackerDX11
+//
+// Converts the float data of a vertex element into a more compact format when
+// it is interleaved into a vertex buffer.  Each vertex element selects its own
+// packing, and GeometryDX11 uses the packed formats and sizes both when filling
+// the vertex buffer and when generating its input layouts.  Every packed
+// element is padded to a multiple of four bytes, and any padding components are
+// filled with the same ( 0, 0, 0, 1 ) defaults that the input assembler uses.
+//
+// The packings and their maximum error after unpacking are:
+//
+//  HalfFloat  - 16 bit floats, with a relative error of at most 2^-11 for
+//               values up to 65504.  Positions are read as float3 or float4.
+//  Octahedral - unit vectors mapped onto an octahedron and stored as two
+//               16 bit snorm values, with an angular error below 0.04
+//               degrees.  Only three component elements can use it, and the
+//               shader must decode the float2 it receives:
+//
+//                   float3 n = float3( e.xy, 1.0f - abs( e.x ) - abs( e.y ) );
+//                   float t = saturate( -n.z );
+//                   n.xy += ( n.xy >= 0.0f ) ? -t : t;
+//                   n = normalize( n );
+//
+//  UNorm16    - values in [0,1] stored as 16 bit unorms, error of about 1/131070.
+//  UNorm8     - values in [0,1] stored as 8 bit unorms, error of about 1/510.
+//  UInt8      - uint data in [0,255] stored as 8 bit uints, without error.
+//  SInt8      - sint data in [-128,127] stored as 8 bit sints, without error.
+//               The integer packings keep the signedness of the element's
+//               format, so the shader declares the same uint or int input as
+//               it does for the unpacked element.
+//
+// CanPack checks that an element's data fits the range of a packing, and
+// MeasureError round trips the data to report the actual maximum error.
+//--------------------------------------------------------------------------------
+#ifndef VertexPackerDX11_h
+#define VertexPackerDX11_h
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+//--------------------------------------------------------------------------------
+namespace Glyph3
+{
+	class VertexElementDX11;
+
+	enum class VertexPacking
+	{
+		None,
+		HalfFloat,
+		Octahedral,
+		UNorm16,
+		UNorm8,
+		UInt8,
+		SInt8
+	};
+
+	class VertexPackerDX11
+	{
+	public:
+		// Returns the packing that suits the standard semantic names.
+		static VertexPacking GetDefaultPacking( const std::string& semantic );
+
+		static bool CanPack( VertexElementDX11* pElement, VertexPacking packing );
+		static DXGI_FORMAT GetFormat( VertexElementDX11* pElement, VertexPacking packing );
+		static unsigned int GetSize( VertexElementDX11* pElement, VertexPacking packing );
+
+		// Writes GetSize bytes for one vertex of the element, and reads them back.
+		static void Pack( VertexElementDX11* pElement, VertexPacking packing, int vertex, void* pDest );
+		static void Unpack( const void* pSource, VertexPacking packing, int tuple, float* pDest );
+
+		// Returns the largest error of any component after a round trip, or the
+		// largest angle in radians for octahedral packing.
+		static float MeasureError( VertexElementDX11* pElement, VertexPacking packing );
+
+		static unsigned short FloatToHalf( float value );
+		static float HalfToFloat( unsigned short value );
+
+		static void EncodeOctahedral( const float* pVector, short* pEncoded );
+		static void DecodeOctahedral( const short* pEncoded, float* pVector );
+
+	private:
+		VertexPackerDX11();
+	};
+};
+//--------------------------------------------------------------------------------
+#endif // VertexPackerDX11_h
+//--------------------------------------------------------------------------------
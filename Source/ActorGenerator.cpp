@@ -40,12 +40,19 @@ Actor* ActorGenerator::GenerateVisualizationTexture2D( RendererDX11& Renderer,
 	pActor->AddElement( pFrame );
 
 	// Create/load the geometry to put around the visualization (i.e. the picture frame)
+	// The frame is only lit, so its vertices are packed with the default
+	// formats, and the normals are decoded by the material if they could be
+	// packed.
 	GeometryPtr frameGeometry = GeometryLoaderDX11::loadMS3DFile2( std::wstring( L"ScreenFrame.ms3d" ) );
+	frameGeometry->SetDefaultPacking();
 	frameGeometry->LoadToBuffers();
 	pFrame->Visual.SetGeometry( frameGeometry );
+
+	VertexElementDX11* pNormals = frameGeometry->GetElement( VertexElementDX11::NormalSemantic );
+	const bool bOctahedral = pNormals != nullptr && pNormals->m_Packing == VertexPacking::Octahedral;
 		
 	// Create the material for the picture frame
-	pFrame->Visual.SetMaterial( MaterialGeneratorDX11::GeneratePhong( Renderer ) );
+	pFrame->Visual.SetMaterial( MaterialGeneratorDX11::GeneratePhong( Renderer, bOctahedral ) );
 
 	// Create/load the geometry to put the visualization on (i.e. the picture)
 	GeometryPtr screenGeometry = GeometryLoaderDX11::loadMS3DFile2( std::wstring( L"Screen.ms3d" ) );
@@ -16,6 +16,8 @@
 #include "Application.h"
 #include "EvtInfoMessage.h"
 #include "EvtErrorMessage.h"
+#include "Profiler.h"
+#include "EventPool.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
@@ -139,9 +141,20 @@ void Application::MessageLoop()
 			DispatchMessage( &msg );
 		}
 
-		// Call the overloaded application update function.
-		Update();
+		// Dispatch the events that were queued since the last frame, finalize
+		// the resources that have finished streaming, and then call the
+		// overloaded application update function.
+		{
+			GLYPH_PROFILE_SCOPE( "Application::Update" );
+
+			EvtManager.ProcessEventQueue();
+			Streamer.Update();
+			Update();
+		}
 		TakeScreenShot();
+
+		// Collect the profiling data of the frame.
+		Profiler::Get().EndFrame();
 	}
 }
 //--------------------------------------------------------------------------------
@@ -186,74 +199,74 @@ LRESULT Application::WindowProc( HWND hwnd, UINT msg, WPARAM wparam, LPARAM lpar
 
 		case WM_SIZE:
 			{				
-                EvtWindowResizePtr pEvent = EvtWindowResizePtr( new EvtWindowResize( hwnd, wparam, lparam ) );
+                EvtWindowResizePtr pEvent = MakeEvent<EvtWindowResize>( hwnd, wparam, lparam );
                 EvtManager.ProcessEvent( pEvent );
 			} break;
 
 
 		case WM_LBUTTONUP:
 			{				
-                EvtMouseLButtonUpPtr pEvent = EvtMouseLButtonUpPtr( new EvtMouseLButtonUp( hwnd, wparam, lparam ) );
+                EvtMouseLButtonUpPtr pEvent = MakeEvent<EvtMouseLButtonUp>( hwnd, wparam, lparam );
                 EvtManager.ProcessEvent( pEvent );
 			} break;
 
 		case WM_LBUTTONDOWN:
 			{
-                EvtMouseLButtonDownPtr pEvent = EvtMouseLButtonDownPtr( new EvtMouseLButtonDown( hwnd, wparam, lparam ) );
+                EvtMouseLButtonDownPtr pEvent = MakeEvent<EvtMouseLButtonDown>( hwnd, wparam, lparam );
                 EvtManager.ProcessEvent( pEvent );
 			} break;
 			
 		case WM_MBUTTONUP:
 			{
-                EvtMouseMButtonUpPtr pEvent = EvtMouseMButtonUpPtr( new EvtMouseMButtonUp( hwnd, wparam, lparam ) );
+                EvtMouseMButtonUpPtr pEvent = MakeEvent<EvtMouseMButtonUp>( hwnd, wparam, lparam );
                 EvtManager.ProcessEvent( pEvent );
 			} break;
 
 		case WM_MBUTTONDOWN:
 			{
-                EvtMouseMButtonDownPtr pEvent = EvtMouseMButtonDownPtr( new EvtMouseMButtonDown( hwnd, wparam, lparam ) );
+                EvtMouseMButtonDownPtr pEvent = MakeEvent<EvtMouseMButtonDown>( hwnd, wparam, lparam );
                 EvtManager.ProcessEvent( pEvent );
 			} break;
 
 		case WM_RBUTTONUP:
 			{
-                EvtMouseRButtonUpPtr pEvent = EvtMouseRButtonUpPtr( new EvtMouseRButtonUp( hwnd, wparam, lparam ) );
+                EvtMouseRButtonUpPtr pEvent = MakeEvent<EvtMouseRButtonUp>( hwnd, wparam, lparam );
                 EvtManager.ProcessEvent( pEvent );
 			} break;
 
 		case WM_RBUTTONDOWN:
 			{
-                EvtMouseRButtonDownPtr pEvent = EvtMouseRButtonDownPtr( new EvtMouseRButtonDown( hwnd, wparam, lparam ) );
+                EvtMouseRButtonDownPtr pEvent = MakeEvent<EvtMouseRButtonDown>( hwnd, wparam, lparam );
                 EvtManager.ProcessEvent( pEvent );
 			} break;
 
 		case WM_MOUSEMOVE:
 			{
-                EvtMouseMovePtr pEvent = EvtMouseMovePtr( new EvtMouseMove( hwnd, wparam, lparam ) );
+                EvtMouseMovePtr pEvent = MakeEvent<EvtMouseMove>( hwnd, wparam, lparam );
                 EvtManager.ProcessEvent( pEvent );
 			} break;
 
 		case WM_MOUSEWHEEL:
 			{
-                EvtMouseWheelPtr pEvent = EvtMouseWheelPtr( new EvtMouseWheel( hwnd, wparam, lparam ) );
+                EvtMouseWheelPtr pEvent = MakeEvent<EvtMouseWheel>( hwnd, wparam, lparam );
                 EvtManager.ProcessEvent( pEvent );
 			} break;
 
 		case WM_CHAR:
 			{
-				EvtCharPtr pEvent = EvtCharPtr( new EvtChar( hwnd, wparam, lparam ) );
+				EvtCharPtr pEvent = MakeEvent<EvtChar>( hwnd, wparam, lparam );
 				EvtManager.ProcessEvent( pEvent );
 			} break;
 
 		case WM_KEYDOWN:
 			{
-				EvtKeyDownPtr pEvent = EvtKeyDownPtr( new EvtKeyDown( hwnd, wparam, lparam ) );
+				EvtKeyDownPtr pEvent = MakeEvent<EvtKeyDown>( hwnd, wparam, lparam );
 				EvtManager.ProcessEvent( pEvent );
 			} break;
 
 		case WM_KEYUP:
 			{
-				EvtKeyUpPtr pEvent = EvtKeyUpPtr( new EvtKeyUp( hwnd, wparam, lparam ) );
+				EvtKeyUpPtr pEvent = MakeEvent<EvtKeyUp>( hwnd, wparam, lparam );
 				EvtManager.ProcessEvent( pEvent );
 			} break;
     }
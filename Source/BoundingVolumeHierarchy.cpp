@@ -0,0 +1,645 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "BoundingVolumeHierarchy.h"
+#include "Entity3D.h"
+#include "JobSystem.h"
+#include <unordered_set>
+#include <float.h>
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+// The fat boxes of the leaves are enlarged by this fraction of the sphere radius,
+// plus a small constant for very small spheres.
+//--------------------------------------------------------------------------------
+static const float LeafMarginScale = 0.1f;
+static const float LeafMarginMinimum = 0.01f;
+//--------------------------------------------------------------------------------
+static AxisAlignedBox Merge( const AxisAlignedBox& a, const AxisAlignedBox& b )
+{
+	return( AxisAlignedBox(
+		Vector3f( std::min( a.minimums.x, b.minimums.x ), std::min( a.minimums.y, b.minimums.y ), std::min( a.minimums.z, b.minimums.z ) ),
+		Vector3f( std::max( a.maximums.x, b.maximums.x ), std::max( a.maximums.y, b.maximums.y ), std::max( a.maximums.z, b.maximums.z ) ) ) );
+}
+//--------------------------------------------------------------------------------
+static float SurfaceArea( const AxisAlignedBox& box )
+{
+	Vector3f d = box.maximums - box.minimums;
+	return( 2.0f * ( d.x * d.y + d.y * d.z + d.z * d.x ) );
+}
+//--------------------------------------------------------------------------------
+static bool Encloses( const AxisAlignedBox& outer, const AxisAlignedBox& inner )
+{
+	return( outer.minimums.x <= inner.minimums.x && outer.minimums.y <= inner.minimums.y && outer.minimums.z <= inner.minimums.z
+		&& inner.maximums.x <= outer.maximums.x && inner.maximums.y <= outer.maximums.y && inner.maximums.z <= outer.maximums.z );
+}
+//--------------------------------------------------------------------------------
+static AxisAlignedBox SphereBox( const Sphere3f& sphere, float fMargin )
+{
+	Vector3f extent( sphere.radius + fMargin, sphere.radius + fMargin, sphere.radius + fMargin );
+	return( AxisAlignedBox( sphere.center - extent, sphere.center + extent ) );
+}
+//--------------------------------------------------------------------------------
+static bool RayIntersectsBox( const Ray3f& ray, const AxisAlignedBox& box )
+{
+	// Slab test against the three pairs of planes, clipped to the positive half
+	// of the ray.  Zero direction components produce infinite reciprocals, which
+	// the comparisons below handle correctly unless the origin lies exactly on a
+	// slab boundary.
+
+	float tMin = 0.0f;
+	float tMax = FLT_MAX;
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		float fInv = 1.0f / ray.direction[i];
+		float t0 = ( box.minimums[i] - ray.origin[i] ) * fInv;
+		float t1 = ( box.maximums[i] - ray.origin[i] ) * fInv;
+
+		if ( t0 > t1 ) std::swap( t0, t1 );
+
+		tMin = std::max( tMin, t0 );
+		tMax = std::min( tMax, t1 );
+
+		if ( tMin > tMax )
+			return( false );
+	}
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+static bool SphereIntersectsBox( const Sphere3f& sphere, const AxisAlignedBox& box )
+{
+	float fDistanceSq = 0.0f;
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		float v = sphere.center[i];
+		if ( v < box.minimums[i] ) fDistanceSq += ( box.minimums[i] - v ) * ( box.minimums[i] - v );
+		if ( v > box.maximums[i] ) fDistanceSq += ( v - box.maximums[i] ) * ( v - box.maximums[i] );
+	}
+
+	return( fDistanceSq <= sphere.radius * sphere.radius );
+}
+//--------------------------------------------------------------------------------
+static bool FrustumIntersectsBox( const Frustum3f& frustum, const AxisAlignedBox& box )
+{
+	// The box is outside if its corner furthest along a plane's normal is behind
+	// that plane.
+
+	for ( int i = 0; i < 6; i++ )
+	{
+		const Plane3f& plane = frustum.planes[i];
+
+		Vector3f corner( plane.a >= 0.0f ? box.maximums.x : box.minimums.x,
+						 plane.b >= 0.0f ? box.maximums.y : box.minimums.y,
+						 plane.c >= 0.0f ? box.maximums.z : box.minimums.z );
+
+		if ( plane.DistanceToPoint( corner ) < 0.0f )
+			return( false );
+	}
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+BoundingVolumeHierarchy::BoundingVolumeHierarchy() :
+	m_iRoot( -1 ),
+	m_iFreeList( -1 ),
+	m_uiRevision( 0 ),
+	m_bSynchronized( false )
+{
+}
+//--------------------------------------------------------------------------------
+BoundingVolumeHierarchy::~BoundingVolumeHierarchy()
+{
+}
+//--------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::Clear( )
+{
+	m_Nodes.clear();
+	m_Records.clear();
+	m_iRoot = -1;
+	m_iFreeList = -1;
+	m_bSynchronized = false;
+}
+//--------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::Update( const std::vector<Entity3D*>& entities, unsigned int revision,
+									const std::vector<Entity3D*>& changed )
+{
+	if ( !m_bSynchronized || revision != m_uiRevision )
+	{
+		// Remove the entities that are no longer in the list, and then add the
+		// ones that are new.  Entities that remain keep their current leaves.
+
+		std::unordered_set< Entity3D* > current;
+		current.reserve( entities.size() );
+
+		for ( auto pEntity : entities ) {
+			if ( pEntity ) current.insert( pEntity );
+		}
+
+		std::vector< Entity3D* > removed;
+
+		for ( auto& entry : m_Records ) {
+			if ( current.find( entry.first ) == current.end() )
+				removed.push_back( entry.first );
+		}
+
+		for ( auto pEntity : removed )
+			Remove( pEntity );
+
+		for ( auto pEntity : current )
+			Insert( pEntity );
+
+		m_uiRevision = revision;
+		m_bSynchronized = true;
+	}
+
+	Refit( changed );
+}
+//--------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::Insert( Entity3D* pEntity )
+{
+	if ( pEntity == nullptr || m_Records.find( pEntity ) != m_Records.end() )
+		return;
+
+	Record record;
+	record.leaf = -1;
+	record.revision = pEntity->Transform.GetRevision();
+	record.shapes = -1;
+
+	UpdateRecord( pEntity, record );
+
+	m_Records[pEntity] = record;
+}
+//--------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::Remove( Entity3D* pEntity )
+{
+	auto it = m_Records.find( pEntity );
+
+	if ( it == m_Records.end() )
+		return;
+
+	if ( it->second.leaf != -1 )
+	{
+		RemoveLeaf( it->second.leaf );
+		FreeNode( it->second.leaf );
+	}
+
+	m_Records.erase( it );
+}
+//--------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::Refit( const std::vector<Entity3D*>& entities )
+{
+	for ( auto pEntity : entities )
+	{
+		auto it = m_Records.find( pEntity );
+
+		if ( it == m_Records.end() )
+			continue;
+
+		Record& record = it->second;
+
+		if ( record.revision != pEntity->Transform.GetRevision()
+			|| record.shapes != pEntity->Shape.GetNumberOfShapes() )
+		{
+			UpdateRecord( pEntity, record );
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::UpdateRecord( Entity3D* pEntity, Record& record )
+{
+	record.revision = pEntity->Transform.GetRevision();
+	record.shapes = pEntity->Shape.GetNumberOfShapes();
+
+	Sphere3f bounds;
+
+	if ( !pEntity->Shape.GetBoundingSphere( pEntity->Transform.WorldMatrix(), bounds ) )
+	{
+		// The entity has lost all of its shapes, so it can't be found anymore.
+
+		if ( record.leaf != -1 )
+		{
+			RemoveLeaf( record.leaf );
+			FreeNode( record.leaf );
+			record.leaf = -1;
+		}
+
+		return;
+	}
+
+	// Nothing changes in the tree as long as the entity stays within its fat box.
+
+	AxisAlignedBox tight = SphereBox( bounds, 0.0f );
+
+	if ( record.leaf != -1 )
+	{
+		if ( Encloses( m_Nodes[record.leaf].box, tight ) )
+			return;
+
+		RemoveLeaf( record.leaf );
+	}
+	else
+	{
+		record.leaf = AllocateNode();
+		m_Nodes[record.leaf].pEntity = pEntity;
+		m_Nodes[record.leaf].height = 0;
+	}
+
+	m_Nodes[record.leaf].box = SphereBox( bounds, bounds.radius * LeafMarginScale + LeafMarginMinimum );
+	InsertLeaf( record.leaf );
+}
+//--------------------------------------------------------------------------------
+int BoundingVolumeHierarchy::AllocateNode( )
+{
+	int index;
+
+	if ( m_iFreeList != -1 )
+	{
+		index = m_iFreeList;
+		m_iFreeList = m_Nodes[index].parent;
+	}
+	else
+	{
+		index = static_cast<int>( m_Nodes.size() );
+		m_Nodes.push_back( Node() );
+	}
+
+	Node& node = m_Nodes[index];
+	node.parent = -1;
+	node.child1 = -1;
+	node.child2 = -1;
+	node.height = 0;
+	node.pEntity = nullptr;
+
+	return( index );
+}
+//--------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::FreeNode( int index )
+{
+	m_Nodes[index].parent = m_iFreeList;
+	m_Nodes[index].height = -1;
+	m_Nodes[index].pEntity = nullptr;
+	m_iFreeList = index;
+}
+//--------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::InsertLeaf( int leaf )
+{
+	if ( m_iRoot == -1 )
+	{
+		m_iRoot = leaf;
+		m_Nodes[leaf].parent = -1;
+		return;
+	}
+
+	// Descend the tree to find the best sibling for the new leaf, using the
+	// increase in surface area as the cost of each choice.
+
+	AxisAlignedBox leafBox = m_Nodes[leaf].box;
+	int index = m_iRoot;
+
+	while ( !m_Nodes[index].IsLeaf() )
+	{
+		const Node& node = m_Nodes[index];
+
+		float fArea = SurfaceArea( node.box );
+		float fCombinedArea = SurfaceArea( Merge( node.box, leafBox ) );
+
+		// The cost of making a new parent for this node and the new leaf, and
+		// the minimum cost that is pushed down into the children.
+
+		float fCost = 2.0f * fCombinedArea;
+		float fInheritance = 2.0f * ( fCombinedArea - fArea );
+
+		float fChildCost[2];
+		int children[2] = { node.child1, node.child2 };
+
+		for ( int i = 0; i < 2; i++ )
+		{
+			const Node& child = m_Nodes[children[i]];
+			float fMerged = SurfaceArea( Merge( child.box, leafBox ) );
+
+			if ( child.IsLeaf() )
+				fChildCost[i] = fMerged + fInheritance;
+			else
+				fChildCost[i] = ( fMerged - SurfaceArea( child.box ) ) + fInheritance;
+		}
+
+		if ( fCost < fChildCost[0] && fCost < fChildCost[1] )
+			break;
+
+		index = ( fChildCost[0] < fChildCost[1] ) ? children[0] : children[1];
+	}
+
+	int sibling = index;
+
+	// Create a new parent for the sibling and the leaf.
+
+	int oldParent = m_Nodes[sibling].parent;
+	int newParent = AllocateNode();
+
+	m_Nodes[newParent].parent = oldParent;
+	m_Nodes[newParent].box = Merge( leafBox, m_Nodes[sibling].box );
+	m_Nodes[newParent].height = m_Nodes[sibling].height + 1;
+	m_Nodes[newParent].child1 = sibling;
+	m_Nodes[newParent].child2 = leaf;
+
+	if ( oldParent != -1 )
+	{
+		if ( m_Nodes[oldParent].child1 == sibling )
+			m_Nodes[oldParent].child1 = newParent;
+		else
+			m_Nodes[oldParent].child2 = newParent;
+	}
+	else
+	{
+		m_iRoot = newParent;
+	}
+
+	m_Nodes[sibling].parent = newParent;
+	m_Nodes[leaf].parent = newParent;
+
+	// Walk back up the tree, rebalancing and refitting the ancestors.
+
+	index = m_Nodes[leaf].parent;
+
+	while ( index != -1 )
+	{
+		index = Balance( index );
+
+		Node& node = m_Nodes[index];
+		node.height = 1 + std::max( m_Nodes[node.child1].height, m_Nodes[node.child2].height );
+		node.box = Merge( m_Nodes[node.child1].box, m_Nodes[node.child2].box );
+
+		index = node.parent;
+	}
+}
+//--------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::RemoveLeaf( int leaf )
+{
+	if ( leaf == m_iRoot )
+	{
+		m_iRoot = -1;
+		return;
+	}
+
+	// The leaf's parent is removed, and the sibling takes its place.
+
+	int parent = m_Nodes[leaf].parent;
+	int grandParent = m_Nodes[parent].parent;
+	int sibling = ( m_Nodes[parent].child1 == leaf ) ? m_Nodes[parent].child2 : m_Nodes[parent].child1;
+
+	FreeNode( parent );
+
+	if ( grandParent == -1 )
+	{
+		m_iRoot = sibling;
+		m_Nodes[sibling].parent = -1;
+		return;
+	}
+
+	if ( m_Nodes[grandParent].child1 == parent )
+		m_Nodes[grandParent].child1 = sibling;
+	else
+		m_Nodes[grandParent].child2 = sibling;
+
+	m_Nodes[sibling].parent = grandParent;
+
+	int index = grandParent;
+
+	while ( index != -1 )
+	{
+		index = Balance( index );
+
+		Node& node = m_Nodes[index];
+		node.height = 1 + std::max( m_Nodes[node.child1].height, m_Nodes[node.child2].height );
+		node.box = Merge( m_Nodes[node.child1].box, m_Nodes[node.child2].box );
+
+		index = node.parent;
+	}
+}
+//--------------------------------------------------------------------------------
+int BoundingVolumeHierarchy::Balance( int iA )
+{
+	// Performs a left or right rotation if node A is imbalanced, and returns the
+	// index of the node that takes its place.
+
+	Node& A = m_Nodes[iA];
+
+	if ( A.IsLeaf() || A.height < 2 )
+		return( iA );
+
+	int iB = A.child1;
+	int iC = A.child2;
+	Node& B = m_Nodes[iB];
+	Node& C = m_Nodes[iC];
+
+	int balance = C.height - B.height;
+
+	if ( balance > 1 )
+	{
+		// Rotate C up
+
+		int iF = C.child1;
+		int iG = C.child2;
+		Node& F = m_Nodes[iF];
+		Node& G = m_Nodes[iG];
+
+		C.child1 = iA;
+		C.parent = A.parent;
+		A.parent = iC;
+
+		if ( C.parent != -1 )
+		{
+			if ( m_Nodes[C.parent].child1 == iA )
+				m_Nodes[C.parent].child1 = iC;
+			else
+				m_Nodes[C.parent].child2 = iC;
+		}
+		else
+		{
+			m_iRoot = iC;
+		}
+
+		if ( F.height > G.height )
+		{
+			C.child2 = iF;
+			A.child2 = iG;
+			G.parent = iA;
+			A.box = Merge( B.box, G.box );
+			C.box = Merge( A.box, F.box );
+			A.height = 1 + std::max( B.height, G.height );
+			C.height = 1 + std::max( A.height, F.height );
+		}
+		else
+		{
+			C.child2 = iG;
+			A.child2 = iF;
+			F.parent = iA;
+			A.box = Merge( B.box, F.box );
+			C.box = Merge( A.box, G.box );
+			A.height = 1 + std::max( B.height, F.height );
+			C.height = 1 + std::max( A.height, G.height );
+		}
+
+		return( iC );
+	}
+
+	if ( balance < -1 )
+	{
+		// Rotate B up
+
+		int iD = B.child1;
+		int iE = B.child2;
+		Node& D = m_Nodes[iD];
+		Node& E = m_Nodes[iE];
+
+		B.child1 = iA;
+		B.parent = A.parent;
+		A.parent = iB;
+
+		if ( B.parent != -1 )
+		{
+			if ( m_Nodes[B.parent].child1 == iA )
+				m_Nodes[B.parent].child1 = iB;
+			else
+				m_Nodes[B.parent].child2 = iB;
+		}
+		else
+		{
+			m_iRoot = iB;
+		}
+
+		if ( D.height > E.height )
+		{
+			B.child2 = iD;
+			A.child1 = iE;
+			E.parent = iA;
+			A.box = Merge( C.box, E.box );
+			B.box = Merge( A.box, D.box );
+			A.height = 1 + std::max( C.height, E.height );
+			B.height = 1 + std::max( A.height, D.height );
+		}
+		else
+		{
+			B.child2 = iE;
+			A.child1 = iD;
+			D.parent = iA;
+			A.box = Merge( C.box, D.box );
+			B.box = Merge( A.box, E.box );
+			A.height = 1 + std::max( C.height, D.height );
+			B.height = 1 + std::max( A.height, E.height );
+		}
+
+		return( iB );
+	}
+
+	return( iA );
+}
+//--------------------------------------------------------------------------------
+template <typename TBoxTest, typename TLeafTest>
+void BoundingVolumeHierarchy::Query( const TBoxTest& boxTest, const TLeafTest& leafTest, std::vector<Entity3D*>& set ) const
+{
+	if ( m_iRoot == -1 )
+		return;
+
+	// The tree is balanced, so its height (and hence the stack size) stays
+	// logarithmic in the number of entities.
+
+	std::vector<int> stack;
+	stack.reserve( 64 );
+	stack.push_back( m_iRoot );
+
+	while ( !stack.empty() )
+	{
+		const Node& node = m_Nodes[stack.back()];
+		stack.pop_back();
+
+		if ( !boxTest( node.box ) )
+			continue;
+
+		if ( node.IsLeaf() )
+		{
+			if ( leafTest( node.pEntity ) )
+				set.push_back( node.pEntity );
+		}
+		else
+		{
+			stack.push_back( node.child2 );
+			stack.push_back( node.child1 );
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::QueryRay( const Ray3f& ray, std::vector<Entity3D*>& set ) const
+{
+	Query( [&ray]( const AxisAlignedBox& box ) { return( RayIntersectsBox( ray, box ) ); },
+		[]( Entity3D* ) { return( true ); },
+		set );
+}
+//--------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::QuerySphere( const Sphere3f& bounds, std::vector<Entity3D*>& set ) const
+{
+	// The leaves are tested against the entity's actual bounding sphere, since
+	// the fat boxes are considerably larger than it.
+
+	Query( [&bounds]( const AxisAlignedBox& box ) { return( SphereIntersectsBox( bounds, box ) ); },
+		[&bounds]( Entity3D* pEntity ) {
+			Sphere3f sphere;
+			pEntity->Shape.GetBoundingSphere( pEntity->Transform.WorldMatrix(), sphere );
+			return( bounds.Intersects( sphere ) ); },
+		set );
+}
+//--------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::QueryFrustum( const Frustum3f& bounds, std::vector<Entity3D*>& set ) const
+{
+	Query( [&bounds]( const AxisAlignedBox& box ) { return( FrustumIntersectsBox( bounds, box ) ); },
+		[&bounds]( Entity3D* pEntity ) {
+			Sphere3f sphere;
+			pEntity->Shape.GetBoundingSphere( pEntity->Transform.WorldMatrix(), sphere );
+			return( bounds.Intersects( sphere ) ); },
+		set );
+}
+//--------------------------------------------------------------------------------
+void BoundingVolumeHierarchy::QueryRays( const std::vector<Ray3f>& rays, std::vector< std::vector<Entity3D*> >& sets ) const
+{
+	sets.resize( rays.size() );
+
+	auto QueryRange = [&]( unsigned int begin, unsigned int end )
+	{
+		for ( unsigned int i = begin; i < end; i++ )
+		{
+			sets[i].clear();
+			QueryRay( rays[i], sets[i] );
+		}
+	};
+
+	const unsigned int count = static_cast<unsigned int>( rays.size() );
+	JobSystem* pJobs = JobSystem::Get();
+
+	if ( pJobs )
+		pJobs->ParallelFor( count, 64, QueryRange );
+	else
+		QueryRange( 0, count );
+}
+//--------------------------------------------------------------------------------
+unsigned int BoundingVolumeHierarchy::GetEntityCount( ) const
+{
+	return( static_cast<unsigned int>( m_Records.size() ) );
+}
+//--------------------------------------------------------------------------------
+int BoundingVolumeHierarchy::GetHeight( ) const
+{
+	return( m_iRoot == -1 ? 0 : m_Nodes[m_iRoot].height );
+}
+//--------------------------------------------------------------------------------
@@ -87,4 +87,30 @@ int CompositeShape::GetNumberOfShapes() const
 {
 	return( m_spheres.size() );
 }
+//--------------------------------------------------------------------------------
+bool CompositeShape::GetBoundingSphere( const Matrix4f& transform, Sphere3f& bounds ) const
+{
+	if ( m_spheres.empty() )
+		return( false );
+
+	// The radii are scaled by the largest scaling of the basis vectors, which 
+	// conservatively covers non-uniform scaling as well.
+
+	float fScale = std::max( Vector3f::Magnitude( transform.GetBasisX() ),
+		std::max( Vector3f::Magnitude( transform.GetBasisY() ), Vector3f::Magnitude( transform.GetBasisZ() ) ) );
+
+	for ( unsigned int i = 0; i < m_spheres.size(); i++ )
+	{
+		Sphere3f sphere;
+		transform.TransformPoints( &m_spheres[i].center, &sphere.center, 1 );
+		sphere.radius = m_spheres[i].radius * fScale;
+
+		if ( i == 0 )
+			bounds = sphere;
+		else
+			bounds.Merge( sphere );
+	}
+
+	return( true );
+}
 //--------------------------------------------------------------------------------
\ No newline at end of file
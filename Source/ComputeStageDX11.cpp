@@ -45,26 +45,42 @@ void ComputeStageDX11::BindShaderProgram( ID3D11DeviceContext* pContext )
 //--------------------------------------------------------------------------------
 void ComputeStageDX11::BindConstantBuffers( ID3D11DeviceContext* pContext, int count )
 {
-	pContext->CSSetConstantBuffers( 
-		DesiredState.ConstantBuffers.GetStartSlot(),
-		DesiredState.ConstantBuffers.GetRange(),
-		DesiredState.ConstantBuffers.GetFirstSlotLocation() );
+	unsigned int slot = 0;
+	unsigned int range = 0;
+
+	while ( DesiredState.GetNextConstantBufferRange( slot, range ) ) {
+		if ( m_pContext1 ) {
+			m_pContext1->CSSetConstantBuffers1( slot, range,
+				DesiredState.ConstantBuffers.GetSlotLocation( slot ),
+				DesiredState.ConstantBufferOffsets.GetSlotLocation( slot ),
+				DesiredState.ConstantBufferSizes.GetSlotLocation( slot ) );
+		} else {
+			pContext->CSSetConstantBuffers( slot, range, DesiredState.ConstantBuffers.GetSlotLocation( slot ) );
+		}
+		slot += range;
+	}
 }
 //--------------------------------------------------------------------------------
 void ComputeStageDX11::BindSamplerStates( ID3D11DeviceContext* pContext, int count )
 {
-	pContext->CSSetSamplers( 
-		DesiredState.SamplerStates.GetStartSlot(),
-		DesiredState.SamplerStates.GetRange(),
-		DesiredState.SamplerStates.GetFirstSlotLocation() );
+	unsigned int slot = 0;
+	unsigned int range = 0;
+
+	while ( DesiredState.SamplerStates.GetNextRange( slot, range ) ) {
+		pContext->CSSetSamplers( slot, range, DesiredState.SamplerStates.GetSlotLocation( slot ) );
+		slot += range;
+	}
 }
 //--------------------------------------------------------------------------------
 void ComputeStageDX11::BindShaderResourceViews( ID3D11DeviceContext* pContext, int count )
 {
-	pContext->CSSetShaderResources( 
-		DesiredState.ShaderResourceViews.GetStartSlot(),
-		DesiredState.ShaderResourceViews.GetRange(),
-		DesiredState.ShaderResourceViews.GetFirstSlotLocation() ); 
+	unsigned int slot = 0;
+	unsigned int range = 0;
+
+	while ( DesiredState.ShaderResourceViews.GetNextRange( slot, range ) ) {
+		pContext->CSSetShaderResources( slot, range, DesiredState.ShaderResourceViews.GetSlotLocation( slot ) );
+		slot += range;
+	}
 }
 //--------------------------------------------------------------------------------
 void ComputeStageDX11::BindUnorderedAccessViews( ID3D11DeviceContext* pContext, int count )
@@ -13,14 +13,29 @@
 #include "EventManager.h"
 #include "ConsoleActor.h"
 #include "EvtChar.h"
+#include "Profiler.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
 ConsoleActor::ConsoleActor() : 
 	console(),
-	textActor()
+	textActor(),
+	m_bShowProfile( false )
 {
 	RequestEvent( SYSTEM_KEYBOARD_CHAR );
+	RequestEvent( RENDER_FRAME_START );
+
+	// Register the profiler commands, with this actor as their upvalue.
+
+	lua_State* L = console.getState();
+
+	lua_pushlightuserdata( L, this );
+	lua_pushcclosure( L, &ConsoleActor::ToggleProfile, 1 );
+	lua_setglobal( L, "profile" );
+
+	lua_pushlightuserdata( L, this );
+	lua_pushcclosure( L, &ConsoleActor::ToggleTrace, 1 );
+	lua_setglobal( L, "trace" );
 
 	GetNode()->AttachChild( textActor.GetNode() );
 
@@ -60,6 +75,11 @@ bool ConsoleActor::HandleEvent( EventPtr pEvent )
 		console.processKey( key );
 		printText();
 	}
+	else if ( e == RENDER_FRAME_START )
+	{
+		if ( m_bShowProfile )
+			printText();
+	}
 
     return false;
 }
@@ -85,5 +105,71 @@ void ConsoleActor::printText()
 		++count;
 		if ( count >= MAX_ENTRY_DISPLAY ) break;
 	}
+
+	if ( m_bShowProfile )
+	{
+		textActor.SetColor( Vector4f( 1.0f, 1.0f, 0.5f, 1.0f ) );
+
+		std::wstringstream table( Profiler::Get().GetStatisticsTable( MAX_PROFILE_DISPLAY ) );
+		std::wstring row;
+
+		while ( std::getline( table, row ) ) {
+			textActor.AppendText( row );
+			textActor.NewLine();
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+void ConsoleActor::SetProfileVisible( bool visible )
+{
+	m_bShowProfile = visible;
+	printText();
+}
+//--------------------------------------------------------------------------------
+bool ConsoleActor::IsProfileVisible() const
+{
+	return( m_bShowProfile );
+}
+//--------------------------------------------------------------------------------
+int ConsoleActor::ToggleProfile( lua_State* L )
+{
+	ConsoleActor* pActor = static_cast<ConsoleActor*>( lua_touserdata( L, lua_upvalueindex( 1 ) ) );
+
+	bool visible = !pActor->IsProfileVisible();
+
+	if ( visible || !Profiler::Get().IsCapturing() )
+		Profiler::Get().SetEnabled( visible );
+
+	pActor->SetProfileVisible( visible );
+
+	lua_pushboolean( L, visible );
+	return( 1 );
+}
+//--------------------------------------------------------------------------------
+int ConsoleActor::ToggleTrace( lua_State* L )
+{
+	ConsoleActor* pActor = static_cast<ConsoleActor*>( lua_touserdata( L, lua_upvalueindex( 1 ) ) );
+	Profiler& profiler = Profiler::Get();
+
+	if ( !profiler.IsCapturing() )
+	{
+		profiler.SetEnabled( true );
+		profiler.BeginCapture();
+
+		lua_pushstring( L, "capturing" );
+		return( 1 );
+	}
+
+	profiler.EndCapture();
+
+	if ( !pActor->IsProfileVisible() )
+		profiler.SetEnabled( false );
+
+	if ( profiler.WriteChromeTrace( L"ProfileTrace.json" ) )
+		lua_pushstring( L, "ProfileTrace.json" );
+	else
+		lua_pushstring( L, "unable to write ProfileTrace.json" );
+
+	return( 1 );
 }
 //--------------------------------------------------------------------------------
\ No newline at end of file
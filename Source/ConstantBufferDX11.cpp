@@ -13,7 +13,9 @@
 #include "ConstantBufferDX11.h"
 #include "PipelineManagerDX11.h"
 #include "IParameterManager.h"
+#include "ConstantBufferRingDX11.h"
 #include "Log.h"
+#include "Profiler.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
@@ -21,6 +23,11 @@ ConstantBufferDX11::ConstantBufferDX11( Microsoft::WRL::ComPtr<ID3D11Buffer> pBu
 {
 	m_pBuffer = pBuffer;
 	m_bAutoUpdate = true;
+
+	m_pRing = nullptr;
+	m_uiRingGeneration = 0;
+	m_uiFirstConstant = 0;
+	m_uiNumConstants = 0;
 }
 //--------------------------------------------------------------------------------
 ConstantBufferDX11::~ConstantBufferDX11()
@@ -45,6 +52,8 @@ void ConstantBufferDX11::EmptyMappings( )
 //--------------------------------------------------------------------------------
 void ConstantBufferDX11::EvaluateMappings( PipelineManagerDX11* pPipeline, IParameterManager* pParamManager )
 {
+	GLYPH_PROFILE_SCOPE( "ConstantBufferDX11::EvaluateMappings" );
+
 	// Test the index to ensure that it is a constant buffer.  If the method above returns
 	// a non-null result, then this is a constant buffer.
 	if ( m_pBuffer ) 
@@ -65,67 +74,96 @@ void ConstantBufferDX11::EvaluateMappings( PipelineManagerDX11* pPipeline, IPara
 				}
 			}
 
+			// Contents that were written into a ring are only valid until the ring
+			// discards its buffer, so they have to be written again after that.
+
+			ConstantBufferRingDX11* pRing = pPipeline->GetConstantBufferRing();
+
+			if ( pRing && ( m_pRing != pRing || m_uiRingGeneration != pRing->GetGeneration() ) )
+				doUpdate = true;
+
 			if ( doUpdate ) {
 
-				// Map the constant buffer into system memory.  We map the buffer 
-				// with the discard write flag since we don't care what was in the
-				// buffer already.
-
-				D3D11_MAPPED_SUBRESOURCE resource = 
-					pPipeline->MapResource( this, 0, D3D11_MAP_WRITE_DISCARD, 0 );
-
-				// Update each variable in the constant buffer.  These variables are identified
-				// by their type, and are currently allowed to be Vector4f, Matrix4f, or Matrix4f
-				// arrays.  Additional types will be added as they are needed...
-
-				for ( unsigned int j = 0; j < m_Mappings.size(); j++ )
-				{
-					RenderParameterDX11* pParam		= m_Mappings[j].pParameter;
-					unsigned int offset				= m_Mappings[j].offset;
-					unsigned int size				= m_Mappings[j].size;
-					unsigned int elements			= m_Mappings[j].elements;
-					unsigned int valueID			= m_Mappings[j].valueID;
-					unsigned int threadID			= pParamManager->GetID();
-
-
-					m_Mappings[j].valueID = pParam->GetValueID( threadID );
-
-					if ( m_Mappings[j].varclass == D3D_SVC_VECTOR )
-					{
-						Vector4f vector = pParamManager->GetVectorParameter( pParam );
-						Vector4f* pBuf = (Vector4f*)((char*)resource.pData + offset);
-						*pBuf = vector;
-					}
-					else if ( ( m_Mappings[j].varclass == D3D_SVC_MATRIX_ROWS ) ||
-						( m_Mappings[j].varclass == D3D_SVC_MATRIX_COLUMNS ) )
-					{
-						// Check if it is an array of matrices first...
-						if ( elements == 0 ) 
-						{
-							Matrix4f matrix = pParamManager->GetMatrixParameter( pParam );
-							Matrix4f* pBuf = (Matrix4f*)((char*)resource.pData + offset);
-							*pBuf = matrix;
-						}
-						else 
-						{
-							// If a matrix array, then use the corresponding parameter type.
-							if ( size == elements * sizeof( Matrix4f ) ) {
-								Matrix4f* pMatrices = pParamManager->GetMatrixArrayParameter( pParam );
-								memcpy( ((char*)resource.pData + offset), (char*)pMatrices, size );
-							} else {
-								Log::Get().Write( L"Mismatch in matrix array count, update will not be performed!!!" );
-							}
-						}
-					} else {
-						Log::Get().Write( L"Non vector or matrix parameter specified in a constant buffer!  This will not be updated!" );
-					}
+				// Write the contents linearly into the pipeline's ring if there is
+				// room for them.  Otherwise map the constant buffer itself with the
+				// discard write flag since we don't care what was in the buffer 
+				// already.
+
+				void* pData = nullptr;
+
+				if ( pRing ) {
+					pData = pRing->Map( pPipeline, GetByteWidth(), m_uiFirstConstant, m_uiNumConstants );
 				}
 
-				pPipeline->UnMapResource( this, 0 );
+				if ( pData ) {
+					m_pRing = pRing;
+					m_uiRingGeneration = pRing->GetGeneration();
+
+					WriteMappings( pData, pParamManager );
+					pRing->Unmap( pPipeline );
+				} else {
+					m_pRing = nullptr;
+
+					D3D11_MAPPED_SUBRESOURCE resource = 
+						pPipeline->MapResource( this, 0, D3D11_MAP_WRITE_DISCARD, 0 );
+
+					WriteMappings( resource.pData, pParamManager );
+					pPipeline->UnMapResource( this, 0 );
+				}
 			}
 		}
 	} else {
-		Log::Get().Write( L"Trying to update a constant buffer that isn't a constant buffer!" );
+		Log::Get().Write( L"Trying to update a constant buffer that isn't a constant buffer!", LOG_WARNING );
+	}
+}
+//--------------------------------------------------------------------------------
+void ConstantBufferDX11::WriteMappings( void* pData, IParameterManager* pParamManager )
+{
+	// Update each variable in the constant buffer.  These variables are identified
+	// by their type, and are currently allowed to be Vector4f, Matrix4f, or Matrix4f
+	// arrays.  Additional types will be added as they are needed...
+
+	for ( unsigned int j = 0; j < m_Mappings.size(); j++ )
+	{
+		RenderParameterDX11* pParam		= m_Mappings[j].pParameter;
+		unsigned int offset				= m_Mappings[j].offset;
+		unsigned int size				= m_Mappings[j].size;
+		unsigned int elements			= m_Mappings[j].elements;
+		unsigned int valueID			= m_Mappings[j].valueID;
+		unsigned int threadID			= pParamManager->GetID();
+
+
+		m_Mappings[j].valueID = pParam->GetValueID( threadID );
+
+		if ( m_Mappings[j].varclass == D3D_SVC_VECTOR )
+		{
+			Vector4f vector = pParamManager->GetVectorParameter( pParam );
+			Vector4f* pBuf = (Vector4f*)((char*)pData + offset);
+			*pBuf = vector;
+		}
+		else if ( ( m_Mappings[j].varclass == D3D_SVC_MATRIX_ROWS ) ||
+			( m_Mappings[j].varclass == D3D_SVC_MATRIX_COLUMNS ) )
+		{
+			// Check if it is an array of matrices first...
+			if ( elements == 0 ) 
+			{
+				Matrix4f matrix = pParamManager->GetMatrixParameter( pParam );
+				Matrix4f* pBuf = (Matrix4f*)((char*)pData + offset);
+				*pBuf = matrix;
+			}
+			else 
+			{
+				// If a matrix array, then use the corresponding parameter type.
+				if ( size == elements * sizeof( Matrix4f ) ) {
+					Matrix4f* pMatrices = pParamManager->GetMatrixArrayParameter( pParam );
+					memcpy( ((char*)pData + offset), (char*)pMatrices, size );
+				} else {
+					Log::Get().Write( L"Mismatch in matrix array count, update will not be performed!!!", LOG_WARNING );
+				}
+			}
+		} else {
+			Log::Get().Write( L"Non vector or matrix parameter specified in a constant buffer!  This will not be updated!", LOG_WARNING );
+		}
 	}
 }
 //--------------------------------------------------------------------------------
@@ -161,4 +199,16 @@ bool ConstantBufferDX11::GetAutoUpdate()
 {
 	return( m_bAutoUpdate );
 }
-//--------------------------------------------------------------------------------
\ No newline at end of file
+//--------------------------------------------------------------------------------
+bool ConstantBufferDX11::GetRingLocation( ConstantBufferRingDX11* pRing, ID3D11Buffer*& pBuffer, UINT& firstConstant, UINT& numConstants )
+{
+	if ( pRing == nullptr || m_pRing != pRing || m_uiRingGeneration != pRing->GetGeneration() )
+		return( false );
+
+	pBuffer = pRing->GetBuffer();
+	firstConstant = m_uiFirstConstant;
+	numConstants = m_uiNumConstants;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,117 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "ConstantBufferRingDX11.h"
+#include "PipelineManagerDX11.h"
+#include "RendererDX11.h"
+#include "BufferConfigDX11.h"
+#include "ResourceDX11.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+ConstantBufferRingDX11::ConstantBufferRingDX11( unsigned int capacity ) :
+	m_Allocator( ( capacity / Alignment ) * Alignment, Alignment ),
+	m_Buffer( nullptr ),
+	m_uiGeneration( 1 ),
+	m_bDiscard( true )
+{
+	// The ring is filled manually, so it doesn't use the automatic updates of
+	// the constant buffer class.
+
+	BufferConfigDX11 config;
+	config.SetDefaultConstantBuffer( m_Allocator.GetCapacity(), true );
+	m_Buffer = RendererDX11::Get()->CreateConstantBuffer( &config, nullptr, false );
+}
+//--------------------------------------------------------------------------------
+ConstantBufferRingDX11::~ConstantBufferRingDX11()
+{
+	if ( nullptr != m_Buffer ) {
+		RendererDX11::Get()->DeleteResource( m_Buffer );
+		m_Buffer = nullptr;
+	}
+}
+//--------------------------------------------------------------------------------
+void* ConstantBufferRingDX11::Map( PipelineManagerDX11* pPipeline, unsigned int size, UINT& firstConstant, UINT& numConstants )
+{
+	unsigned int offset = 0;
+
+	if ( m_Buffer == nullptr || !m_Allocator.Allocate( size, offset ) )
+		return( nullptr );
+
+	const unsigned int aligned = ( ( size + Alignment - 1 ) / Alignment ) * Alignment;
+
+	// The ring never overwrites the space of a frame that hasn't been retired,
+	// so it can be mapped without discarding it.  Only a deferred context needs
+	// to discard it first in each command list.
+
+	D3D11_MAP actions = D3D11_MAP_WRITE_NO_OVERWRITE;
+
+	if ( m_bDiscard ) {
+		actions = D3D11_MAP_WRITE_DISCARD;
+		m_bDiscard = false;
+	}
+
+	D3D11_MAPPED_SUBRESOURCE resource = pPipeline->MapResource( m_Buffer, 0, actions, 0 );
+
+	if ( resource.pData == nullptr )
+		return( nullptr );
+
+	firstConstant = offset / 16;
+	numConstants = aligned / 16;
+
+	return( static_cast<char*>( resource.pData ) + offset );
+}
+//--------------------------------------------------------------------------------
+void ConstantBufferRingDX11::Unmap( PipelineManagerDX11* pPipeline )
+{
+	pPipeline->UnMapResource( m_Buffer, 0 );
+}
+//--------------------------------------------------------------------------------
+void ConstantBufferRingDX11::BeginFrame( unsigned long long frame )
+{
+	m_Allocator.BeginFrame( frame );
+
+	// The space of an older frame may be reused without a discard, so anything
+	// written before this frame has to be written again.
+
+	m_uiGeneration++;
+}
+//--------------------------------------------------------------------------------
+void ConstantBufferRingDX11::RetireFrames( unsigned long long frame )
+{
+	m_Allocator.RetireFrames( frame );
+}
+//--------------------------------------------------------------------------------
+void ConstantBufferRingDX11::RequireDiscard( )
+{
+	m_bDiscard = true;
+	m_uiGeneration++;
+}
+//--------------------------------------------------------------------------------
+ID3D11Buffer* ConstantBufferRingDX11::GetBuffer( )
+{
+	if ( m_Buffer == nullptr )
+		return( nullptr );
+
+	ResourceDX11* pResource = RendererDX11::Get()->GetResourceByIndex( m_Buffer->m_iResource );
+
+	if ( pResource == nullptr )
+		return( nullptr );
+
+	return( static_cast<ID3D11Buffer*>( pResource->GetResource() ) );
+}
+//--------------------------------------------------------------------------------
+unsigned int ConstantBufferRingDX11::GetGeneration( ) const
+{
+	return( m_uiGeneration );
+}
+//--------------------------------------------------------------------------------
@@ -77,11 +77,13 @@ Node3D* Entity3D::GetParent()
 void Entity3D::AttachParent( Node3D* Parent )
 {
 	m_pParent = Parent;
+	Transform.MakeDirty();
 }
 //--------------------------------------------------------------------------------
 void Entity3D::DetachParent( )
 {
 	m_pParent = nullptr;
+	Transform.MakeDirty();
 }
 //--------------------------------------------------------------------------------
 void Entity3D::Update( float time )
@@ -111,7 +113,7 @@ void Entity3D::UpdateWorld( )
 	// If the entity has a parent, then update its world matrix accordingly.
 
 	if (m_pParent)
-		Transform.UpdateWorld( m_pParent->Transform.WorldMatrix() );
+		Transform.UpdateWorld( m_pParent->Transform );
 	else
 		Transform.UpdateWorld( );
 }
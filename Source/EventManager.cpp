@@ -17,10 +17,27 @@ using namespace Glyph3;
 //--------------------------------------------------------------------------------
 EventManager* EventManager::m_spEventManager = 0;
 //--------------------------------------------------------------------------------
-EventManager::EventManager()
+EventManager::EventManager( unsigned int uiQueueCapacity )
 {
 	if ( !m_spEventManager )
 		m_spEventManager = this;
+
+	// Round the capacity up to a power of two so that the slot index can be
+	// found with a mask.  Each slot starts out free for the producer whose
+	// position matches its index.
+
+	unsigned int capacity = 2;
+	while ( capacity < uiQueueCapacity )
+		capacity <<= 1;
+
+	m_pEventQueue = new QueueSlot[capacity];
+	m_uiQueueMask = capacity - 1;
+
+	for ( unsigned int i = 0; i < capacity; i++ )
+		m_pEventQueue[i].Sequence.store( i, std::memory_order_relaxed );
+
+	m_uiQueueTail.store( 0, std::memory_order_relaxed );
+	m_uiQueueHead = 0;
 }
 //--------------------------------------------------------------------------------
 EventManager::~EventManager()
@@ -32,6 +49,10 @@ EventManager::~EventManager()
 			m_EventHandlers[e][i]->SetEventManager( nullptr );
 		}
 	}
+
+	// Any events that are still queued are released with the queue.
+
+	delete [] m_pEventQueue;
 }
 //--------------------------------------------------------------------------------
 EventManager* EventManager::Get()
@@ -96,17 +117,72 @@ bool EventManager::ProcessEvent( EventPtr pEvent )
 //--------------------------------------------------------------------------------
 bool EventManager::QueueEvent( EventPtr pEvent )
 {
-	// TODO: Events are currently not queued - they are handled immediately after
-	//       sending them.  This will need to be addressed in the future...
+	if ( !pEvent )
+		return( false );
+
+	// Claim the slot at the tail of the queue.  A slot is free for the producer
+	// at position 'pos' when its sequence equals 'pos', and if the sequence is
+	// behind then the consumer hasn't released it yet and the queue is full.
+
+	unsigned int pos = m_uiQueueTail.load( std::memory_order_relaxed );
+	QueueSlot* pSlot = nullptr;
+
+	while ( true )
+	{
+		pSlot = &m_pEventQueue[pos & m_uiQueueMask];
+		unsigned int seq = pSlot->Sequence.load( std::memory_order_acquire );
+		int diff = static_cast<int>( seq - pos );
+
+		if ( diff == 0 ) {
+			if ( m_uiQueueTail.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+				break;
+		} else if ( diff < 0 ) {
+			return( false );
+		} else {
+			pos = m_uiQueueTail.load( std::memory_order_relaxed );
+		}
+	}
+
+	// The slot is now owned by this thread until it is published to the
+	// consumer by advancing its sequence.
+
+	pSlot->pEvent = pEvent;
+	pSlot->Sequence.store( pos + 1, std::memory_order_release );
 
 	return( true );
 }
 //--------------------------------------------------------------------------------
-bool EventManager::ProcessEventQueue( )
+bool EventManager::ProcessEventQueue( unsigned int uiMaxEvents )
 {
-	// TODO: Events are currently not queued - they are handled immediately after
-	//       sending them.  This will need to be addressed in the future...
+	// Only events that were queued before this call started are processed, so
+	// that listeners which queue new events can't keep the loop running.
 
-	return( true );
+	const unsigned int end = m_uiQueueTail.load( std::memory_order_acquire );
+	unsigned int count = 0;
+
+	while ( m_uiQueueHead != end && count < uiMaxEvents )
+	{
+		QueueSlot* pSlot = &m_pEventQueue[m_uiQueueHead & m_uiQueueMask];
+		unsigned int seq = pSlot->Sequence.load( std::memory_order_acquire );
+
+		// The slot has been claimed but the producer hasn't finished writing
+		// it yet.  Stop here to keep the events in order.
+
+		if ( static_cast<int>( seq - ( m_uiQueueHead + 1 ) ) < 0 )
+			break;
+
+		EventPtr pEvent = pSlot->pEvent;
+		pSlot->pEvent.reset();
+
+		// Release the slot for the producer one lap ahead.
+
+		pSlot->Sequence.store( m_uiQueueHead + m_uiQueueMask + 1, std::memory_order_release );
+		m_uiQueueHead++;
+		count++;
+
+		ProcessEvent( pEvent );
+	}
+
+	return( m_uiQueueHead == m_uiQueueTail.load( std::memory_order_acquire ) );
 }
 //--------------------------------------------------------------------------------
@@ -20,6 +20,7 @@ std::wstring FileSystem::sModelsSubFolder = L"Models/";
 std::wstring FileSystem::sScriptsSubFolder = L"Scripts/";
 std::wstring FileSystem::sShaderSubFolder = L"Shaders/";
 std::wstring FileSystem::sTextureSubFolder = L"Textures/";
+std::wstring FileSystem::sCacheFolder = L"";
 //--------------------------------------------------------------------------------
 FileSystem::FileSystem()
 {
@@ -81,6 +82,27 @@ std::wstring FileSystem::GetLogFolder( )
 	return( result );
 }
 //--------------------------------------------------------------------------------
+std::wstring FileSystem::GetCacheFolder( )
+{
+	std::wstring folder = sCacheFolder;
+
+	if ( folder.empty() )
+		folder = GetLogFolder() + L"\\Hieroglyph3\\Cache\\";
+
+	// SHCreateDirectoryEx needs a full path, and creates any missing parents.
+	wchar_t buffer[MAX_PATH];
+
+	if ( GetFullPathNameW( folder.c_str(), MAX_PATH, buffer, nullptr ) != 0 )
+		SHCreateDirectoryExW( nullptr, buffer, nullptr );
+
+	return( folder );
+}
+//--------------------------------------------------------------------------------
+void FileSystem::SetCacheFolder( const std::wstring& folder )
+{
+	sCacheFolder = folder;
+}
+//--------------------------------------------------------------------------------
 std::wstring FileSystem::GetDataFolder()
 {
 	return( sDataFolder );
@@ -11,6 +11,9 @@
 //--------------------------------------------------------------------------------
 #include "PCH.h"
 #include "Frustum3f.h"
+#if GLYPH_SSE_MATH
+#include <xmmintrin.h>
+#endif
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
@@ -163,3 +166,46 @@ bool Frustum3f::Envelops( const Sphere3f& bounds ) const
 	return( true );
 }
 //--------------------------------------------------------------------------------
+void Frustum3f::Intersects( const Sphere3f* pSpheres, unsigned int count, bool* pResults ) const
+{
+	unsigned int i = 0;
+
+#if GLYPH_SSE_MATH
+	// Transpose four spheres into separate x, y, z and radius registers, and
+	// then test all four against one plane at a time.  A sphere is outside as
+	// soon as its signed distance plus its radius is negative for any plane.
+
+	for ( ; i + 4 <= count; i += 4 )
+	{
+		const Sphere3f* p = pSpheres + i;
+
+		const __m128 x = _mm_setr_ps( p[0].center.x, p[1].center.x, p[2].center.x, p[3].center.x );
+		const __m128 y = _mm_setr_ps( p[0].center.y, p[1].center.y, p[2].center.y, p[3].center.y );
+		const __m128 z = _mm_setr_ps( p[0].center.z, p[1].center.z, p[2].center.z, p[3].center.z );
+		const __m128 r = _mm_setr_ps( p[0].radius, p[1].radius, p[2].radius, p[3].radius );
+
+		__m128 outside = _mm_setzero_ps();
+
+		for ( int j = 0; j < 6; j++ )
+		{
+			__m128 distance = _mm_mul_ps( x, _mm_set1_ps( planes[j].a ) );
+			distance = _mm_add_ps( distance, _mm_mul_ps( y, _mm_set1_ps( planes[j].b ) ) );
+			distance = _mm_add_ps( distance, _mm_mul_ps( z, _mm_set1_ps( planes[j].c ) ) );
+			distance = _mm_add_ps( _mm_add_ps( distance, _mm_set1_ps( planes[j].d ) ), r );
+
+			outside = _mm_or_ps( outside, _mm_cmplt_ps( distance, _mm_setzero_ps() ) );
+		}
+
+		const int mask = _mm_movemask_ps( outside );
+
+		pResults[i + 0] = ( mask & 1 ) == 0;
+		pResults[i + 1] = ( mask & 2 ) == 0;
+		pResults[i + 2] = ( mask & 4 ) == 0;
+		pResults[i + 3] = ( mask & 8 ) == 0;
+	}
+#endif
+
+	for ( ; i < count; i++ )
+		pResults[i] = Intersects( pSpheres[i] );
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,266 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "GeometryCacheDX11.h"
+#include "FileSystem.h"
+#include "MemoryMappedFile.h"
+#include "Log.h"
+#include <fstream>
+#include <mutex>
+#include <set>
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+static const char CacheID[4] = { 'G', '3', 'G', 'C' };
+static const unsigned int CacheVersion = 3;
+//--------------------------------------------------------------------------------
+bool GeometryCacheDX11::sbEnabled = true;
+//--------------------------------------------------------------------------------
+// The cache files that are being written at the moment.  Two loads of the same
+// model can finish parsing at the same time, for example when it is streamed by
+// two requests, and only the first of them writes the cache.
+//--------------------------------------------------------------------------------
+static std::mutex WriteLock;
+static std::set<std::wstring> WritesInProgress;
+//--------------------------------------------------------------------------------
+GeometryCacheDX11::GeometryCacheDX11()
+{
+}
+//--------------------------------------------------------------------------------
+void GeometryCacheDX11::SetEnabled( bool bEnabled )
+{
+	sbEnabled = bEnabled;
+}
+//--------------------------------------------------------------------------------
+bool GeometryCacheDX11::IsEnabled( )
+{
+	return( sbEnabled );
+}
+//--------------------------------------------------------------------------------
+std::wstring GeometryCacheDX11::GetCacheFilename( const std::wstring& source )
+{
+	// Models with the same name in different folders get their own cache, so
+	// the name is made unique with an FNV-1a hash of the full path.  Paths are
+	// not case sensitive, so they are hashed in lower case.
+
+	wchar_t buffer[MAX_PATH];
+	std::wstring path = source;
+
+	if ( GetFullPathNameW( source.c_str(), MAX_PATH, buffer, nullptr ) != 0 )
+		path = buffer;
+
+	unsigned long long hash = 14695981039346656037ULL;
+
+	for ( auto c : path ) {
+		hash ^= static_cast<unsigned long long>( towlower( c == L'/' ? L'\\' : c ) );
+		hash *= 1099511628211ULL;
+	}
+
+	const size_t separator = path.find_last_of( L"/\\" );
+	const std::wstring name = ( separator == std::wstring::npos ) ? path : path.substr( separator + 1 );
+
+	wchar_t suffix[32];
+	swprintf_s( suffix, L"-%016llx.g3geo", hash );
+
+	FileSystem fs;
+	return( fs.GetCacheFolder() + name + suffix );
+}
+//--------------------------------------------------------------------------------
+bool GeometryCacheDX11::IsCacheValid( const std::wstring& source, const std::wstring& cache )
+{
+	if ( !sbEnabled )
+		return( false );
+
+	FileSystem fs;
+
+	if ( !fs.FileExists( cache ) || !fs.FileExists( source ) )
+		return( false );
+
+	return( fs.FileIsNewer( cache, source ) );
+}
+//--------------------------------------------------------------------------------
+bool GeometryCacheDX11::Write( GeometryPtr pGeometry, const std::wstring& filename )
+{
+	if ( !sbEnabled || !pGeometry )
+		return( false );
+
+	{
+		std::lock_guard<std::mutex> lock( WriteLock );
+
+		if ( !WritesInProgress.insert( filename ).second )
+			return( false );
+	}
+
+	// The file is written under a temporary name and then renamed, so that a
+	// load which checks the cache in the meantime never maps a partial file.
+	// Renaming fails while an old cache is mapped by a reader, in which case
+	// the cache is written again by a later load.
+
+	const std::wstring temporary = filename + L".tmp";
+
+	bool bWritten = WriteContents( pGeometry, temporary );
+
+	if ( bWritten )
+		bWritten = MoveFileExW( temporary.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING ) != FALSE;
+
+	if ( !bWritten )
+		DeleteFileW( temporary.c_str() );
+
+	std::lock_guard<std::mutex> lock( WriteLock );
+	WritesInProgress.erase( filename );
+
+	return( bWritten );
+}
+//--------------------------------------------------------------------------------
+bool GeometryCacheDX11::WriteContents( GeometryPtr pGeometry, const std::wstring& filename )
+{
+	FileHeader header;
+	memcpy( header.id, CacheID, sizeof( CacheID ) );
+	header.version = CacheVersion;
+	header.topology = static_cast<unsigned int>( pGeometry->m_ePrimType );
+	header.elementCount = static_cast<unsigned int>( pGeometry->m_vElements.size() );
+	header.indexCount = static_cast<unsigned int>( pGeometry->m_vIndices.size() );
+
+	std::vector<ElementHeader> elements( header.elementCount );
+
+	for ( unsigned int i = 0; i < header.elementCount; i++ )
+	{
+		VertexElementDX11* pElement = pGeometry->m_vElements[i];
+		ElementHeader& desc = elements[i];
+
+		if ( pElement->m_SemanticName.size() >= sizeof( desc.semantic ) ) {
+			Log::Get().Write( L"Geometry cache can't store a semantic name this long!" );
+			return( false );
+		}
+
+		memset( desc.semantic, 0, sizeof( desc.semantic ) );
+		memcpy( desc.semantic, pElement->m_SemanticName.c_str(), pElement->m_SemanticName.size() );
+		desc.semanticIndex = pElement->m_uiSemanticIndex;
+		desc.format = static_cast<unsigned int>( pElement->m_Format );
+		desc.inputSlot = pElement->m_uiInputSlot;
+		desc.alignedByteOffset = pElement->m_uiAlignedByteOffset;
+		desc.inputSlotClass = static_cast<unsigned int>( pElement->m_InputSlotClass );
+		desc.instanceDataStepRate = pElement->m_uiInstanceDataStepRate;
+		desc.packing = static_cast<unsigned int>( pElement->m_Packing );
+		desc.tuple = pElement->Tuple();
+		desc.count = pElement->Count();
+	}
+
+	std::ofstream output( filename.c_str(), std::ios::binary | std::ios::trunc );
+
+	if ( !output.is_open() )
+		return( false );
+
+	output.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+
+	if ( header.elementCount > 0 )
+		output.write( reinterpret_cast<const char*>( &elements[0] ), sizeof( ElementHeader ) * header.elementCount );
+
+	for ( unsigned int i = 0; i < header.elementCount; i++ )
+	{
+		VertexElementDX11* pElement = pGeometry->m_vElements[i];
+		output.write( reinterpret_cast<const char*>( pElement->GetPtr( 0 ) ), sizeof( float ) * elements[i].tuple * elements[i].count );
+	}
+
+	if ( header.indexCount > 0 )
+		output.write( reinterpret_cast<const char*>( &pGeometry->m_vIndices[0] ), sizeof( UINT ) * header.indexCount );
+
+	output.close();
+
+	return( !output.fail() );
+}
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryCacheDX11::Read( const std::wstring& filename )
+{
+	// Map the whole file into memory, which lets the vertex data be copied
+	// straight from the file cache into the vertex elements.
+
+	MemoryMappedFile file;
+
+	if ( !file.Open( filename ) )
+		return( nullptr );
+
+	return( ReadFromMemory( file.GetData(), file.GetSize(), filename ) );
+}
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryCacheDX11::ReadFromMemory( const unsigned char* pData, size_t size, const std::wstring& name )
+{
+	GeometryPtr pGeometry = nullptr;
+
+	if ( size >= sizeof( FileHeader ) )
+	{
+		const FileHeader* pHeader = reinterpret_cast<const FileHeader*>( pData );
+
+		// Validate the header and the size of every section before using them.
+
+		bool bValid = ( memcmp( pHeader->id, CacheID, sizeof( CacheID ) ) == 0 )
+			&& ( pHeader->version == CacheVersion );
+
+		size_t offset = sizeof( FileHeader );
+		const ElementHeader* pElements = reinterpret_cast<const ElementHeader*>( pData + offset );
+
+		if ( bValid ) {
+			bValid = ( size - offset ) / sizeof( ElementHeader ) >= pHeader->elementCount;
+			offset += sizeof( ElementHeader ) * pHeader->elementCount;
+		}
+
+		for ( unsigned int i = 0; bValid && i < pHeader->elementCount; i++ )
+		{
+			const size_t bytes = sizeof( float ) * static_cast<size_t>( pElements[i].tuple ) * pElements[i].count;
+			bValid = ( pElements[i].tuple >= 1 ) && ( pElements[i].tuple <= 4 ) && ( bytes <= size - offset )
+				&& ( pElements[i].packing <= static_cast<unsigned int>( VertexPacking::SInt8 ) );
+			offset += bytes;
+		}
+
+		if ( bValid )
+			bValid = ( size - offset ) / sizeof( UINT ) >= pHeader->indexCount;
+
+		if ( bValid )
+		{
+			pGeometry = GeometryPtr( new GeometryDX11() );
+			offset = sizeof( FileHeader ) + sizeof( ElementHeader ) * pHeader->elementCount;
+
+			for ( unsigned int i = 0; i < pHeader->elementCount; i++ )
+			{
+				const ElementHeader& desc = pElements[i];
+				VertexElementDX11* pElement = new VertexElementDX11( desc.tuple, desc.count );
+
+				pElement->m_SemanticName = std::string( desc.semantic, strnlen( desc.semantic, sizeof( desc.semantic ) ) );
+				pElement->m_uiSemanticIndex = desc.semanticIndex;
+				pElement->m_Format = static_cast<DXGI_FORMAT>( desc.format );
+				pElement->m_uiInputSlot = desc.inputSlot;
+				pElement->m_uiAlignedByteOffset = desc.alignedByteOffset;
+				pElement->m_InputSlotClass = static_cast<D3D11_INPUT_CLASSIFICATION>( desc.inputSlotClass );
+				pElement->m_uiInstanceDataStepRate = desc.instanceDataStepRate;
+				pElement->m_Packing = static_cast<VertexPacking>( desc.packing );
+
+				const size_t bytes = sizeof( float ) * desc.tuple * desc.count;
+				memcpy( pElement->GetPtr( 0 ), pData + offset, bytes );
+				offset += bytes;
+
+				pGeometry->AddElement( pElement );
+			}
+
+			const UINT* pIndices = reinterpret_cast<const UINT*>( pData + offset );
+			pGeometry->m_vIndices.assign( pIndices, pIndices + pHeader->indexCount );
+			pGeometry->SetPrimitiveType( static_cast<D3D11_PRIMITIVE_TOPOLOGY>( pHeader->topology ) );
+		}
+		else
+		{
+			std::wstring message = L"Ignoring invalid geometry cache file: " + name;
+			Log::Get().Write( message );
+		}
+	}
+
+	return( pGeometry );
+}
+//--------------------------------------------------------------------------------
@@ -17,9 +17,42 @@
 #include "Log.h"
 #include "GlyphString.h"
 #include "PipelineManagerDX11.h"
+#include "Matrix4f.h"
+#include "JobSystem.h"
+#include "Profiler.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
+static const unsigned int AdjacencyGrain = 4096;
+static const unsigned long long EmptyEdgeKey = ~0ULL;
+static const unsigned int NoEdge = ~0U;
+//--------------------------------------------------------------------------------
+struct EdgeSlot
+{
+	std::atomic<unsigned long long>	key;
+	std::atomic<unsigned int>		first;
+};
+//--------------------------------------------------------------------------------
+template <typename F>
+static void ForEachRange( unsigned int count, const F& func )
+{
+	JobSystem* pJobs = JobSystem::Get();
+
+	if ( pJobs )
+		pJobs->ParallelFor( count, AdjacencyGrain, func );
+	else
+		func( 0, count );
+}
+//--------------------------------------------------------------------------------
+static inline unsigned int HashEdgeKey( unsigned long long key )
+{
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+
+	return( static_cast<unsigned int>( key ) );
+}
+//--------------------------------------------------------------------------------
 GeometryDX11::GeometryDX11( )
 {
 	m_iVertexSize = 0;
@@ -31,6 +64,9 @@ GeometryDX11::GeometryDX11( )
 //--------------------------------------------------------------------------------
 GeometryDX11::~GeometryDX11()
 {
+	for ( auto& layout : m_InstancedInputLayouts )
+		SAFE_DELETE( layout.second );
+
 	for ( auto pElement : m_vElements )
 	{
 		if ( pElement != nullptr )
@@ -263,7 +299,7 @@ int GeometryDX11::CalculateVertexSize()
 
 	// Loop through the elements and add their per-vertex size
 	for ( auto pElement : m_vElements )
-		m_iVertexSize += pElement->SizeInBytes();
+		m_iVertexSize += VertexPackerDX11::GetSize( pElement, pElement->m_Packing );
 
 	return( m_iVertexSize );
 }
@@ -313,21 +349,7 @@ void GeometryDX11::GenerateInputLayout( int ShaderID )
 
 		// Allocate the necessary number of element descriptions
 		std::vector<D3D11_INPUT_ELEMENT_DESC> elements;
-
-		// Fill in the vertex element descriptions based on each element
-		for ( unsigned int i = 0; i < m_vElements.size(); i++ )
-		{
-			D3D11_INPUT_ELEMENT_DESC e;
-			e.SemanticName = m_vElements[i]->m_SemanticName.c_str();
-			e.SemanticIndex = m_vElements[i]->m_uiSemanticIndex;
-			e.Format = m_vElements[i]->m_Format;
-			e.InputSlot = m_vElements[i]->m_uiInputSlot;
-			e.AlignedByteOffset = m_vElements[i]->m_uiAlignedByteOffset;
-			e.InputSlotClass = m_vElements[i]->m_InputSlotClass;
-			e.InstanceDataStepRate = m_vElements[i]->m_uiInstanceDataStepRate;
-			
-			elements.push_back( e );
-		}
+		GetLayoutElements( elements );
 
 		// Create the input layout for the given shader index
 
@@ -342,11 +364,120 @@ void GeometryDX11::GenerateInputLayout( int ShaderID )
 	}
 }
 //--------------------------------------------------------------------------------
+void GeometryDX11::GetLayoutElements( std::vector<D3D11_INPUT_ELEMENT_DESC>& elements )
+{
+	// Packed elements change the size of the elements that follow them, so
+	// the offsets are taken from the interleaved layout in that case.
+	bool bPacked = false;
+	for ( auto pElement : m_vElements )
+		bPacked = bPacked || ( pElement->m_Packing != VertexPacking::None );
+
+	UINT offset = 0;
+
+	// Fill in the vertex element descriptions based on each element
+	for ( unsigned int i = 0; i < m_vElements.size(); i++ )
+	{
+		VertexPacking packing = m_vElements[i]->m_Packing;
+
+		D3D11_INPUT_ELEMENT_DESC e;
+		e.SemanticName = m_vElements[i]->m_SemanticName.c_str();
+		e.SemanticIndex = m_vElements[i]->m_uiSemanticIndex;
+		e.Format = VertexPackerDX11::GetFormat( m_vElements[i], packing );
+		e.InputSlot = m_vElements[i]->m_uiInputSlot;
+		e.AlignedByteOffset = bPacked ? offset : m_vElements[i]->m_uiAlignedByteOffset;
+		e.InputSlotClass = m_vElements[i]->m_InputSlotClass;
+		e.InstanceDataStepRate = m_vElements[i]->m_uiInstanceDataStepRate;
+		
+		elements.push_back( e );
+
+		offset += VertexPackerDX11::GetSize( m_vElements[i], packing );
+	}
+}
+//--------------------------------------------------------------------------------
+int GeometryDX11::GetInstancedInputLayout( int ShaderID )
+{
+	InputLayoutKey*& pKey = m_InstancedInputLayouts[ShaderID];
+
+	if ( pKey == nullptr )
+	{
+		// The vertex elements are followed by the rows of the instance world
+		// matrix, which advance once per instance in the second vertex buffer.
+
+		std::vector<D3D11_INPUT_ELEMENT_DESC> elements;
+		GetLayoutElements( elements );
+
+		for ( UINT row = 0; row < 4; row++ )
+		{
+			D3D11_INPUT_ELEMENT_DESC e;
+			e.SemanticName = "INSTANCE_WORLD";
+			e.SemanticIndex = row;
+			e.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+			e.InputSlot = 1;
+			e.AlignedByteOffset = row * 16;
+			e.InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+			e.InstanceDataStepRate = 1;
+
+			elements.push_back( e );
+		}
+
+		pKey = new InputLayoutKey();
+		pKey->shader = ShaderID;
+		pKey->layout = RendererDX11::Get()->CreateInputLayout( elements, ShaderID );
+	}
+
+	return( pKey->layout );
+}
+//--------------------------------------------------------------------------------
+bool GeometryDX11::SupportsInstancing( )
+{
+	return( m_VB != nullptr && m_IB != nullptr );
+}
+//--------------------------------------------------------------------------------
+void GeometryDX11::ExecuteInstanced( PipelineManagerDX11* pPipeline, IParameterManager* pParamManager,
+	int instances, UINT start, UINT count )
+{
+	pPipeline->InputAssemblerStage.ClearDesiredState();
+
+	// Set the Input Assembler state, with the instance matrices in slot 1, and
+	// then draw all of the instances at once.
+	int layout = GetInstancedInputLayout( pPipeline->ShaderStages[VERTEX_SHADER]->DesiredState.ShaderProgram.GetState() );
+	pPipeline->InputAssemblerStage.DesiredState.InputLayout.SetState( layout );
+	pPipeline->InputAssemblerStage.DesiredState.PrimitiveTopology.SetState( m_ePrimType );
+
+	pPipeline->InputAssemblerStage.DesiredState.VertexBuffers.SetState( 0, m_VB->m_iResource );
+	pPipeline->InputAssemblerStage.DesiredState.VertexBufferStrides.SetState( 0, m_iVertexSize );
+	pPipeline->InputAssemblerStage.DesiredState.VertexBufferOffsets.SetState( 0, 0 );
+
+	pPipeline->InputAssemblerStage.DesiredState.VertexBuffers.SetState( 1, instances );
+	pPipeline->InputAssemblerStage.DesiredState.VertexBufferStrides.SetState( 1, sizeof( Matrix4f ) );
+	pPipeline->InputAssemblerStage.DesiredState.VertexBufferOffsets.SetState( 1, 0 );
+
+	pPipeline->InputAssemblerStage.DesiredState.IndexBuffer.SetState( m_IB->m_iResource );
+	pPipeline->InputAssemblerStage.DesiredState.IndexBufferFormat.SetState( DXGI_FORMAT_R32_UINT );
+
+	pPipeline->ApplyInputResources();
+
+	pPipeline->DrawIndexedInstanced( GetIndexCount(), count, 0, 0, start );
+}
+//--------------------------------------------------------------------------------
 void GeometryDX11::LoadToBuffers()
 {
 	// Check the number of vertices to be created
 	CalculateVertexCount();
 
+	// Elements whose data doesn't fit their packing are stored as floats.
+	for ( auto pElement : m_vElements )
+	{
+		if ( !VertexPackerDX11::CanPack( pElement, pElement->m_Packing ) )
+		{
+			std::wstring message = L"Vertex element " + GlyphString::ToUnicode( pElement->m_SemanticName ) + L" can't be packed, using its original format.";
+			Log::Get().Write( message );
+
+			pElement->m_Packing = VertexPacking::None;
+			ReleaseInputLayouts();
+		}
+	}
+
 	// Check the size of the assembled vertices
 	CalculateVertexSize();
 
@@ -362,8 +493,9 @@ void GeometryDX11::LoadToBuffers()
 			int iElemOffset = 0;
 			for ( unsigned int i = 0; i < m_vElements.size(); i++ )
 			{
-				memcpy( pBytes + j * m_iVertexSize + iElemOffset, m_vElements[i]->GetPtr(j), m_vElements[i]->SizeInBytes() );
-				iElemOffset += m_vElements[i]->SizeInBytes();
+				VertexPacking packing = m_vElements[i]->m_Packing;
+				VertexPackerDX11::Pack( m_vElements[i], packing, j, pBytes + j * m_iVertexSize + iElemOffset );
+				iElemOffset += VertexPackerDX11::GetSize( m_vElements[i], packing );
 			}
 		}
 
@@ -391,6 +523,37 @@ void GeometryDX11::LoadToBuffers()
 	m_IB = RendererDX11::Get()->CreateIndexBuffer( &ibuffer, &data );
 }
 //--------------------------------------------------------------------------------
+void GeometryDX11::SetPacking( std::string semantic, VertexPacking packing )
+{
+	VertexElementDX11* pElement = GetElement( semantic );
+
+	if ( pElement != nullptr && pElement->m_Packing != packing )
+	{
+		pElement->m_Packing = packing;
+		ReleaseInputLayouts();
+	}
+}
+//--------------------------------------------------------------------------------
+void GeometryDX11::SetDefaultPacking( )
+{
+	for ( auto pElement : m_vElements )
+		SetPacking( pElement->m_SemanticName, VertexPackerDX11::GetDefaultPacking( pElement->m_SemanticName ) );
+}
+//--------------------------------------------------------------------------------
+void GeometryDX11::ReleaseInputLayouts( )
+{
+	// The layouts are regenerated for the new vertex format the next time that
+	// the geometry is drawn.
+	for ( auto& layout : m_InputLayouts )
+		SAFE_DELETE( layout.second );
+
+	for ( auto& layout : m_InstancedInputLayouts )
+		SAFE_DELETE( layout.second );
+
+	m_InputLayouts.clear();
+	m_InstancedInputLayouts.clear();
+}
+//--------------------------------------------------------------------------------
 UINT GeometryDX11::GetIndexCount()
 {
 	return( m_vIndices.size() );
@@ -523,3 +686,170 @@ bool GeometryDX11::ComputeTangentFrame( std::string positionSemantic,
     return true;
 }
 //--------------------------------------------------------------------------------
+bool GeometryDX11::GenerateAdjacency( AdjacencyLayout layout )
+{
+	if ( m_ePrimType != D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST )
+		return( false );
+
+	const unsigned int triangles = static_cast<unsigned int>( m_vIndices.size() / 3 );
+
+	std::vector<UINT> adjacent( triangles * 3 );
+	std::vector<UINT> indices( triangles * 6 );
+
+	if ( triangles > 0 )
+		FindAdjacentVertices( &m_vIndices[0], triangles * 3, &adjacent[0] );
+
+	for ( unsigned int t = 0; t < triangles; t++ )
+	{
+		const UINT* pTriangle = &m_vIndices[3*t];
+		const UINT* pAdjacent = &adjacent[3*t];
+		UINT* pOut = &indices[6*t];
+
+		if ( layout == ADJACENCY_PATCH )
+		{
+			for ( unsigned int k = 0; k < 3; k++ )
+			{
+				pOut[k] = pTriangle[k];
+				pOut[k+3] = pAdjacent[k];
+			}
+		}
+		else
+		{
+			for ( unsigned int k = 0; k < 3; k++ )
+			{
+				pOut[2*k] = pTriangle[k];
+				pOut[2*k+1] = pAdjacent[k];
+			}
+		}
+	}
+
+	m_vIndices.swap( indices );
+
+	if ( layout == ADJACENCY_PATCH )
+		m_ePrimType = D3D11_PRIMITIVE_TOPOLOGY_6_CONTROL_POINT_PATCHLIST;
+	else
+		m_ePrimType = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST_ADJ;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void GeometryDX11::FindAdjacentVertices( const UINT* pIndices, unsigned int indexCount, UINT* pAdjacent )
+{
+	GLYPH_PROFILE_SCOPE( "GeometryDX11::FindAdjacentVertices" );
+
+	// Edge h runs from corner h to the next corner of the same triangle.  Every
+	// edge is entered into an open addressing hash table under the pair of its
+	// vertices, regardless of direction, and pushed onto the list of edges of
+	// its slot, so that all of the triangles that share an edge end up in the
+	// same list.  Each edge then looks through its own list for the neighbour.
+	// Both passes only work on one edge at a time, so they run in parallel, and
+	// taking the lowest edge index among the candidates makes the result the
+	// same no matter in which order the threads added the edges to the lists.
+
+	const unsigned int edges = indexCount - indexCount % 3;
+
+	if ( edges == 0 )
+		return;
+
+	// Every edge can have its own key, such as in a mesh of separate triangles,
+	// so the table has at least twice as many slots as edges to stay at most
+	// half full, like the tables of ObjImporterDX11.
+
+	const unsigned long long entries = 2ull * edges;
+
+	unsigned int tableSize = 64;
+	while ( tableSize < entries && tableSize < 0x80000000u )
+		tableSize <<= 1;
+
+	const unsigned int mask = tableSize - 1;
+
+	std::unique_ptr<EdgeSlot[]> table( new EdgeSlot[tableSize] );
+	std::vector<unsigned int> slots( edges );
+	std::vector<unsigned int> next( edges );
+
+	ForEachRange( tableSize, [&]( unsigned int begin, unsigned int end )
+	{
+		for ( unsigned int i = begin; i < end; i++ )
+		{
+			table[i].key.store( EmptyEdgeKey, std::memory_order_relaxed );
+			table[i].first.store( NoEdge, std::memory_order_relaxed );
+		}
+	} );
+
+	// Insert the edges.  Degenerate edges can't have a neighbour, so they are
+	// left out of the table.
+
+	ForEachRange( edges, [&]( unsigned int begin, unsigned int end )
+	{
+		for ( unsigned int h = begin; h < end; h++ )
+		{
+			const UINT start = pIndices[h];
+			const UINT finish = pIndices[h % 3 == 2 ? h - 2 : h + 1];
+
+			if ( start == finish )
+			{
+				slots[h] = NoEdge;
+				continue;
+			}
+
+			const unsigned long long key = start < finish ?
+				( static_cast<unsigned long long>( start ) << 32 ) | finish :
+				( static_cast<unsigned long long>( finish ) << 32 ) | start;
+
+			unsigned int slot = HashEdgeKey( key ) & mask;
+
+			while ( true )
+			{
+				unsigned long long current = table[slot].key.load( std::memory_order_relaxed );
+
+				if ( current == EmptyEdgeKey )
+				{
+					if ( table[slot].key.compare_exchange_strong( current, key, std::memory_order_relaxed ) )
+						break;
+				}
+
+				if ( current == key )
+					break;
+
+				slot = ( slot + 1 ) & mask;
+			}
+
+			slots[h] = slot;
+			next[h] = table[slot].first.exchange( h, std::memory_order_relaxed );
+		}
+	} );
+
+	// The neighbour is the first other triangle on the edge whose third vertex
+	// differs from this one's.  That excludes the triangle itself, as well as
+	// duplicates of it with either winding.
+
+	ForEachRange( edges, [&]( unsigned int begin, unsigned int end )
+	{
+		for ( unsigned int h = begin; h < end; h++ )
+		{
+			const unsigned int triangle = h - h % 3;
+			const UINT opposite = pIndices[triangle + ( h + 2 ) % 3];
+
+			pAdjacent[h] = pIndices[h];
+
+			if ( slots[h] == NoEdge )
+				continue;
+
+			unsigned int best = NoEdge;
+
+			for ( unsigned int other = table[slots[h]].first.load( std::memory_order_relaxed );
+				other != NoEdge; other = next[other] )
+			{
+				if ( other >= best || other - other % 3 == triangle )
+					continue;
+
+				if ( pIndices[other - other % 3 + ( other + 2 ) % 3] != opposite )
+					best = other;
+			}
+
+			if ( best != NoEdge )
+				pAdjacent[h] = pIndices[best - best % 3 + ( best + 2 ) % 3];
+		}
+	} );
+}
+//--------------------------------------------------------------------------------
@@ -19,6 +19,7 @@
 #include "ShaderResourceParameterWriterDX11.h"
 #include "EventManager.h"
 #include "EvtErrorMessage.h"
+#include "GeometryOptimizerDX11.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
@@ -518,6 +519,11 @@ void GeometryGeneratorDX11::GenerateSphere( GeometryPtr pGeometry, unsigned int
         face = TriangleIndices( currTop, bottom, nextTop );
         pGeometry->AddFace( face );
     }
+
+    // The rings are generated in order, so reorder the triangles to make
+    // better use of the post-transform vertex cache.  The vertices are left in
+    // place, since callers may add more elements to them afterwards.
+    GeometryOptimizerDX11::OptimizeVertexCache( pGeometry );
 }
 //--------------------------------------------------------------------------------
 void GeometryGeneratorDX11::GenerateCone( GeometryPtr pGeometry, unsigned int URes, 
@@ -625,6 +631,9 @@ void GeometryGeneratorDX11::GenerateCone( GeometryPtr pGeometry, unsigned int UR
         face = TriangleIndices( nextTop, center, currTop );
         pGeometry->AddFace( face );
     }
+
+    // Reorder the triangles for the vertex cache, as with the sphere.
+    GeometryOptimizerDX11::OptimizeVertexCache( pGeometry );
 }
 //--------------------------------------------------------------------------------
 void GeometryGeneratorDX11::GenerateWeightedSkinnedCone( GeometryPtr pGeometry, unsigned int URes, 
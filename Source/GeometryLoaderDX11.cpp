@@ -13,7 +13,6 @@
 #include "GeometryLoaderDX11.h"
 #include "GeometryDX11.h"
 #include "VertexElementDX11.h"
-#include "ms3dspec.h"
 #include "Vector2f.h"
 #include "Vector3f.h"
 #include "Log.h"
@@ -21,386 +20,415 @@
 #include "MaterialGeneratorDX11.h"
 #include <sstream>
 #include "FileSystem.h"
+#include "GeometryCacheDX11.h"
+#include "MemoryMappedFile.h"
+#include "GeometryOptimizerDX11.h"
+#include "Profiler.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
+// The sizes of the binary PLY scalar types, indexed by PlyScalarType.
+//--------------------------------------------------------------------------------
+static const unsigned int PlyScalarSizes[] = { 0, 1, 1, 2, 2, 4, 4, 4, 8 };
+//--------------------------------------------------------------------------------
 GeometryLoaderDX11::GeometryLoaderDX11( )
 {
 }
 //--------------------------------------------------------------------------------
 GeometryPtr GeometryLoaderDX11::loadMS3DFile2( std::wstring filename )
 {
+	GLYPH_PROFILE_SCOPE( "GeometryLoaderDX11::loadMS3DFile2" );
+
 	// Get the file path to the models
 	FileSystem fs;
 	filename = fs.GetModelsFolder() + filename;
 
-	// Temporary Milkshape structures
-	unsigned short usVertexCount = 0;
-	unsigned short usTriangleCount = 0;
-	unsigned short usGroupCount = 0;
-	unsigned short usMaterialCount = 0;
-	MS3DVertex* pMS3DVertices = NULL;
-	MS3DTriangle* pMS3DTriangles = NULL;
-	MS3DGroup* pMS3DGroups = NULL;
-	MS3DMaterial* pMS3DMaterials = NULL;
-
-	std::ifstream fin;
-	MS3DHeader header;
-
-	// Open the file and read the MS3D header data
-	fin.open( filename.c_str(),std::ios::binary );
-	fin.read((char*)(&(header.id)), sizeof(header.id));
-	fin.read((char*)(&(header.version)), sizeof(header.version));
-	if (header.version!=3 && header.version!=4)
-		return NULL;
+	// Use the binary cache of this model if it is up to date.
+	std::wstring cache = GeometryCacheDX11::GetCacheFilename( filename );
 
-	// Load all the vertices
-	fin.read((char*)(&usVertexCount), sizeof(unsigned short));
-	pMS3DVertices = new MS3DVertex[usVertexCount];
-	for (int i = 0; i < usVertexCount; i++)
-	{
-		fin.read((char*)&(pMS3DVertices[i].flags), sizeof(unsigned char));
-		fin.read((char*)&(pMS3DVertices[i].vertex[0]), sizeof(float));
-		fin.read((char*)&(pMS3DVertices[i].vertex[1]), sizeof(float));
-		fin.read((char*)&(pMS3DVertices[i].vertex[2]), sizeof(float));
-		fin.read((char*)&(pMS3DVertices[i].boneId), sizeof(char));
-		fin.read((char*)&(pMS3DVertices[i].referenceCount), sizeof(unsigned char));
+	if ( GeometryCacheDX11::IsCacheValid( filename, cache ) ) {
+		GeometryPtr pCached = GeometryCacheDX11::Read( cache );
+		if ( pCached )
+			return( pCached );
 	}
 
-	// Load all the triangle indices
-	fin.read((char*)(&usTriangleCount), sizeof(unsigned short));
-	pMS3DTriangles = new MS3DTriangle[usTriangleCount];
-	for (int i = 0; i < usTriangleCount; i++)
-	{
-		fin.read((char*)&(pMS3DTriangles[i].flags),sizeof(unsigned short));
-		fin.read((char*)&(pMS3DTriangles[i].vertexIndices[0]), sizeof(unsigned short)); //3*sizeof(unsigned short));
-		fin.read((char*)&(pMS3DTriangles[i].vertexIndices[1]), sizeof(unsigned short)); //3*sizeof(unsigned short));
-		fin.read((char*)&(pMS3DTriangles[i].vertexIndices[2]), sizeof(unsigned short)); //3*sizeof(unsigned short));
-		fin.read((char*)&(pMS3DTriangles[i].vertexNormals[0]), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].vertexNormals[1]), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].vertexNormals[2]), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].s), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].t), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].smoothingGroup), sizeof(unsigned char));
-		fin.read((char*)&(pMS3DTriangles[i].groupIndex), sizeof(unsigned char));
-	}
+	MS3DModel model;
 
-	// Load all the group information
-	fin.read((char*)(&usGroupCount), sizeof(unsigned short));
-	pMS3DGroups = new MS3DGroup[usGroupCount];
-	for (int i = 0; i < usGroupCount; i++)
-	{
-		fin.read((char*)&(pMS3DGroups[i].flags), sizeof(unsigned char));
-		fin.read((char*)&(pMS3DGroups[i].name), sizeof(char[32]));
-		fin.read((char*)&(pMS3DGroups[i].numtriangles), sizeof(unsigned short));
-		unsigned short triCount = pMS3DGroups[i].numtriangles;
-		pMS3DGroups[i].triangleIndices = new unsigned short[triCount];
-		fin.read((char*)(pMS3DGroups[i].triangleIndices), sizeof(unsigned short) * triCount);
-		fin.read((char*)&(pMS3DGroups[i].materialIndex), sizeof(char));
-	}
+	if ( !ReadMS3DFile( filename, model, false ) )
+		return( nullptr );
 
-	// Load all the material information
-	fin.read((char*)(&usMaterialCount),sizeof(unsigned short));
-	pMS3DMaterials = new MS3DMaterial[usMaterialCount];
-	for (int i = 0; i < usMaterialCount; i++)
-	{
-		fin.read((char*)&(pMS3DMaterials[i].name), sizeof(char[32]));
-		fin.read((char*)&(pMS3DMaterials[i].ambient), 4 * sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].diffuse), 4 * sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].specular), 4 * sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].emissive), 4 * sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].shininess), sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].transparency), sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].mode), sizeof(char));
-		fin.read((char*)&(pMS3DMaterials[i].texture), sizeof(char[128]));
-		fin.read((char*)&(pMS3DMaterials[i].alphamap), sizeof(char[128]));
-	}
+	GeometryPtr MeshPtr = BuildMS3DGeometry( model, false );
 
-	// Close the file (remaining file data unused)
-	fin.close();
+	//MeshPtr->GenerateVertexDeclaration();
+	//MeshPtr->LoadToBuffers();
 
+	GeometryCacheDX11::Write( MeshPtr, cache );
 
-	// create the vertex element streams
-	VertexElementDX11* pPositions = new VertexElementDX11( 3, usTriangleCount*3 );
-    pPositions->m_SemanticName = VertexElementDX11::PositionSemantic;
-	pPositions->m_uiSemanticIndex = 0;
-	pPositions->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	pPositions->m_uiInputSlot = 0;
-	pPositions->m_uiAlignedByteOffset = 0;
-	pPositions->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	pPositions->m_uiInstanceDataStepRate = 0;
+	return( MeshPtr );
+}
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryLoaderDX11::loadMS3DFromMemory( const unsigned char* pData, size_t size, const std::wstring& name )
+{
+	MS3DModel model;
 
-	VertexElementDX11* pTexcoords = new VertexElementDX11( 2, usTriangleCount*3 );
-	pTexcoords->m_SemanticName = VertexElementDX11::TexCoordSemantic;
-	pTexcoords->m_uiSemanticIndex = 0;
-	pTexcoords->m_Format = DXGI_FORMAT_R32G32_FLOAT;
-	pTexcoords->m_uiInputSlot = 0;
-	pTexcoords->m_uiAlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	pTexcoords->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	pTexcoords->m_uiInstanceDataStepRate = 0;
+	if ( !ReadMS3DData( pData, size, name, model, false ) )
+		return( nullptr );
 
-	VertexElementDX11* pNormals = new VertexElementDX11( 3, usTriangleCount*3 );
-	pNormals->m_SemanticName = VertexElementDX11::NormalSemantic;
-	pNormals->m_uiSemanticIndex = 0;
-	pNormals->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	pNormals->m_uiInputSlot = 0;
-	pNormals->m_uiAlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	pNormals->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	pNormals->m_uiInstanceDataStepRate = 0;
+	return( BuildMS3DGeometry( model, false ) );
+}
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryLoaderDX11::loadMS3DFileWithAnimation( std::wstring filename, SkinnedActor* pActor )
+{
+	GLYPH_PROFILE_SCOPE( "GeometryLoaderDX11::loadMS3DFileWithAnimation" );
 
-	Vector3f* pPos = (Vector3f*)((*pPositions)[0]);
-	Vector3f* pNrm = (Vector3f*)((*pNormals)[0]);
-	Vector2f* pTex = (Vector2f*)((*pTexcoords)[0]);
+	// Get the file path to the models
+	FileSystem fs;
+	filename = fs.GetModelsFolder() + filename;
 
-	GeometryPtr MeshPtr = GeometryPtr( new GeometryDX11() );
+	MS3DModel model;
 
-	//for ( int i = 0; i < usVertexCount; i++ )
-	//{
-	//	pPos[i].x() = pMS3DVertices[i].vertex[0];
-	//	pPos[i].y() = pMS3DVertices[i].vertex[1];
-	//	pPos[i].z() = -pMS3DVertices[i].vertex[2];
-	//	pNrm[i].MakeZero();
-	//}
+	if ( !ReadMS3DFile( filename, model, true ) )
+		return( nullptr );
 
-	TriangleIndices face;
+	// Create the geometry object, and fill it with the data read from the file.
 
-	for ( int i = 0; i < usTriangleCount; i++ )
-	{
+	GeometryPtr MeshPtr = BuildMS3DGeometry( model, true );
 
-		face.i1 = 3*i+0;
-		face.i2 = 3*i+2;
-		face.i3 = 3*i+1;
-
-		pPos[3*i+0].x = pMS3DVertices[pMS3DTriangles[i].vertexIndices[0]].vertex[0];
-		pPos[3*i+0].y = pMS3DVertices[pMS3DTriangles[i].vertexIndices[0]].vertex[1];
-		pPos[3*i+0].z = -pMS3DVertices[pMS3DTriangles[i].vertexIndices[0]].vertex[2];
-		pPos[3*i+1].x = pMS3DVertices[pMS3DTriangles[i].vertexIndices[1]].vertex[0];
-		pPos[3*i+1].y = pMS3DVertices[pMS3DTriangles[i].vertexIndices[1]].vertex[1];
-		pPos[3*i+1].z = -pMS3DVertices[pMS3DTriangles[i].vertexIndices[1]].vertex[2];
-		pPos[3*i+2].x = pMS3DVertices[pMS3DTriangles[i].vertexIndices[2]].vertex[0];
-		pPos[3*i+2].y = pMS3DVertices[pMS3DTriangles[i].vertexIndices[2]].vertex[1];
-		pPos[3*i+2].z = -pMS3DVertices[pMS3DTriangles[i].vertexIndices[2]].vertex[2];
-
-		pNrm[3*i+0].x = pMS3DTriangles[i].vertexNormals[0][0];
-		pNrm[3*i+0].y = pMS3DTriangles[i].vertexNormals[0][1];
-		pNrm[3*i+0].z = -pMS3DTriangles[i].vertexNormals[0][2];
-		pNrm[3*i+1].x = pMS3DTriangles[i].vertexNormals[1][0];
-		pNrm[3*i+1].y = pMS3DTriangles[i].vertexNormals[1][1];
-		pNrm[3*i+1].z = -pMS3DTriangles[i].vertexNormals[1][2];
-		pNrm[3*i+2].x = pMS3DTriangles[i].vertexNormals[2][0];
-		pNrm[3*i+2].y = pMS3DTriangles[i].vertexNormals[2][1];
-		pNrm[3*i+2].z = -pMS3DTriangles[i].vertexNormals[2][2];
-
-		pTex[3*i+0].x = pMS3DTriangles[i].s[0];
-		pTex[3*i+0].y = pMS3DTriangles[i].t[0];
-		pTex[3*i+1].x = pMS3DTriangles[i].s[1];
-		pTex[3*i+1].y = pMS3DTriangles[i].t[1];
-		pTex[3*i+2].x = pMS3DTriangles[i].s[2];
-		pTex[3*i+2].y = pMS3DTriangles[i].t[2];
-
-		MeshPtr->AddFace( face );
-	}
+	// Now set the geometry in the SkinnedActor, and create the bones
+	// and add them to the SkinnedActor.
 
-	for ( int i = 0; i < usVertexCount; i++ )
+	if ( pActor )
 	{
-		pNrm[i].Normalize();
-	}
-
-	MeshPtr->AddElement( pPositions );
-	MeshPtr->AddElement( pTexcoords );
-	MeshPtr->AddElement( pNormals );
+		// Set the geometry in the body of the actor
+		pActor->GetBody()->Visual.SetGeometry( MeshPtr );
 
-	// Delete temporary materials
-	if (pMS3DMaterials != NULL)
-	{
-		delete[] pMS3DMaterials;
-		pMS3DMaterials = NULL;
-	}
+		// Create an array of nodes, one for each joint.
+		std::map<std::string,Node3D*> JointNodes;
 
-	// Delete temporary groups and their indices
-	if (pMS3DGroups != NULL)
-	{
-		for (int i = 0; i < usGroupCount; i++)
+		for ( unsigned int i = 0; i < model.joints.size(); i++ )
 		{
-			if (pMS3DGroups[i].triangleIndices != NULL)
+			const MS3DJointData& data = model.joints[i];
+			Node3D* pBone = new Node3D();
+
+			Vector3f BindPosition = Vector3f( data.joint.position[0],
+			 									data.joint.position[1],
+												data.joint.position[2] );
+
+			AnimationStream<Vector3f>* pPosFrames = new AnimationStream<Vector3f>();
+
+			for ( unsigned int j = 0; j < data.positions.size(); j++ )
 			{
-				delete[] pMS3DGroups[i].triangleIndices;
-				pMS3DGroups[i].triangleIndices = NULL;
+				Vector3f p = Vector3f( data.positions[j].position[0],
+					data.positions[j].position[1],
+					data.positions[j].position[2] );
+
+				pPosFrames->AddState( AnimationState<Vector3f>( data.positions[j].time, p ) ); 
 			}
+
+			AnimationStream<Vector3f>* pRotFrames = new AnimationStream<Vector3f>();
+			
+			Vector3f BindRotation = Vector3f( data.joint.rotation[0] + 6.28f, data.joint.rotation[1] + 6.28f, data.joint.rotation[2] + 6.28f );
+
+			for ( unsigned int j = 0; j < data.rotations.size(); j++ )
+			{
+				Vector3f p = Vector3f( data.rotations[j].rotation[0] + 6.28f,
+					data.rotations[j].rotation[1] + 6.28f,
+					data.rotations[j].rotation[2] + 6.28f );
+
+				pRotFrames->AddState( AnimationState<Vector3f>( data.rotations[j].time, p ) ); 
+			}
+
+			pActor->AddBoneNode( pBone, BindPosition, BindRotation, pPosFrames, pRotFrames );
+
+			JointNodes[std::string(data.joint.name)] = pBone;
 		}
-		delete[] pMS3DGroups;
-		pMS3DGroups = NULL;
-	}
 
-	// Delete temporary triangles
-	if (pMS3DTriangles != NULL)
-	{
-		delete[] pMS3DTriangles;
-		pMS3DTriangles = NULL;
-	}
+		// Connect up the bones to form the skeleton.
+		for ( unsigned int i = 0; i < model.joints.size(); i++ )
+		{
+			const MS3DJointData& data = model.joints[i];
+			Node3D* pParent = JointNodes[std::string(data.joint.parentName)];
+			Node3D* pChild = JointNodes[std::string(data.joint.name)];
 
-	// Delete temporary vertices
-	if (pMS3DVertices != NULL)
-	{
-        delete[] pMS3DVertices;
-		pMS3DVertices = NULL;
+			// If the node has a parent, link them
+			if ( pParent && pChild )
+				pParent->AttachChild( pChild );
+
+			// If the node has no parent, link it to the root of the skinned actor (for connection
+			// to the scene graph).
+			if ( !pParent && pChild )
+				pActor->GetNode()->AttachChild( pChild );
+		}
 	}
 
 	//MeshPtr->GenerateVertexDeclaration();
-	//MeshPtr->LoadToBuffers();
+	MeshPtr->LoadToBuffers();
 
 	return( MeshPtr );
 }
 //--------------------------------------------------------------------------------
-GeometryPtr GeometryLoaderDX11::loadMS3DFileWithAnimation( std::wstring filename, SkinnedActor* pActor )
+bool GeometryLoaderDX11::ReadMS3DFile( const std::wstring& filename, MS3DModel& model, bool withJoints )
 {
-	// Get the file path to the models
-	FileSystem fs;
-	filename = fs.GetModelsFolder() + filename;
+	// Map the file into memory, and read the model out of the mapped view.
+	MemoryMappedFile file;
+
+	if ( !file.Open( filename ) )
+	{
+		Log::Get().Write( L"Could not open MS3D file: " + filename, LOG_ERROR );
+		return( false );
+	}
+
+	return( ReadMS3DData( file.GetData(), file.GetSize(), filename, model, withJoints ) );
+}
+//--------------------------------------------------------------------------------
+bool GeometryLoaderDX11::ReadMS3DData( const unsigned char* pData, size_t size, const std::wstring& name, MS3DModel& model, bool withJoints )
+{
+	// The structures in the file are packed, so each field is copied separately.
+	MS3DCursor cursor;
+	cursor.pCurrent = pData;
+	cursor.pEnd = pData + size;
+	cursor.error = false;
 
-	// Temporary Milkshape structures
-	unsigned short usVertexCount = 0;
-	unsigned short usTriangleCount = 0;
-	unsigned short usGroupCount = 0;
-	unsigned short usMaterialCount = 0;
-	MS3DVertex* pMS3DVertices = NULL;
-	MS3DTriangle* pMS3DTriangles = NULL;
-	MS3DGroup* pMS3DGroups = NULL;
-	MS3DMaterial* pMS3DMaterials = NULL;
-
-	int i;
-	std::ifstream fin;
 	MS3DHeader header;
+	ReadMS3DBytes( cursor, header.id, sizeof( header.id ) );
+	ReadMS3DBytes( cursor, &header.version, sizeof( header.version ) );
 
-	// Open the file and read the MS3D header data
-	fin.open( filename.c_str(),std::ios::binary );
-	fin.read((char*)(&(header.id)), sizeof(header.id));
-	fin.read((char*)(&(header.version)), sizeof(header.version));
-	if (header.version!=3 && header.version!=4)
-		return NULL;
+	if ( cursor.error || ( header.version != 3 && header.version != 4 ) )
+	{
+		Log::Get().Write( L"Unsupported MS3D file version: " + name, LOG_ERROR );
+		return( false );
+	}
 
 	// Load all the vertices
-	fin.read((char*)(&usVertexCount), sizeof(unsigned short));
-	pMS3DVertices = new MS3DVertex[usVertexCount];
-	for (i=0; i < usVertexCount; i++)
+	unsigned short usVertexCount = 0;
+	ReadMS3DBytes( cursor, &usVertexCount, sizeof( unsigned short ) );
+	model.vertices.resize( usVertexCount );
+
+	for ( auto& vertex : model.vertices )
 	{
-		fin.read((char*)&(pMS3DVertices[i].flags), sizeof(unsigned char));
-		fin.read((char*)&(pMS3DVertices[i].vertex[0]), sizeof(float));
-		fin.read((char*)&(pMS3DVertices[i].vertex[1]), sizeof(float));
-		fin.read((char*)&(pMS3DVertices[i].vertex[2]), sizeof(float));
-		fin.read((char*)&(pMS3DVertices[i].boneId), sizeof(char));
-		fin.read((char*)&(pMS3DVertices[i].referenceCount), sizeof(unsigned char));
+		ReadMS3DBytes( cursor, &vertex.flags, sizeof( unsigned char ) );
+		ReadMS3DBytes( cursor, vertex.vertex, 3 * sizeof( float ) );
+		ReadMS3DBytes( cursor, &vertex.boneId, sizeof( char ) );
+		ReadMS3DBytes( cursor, &vertex.referenceCount, sizeof( unsigned char ) );
 	}
 
-	// Load all the triangle indices
-	fin.read((char*)(&usTriangleCount), sizeof(unsigned short));
-	pMS3DTriangles = new MS3DTriangle[usTriangleCount];
-	for (i=0; i < usTriangleCount; i++)
+	// Load all the triangles
+	unsigned short usTriangleCount = 0;
+	ReadMS3DBytes( cursor, &usTriangleCount, sizeof( unsigned short ) );
+	model.triangles.resize( usTriangleCount );
+
+	for ( auto& triangle : model.triangles )
 	{
-		fin.read((char*)&(pMS3DTriangles[i].flags),sizeof(unsigned short));
-		fin.read((char*)&(pMS3DTriangles[i].vertexIndices[0]), sizeof(unsigned short)); //3*sizeof(unsigned short));
-		fin.read((char*)&(pMS3DTriangles[i].vertexIndices[1]), sizeof(unsigned short)); //3*sizeof(unsigned short));
-		fin.read((char*)&(pMS3DTriangles[i].vertexIndices[2]), sizeof(unsigned short)); //3*sizeof(unsigned short));
-		fin.read((char*)&(pMS3DTriangles[i].vertexNormals[0]), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].vertexNormals[1]), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].vertexNormals[2]), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].s), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].t), 3*sizeof(float));
-		fin.read((char*)&(pMS3DTriangles[i].smoothingGroup), sizeof(unsigned char));
-		fin.read((char*)&(pMS3DTriangles[i].groupIndex), sizeof(unsigned char));
+		ReadMS3DBytes( cursor, &triangle.flags, sizeof( unsigned short ) );
+		ReadMS3DBytes( cursor, triangle.vertexIndices, 3 * sizeof( unsigned short ) );
+		ReadMS3DBytes( cursor, triangle.vertexNormals, 9 * sizeof( float ) );
+		ReadMS3DBytes( cursor, triangle.s, 3 * sizeof( float ) );
+		ReadMS3DBytes( cursor, triangle.t, 3 * sizeof( float ) );
+		ReadMS3DBytes( cursor, &triangle.smoothingGroup, sizeof( unsigned char ) );
+		ReadMS3DBytes( cursor, &triangle.groupIndex, sizeof( unsigned char ) );
+
+		for ( int i = 0; i < 3; i++ )
+			if ( triangle.vertexIndices[i] >= usVertexCount )
+				cursor.error = true;
 	}
 
-	// Load all the group information
-	fin.read((char*)(&usGroupCount), sizeof(unsigned short));
-	pMS3DGroups = new MS3DGroup[usGroupCount];
-	for (i=0; i < usGroupCount; i++)
+	if ( withJoints )
 	{
-		fin.read((char*)&(pMS3DGroups[i].flags), sizeof(unsigned char));
-		fin.read((char*)&(pMS3DGroups[i].name), sizeof(char[32]));
-		fin.read((char*)&(pMS3DGroups[i].numtriangles), sizeof(unsigned short));
-		unsigned short triCount = pMS3DGroups[i].numtriangles;
-		pMS3DGroups[i].triangleIndices = new unsigned short[triCount];
-		fin.read((char*)(pMS3DGroups[i].triangleIndices), sizeof(unsigned short) * triCount);
-		fin.read((char*)&(pMS3DGroups[i].materialIndex), sizeof(char));
+		// Skip the groups and the materials, which aren't used.
+		unsigned short usGroupCount = 0;
+		ReadMS3DBytes( cursor, &usGroupCount, sizeof( unsigned short ) );
+
+		for ( int i = 0; i < usGroupCount && !cursor.error; i++ )
+		{
+			unsigned short usGroupTriangles = 0;
+			SkipMS3DBytes( cursor, sizeof( unsigned char ) + sizeof( char[32] ) );
+			ReadMS3DBytes( cursor, &usGroupTriangles, sizeof( unsigned short ) );
+			SkipMS3DBytes( cursor, sizeof( unsigned short ) * usGroupTriangles + sizeof( char ) );
+		}
+
+		unsigned short usMaterialCount = 0;
+		ReadMS3DBytes( cursor, &usMaterialCount, sizeof( unsigned short ) );
+
+		// The name, four colors, shininess, transparency, mode, texture and
+		// alpha map of each material.
+		const size_t materialSize = sizeof( char[32] ) + 16 * sizeof( float ) + 2 * sizeof( float )
+			+ sizeof( char ) + 2 * sizeof( char[128] );
+		SkipMS3DBytes( cursor, materialSize * usMaterialCount );
+
+		// Skip the animation FPS, current time and total frames.
+		SkipMS3DBytes( cursor, 2 * sizeof( float ) + sizeof( int ) );
+
+		unsigned short usJointCount = 0;
+		ReadMS3DBytes( cursor, &usJointCount, sizeof( unsigned short ) );
+		model.joints.resize( usJointCount );
+
+		for ( auto& data : model.joints )
+		{
+			MS3DKeyframeJoint& joint = data.joint;
+
+			ReadMS3DBytes( cursor, &joint.flags, sizeof( unsigned char ) );
+			ReadMS3DBytes( cursor, joint.name, sizeof( char[32] ) );
+			ReadMS3DBytes( cursor, joint.parentName, sizeof( char[32] ) );
+			ReadMS3DBytes( cursor, joint.rotation, 3 * sizeof( float ) );
+			ReadMS3DBytes( cursor, joint.position, 3 * sizeof( float ) );
+			ReadMS3DBytes( cursor, &joint.numKeyFramesRot, sizeof( unsigned short ) );
+			ReadMS3DBytes( cursor, &joint.numKeyFramesTrans, sizeof( unsigned short ) );
+
+			// Make sure that the names are terminated, even in a broken file.
+			joint.name[31] = 0;
+			joint.parentName[31] = 0;
+			joint.keyFramesRot = nullptr;
+			joint.keyFramesTrans = nullptr;
+
+			data.rotations.resize( joint.numKeyFramesRot );
+			data.positions.resize( joint.numKeyFramesTrans );
+
+			for ( auto& key : data.rotations )
+			{
+				ReadMS3DBytes( cursor, &key.time, sizeof( float ) );
+				ReadMS3DBytes( cursor, key.rotation, 3 * sizeof( float ) );
+			}
+
+			for ( auto& key : data.positions )
+			{
+				ReadMS3DBytes( cursor, &key.time, sizeof( float ) );
+				ReadMS3DBytes( cursor, key.position, 3 * sizeof( float ) );
+			}
+		}
 	}
 
-	// Load all the material information
-	fin.read((char*)(&usMaterialCount),sizeof(unsigned short));
-	pMS3DMaterials = new MS3DMaterial[usMaterialCount];
-	for (i=0; i < usMaterialCount; i++)
+	// The remaining file data is unused.
+
+	if ( cursor.error )
 	{
-		fin.read((char*)&(pMS3DMaterials[i].name), sizeof(char[32]));
-		fin.read((char*)&(pMS3DMaterials[i].ambient), 4 * sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].diffuse), 4 * sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].specular), 4 * sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].emissive), 4 * sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].shininess), sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].transparency), sizeof(float));
-		fin.read((char*)&(pMS3DMaterials[i].mode), sizeof(char));
-		fin.read((char*)&(pMS3DMaterials[i].texture), sizeof(char[128]));
-		fin.read((char*)&(pMS3DMaterials[i].alphamap), sizeof(char[128]));
+		Log::Get().Write( L"MS3D file is truncated or malformed: " + name, LOG_ERROR );
+		return( false );
+	}
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void GeometryLoaderDX11::ReadMS3DBytes( MS3DCursor& cursor, void* pData, size_t size )
+{
+	if ( static_cast<size_t>( cursor.pEnd - cursor.pCurrent ) < size ) {
+		memset( pData, 0, size );
+		cursor.pCurrent = cursor.pEnd;
+		cursor.error = true;
+		return;
+	}
+
+	memcpy( pData, cursor.pCurrent, size );
+	cursor.pCurrent += size;
+}
+//--------------------------------------------------------------------------------
+void GeometryLoaderDX11::SkipMS3DBytes( MS3DCursor& cursor, size_t size )
+{
+	if ( static_cast<size_t>( cursor.pEnd - cursor.pCurrent ) < size ) {
+		cursor.pCurrent = cursor.pEnd;
+		cursor.error = true;
+		return;
 	}
 
-	float fAnimationFPS; // 4 bytes
-	float fCurrentTime; // 4 bytes
-	int iTotalFrames; // 4 bytes
-	unsigned short nNumJoints; // 2 bytes
+	cursor.pCurrent += size;
+}
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryLoaderDX11::BuildMS3DGeometry( const MS3DModel& model, bool withBoneIDs )
+{
+	// The data of one triangle corner, with the z axis flipped to convert it to
+	// the left handed coordinate system.  Negative zero is folded into zero, so
+	// that corners can be compared on their exact bits like in
+	// GeometryOptimizerDX11::WeldVertices.  The bone is left at zero when it
+	// isn't used, so that it doesn't keep otherwise identical corners apart.
+
+	struct Corner
+	{
+		float	data[8];
+		int		bone;
+	};
+
+	static const UINT NoVertex = ~0U;
 
-	fin.read((char*)&(fAnimationFPS), sizeof(float));
-	fin.read((char*)&(fCurrentTime), sizeof(float));
-	fin.read((char*)&(iTotalFrames), sizeof(int));
-	fin.read((char*)&(nNumJoints), sizeof(unsigned short));
+	// The corners are taken in the order 0, 2, 1 to flip the winding along with
+	// the z axis.
+	static const unsigned int CornerOrder[3] = { 0, 2, 1 };
 
+	const unsigned int cornerCount = static_cast<unsigned int>( model.triangles.size() ) * 3;
 
-	MS3DKeyframeJoint* pMS3DJoints = 0;
+	std::vector<Corner> vertices;
+	std::vector<UINT> indices( cornerCount );
+	vertices.reserve( cornerCount );
 
-	if ( nNumJoints > 0 )
-		pMS3DJoints = new MS3DKeyframeJoint[nNumJoints];
+	// An open addressing table of the vertices created so far, which is kept at
+	// most half full.
+	unsigned int tableSize = 64;
+	while ( tableSize < cornerCount * 2 )
+		tableSize <<= 1;
 
-	for ( i = 0; i < nNumJoints; i++ )
+	std::vector<UINT> table( tableSize, NoVertex );
+
+	for ( unsigned int t = 0; t < model.triangles.size(); t++ )
 	{
-		fin.read((char*)&(pMS3DJoints[i].flags), sizeof(unsigned char));
-		fin.read((char*)&(pMS3DJoints[i].name), sizeof(char[32]));
-		fin.read((char*)&(pMS3DJoints[i].parentName), sizeof(char[32]));
-		fin.read((char*)&(pMS3DJoints[i].rotation[0]), 3 * sizeof(float));
-		fin.read((char*)&(pMS3DJoints[i].position[0]), 3 * sizeof(float));
-		fin.read((char*)&(pMS3DJoints[i].numKeyFramesRot), sizeof(unsigned short));
-		fin.read((char*)&(pMS3DJoints[i].numKeyFramesTrans), sizeof(unsigned short));
-
-		pMS3DJoints[i].keyFramesRot = new MS3DKeyframeRotation[pMS3DJoints[i].numKeyFramesRot];
-		pMS3DJoints[i].keyFramesTrans = new MS3DKeyframePosition[pMS3DJoints[i].numKeyFramesTrans];
-
-		for ( int j = 0; j < pMS3DJoints[i].numKeyFramesRot; j++ )
-		{
-			fin.read((char*)&(pMS3DJoints[i].keyFramesRot[j].time), 1 * sizeof(float));
-			fin.read((char*)&(pMS3DJoints[i].keyFramesRot[j].rotation), 3 * sizeof(float));
-		}
+		const MS3DTriangle& triangle = model.triangles[t];
 
-		for ( int j = 0; j < pMS3DJoints[i].numKeyFramesTrans; j++ )
+		for ( unsigned int k = 0; k < 3; k++ )
 		{
-			fin.read((char*)&(pMS3DJoints[i].keyFramesTrans[j].time), 1 * sizeof(float));
-			fin.read((char*)&(pMS3DJoints[i].keyFramesTrans[j].position), 3 * sizeof(float));
-		}
+			const unsigned int c = CornerOrder[k];
+			const MS3DVertex& vertex = model.vertices[triangle.vertexIndices[c]];
+
+			Vector3f normal( triangle.vertexNormals[c][0], triangle.vertexNormals[c][1], -triangle.vertexNormals[c][2] );
+			normal.Normalize();
+
+			Corner corner;
+			corner.data[0] = vertex.vertex[0];
+			corner.data[1] = vertex.vertex[1];
+			corner.data[2] = -vertex.vertex[2];
+			corner.data[3] = normal.x;
+			corner.data[4] = normal.y;
+			corner.data[5] = normal.z;
+			corner.data[6] = triangle.s[c];
+			corner.data[7] = triangle.t[c];
+			corner.bone = withBoneIDs ? vertex.boneId : 0;
+
+			unsigned int hash = 2166136261u;
+
+			for ( int i = 0; i < 8; i++ )
+			{
+				if ( corner.data[i] == 0.0f )
+					corner.data[i] = 0.0f;
 
-		//std::wstringstream s;
-		//s << GlyphString::ToUnicode( std::string( pMS3DJoints[i].name ) ) << std::endl;
-		//for ( int z = 0; z < pMS3DJoints[i].numKeyFramesRot; z++ )
-		//	s << L"rotation: " << pMS3DJoints[i].keyFramesRot[z].time << L" " <<pMS3DJoints[i].keyFramesRot[z].rotation[0] << L" " << pMS3DJoints[i].keyFramesRot[z].rotation[1] << L" " << pMS3DJoints[i].keyFramesRot[z].rotation[2] << std::endl;
+				unsigned int bits;
+				memcpy( &bits, &corner.data[i], sizeof( bits ) );
+				hash = ( hash ^ bits ) * 16777619u;
+			}
 
-		//for ( int z = 0; z < pMS3DJoints[i].numKeyFramesTrans; z++ )
-		//	s << L"position: " << pMS3DJoints[i].keyFramesTrans[z].time << L" " <<pMS3DJoints[i].keyFramesTrans[z].position[0] << L" " << pMS3DJoints[i].keyFramesTrans[z].position[1] << L" " << pMS3DJoints[i].keyFramesTrans[z].position[2] << std::endl;
+			hash = ( hash ^ static_cast<unsigned int>( corner.bone ) ) * 16777619u;
 
-		//Log::Get().Write( s.str() );
-	}
+			unsigned int slot = hash & ( tableSize - 1 );
 
+			while ( table[slot] != NoVertex )
+			{
+				const Corner& existing = vertices[table[slot]];
 
+				if ( existing.bone == corner.bone && memcmp( existing.data, corner.data, sizeof( corner.data ) ) == 0 )
+					break;
 
-	// Close the file (remaining file data unused)
-	fin.close();
+				slot = ( slot + 1 ) & ( tableSize - 1 );
+			}
 
+			if ( table[slot] == NoVertex )
+			{
+				table[slot] = static_cast<UINT>( vertices.size() );
+				vertices.push_back( corner );
+			}
+
+			indices[3*t+k] = table[slot];
+		}
+	}
 
 	// create the vertex element streams
-	VertexElementDX11* pPositions = new VertexElementDX11( 3, usTriangleCount*3 );
+	const int vertexCount = static_cast<int>( vertices.size() );
+
+	VertexElementDX11* pPositions = new VertexElementDX11( 3, vertexCount );
 	pPositions->m_SemanticName = VertexElementDX11::PositionSemantic;
 	pPositions->m_uiSemanticIndex = 0;
 	pPositions->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
@@ -409,16 +437,21 @@ GeometryPtr GeometryLoaderDX11::loadMS3DFileWithAnimation( std::wstring filename
 	pPositions->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
 	pPositions->m_uiInstanceDataStepRate = 0;
 
-	VertexElementDX11* pBoneIDs = new VertexElementDX11( 1, usTriangleCount*3 );
-	pBoneIDs->m_SemanticName = VertexElementDX11::BoneIDSemantic;
-	pBoneIDs->m_uiSemanticIndex = 0;
-	pBoneIDs->m_Format = DXGI_FORMAT_R32_SINT;
-	pBoneIDs->m_uiInputSlot = 0;
-	pBoneIDs->m_uiAlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	pBoneIDs->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	pBoneIDs->m_uiInstanceDataStepRate = 0;
+	VertexElementDX11* pBoneIDs = nullptr;
+
+	if ( withBoneIDs )
+	{
+		pBoneIDs = new VertexElementDX11( 1, vertexCount );
+		pBoneIDs->m_SemanticName = VertexElementDX11::BoneIDSemantic;
+		pBoneIDs->m_uiSemanticIndex = 0;
+		pBoneIDs->m_Format = DXGI_FORMAT_R32_SINT;
+		pBoneIDs->m_uiInputSlot = 0;
+		pBoneIDs->m_uiAlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+		pBoneIDs->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		pBoneIDs->m_uiInstanceDataStepRate = 0;
+	}
 
-	VertexElementDX11* pTexcoords = new VertexElementDX11( 2, usTriangleCount*3 );
+	VertexElementDX11* pTexcoords = new VertexElementDX11( 2, vertexCount );
 	pTexcoords->m_SemanticName = VertexElementDX11::TexCoordSemantic;
 	pTexcoords->m_uiSemanticIndex = 0;
 	pTexcoords->m_Format = DXGI_FORMAT_R32G32_FLOAT;
@@ -427,7 +460,7 @@ GeometryPtr GeometryLoaderDX11::loadMS3DFileWithAnimation( std::wstring filename
 	pTexcoords->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
 	pTexcoords->m_uiInstanceDataStepRate = 0;
 
-	VertexElementDX11* pNormals = new VertexElementDX11( 3, usTriangleCount*3 );
+	VertexElementDX11* pNormals = new VertexElementDX11( 3, vertexCount );
 	pNormals->m_SemanticName = VertexElementDX11::NormalSemantic;
 	pNormals->m_uiSemanticIndex = 0;
 	pNormals->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
@@ -437,736 +470,595 @@ GeometryPtr GeometryLoaderDX11::loadMS3DFileWithAnimation( std::wstring filename
 	pNormals->m_uiInstanceDataStepRate = 0;
 
 	Vector3f* pPos = pPositions->Get3f( 0 );
-	int* pIds = pBoneIDs->Get1i( 0 );
 	Vector3f* pNrm = pNormals->Get3f( 0 );
 	Vector2f* pTex = pTexcoords->Get2f( 0 );
 
-	// Create the geometry object, and fill it with the data read from the file.
-
-	GeometryPtr MeshPtr = GeometryPtr( new GeometryDX11() );
-
-	TriangleIndices face;
-
-	for ( int i = 0; i < usTriangleCount; i++ )
+	for ( int v = 0; v < vertexCount; v++ )
 	{
+		const float* pData = vertices[v].data;
 
-		face.i1 = 3*i+0;
-		face.i2 = 3*i+2;
-		face.i3 = 3*i+1;
-
-		pPos[3*i+0].x = pMS3DVertices[pMS3DTriangles[i].vertexIndices[0]].vertex[0];
-		pPos[3*i+0].y = pMS3DVertices[pMS3DTriangles[i].vertexIndices[0]].vertex[1];
-		pPos[3*i+0].z = -pMS3DVertices[pMS3DTriangles[i].vertexIndices[0]].vertex[2];
-		pPos[3*i+1].x = pMS3DVertices[pMS3DTriangles[i].vertexIndices[1]].vertex[0];
-		pPos[3*i+1].y = pMS3DVertices[pMS3DTriangles[i].vertexIndices[1]].vertex[1];
-		pPos[3*i+1].z = -pMS3DVertices[pMS3DTriangles[i].vertexIndices[1]].vertex[2];
-		pPos[3*i+2].x = pMS3DVertices[pMS3DTriangles[i].vertexIndices[2]].vertex[0];
-		pPos[3*i+2].y = pMS3DVertices[pMS3DTriangles[i].vertexIndices[2]].vertex[1];
-		pPos[3*i+2].z = -pMS3DVertices[pMS3DTriangles[i].vertexIndices[2]].vertex[2];
-
-		pIds[3*i+0] = pMS3DVertices[pMS3DTriangles[i].vertexIndices[0]].boneId;
-		pIds[3*i+1] = pMS3DVertices[pMS3DTriangles[i].vertexIndices[1]].boneId;
-		pIds[3*i+2] = pMS3DVertices[pMS3DTriangles[i].vertexIndices[2]].boneId;
-
-		pNrm[3*i+0].x = pMS3DTriangles[i].vertexNormals[0][0];
-		pNrm[3*i+0].y = pMS3DTriangles[i].vertexNormals[0][1];
-		pNrm[3*i+0].z = -pMS3DTriangles[i].vertexNormals[0][2];
-		pNrm[3*i+1].x = pMS3DTriangles[i].vertexNormals[1][0];
-		pNrm[3*i+1].y = pMS3DTriangles[i].vertexNormals[1][1];
-		pNrm[3*i+1].z = -pMS3DTriangles[i].vertexNormals[1][2];
-		pNrm[3*i+2].x = pMS3DTriangles[i].vertexNormals[2][0];
-		pNrm[3*i+2].y = pMS3DTriangles[i].vertexNormals[2][1];
-		pNrm[3*i+2].z = -pMS3DTriangles[i].vertexNormals[2][2];
-
-		pTex[3*i+0].x = pMS3DTriangles[i].s[0];
-		pTex[3*i+0].y = pMS3DTriangles[i].t[0];
-		pTex[3*i+1].x = pMS3DTriangles[i].s[1];
-		pTex[3*i+1].y = pMS3DTriangles[i].t[1];
-		pTex[3*i+2].x = pMS3DTriangles[i].s[2];
-		pTex[3*i+2].y = pMS3DTriangles[i].t[2];
-
-		MeshPtr->AddFace( face );
-	}
+		pPos[v] = Vector3f( pData[0], pData[1], pData[2] );
+		pNrm[v] = Vector3f( pData[3], pData[4], pData[5] );
+		pTex[v] = Vector2f( pData[6], pData[7] );
 
-	for ( int i = 0; i < usVertexCount; i++ )
-	{
-		pNrm[i].Normalize();
+		if ( pBoneIDs )
+			*pBoneIDs->Get1i( v ) = vertices[v].bone;
 	}
 
+	GeometryPtr MeshPtr = GeometryPtr( new GeometryDX11() );
+
 	MeshPtr->AddElement( pPositions );
-	MeshPtr->AddElement( pBoneIDs );
+	if ( pBoneIDs )
+		MeshPtr->AddElement( pBoneIDs );
 	MeshPtr->AddElement( pTexcoords );
 	MeshPtr->AddElement( pNormals );
 
-	// Now set the geometry in the SkinnedActor, and create the bones
-	// and add them to the SkinnedActor.
+	MeshPtr->m_vIndices.swap( indices );
 
-	if ( pActor )
-	{
-		// Set the geometry in the body of the actor
-		pActor->GetBody()->Visual.SetGeometry( MeshPtr );
+	// The welded mesh can now make use of the vertex cache.
+	GeometryOptimizerDX11::OptimizeVertexCache( MeshPtr );
+	GeometryOptimizerDX11::OptimizeVertexFetch( MeshPtr );
 
-		// Create an array of nodes, one for each joint.
-		std::map<std::string,Node3D*> JointNodes;
+	return( MeshPtr );
+}
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryLoaderDX11::loadStanfordPlyFile( std::wstring filename, bool withAdjacency )
+{
+	GLYPH_PROFILE_SCOPE( "GeometryLoaderDX11::loadStanfordPlyFile" );
 
-		for ( int i = 0; i < nNumJoints; i++ )
-		{
-			Node3D* pBone = new Node3D();
+	// Get the file path to the models
+	FileSystem fs;
+	filename = fs.GetModelsFolder() + filename;
 
-			Vector3f BindPosition = Vector3f( pMS3DJoints[i].position[0],
-			 									pMS3DJoints[i].position[1],
-												pMS3DJoints[i].position[2] );
+	// Use the binary cache of this model if it is up to date.  The adjacency
+	// version of the indices is cached separately.
+	std::wstring cache = GeometryCacheDX11::GetCacheFilename( withAdjacency ? filename + L".adjacency" : filename );
 
-			AnimationStream<Vector3f>* pPosFrames = new AnimationStream<Vector3f>();
+	if ( GeometryCacheDX11::IsCacheValid( filename, cache ) ) {
+		GeometryPtr pCached = GeometryCacheDX11::Read( cache );
+		if ( pCached ) {
+			pCached->LoadToBuffers( );
+			return( pCached );
+		}
+	}
 
-			for ( int j = 0; j < pMS3DJoints[i].numKeyFramesTrans; j++ )
-			{
-				Vector3f p = Vector3f( pMS3DJoints[i].keyFramesTrans[j].position[0],
-					pMS3DJoints[i].keyFramesTrans[j].position[1],
-					pMS3DJoints[i].keyFramesTrans[j].position[2] );
+	// Map the file into memory, and parse everything directly from the mapped
+	// view.
+	MemoryMappedFile file;
 
-				pPosFrames->AddState( AnimationState<Vector3f>( pMS3DJoints[i].keyFramesTrans[j].time, p ) ); 
-			}
+	if ( !file.Open( filename ) )
+	{
+		// signal error - bad filename?
+		throw new std::exception( "Could not open file" );
+	}
 
-			AnimationStream<Vector3f>* pRotFrames = new AnimationStream<Vector3f>();
-			
-			Vector3f BindRotation = Vector3f( pMS3DJoints[i].rotation[0] + 6.28f, pMS3DJoints[i].rotation[1] + 6.28f, pMS3DJoints[i].rotation[2] + 6.28f );
+	GeometryPtr MeshPtr = loadStanfordPlyFromMemory( reinterpret_cast<const char*>( file.GetData() ), file.GetSize(), withAdjacency );
 
-			for ( int j = 0; j < pMS3DJoints[i].numKeyFramesRot; j++ )
-			{
-				Vector3f p = Vector3f( pMS3DJoints[i].keyFramesRot[j].rotation[0] + 6.28f,
-					pMS3DJoints[i].keyFramesRot[j].rotation[1] + 6.28f,
-					pMS3DJoints[i].keyFramesRot[j].rotation[2] + 6.28f );
+	// Save the parsed geometry for the next load, then push into renderable
+	// resource.
+	GeometryCacheDX11::Write( MeshPtr, cache );
+	MeshPtr->LoadToBuffers( );
 
-				pRotFrames->AddState( AnimationState<Vector3f>( pMS3DJoints[i].keyFramesRot[j].time, p ) ); 
-			}
+	// Return to caller
+	return MeshPtr;
+}
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryLoaderDX11::loadStanfordPlyFromMemory( const char* pData, size_t size, bool withAdjacency )
+{
+	// No per-value allocations are made; vertex attributes are written straight
+	// into the vertex elements and the indices into the index list.
+	PlyCursor cursor;
+	cursor.pCurrent = pData;
+	cursor.pEnd = pData + size;
+	cursor.format = PLY_ASCII;
+	cursor.error = false;
 
-			pActor->AddBoneNode( pBone, BindPosition, BindRotation, pPosFrames, pRotFrames );
+	std::vector< PlyElementDesc > elements;
+	ParsePlyHeader( cursor, elements );
 
-			JointNodes[std::string(pMS3DJoints[i].name)] = pBone;
-		}
+	const int vertexIdx = FindPlyElementIndex( elements, "vertex" );
+	const int faceIdx = FindPlyElementIndex( elements, "face" );
 
-		// Connect up the bones to form the skeleton.
-		for ( int i = 0; i < nNumJoints; i++ )
-		{
-			Node3D* pParent = JointNodes[std::string(pMS3DJoints[i].parentName)];
-			Node3D* pChild = JointNodes[std::string(pMS3DJoints[i].name)];
+	if ( -1 == vertexIdx )
+		throw new std::exception( "Expected a 'vertex' element, but not found" );
 
-			// If the node has a parent, link them
-			if ( pParent && pChild )
-				pParent->AttachChild( pChild );
+	if ( -1 == faceIdx )
+		throw new std::exception( "Expected a 'face' element, but not found" );
 
-			// If the node has no parent, link it to the root of the skinned actor (for connection
-			// to the scene graph).
-			if ( !pParent && pChild )
-				pActor->GetNode()->AttachChild( pChild );
-		}
-	}
+	// Create a resource to contain the geometry
+	GeometryPtr MeshPtr = GeometryPtr( new GeometryDX11() );
 
+	std::vector< UINT > indices;
+	int faceSize = -1;
 
-	// Delete temporary joint information
-	if ( pMS3DJoints )
+	// The elements are stored in the order of their declaration, so all of 
+	// them must be visited to find the ones that are used.
+	for ( int e = 0; e < static_cast<int>( elements.size() ); e++ )
 	{
-		for ( int i = 0; i < nNumJoints; i++ )
-		{
-			delete[] pMS3DJoints[i].keyFramesRot;
-			delete[] pMS3DJoints[i].keyFramesTrans;
-		}
-		delete[] pMS3DJoints;
-	}
-
+		// The element counts of the header are used to size the vertex elements,
+		// so an element that can't possibly fit in the rest of the file is
+		// rejected before anything is allocated for it.
+		const size_t remaining = static_cast<size_t>( cursor.pEnd - cursor.pCurrent );
+
+		if ( elements[e].elementCount > remaining / GetPlyMinimumSize( cursor, elements[e] ) )
+			throw new std::exception( "File data is truncated or malformed" );
+
+		if ( e == vertexIdx )
+			ReadPlyVertices( cursor, elements[e], MeshPtr );
+		else if ( e == faceIdx )
+			ReadPlyFaces( cursor, elements[e], elements[vertexIdx].elementCount, indices, faceSize );
+		else
+			SkipPlyElement( cursor, elements[e] );
 
-	// Delete temporary materials
-	if (pMS3DMaterials != NULL)
-	{
-		delete[] pMS3DMaterials;
-		pMS3DMaterials = NULL;
+		if ( cursor.error )
+			throw new std::exception( "File data is truncated or malformed" );
 	}
 
-	// Delete temporary groups and their indices
-	if (pMS3DGroups != NULL)
-	{
-		for (i = 0; i < usGroupCount; i++)
-		{
-			if (pMS3DGroups[i].triangleIndices != NULL)
-			{
-				delete[] pMS3DGroups[i].triangleIndices;
-				pMS3DGroups[i].triangleIndices = NULL;
-			}
-		}
-		delete[] pMS3DGroups;
-		pMS3DGroups = NULL;
-	}
+	if ( -1 == faceSize )
+		throw new std::exception( "Expected at least one face, but none found" );
 
-	// Delete temporary triangles
-	if (pMS3DTriangles != NULL)
+	if ( withAdjacency )
 	{
-		delete[] pMS3DTriangles;
-		pMS3DTriangles = NULL;
-	}
+		// The adjacent vertices are only defined for triangles.
+		if ( faceSize != 3 )
+			throw new std::exception( "Adjacency requires triangle faces" );
 
-	// Delete temporary vertices
-	if (pMS3DVertices != NULL)
+		MeshPtr->SetPrimitiveType( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+		MeshPtr->m_vIndices.swap( indices );
+		MeshPtr->GenerateAdjacency( ADJACENCY_PATCH );
+	}
+	else
 	{
-        delete[] pMS3DVertices;
-		pMS3DVertices = NULL;
+		// Set the appropriate topology, and hand over the indices
+		MeshPtr->SetPrimitiveType( (D3D11_PRIMITIVE_TOPOLOGY)(D3D11_PRIMITIVE_TOPOLOGY_1_CONTROL_POINT_PATCHLIST + (faceSize - 1)) );
+		MeshPtr->m_vIndices.swap( indices );
+
+		// Scanned models usually come with their triangles and vertices in an
+		// arbitrary order, so optimize them once here and store the result in
+		// the cache.
+		if ( faceSize == 3 )
+			GeometryOptimizerDX11::Optimize( MeshPtr );
 	}
 
-	//MeshPtr->GenerateVertexDeclaration();
-	MeshPtr->LoadToBuffers();
-
-	return( MeshPtr );
+	return MeshPtr;
 }
 //--------------------------------------------------------------------------------
-GeometryPtr GeometryLoaderDX11::loadStanfordPlyFile( std::wstring filename, bool withAdjacency )
+void GeometryLoaderDX11::ParsePlyHeader( PlyCursor& cursor, std::vector<PlyElementDesc>& elements )
 {
-	// Get the file path to the models
-	FileSystem fs;
-	filename = fs.GetModelsFolder() + filename;
+	// The header is a small block of text lines, terminated by 'end_header'.
+	// Each line is split into whitespace separated tokens.
 
-	// Load the contents of the file
-	std::ifstream fin;
+	bool bFirstLine = true;
+	bool bFormat = false;
 
-	// Open the file and read the MS3D header data
-	fin.open( filename.c_str(), std::ios::in );
-
-	if(!fin.is_open())
+	while ( true )
 	{
-		// signal error - bad filename?
-		throw new std::exception( "Could not open file" );
-	}
+		const char* pLineEnd = cursor.pCurrent;
+		while ( pLineEnd < cursor.pEnd && *pLineEnd != '\n' )
+			pLineEnd++;
 
-	// Parse the input
-	std::string txt;
+		if ( pLineEnd == cursor.pEnd )
+			throw new std::exception( "File header is not terminated with 'end_header'" );
 
-	// Read in header
-	std::getline(fin, txt);
-
-	if( 0 != txt.compare( "ply" ) )
-	{
-		// signal error - not a PLY format file
-		throw new std::exception( "File does not contain the correct header - 'PLY' expected." );
-	}
+		std::istringstream line( std::string( cursor.pCurrent, pLineEnd ) );
+		cursor.pCurrent = pLineEnd + 1;
 
-	std::getline(fin, txt);
+		std::string keyword;
+		line >> keyword;
 
-	if( 0 != txt.compare( "format ascii 1.0" ) )
-	{
-		// signal error - not a format of PLY that this code supports
-		throw new std::exception( "File is not correct format - ASCII 1.0 expected." );
-	}
-
-	std::vector< PlyElementDesc > elements;
-
-	// Read in the rest of the header
-	while(fin.is_open() && !fin.eof())
-	{
-		// Grab the next line of the header
-		std::getline(fin, txt);
-
-		// If we're at the end then stop processing
-		if(0 == txt.compare("end_header"))
+		if ( bFirstLine )
 		{
-			break;
-		}
-		// If this line is a comment, skip to the next line
-		else if(0 == txt.compare(0, 7, "comment"))
-		{
-			continue;
-		}
-		// If this line is an element, process it
-		else if(0 == txt.compare(0, 7, "element"))
-		{
-			elements.push_back(ParsePLYElementHeader( txt, fin ));
+			// signal error - not a PLY format file
+			if ( 0 != keyword.compare( "ply" ) )
+				throw new std::exception( "File does not contain the correct header - 'PLY' expected." );
+
+			bFirstLine = false;
 		}
-		// Otherwise, wtf?
-		else
+		else if ( 0 == keyword.compare( "format" ) )
 		{
-			throw new std::exception("File header contains unexpected line beginning");
-		}
-	}
-
-	// Read all the raw data
-	for( std::vector< PlyElementDesc >::iterator it = elements.begin(); it != elements.end(); ++it)
-	{
-		(*it).data = ReadPLYElementData(fin, *it);
-	}
-
-	// Create a resource to contain the geometry
-	GeometryPtr MeshPtr = GeometryPtr( new GeometryDX11() );
+			std::string format;
+			std::string version;
+			line >> format >> version;
+
+			if ( 0 == format.compare( "ascii" ) )
+				cursor.format = PLY_ASCII;
+			else if ( 0 == format.compare( "binary_little_endian" ) )
+				cursor.format = PLY_BINARY_LITTLE_ENDIAN;
+			else if ( 0 == format.compare( "binary_big_endian" ) )
+				cursor.format = PLY_BINARY_BIG_ENDIAN;
+			else
+				throw new std::exception( "File is not a supported format - ascii or binary expected." );
 
-	// Convert data to D3D11 format
-	int elemIdx = -1;
+			if ( 0 != version.compare( "1.0" ) )
+				throw new std::exception( "File is not a supported format - version 1.0 expected." );
 
-	// Pull out all the vertex data
-	if(-1 < (elemIdx = FindPlyElementIndex(elements, "vertex")))
-	{
-		PlyElementDesc d = elements.at( elemIdx );
-		
-		// Has positions?
-		int xIdx = FindPlyElementPropertyIndex( d.dataFormat, "x" );
-		int yIdx = FindPlyElementPropertyIndex( d.dataFormat, "y" );
-		int zIdx = FindPlyElementPropertyIndex( d.dataFormat, "z" );
-
-		if ((-1 != xIdx) && (-1 != yIdx) && (-1 != zIdx))
+			bFormat = true;
+		}
+		else if ( 0 == keyword.compare( "element" ) )
 		{
-			VertexElementDX11 *pPositions = new VertexElementDX11( 3, d.elementCount );
-			pPositions->m_SemanticName = VertexElementDX11::PositionSemantic;
-			pPositions->m_uiSemanticIndex = 0;
-			pPositions->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
-			pPositions->m_uiInputSlot = 0;
-			pPositions->m_uiAlignedByteOffset = 0;
-			pPositions->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-			pPositions->m_uiInstanceDataStepRate = 0;
-
-			Vector3f* pRawPos = pPositions->Get3f( 0 );
-
-			for(int v = 0; v < d.elementCount; ++v)
-			{
-				void** raw = d.data.at(v);
-
-				float x = *reinterpret_cast<float*>(raw[xIdx]);
-				float y = *reinterpret_cast<float*>(raw[yIdx]);
-				float z = *reinterpret_cast<float*>(raw[zIdx]);
+			PlyElementDesc desc;
+			desc.elementCount = 0;
+			line >> desc.name >> desc.elementCount;
 
-				pRawPos[v] = Vector3f( x, y, z );
-			}
+			if ( line.fail() )
+				throw new std::exception( "File header contains a malformed element" );
 
-			MeshPtr->AddElement( pPositions );
+			elements.push_back( desc );
 		}
+		else if ( 0 == keyword.compare( "property" ) )
+		{
+			if ( elements.empty() )
+				throw new std::exception( "File header contains a property outside of an element" );
 
-		// Has normals?
-		int nxIdx = FindPlyElementPropertyIndex( d.dataFormat, "nx" );
-		int nyIdx = FindPlyElementPropertyIndex( d.dataFormat, "ny" );
-		int nzIdx = FindPlyElementPropertyIndex( d.dataFormat, "nz" );
+			PlyPropertyDesc prop;
+			std::string type;
+			line >> type;
 
-		if ((-1 != nxIdx) && (-1 != nyIdx) && (-1 != nzIdx))
-		{
-			VertexElementDX11 *pNormals = new VertexElementDX11( 3, d.elementCount );
-			pNormals->m_SemanticName = VertexElementDX11::NormalSemantic;
-			pNormals->m_uiSemanticIndex = 0;
-			pNormals->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
-			pNormals->m_uiInputSlot = 0;
-			pNormals->m_uiAlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-			pNormals->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-			pNormals->m_uiInstanceDataStepRate = 0;
-
-			Vector3f* pRawNorms = pNormals->Get3f( 0 );
-
-			for(int v = 0; v < d.elementCount; ++v)
+			if ( 0 == type.compare( "list" ) )
 			{
-				void** raw = d.data.at(v);
+				std::string lengthType;
+				line >> lengthType >> type;
 
-				float x = *reinterpret_cast<float*>(raw[nxIdx]);
-				float y = *reinterpret_cast<float*>(raw[nyIdx]);
-				float z = *reinterpret_cast<float*>(raw[nzIdx]);
-
-				pRawNorms[v] = Vector3f( x, y, z );
+				prop.isList = true;
+				prop.listLengthType = ParsePlyScalarType( lengthType );
+			}
+			else
+			{
+				prop.isList = false;
+				prop.listLengthType = PLY_INVALID;
 			}
 
-			MeshPtr->AddElement( pNormals );
-		}
-	}
-	else
-	{
-		throw new std::exception("Expected a 'vertex' element, but not found");
-	}
+			prop.type = ParsePlyScalarType( type );
+			line >> prop.name;
 
-	// Pull out all the face index data
-	if(-1 < (elemIdx = FindPlyElementIndex(elements, "face")))
-	{
-		PlyElementDesc d = elements.at( elemIdx );
+			if ( line.fail() || prop.type == PLY_INVALID || ( prop.isList && prop.listLengthType == PLY_INVALID ) )
+				throw new std::exception( "File header contains a malformed property" );
 
-		// Firstly, assert that the format is correct
-		if((1 != d.dataFormat.size()) && d.dataFormat.at(0).isList && (0 == d.dataFormat.at(0).type.compare("uint")))
+			elements.back().properties.push_back( prop );
+		}
+		else if ( 0 == keyword.compare( "end_header" ) )
 		{
-			// Expect a single list of integers
-			throw new std::exception("Expected 'face' to be a single list of integers per-face");
+			break;
 		}
-
-		// Secondly, assert that each list is of the same dimension
-		int faceSize = -1;
-		for(int f = 0; f < d.elementCount; ++f)
+		else if ( 0 == keyword.compare( "comment" ) || 0 == keyword.compare( "obj_info" ) || keyword.empty() )
 		{
-			void** raw = d.data.at(f);
-			PlyDataArray<int>* idxs = reinterpret_cast<PlyDataArray<int>*>(raw[0]);
-			
-			if( -1 == faceSize)
-				faceSize = idxs->length;
-			else if(faceSize != idxs->length)
-				throw new std::exception("Expected each face to have the same number of indexes");
+			continue;
 		}
-
-		if(withAdjacency)
+		else
 		{
-			MeshPtr->SetPrimitiveType( (D3D11_PRIMITIVE_TOPOLOGY)(D3D11_PRIMITIVE_TOPOLOGY_1_CONTROL_POINT_PATCHLIST + ((2*faceSize) - 1)) );
-
-			// Grab all of the faces so we can search for adjacency
-			int* pRaw = new int[d.elementCount * faceSize];
+			throw new std::exception( "File header contains unexpected line beginning" );
+		}
+	}
 
-			int pRawIdx = 0;
+	if ( !bFormat )
+		throw new std::exception( "File header does not declare a format" );
+}
+//--------------------------------------------------------------------------------
+GeometryLoaderDX11::PlyScalarType GeometryLoaderDX11::ParsePlyScalarType( const std::string& name )
+{
+	// Both the original type names and the sized aliases are accepted.
+
+	if ( name == "char" || name == "int8" )				return( PLY_CHAR );
+	if ( name == "uchar" || name == "uint8" )			return( PLY_UCHAR );
+	if ( name == "short" || name == "int16" )			return( PLY_SHORT );
+	if ( name == "ushort" || name == "uint16" )			return( PLY_USHORT );
+	if ( name == "int" || name == "int32" )				return( PLY_INT );
+	if ( name == "uint" || name == "uint32" )			return( PLY_UINT );
+	if ( name == "float" || name == "float32" )			return( PLY_FLOAT );
+	if ( name == "double" || name == "float64" )		return( PLY_DOUBLE );
+
+	return( PLY_INVALID );
+}
+//--------------------------------------------------------------------------------
+double GeometryLoaderDX11::ReadPlyValue( PlyCursor& cursor, PlyScalarType type )
+{
+	if ( cursor.format == PLY_ASCII )
+		return( ReadPlyAsciiValue( cursor ) );
 
-			for(int f = 0; f < d.elementCount; ++f)
-			{
-				void** raw = d.data.at(f);
-				PlyDataArray<int>* idxs = reinterpret_cast<PlyDataArray<int>*>(raw[0]);
+	const unsigned int size = PlyScalarSizes[type];
 
-				for(unsigned int fi = 0; fi < idxs->length; ++fi)
-					pRaw[pRawIdx++] = idxs->data[fi];
-			}
+	if ( static_cast<size_t>( cursor.pEnd - cursor.pCurrent ) < size ) {
+		cursor.error = true;
+		return( 0.0 );
+	}
 
-			// We can now go and add the actual indices
-			for(int f = 0; f < (d.elementCount * faceSize); f+=3)
-			{
-				MeshPtr->AddIndex( pRaw[f + 0] );
-				MeshPtr->AddIndex( pRaw[f + 1] );
-				MeshPtr->AddIndex( pRaw[f + 2] );
-
-				// We now need to find an adjacency for each
-				// edge where possible
-				int a0 = FindAdjacentIndex( pRaw[f + 0], pRaw[f + 1], pRaw[f + 2], pRaw, d.elementCount * faceSize );
-				int a1 = FindAdjacentIndex( pRaw[f + 1], pRaw[f + 2], pRaw[f + 0], pRaw, d.elementCount * faceSize );
-				int a2 = FindAdjacentIndex( pRaw[f + 2], pRaw[f + 0], pRaw[f + 1], pRaw, d.elementCount * faceSize );
-
-				std::wstringstream out;
-				out << "Actual indices <" << pRaw[f+0] << ", " << pRaw[f+1] << ", " << pRaw[f+2] << "> have adjacency <" << a0 << ", " << a1 << ", " << a2 << ">.";
-				OutputDebugString( out.str().c_str() );
-				OutputDebugString( L"\n" );
-
-				MeshPtr->AddIndex( a0 );
-				MeshPtr->AddIndex( a1 );
-				MeshPtr->AddIndex( a2 );
-			}
+	// Copy the bytes out of the mapped view, which may not be aligned for the
+	// type, and swap them if the file order differs from the x86 order.
 
-			delete[] pRaw;
-		}
-		else
-		{
-			// Thirdly, can now set the appropriate topology
-			MeshPtr->SetPrimitiveType( (D3D11_PRIMITIVE_TOPOLOGY)(D3D11_PRIMITIVE_TOPOLOGY_1_CONTROL_POINT_PATCHLIST + (faceSize - 1)) );
+	unsigned char bytes[8];
+	memcpy( bytes, cursor.pCurrent, size );
+	cursor.pCurrent += size;
 
-			// Finally, extract this data
-			for(int f = 0; f < d.elementCount; ++f)
-			{
-				void** raw = d.data.at(f);
-				PlyDataArray<int>* idxs = reinterpret_cast<PlyDataArray<int>*>(raw[0]);
+	if ( cursor.format == PLY_BINARY_BIG_ENDIAN )
+		std::reverse( bytes, bytes + size );
 
-				for(unsigned int fi = 0; fi < idxs->length; ++fi)
-					MeshPtr->AddIndex( idxs->data[fi] );
-			}
-		}
-	}
-	else
+	switch ( type )
 	{
-		throw new std::exception("Expected a 'face' element, but not found");
+	case PLY_CHAR:		{ signed char v;		memcpy( &v, bytes, 1 ); return( v ); }
+	case PLY_UCHAR:		{ unsigned char v;		memcpy( &v, bytes, 1 ); return( v ); }
+	case PLY_SHORT:		{ short v;				memcpy( &v, bytes, 2 ); return( v ); }
+	case PLY_USHORT:	{ unsigned short v;		memcpy( &v, bytes, 2 ); return( v ); }
+	case PLY_INT:		{ int v;				memcpy( &v, bytes, 4 ); return( v ); }
+	case PLY_UINT:		{ unsigned int v;		memcpy( &v, bytes, 4 ); return( v ); }
+	case PLY_FLOAT:		{ float v;				memcpy( &v, bytes, 4 ); return( v ); }
+	case PLY_DOUBLE:	{ double v;				memcpy( &v, bytes, 8 ); return( v ); }
+	default:			cursor.error = true; return( 0.0 );
 	}
+}
+//--------------------------------------------------------------------------------
+double GeometryLoaderDX11::ReadPlyAsciiValue( PlyCursor& cursor )
+{
+	// Parse a decimal number in place.  The mapped view isn't null terminated,
+	// so the library conversion functions can't be used safely here.
 
-	// Push into renderable resource
-	MeshPtr->LoadToBuffers( );
+	const char* p = cursor.pCurrent;
+	const char* end = cursor.pEnd;
 
-	// Release all intermediary memory
-	for( std::vector< PlyElementDesc >::iterator it = elements.begin(); it != elements.end(); ++it)
-	{
-		PlyElementDesc d = *it;
-		for(int e = 0; e < d.elementCount; ++e)
-		{
-			void** raw = d.data.at(e);
+	while ( p < end && ( *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' ) )
+		p++;
 
-			if(d.dataFormat.at(0).isList)
-			{
-				PlyDataArray<void*>* rawArray = reinterpret_cast<PlyDataArray<void*>*>(raw[0]);
-				SAFE_DELETE_ARRAY( rawArray->data );
-				SAFE_DELETE(raw[0]);
-			}
-			else
-			{
-				SAFE_DELETE(raw[0]);
+	bool bNegative = false;
+	if ( p < end && ( *p == '-' || *p == '+' ) )
+		bNegative = ( *p++ == '-' );
+
+	unsigned long long mantissa = 0;
+	int exponent = 0;
+	int digits = 0;
+
+	// Digits beyond what the mantissa can hold only affect the exponent.
+
+	for ( ; p < end && *p >= '0' && *p <= '9'; p++, digits++ ) {
+		if ( mantissa < 100000000000000000ull )
+			mantissa = mantissa * 10 + ( *p - '0' );
+		else
+			exponent++;
+	}
+
+	if ( p < end && *p == '.' )
+	{
+		for ( p++; p < end && *p >= '0' && *p <= '9'; p++, digits++ ) {
+			if ( mantissa < 100000000000000000ull ) {
+				mantissa = mantissa * 10 + ( *p - '0' );
+				exponent--;
 			}
 		}
 	}
 
-	// Return to caller
-	return MeshPtr;
-}
+	if ( digits == 0 ) {
+		cursor.error = true;
+		return( 0.0 );
+	}
 
-int GeometryLoaderDX11::FindAdjacentIndex( int edgeStart, int edgeEnd, int triV, int* pRaw, int rawLen)
-{
-	for(int f = 0; f < rawLen; f+=3)
+	if ( p < end && ( *p == 'e' || *p == 'E' ) )
 	{
-		int esIdx = -1;
-		for( int i = 0; i < 3; ++i ) { if(pRaw[f+i]==edgeStart) esIdx = i; }
+		const char* pExponent = p + 1;
+		bool bNegativeExponent = false;
 
-		int eeIdx = -1;
-		for( int i = 0; i < 3; ++i ) { if(pRaw[f+i]==edgeEnd) eeIdx = i; }
+		if ( pExponent < end && ( *pExponent == '-' || *pExponent == '+' ) )
+			bNegativeExponent = ( *pExponent++ == '-' );
 
-		if((-1!=esIdx)&&(-1!=eeIdx))
+		if ( pExponent < end && *pExponent >= '0' && *pExponent <= '9' )
 		{
-			int oIdx = -1;
-			for(int i = 0; i < 3; ++i) { if((i!=esIdx) && (i!=eeIdx)) oIdx = i; }
+			int value = 0;
+			for ( ; pExponent < end && *pExponent >= '0' && *pExponent <= '9'; pExponent++ ) {
+				if ( value < 10000 )
+					value = value * 10 + ( *pExponent - '0' );
+			}
 
-			if(pRaw[f+oIdx]!=triV)
-				return pRaw[f + oIdx];
+			exponent += bNegativeExponent ? -value : value;
+			p = pExponent;
 		}
 	}
 
-	return edgeStart;
-}
+	// A value has to be followed by a separator, so that text such as "1.0-2.0"
+	// is rejected instead of being read as two values.
 
-GeometryLoaderDX11::PlyElementDesc GeometryLoaderDX11::ParsePLYElementHeader(std::string headerLine, std::ifstream& input)
-{
-	GeometryLoaderDX11::PlyElementDesc desc;
-	std::string txt;
-
-	// Parse the header line
-	// "element <name> <count>"
-	int split = headerLine.find_first_of(' ', 8);
-	desc.name = headerLine.substr(8, split - 8);
-		
-	split = headerLine.rfind( ' ' );
-	std::istringstream elemCount(headerLine.substr(split, headerLine.length() - split));
-	elemCount >> desc.elementCount;
-
-	// Parse any attached properties
-	while(input.is_open() && !input.eof())
-	{
-		std::getline( input, txt );
-
-		if(0 == txt.compare(0, 13, "property list"))
-		{
-			// Parse this property list declaration
-			desc.dataFormat.push_back(ParsePLYElementPropertyList(txt.substr(14, txt.length() - 14)));
-		}
-		else if(0 == txt.compare(0, 8, "property"))
-		{
-			// Parse this property declaration
-			desc.dataFormat.push_back(ParsePLYElementProperty(txt.substr(9, txt.length() - 9)));
-		}
-		else
-		{
-			// At this point we'll also have read a line too far so
-			// need to "unread" it to avoid breaking remaining parsing.
-			input.putback('\n');
-			for(int i = -1 + txt.length(); i >= 0; i--)
-				input.putback(txt.at(i));
-			// (there must be a better way, no?!?)
-			break;
-		}
+	if ( p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n' ) {
+		cursor.error = true;
+		return( 0.0 );
 	}
 
-	return desc;
-}
+	cursor.pCurrent = p;
 
-GeometryLoaderDX11::PlyElementPropertyDeclaration GeometryLoaderDX11::ParsePLYElementProperty(std::string desc)
-{
-	// <type> <name>
-	GeometryLoaderDX11::PlyElementPropertyDeclaration decl;
-	decl.isList = false;
-
-	int split = desc.find(' ');
+	double result = static_cast<double>( mantissa );
 
-	decl.type = desc.substr(0, split);
-	decl.name = desc.substr(split + 1, desc.length() - (split + 1));
+	if ( exponent != 0 )
+		result *= pow( 10.0, exponent );
 
-	return decl;
+	return( bNegative ? -result : result );
 }
-
-GeometryLoaderDX11::PlyElementPropertyDeclaration GeometryLoaderDX11::ParsePLYElementPropertyList(std::string desc)
+//--------------------------------------------------------------------------------
+void GeometryLoaderDX11::SkipPlyProperty( PlyCursor& cursor, const PlyPropertyDesc& prop )
 {
-	// <length_type> <element_type> <name>
-	GeometryLoaderDX11::PlyElementPropertyDeclaration decl;
-	decl.isList = true;
-
-	int split = desc.find(' ');
-	decl.listLengthType = desc.substr(0, split);
-
-	decl.type = desc.substr(split + 1, desc.rfind(' ') - (split + 1));
-
-	split = desc.rfind(' ') + 1;
-	decl.name = desc.substr(split, desc.length() - split);
+	if ( prop.isList )
+	{
+		const unsigned int count = static_cast<unsigned int>( ReadPlyValue( cursor, prop.listLengthType ) );
 
-	return decl;
+		for ( unsigned int i = 0; i < count && !cursor.error; i++ )
+			ReadPlyValue( cursor, prop.type );
+	}
+	else
+	{
+		ReadPlyValue( cursor, prop.type );
+	}
 }
-
-std::vector<void**> GeometryLoaderDX11::ReadPLYElementData(std::ifstream& input, const GeometryLoaderDX11::PlyElementDesc& desc)
+//--------------------------------------------------------------------------------
+size_t GeometryLoaderDX11::GetPlyMinimumSize( const PlyCursor& cursor, const PlyElementDesc& desc )
 {
-	std::vector<void**> raw;
+	// Each value takes at least one character in an ASCII file, and a list may
+	// be empty, so only its length counts.  The result is never zero, so that
+	// it can be used as a divisor.
 
-	for(int i = 0; i < desc.elementCount; ++i)
-	{
-		std::string txt;
-		std::getline(input, txt);
+	size_t size = 0;
 
-		raw.push_back(ParsePLYElementData(txt, desc.dataFormat));
+	for ( auto& prop : desc.properties )
+	{
+		if ( cursor.format == PLY_ASCII )
+			size += 1;
+		else
+			size += PlyScalarSizes[prop.isList ? prop.listLengthType : prop.type];
 	}
 
-	return raw;
+	return( std::max( size, static_cast<size_t>( 1 ) ) );
 }
-
-void** GeometryLoaderDX11::ParsePLYElementData(std::string text, const std::vector<PlyElementPropertyDeclaration>& desc)
+//--------------------------------------------------------------------------------
+void GeometryLoaderDX11::SkipPlyElement( PlyCursor& cursor, const PlyElementDesc& desc )
 {
-	void** parsed;
-
-	parsed = new void*[desc.size()];
+	for ( unsigned int i = 0; i < desc.elementCount && !cursor.error; i++ ) {
+		for ( auto& prop : desc.properties ) {
+			SkipPlyProperty( cursor, prop );
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+void GeometryLoaderDX11::ReadPlyVertices( PlyCursor& cursor, const PlyElementDesc& desc, GeometryPtr pGeometry )
+{
+	// Has positions?
+	const int xIdx = FindPlyPropertyIndex( desc.properties, "x" );
+	const int yIdx = FindPlyPropertyIndex( desc.properties, "y" );
+	const int zIdx = FindPlyPropertyIndex( desc.properties, "z" );
 
-	std::vector<std::string> tokens;
-	std::istringstream is (text);
-	std::string tmps;
-    while (is.good()) {
-        is >> tmps;
-		tokens.push_back(tmps);
-    }
+	// Has normals?
+	const int nxIdx = FindPlyPropertyIndex( desc.properties, "nx" );
+	const int nyIdx = FindPlyPropertyIndex( desc.properties, "ny" );
+	const int nzIdx = FindPlyPropertyIndex( desc.properties, "nz" );
 
+	Vector3f* pRawPos = nullptr;
+	Vector3f* pRawNorms = nullptr;
 
-	unsigned int e = 0;
-	for(std::vector<std::string>::iterator it = tokens.begin(); it != tokens.end(); ++it)
+	if ( ( -1 != xIdx ) && ( -1 != yIdx ) && ( -1 != zIdx ) )
 	{
-		if( e >= desc.size())
-			break;
+		VertexElementDX11 *pPositions = new VertexElementDX11( 3, desc.elementCount );
+		pPositions->m_SemanticName = VertexElementDX11::PositionSemantic;
+		pPositions->m_uiSemanticIndex = 0;
+		pPositions->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
+		pPositions->m_uiInputSlot = 0;
+		pPositions->m_uiAlignedByteOffset = 0;
+		pPositions->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		pPositions->m_uiInstanceDataStepRate = 0;
+
+		pRawPos = pPositions->Get3f( 0 );
+		pGeometry->AddElement( pPositions );
+	}
 
-		if(desc[e].isList)
-		{
-			// Read this as length
-			int arrLen = 0;
+	if ( ( -1 != nxIdx ) && ( -1 != nyIdx ) && ( -1 != nzIdx ) )
+	{
+		VertexElementDX11 *pNormals = new VertexElementDX11( 3, desc.elementCount );
+		pNormals->m_SemanticName = VertexElementDX11::NormalSemantic;
+		pNormals->m_uiSemanticIndex = 0;
+		pNormals->m_Format = DXGI_FORMAT_R32G32B32_FLOAT;
+		pNormals->m_uiInputSlot = 0;
+		pNormals->m_uiAlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+		pNormals->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		pNormals->m_uiInstanceDataStepRate = 0;
+
+		pRawNorms = pNormals->Get3f( 0 );
+		pGeometry->AddElement( pNormals );
+	}
 
-			arrLen = ExtractDataVal<int>(*it);
+	// Each vertex is read into a scratch array of its scalar properties, which
+	// is then scattered into the vertex elements.
+	std::vector< float > values( desc.properties.size(), 0.0f );
 
-			// Size up the type
-			if(0 == desc[e].type.compare("char"))
-			{
-				parsed[e] = ExtractDataPtrArray<char>(arrLen, it);
-			}
-			else if(0 == desc[e].type.compare("uchar"))
-			{
-				parsed[e] = ExtractDataPtrArray<unsigned char>(arrLen, it);
-			}
-			else if(0 == desc[e].type.compare("short"))
-			{
-				parsed[e] = ExtractDataPtrArray<short>(arrLen, it);
-			}
-			else if(0 == desc[e].type.compare("ushort"))
-			{
-				parsed[e] = ExtractDataPtrArray<unsigned short>(arrLen, it);
-			}
-			else if(0 == desc[e].type.compare("int"))
-			{
-				parsed[e] = ExtractDataPtrArray<int>(arrLen, it);
-			}
-			else if(0 == desc[e].type.compare("uint"))
-			{
-				parsed[e] = ExtractDataPtrArray<unsigned int>(arrLen, it);
-			}
-			else if(0 == desc[e].type.compare("float"))
-			{
-				parsed[e] = ExtractDataPtrArray<float>(arrLen, it);
-			}
-			else if(0 == desc[e].type.compare("double"))
-			{
-				parsed[e] = ExtractDataPtrArray<double>(arrLen, it);
-			}
-			else
-			{
-				// wtf?
-			}
-		}
-		else
+	for ( unsigned int v = 0; v < desc.elementCount && !cursor.error; v++ )
+	{
+		for ( unsigned int p = 0; p < desc.properties.size(); p++ )
 		{
-			if(0 == desc[e].type.compare("char"))
-			{
-				parsed[e] = ExtractDataPtr<char>(*it);
-			}
-			else if(0 == desc[e].type.compare("uchar"))
-			{
-				parsed[e] = ExtractDataPtr<unsigned char>(*it);
-			}
-			else if(0 == desc[e].type.compare("short"))
-			{
-				parsed[e] = ExtractDataPtr<short>(*it);
-			}
-			else if(0 == desc[e].type.compare("ushort"))
-			{
-				parsed[e] = ExtractDataPtr<unsigned short>(*it);
-			}
-			else if(0 == desc[e].type.compare("int"))
-			{
-				parsed[e] = ExtractDataPtr<int>(*it);
-			}
-			else if(0 == desc[e].type.compare("uint"))
-			{
-				parsed[e] = ExtractDataPtr<unsigned int>(*it);
-			}
-			else if(0 == desc[e].type.compare("float"))
-			{
-				parsed[e] = ExtractDataPtr<float>(*it);
-			}
-			else if(0 == desc[e].type.compare("double"))
-			{
-				parsed[e] = ExtractDataPtr<double>(*it);
-			}
+			if ( desc.properties[p].isList )
+				SkipPlyProperty( cursor, desc.properties[p] );
 			else
-			{
-				// wtf?
-			}
+				values[p] = static_cast<float>( ReadPlyValue( cursor, desc.properties[p].type ) );
 		}
 
-		++e;
-	}
+		if ( pRawPos )
+			pRawPos[v] = Vector3f( values[xIdx], values[yIdx], values[zIdx] );
 
-	return parsed;
+		if ( pRawNorms )
+			pRawNorms[v] = Vector3f( values[nxIdx], values[nyIdx], values[nzIdx] );
+	}
 }
-
-template<typename T> T* GeometryLoaderDX11::ExtractDataPtr(std::string input)
+//--------------------------------------------------------------------------------
+void GeometryLoaderDX11::ReadPlyFaces( PlyCursor& cursor, const PlyElementDesc& desc, unsigned int vertexCount, std::vector<UINT>& indices, int& faceSize )
 {
-	T* t = new T;
+	// The face indices are the list named 'vertex_indices' (or 'vertex_index' 
+	// in some exporters), otherwise the first list in the element.
+	int listIdx = FindPlyPropertyIndex( desc.properties, "vertex_indices" );
 
-	std::istringstream iss(input);
+	if ( -1 == listIdx )
+		listIdx = FindPlyPropertyIndex( desc.properties, "vertex_index" );
 
-	iss >> *t;
+	for ( int p = 0; p < static_cast<int>( desc.properties.size() ) && -1 == listIdx; p++ ) {
+		if ( desc.properties[p].isList )
+			listIdx = p;
+	}
 
-	return t;
-}
+	if ( -1 == listIdx || !desc.properties[listIdx].isList )
+		throw new std::exception( "Expected 'face' to contain a list of integers per-face" );
 
-template<typename T> T GeometryLoaderDX11::ExtractDataVal(std::string input)
-{
-	T t;
+	// Every face holds at least one index, so the reservation is limited to the
+	// faces that the rest of the file could hold, whatever the header claims.
+	const PlyPropertyDesc& list = desc.properties[listIdx];
+	const size_t faceBytes = GetPlyMinimumSize( cursor, desc ) + ( cursor.format == PLY_ASCII ? 1 : PlyScalarSizes[list.type] );
+	const size_t faceLimit = static_cast<size_t>( cursor.pEnd - cursor.pCurrent ) / faceBytes;
 
-	std::istringstream iss(input);
+	indices.reserve( indices.size() + std::min( static_cast<size_t>( desc.elementCount ), faceLimit ) * 3 );
 
-	iss >> t;
+	for ( unsigned int f = 0; f < desc.elementCount && !cursor.error; f++ )
+	{
+		for ( int p = 0; p < static_cast<int>( desc.properties.size() ); p++ )
+		{
+			const PlyPropertyDesc& prop = desc.properties[p];
 
-	return t;
-}
+			if ( p != listIdx ) {
+				SkipPlyProperty( cursor, prop );
+				continue;
+			}
 
-template<typename T> GeometryLoaderDX11::PlyDataArray<T>* GeometryLoaderDX11::ExtractDataPtrArray(int length, std::vector<std::string>::iterator iterator)
-{
-	PlyDataArray<T>* t = new PlyDataArray<T>;
-	t->length = length;
-	t->data = new T[length];
+			const double length = ReadPlyValue( cursor, prop.listLengthType );
 
-	for(int i = 0; i < length; ++i)
-	{
-		std::istringstream iss(*(++iterator));
-		iss >> t->data[i];
-	}
+			if ( cursor.error )
+				return;
 
-	return t;
-}
+			// The faces are drawn as patches, which have 1 to 32 control points.
+			if ( !( length >= 1.0 && length <= 32.0 ) )
+				throw new std::exception( "Expected each face to have between 1 and 32 indexes" );
 
+			const int count = static_cast<int>( length );
 
+			// Assert that each list is of the same dimension
+			if ( -1 == faceSize )
+				faceSize = count;
+			else if ( faceSize != count )
+				throw new std::exception( "Expected each face to have the same number of indexes" );
+
+			for ( int i = 0; i < count; i++ )
+			{
+				const double index = ReadPlyValue( cursor, prop.type );
 
-int GeometryLoaderDX11::FindPlyElementIndex(std::vector<PlyElementDesc> elems, std::string name)
+				if ( !( index >= 0.0 && index < vertexCount ) )
+					throw new std::exception( "Face index is outside of the vertex list" );
+
+				indices.push_back( static_cast<UINT>( index ) );
+			}
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+int GeometryLoaderDX11::FindPlyElementIndex( const std::vector<PlyElementDesc>& elems, const std::string& name )
 {
-	for(unsigned int idx = 0; idx < elems.size(); ++idx)
-		if(0 == elems.at(idx).name.compare(name))
+	for ( unsigned int idx = 0; idx < elems.size(); ++idx )
+		if ( 0 == elems[idx].name.compare( name ) )
 			return idx;
 
 	return -1;
 }
-
-int GeometryLoaderDX11::FindPlyElementPropertyIndex(std::vector<PlyElementPropertyDeclaration> elems, std::string name)
+//--------------------------------------------------------------------------------
+int GeometryLoaderDX11::FindPlyPropertyIndex( const std::vector<PlyPropertyDesc>& props, const std::string& name )
 {
-	for(unsigned int idx = 0; idx < elems.size(); ++idx)
-		if(0 == elems.at(idx).name.compare(name))
+	for ( unsigned int idx = 0; idx < props.size(); ++idx )
+		if ( 0 == props[idx].name.compare( name ) )
 			return idx;
 
 	return -1;
-}
\ No newline at end of file
+}
+//--------------------------------------------------------------------------------
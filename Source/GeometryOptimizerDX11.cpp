@@ -0,0 +1,508 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "GeometryOptimizerDX11.h"
+#include "Log.h"
+#include <sstream>
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+static const UINT InvalidIndex = 0xffffffff;
+//--------------------------------------------------------------------------------
+// Vertex scoring constants from Tom Forsyth's "Linear-Speed Vertex Cache
+// Optimisation".  The three most recently used vertices get a fixed score, so
+// that the next triangle doesn't simply reuse the last triangle's edge, and
+// vertices with few remaining triangles are boosted so they get finished off.
+//--------------------------------------------------------------------------------
+static const float CacheDecayPower = 1.5f;
+static const float LastTriangleScore = 0.75f;
+static const float ValenceBoostScale = 2.0f;
+static const float ValenceBoostPower = 0.5f;
+//--------------------------------------------------------------------------------
+static float VertexScore( int cachePosition, unsigned int remaining, unsigned int cacheSize )
+{
+	// Vertices without any remaining triangles are no longer of interest.
+	if ( remaining == 0 )
+		return( -1.0f );
+
+	float score = 0.0f;
+
+	if ( cachePosition >= 0 )
+	{
+		// The decay needs at least one cache entry past the last triangle, so a
+		// smaller cache only scores the last triangle.
+		if ( cachePosition < 3 || cacheSize <= 3 )
+		{
+			score = LastTriangleScore;
+		}
+		else
+		{
+			const float scaler = 1.0f / static_cast<float>( cacheSize - 3 );
+			score = 1.0f - static_cast<float>( cachePosition - 3 ) * scaler;
+			score = powf( score, CacheDecayPower );
+		}
+	}
+
+	score += ValenceBoostScale * powf( static_cast<float>( remaining ), -ValenceBoostPower );
+
+	return( score );
+}
+//--------------------------------------------------------------------------------
+GeometryOptimizerDX11::GeometryOptimizerDX11()
+{
+}
+//--------------------------------------------------------------------------------
+bool GeometryOptimizerDX11::IsTriangleList( GeometryPtr pGeometry )
+{
+	const D3D11_PRIMITIVE_TOPOLOGY topology = pGeometry->GetPrimitiveType();
+
+	return( ( topology == D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST
+		|| topology == D3D11_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST )
+		&& pGeometry->m_vIndices.size() % 3 == 0 );
+}
+//--------------------------------------------------------------------------------
+void GeometryOptimizerDX11::Optimize( GeometryPtr pGeometry )
+{
+	WeldVertices( pGeometry );
+	OptimizeVertexCache( pGeometry );
+	OptimizeVertexFetch( pGeometry );
+}
+//--------------------------------------------------------------------------------
+unsigned int GeometryOptimizerDX11::WeldVertices( GeometryPtr pGeometry )
+{
+	if ( !pGeometry || !IsTriangleList( pGeometry ) || pGeometry->m_vElements.empty() )
+		return( 0 );
+
+	const unsigned int vertexCount = static_cast<unsigned int>( pGeometry->CalculateVertexCount() );
+	std::vector<VertexElementDX11*>& elements = pGeometry->m_vElements;
+
+	for ( auto pElement : elements )
+		if ( pElement->Count() != static_cast<int>( vertexCount ) )
+			return( 0 );
+
+	for ( auto index : pGeometry->m_vIndices )
+		if ( index >= vertexCount )
+			return( 0 );
+
+	// Negative zero compares equal to zero, but has a different bit pattern, so
+	// it is folded into zero before hashing.  Everything else is compared on the
+	// exact bits, since any difference would be visible once rendered.
+
+	std::vector<unsigned int> hashes( vertexCount );
+
+	for ( unsigned int v = 0; v < vertexCount; v++ )
+	{
+		unsigned int hash = 2166136261u;
+
+		for ( auto pElement : elements )
+		{
+			const float* pData = ( *pElement )[v];
+
+			for ( int t = 0; t < pElement->Tuple(); t++ )
+			{
+				const float value = ( pData[t] == 0.0f ) ? 0.0f : pData[t];
+				unsigned int bits;
+				memcpy( &bits, &value, sizeof( bits ) );
+				hash = ( hash ^ bits ) * 16777619u;
+			}
+		}
+
+		hashes[v] = hash;
+	}
+
+	// Sort the vertices by their hash, so that identical vertices end up next to
+	// each other, and then compare each vertex with the ones before it in its run.
+
+	std::vector<UINT> order( vertexCount );
+
+	for ( unsigned int v = 0; v < vertexCount; v++ )
+		order[v] = v;
+
+	std::sort( order.begin(), order.end(), [&hashes]( UINT a, UINT b )
+	{
+		return( hashes[a] < hashes[b] || ( hashes[a] == hashes[b] && a < b ) );
+	} );
+
+	std::vector<UINT> unique( vertexCount );
+	unsigned int runStart = 0;
+
+	for ( unsigned int i = 0; i < vertexCount; i++ )
+	{
+		const UINT v = order[i];
+
+		if ( hashes[v] != hashes[order[runStart]] )
+			runStart = i;
+
+		unique[v] = v;
+
+		for ( unsigned int j = runStart; j < i; j++ )
+		{
+			const UINT candidate = order[j];
+
+			if ( unique[candidate] != candidate )
+				continue;
+
+			bool bEqual = true;
+
+			for ( auto pElement : elements )
+			{
+				const float* pA = ( *pElement )[v];
+				const float* pB = ( *pElement )[candidate];
+
+				for ( int t = 0; bEqual && t < pElement->Tuple(); t++ )
+					bEqual = ( pA[t] == pB[t] ) || ( pA[t] != pA[t] && pB[t] != pB[t] );
+
+				if ( !bEqual )
+					break;
+			}
+
+			if ( bEqual ) {
+				unique[v] = candidate;
+				break;
+			}
+		}
+	}
+
+	// Give each unique vertex its new position, keeping the original order.
+
+	std::vector<UINT> remap( vertexCount );
+	unsigned int uniqueCount = 0;
+
+	for ( unsigned int v = 0; v < vertexCount; v++ )
+	{
+		if ( unique[v] == v )
+			remap[v] = uniqueCount++;
+		else
+			remap[v] = remap[unique[v]];
+	}
+
+	if ( uniqueCount == vertexCount )
+		return( 0 );
+
+	RemapVertices( pGeometry, remap, uniqueCount );
+
+	return( vertexCount - uniqueCount );
+}
+//--------------------------------------------------------------------------------
+void GeometryOptimizerDX11::OptimizeVertexCache( GeometryPtr pGeometry, unsigned int cacheSize )
+{
+	if ( !pGeometry || !IsTriangleList( pGeometry ) )
+		return;
+
+	UINT vertexCount = static_cast<UINT>( pGeometry->CalculateVertexCount() );
+
+	for ( auto index : pGeometry->m_vIndices )
+		vertexCount = std::max( vertexCount, index + 1 );
+
+	// The result is logged when debug messages are written, which costs two
+	// passes over the indices with the simulated cache.
+
+	const bool bMeasure = Log::Get().GetMinimumLevel() <= LOG_DEBUG;
+	const float before = bMeasure ? CalculateACMR( pGeometry->m_vIndices ) : 0.0f;
+
+	OptimizeVertexCache( pGeometry->m_vIndices, vertexCount, cacheSize );
+
+	if ( bMeasure )
+	{
+		std::wstringstream message;
+		message << L"Vertex cache optimization of " << pGeometry->m_vIndices.size() / 3
+			<< L" triangles changed the ACMR from " << before << L" to " << CalculateACMR( pGeometry->m_vIndices );
+
+		Log::Get().Write( message.str(), LOG_DEBUG );
+	}
+}
+//--------------------------------------------------------------------------------
+void GeometryOptimizerDX11::OptimizeVertexCache( std::vector<UINT>& indices, unsigned int vertexCount, unsigned int cacheSize )
+{
+	const unsigned int triangleCount = static_cast<unsigned int>( indices.size() / 3 );
+
+	if ( cacheSize < 4 )
+	{
+		Log::Get().Write( L"Vertex cache optimization needs a cache of at least 4 vertices, leaving the triangle order unchanged.", LOG_WARNING );
+		return;
+	}
+
+	if ( triangleCount == 0 )
+		return;
+
+	// Build the list of triangles that use each vertex, stored as one array with
+	// an offset into it for each vertex.
+
+	std::vector<unsigned int> remaining( vertexCount, 0 );
+
+	for ( unsigned int i = 0; i < triangleCount * 3; i++ )
+		remaining[indices[i]]++;
+
+	std::vector<unsigned int> offsets( vertexCount + 1, 0 );
+
+	for ( unsigned int v = 0; v < vertexCount; v++ )
+		offsets[v + 1] = offsets[v] + remaining[v];
+
+	std::vector<unsigned int> adjacency( triangleCount * 3 );
+	std::vector<unsigned int> fill( offsets.begin(), offsets.end() - 1 );
+
+	for ( unsigned int t = 0; t < triangleCount; t++ )
+		for ( unsigned int k = 0; k < 3; k++ )
+			adjacency[fill[indices[t * 3 + k]]++] = t;
+
+	// Initial scores for every vertex and triangle.
+
+	std::vector<int> cachePosition( vertexCount, -1 );
+	std::vector<float> vertexScores( vertexCount );
+
+	for ( unsigned int v = 0; v < vertexCount; v++ )
+		vertexScores[v] = VertexScore( -1, remaining[v], cacheSize );
+
+	std::vector<float> triangleScores( triangleCount );
+	std::vector<bool> emitted( triangleCount, false );
+
+	for ( unsigned int t = 0; t < triangleCount; t++ )
+		triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+
+	// The simulated cache holds three extra entries, since up to three new
+	// vertices are pushed in before the oldest ones fall out of it.
+
+	std::vector<UINT> cache;
+	std::vector<UINT> nextCache;
+	cache.reserve( cacheSize + 3 );
+	nextCache.reserve( cacheSize + 3 );
+
+	std::vector<UINT> output;
+	output.reserve( triangleCount * 3 );
+
+	// Every emitted vertex is also pushed onto a stack of recently used vertices,
+	// which is where the search continues when the cache runs dry.
+
+	std::vector<UINT> recent;
+	recent.reserve( triangleCount * 3 );
+
+	unsigned int bestTriangle = InvalidIndex;
+	unsigned int scanPosition = 0;
+
+	for ( unsigned int emittedCount = 0; emittedCount < triangleCount; emittedCount++ )
+	{
+		// When none of the cached vertices have any triangles left, take the best
+		// triangle of the most recently used vertex that still has some, so that
+		// the order stays local.  Only if there is none left, continue with the
+		// next triangle that hasn't been emitted yet.  Each vertex is popped off
+		// the stack once for each time it was pushed, and the scan position only
+		// ever moves forward, so a dead end costs no more than the regular search
+		// through the triangles of the cached vertices.
+
+		while ( bestTriangle == InvalidIndex && !recent.empty() )
+		{
+			const UINT v = recent.back();
+			recent.pop_back();
+
+			float bestScore = -1.0f;
+
+			for ( unsigned int j = offsets[v]; j < offsets[v] + remaining[v]; j++ )
+			{
+				const unsigned int t = adjacency[j];
+
+				if ( triangleScores[t] > bestScore ) {
+					bestScore = triangleScores[t];
+					bestTriangle = t;
+				}
+			}
+		}
+
+		if ( bestTriangle == InvalidIndex )
+		{
+			while ( emitted[scanPosition] )
+				scanPosition++;
+
+			bestTriangle = scanPosition;
+		}
+
+		// Emit the triangle, and remove it from the lists of its vertices.
+
+		const UINT* pTriangle = &indices[bestTriangle * 3];
+		emitted[bestTriangle] = true;
+
+		nextCache.clear();
+
+		for ( unsigned int k = 0; k < 3; k++ )
+		{
+			const UINT v = pTriangle[k];
+			output.push_back( v );
+			recent.push_back( v );
+
+			if ( std::find( nextCache.begin(), nextCache.end(), v ) == nextCache.end() )
+				nextCache.push_back( v );
+
+			unsigned int* pBegin = &adjacency[offsets[v]];
+			unsigned int* pEnd = pBegin + remaining[v];
+			*std::find( pBegin, pEnd, bestTriangle ) = *( pEnd - 1 );
+			remaining[v]--;
+		}
+
+		for ( auto v : cache )
+			if ( v != pTriangle[0] && v != pTriangle[1] && v != pTriangle[2] )
+				nextCache.push_back( v );
+
+		cache.swap( nextCache );
+
+		// Update the scores of every vertex whose cache position has changed,
+		// including those that have just fallen out of the cache, and rescore
+		// their triangles to find the next one to emit.
+
+		for ( unsigned int i = 0; i < cache.size(); i++ )
+		{
+			const UINT v = cache[i];
+			cachePosition[v] = ( i < cacheSize ) ? static_cast<int>( i ) : -1;
+		}
+
+		for ( auto v : cache )
+		{
+			const float score = VertexScore( cachePosition[v], remaining[v], cacheSize );
+			const float delta = score - vertexScores[v];
+			vertexScores[v] = score;
+
+			for ( unsigned int i = offsets[v]; i < offsets[v] + remaining[v]; i++ )
+				triangleScores[adjacency[i]] += delta;
+		}
+
+		bestTriangle = InvalidIndex;
+		float bestScore = -1.0f;
+
+		for ( unsigned int i = 0; i < cache.size() && i < cacheSize; i++ )
+		{
+			const UINT v = cache[i];
+
+			for ( unsigned int j = offsets[v]; j < offsets[v] + remaining[v]; j++ )
+			{
+				const unsigned int t = adjacency[j];
+
+				if ( triangleScores[t] > bestScore ) {
+					bestScore = triangleScores[t];
+					bestTriangle = t;
+				}
+			}
+		}
+
+		if ( cache.size() > cacheSize )
+			cache.resize( cacheSize );
+	}
+
+	indices.swap( output );
+}
+//--------------------------------------------------------------------------------
+void GeometryOptimizerDX11::OptimizeVertexFetch( GeometryPtr pGeometry )
+{
+	if ( !pGeometry || !IsTriangleList( pGeometry ) || pGeometry->m_vElements.empty() )
+		return;
+
+	const unsigned int vertexCount = static_cast<unsigned int>( pGeometry->CalculateVertexCount() );
+
+	for ( auto pElement : pGeometry->m_vElements )
+		if ( pElement->Count() != static_cast<int>( vertexCount ) )
+			return;
+
+	for ( auto index : pGeometry->m_vIndices )
+		if ( index >= vertexCount )
+			return;
+
+	// Number the vertices in the order that the index list first references
+	// them, and keep any unreferenced vertices at the end in their old order.
+
+	std::vector<UINT> remap( vertexCount, InvalidIndex );
+	unsigned int next = 0;
+
+	for ( auto index : pGeometry->m_vIndices )
+		if ( remap[index] == InvalidIndex )
+			remap[index] = next++;
+
+	for ( unsigned int v = 0; v < vertexCount; v++ )
+		if ( remap[v] == InvalidIndex )
+			remap[v] = next++;
+
+	RemapVertices( pGeometry, remap, vertexCount );
+}
+//--------------------------------------------------------------------------------
+void GeometryOptimizerDX11::RemapVertices( GeometryPtr pGeometry, const std::vector<UINT>& remap, unsigned int vertexCount )
+{
+	// Each element is rebuilt with its vertices moved to their new positions.
+	// Vertices that were merged map to the same position, and simply copy the
+	// same data over each other.
+
+	for ( auto& pElement : pGeometry->m_vElements )
+	{
+		const int tuple = pElement->Tuple();
+		VertexElementDX11* pRemapped = new VertexElementDX11( tuple, vertexCount );
+
+		pRemapped->m_SemanticName = pElement->m_SemanticName;
+		pRemapped->m_uiSemanticIndex = pElement->m_uiSemanticIndex;
+		pRemapped->m_Format = pElement->m_Format;
+		pRemapped->m_uiInputSlot = pElement->m_uiInputSlot;
+		pRemapped->m_uiAlignedByteOffset = pElement->m_uiAlignedByteOffset;
+		pRemapped->m_InputSlotClass = pElement->m_InputSlotClass;
+		pRemapped->m_uiInstanceDataStepRate = pElement->m_uiInstanceDataStepRate;
+		pRemapped->m_Packing = pElement->m_Packing;
+
+		for ( unsigned int v = 0; v < remap.size(); v++ )
+			memcpy( ( *pRemapped )[remap[v]], ( *pElement )[v], sizeof( float ) * tuple );
+
+		delete pElement;
+		pElement = pRemapped;
+	}
+
+	for ( auto& index : pGeometry->m_vIndices )
+		index = remap[index];
+
+	pGeometry->CalculateVertexCount();
+}
+//--------------------------------------------------------------------------------
+unsigned int GeometryOptimizerDX11::CountCacheMisses( const std::vector<UINT>& indices, unsigned int cacheSize )
+{
+	// Simulates a FIFO post-transform cache, where a hit doesn't change the
+	// position of the vertex, which matches the behavior of most hardware.
+
+	std::vector<UINT> fifo( std::max( cacheSize, 1u ), InvalidIndex );
+	unsigned int head = 0;
+	unsigned int misses = 0;
+
+	for ( auto index : indices )
+	{
+		if ( std::find( fifo.begin(), fifo.end(), index ) == fifo.end() )
+		{
+			fifo[head] = index;
+			head = ( head + 1 ) % fifo.size();
+			misses++;
+		}
+	}
+
+	return( misses );
+}
+//--------------------------------------------------------------------------------
+float GeometryOptimizerDX11::CalculateACMR( const std::vector<UINT>& indices, unsigned int cacheSize )
+{
+	const unsigned int triangleCount = static_cast<unsigned int>( indices.size() / 3 );
+
+	if ( triangleCount == 0 )
+		return( 0.0f );
+
+	return( static_cast<float>( CountCacheMisses( indices, cacheSize ) ) / triangleCount );
+}
+//--------------------------------------------------------------------------------
+float GeometryOptimizerDX11::CalculateATVR( const std::vector<UINT>& indices, unsigned int cacheSize )
+{
+	std::vector<UINT> referenced( indices.begin(), indices.end() );
+	std::sort( referenced.begin(), referenced.end() );
+	const size_t vertexCount = std::unique( referenced.begin(), referenced.end() ) - referenced.begin();
+
+	if ( vertexCount == 0 )
+		return( 0.0f );
+
+	return( static_cast<float>( CountCacheMisses( indices, cacheSize ) ) / vertexCount );
+}
+//--------------------------------------------------------------------------------
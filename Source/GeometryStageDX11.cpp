@@ -45,26 +45,42 @@ void GeometryStageDX11::BindShaderProgram( ID3D11DeviceContext* pContext )
 //--------------------------------------------------------------------------------
 void GeometryStageDX11::BindConstantBuffers( ID3D11DeviceContext* pContext, int count )
 {
-	pContext->GSSetConstantBuffers( 
-		DesiredState.ConstantBuffers.GetStartSlot(),
-		DesiredState.ConstantBuffers.GetRange(),
-		DesiredState.ConstantBuffers.GetFirstSlotLocation() );
+	unsigned int slot = 0;
+	unsigned int range = 0;
+
+	while ( DesiredState.GetNextConstantBufferRange( slot, range ) ) {
+		if ( m_pContext1 ) {
+			m_pContext1->GSSetConstantBuffers1( slot, range,
+				DesiredState.ConstantBuffers.GetSlotLocation( slot ),
+				DesiredState.ConstantBufferOffsets.GetSlotLocation( slot ),
+				DesiredState.ConstantBufferSizes.GetSlotLocation( slot ) );
+		} else {
+			pContext->GSSetConstantBuffers( slot, range, DesiredState.ConstantBuffers.GetSlotLocation( slot ) );
+		}
+		slot += range;
+	}
 }
 //--------------------------------------------------------------------------------
 void GeometryStageDX11::BindSamplerStates( ID3D11DeviceContext* pContext, int count )
 {
-	pContext->GSSetSamplers( 
-		DesiredState.SamplerStates.GetStartSlot(),
-		DesiredState.SamplerStates.GetRange(),
-		DesiredState.SamplerStates.GetFirstSlotLocation() );
+	unsigned int slot = 0;
+	unsigned int range = 0;
+
+	while ( DesiredState.SamplerStates.GetNextRange( slot, range ) ) {
+		pContext->GSSetSamplers( slot, range, DesiredState.SamplerStates.GetSlotLocation( slot ) );
+		slot += range;
+	}
 }
 //--------------------------------------------------------------------------------
 void GeometryStageDX11::BindShaderResourceViews( ID3D11DeviceContext* pContext, int count )
 {
-	pContext->GSSetShaderResources( 
-		DesiredState.ShaderResourceViews.GetStartSlot(),
-		DesiredState.ShaderResourceViews.GetRange(), 
-		DesiredState.ShaderResourceViews.GetFirstSlotLocation() ); 
+	unsigned int slot = 0;
+	unsigned int range = 0;
+
+	while ( DesiredState.ShaderResourceViews.GetNextRange( slot, range ) ) {
+		pContext->GSSetShaderResources( slot, range, DesiredState.ShaderResourceViews.GetSlotLocation( slot ) );
+		slot += range;
+	}
 }
 //--------------------------------------------------------------------------------
 void GeometryStageDX11::BindUnorderedAccessViews( ID3D11DeviceContext* pContext, int count )
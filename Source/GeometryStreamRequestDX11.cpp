@@ -0,0 +1,112 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "GeometryStreamRequestDX11.h"
+#include "GeometryLoaderDX11.h"
+#include "GeometryCacheDX11.h"
+#include "StlImporterDX11.h"
+#include "FileSystem.h"
+#include "GlyphString.h"
+#include "Log.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+GeometryStreamRequestDX11::GeometryStreamRequestDX11( const std::wstring& filename ) :
+	StreamRequest( FileSystem().GetModelsFolder() + filename ),
+	m_ModelName( filename ),
+	m_bFromCache( false )
+{
+	const size_t separator = m_ModelName.find_last_of( L'.' );
+	m_Extension = ( separator == std::wstring::npos ) ? L"" : m_ModelName.substr( separator + 1 );
+	std::transform( m_Extension.begin(), m_Extension.end(), m_Extension.begin(), ::tolower );
+}
+//--------------------------------------------------------------------------------
+GeometryStreamRequestDX11::~GeometryStreamRequestDX11()
+{
+}
+//--------------------------------------------------------------------------------
+GeometryPtr GeometryStreamRequestDX11::GetGeometry( ) const
+{
+	return( GetState() == STREAM_COMPLETE ? m_pGeometry : nullptr );
+}
+//--------------------------------------------------------------------------------
+unsigned long long GeometryStreamRequestDX11::EstimateMemoryCost( )
+{
+	// The file that is read is chosen here, since it decides the cost that is
+	// charged to the memory budget.  Finding the cache folder may create it, so
+	// this is left to the I/O thread as well.
+
+	if ( m_Extension == L"ms3d" || m_Extension == L"ply" )
+		m_CacheFilename = GeometryCacheDX11::GetCacheFilename( m_Filename );
+
+	m_bFromCache = !m_CacheFilename.empty() && GeometryCacheDX11::IsCacheValid( m_Filename, m_CacheFilename );
+
+	return( GetFileLength( m_bFromCache ? m_CacheFilename : m_Filename ) );
+}
+//--------------------------------------------------------------------------------
+bool GeometryStreamRequestDX11::Read( )
+{
+	return( LoadFile( m_bFromCache ? m_CacheFilename : m_Filename ) );
+}
+//--------------------------------------------------------------------------------
+bool GeometryStreamRequestDX11::Decode( )
+{
+	const unsigned char* pData = reinterpret_cast<const unsigned char*>( &m_Data[0] );
+	const size_t size = m_Data.size();
+
+	if ( m_bFromCache )
+	{
+		m_pGeometry = GeometryCacheDX11::ReadFromMemory( pData, size, m_CacheFilename );
+
+		// An invalid cache is rebuilt by loading the model from its file instead,
+		// which is the only case where the decode thread does the I/O.
+		if ( m_pGeometry == nullptr && LoadFile( m_Filename ) ) {
+			m_bFromCache = false;
+			return( Decode() );
+		}
+
+		return( m_pGeometry != nullptr );
+	}
+
+	try
+	{
+		if ( m_Extension == L"ms3d" )
+			m_pGeometry = GeometryLoaderDX11::loadMS3DFromMemory( pData, size, m_Filename );
+		else if ( m_Extension == L"ply" )
+			m_pGeometry = GeometryLoaderDX11::loadStanfordPlyFromMemory( reinterpret_cast<const char*>( pData ), size );
+		else if ( m_Extension == L"stl" )
+			m_pGeometry = StlImporterDX11::LoadFromMemory( reinterpret_cast<const char*>( pData ), size, m_Filename );
+		else
+			Log::Get().Write( L"Model format can't be streamed: " + m_ModelName, LOG_ERROR );
+	}
+	catch ( std::exception* pException )
+	{
+		// The PLY reader reports its errors by throwing.
+
+		Log::Get().Write( L"Failed to load model " + m_ModelName + L": " + GlyphString::ToUnicode( pException->what() ), LOG_ERROR );
+		delete pException;
+		m_pGeometry = nullptr;
+	}
+
+	if ( m_pGeometry != nullptr && !m_CacheFilename.empty() )
+		GeometryCacheDX11::Write( m_pGeometry, m_CacheFilename );
+
+	return( m_pGeometry != nullptr );
+}
+//--------------------------------------------------------------------------------
+bool GeometryStreamRequestDX11::Finalize( )
+{
+	m_pGeometry->LoadToBuffers();
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
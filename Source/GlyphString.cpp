@@ -17,6 +17,12 @@
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
+static const double PowersOfTen[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+//--------------------------------------------------------------------------------
 GlyphString::GlyphString( )
 {
 }
@@ -48,4 +54,78 @@ std::vector<std::string> GlyphString::split(const std::string &s, char delim) {
 	GlyphString::split(s, delim, elems);
 	return elems;
 }
+//--------------------------------------------------------------------------------
+const char* GlyphString::ParseFloat( const char* p, const char* pEnd, float& value )
+{
+	// Parse a decimal number in place, like the ASCII PLY reader, but scale it
+	// with a table for the exponents that occur in practice.  Returns nullptr
+	// if there is no number.
+
+	while ( p < pEnd && ( *p == ' ' || *p == '\t' || *p == '\r' ) )
+		p++;
+
+	bool bNegative = false;
+	if ( p < pEnd && ( *p == '-' || *p == '+' ) )
+		bNegative = ( *p++ == '-' );
+
+	unsigned long long mantissa = 0;
+	int exponent = 0;
+	int digits = 0;
+
+	// Digits beyond what the mantissa can hold only affect the exponent.
+
+	for ( ; p < pEnd && *p >= '0' && *p <= '9'; p++, digits++ ) {
+		if ( mantissa < 100000000000000000ull )
+			mantissa = mantissa * 10 + ( *p - '0' );
+		else
+			exponent++;
+	}
+
+	if ( p < pEnd && *p == '.' )
+	{
+		for ( p++; p < pEnd && *p >= '0' && *p <= '9'; p++, digits++ ) {
+			if ( mantissa < 100000000000000000ull ) {
+				mantissa = mantissa * 10 + ( *p - '0' );
+				exponent--;
+			}
+		}
+	}
+
+	if ( digits == 0 )
+		return( nullptr );
+
+	if ( p < pEnd && ( *p == 'e' || *p == 'E' ) )
+	{
+		const char* pExponent = p + 1;
+		bool bNegativeExponent = false;
+
+		if ( pExponent < pEnd && ( *pExponent == '-' || *pExponent == '+' ) )
+			bNegativeExponent = ( *pExponent++ == '-' );
+
+		if ( pExponent < pEnd && *pExponent >= '0' && *pExponent <= '9' )
+		{
+			int e = 0;
+			for ( ; pExponent < pEnd && *pExponent >= '0' && *pExponent <= '9'; pExponent++ ) {
+				if ( e < 10000 )
+					e = e * 10 + ( *pExponent - '0' );
+			}
+
+			exponent += bNegativeExponent ? -e : e;
+			p = pExponent;
+		}
+	}
+
+	double result = static_cast<double>( mantissa );
+
+	if ( exponent < 0 && exponent >= -22 )
+		result /= PowersOfTen[-exponent];
+	else if ( exponent > 0 && exponent <= 22 )
+		result *= PowersOfTen[exponent];
+	else if ( exponent != 0 )
+		result *= pow( 10.0, exponent );
+
+	value = static_cast<float>( bNegative ? -result : result );
+
+	return( p );
+}
 //--------------------------------------------------------------------------------
\ No newline at end of file
@@ -45,26 +45,42 @@ void HullStageDX11::BindShaderProgram( ID3D11DeviceContext* pContext )
 //--------------------------------------------------------------------------------
 void HullStageDX11::BindConstantBuffers( ID3D11DeviceContext* pContext, int count )
 {
-	pContext->HSSetConstantBuffers( 
-		DesiredState.ConstantBuffers.GetStartSlot(),
-		DesiredState.ConstantBuffers.GetRange(),
-		DesiredState.ConstantBuffers.GetFirstSlotLocation() );
+	unsigned int slot = 0;
+	unsigned int range = 0;
+
+	while ( DesiredState.GetNextConstantBufferRange( slot, range ) ) {
+		if ( m_pContext1 ) {
+			m_pContext1->HSSetConstantBuffers1( slot, range,
+				DesiredState.ConstantBuffers.GetSlotLocation( slot ),
+				DesiredState.ConstantBufferOffsets.GetSlotLocation( slot ),
+				DesiredState.ConstantBufferSizes.GetSlotLocation( slot ) );
+		} else {
+			pContext->HSSetConstantBuffers( slot, range, DesiredState.ConstantBuffers.GetSlotLocation( slot ) );
+		}
+		slot += range;
+	}
 }
 //--------------------------------------------------------------------------------
 void HullStageDX11::BindSamplerStates( ID3D11DeviceContext* pContext, int count )
 {
-	pContext->HSSetSamplers( 
-		DesiredState.SamplerStates.GetStartSlot(),
-		DesiredState.SamplerStates.GetRange(),
-		DesiredState.SamplerStates.GetFirstSlotLocation() );
+	unsigned int slot = 0;
+	unsigned int range = 0;
+
+	while ( DesiredState.SamplerStates.GetNextRange( slot, range ) ) {
+		pContext->HSSetSamplers( slot, range, DesiredState.SamplerStates.GetSlotLocation( slot ) );
+		slot += range;
+	}
 }
 //--------------------------------------------------------------------------------
 void HullStageDX11::BindShaderResourceViews( ID3D11DeviceContext* pContext, int count )
 {
-	pContext->HSSetShaderResources( 
-		DesiredState.ShaderResourceViews.GetStartSlot(),
-		DesiredState.ShaderResourceViews.GetRange(),
-		DesiredState.ShaderResourceViews.GetFirstSlotLocation() ); 
+	unsigned int slot = 0;
+	unsigned int range = 0;
+
+	while ( DesiredState.ShaderResourceViews.GetNextRange( slot, range ) ) {
+		pContext->HSSetShaderResources( slot, range, DesiredState.ShaderResourceViews.GetSlotLocation( slot ) );
+		slot += range;
+	}
 }
 //--------------------------------------------------------------------------------
 void HullStageDX11::BindUnorderedAccessViews( ID3D11DeviceContext* pContext, int count )
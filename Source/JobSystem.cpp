@@ -0,0 +1,223 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "JobSystem.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+JobSystem* JobSystem::m_spJobSystem = nullptr;
+//--------------------------------------------------------------------------------
+// Each worker thread records its owning job system and queue index, so that jobs
+// submitted from within a job go to the worker's own queue.
+//--------------------------------------------------------------------------------
+static GLYPH_THREAD_LOCAL JobSystem* s_pWorkerOwner = nullptr;
+static GLYPH_THREAD_LOCAL unsigned int s_uiWorkerQueue = 0;
+//--------------------------------------------------------------------------------
+JobSystem::JobSystem( unsigned int uiWorkers ) :
+	m_iQueuedJobs( 0 ),
+	m_bShutdown( false )
+{
+	if ( uiWorkers == 0 )
+	{
+		unsigned int uiHardwareThreads = std::thread::hardware_concurrency();
+		uiWorkers = ( uiHardwareThreads > 1 ) ? uiHardwareThreads - 1 : 1;
+	}
+
+	// All of the queues are created before any of the workers are started, since
+	// the workers steal from each other's queues.
+
+	for ( unsigned int i = 0; i < uiWorkers + 1; i++ )
+		m_Queues.push_back( new WorkQueue() );
+
+	m_Threads.reserve( uiWorkers );
+
+	for ( unsigned int i = 0; i < uiWorkers; i++ )
+		m_Threads.push_back( std::thread( &JobSystem::WorkerProc, this, i + 1 ) );
+
+	if ( !m_spJobSystem )
+		m_spJobSystem = this;
+}
+//--------------------------------------------------------------------------------
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_SleepLock );
+		m_bShutdown = true;
+	}
+	m_WakeCondition.notify_all();
+
+	for ( auto& thread : m_Threads )
+		thread.join();
+
+	for ( auto pQueue : m_Queues )
+		delete pQueue;
+
+	if ( m_spJobSystem == this )
+		m_spJobSystem = nullptr;
+}
+//--------------------------------------------------------------------------------
+JobSystem* JobSystem::Get()
+{
+	return( m_spJobSystem );
+}
+//--------------------------------------------------------------------------------
+unsigned int JobSystem::GetWorkerCount() const
+{
+	return( static_cast<unsigned int>( m_Threads.size() ) );
+}
+//--------------------------------------------------------------------------------
+unsigned int JobSystem::CurrentQueue( ) const
+{
+	return( s_pWorkerOwner == this ? s_uiWorkerQueue : 0 );
+}
+//--------------------------------------------------------------------------------
+void JobSystem::Submit( const Job& job, Counter& counter )
+{
+	counter.m_iPending++;
+
+	WorkQueue* pQueue = m_Queues[CurrentQueue()];
+
+	{
+		std::lock_guard<std::mutex> lock( pQueue->Lock );
+		Entry entry;
+		entry.job = job;
+		entry.pCounter = &counter;
+		pQueue->Jobs.push_back( entry );
+	}
+
+	// The sleep lock is taken before notifying to ensure that a worker which is
+	// just about to go to sleep can't miss the new job.
+
+	m_iQueuedJobs++;
+	{
+		std::lock_guard<std::mutex> lock( m_SleepLock );
+	}
+	m_WakeCondition.notify_one();
+}
+//--------------------------------------------------------------------------------
+void JobSystem::Wait( Counter& counter )
+{
+	// Help out with any available work until the counter reaches zero.  When
+	// nothing is available the remaining jobs are already running on other 
+	// threads, so we sleep until one of them completes the counter or new work
+	// is submitted.
+
+	unsigned int queue = CurrentQueue();
+
+	while ( !counter.IsComplete() )
+	{
+		if ( ExecuteOne( queue ) )
+			continue;
+
+		std::unique_lock<std::mutex> lock( m_SleepLock );
+		m_WakeCondition.wait( lock, [&]() { return( counter.IsComplete() || m_iQueuedJobs > 0 ); } );
+	}
+}
+//--------------------------------------------------------------------------------
+void JobSystem::Complete( Counter& counter )
+{
+	// The waiter may destroy the counter as soon as it reaches zero, so it isn't
+	// touched after the decrement.  Waking everyone also wakes idle workers,
+	// which simply go back to sleep, but only happens once per group.
+
+	if ( --counter.m_iPending == 0 )
+	{
+		{
+			std::lock_guard<std::mutex> lock( m_SleepLock );
+		}
+		m_WakeCondition.notify_all();
+	}
+}
+//--------------------------------------------------------------------------------
+bool JobSystem::ExecutePending( )
+{
+	return( ExecuteOne( CurrentQueue() ) );
+}
+//--------------------------------------------------------------------------------
+bool JobSystem::PopLocal( unsigned int queue, Entry& entry )
+{
+	WorkQueue* pQueue = m_Queues[queue];
+	std::lock_guard<std::mutex> lock( pQueue->Lock );
+
+	if ( pQueue->Jobs.empty() )
+		return( false );
+
+	entry = pQueue->Jobs.back();
+	pQueue->Jobs.pop_back();
+	return( true );
+}
+//--------------------------------------------------------------------------------
+bool JobSystem::Steal( unsigned int queue, Entry& entry )
+{
+	// Visit the other queues starting from the next one, so that thieves are 
+	// spread out across the victims instead of all contending for the same one.
+
+	unsigned int count = static_cast<unsigned int>( m_Queues.size() );
+
+	for ( unsigned int i = 1; i < count; i++ )
+	{
+		WorkQueue* pQueue = m_Queues[( queue + i ) % count];
+		std::lock_guard<std::mutex> lock( pQueue->Lock );
+
+		if ( !pQueue->Jobs.empty() )
+		{
+			entry = pQueue->Jobs.front();
+			pQueue->Jobs.pop_front();
+			return( true );
+		}
+	}
+
+	return( false );
+}
+//--------------------------------------------------------------------------------
+bool JobSystem::ExecuteOne( unsigned int queue )
+{
+	Entry entry;
+
+	if ( !PopLocal( queue, entry ) && !Steal( queue, entry ) )
+		return( false );
+
+	m_iQueuedJobs--;
+
+	// The counter is completed by a guard, so that a job which throws doesn't
+	// leave the threads waiting on it hanging.
+
+	struct CompletionGuard
+	{
+		JobSystem*	pSystem;
+		Counter*	pCounter;
+		~CompletionGuard() { pSystem->Complete( *pCounter ); }
+	} guard = { this, entry.pCounter };
+
+	entry.job();
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void JobSystem::WorkerProc( unsigned int index )
+{
+	s_pWorkerOwner = this;
+	s_uiWorkerQueue = index;
+
+	while ( true )
+	{
+		if ( ExecuteOne( index ) )
+			continue;
+
+		std::unique_lock<std::mutex> lock( m_SleepLock );
+		m_WakeCondition.wait( lock, [this]() { return( m_bShutdown || m_iQueuedJobs > 0 ); } );
+
+		if ( m_bShutdown )
+			break;
+	}
+}
+//--------------------------------------------------------------------------------
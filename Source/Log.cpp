@@ -12,11 +12,68 @@
 #include "PCH.h"
 #include "Log.h"
 #include "FileSystem.h"
+#include <chrono>
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
-Log::Log()
+// Each thread finds its own buffer through this pointer, which is set the first
+// time the thread writes a message.
+//--------------------------------------------------------------------------------
+static GLYPH_THREAD_LOCAL Log::ThreadBuffer* s_pThreadBuffer = nullptr;
+//--------------------------------------------------------------------------------
+// The writer thread wakes up at least this often to write out the messages, and
+// the repeated messages are counted over windows of RepeatWindowLength.
+//--------------------------------------------------------------------------------
+static const unsigned int WriterInterval = 50;
+static const unsigned int RepeatWindowLength = 1000;
+static const unsigned int DefaultRateLimit = 10;
+//--------------------------------------------------------------------------------
+static unsigned long long GetMilliseconds()
+{
+	return( static_cast<unsigned long long>( std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch() ).count() ) );
+}
+//--------------------------------------------------------------------------------
+#if defined(_WIN32)
+static LPTOP_LEVEL_EXCEPTION_FILTER s_pPreviousFilter = nullptr;
+
+static LONG WINAPI FlushOnCrash( EXCEPTION_POINTERS* pExceptionInfo )
+{
+	Log::Get().FlushWithin( 1000 );
+
+	if ( s_pPreviousFilter != nullptr )
+		return( s_pPreviousFilter( pExceptionInfo ) );
+
+	return( EXCEPTION_CONTINUE_SEARCH );
+}
+#endif
+//--------------------------------------------------------------------------------
+Log::Log() :
+	m_MinimumLevel( LOG_INFO ),
+	m_uiRateLimit( DefaultRateLimit ),
+	m_Sequence( 0 ),
+	m_uiDropped( 0 ),
+	m_bWakeRequested( false ),
+	m_bRunning( false ),
+	m_bStopping( false ),
+	m_uiFlushRequested( 0 ),
+	m_uiFlushCompleted( 0 ),
+	m_RepeatWindow( 0 )
 {
+#if _DEBUG
+	m_MinimumLevel = LOG_DEBUG;
+#endif
+}
+//--------------------------------------------------------------------------------
+Log::~Log()
+{
+	if ( m_bRunning )
+		Close();
+
+	for ( auto pBuffer : m_Buffers )
+		delete pBuffer;
+
+	m_Buffers.clear();
 }
 //--------------------------------------------------------------------------------
 Log& Log::Get()
@@ -27,35 +84,124 @@ Log& Log::Get()
 //--------------------------------------------------------------------------------
 bool Log::Open()
 {
-	FileSystem fs;
-	std::wstring filename = fs.GetLogFolder() + L"\\Log.txt";
-	AppLog.open( filename.c_str() );
+	{
+		std::lock_guard<std::mutex> lock( m_Lock );
+
+		if ( m_bRunning )
+			return( true );
+
+		FileSystem fs;
+		std::wstring filename = fs.GetLogFolder() + L"\\Log.txt";
+		AppLog.open( filename.c_str() );
+
+		m_RepeatWindow = GetMilliseconds();
+		m_bStopping = false;
+		m_bRunning = true;
+		m_Writer = std::thread( &Log::WriterThread, this );
+	}
+
+#if defined(_WIN32)
+	static bool bFilterInstalled = false;
+
+	if ( !bFilterInstalled )
+	{
+		s_pPreviousFilter = ::SetUnhandledExceptionFilter( FlushOnCrash );
+		bFilterInstalled = true;
+	}
+#endif
 
 	Write( L"Log file opened." );
 
 	return( true );
 }
 //--------------------------------------------------------------------------------
-bool Log::Write( const wchar_t *cTextString )
+Log::ThreadBuffer* Log::GetThreadBuffer()
 {
-	AppLog << cTextString << "\n";
-#if _DEBUG
-	::OutputDebugStringW( cTextString );
-	::OutputDebugStringW( L"\n" );
-#endif
-	return( true );
+	ThreadBuffer* pBuffer = s_pThreadBuffer;
+
+	if ( pBuffer == nullptr )
+	{
+		// This only happens once per thread, so the lock isn't a concern.
+
+		pBuffer = new ThreadBuffer();
+		pBuffer->head = 0;
+		pBuffer->tail = 0;
+
+		std::lock_guard<std::mutex> lock( m_Lock );
+		m_Buffers.push_back( pBuffer );
+
+		s_pThreadBuffer = pBuffer;
+	}
+
+	return( pBuffer );
 }
 //--------------------------------------------------------------------------------
-bool Log::Write( std::wstring& TextString )
+bool Log::Write( const wchar_t *cTextString, LogLevel level )
 {
-	Log::Write( TextString.c_str() );
-	AppLog.flush();
+	if ( level < m_MinimumLevel.load( std::memory_order_relaxed ) )
+		return( false );
+
+	ThreadBuffer* pBuffer = GetThreadBuffer();
+	const unsigned int head = pBuffer->head.load( std::memory_order_relaxed );
+
+	// When the buffer is full, only errors wait for the writer to empty it.  The
+	// counters are allowed to wrap around, since only their differences are used.
+
+	while ( head - pBuffer->tail.load( std::memory_order_acquire ) >= BufferSize )
+	{
+		if ( level < LOG_ERROR || !Flush() )
+		{
+			m_uiDropped.fetch_add( 1, std::memory_order_relaxed );
+			return( false );
+		}
+	}
+
+	Message& message = pBuffer->messages[head % BufferSize];
+	message.sequence = m_Sequence.fetch_add( 1, std::memory_order_relaxed );
+	message.level = level;
+	message.text.assign( cTextString );
+
+	// Publish the message to the writer.
+
+	pBuffer->head.store( head + 1, std::memory_order_release );
+
+	// Wake the writer early when the buffer is filling up, instead of waiting
+	// for its next interval.
+
+	if ( level >= LOG_ERROR )
+		Flush();
+	else if ( head + 1 - pBuffer->tail.load( std::memory_order_relaxed ) == BufferSize / 2 )
+	{
+		m_bWakeRequested = true;
+		m_Wake.notify_one();
+	}
+
 	return( true );
 }
 //--------------------------------------------------------------------------------
+bool Log::Write( const std::wstring& TextString, LogLevel level )
+{
+	return( Log::Write( TextString.c_str(), level ) );
+}
+//--------------------------------------------------------------------------------
 bool Log::Close( )
 {
 	Write( L"Log file closed." );
+
+	{
+		std::lock_guard<std::mutex> lock( m_Lock );
+
+		if ( !m_bRunning )
+			return( false );
+
+		m_bStopping = true;
+		m_Wake.notify_one();
+	}
+
+	// The writer empties all of the buffers before it stops.
+
+	m_Writer.join();
+
 	AppLog.close();
 	return( true );
 }
@@ -66,4 +212,228 @@ bool Log::WriteSeparater( )
 
 	return( true );
 }
-//--------------------------------------------------------------------------------
\ No newline at end of file
+//--------------------------------------------------------------------------------
+bool Log::Flush( )
+{
+	std::unique_lock<std::mutex> lock( m_Lock );
+
+	return( WaitForWriter( lock, 0 ) );
+}
+//--------------------------------------------------------------------------------
+bool Log::FlushWithin( unsigned int milliseconds )
+{
+	const unsigned long long deadline = GetMilliseconds() + milliseconds;
+
+	std::unique_lock<std::mutex> lock( m_Lock, std::try_to_lock );
+
+	while ( !lock.owns_lock() )
+	{
+		if ( GetMilliseconds() >= deadline )
+			return( false );
+
+		std::this_thread::yield();
+		lock.try_lock();
+	}
+
+	const unsigned long long now = GetMilliseconds();
+
+	if ( now >= deadline )
+		return( false );
+
+	return( WaitForWriter( lock, static_cast<unsigned int>( deadline - now ) ) );
+}
+//--------------------------------------------------------------------------------
+bool Log::WaitForWriter( std::unique_lock<std::mutex>& lock, unsigned int milliseconds )
+{
+	// Called with the lock held.  A time of zero waits until the writer is done.
+
+	if ( !m_bRunning || std::this_thread::get_id() == m_Writer.get_id() )
+		return( false );
+
+	const unsigned int request = ++m_uiFlushRequested;
+	m_Wake.notify_one();
+
+	auto flushed = [this, request]()
+	{
+		return( !m_bRunning || static_cast<int>( m_uiFlushCompleted - request ) >= 0 );
+	};
+
+	if ( milliseconds == 0 )
+		m_Flushed.wait( lock, flushed );
+	else if ( !m_Flushed.wait_for( lock, std::chrono::milliseconds( milliseconds ), flushed ) )
+		return( false );
+
+	return( static_cast<int>( m_uiFlushCompleted - request ) >= 0 );
+}
+//--------------------------------------------------------------------------------
+void Log::SetMinimumLevel( LogLevel level )
+{
+	m_MinimumLevel = level;
+}
+//--------------------------------------------------------------------------------
+LogLevel Log::GetMinimumLevel( ) const
+{
+	return( static_cast<LogLevel>( m_MinimumLevel.load() ) );
+}
+//--------------------------------------------------------------------------------
+void Log::SetRateLimit( unsigned int messages )
+{
+	m_uiRateLimit = messages;
+}
+//--------------------------------------------------------------------------------
+unsigned int Log::GetRateLimit( ) const
+{
+	return( m_uiRateLimit.load() );
+}
+//--------------------------------------------------------------------------------
+void Log::WriterThread( )
+{
+	std::unique_lock<std::mutex> lock( m_Lock );
+
+	while ( true )
+	{
+		m_Wake.wait_for( lock, std::chrono::milliseconds( WriterInterval ), [this]()
+		{
+			return( m_bStopping || m_uiFlushRequested != m_uiFlushCompleted || m_bWakeRequested.exchange( false ) );
+		} );
+
+		// Everything that was written before the current flush request was made
+		// is in the buffers by now.
+
+		const unsigned int request = m_uiFlushRequested;
+		const bool stopping = m_bStopping;
+
+		m_Draining = m_Buffers;
+
+		lock.unlock();
+
+		WriteBatch();
+
+		if ( stopping )
+			WriteRepeatCounts();
+
+		AppLog.flush();
+
+		lock.lock();
+
+		m_uiFlushCompleted = request;
+
+		if ( stopping )
+		{
+			m_bRunning = false;
+			m_bStopping = false;
+		}
+
+		m_Flushed.notify_all();
+
+		if ( stopping )
+			break;
+	}
+}
+//--------------------------------------------------------------------------------
+void Log::WriteBatch( )
+{
+	// Gather the messages of all threads, and sort them back into the order that
+	// they were written in.
+
+	m_Batch.clear();
+	m_Heads.resize( m_Draining.size() );
+
+	for ( unsigned int i = 0; i < m_Draining.size(); i++ )
+	{
+		ThreadBuffer* pBuffer = m_Draining[i];
+
+		const unsigned int head = pBuffer->head.load( std::memory_order_acquire );
+		const unsigned int tail = pBuffer->tail.load( std::memory_order_relaxed );
+
+		for ( unsigned int j = tail; j != head; j++ )
+			m_Batch.push_back( &pBuffer->messages[j % BufferSize] );
+
+		m_Heads[i] = head;
+	}
+
+	std::sort( m_Batch.begin(), m_Batch.end(), []( const Message* pA, const Message* pB )
+	{
+		return( pA->sequence < pB->sequence );
+	} );
+
+	// Report the repeats of the last window before starting a new one.
+
+	const unsigned long long now = GetMilliseconds();
+
+	if ( now - m_RepeatWindow >= RepeatWindowLength )
+	{
+		WriteRepeatCounts();
+		m_RepeatWindow = now;
+	}
+
+	const unsigned int dropped = m_uiDropped.exchange( 0 );
+
+	if ( dropped > 0 )
+	{
+		std::wstringstream s;
+		s << dropped << L" messages were dropped because a thread wrote them faster than they could be logged.";
+		WriteMessage( LOG_WARNING, s.str() );
+	}
+
+	const unsigned int limit = m_uiRateLimit.load( std::memory_order_relaxed );
+
+	for ( auto pMessage : m_Batch )
+	{
+		if ( limit > 0 )
+		{
+			RepeatCount& count = m_Repeats[pMessage->text];
+
+			if ( count.written >= limit )
+			{
+				count.suppressed++;
+				continue;
+			}
+
+			count.written++;
+		}
+
+		WriteMessage( pMessage->level, pMessage->text );
+	}
+
+	// Hand the slots back to their threads.
+
+	for ( unsigned int i = 0; i < m_Draining.size(); i++ )
+		m_Draining[i]->tail.store( m_Heads[i], std::memory_order_release );
+}
+//--------------------------------------------------------------------------------
+void Log::WriteMessage( LogLevel level, const std::wstring& text )
+{
+	const wchar_t* prefix = L"";
+
+	switch ( level )
+	{
+	case LOG_DEBUG:		prefix = L"Debug: "; break;
+	case LOG_WARNING:	prefix = L"Warning: "; break;
+	case LOG_ERROR:		prefix = L"Error: "; break;
+	default: break;
+	}
+
+	AppLog << prefix << text << "\n";
+#if _DEBUG
+	::OutputDebugStringW( prefix );
+	::OutputDebugStringW( text.c_str() );
+	::OutputDebugStringW( L"\n" );
+#endif
+}
+//--------------------------------------------------------------------------------
+void Log::WriteRepeatCounts( )
+{
+	for ( auto& repeat : m_Repeats )
+	{
+		if ( repeat.second.suppressed > 0 )
+		{
+			std::wstringstream s;
+			s << L"The following message was repeated " << repeat.second.suppressed << L" more times: " << repeat.first;
+			WriteMessage( LOG_INFO, s.str() );
+		}
+	}
+
+	m_Repeats.clear();
+}
+//--------------------------------------------------------------------------------
@@ -23,6 +23,7 @@ MaterialDX11::MaterialDX11()
 	{
 		Params[i].bRender = false;
 		Params[i].pEffect = nullptr;
+		Params[i].pInstancedEffect = nullptr;
 	}
 	
 	//m_pEntity = nullptr;
@@ -32,8 +33,10 @@ MaterialDX11::~MaterialDX11()
 {
 	// Delete the effects that have been added to this material
 
-	for ( int i = 0; i < VT_NUM_VIEW_TYPES; i++ )
+	for ( int i = 0; i < VT_NUM_VIEW_TYPES; i++ ) {
 		SAFE_DELETE( Params[i].pEffect );
+		SAFE_DELETE( Params[i].pInstancedEffect );
+	}
 }
 //--------------------------------------------------------------------------------
 void MaterialDX11::Update( float time )
@@ -171,7 +171,7 @@ MaterialPtr MaterialGeneratorDX11::GenerateSkinnedSolid( RendererDX11& Renderer
 	return( pMaterial );
 }
 //--------------------------------------------------------------------------------
-MaterialPtr MaterialGeneratorDX11::GeneratePhong( RendererDX11& Renderer )
+MaterialPtr MaterialGeneratorDX11::GeneratePhong( RendererDX11& Renderer, bool bOctahedralNormals )
 {
 	// Create the material that will be returned
 	MaterialPtr pMaterial = MaterialPtr( new MaterialDX11() );
@@ -179,10 +179,13 @@ MaterialPtr MaterialGeneratorDX11::GeneratePhong( RendererDX11& Renderer )
 	// Create and fill the effect that will be used for this view type
 	RenderEffectDX11* pEffect = new RenderEffectDX11();
 
+	D3D_SHADER_MACRO octahedral[2] = { "OCTAHEDRAL_NORMALS", "1", NULL, NULL };
+
 	pEffect->SetVertexShader( Renderer.LoadShader( VERTEX_SHADER,
 		std::wstring( L"PhongShading.hlsl" ),
 		std::wstring( L"VSMAIN" ),
-		std::wstring( L"vs_5_0" ) ) );
+		std::wstring( L"vs_5_0" ),
+		bOctahedralNormals ? octahedral : NULL ) );
 
 	pEffect->SetPixelShader( Renderer.LoadShader( PIXEL_SHADER,
 		std::wstring( L"PhongShading.hlsl" ),
@@ -200,6 +203,33 @@ MaterialPtr MaterialGeneratorDX11::GeneratePhong( RendererDX11& Renderer )
 	pMaterial->Params[VT_PERSPECTIVE].bRender = true;
 	pMaterial->Params[VT_PERSPECTIVE].pEffect = pEffect;
 
+	// The instanced variant of the vertex shader takes its world matrix from the
+	// instance buffer, which lets entities sharing this material and geometry be
+	// drawn together.
+	D3D_SHADER_MACRO instanced[3] = { "INSTANCED", "1", NULL, NULL, NULL, NULL };
+
+	if ( bOctahedralNormals ) {
+		instanced[1].Name = "OCTAHEDRAL_NORMALS";
+		instanced[1].Definition = "1";
+	}
+
+	RenderEffectDX11* pInstancedEffect = new RenderEffectDX11();
+
+	pInstancedEffect->SetVertexShader( Renderer.LoadShader( VERTEX_SHADER,
+		std::wstring( L"PhongShading.hlsl" ),
+		std::wstring( L"VSMAIN" ),
+		std::wstring( L"vs_5_0" ),
+		instanced ) );
+
+	pInstancedEffect->SetPixelShader( pEffect->GetPixelShader() );
+
+	pInstancedEffect->m_iBlendState = pEffect->m_iBlendState;
+	pInstancedEffect->m_iDepthStencilState = pEffect->m_iDepthStencilState;
+	pInstancedEffect->m_iRasterizerState = pEffect->m_iRasterizerState;
+	pInstancedEffect->m_uStencilRef = pEffect->m_uStencilRef;
+
+	pMaterial->Params[VT_PERSPECTIVE].pInstancedEffect = pInstancedEffect;
+
 	return( pMaterial );
 }
 //--------------------------------------------------------------------------------
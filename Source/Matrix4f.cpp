@@ -11,9 +11,153 @@
 //----------------------------------------------------------------------------------------------------
 #include "PCH.h"
 #include "Matrix4f.h"
+#include "Vector3f.h"
+#if GLYPH_SSE_MATH
+#include <xmmintrin.h>
+#endif
 //----------------------------------------------------------------------------------------------------
 using namespace Glyph3;
 //----------------------------------------------------------------------------------------------------
+#if GLYPH_SSE_MATH
+//----------------------------------------------------------------------------------------------------
+// The SSE kernels work directly on the row major entry arrays.  Matrix4f is not
+// declared with 16 byte alignment (it is passed by value and stored in STL
+// containers throughout the engine), so all loads and stores are unaligned.
+//----------------------------------------------------------------------------------------------------
+#define GLYPH_SHUFFLE( v1, v2, x, y, z, w ) _mm_shuffle_ps( v1, v2, _MM_SHUFFLE( w, z, y, x ) )
+#define GLYPH_SWIZZLE( v, x, y, z, w ) GLYPH_SHUFFLE( v, v, x, y, z, w )
+//----------------------------------------------------------------------------------------------------
+static inline __m128 RowTimesMatrixSSE( __m128 row, const __m128* pB )
+{
+	__m128 result = _mm_mul_ps( GLYPH_SWIZZLE( row, 0, 0, 0, 0 ), pB[0] );
+	result = _mm_add_ps( result, _mm_mul_ps( GLYPH_SWIZZLE( row, 1, 1, 1, 1 ), pB[1] ) );
+	result = _mm_add_ps( result, _mm_mul_ps( GLYPH_SWIZZLE( row, 2, 2, 2, 2 ), pB[2] ) );
+	result = _mm_add_ps( result, _mm_mul_ps( GLYPH_SWIZZLE( row, 3, 3, 3, 3 ), pB[3] ) );
+	return( result );
+}
+//----------------------------------------------------------------------------------------------------
+static void MultiplySSE( const float* pA, const float* pB, float* pOut )
+{
+	// Both inputs are fully loaded before anything is written, so the output is
+	// allowed to alias either of the inputs.
+
+	__m128 b[4];
+	b[0] = _mm_loadu_ps( pB + 0 );
+	b[1] = _mm_loadu_ps( pB + 4 );
+	b[2] = _mm_loadu_ps( pB + 8 );
+	b[3] = _mm_loadu_ps( pB + 12 );
+
+	__m128 r0 = RowTimesMatrixSSE( _mm_loadu_ps( pA + 0 ), b );
+	__m128 r1 = RowTimesMatrixSSE( _mm_loadu_ps( pA + 4 ), b );
+	__m128 r2 = RowTimesMatrixSSE( _mm_loadu_ps( pA + 8 ), b );
+	__m128 r3 = RowTimesMatrixSSE( _mm_loadu_ps( pA + 12 ), b );
+
+	_mm_storeu_ps( pOut + 0, r0 );
+	_mm_storeu_ps( pOut + 4, r1 );
+	_mm_storeu_ps( pOut + 8, r2 );
+	_mm_storeu_ps( pOut + 12, r3 );
+}
+//----------------------------------------------------------------------------------------------------
+static void TransposeSSE( const float* pIn, float* pOut )
+{
+	__m128 r0 = _mm_loadu_ps( pIn + 0 );
+	__m128 r1 = _mm_loadu_ps( pIn + 4 );
+	__m128 r2 = _mm_loadu_ps( pIn + 8 );
+	__m128 r3 = _mm_loadu_ps( pIn + 12 );
+
+	_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+
+	_mm_storeu_ps( pOut + 0, r0 );
+	_mm_storeu_ps( pOut + 4, r1 );
+	_mm_storeu_ps( pOut + 8, r2 );
+	_mm_storeu_ps( pOut + 12, r3 );
+}
+//----------------------------------------------------------------------------------------------------
+// The 2x2 helpers below operate on 2x2 row major matrices packed into a single
+// register as ( m11, m12, m21, m22 ).
+//----------------------------------------------------------------------------------------------------
+static inline __m128 Mat2MulSSE( __m128 a, __m128 b )
+{
+	// A * B
+	return( _mm_add_ps( _mm_mul_ps( a, GLYPH_SWIZZLE( b, 0, 3, 0, 3 ) ),
+		_mm_mul_ps( GLYPH_SWIZZLE( a, 1, 0, 3, 2 ), GLYPH_SWIZZLE( b, 2, 1, 2, 1 ) ) ) );
+}
+//----------------------------------------------------------------------------------------------------
+static inline __m128 Mat2AdjMulSSE( __m128 a, __m128 b )
+{
+	// adj(A) * B
+	return( _mm_sub_ps( _mm_mul_ps( GLYPH_SWIZZLE( a, 3, 3, 0, 0 ), b ),
+		_mm_mul_ps( GLYPH_SWIZZLE( a, 1, 1, 2, 2 ), GLYPH_SWIZZLE( b, 2, 3, 0, 1 ) ) ) );
+}
+//----------------------------------------------------------------------------------------------------
+static inline __m128 Mat2MulAdjSSE( __m128 a, __m128 b )
+{
+	// A * adj(B)
+	return( _mm_sub_ps( _mm_mul_ps( a, GLYPH_SWIZZLE( b, 3, 0, 3, 0 ) ),
+		_mm_mul_ps( GLYPH_SWIZZLE( a, 1, 0, 3, 2 ), GLYPH_SWIZZLE( b, 2, 1, 2, 1 ) ) ) );
+}
+//----------------------------------------------------------------------------------------------------
+static void InverseSSE( const float* pIn, float* pOut )
+{
+	// The inverse is computed blockwise, treating the matrix as four 2x2 blocks:
+	//
+	//     M = | A B |    inv(M) = 1/|M| * | X Y |
+	//         | C D |                     | Z W |
+	//
+	// with |M| = |A||D| + |B||C| - tr( adj(A)B adj(D)C ).
+
+	__m128 r0 = _mm_loadu_ps( pIn + 0 );
+	__m128 r1 = _mm_loadu_ps( pIn + 4 );
+	__m128 r2 = _mm_loadu_ps( pIn + 8 );
+	__m128 r3 = _mm_loadu_ps( pIn + 12 );
+
+	__m128 A = _mm_movelh_ps( r0, r1 );
+	__m128 B = _mm_movehl_ps( r1, r0 );
+	__m128 C = _mm_movelh_ps( r2, r3 );
+	__m128 D = _mm_movehl_ps( r3, r2 );
+
+	// Determinants of the four blocks as ( |A|, |B|, |C|, |D| ).
+	__m128 detSub = _mm_sub_ps(
+		_mm_mul_ps( GLYPH_SHUFFLE( r0, r2, 0, 2, 0, 2 ), GLYPH_SHUFFLE( r1, r3, 1, 3, 1, 3 ) ),
+		_mm_mul_ps( GLYPH_SHUFFLE( r0, r2, 1, 3, 1, 3 ), GLYPH_SHUFFLE( r1, r3, 0, 2, 0, 2 ) ) );
+
+	__m128 detA = GLYPH_SWIZZLE( detSub, 0, 0, 0, 0 );
+	__m128 detB = GLYPH_SWIZZLE( detSub, 1, 1, 1, 1 );
+	__m128 detC = GLYPH_SWIZZLE( detSub, 2, 2, 2, 2 );
+	__m128 detD = GLYPH_SWIZZLE( detSub, 3, 3, 3, 3 );
+
+	__m128 D_C = Mat2AdjMulSSE( D, C );
+	__m128 A_B = Mat2AdjMulSSE( A, B );
+
+	// The adjugates of the result blocks.
+	__m128 X_ = _mm_sub_ps( _mm_mul_ps( detD, A ), Mat2MulSSE( B, D_C ) );
+	__m128 W_ = _mm_sub_ps( _mm_mul_ps( detA, D ), Mat2MulSSE( C, A_B ) );
+	__m128 Y_ = _mm_sub_ps( _mm_mul_ps( detB, C ), Mat2MulAdjSSE( D, A_B ) );
+	__m128 Z_ = _mm_sub_ps( _mm_mul_ps( detC, B ), Mat2MulAdjSSE( A, D_C ) );
+
+	__m128 tr = _mm_mul_ps( A_B, GLYPH_SWIZZLE( D_C, 0, 2, 1, 3 ) );
+	tr = _mm_add_ps( tr, _mm_movehl_ps( tr, tr ) );
+	tr = _mm_add_ps( tr, GLYPH_SWIZZLE( tr, 1, 0, 1, 0 ) );
+
+	__m128 detM = _mm_add_ps( _mm_mul_ps( detA, detD ), _mm_mul_ps( detB, detC ) );
+	detM = _mm_sub_ps( detM, GLYPH_SWIZZLE( tr, 0, 0, 0, 0 ) );
+
+	// The sign pattern applies the final adjugate of each block.
+	__m128 rDetM = _mm_div_ps( _mm_setr_ps( 1.0f, -1.0f, -1.0f, 1.0f ), detM );
+
+	X_ = _mm_mul_ps( X_, rDetM );
+	Y_ = _mm_mul_ps( Y_, rDetM );
+	Z_ = _mm_mul_ps( Z_, rDetM );
+	W_ = _mm_mul_ps( W_, rDetM );
+
+	_mm_storeu_ps( pOut + 0, GLYPH_SHUFFLE( X_, Y_, 3, 1, 3, 1 ) );
+	_mm_storeu_ps( pOut + 4, GLYPH_SHUFFLE( X_, Y_, 2, 0, 2, 0 ) );
+	_mm_storeu_ps( pOut + 8, GLYPH_SHUFFLE( Z_, W_, 3, 1, 3, 1 ) );
+	_mm_storeu_ps( pOut + 12, GLYPH_SHUFFLE( Z_, W_, 2, 0, 2, 0 ) );
+}
+//----------------------------------------------------------------------------------------------------
+#endif // GLYPH_SSE_MATH
+//----------------------------------------------------------------------------------------------------
 Matrix4f::Matrix4f()
 {
 }
@@ -187,6 +331,10 @@ void Matrix4f::Translate( float fX, float fY, float fZ )
 //----------------------------------------------------------------------------------------------------
 Matrix4f Matrix4f::Inverse() const
 {
+#if GLYPH_SSE_MATH
+    Matrix4f kInv;
+    InverseSSE( m_afEntry, kInv.m_afEntry );
+#else
     float fA0 = m_afEntry[ 0]*m_afEntry[ 5] - m_afEntry[ 1]*m_afEntry[ 4];
     float fA1 = m_afEntry[ 0]*m_afEntry[ 6] - m_afEntry[ 2]*m_afEntry[ 4];
     float fA2 = m_afEntry[ 0]*m_afEntry[ 7] - m_afEntry[ 3]*m_afEntry[ 4];
@@ -228,6 +376,7 @@ Matrix4f Matrix4f::Inverse() const
         for (int iCol = 0; iCol < 4; iCol++)
             kInv(iRow,iCol) *= fInvDet;
     }
+#endif
 
     return( kInv );
 }
@@ -541,6 +690,9 @@ Matrix4f Matrix4f::operator* ( const Matrix4f& Matrix ) const
 {
 	Matrix4f mProd;
 
+#if GLYPH_SSE_MATH
+	MultiplySSE( m_afEntry, Matrix.m_afEntry, mProd.m_afEntry );
+#else
 	for (int iRow = 0; iRow < 4; iRow++)
 	{
 		for (int iCol = 0; iCol < 4; iCol++)
@@ -554,6 +706,7 @@ Matrix4f Matrix4f::operator* ( const Matrix4f& Matrix ) const
 			}
 		}
 	}
+#endif
 	return( mProd );
 }
 //----------------------------------------------------------------------------------------------------
@@ -641,6 +794,9 @@ Matrix4f& Matrix4f::operator*= ( float fScalar )
 //----------------------------------------------------------------------------------------------------
 Matrix4f& Matrix4f::operator*= ( const Matrix4f& Matrix )
 {
+#if GLYPH_SSE_MATH
+	MultiplySSE( m_afEntry, Matrix.m_afEntry, m_afEntry );
+#else
 	Matrix4f mProd = *this; 
 	
 	for ( int iRow = 0; iRow < 4; iRow++ )
@@ -656,6 +812,7 @@ Matrix4f& Matrix4f::operator*= ( const Matrix4f& Matrix )
 			}
 		}
 	}
+#endif
 	return( *this );
 }
 //----------------------------------------------------------------------------------------------------
@@ -697,6 +854,9 @@ void Matrix4f::MakeIdentity()
 //----------------------------------------------------------------------------------------------------
 void Matrix4f::MakeTranspose()
 {
+#if GLYPH_SSE_MATH
+	TransposeSSE( m_afEntry, m_afEntry );
+#else
 	Matrix4f mTranspose;
 
 	for ( int iRow = 0; iRow < 4; iRow++ )
@@ -706,6 +866,7 @@ void Matrix4f::MakeTranspose()
 	}
     
 	memcpy( m_afEntry, mTranspose.m_afEntry, 4*4*sizeof(float) );
+#endif
 }
 //----------------------------------------------------------------------------------------------------
 Matrix4f Matrix4f::Zero()
@@ -737,11 +898,15 @@ Matrix4f Matrix4f::Transpose()
 {
 	Matrix4f mTranspose;
 
+#if GLYPH_SSE_MATH
+	TransposeSSE( m_afEntry, mTranspose.m_afEntry );
+#else
 	for ( int iRow = 0; iRow < 4; iRow++ )
 	{
 		for ( int iCol = 0; iCol < 4; iCol++ )
 			mTranspose.m_afEntry[I(iRow,iCol)] = m_afEntry[I(iCol,iRow)];
 	}
+#endif
 
 	return( mTranspose );
 
@@ -755,15 +920,108 @@ int Matrix4f::I( int iRow, int iCol )
 Vector4f Matrix4f::operator* ( const Vector4f& Vector ) const
 {
     Vector4f vProd;
+#if GLYPH_SSE_MATH
+	TransformVectors( &Vector, &vProd, 1 );
+#else
     for ( int iCol = 0; iCol < 4; iCol++ )
     {
         vProd[iCol] = 0.0f;
         for ( int iRow = 0; iRow < 4; iRow++ )
             vProd[iCol] += m_afEntry[I(iRow,iCol)] * Vector[iRow];
     }
+#endif
     return( vProd );
 }
 //----------------------------------------------------------------------------------------------------
+void Matrix4f::TransformVectors( const Vector4f* pIn, Vector4f* pOut, unsigned int uiCount ) const
+{
+#if GLYPH_SSE_MATH
+	__m128 rows[4];
+	rows[0] = _mm_loadu_ps( m_afEntry + 0 );
+	rows[1] = _mm_loadu_ps( m_afEntry + 4 );
+	rows[2] = _mm_loadu_ps( m_afEntry + 8 );
+	rows[3] = _mm_loadu_ps( m_afEntry + 12 );
+
+	for ( unsigned int i = 0; i < uiCount; i++ )
+		_mm_storeu_ps( &pOut[i].x, RowTimesMatrixSSE( _mm_loadu_ps( &pIn[i].x ), rows ) );
+#else
+	for ( unsigned int i = 0; i < uiCount; i++ )
+	{
+		Vector4f v = pIn[i];
+		for ( int iCol = 0; iCol < 4; iCol++ )
+		{
+			pOut[i][iCol] = 0.0f;
+			for ( int iRow = 0; iRow < 4; iRow++ )
+				pOut[i][iCol] += m_afEntry[I(iRow,iCol)] * v[iRow];
+		}
+	}
+#endif
+}
+//----------------------------------------------------------------------------------------------------
+void Matrix4f::TransformPoints( const Vector3f* pIn, Vector3f* pOut, unsigned int uiCount ) const
+{
+#if GLYPH_SSE_MATH
+	__m128 r0 = _mm_loadu_ps( m_afEntry + 0 );
+	__m128 r1 = _mm_loadu_ps( m_afEntry + 4 );
+	__m128 r2 = _mm_loadu_ps( m_afEntry + 8 );
+	__m128 r3 = _mm_loadu_ps( m_afEntry + 12 );
+
+	for ( unsigned int i = 0; i < uiCount; i++ )
+	{
+		__m128 result = _mm_add_ps( r3, _mm_mul_ps( _mm_set1_ps( pIn[i].x ), r0 ) );
+		result = _mm_add_ps( result, _mm_mul_ps( _mm_set1_ps( pIn[i].y ), r1 ) );
+		result = _mm_add_ps( result, _mm_mul_ps( _mm_set1_ps( pIn[i].z ), r2 ) );
+
+		// Vector3f is only 12 bytes, so the result is stored one lane at a time.
+		_mm_store_ss( &pOut[i].x, result );
+		_mm_store_ss( &pOut[i].y, GLYPH_SWIZZLE( result, 1, 1, 1, 1 ) );
+		_mm_store_ss( &pOut[i].z, GLYPH_SWIZZLE( result, 2, 2, 2, 2 ) );
+	}
+#else
+	for ( unsigned int i = 0; i < uiCount; i++ )
+	{
+		Vector3f v = pIn[i];
+		for ( int iCol = 0; iCol < 3; iCol++ )
+		{
+			pOut[i][iCol] = m_afEntry[I(3,iCol)];
+			for ( int iRow = 0; iRow < 3; iRow++ )
+				pOut[i][iCol] += m_afEntry[I(iRow,iCol)] * v[iRow];
+		}
+	}
+#endif
+}
+//----------------------------------------------------------------------------------------------------
+void Matrix4f::TransformDirections( const Vector3f* pIn, Vector3f* pOut, unsigned int uiCount ) const
+{
+#if GLYPH_SSE_MATH
+	__m128 r0 = _mm_loadu_ps( m_afEntry + 0 );
+	__m128 r1 = _mm_loadu_ps( m_afEntry + 4 );
+	__m128 r2 = _mm_loadu_ps( m_afEntry + 8 );
+
+	for ( unsigned int i = 0; i < uiCount; i++ )
+	{
+		__m128 result = _mm_mul_ps( _mm_set1_ps( pIn[i].x ), r0 );
+		result = _mm_add_ps( result, _mm_mul_ps( _mm_set1_ps( pIn[i].y ), r1 ) );
+		result = _mm_add_ps( result, _mm_mul_ps( _mm_set1_ps( pIn[i].z ), r2 ) );
+
+		_mm_store_ss( &pOut[i].x, result );
+		_mm_store_ss( &pOut[i].y, GLYPH_SWIZZLE( result, 1, 1, 1, 1 ) );
+		_mm_store_ss( &pOut[i].z, GLYPH_SWIZZLE( result, 2, 2, 2, 2 ) );
+	}
+#else
+	for ( unsigned int i = 0; i < uiCount; i++ )
+	{
+		Vector3f v = pIn[i];
+		for ( int iCol = 0; iCol < 3; iCol++ )
+		{
+			pOut[i][iCol] = 0.0f;
+			for ( int iRow = 0; iRow < 3; iRow++ )
+				pOut[i][iCol] += m_afEntry[I(iRow,iCol)] * v[iRow];
+		}
+	}
+#endif
+}
+//----------------------------------------------------------------------------------------------------
 void Matrix4f::SetRow( int iRow, const Vector4f& Vector )
 {
 	for ( int iCol = 0; iCol < 4; iCol++ )
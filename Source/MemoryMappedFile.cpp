@@ -0,0 +1,95 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "MemoryMappedFile.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+MemoryMappedFile::MemoryMappedFile()
+	: m_hFile( INVALID_HANDLE_VALUE ),
+	m_hMapping( nullptr ),
+	m_pData( nullptr ),
+	m_uiSize( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+MemoryMappedFile::~MemoryMappedFile()
+{
+	Close();
+}
+//--------------------------------------------------------------------------------
+bool MemoryMappedFile::Open( const std::wstring& filename )
+{
+	Close();
+
+	m_hFile = CreateFileW( filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+
+	if ( m_hFile == INVALID_HANDLE_VALUE )
+		return( false );
+
+	LARGE_INTEGER size;
+	size.QuadPart = 0;
+
+	if ( !GetFileSizeEx( m_hFile, &size ) || size.QuadPart == 0
+		|| static_cast<unsigned long long>( size.QuadPart ) > static_cast<size_t>( -1 ) ) {
+		Close();
+		return( false );
+	}
+
+	m_hMapping = CreateFileMappingW( m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+
+	if ( m_hMapping )
+		m_pData = reinterpret_cast<const unsigned char*>( MapViewOfFile( m_hMapping, FILE_MAP_READ, 0, 0, 0 ) );
+
+	if ( !m_pData ) {
+		Close();
+		return( false );
+	}
+
+	m_uiSize = static_cast<size_t>( size.QuadPart );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void MemoryMappedFile::Close( )
+{
+	if ( m_pData )
+		UnmapViewOfFile( m_pData );
+
+	if ( m_hMapping )
+		CloseHandle( m_hMapping );
+
+	if ( m_hFile != INVALID_HANDLE_VALUE )
+		CloseHandle( m_hFile );
+
+	m_hFile = INVALID_HANDLE_VALUE;
+	m_hMapping = nullptr;
+	m_pData = nullptr;
+	m_uiSize = 0;
+}
+//--------------------------------------------------------------------------------
+bool MemoryMappedFile::IsOpen( ) const
+{
+	return( m_pData != nullptr );
+}
+//--------------------------------------------------------------------------------
+const unsigned char* MemoryMappedFile::GetData( ) const
+{
+	return( m_pData );
+}
+//--------------------------------------------------------------------------------
+size_t MemoryMappedFile::GetSize( ) const
+{
+	return( m_uiSize );
+}
+//--------------------------------------------------------------------------------
@@ -13,11 +13,15 @@
 #include "Node3D.h"
 #include "Entity3D.h"
 #include "SceneGraph.h"
+#include "Profiler.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
 Node3D::Node3D() :
 	m_pParent( nullptr ),
+	m_uiStructureRevision( 0 ),
+	m_bSubtreeBounded( false ),
+	m_uiSubtreeEntities( 0 ),
 	Controllers( this )
 {
 }
@@ -51,6 +55,8 @@ void Node3D::Render( PipelineManagerDX11* pPipelineManager, IParameterManager* p
 //--------------------------------------------------------------------------------
 void Node3D::Update( float time )
 {
+	GLYPH_PROFILE_SCOPE( "Node3D::Update" );
+
 	UpdateLocal( time );
 	UpdateWorld( );
 
@@ -79,7 +85,7 @@ void Node3D::UpdateWorld( )
 	// If the entity has a parent, then update its world matrix accordingly.
 
 	if ( m_pParent )
-		Transform.UpdateWorld( m_pParent->Transform.WorldMatrix() );
+		Transform.UpdateWorld( m_pParent->Transform );
 	else
 		Transform.UpdateWorld( );
 }
@@ -93,6 +99,7 @@ void Node3D::AttachChild( Entity3D* Child )
 		{
 			pChild = Child;
 			Child->AttachParent( this );
+			StructureChanged();
 			return;
 		}
 	}
@@ -100,6 +107,7 @@ void Node3D::AttachChild( Entity3D* Child )
 	// If no open spots then add a new one
 	m_Leafs.push_back( Child );
 	Child->AttachParent( this );
+	StructureChanged();
 }
 //--------------------------------------------------------------------------------
 void Node3D::AttachChild( Node3D* Child )
@@ -111,6 +119,7 @@ void Node3D::AttachChild( Node3D* Child )
 		{
 			pChild = Child;
 			Child->AttachParent( this );
+			StructureChanged();
 			return;
 		}
 	}
@@ -118,6 +127,7 @@ void Node3D::AttachChild( Node3D* Child )
 	// If no open spots then add a new one
 	m_Nodes.push_back( Child );
 	Child->AttachParent( this );
+	StructureChanged();
 }
 //--------------------------------------------------------------------------------
 void Node3D::DetachChild( Entity3D* Child )
@@ -128,6 +138,7 @@ void Node3D::DetachChild( Entity3D* Child )
 		{
 			pChild->DetachParent();
 			pChild = nullptr;
+			StructureChanged();
 		}
 	}
 }
@@ -140,6 +151,7 @@ void Node3D::DetachChild( Node3D* Child )
 		{
 			pChild->DetachParent();
 			pChild = nullptr;
+			StructureChanged();
 		}
 	}
 }
@@ -147,11 +159,13 @@ void Node3D::DetachChild( Node3D* Child )
 void Node3D::AttachParent( Node3D* Parent )
 {
 	m_pParent = Parent;
+	Transform.MakeDirty();
 }
 //--------------------------------------------------------------------------------
 void Node3D::DetachParent( )
 {
 	m_pParent = nullptr;
+	Transform.MakeDirty();
 }
 //--------------------------------------------------------------------------------
 Node3D* Node3D::GetParent()
@@ -205,3 +219,33 @@ const std::vector<Node3D*>& Node3D::Nodes()
 	return m_Nodes;
 }
 //--------------------------------------------------------------------------------
+unsigned int Node3D::GetStructureRevision( ) const
+{
+	return( m_uiStructureRevision );
+}
+//--------------------------------------------------------------------------------
+void Node3D::StructureChanged( )
+{
+	GetRoot( this )->m_uiStructureRevision++;
+}
+//--------------------------------------------------------------------------------
+void Node3D::SetSubtreeBounds( const Sphere3f& bounds, bool bBounded, unsigned int entities )
+{
+	m_SubtreeBounds = bounds;
+	m_bSubtreeBounded = bBounded;
+	m_uiSubtreeEntities = entities;
+}
+//--------------------------------------------------------------------------------
+bool Node3D::GetSubtreeBounds( Sphere3f& bounds ) const
+{
+	if ( m_bSubtreeBounded )
+		bounds = m_SubtreeBounds;
+
+	return( m_bSubtreeBounded );
+}
+//--------------------------------------------------------------------------------
+unsigned int Node3D::GetSubtreeEntityCount( ) const
+{
+	return( m_uiSubtreeEntities );
+}
+//--------------------------------------------------------------------------------
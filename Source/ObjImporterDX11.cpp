@@ -0,0 +1,717 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "ObjImporterDX11.h"
+#include "MemoryMappedFile.h"
+#include "JobSystem.h"
+#include "GlyphString.h"
+#include "Log.h"
+#include "Profiler.h"
+#include <climits>
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+static const ptrdiff_t ChunkSize = 1 << 20;
+static const UINT NoVertex = ~0U;
+//--------------------------------------------------------------------------------
+template <typename F>
+static void ForEachIndex( unsigned int count, const F& func )
+{
+	JobSystem* pJobs = JobSystem::Get();
+
+	if ( pJobs )
+		pJobs->ParallelFor( count, 1, func );
+	else
+		func( 0, count );
+}
+//--------------------------------------------------------------------------------
+static inline bool IsSpace( char c )
+{
+	return( c == ' ' || c == '\t' || c == '\r' );
+}
+//--------------------------------------------------------------------------------
+static inline unsigned int HashVertex( unsigned int part, const int* pIndices )
+{
+	unsigned int hash = 2166136261u;
+
+	hash = ( hash ^ part ) * 16777619u;
+	hash = ( hash ^ static_cast<unsigned int>( pIndices[0] ) ) * 16777619u;
+	hash = ( hash ^ static_cast<unsigned int>( pIndices[1] ) ) * 16777619u;
+	hash = ( hash ^ static_cast<unsigned int>( pIndices[2] ) ) * 16777619u;
+
+	return( hash ^ ( hash >> 16 ) );
+}
+//--------------------------------------------------------------------------------
+static inline bool SameIndices( const int* pA, const int* pB )
+{
+	return( pA[0] == pB[0] && pA[1] == pB[1] && pA[2] == pB[2] );
+}
+//--------------------------------------------------------------------------------
+static inline unsigned int TableSize( size_t entries )
+{
+	// A power of two that keeps an open addressing table at most half full.
+	unsigned int size = 64;
+	while ( size < entries * 2 )
+		size <<= 1;
+
+	return( size );
+}
+//--------------------------------------------------------------------------------
+static VertexElementDX11* CreateElement( const std::string& semantic, int tuple, DXGI_FORMAT format,
+										int count, bool first )
+{
+	VertexElementDX11* pElement = new VertexElementDX11( tuple, count );
+	pElement->m_SemanticName = semantic;
+	pElement->m_uiSemanticIndex = 0;
+	pElement->m_Format = format;
+	pElement->m_uiInputSlot = 0;
+	pElement->m_uiAlignedByteOffset = first ? 0 : D3D11_APPEND_ALIGNED_ELEMENT;
+	pElement->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	pElement->m_uiInstanceDataStepRate = 0;
+
+	return( pElement );
+}
+//--------------------------------------------------------------------------------
+ObjImporterDX11::ObjImporterDX11()
+{
+}
+//--------------------------------------------------------------------------------
+bool ObjImporterDX11::Load( const std::wstring& filename, std::vector<Part>& parts )
+{
+	GLYPH_PROFILE_SCOPE( "ObjImporterDX11::Load" );
+
+	parts.clear();
+
+	MemoryMappedFile file;
+
+	if ( !file.Open( filename ) )
+	{
+		Log::Get().Write( L"Could not open OBJ file: " + filename, LOG_ERROR );
+		return( false );
+	}
+
+	// Split the file into chunks of about ChunkSize bytes, each of which ends
+	// with a complete line.
+
+	const char* pData = reinterpret_cast<const char*>( file.GetData() );
+	const char* pDataEnd = pData + file.GetSize();
+
+	std::vector<const char*> splits( 1, pData );
+
+	while ( splits.back() < pDataEnd )
+	{
+		const char* pSplit = ( pDataEnd - splits.back() > ChunkSize ) ? splits.back() + ChunkSize : pDataEnd;
+
+		while ( pSplit < pDataEnd && *( pSplit - 1 ) != '\n' )
+			pSplit++;
+
+		splits.push_back( pSplit );
+	}
+
+	const unsigned int chunkCount = static_cast<unsigned int>( splits.size() - 1 );
+	std::vector<Chunk> chunks( chunkCount );
+
+	for ( unsigned int c = 0; c < chunkCount; c++ )
+	{
+		chunks[c].pBegin = splits[c];
+		chunks[c].pEnd = splits[c+1];
+		chunks[c].error = false;
+	}
+
+	ForEachIndex( chunkCount, [&]( unsigned int begin, unsigned int end )
+	{
+		for ( unsigned int c = begin; c < end; c++ )
+			ParseChunk( chunks[c] );
+	} );
+
+	// Now that the number of vertices in each chunk is known, the start of each
+	// chunk within the complete attribute arrays can be found.  The objects and
+	// materials are also tracked through the chunks here to find the part that
+	// each of their triangles belongs to.  A part is made for each combination
+	// of object and material, so a material that is used more than once within
+	// an object only produces one geometry.
+
+	unsigned int totals[3] = { 0, 0, 0 };
+	std::vector<std::string> libraries;
+	std::map<std::pair<std::string,std::string>, unsigned int> partIndices;
+	std::string object;
+	std::string material;
+
+	auto FindPart = [&]() -> unsigned int
+	{
+		auto key = std::make_pair( object, material );
+		auto it = partIndices.find( key );
+
+		if ( it != partIndices.end() )
+			return( it->second );
+
+		const unsigned int index = static_cast<unsigned int>( parts.size() );
+		parts.push_back( Part() );
+		parts.back().object = object;
+		parts.back().material = material;
+		partIndices[key] = index;
+
+		return( index );
+	};
+
+	unsigned int current = FindPart();
+
+	for ( auto& chunk : chunks )
+	{
+		if ( chunk.error )
+		{
+			Log::Get().Write( L"OBJ file contains invalid data: " + filename, LOG_ERROR );
+			parts.clear();
+			return( false );
+		}
+
+		chunk.base[0] = totals[0];
+		chunk.base[1] = totals[1];
+		chunk.base[2] = totals[2];
+		totals[0] += static_cast<unsigned int>( chunk.positions.size() / 3 );
+		totals[1] += static_cast<unsigned int>( chunk.texcoords.size() / 2 );
+		totals[2] += static_cast<unsigned int>( chunk.normals.size() / 3 );
+
+		chunk.firstPart = current;
+
+		for ( auto& event : chunk.events )
+		{
+			if ( event.type == OBJ_OBJECT )
+				object = event.name;
+			else
+				material = event.name;
+
+			event.part = current = FindPart();
+		}
+
+		libraries.insert( libraries.end(), chunk.libraries.begin(), chunk.libraries.end() );
+	}
+
+	const unsigned int partCount = static_cast<unsigned int>( parts.size() );
+
+	// Resolve the indices and weld the triplets of each chunk, and gather the
+	// attributes of all chunks.
+
+	std::vector<float> positions( totals[0] * 3 );
+	std::vector<float> texcoords( totals[1] * 2 );
+	std::vector<float> normals( totals[2] * 3 );
+
+	ForEachIndex( chunkCount, [&]( unsigned int begin, unsigned int end )
+	{
+		for ( unsigned int c = begin; c < end; c++ )
+		{
+			Chunk& chunk = chunks[c];
+
+			std::copy( chunk.positions.begin(), chunk.positions.end(), positions.begin() + chunk.base[0] * 3 );
+			std::copy( chunk.texcoords.begin(), chunk.texcoords.end(), texcoords.begin() + chunk.base[1] * 2 );
+			std::copy( chunk.normals.begin(), chunk.normals.end(), normals.begin() + chunk.base[2] * 3 );
+
+			ResolveChunk( chunk, totals );
+
+			if ( !chunk.error )
+				WeldChunk( chunk, partCount );
+		}
+	} );
+
+	for ( auto& chunk : chunks )
+	{
+		if ( chunk.error )
+		{
+			Log::Get().Write( L"OBJ file refers to vertex data that doesn't exist: " + filename, LOG_ERROR );
+			parts.clear();
+			return( false );
+		}
+	}
+
+	// Merge the vertices of the chunks.  A triplet that is used in several
+	// chunks is only added once to its part.  This only visits the unique
+	// vertices of each chunk, which are far fewer than the triangle corners.
+
+	size_t chunkVertices = 0;
+
+	for ( auto& chunk : chunks )
+		chunkVertices += chunk.vertices.size();
+
+	const unsigned int tableSize = TableSize( chunkVertices );
+	std::vector<UINT> table( tableSize, NoVertex );
+	std::vector<Vertex> merged;
+	std::vector< std::vector<UINT> > partVertices( partCount );
+	merged.reserve( chunkVertices );
+
+	for ( auto& chunk : chunks )
+	{
+		chunk.remap.resize( chunk.vertices.size() );
+
+		for ( size_t v = 0; v < chunk.vertices.size(); v++ )
+		{
+			const Vertex& vertex = chunk.vertices[v];
+			unsigned int slot = HashVertex( vertex.part, vertex.index ) & ( tableSize - 1 );
+
+			while ( table[slot] != NoVertex )
+			{
+				const Vertex& existing = merged[table[slot]];
+
+				if ( existing.part == vertex.part && SameIndices( existing.index, vertex.index ) )
+					break;
+
+				slot = ( slot + 1 ) & ( tableSize - 1 );
+			}
+
+			if ( table[slot] == NoVertex )
+			{
+				table[slot] = static_cast<UINT>( merged.size() );
+				merged.push_back( vertex );
+				partVertices[vertex.part].push_back( table[slot] );
+			}
+
+			chunk.remap[v] = table[slot];
+		}
+	}
+
+	// Number the vertices of each part, and place the triangles of each chunk
+	// within the index list of its part.
+
+	std::vector<UINT> partNumbers( merged.size() );
+	std::vector< std::vector<UINT> > partIndexLists( partCount );
+	std::vector<unsigned int> partIndexCounts( partCount, 0 );
+
+	for ( unsigned int p = 0; p < partCount; p++ )
+	{
+		for ( size_t v = 0; v < partVertices[p].size(); v++ )
+			partNumbers[partVertices[p][v]] = static_cast<UINT>( v );
+	}
+
+	// The triangles of each chunk go after those of the previous chunks.
+
+	for ( auto& chunk : chunks )
+	{
+		chunk.partOffsets.resize( partCount );
+
+		for ( unsigned int p = 0; p < partCount; p++ )
+		{
+			chunk.partOffsets[p] = partIndexCounts[p];
+			partIndexCounts[p] += chunk.partCorners[p];
+		}
+	}
+
+	for ( unsigned int p = 0; p < partCount; p++ )
+		partIndexLists[p].resize( partIndexCounts[p] );
+
+	ForEachIndex( chunkCount, [&]( unsigned int begin, unsigned int end )
+	{
+		for ( unsigned int c = begin; c < end; c++ )
+		{
+			Chunk& chunk = chunks[c];
+			std::vector<unsigned int> offsets( chunk.partOffsets );
+
+			for ( size_t i = 0; i < chunk.indices.size(); i++ )
+			{
+				const UINT local = chunk.indices[i];
+				const unsigned int part = chunk.vertices[local].part;
+
+				partIndexLists[part][offsets[part]++] = partNumbers[chunk.remap[local]];
+			}
+		}
+	} );
+
+	// Create a geometry for each part with the data of its vertices.
+
+	ForEachIndex( partCount, [&]( unsigned int begin, unsigned int end )
+	{
+		for ( unsigned int p = begin; p < end; p++ )
+		{
+			const std::vector<UINT>& vertices = partVertices[p];
+
+			if ( partIndexLists[p].empty() )
+				continue;
+
+			bool bTexcoords = false;
+			bool bNormals = false;
+
+			for ( auto v : vertices )
+			{
+				bTexcoords |= ( merged[v].index[1] >= 0 );
+				bNormals |= ( merged[v].index[2] >= 0 );
+			}
+
+			const int count = static_cast<int>( vertices.size() );
+
+			VertexElementDX11* pPositions = CreateElement( VertexElementDX11::PositionSemantic, 3, DXGI_FORMAT_R32G32B32_FLOAT, count, true );
+			VertexElementDX11* pTexcoords = nullptr;
+			VertexElementDX11* pNormals = nullptr;
+
+			if ( bTexcoords )
+				pTexcoords = CreateElement( VertexElementDX11::TexCoordSemantic, 2, DXGI_FORMAT_R32G32_FLOAT, count, false );
+
+			if ( bNormals )
+				pNormals = CreateElement( VertexElementDX11::NormalSemantic, 3, DXGI_FORMAT_R32G32B32_FLOAT, count, false );
+
+			for ( int v = 0; v < count; v++ )
+			{
+				const int* pIndex = merged[vertices[v]].index;
+
+				memcpy( ( *pPositions )[v], &positions[pIndex[0] * 3], 3 * sizeof( float ) );
+
+				// Vertices without texture coordinates or normals in a part that
+				// has them are set to zero.
+
+				if ( pTexcoords )
+				{
+					if ( pIndex[1] >= 0 )
+						memcpy( ( *pTexcoords )[v], &texcoords[pIndex[1] * 2], 2 * sizeof( float ) );
+					else
+						memset( ( *pTexcoords )[v], 0, 2 * sizeof( float ) );
+				}
+
+				if ( pNormals )
+				{
+					if ( pIndex[2] >= 0 )
+						memcpy( ( *pNormals )[v], &normals[pIndex[2] * 3], 3 * sizeof( float ) );
+					else
+						memset( ( *pNormals )[v], 0, 3 * sizeof( float ) );
+				}
+			}
+
+			GeometryPtr pGeometry = GeometryPtr( new GeometryDX11() );
+
+			pGeometry->AddElement( pPositions );
+			if ( pTexcoords )
+				pGeometry->AddElement( pTexcoords );
+			if ( pNormals )
+				pGeometry->AddElement( pNormals );
+
+			pGeometry->SetPrimitiveType( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+			pGeometry->m_vIndices.swap( partIndexLists[p] );
+
+			parts[p].geometry = pGeometry;
+		}
+	} );
+
+	// Parts without triangles, such as the default part of a file that names
+	// its material before the first face, are dropped.
+
+	parts.erase( std::remove_if( parts.begin(), parts.end(), []( const Part& part ) { return( !part.geometry ); } ), parts.end() );
+
+	// Load the material libraries from the folder of the OBJ file, and copy the
+	// properties of the materials that are used.
+
+	const size_t separator = filename.find_last_of( L"\\/" );
+	const std::wstring folder = ( separator == std::wstring::npos ) ? L"" : filename.substr( 0, separator + 1 );
+
+	for ( auto& library : libraries )
+	{
+		MTL::MeshMTL mtl( folder + GlyphString::ToUnicode( library ) );
+
+		for ( auto& part : parts )
+		{
+			auto it = mtl.materials.find( part.material );
+
+			if ( it != mtl.materials.end() )
+				part.properties = it->second;
+		}
+	}
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void ObjImporterDX11::ParseChunk( Chunk& chunk )
+{
+	// Each line starts with a keyword, and only the keywords that contribute to
+	// the geometry are interpreted.  Everything else, including comments, groups,
+	// smoothing groups, lines and points, is skipped.
+
+	const char* p = chunk.pBegin;
+	const char* pEnd = chunk.pEnd;
+
+	Corner fan[2];
+
+	while ( p < pEnd )
+	{
+		const char* pLine = p;
+		const char* pLineEnd = static_cast<const char*>( memchr( p, '\n', pEnd - p ) );
+
+		if ( pLineEnd == nullptr )
+			pLineEnd = pEnd;
+
+		p = ( pLineEnd < pEnd ) ? pLineEnd + 1 : pEnd;
+
+		while ( pLine < pLineEnd && IsSpace( *pLine ) )
+			pLine++;
+
+		const char* pKeyEnd = pLine;
+		while ( pKeyEnd < pLineEnd && !IsSpace( *pKeyEnd ) )
+			pKeyEnd++;
+
+		const ptrdiff_t keyLength = pKeyEnd - pLine;
+
+		if ( keyLength == 0 || pLine[0] == '#' )
+			continue;
+
+		if ( keyLength == 1 && pLine[0] == 'v' )
+		{
+			// Any w component or vertex color after the position is ignored.
+			float x, y, z;
+			const char* q = GlyphString::ParseFloat( pKeyEnd, pLineEnd, x );
+			if ( q ) q = GlyphString::ParseFloat( q, pLineEnd, y );
+			if ( q ) q = GlyphString::ParseFloat( q, pLineEnd, z );
+
+			if ( !q ) {
+				chunk.error = true;
+				return;
+			}
+
+			chunk.positions.push_back( x );
+			chunk.positions.push_back( y );
+			chunk.positions.push_back( z );
+		}
+		else if ( keyLength == 2 && pLine[0] == 'v' && pLine[1] == 't' )
+		{
+			// The v coordinate is optional, and any w coordinate is ignored.
+			float u;
+			float v = 0.0f;
+			const char* q = GlyphString::ParseFloat( pKeyEnd, pLineEnd, u );
+
+			if ( !q ) {
+				chunk.error = true;
+				return;
+			}
+
+			GlyphString::ParseFloat( q, pLineEnd, v );
+
+			chunk.texcoords.push_back( u );
+			chunk.texcoords.push_back( v );
+		}
+		else if ( keyLength == 2 && pLine[0] == 'v' && pLine[1] == 'n' )
+		{
+			float x, y, z;
+			const char* q = GlyphString::ParseFloat( pKeyEnd, pLineEnd, x );
+			if ( q ) q = GlyphString::ParseFloat( q, pLineEnd, y );
+			if ( q ) q = GlyphString::ParseFloat( q, pLineEnd, z );
+
+			if ( !q ) {
+				chunk.error = true;
+				return;
+			}
+
+			chunk.normals.push_back( x );
+			chunk.normals.push_back( y );
+			chunk.normals.push_back( z );
+		}
+		else if ( keyLength == 1 && pLine[0] == 'f' )
+		{
+			// Each corner is 'p', 'p/t', 'p//n' or 'p/t/n'.  The polygon is split
+			// into a fan around its first corner.
+
+			const int counts[3] = {
+				static_cast<int>( chunk.positions.size() / 3 ),
+				static_cast<int>( chunk.texcoords.size() / 2 ),
+				static_cast<int>( chunk.normals.size() / 3 ) };
+
+			const char* q = pKeyEnd;
+			unsigned int cornerCount = 0;
+
+			while ( true )
+			{
+				while ( q < pLineEnd && IsSpace( *q ) )
+					q++;
+
+				if ( q == pLineEnd )
+					break;
+
+				Corner corner;
+				corner.index[1] = -1;
+				corner.index[2] = -1;
+				corner.relative = 0;
+
+				for ( int k = 0; k < 3 && q; k++ )
+				{
+					if ( k > 0 )
+					{
+						if ( q == pLineEnd || *q != '/' )
+							break;
+
+						q++;
+
+						// An empty texture coordinate, as in 'p//n'.
+						if ( k == 1 && q < pLineEnd && *q == '/' )
+							continue;
+					}
+
+					int value;
+					q = ParseInt( q, pLineEnd, value );
+
+					if ( q && value > 0 ) {
+						corner.index[k] = value - 1;
+					} else if ( q && value < 0 ) {
+						corner.index[k] = counts[k] + value;
+						corner.relative |= 1 << k;
+					} else {
+						q = nullptr;
+					}
+				}
+
+				if ( !q || ( q < pLineEnd && !IsSpace( *q ) ) ) {
+					chunk.error = true;
+					return;
+				}
+
+				if ( cornerCount == 0 ) {
+					fan[0] = corner;
+				} else if ( cornerCount >= 2 ) {
+					chunk.corners.push_back( fan[0] );
+					chunk.corners.push_back( fan[1] );
+					chunk.corners.push_back( corner );
+				}
+
+				fan[1] = corner;
+				cornerCount++;
+			}
+		}
+		else if ( keyLength == 1 && pLine[0] == 'o' )
+		{
+			Event event;
+			event.type = OBJ_OBJECT;
+			event.corner = static_cast<unsigned int>( chunk.corners.size() );
+			event.name = ParseName( pKeyEnd, pLineEnd );
+			event.part = 0;
+			chunk.events.push_back( event );
+		}
+		else if ( keyLength == 6 && strncmp( pLine, "usemtl", 6 ) == 0 )
+		{
+			Event event;
+			event.type = OBJ_MATERIAL;
+			event.corner = static_cast<unsigned int>( chunk.corners.size() );
+			event.name = ParseName( pKeyEnd, pLineEnd );
+			event.part = 0;
+			chunk.events.push_back( event );
+		}
+		else if ( keyLength == 6 && strncmp( pLine, "mtllib", 6 ) == 0 )
+		{
+			chunk.libraries.push_back( ParseName( pKeyEnd, pLineEnd ) );
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+void ObjImporterDX11::ResolveChunk( Chunk& chunk, const unsigned int* pTotals )
+{
+	for ( auto& corner : chunk.corners )
+	{
+		for ( int k = 0; k < 3; k++ )
+		{
+			int& index = corner.index[k];
+
+			if ( corner.relative & ( 1 << k ) )
+				index += static_cast<int>( chunk.base[k] );
+			else if ( k > 0 && index == -1 )
+				continue;
+
+			if ( index < 0 || index >= static_cast<int>( pTotals[k] ) ) {
+				chunk.error = true;
+				return;
+			}
+		}
+
+		corner.relative = 0;
+	}
+}
+//--------------------------------------------------------------------------------
+void ObjImporterDX11::WeldChunk( Chunk& chunk, unsigned int partCount )
+{
+	// The triplets are welded per part, since a vertex can't be shared between
+	// two geometries.
+
+	const unsigned int tableSize = TableSize( chunk.corners.size() );
+	std::vector<UINT> table( tableSize, NoVertex );
+
+	chunk.indices.resize( chunk.corners.size() );
+	chunk.partCorners.assign( partCount, 0 );
+
+	unsigned int part = chunk.firstPart;
+	size_t nextEvent = 0;
+
+	for ( size_t i = 0; i < chunk.corners.size(); i++ )
+	{
+		while ( nextEvent < chunk.events.size() && chunk.events[nextEvent].corner <= i )
+			part = chunk.events[nextEvent++].part;
+
+		const int* pIndex = chunk.corners[i].index;
+		unsigned int slot = HashVertex( part, pIndex ) & ( tableSize - 1 );
+
+		while ( table[slot] != NoVertex )
+		{
+			const Vertex& existing = chunk.vertices[table[slot]];
+
+			if ( existing.part == part && SameIndices( existing.index, pIndex ) )
+				break;
+
+			slot = ( slot + 1 ) & ( tableSize - 1 );
+		}
+
+		if ( table[slot] == NoVertex )
+		{
+			Vertex vertex;
+			vertex.part = part;
+			vertex.index[0] = pIndex[0];
+			vertex.index[1] = pIndex[1];
+			vertex.index[2] = pIndex[2];
+
+			table[slot] = static_cast<UINT>( chunk.vertices.size() );
+			chunk.vertices.push_back( vertex );
+		}
+
+		chunk.indices[i] = table[slot];
+		chunk.partCorners[part]++;
+	}
+
+	// The raw data is no longer needed.
+	std::vector<Corner>().swap( chunk.corners );
+}
+//--------------------------------------------------------------------------------
+const char* ObjImporterDX11::ParseInt( const char* p, const char* pEnd, int& value )
+{
+	bool bNegative = false;
+	if ( p < pEnd && ( *p == '-' || *p == '+' ) )
+		bNegative = ( *p++ == '-' );
+
+	const char* pDigits = p;
+	int result = 0;
+
+	// Numbers that don't fit are rejected rather than wrapped around.
+
+	for ( ; p < pEnd && *p >= '0' && *p <= '9'; p++ ) {
+		if ( result > ( INT_MAX - 9 ) / 10 )
+			return( nullptr );
+
+		result = result * 10 + ( *p - '0' );
+	}
+
+	if ( p == pDigits )
+		return( nullptr );
+
+	value = bNegative ? -result : result;
+
+	return( p );
+}
+//--------------------------------------------------------------------------------
+std::string ObjImporterDX11::ParseName( const char* p, const char* pEnd )
+{
+	// The name is the rest of the line, which may contain spaces.
+
+	while ( p < pEnd && IsSpace( *p ) )
+		p++;
+
+	while ( pEnd > p && IsSpace( *( pEnd - 1 ) ) )
+		pEnd--;
+
+	return( std::string( p, pEnd ) );
+}
+//--------------------------------------------------------------------------------
@@ -14,6 +14,9 @@
 #include "Log.h"
 #include "RenderParameterDX11.h"
 #include "IParameterManager.h"
+#include "ParameterNameTable.h"
+#include "Profiler.h"
+#include <algorithm>
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
@@ -34,20 +37,13 @@ void ParameterContainer::AddRenderParameter( ParameterWriter* pWriter )
 
 	if ( pWriter )
 	{
-		// Search the list to see if this parameter is already there
-		ParameterWriter* pCurr = 0;
+		// Search the index to see if this parameter is already there
+		const unsigned int nameID = pWriter->GetRenderParameterRef()->GetNameID();
+		auto it = std::lower_bound( m_Index.begin(), m_Index.end(), nameID, CompareID );
 
-		for ( unsigned int i = 0; i < m_RenderParameters.size(); i++ )
-		{
-			if ( pWriter->GetRenderParameterRef()->GetName() == m_RenderParameters[i]->GetRenderParameterRef()->GetName() )
-			{
-				pCurr = m_RenderParameters[i];
-				break;
-			}
-		}
-
-		if ( !pCurr )
+		if ( it == m_Index.end() || it->first != nameID )
 		{
+			m_Index.insert( it, std::make_pair( nameID, pWriter ) );
 			m_RenderParameters.push_back( pWriter );
 		}
 		else
@@ -58,23 +54,34 @@ void ParameterContainer::AddRenderParameter( ParameterWriter* pWriter )
 }
 //--------------------------------------------------------------------------------
 ParameterWriter* ParameterContainer::GetRenderParameter( const std::wstring& name )
+{
+	// A name that has never been interned can't belong to any parameter.
+
+	const unsigned int nameID = ParameterNameTable::Get()->Find( name );
+
+	if ( nameID == ParameterNameTable::InvalidID )
+		return( nullptr );
+
+	return( GetRenderParameter( nameID ) );
+}
+//--------------------------------------------------------------------------------
+ParameterWriter* ParameterContainer::GetRenderParameter( unsigned int nameID )
 {
 	ParameterWriter* pResult = nullptr;
 
-	for ( auto pParameterWriter : m_RenderParameters )
-	{
-		RenderParameterDX11* pParameter = pParameterWriter->GetRenderParameterRef();
-		if ( pParameter != nullptr ) {
-			if ( name.compare( pParameter->GetName() ) == 0 ) {
-				pResult = pParameterWriter;
-				break;
-			}
-		}
-	}
+	auto it = std::lower_bound( m_Index.begin(), m_Index.end(), nameID, CompareID );
+
+	if ( it != m_Index.end() && it->first == nameID )
+		pResult = it->second;
 
 	return( pResult );
 }
 //--------------------------------------------------------------------------------
+bool ParameterContainer::CompareID( const std::pair< unsigned int, ParameterWriter* >& entry, unsigned int nameID )
+{
+	return( entry.first < nameID );
+}
+//--------------------------------------------------------------------------------
 ConstantBufferParameterWriterDX11* ParameterContainer::GetConstantBufferParameterWriter( const std::wstring& name )
 {
 	ParameterWriter* pWriter = nullptr;
@@ -292,8 +299,15 @@ VectorParameterWriterDX11* ParameterContainer::GetVectorParameterWriter( const s
 	return( pVectorWriter );
 }
 //--------------------------------------------------------------------------------
+unsigned int ParameterContainer::GetRenderParameterCount( ) const
+{
+	return( static_cast<unsigned int>( m_RenderParameters.size() ) );
+}
+//--------------------------------------------------------------------------------
 void ParameterContainer::SetRenderParams( IParameterManager* pParamManager )
 {
+	GLYPH_PROFILE_SCOPE( "ParameterContainer::SetRenderParams" );
+
 	// Scroll through each parameter and set it in the provided parameter manager.
 	for ( auto pParamWriter : m_RenderParameters )
 		pParamWriter->WriteParameter( pParamManager );
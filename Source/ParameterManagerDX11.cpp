@@ -18,11 +18,12 @@
 #include "UnorderedAccessParameterDX11.h"
 #include "ConstantBufferParameterDX11.h"
 #include "SamplerParameterDX11.h"
+#include "ParameterNameTable.h"
 #include "Log.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
-std::map< std::wstring, RenderParameterDX11* >	ParameterManagerDX11::m_Parameters;
+std::vector< RenderParameterDX11* >	ParameterManagerDX11::m_Parameters;
 //--------------------------------------------------------------------------------
 ParameterManagerDX11::ParameterManagerDX11( unsigned int ID )
 {
@@ -41,10 +42,8 @@ ParameterManagerDX11::ParameterManagerDX11( unsigned int ID )
 ParameterManagerDX11::~ParameterManagerDX11()
 {
 	// Iterate the list of parameters and release them
-	std::map< std::wstring, RenderParameterDX11* >::iterator iter = m_Parameters.begin();
-	while ( iter != m_Parameters.end() ) {
-		SAFE_DELETE( iter->second );
-		iter++;
+	for ( auto pParameter : m_Parameters ) {
+		SAFE_DELETE( pParameter );
 	}
 
 	m_Parameters.clear();
@@ -159,14 +158,14 @@ unsigned int ParameterManagerDX11::GetID()
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::SetVectorParameter( const std::wstring& name, Vector4f* pVector )
 {
-	RenderParameterDX11* pParameter = m_Parameters[name];
+	RenderParameterDX11* pParameter = FindParameter( name );
 
 	// Only create the new parameter if it hasn't already been registered
 	if ( pParameter == 0 )
 	{
 		pParameter = new VectorParameterDX11();
 		pParameter->SetName( name );
-		m_Parameters[name] = reinterpret_cast<RenderParameterDX11*>( pParameter );
+		StoreParameter( pParameter );
 
 		// Initialize the parameter with the current data in all slots
 		pParameter->InitializeParameterData( reinterpret_cast<void*>( pVector ) );
@@ -182,14 +181,14 @@ void ParameterManagerDX11::SetVectorParameter( const std::wstring& name, Vector4
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::SetMatrixParameter( const std::wstring& name, Matrix4f* pMatrix )
 {
-	RenderParameterDX11* pParameter = m_Parameters[name];
+	RenderParameterDX11* pParameter = FindParameter( name );
 
 	// Only create the new parameter if it hasn't already been registered
 	if ( pParameter == 0 )
 	{
 		pParameter = new MatrixParameterDX11();
 		pParameter->SetName( name );
-		m_Parameters[name] = reinterpret_cast<RenderParameterDX11*>( pParameter );
+		StoreParameter( pParameter );
 		
 		// Initialize the parameter with the current data in all slots
 		pParameter->InitializeParameterData( reinterpret_cast<void*>( pMatrix ) );
@@ -205,14 +204,14 @@ void ParameterManagerDX11::SetMatrixParameter( const std::wstring& name, Matrix4
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::SetMatrixArrayParameter( const std::wstring& name, int count, Matrix4f* pMatrix )
 {
-	RenderParameterDX11* pParameter = m_Parameters[name];
+	RenderParameterDX11* pParameter = FindParameter( name );
 
 	// Only create the new parameter if it hasn't already been registered
 	if ( pParameter == 0 )
 	{
 		pParameter = new MatrixArrayParameterDX11( count );
 		pParameter->SetName( name );
-		m_Parameters[name] = reinterpret_cast<RenderParameterDX11*>( pParameter );
+		StoreParameter( pParameter );
 
 		// Initialize the parameter with the current data in all slots
 		pParameter->InitializeParameterData( reinterpret_cast<void*>( pMatrix ) );
@@ -228,14 +227,14 @@ void ParameterManagerDX11::SetMatrixArrayParameter( const std::wstring& name, in
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::SetShaderResourceParameter( const std::wstring& name, ResourcePtr resource )
 {
-	RenderParameterDX11* pParameter = m_Parameters[name];
+	RenderParameterDX11* pParameter = FindParameter( name );
 
 	// Only create the new parameter if it hasn't already been registered
 	if ( pParameter == 0 )
 	{
 		pParameter = new ShaderResourceParameterDX11();
 		pParameter->SetName( name );
-		m_Parameters[name] = reinterpret_cast<RenderParameterDX11*>( pParameter );
+		StoreParameter( pParameter );
 
 		// Initialize the parameter with the current data in all slots
 		pParameter->InitializeParameterData( reinterpret_cast<void*>( &resource->m_iResourceSRV ) );
@@ -251,14 +250,14 @@ void ParameterManagerDX11::SetShaderResourceParameter( const std::wstring& name,
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::SetUnorderedAccessParameter( const std::wstring& name, ResourcePtr resource, unsigned int initial )
 {
-	RenderParameterDX11* pParameter = m_Parameters[name];
+	RenderParameterDX11* pParameter = FindParameter( name );
 
 	// Only create the new parameter if it hasn't already been registered
 	if ( pParameter == 0 )
 	{
 		pParameter = new UnorderedAccessParameterDX11();
 		pParameter->SetName( name );
-		m_Parameters[name] = reinterpret_cast<RenderParameterDX11*>( pParameter );
+		StoreParameter( pParameter );
 
 		// Initialize the parameter with the current data in all slots
 		UAVParameterData data; 
@@ -283,14 +282,14 @@ void ParameterManagerDX11::SetUnorderedAccessParameter( const std::wstring& name
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::SetConstantBufferParameter( const std::wstring& name, ResourcePtr resource )
 {
-	RenderParameterDX11* pParameter = m_Parameters[name];
+	RenderParameterDX11* pParameter = FindParameter( name );
 
 	// Only create the new parameter if it hasn't already been registered
 	if ( pParameter == 0 )
 	{
 		pParameter = new ConstantBufferParameterDX11();
 		pParameter->SetName( name );
-		m_Parameters[name] = reinterpret_cast<RenderParameterDX11*>( pParameter );
+		StoreParameter( pParameter );
 
 		// Initialize the parameter with the current data in all slots
 		pParameter->InitializeParameterData( reinterpret_cast<void*>( &resource->m_iResource ) );
@@ -306,14 +305,14 @@ void ParameterManagerDX11::SetConstantBufferParameter( const std::wstring& name,
 //--------------------------------------------------------------------------------
 void ParameterManagerDX11::SetSamplerParameter( const std::wstring& name, int* pID )
 {
-	RenderParameterDX11* pParameter = m_Parameters[name];
+	RenderParameterDX11* pParameter = FindParameter( name );
 
 	// Only create the new parameter if it hasn't already been registered
 	if ( pParameter == 0 )
 	{
 		pParameter = new SamplerParameterDX11();
 		pParameter->SetName( name );
-		m_Parameters[name] = reinterpret_cast<RenderParameterDX11*>( pParameter );
+		StoreParameter( pParameter );
 
 		// Initialize the parameter with the current data in all slots
 		pParameter->InitializeParameterData( reinterpret_cast<void*>( pID ) );
@@ -410,7 +409,7 @@ Vector4f ParameterManagerDX11::GetVectorParameter( const std::wstring& name )
 	{
 		pParam = new VectorParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		StoreParameter( pParam );
 	}
 
 	return( result );
@@ -438,7 +437,7 @@ Matrix4f ParameterManagerDX11::GetMatrixParameter( const std::wstring& name )
 	{
 		pParam = new MatrixParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		StoreParameter( pParam );
 	}
 
 	return( result );
@@ -466,7 +465,7 @@ Matrix4f* ParameterManagerDX11::GetMatrixArrayParameter( const std::wstring& nam
 	{
 		pParam = new MatrixArrayParameterDX11( count );
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		StoreParameter( pParam );
 		pResult = reinterpret_cast<MatrixArrayParameterDX11*>( pParam )->GetMatrices( GetID() );
 	}
 
@@ -495,7 +494,7 @@ int ParameterManagerDX11::GetShaderResourceParameter( const std::wstring& name )
 	{
 		pParam = new ShaderResourceParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		StoreParameter( pParam );
 	}
 
 	return( result );
@@ -523,7 +522,7 @@ int ParameterManagerDX11::GetUnorderedAccessParameter( const std::wstring& name
 	{
 		pParam = new UnorderedAccessParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		StoreParameter( pParam );
 	}
 
 	return( result );
@@ -551,7 +550,7 @@ int ParameterManagerDX11::GetConstantBufferParameter( const std::wstring& name )
 	{
 		pParam = new ConstantBufferParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		StoreParameter( pParam );
 	}
 
 	return( result );
@@ -579,7 +578,7 @@ int ParameterManagerDX11::GetSamplerStateParameter( const std::wstring& name )
 	{
 		pParam = new SamplerParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		StoreParameter( pParam );
 	}
 
 	return( result );	
@@ -709,7 +708,7 @@ VectorParameterDX11* ParameterManagerDX11::GetVectorParameterRef( const std::wst
 	{
 		pParam = new VectorParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		StoreParameter( pParam );
 	}
 
 	return( reinterpret_cast<VectorParameterDX11*>( pParam ) );
@@ -729,7 +728,7 @@ MatrixParameterDX11* ParameterManagerDX11::GetMatrixParameterRef( const std::wst
 	{
 		pParam = new MatrixParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		StoreParameter( pParam );
 	}
 
 	return( reinterpret_cast<MatrixParameterDX11*>( pParam ) );
@@ -746,7 +745,7 @@ MatrixArrayParameterDX11* ParameterManagerDX11::GetMatrixArrayParameterRef( cons
 	{
 		pParam = new MatrixArrayParameterDX11( count );
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		StoreParameter( pParam );
 	}
 
 	return( reinterpret_cast<MatrixArrayParameterDX11*>( pParam ) );
@@ -766,7 +765,7 @@ ShaderResourceParameterDX11* ParameterManagerDX11::GetShaderResourceParameterRef
 	{
 		pParam = new ShaderResourceParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		StoreParameter( pParam );
 	}
 
 	return( reinterpret_cast<ShaderResourceParameterDX11*>( pParam ) );
@@ -786,7 +785,7 @@ UnorderedAccessParameterDX11* ParameterManagerDX11::GetUnorderedAccessParameterR
 	{
 		pParam = new UnorderedAccessParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		StoreParameter( pParam );
 	}
 
 	return( reinterpret_cast<UnorderedAccessParameterDX11*>( pParam ) );
@@ -806,7 +805,7 @@ ConstantBufferParameterDX11* ParameterManagerDX11::GetConstantBufferParameterRef
 	{
 		pParam = new ConstantBufferParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		StoreParameter( pParam );
 	}
 
 	return( reinterpret_cast<ConstantBufferParameterDX11*>( pParam ) );
@@ -826,7 +825,7 @@ SamplerParameterDX11* ParameterManagerDX11::GetSamplerStateParameterRef( const s
 	{
 		pParam = new SamplerParameterDX11();
 		pParam->SetName( name );
-		m_Parameters[name] = pParam;
+		StoreParameter( pParam );
 	}
 
 	return( reinterpret_cast<SamplerParameterDX11*>( pParam ) );	
@@ -902,7 +901,7 @@ void ParameterManagerDX11::DetachParent( )
 RenderParameterDX11* ParameterManagerDX11::GetParameterRef( const std::wstring& name )
 {
 	// First check this parameter manager
-	RenderParameterDX11* pParam = m_Parameters[name];
+	RenderParameterDX11* pParam = FindParameter( name );
 
 	// Then check the parent manager
 	if ( ( pParam == 0 ) && ( m_pParent ) )
@@ -912,3 +911,48 @@ RenderParameterDX11* ParameterManagerDX11::GetParameterRef( const std::wstring&
 	return( pParam );
 }
 //--------------------------------------------------------------------------------
+RenderParameterDX11* ParameterManagerDX11::GetParameterRef( unsigned int nameID )
+{
+	RenderParameterDX11* pParam = FindParameter( nameID );
+
+	if ( ( pParam == 0 ) && ( m_pParent ) )
+		pParam = m_pParent->GetParameterRef( nameID );
+
+	return( pParam );
+}
+//--------------------------------------------------------------------------------
+unsigned int ParameterManagerDX11::GetNameID( const std::wstring& name )
+{
+	return( ParameterNameTable::Get()->Intern( name ) );
+}
+//--------------------------------------------------------------------------------
+RenderParameterDX11* ParameterManagerDX11::FindParameter( unsigned int nameID )
+{
+	// Names that have never been interned have the invalid ID, which is always
+	// outside of the parameter list.
+
+	if ( nameID < m_Parameters.size() )
+		return( m_Parameters[nameID] );
+
+	return( 0 );
+}
+//--------------------------------------------------------------------------------
+RenderParameterDX11* ParameterManagerDX11::FindParameter( const std::wstring& name )
+{
+	return( FindParameter( ParameterNameTable::Get()->Find( name ) ) );
+}
+//--------------------------------------------------------------------------------
+void ParameterManagerDX11::StoreParameter( RenderParameterDX11* pParameter )
+{
+	// The parameter must already have been named, which assigns its ID.
+
+	const unsigned int nameID = pParameter->GetNameID();
+
+	assert( nameID != ParameterNameTable::InvalidID );
+
+	if ( nameID >= m_Parameters.size() )
+		m_Parameters.resize( nameID + 1, 0 );
+
+	m_Parameters[nameID] = pParameter;
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,200 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "ParameterNameTable.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+ParameterNameTable* ParameterNameTable::m_spNameTable = nullptr;
+//--------------------------------------------------------------------------------
+// Scoped holders for the two modes of the table's SRWLOCK.
+//--------------------------------------------------------------------------------
+namespace
+{
+	struct SharedLock
+	{
+		SharedLock( SRWLOCK& lock ) : m_Lock( lock ) { AcquireSRWLockShared( &m_Lock ); }
+		~SharedLock() { ReleaseSRWLockShared( &m_Lock ); }
+		SRWLOCK& m_Lock;
+	private:
+		SharedLock& operator=( const SharedLock& );
+	};
+
+	struct ExclusiveLock
+	{
+		ExclusiveLock( SRWLOCK& lock ) : m_Lock( lock ) { AcquireSRWLockExclusive( &m_Lock ); }
+		~ExclusiveLock() { ReleaseSRWLockExclusive( &m_Lock ); }
+		SRWLOCK& m_Lock;
+	private:
+		ExclusiveLock& operator=( const ExclusiveLock& );
+	};
+}
+//--------------------------------------------------------------------------------
+ParameterNameTable::ParameterNameTable()
+	: m_uiLookups( 0 )
+{
+	InitializeSRWLock( &m_Lock );
+	m_Slots.resize( 256, 0 );
+
+	if ( !m_spNameTable )
+		m_spNameTable = this;
+}
+//--------------------------------------------------------------------------------
+ParameterNameTable::~ParameterNameTable()
+{
+	if ( m_spNameTable == this )
+		m_spNameTable = nullptr;
+}
+//--------------------------------------------------------------------------------
+ParameterNameTable* ParameterNameTable::Get()
+{
+	return( m_spNameTable );
+}
+//--------------------------------------------------------------------------------
+unsigned int ParameterNameTable::Hash( const std::wstring& name )
+{
+	// FNV-1a over the characters of the name.
+
+	unsigned int hash = 2166136261u;
+
+	for ( auto c : name ) {
+		hash ^= static_cast<unsigned int>( c );
+		hash *= 16777619u;
+	}
+
+	return( hash );
+}
+//--------------------------------------------------------------------------------
+unsigned int ParameterNameTable::FindSlot( const std::wstring& name, unsigned int hash ) const
+{
+	// Returns either the slot holding the name, or the empty slot where it
+	// would be inserted.  The table is never more than half full, so an empty
+	// slot is always found.
+
+	const unsigned int mask = static_cast<unsigned int>( m_Slots.size() ) - 1;
+	unsigned int slot = hash & mask;
+
+	while ( m_Slots[slot] != 0 )
+	{
+		const unsigned int id = m_Slots[slot] - 1;
+
+		if ( m_Hashes[id] == hash && m_Names[id] == name ) {
+			break;
+		}
+
+		slot = ( slot + 1 ) & mask;
+	}
+
+	return( slot );
+}
+//--------------------------------------------------------------------------------
+void ParameterNameTable::Grow( )
+{
+	std::vector< unsigned int > slots( m_Slots.size() * 2, 0 );
+	const unsigned int mask = static_cast<unsigned int>( slots.size() ) - 1;
+
+	for ( unsigned int id = 0; id < m_Hashes.size(); id++ )
+	{
+		unsigned int slot = m_Hashes[id] & mask;
+
+		while ( slots[slot] != 0 ) {
+			slot = ( slot + 1 ) & mask;
+		}
+
+		slots[slot] = id + 1;
+	}
+
+	m_Slots.swap( slots );
+}
+//--------------------------------------------------------------------------------
+unsigned int ParameterNameTable::Intern( const std::wstring& name )
+{
+	const unsigned int hash = Hash( name );
+
+	m_uiLookups++;
+
+	// Names are almost always interned already, which only needs the shared
+	// lock.  Otherwise the lookup is repeated under the exclusive lock, since
+	// another thread may have added the name in between.
+
+	{
+		SharedLock lock( m_Lock );
+
+		const unsigned int slot = FindSlot( name, hash );
+
+		if ( m_Slots[slot] != 0 ) {
+			return( m_Slots[slot] - 1 );
+		}
+	}
+
+	ExclusiveLock lock( m_Lock );
+
+	unsigned int slot = FindSlot( name, hash );
+
+	if ( m_Slots[slot] != 0 ) {
+		return( m_Slots[slot] - 1 );
+	}
+
+	const unsigned int id = static_cast<unsigned int>( m_Names.size() );
+
+	m_Names.push_back( name );
+	m_Hashes.push_back( hash );
+
+	if ( ( m_Names.size() * 2 ) > m_Slots.size() ) {
+		Grow();
+		slot = FindSlot( name, hash );
+	}
+
+	m_Slots[slot] = id + 1;
+
+	return( id );
+}
+//--------------------------------------------------------------------------------
+unsigned int ParameterNameTable::Find( const std::wstring& name ) const
+{
+	const unsigned int hash = Hash( name );
+
+	m_uiLookups++;
+
+	SharedLock lock( m_Lock );
+
+	const unsigned int slot = FindSlot( name, hash );
+
+	return( m_Slots[slot] != 0 ? m_Slots[slot] - 1 : InvalidID );
+}
+//--------------------------------------------------------------------------------
+const std::wstring& ParameterNameTable::GetName( unsigned int id ) const
+{
+	SharedLock lock( m_Lock );
+
+	assert( id < m_Names.size() );
+
+	return( m_Names[id] );
+}
+//--------------------------------------------------------------------------------
+unsigned int ParameterNameTable::GetCount( ) const
+{
+	SharedLock lock( m_Lock );
+
+	return( static_cast<unsigned int>( m_Names.size() ) );
+}
+//--------------------------------------------------------------------------------
+unsigned int ParameterNameTable::GetLookupCount( ) const
+{
+	return( m_uiLookups.load() );
+}
+//--------------------------------------------------------------------------------
+void ParameterNameTable::ResetLookupCount( )
+{
+	m_uiLookups = 0;
+}
+//--------------------------------------------------------------------------------
@@ -63,3 +63,15 @@ void PipelineExecutorDX11::SetLayoutElements( unsigned int count, D3D11_INPUT_EL
 	}
 }
 //--------------------------------------------------------------------------------
+bool PipelineExecutorDX11::SupportsInstancing( )
+{
+	return( false );
+}
+//--------------------------------------------------------------------------------
+void PipelineExecutorDX11::ExecuteInstanced( PipelineManagerDX11* pPipeline, IParameterManager* pParamManager,
+	int instances, UINT start, UINT count )
+{
+	// Executors without instancing support are never batched, so there is
+	// nothing to do here.
+}
+//--------------------------------------------------------------------------------
@@ -42,6 +42,8 @@
 #include "ComputeShaderDX11.h"
 
 #include "IndirectArgsBufferDX11.h"
+#include "ConstantBufferDX11.h"
+#include "ConstantBufferRingDX11.h"
 
 #include "ScreenGrab.h"
 #include <wincodec.h>
@@ -59,6 +61,7 @@ using namespace Glyph3;
 PipelineManagerDX11::PipelineManagerDX11()
 {
     m_iCurrentQuery = 0;
+	m_pConstantRing = nullptr;
 
     ZeroMemory(&m_PipelineStatsData, sizeof(D3D11_QUERY_DATA_PIPELINE_STATISTICS));
 
@@ -76,6 +79,8 @@ PipelineManagerDX11::~PipelineManagerDX11()
 {
 	if( m_pContext ) m_pContext->ClearState();
 	if( m_pContext ) m_pContext->Flush();
+
+	SAFE_DELETE( m_pConstantRing );
 }
 //--------------------------------------------------------------------------------
 void PipelineManagerDX11::SetDeviceContext( DeviceContextComPtr pContext, D3D_FEATURE_LEVEL level )
@@ -85,7 +90,19 @@ void PipelineManagerDX11::SetDeviceContext( DeviceContextComPtr pContext, D3D_FE
 
 	m_pAnnotation = nullptr;
 	HRESULT hr = m_pContext.CopyTo( m_pAnnotation.GetAddressOf() );
-	
+
+	// The constant buffer ring binds its windows through the new context as
+	// well, if one was already created for the previous context.
+
+	if ( m_pConstantRing != nullptr )
+	{
+		m_pContext1 = nullptr;
+		m_pContext.CopyTo( m_pContext1.GetAddressOf() );
+
+		for ( int i = 0; i < 6; i++ )
+			ShaderStages[i]->EnableConstantBufferOffsets( m_pContext1.Get() );
+	}
+
 
 	// For each pipeline stage object, set its feature level here so they know
 	// what they can do and what they can't do.
@@ -103,6 +120,44 @@ void PipelineManagerDX11::SetDeviceContext( DeviceContextComPtr pContext, D3D_FE
 	OutputMergerStage.SetFeautureLevel( level );
 }
 //--------------------------------------------------------------------------------
+bool PipelineManagerDX11::CreateConstantBufferRing( unsigned int capacity )
+{
+	if ( m_pConstantRing != nullptr )
+		return( true );
+
+	// Check that the device can bind a window of a constant buffer, and that a
+	// dynamic constant buffer can be mapped without discarding it.
+
+	Microsoft::WRL::ComPtr<ID3D11Device> pDevice;
+	m_pContext->GetDevice( pDevice.GetAddressOf() );
+
+	if ( pDevice == nullptr )
+		return( false );
+
+	D3D11_FEATURE_DATA_D3D11_OPTIONS options;
+	ZeroMemory( &options, sizeof( options ) );
+
+	HRESULT hr = pDevice->CheckFeatureSupport( D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof( options ) );
+
+	if ( FAILED( hr ) || !options.ConstantBufferOffsetting || !options.MapNoOverwriteOnDynamicConstantBuffer )
+		return( false );
+
+	if ( FAILED( m_pContext.CopyTo( m_pContext1.GetAddressOf() ) ) )
+		return( false );
+
+	m_pConstantRing = new ConstantBufferRingDX11( capacity );
+
+	for ( int i = 0; i < 6; i++ )
+		ShaderStages[i]->EnableConstantBufferOffsets( m_pContext1.Get() );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+ConstantBufferRingDX11* PipelineManagerDX11::GetConstantBufferRing()
+{
+	return( m_pConstantRing );
+}
+//--------------------------------------------------------------------------------
 void PipelineManagerDX11::BindConstantBufferParameter( ShaderType type, RenderParameterDX11* pParam, UINT slot, 
                                                       IParameterManager* pParamManager )
 {
@@ -124,12 +179,23 @@ void PipelineManagerDX11::BindConstantBufferParameter( ShaderType type, RenderPa
 				// Get the resource to be set, and pass it in to the desired shader type
 				
 				ID3D11Buffer* pBuffer = 0;
+				UINT firstConstant = 0;
+				UINT numConstants = D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT;
 				
 				if ( ID >= 0 ) {
 					pBuffer = (ID3D11Buffer*)pResource->GetResource();
+
+					// If the contents were written into the ring, then bind that
+					// window of the ring instead of the buffer itself.
+
+					if ( m_pConstantRing && pResource->GetType() == RT_CONSTANTBUFFER ) {
+						static_cast<ConstantBufferDX11*>( pResource )->GetRingLocation( m_pConstantRing, pBuffer, firstConstant, numConstants );
+					}
 				}
 
 				ShaderStages[type]->DesiredState.ConstantBuffers.SetState( slot, pBuffer );
+				ShaderStages[type]->DesiredState.ConstantBufferOffsets.SetState( slot, firstConstant );
+				ShaderStages[type]->DesiredState.ConstantBufferSizes.SetState( slot, numConstants );
 			} else {
 				Log::Get().Write( L"Tried to set an invalid constant buffer ID!" );
 			}
@@ -869,6 +935,12 @@ void PipelineManagerDX11::GenerateCommandList( CommandListDX11* pList )
 	{
 		m_pContext->FinishCommandList( false, &pList->m_pList );
 
+		// The next command list has to start with a discarded ring, since the
+		// contents of dynamic buffers don't carry over between command lists.
+
+		if ( m_pConstantRing )
+			m_pConstantRing->RequireDiscard();
+
 		// Reset the cached context state to default, since we do that for all
 		// command lists.
 
@@ -45,26 +45,42 @@ void PixelStageDX11::BindShaderProgram( ID3D11DeviceContext* pContext )
 //--------------------------------------------------------------------------------
 void PixelStageDX11::BindConstantBuffers( ID3D11DeviceContext* pContext, int count )
 {
-	pContext->PSSetConstantBuffers(
-		DesiredState.ConstantBuffers.GetStartSlot(),
-		DesiredState.ConstantBuffers.GetRange(),
-		DesiredState.ConstantBuffers.GetFirstSlotLocation() );
+	unsigned int slot = 0;
+	unsigned int range = 0;
+
+	while ( DesiredState.GetNextConstantBufferRange( slot, range ) ) {
+		if ( m_pContext1 ) {
+			m_pContext1->PSSetConstantBuffers1( slot, range,
+				DesiredState.ConstantBuffers.GetSlotLocation( slot ),
+				DesiredState.ConstantBufferOffsets.GetSlotLocation( slot ),
+				DesiredState.ConstantBufferSizes.GetSlotLocation( slot ) );
+		} else {
+			pContext->PSSetConstantBuffers( slot, range, DesiredState.ConstantBuffers.GetSlotLocation( slot ) );
+		}
+		slot += range;
+	}
 }
 //--------------------------------------------------------------------------------
 void PixelStageDX11::BindSamplerStates( ID3D11DeviceContext* pContext, int count )
 {
-	pContext->PSSetSamplers( 
-		DesiredState.SamplerStates.GetStartSlot(),
-		DesiredState.SamplerStates.GetRange(),
-		DesiredState.SamplerStates.GetFirstSlotLocation() );
+	unsigned int slot = 0;
+	unsigned int range = 0;
+
+	while ( DesiredState.SamplerStates.GetNextRange( slot, range ) ) {
+		pContext->PSSetSamplers( slot, range, DesiredState.SamplerStates.GetSlotLocation( slot ) );
+		slot += range;
+	}
 }
 //--------------------------------------------------------------------------------
 void PixelStageDX11::BindShaderResourceViews( ID3D11DeviceContext* pContext, int count )
 {
-	pContext->PSSetShaderResources( 
-		DesiredState.ShaderResourceViews.GetStartSlot(),
-		DesiredState.ShaderResourceViews.GetRange(),
-		DesiredState.ShaderResourceViews.GetFirstSlotLocation() ); 
+	unsigned int slot = 0;
+	unsigned int range = 0;
+
+	while ( DesiredState.ShaderResourceViews.GetNextRange( slot, range ) ) {
+		pContext->PSSetShaderResources( slot, range, DesiredState.ShaderResourceViews.GetSlotLocation( slot ) );
+		slot += range;
+	}
 }
 //--------------------------------------------------------------------------------
 void PixelStageDX11::BindUnorderedAccessViews( ID3D11DeviceContext* pContext, int count )
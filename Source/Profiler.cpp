@@ -0,0 +1,446 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "Profiler.h"
+#if !defined(_WIN32)
+#include <chrono>
+#endif
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+std::atomic<bool> Profiler::ms_bEnabled( false );
+Profiler Profiler::ms_Profiler;
+//--------------------------------------------------------------------------------
+// Each thread finds its own buffer through this pointer, which is set the first
+// time the thread enters a zone.
+//--------------------------------------------------------------------------------
+static GLYPH_THREAD_LOCAL Profiler::ThreadBuffer* s_pThreadBuffer = nullptr;
+//--------------------------------------------------------------------------------
+// The capture is limited in size, so that a capture that is left running can't
+// use up all of the memory.
+//--------------------------------------------------------------------------------
+static const unsigned int MaxCapturedEvents = 1024 * 1024;
+//--------------------------------------------------------------------------------
+Profiler::Profiler() :
+	m_uiFrame( 0 ),
+	m_uiDropped( 0 ),
+	m_bCapturing( false ),
+	m_CaptureStart( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+Profiler::~Profiler()
+{
+	ms_bEnabled = false;
+
+	for ( auto pBuffer : m_Buffers )
+		delete pBuffer;
+
+	m_Buffers.clear();
+}
+//--------------------------------------------------------------------------------
+Profiler& Profiler::Get()
+{
+	return( ms_Profiler );
+}
+//--------------------------------------------------------------------------------
+void Profiler::SetEnabled( bool enable )
+{
+	ms_bEnabled = enable;
+}
+//--------------------------------------------------------------------------------
+bool Profiler::IsEnabled() const
+{
+	return( ms_bEnabled.load( std::memory_order_relaxed ) );
+}
+//--------------------------------------------------------------------------------
+unsigned long long Profiler::GetTimestamp()
+{
+#if defined(_WIN32)
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter( &counter );
+	return( static_cast<unsigned long long>( counter.QuadPart ) );
+#else
+	return( static_cast<unsigned long long>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch() ).count() ) );
+#endif
+}
+//--------------------------------------------------------------------------------
+double Profiler::GetTimestampFrequency()
+{
+#if defined(_WIN32)
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency( &frequency );
+	return( static_cast<double>( frequency.QuadPart ) );
+#else
+	return( 1000000000.0 );
+#endif
+}
+//--------------------------------------------------------------------------------
+Profiler::ThreadBuffer* Profiler::EnterZone()
+{
+	ThreadBuffer* pBuffer = s_pThreadBuffer;
+
+	if ( pBuffer == nullptr )
+	{
+		// This only happens once per thread, so the lock isn't a concern.
+
+		pBuffer = new ThreadBuffer();
+		pBuffer->depth = 0;
+		pBuffer->head = 0;
+		pBuffer->tail = 0;
+
+		std::lock_guard<std::mutex> lock( m_Lock );
+		pBuffer->thread = static_cast<unsigned int>( m_Buffers.size() );
+		m_Buffers.push_back( pBuffer );
+
+		s_pThreadBuffer = pBuffer;
+	}
+
+	pBuffer->depth++;
+
+	return( pBuffer );
+}
+//--------------------------------------------------------------------------------
+void Profiler::LeaveZone( ThreadBuffer* pBuffer, const char* name, unsigned long long begin )
+{
+	const unsigned long long end = GetTimestamp();
+	const unsigned int head = pBuffer->head.load( std::memory_order_relaxed );
+
+	pBuffer->depth--;
+
+	Event& event = pBuffer->events[head % BufferSize];
+	event.name = name;
+	event.begin = begin;
+	event.end = end;
+	event.depth = pBuffer->depth;
+	event.thread = pBuffer->thread;
+
+	// Publish the event to the collector.
+
+	pBuffer->head.store( head + 1, std::memory_order_release );
+}
+//--------------------------------------------------------------------------------
+void Profiler::Collect( ThreadBuffer* pBuffer, std::vector<Event>& events )
+{
+	// Called with the lock held.  The counters are allowed to wrap around, since
+	// only their differences are used.
+
+	unsigned int head = pBuffer->head.load( std::memory_order_acquire );
+	unsigned int tail = pBuffer->tail;
+
+	if ( head - tail > BufferSize )
+	{
+		m_uiDropped += head - tail - BufferSize;
+		tail = head - BufferSize;
+	}
+
+	const size_t first = events.size();
+
+	for ( unsigned int i = tail; i != head; i++ )
+		events.push_back( pBuffer->events[i % BufferSize] );
+
+	// The owning thread may have written over the oldest events while they were
+	// being copied, in which case those copies are discarded.  The event at
+	// 'latest' may be in the middle of being written without being published,
+	// and it shares its slot with the event BufferSize before it, so that event
+	// is counted as overwritten as well.
+
+	const unsigned int latest = pBuffer->head.load( std::memory_order_acquire );
+
+	if ( latest + 1 - tail > BufferSize )
+	{
+		unsigned int overwritten = latest + 1 - tail - BufferSize;
+
+		if ( overwritten > head - tail )
+			overwritten = head - tail;
+
+		events.erase( events.begin() + first, events.begin() + first + overwritten );
+		m_uiDropped += overwritten;
+	}
+
+	pBuffer->tail = head;
+}
+//--------------------------------------------------------------------------------
+Profiler::ZoneStatistics& Profiler::GetZone( const char* name )
+{
+	// Zones are looked up by their name pointer first, and only by their text
+	// when a new pointer is seen, since the same name can be stored in several
+	// places.
+
+	auto lookup = m_ZoneLookup.find( name );
+
+	if ( lookup != m_ZoneLookup.end() )
+		return( m_Zones[lookup->second] );
+
+	std::string text( name );
+	unsigned int index = 0;
+
+	auto named = m_ZoneNames.find( text );
+
+	if ( named != m_ZoneNames.end() )
+	{
+		index = named->second;
+	}
+	else
+	{
+		ZoneStatistics zone;
+		zone.name = text;
+		zone.calls = 0;
+		zone.frameTime = 0.0f;
+		zone.averageTime = 0.0f;
+		zone.maximumTime = 0.0f;
+
+		for ( unsigned int i = 0; i < HistoryFrames; i++ )
+			zone.history[i] = 0.0f;
+
+		index = static_cast<unsigned int>( m_Zones.size() );
+		m_Zones.push_back( zone );
+		m_ZoneNames[text] = index;
+	}
+
+	m_ZoneLookup[name] = index;
+
+	return( m_Zones[index] );
+}
+//--------------------------------------------------------------------------------
+void Profiler::EndFrame()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	std::vector<Event> events;
+
+	for ( auto pBuffer : m_Buffers )
+		Collect( pBuffer, events );
+
+	// Accumulate the time of each zone over the frame.
+
+	const float milliseconds = static_cast<float>( 1000.0 / GetTimestampFrequency() );
+
+	for ( auto& zone : m_Zones )
+	{
+		zone.calls = 0;
+		zone.frameTime = 0.0f;
+	}
+
+	for ( auto& event : events )
+	{
+		ZoneStatistics& zone = GetZone( event.name );
+		zone.calls++;
+		zone.frameTime += static_cast<float>( event.end - event.begin ) * milliseconds;
+	}
+
+	// Then roll the frame into the history of every zone.
+
+	const unsigned int slot = m_uiFrame % HistoryFrames;
+	const unsigned int frames = m_uiFrame + 1 < HistoryFrames ? m_uiFrame + 1 : HistoryFrames;
+
+	for ( auto& zone : m_Zones )
+	{
+		zone.history[slot] = zone.frameTime;
+
+		float total = 0.0f;
+		zone.maximumTime = 0.0f;
+
+		for ( unsigned int i = 0; i < frames; i++ )
+		{
+			total += zone.history[i];
+
+			if ( zone.history[i] > zone.maximumTime )
+				zone.maximumTime = zone.history[i];
+		}
+
+		zone.averageTime = total / static_cast<float>( frames );
+	}
+
+	m_uiFrame++;
+
+	if ( m_bCapturing )
+	{
+		size_t count = events.size();
+
+		if ( m_Capture.size() + count > MaxCapturedEvents )
+			count = MaxCapturedEvents - m_Capture.size();
+
+		m_Capture.insert( m_Capture.end(), events.begin(), events.begin() + count );
+	}
+}
+//--------------------------------------------------------------------------------
+void Profiler::BeginCapture()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	m_Capture.clear();
+	m_CaptureStart = GetTimestamp();
+	m_bCapturing = true;
+}
+//--------------------------------------------------------------------------------
+void Profiler::EndCapture()
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	m_bCapturing = false;
+}
+//--------------------------------------------------------------------------------
+bool Profiler::IsCapturing() const
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	return( m_bCapturing );
+}
+//--------------------------------------------------------------------------------
+static void WriteJsonString( std::ofstream& file, const char* text )
+{
+	file << '"';
+
+	for ( const char* c = text; *c != 0; c++ )
+	{
+		if ( *c == '"' || *c == '\\' )
+			file << '\\' << *c;
+		else if ( static_cast<unsigned char>( *c ) < 0x20 )
+			file << ' ';
+		else
+			file << *c;
+	}
+
+	file << '"';
+}
+//--------------------------------------------------------------------------------
+bool Profiler::WriteChromeTrace( const std::wstring& filename )
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+#if defined(_WIN32)
+	std::ofstream file( filename.c_str() );
+#else
+	std::ofstream file( std::string( filename.begin(), filename.end() ).c_str() );
+#endif
+
+	if ( !file.is_open() )
+		return( false );
+
+	const double microseconds = 1000000.0 / GetTimestampFrequency();
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+	// Name each thread, so that they are listed in a readable way.
+
+	bool first = true;
+
+	for ( auto pBuffer : m_Buffers )
+	{
+		if ( !first )
+			file << ",\n";
+
+		file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << pBuffer->thread
+			<< ",\"args\":{\"name\":\"Thread " << pBuffer->thread << "\"}}";
+
+		first = false;
+	}
+
+	file.precision( 3 );
+	file << std::fixed;
+
+	for ( auto& event : m_Capture )
+	{
+		// Zones that started before the capture are clipped to its start.
+
+		const unsigned long long begin = event.begin > m_CaptureStart ? event.begin : m_CaptureStart;
+		const unsigned long long end = event.end > begin ? event.end : begin;
+
+		if ( !first )
+			file << ",\n";
+
+		file << "{\"name\":";
+		WriteJsonString( file, event.name );
+		file << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+			<< ",\"ts\":" << static_cast<double>( begin - m_CaptureStart ) * microseconds
+			<< ",\"dur\":" << static_cast<double>( end - begin ) * microseconds << "}";
+
+		first = false;
+	}
+
+	file << "\n]}\n";
+
+	return( file.good() );
+}
+//--------------------------------------------------------------------------------
+std::vector<Profiler::ZoneStatistics> Profiler::GetStatistics() const
+{
+	std::vector<ZoneStatistics> zones;
+
+	{
+		std::lock_guard<std::mutex> lock( m_Lock );
+		zones = m_Zones;
+	}
+
+	std::sort( zones.begin(), zones.end(), []( const ZoneStatistics& a, const ZoneStatistics& b ) {
+		return( a.averageTime > b.averageTime );
+	} );
+
+	return( zones );
+}
+//--------------------------------------------------------------------------------
+std::wstring Profiler::GetStatisticsTable( unsigned int rows ) const
+{
+	std::vector<ZoneStatistics> zones = GetStatistics();
+
+	std::wstringstream s;
+	s.precision( 3 );
+	s << std::fixed;
+
+	s << L"Zone: calls, frame / average / maximum ms" << std::endl;
+
+	for ( unsigned int i = 0; i < zones.size() && i < rows; i++ )
+	{
+		const ZoneStatistics& zone = zones[i];
+
+		s << std::wstring( zone.name.begin(), zone.name.end() ) << L": " << zone.calls << L", "
+			<< zone.frameTime << L" / " << zone.averageTime << L" / " << zone.maximumTime << std::endl;
+	}
+
+	return( s.str() );
+}
+//--------------------------------------------------------------------------------
+unsigned int Profiler::GetDroppedEvents() const
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	return( m_uiDropped );
+}
+//--------------------------------------------------------------------------------
+double Profiler::MeasureOverhead( unsigned int iterations )
+{
+	if ( iterations == 0 )
+		return( 0.0 );
+
+	const unsigned long long begin = GetTimestamp();
+
+	for ( unsigned int i = 0; i < iterations; i++ )
+	{
+		ProfileScope scope( "Profiler::MeasureOverhead" );
+	}
+
+	const unsigned long long end = GetTimestamp();
+
+	// Throw away the zones that were just recorded, so that they don't show up
+	// in the statistics or count as dropped.
+
+	if ( s_pThreadBuffer != nullptr )
+	{
+		std::lock_guard<std::mutex> lock( m_Lock );
+		s_pThreadBuffer->tail = s_pThreadBuffer->head.load( std::memory_order_acquire );
+	}
+
+	return( static_cast<double>( end - begin ) * 1000000000.0 / GetTimestampFrequency() / iterations );
+}
+//--------------------------------------------------------------------------------
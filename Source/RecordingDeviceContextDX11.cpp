@@ -0,0 +1,1103 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "RecordingDeviceContextDX11.h"
+#include "ShaderReflectionDX11.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+RecordingDeviceContextDX11::RecordingDeviceContextDX11( ID3D11Device* pDevice ) :
+	m_uiReferences( 1 ),
+	m_pDevice( pDevice ),
+	m_bRecording( true )
+{
+	if ( m_pDevice != nullptr )
+		m_pDevice->AddRef();
+
+	Reset();
+}
+//--------------------------------------------------------------------------------
+RecordingDeviceContextDX11::~RecordingDeviceContextDX11()
+{
+	if ( m_pDevice != nullptr )
+		m_pDevice->Release();
+}
+//--------------------------------------------------------------------------------
+void RecordingDeviceContextDX11::Reset()
+{
+	ClearState();
+
+	m_Commands.clear();
+	memset( &m_Statistics, 0, sizeof( m_Statistics ) );
+
+	m_MappedMemory.clear();
+}
+//--------------------------------------------------------------------------------
+void RecordingDeviceContextDX11::SetRecordingEnabled( bool enable )
+{
+	m_bRecording = enable;
+}
+//--------------------------------------------------------------------------------
+bool RecordingDeviceContextDX11::IsRecordingEnabled() const
+{
+	return( m_bRecording );
+}
+//--------------------------------------------------------------------------------
+const std::vector<RecordedCommandDX11>& RecordingDeviceContextDX11::GetCommands() const
+{
+	return( m_Commands );
+}
+//--------------------------------------------------------------------------------
+const RecordingStatisticsDX11& RecordingDeviceContextDX11::GetStatistics() const
+{
+	return( m_Statistics );
+}
+//--------------------------------------------------------------------------------
+std::wstring RecordingDeviceContextDX11::PrintStatistics() const
+{
+	std::wstringstream s;
+
+	s << L"Commands: " << m_Statistics.commands
+		<< L", Draws: " << m_Statistics.draws
+		<< L", Dispatches: " << m_Statistics.dispatches
+		<< L", Bind calls: " << m_Statistics.bindCalls
+		<< L", Bound slots: " << m_Statistics.boundSlots
+		<< L", Redundant slots: " << m_Statistics.redundantSlots
+		<< L", Maps: " << m_Statistics.maps
+		<< L", Mapped bytes: " << m_Statistics.mappedBytes;
+
+	return( s.str() );
+}
+//--------------------------------------------------------------------------------
+void RecordingDeviceContextDX11::Record( RecordedCommandType type, unsigned int stage, unsigned int start, unsigned int count,
+	unsigned int arg0, unsigned int arg1 )
+{
+	m_Statistics.commands++;
+
+	if ( !m_bRecording )
+		return;
+
+	RecordedCommandDX11 command;
+	command.type = type;
+	command.stage = static_cast<unsigned char>( stage );
+	command.count = static_cast<unsigned short>( count );
+	command.start = start;
+	command.args[0] = arg0;
+	command.args[1] = arg1;
+
+	m_Commands.push_back( command );
+}
+//--------------------------------------------------------------------------------
+void RecordingDeviceContextDX11::CountBind( unsigned int slots, unsigned int redundant )
+{
+	m_Statistics.bindCalls++;
+	m_Statistics.boundSlots += slots;
+	m_Statistics.redundantSlots += redundant;
+}
+//--------------------------------------------------------------------------------
+void RecordingDeviceContextDX11::SetShader( unsigned int stage, void* pShader )
+{
+	CountBind( 1, m_Stages[stage].pShader == pShader ? 1 : 0 );
+	m_Stages[stage].pShader = pShader;
+
+	Record( RecordedCommandType::SetShader, stage, 0, 1 );
+}
+//--------------------------------------------------------------------------------
+void RecordingDeviceContextDX11::SetConstantBuffers( unsigned int stage, UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers,
+	const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+	StageState& state = m_Stages[stage];
+	unsigned int redundant = 0;
+
+	for ( UINT i = 0; i < NumBuffers && StartSlot + i < D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT; i++ )
+	{
+		const UINT slot = StartSlot + i;
+		const UINT first = pFirstConstant != nullptr ? pFirstConstant[i] : 0;
+		const UINT count = pNumConstants != nullptr ? pNumConstants[i] : D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT;
+
+		if ( state.ConstantBuffers[slot] == ppConstantBuffers[i]
+			&& state.FirstConstants[slot] == first
+			&& state.NumConstants[slot] == count )
+			redundant++;
+
+		state.ConstantBuffers[slot] = ppConstantBuffers[i];
+		state.FirstConstants[slot] = first;
+		state.NumConstants[slot] = count;
+	}
+
+	CountBind( NumBuffers, redundant );
+	Record( RecordedCommandType::SetConstantBuffers, stage, StartSlot, NumBuffers, pFirstConstant != nullptr ? 1 : 0 );
+}
+//--------------------------------------------------------------------------------
+void RecordingDeviceContextDX11::SetSamplers( unsigned int stage, UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+	StageState& state = m_Stages[stage];
+	unsigned int redundant = 0;
+
+	for ( UINT i = 0; i < NumSamplers && StartSlot + i < D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT; i++ )
+	{
+		if ( state.Samplers[StartSlot + i] == ppSamplers[i] )
+			redundant++;
+
+		state.Samplers[StartSlot + i] = ppSamplers[i];
+	}
+
+	CountBind( NumSamplers, redundant );
+	Record( RecordedCommandType::SetSamplers, stage, StartSlot, NumSamplers );
+}
+//--------------------------------------------------------------------------------
+void RecordingDeviceContextDX11::SetShaderResources( unsigned int stage, UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppViews )
+{
+	StageState& state = m_Stages[stage];
+	unsigned int redundant = 0;
+
+	for ( UINT i = 0; i < NumViews && StartSlot + i < D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT; i++ )
+	{
+		if ( state.ShaderResourceViews[StartSlot + i] == ppViews[i] )
+			redundant++;
+
+		state.ShaderResourceViews[StartSlot + i] = ppViews[i];
+	}
+
+	CountBind( NumViews, redundant );
+	Record( RecordedCommandType::SetShaderResources, stage, StartSlot, NumViews );
+}
+//--------------------------------------------------------------------------------
+void RecordingDeviceContextDX11::SetUnorderedAccessViews( unsigned int stage, UINT StartSlot, UINT NumUAVs, ID3D11UnorderedAccessView* const* ppViews )
+{
+	StageState& state = m_Stages[stage];
+	unsigned int redundant = 0;
+
+	for ( UINT i = 0; i < NumUAVs && StartSlot + i < D3D11_PS_CS_UAV_REGISTER_COUNT; i++ )
+	{
+		if ( state.UnorderedAccessViews[StartSlot + i] == ppViews[i] )
+			redundant++;
+
+		state.UnorderedAccessViews[StartSlot + i] = ppViews[i];
+	}
+
+	CountBind( NumUAVs, redundant );
+	Record( RecordedCommandType::SetUnorderedAccessViews, stage, StartSlot, NumUAVs );
+}
+//--------------------------------------------------------------------------------
+void RecordingDeviceContextDX11::SetState( RecordedCommandType type, void** ppBound, void* pState )
+{
+	CountBind( 1, *ppBound == pState ? 1 : 0 );
+	*ppBound = pState;
+
+	Record( type, 0, 0, 1 );
+}
+//--------------------------------------------------------------------------------
+UINT RecordingDeviceContextDX11::GetMappedSize( ID3D11Resource* pResource, UINT& rowPitch, UINT& depthPitch )
+{
+	// Textures are sized for their top level with the largest texel format, which
+	// is enough for any subresource that gets mapped.
+
+	const UINT texel = 16;
+	D3D11_RESOURCE_DIMENSION dimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+	pResource->GetType( &dimension );
+
+	switch ( dimension )
+	{
+	case D3D11_RESOURCE_DIMENSION_BUFFER:
+	{
+		D3D11_BUFFER_DESC desc;
+		static_cast<ID3D11Buffer*>( pResource )->GetDesc( &desc );
+		rowPitch = depthPitch = desc.ByteWidth;
+		return( desc.ByteWidth );
+	}
+	case D3D11_RESOURCE_DIMENSION_TEXTURE1D:
+	{
+		D3D11_TEXTURE1D_DESC desc;
+		static_cast<ID3D11Texture1D*>( pResource )->GetDesc( &desc );
+		rowPitch = depthPitch = desc.Width * texel;
+		return( rowPitch );
+	}
+	case D3D11_RESOURCE_DIMENSION_TEXTURE2D:
+	{
+		D3D11_TEXTURE2D_DESC desc;
+		static_cast<ID3D11Texture2D*>( pResource )->GetDesc( &desc );
+		rowPitch = desc.Width * texel;
+		depthPitch = rowPitch * desc.Height;
+		return( depthPitch );
+	}
+	case D3D11_RESOURCE_DIMENSION_TEXTURE3D:
+	{
+		D3D11_TEXTURE3D_DESC desc;
+		static_cast<ID3D11Texture3D*>( pResource )->GetDesc( &desc );
+		rowPitch = desc.Width * texel;
+		depthPitch = rowPitch * desc.Height;
+		return( depthPitch * desc.Depth );
+	}
+	default:
+		rowPitch = depthPitch = 0;
+		return( 0 );
+	}
+}
+//--------------------------------------------------------------------------------
+HRESULT STDMETHODCALLTYPE RecordingDeviceContextDX11::QueryInterface( REFIID riid, void** ppvObject )
+{
+	if ( ppvObject == nullptr )
+		return( E_POINTER );
+
+	if ( riid == __uuidof( IUnknown )
+		|| riid == __uuidof( ID3D11DeviceChild )
+		|| riid == __uuidof( ID3D11DeviceContext )
+		|| riid == __uuidof( ID3D11DeviceContext1 ) )
+	{
+		*ppvObject = static_cast<ID3D11DeviceContext1*>( this );
+		AddRef();
+		return( S_OK );
+	}
+
+	*ppvObject = nullptr;
+	return( E_NOINTERFACE );
+}
+//--------------------------------------------------------------------------------
+ULONG STDMETHODCALLTYPE RecordingDeviceContextDX11::AddRef()
+{
+	return( ++m_uiReferences );
+}
+//--------------------------------------------------------------------------------
+ULONG STDMETHODCALLTYPE RecordingDeviceContextDX11::Release()
+{
+	const ULONG references = --m_uiReferences;
+
+	if ( references == 0 )
+		delete this;
+
+	return( references );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::GetDevice( ID3D11Device** ppDevice )
+{
+	*ppDevice = m_pDevice;
+
+	if ( m_pDevice != nullptr )
+		m_pDevice->AddRef();
+}
+//--------------------------------------------------------------------------------
+HRESULT STDMETHODCALLTYPE RecordingDeviceContextDX11::GetPrivateData( REFGUID guid, UINT* pDataSize, void* pData )
+{
+	if ( pDataSize != nullptr )
+		*pDataSize = 0;
+
+	return( DXGI_ERROR_NOT_FOUND );
+}
+//--------------------------------------------------------------------------------
+HRESULT STDMETHODCALLTYPE RecordingDeviceContextDX11::SetPrivateData( REFGUID guid, UINT DataSize, const void* pData )
+{
+	return( S_OK );
+}
+//--------------------------------------------------------------------------------
+HRESULT STDMETHODCALLTYPE RecordingDeviceContextDX11::SetPrivateDataInterface( REFGUID guid, const IUnknown* pData )
+{
+	return( S_OK );
+}
+//--------------------------------------------------------------------------------
+// Shaders
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::VSSetShader( ID3D11VertexShader* pVertexShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+	SetShader( VERTEX_SHADER, pVertexShader );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::HSSetShader( ID3D11HullShader* pHullShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+	SetShader( HULL_SHADER, pHullShader );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DSSetShader( ID3D11DomainShader* pDomainShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+	SetShader( DOMAIN_SHADER, pDomainShader );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::GSSetShader( ID3D11GeometryShader* pShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+	SetShader( GEOMETRY_SHADER, pShader );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::PSSetShader( ID3D11PixelShader* pPixelShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+	SetShader( PIXEL_SHADER, pPixelShader );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::CSSetShader( ID3D11ComputeShader* pComputeShader, ID3D11ClassInstance* const* ppClassInstances, UINT NumClassInstances )
+{
+	SetShader( COMPUTE_SHADER, pComputeShader );
+}
+//--------------------------------------------------------------------------------
+// Constant buffers
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::VSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+	SetConstantBuffers( VERTEX_SHADER, StartSlot, NumBuffers, ppConstantBuffers, nullptr, nullptr );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::HSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+	SetConstantBuffers( HULL_SHADER, StartSlot, NumBuffers, ppConstantBuffers, nullptr, nullptr );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+	SetConstantBuffers( DOMAIN_SHADER, StartSlot, NumBuffers, ppConstantBuffers, nullptr, nullptr );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::GSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+	SetConstantBuffers( GEOMETRY_SHADER, StartSlot, NumBuffers, ppConstantBuffers, nullptr, nullptr );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::PSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+	SetConstantBuffers( PIXEL_SHADER, StartSlot, NumBuffers, ppConstantBuffers, nullptr, nullptr );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::CSSetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers )
+{
+	SetConstantBuffers( COMPUTE_SHADER, StartSlot, NumBuffers, ppConstantBuffers, nullptr, nullptr );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::VSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+	SetConstantBuffers( VERTEX_SHADER, StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::HSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+	SetConstantBuffers( HULL_SHADER, StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+	SetConstantBuffers( DOMAIN_SHADER, StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::GSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+	SetConstantBuffers( GEOMETRY_SHADER, StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::PSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+	SetConstantBuffers( PIXEL_SHADER, StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::CSSetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants )
+{
+	SetConstantBuffers( COMPUTE_SHADER, StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+}
+//--------------------------------------------------------------------------------
+// Samplers
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::VSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+	SetSamplers( VERTEX_SHADER, StartSlot, NumSamplers, ppSamplers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::HSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+	SetSamplers( HULL_SHADER, StartSlot, NumSamplers, ppSamplers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+	SetSamplers( DOMAIN_SHADER, StartSlot, NumSamplers, ppSamplers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::GSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+	SetSamplers( GEOMETRY_SHADER, StartSlot, NumSamplers, ppSamplers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::PSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+	SetSamplers( PIXEL_SHADER, StartSlot, NumSamplers, ppSamplers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::CSSetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState* const* ppSamplers )
+{
+	SetSamplers( COMPUTE_SHADER, StartSlot, NumSamplers, ppSamplers );
+}
+//--------------------------------------------------------------------------------
+// Shader resources and unordered access views
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::VSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+	SetShaderResources( VERTEX_SHADER, StartSlot, NumViews, ppShaderResourceViews );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::HSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+	SetShaderResources( HULL_SHADER, StartSlot, NumViews, ppShaderResourceViews );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+	SetShaderResources( DOMAIN_SHADER, StartSlot, NumViews, ppShaderResourceViews );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::GSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+	SetShaderResources( GEOMETRY_SHADER, StartSlot, NumViews, ppShaderResourceViews );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::PSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+	SetShaderResources( PIXEL_SHADER, StartSlot, NumViews, ppShaderResourceViews );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::CSSetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView* const* ppShaderResourceViews )
+{
+	SetShaderResources( COMPUTE_SHADER, StartSlot, NumViews, ppShaderResourceViews );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::CSSetUnorderedAccessViews( UINT StartSlot, UINT NumUAVs, ID3D11UnorderedAccessView* const* ppUnorderedAccessViews, const UINT* pUAVInitialCounts )
+{
+	SetUnorderedAccessViews( COMPUTE_SHADER, StartSlot, NumUAVs, ppUnorderedAccessViews );
+}
+//--------------------------------------------------------------------------------
+// Input assembler
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::IASetInputLayout( ID3D11InputLayout* pInputLayout )
+{
+	SetState( RecordedCommandType::SetInputLayout, &m_pInputLayout, pInputLayout );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::IASetVertexBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer* const* ppVertexBuffers, const UINT* pStrides, const UINT* pOffsets )
+{
+	unsigned int redundant = 0;
+
+	for ( UINT i = 0; i < NumBuffers && StartSlot + i < D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT; i++ )
+	{
+		const UINT slot = StartSlot + i;
+
+		if ( m_VertexBuffers[slot] == ppVertexBuffers[i]
+			&& m_VertexStrides[slot] == pStrides[i]
+			&& m_VertexOffsets[slot] == pOffsets[i] )
+			redundant++;
+
+		m_VertexBuffers[slot] = ppVertexBuffers[i];
+		m_VertexStrides[slot] = pStrides[i];
+		m_VertexOffsets[slot] = pOffsets[i];
+	}
+
+	CountBind( NumBuffers, redundant );
+	Record( RecordedCommandType::SetVertexBuffers, 0, StartSlot, NumBuffers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::IASetIndexBuffer( ID3D11Buffer* pIndexBuffer, DXGI_FORMAT Format, UINT Offset )
+{
+	const bool redundant = m_pIndexBuffer == pIndexBuffer && m_IndexFormat == Format && m_uiIndexOffset == Offset;
+
+	m_pIndexBuffer = pIndexBuffer;
+	m_IndexFormat = Format;
+	m_uiIndexOffset = Offset;
+
+	CountBind( 1, redundant ? 1 : 0 );
+	Record( RecordedCommandType::SetIndexBuffer, 0, 0, 1, Format, Offset );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY Topology )
+{
+	CountBind( 1, m_Topology == Topology ? 1 : 0 );
+	m_Topology = Topology;
+
+	Record( RecordedCommandType::SetPrimitiveTopology, 0, 0, 1, Topology );
+}
+//--------------------------------------------------------------------------------
+// Rasterizer and output merger
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::RSSetState( ID3D11RasterizerState* pRasterizerState )
+{
+	SetState( RecordedCommandType::SetRasterizerState, &m_pRasterizerState, pRasterizerState );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::RSSetViewports( UINT NumViewports, const D3D11_VIEWPORT* pViewports )
+{
+	CountBind( NumViewports, 0 );
+	Record( RecordedCommandType::SetViewports, 0, 0, NumViewports );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::RSSetScissorRects( UINT NumRects, const D3D11_RECT* pRects )
+{
+	CountBind( NumRects, 0 );
+	Record( RecordedCommandType::SetScissorRects, 0, 0, NumRects );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::OMSetBlendState( ID3D11BlendState* pBlendState, const FLOAT BlendFactor[4], UINT SampleMask )
+{
+	SetState( RecordedCommandType::SetBlendState, &m_pBlendState, pBlendState );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::OMSetDepthStencilState( ID3D11DepthStencilState* pDepthStencilState, UINT StencilRef )
+{
+	const bool redundant = m_pDepthStencilState == pDepthStencilState && m_uiStencilRef == StencilRef;
+
+	m_pDepthStencilState = pDepthStencilState;
+	m_uiStencilRef = StencilRef;
+
+	CountBind( 1, redundant ? 1 : 0 );
+	Record( RecordedCommandType::SetDepthStencilState, 0, 0, 1, StencilRef );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::OMSetRenderTargets( UINT NumViews, ID3D11RenderTargetView* const* ppRenderTargetViews, ID3D11DepthStencilView* pDepthStencilView )
+{
+	CountBind( NumViews + 1, 0 );
+	Record( RecordedCommandType::SetRenderTargets, 0, 0, NumViews );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::OMSetRenderTargetsAndUnorderedAccessViews( UINT NumRTVs, ID3D11RenderTargetView* const* ppRenderTargetViews, ID3D11DepthStencilView* pDepthStencilView, UINT UAVStartSlot, UINT NumUAVs, ID3D11UnorderedAccessView* const* ppUnorderedAccessViews, const UINT* pUAVInitialCounts )
+{
+	if ( NumRTVs != D3D11_KEEP_RENDER_TARGETS_AND_DEPTH_STENCIL )
+		OMSetRenderTargets( NumRTVs, ppRenderTargetViews, pDepthStencilView );
+
+	if ( NumUAVs != D3D11_KEEP_UNORDERED_ACCESS_VIEWS )
+		SetUnorderedAccessViews( PIXEL_SHADER, UAVStartSlot, NumUAVs, ppUnorderedAccessViews );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::SOSetTargets( UINT NumBuffers, ID3D11Buffer* const* ppSOTargets, const UINT* pOffsets )
+{
+	CountBind( NumBuffers, 0 );
+	Record( RecordedCommandType::SetStreamOutputTargets, 0, 0, NumBuffers );
+}
+//--------------------------------------------------------------------------------
+// Resource access
+//--------------------------------------------------------------------------------
+HRESULT STDMETHODCALLTYPE RecordingDeviceContextDX11::Map( ID3D11Resource* pResource, UINT Subresource, D3D11_MAP MapType, UINT MapFlags, D3D11_MAPPED_SUBRESOURCE* pMappedResource )
+{
+	if ( pResource == nullptr || pMappedResource == nullptr )
+		return( E_INVALIDARG );
+
+	UINT rowPitch = 0;
+	UINT depthPitch = 0;
+	const UINT size = GetMappedSize( pResource, rowPitch, depthPitch );
+
+	std::vector<unsigned char>& memory = m_MappedMemory[pResource];
+
+	if ( memory.size() < size )
+		memory.resize( size );
+
+	pMappedResource->pData = memory.empty() ? nullptr : &memory[0];
+	pMappedResource->RowPitch = rowPitch;
+	pMappedResource->DepthPitch = depthPitch;
+
+	m_Statistics.maps++;
+	m_Statistics.mappedBytes += size;
+
+	Record( RecordedCommandType::Map, 0, Subresource, 1, MapType, size );
+
+	return( S_OK );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::Unmap( ID3D11Resource* pResource, UINT Subresource )
+{
+	Record( RecordedCommandType::Unmap, 0, Subresource, 1 );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::CopySubresourceRegion( ID3D11Resource* pDstResource, UINT DstSubresource, UINT DstX, UINT DstY, UINT DstZ, ID3D11Resource* pSrcResource, UINT SrcSubresource, const D3D11_BOX* pSrcBox )
+{
+	Record( RecordedCommandType::Copy, 0, DstSubresource, 1, SrcSubresource );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::CopySubresourceRegion1( ID3D11Resource* pDstResource, UINT DstSubresource, UINT DstX, UINT DstY, UINT DstZ, ID3D11Resource* pSrcResource, UINT SrcSubresource, const D3D11_BOX* pSrcBox, UINT CopyFlags )
+{
+	Record( RecordedCommandType::Copy, 0, DstSubresource, 1, SrcSubresource, CopyFlags );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::CopyResource( ID3D11Resource* pDstResource, ID3D11Resource* pSrcResource )
+{
+	Record( RecordedCommandType::Copy, 0, 0, 1 );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::CopyStructureCount( ID3D11Buffer* pDstBuffer, UINT DstAlignedByteOffset, ID3D11UnorderedAccessView* pSrcView )
+{
+	Record( RecordedCommandType::Copy, 0, DstAlignedByteOffset, 1 );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::UpdateSubresource( ID3D11Resource* pDstResource, UINT DstSubresource, const D3D11_BOX* pDstBox, const void* pSrcData, UINT SrcRowPitch, UINT SrcDepthPitch )
+{
+	Record( RecordedCommandType::Update, 0, DstSubresource, 1, SrcRowPitch, SrcDepthPitch );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::UpdateSubresource1( ID3D11Resource* pDstResource, UINT DstSubresource, const D3D11_BOX* pDstBox, const void* pSrcData, UINT SrcRowPitch, UINT SrcDepthPitch, UINT CopyFlags )
+{
+	Record( RecordedCommandType::Update, 0, DstSubresource, 1, SrcRowPitch, SrcDepthPitch );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::ResolveSubresource( ID3D11Resource* pDstResource, UINT DstSubresource, ID3D11Resource* pSrcResource, UINT SrcSubresource, DXGI_FORMAT Format )
+{
+	Record( RecordedCommandType::Copy, 0, DstSubresource, 1, SrcSubresource, Format );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::GenerateMips( ID3D11ShaderResourceView* pShaderResourceView )
+{
+	Record( RecordedCommandType::Other, 0, 0, 1 );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::SetResourceMinLOD( ID3D11Resource* pResource, FLOAT MinLOD )
+{
+	Record( RecordedCommandType::Other, 0, 0, 1 );
+}
+//--------------------------------------------------------------------------------
+FLOAT STDMETHODCALLTYPE RecordingDeviceContextDX11::GetResourceMinLOD( ID3D11Resource* pResource )
+{
+	return( 0.0f );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DiscardResource( ID3D11Resource* pResource )
+{
+	Record( RecordedCommandType::Other, 0, 0, 1 );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DiscardView( ID3D11View* pResourceView )
+{
+	Record( RecordedCommandType::Other, 0, 0, 1 );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DiscardView1( ID3D11View* pResourceView, const D3D11_RECT* pRects, UINT NumRects )
+{
+	Record( RecordedCommandType::Other, 0, 0, NumRects );
+}
+//--------------------------------------------------------------------------------
+// Clears
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::ClearRenderTargetView( ID3D11RenderTargetView* pRenderTargetView, const FLOAT ColorRGBA[4] )
+{
+	Record( RecordedCommandType::Clear, 0, 0, 1 );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::ClearUnorderedAccessViewUint( ID3D11UnorderedAccessView* pUnorderedAccessView, const UINT Values[4] )
+{
+	Record( RecordedCommandType::Clear, 0, 0, 1 );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::ClearUnorderedAccessViewFloat( ID3D11UnorderedAccessView* pUnorderedAccessView, const FLOAT Values[4] )
+{
+	Record( RecordedCommandType::Clear, 0, 0, 1 );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::ClearDepthStencilView( ID3D11DepthStencilView* pDepthStencilView, UINT ClearFlags, FLOAT Depth, UINT8 Stencil )
+{
+	Record( RecordedCommandType::Clear, 0, 0, 1, ClearFlags );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::ClearView( ID3D11View* pView, const FLOAT Color[4], const D3D11_RECT* pRect, UINT NumRects )
+{
+	Record( RecordedCommandType::Clear, 0, 0, NumRects );
+}
+//--------------------------------------------------------------------------------
+// Draws and dispatches
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::Draw( UINT VertexCount, UINT StartVertexLocation )
+{
+	m_Statistics.draws++;
+	Record( RecordedCommandType::Draw, 0, StartVertexLocation, 1, VertexCount );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DrawIndexed( UINT IndexCount, UINT StartIndexLocation, INT BaseVertexLocation )
+{
+	m_Statistics.draws++;
+	Record( RecordedCommandType::DrawIndexed, 0, StartIndexLocation, 1, IndexCount, static_cast<unsigned int>( BaseVertexLocation ) );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DrawInstanced( UINT VertexCountPerInstance, UINT InstanceCount, UINT StartVertexLocation, UINT StartInstanceLocation )
+{
+	m_Statistics.draws++;
+	Record( RecordedCommandType::DrawInstanced, 0, StartVertexLocation, 1, VertexCountPerInstance, InstanceCount );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DrawIndexedInstanced( UINT IndexCountPerInstance, UINT InstanceCount, UINT StartIndexLocation, INT BaseVertexLocation, UINT StartInstanceLocation )
+{
+	m_Statistics.draws++;
+	Record( RecordedCommandType::DrawIndexedInstanced, 0, StartIndexLocation, 1, IndexCountPerInstance, InstanceCount );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DrawAuto()
+{
+	m_Statistics.draws++;
+	Record( RecordedCommandType::Draw, 0, 0, 1 );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DrawIndexedInstancedIndirect( ID3D11Buffer* pBufferForArgs, UINT AlignedByteOffsetForArgs )
+{
+	m_Statistics.draws++;
+	Record( RecordedCommandType::DrawIndirect, 0, AlignedByteOffsetForArgs, 1 );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DrawInstancedIndirect( ID3D11Buffer* pBufferForArgs, UINT AlignedByteOffsetForArgs )
+{
+	m_Statistics.draws++;
+	Record( RecordedCommandType::DrawIndirect, 0, AlignedByteOffsetForArgs, 1 );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::Dispatch( UINT ThreadGroupCountX, UINT ThreadGroupCountY, UINT ThreadGroupCountZ )
+{
+	m_Statistics.dispatches++;
+	Record( RecordedCommandType::Dispatch, 0, ThreadGroupCountX, 1, ThreadGroupCountY, ThreadGroupCountZ );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DispatchIndirect( ID3D11Buffer* pBufferForArgs, UINT AlignedByteOffsetForArgs )
+{
+	m_Statistics.dispatches++;
+	Record( RecordedCommandType::DispatchIndirect, 0, AlignedByteOffsetForArgs, 1 );
+}
+//--------------------------------------------------------------------------------
+// Queries and predication
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::Begin( ID3D11Asynchronous* pAsync )
+{
+	Record( RecordedCommandType::Query, 0, 0, 1 );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::End( ID3D11Asynchronous* pAsync )
+{
+	Record( RecordedCommandType::Query, 0, 1, 1 );
+}
+//--------------------------------------------------------------------------------
+HRESULT STDMETHODCALLTYPE RecordingDeviceContextDX11::GetData( ID3D11Asynchronous* pAsync, void* pData, UINT DataSize, UINT GetDataFlags )
+{
+	// Nothing is ever executed, so the results are reported as zeros right away.
+
+	if ( pData != nullptr && DataSize > 0 )
+		memset( pData, 0, DataSize );
+
+	return( S_OK );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::SetPredication( ID3D11Predicate* pPredicate, BOOL PredicateValue )
+{
+	Record( RecordedCommandType::Query, 0, 2, 1, PredicateValue );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::GetPredication( ID3D11Predicate** ppPredicate, BOOL* pPredicateValue )
+{
+	if ( ppPredicate != nullptr ) *ppPredicate = nullptr;
+	if ( pPredicateValue != nullptr ) *pPredicateValue = FALSE;
+}
+//--------------------------------------------------------------------------------
+// Context management
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::ExecuteCommandList( ID3D11CommandList* pCommandList, BOOL RestoreContextState )
+{
+	Record( RecordedCommandType::Other, 0, 0, 1, RestoreContextState );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::ClearState()
+{
+	memset( m_Stages, 0, sizeof( m_Stages ) );
+	m_pInputLayout = nullptr;
+	memset( m_VertexBuffers, 0, sizeof( m_VertexBuffers ) );
+	memset( m_VertexStrides, 0, sizeof( m_VertexStrides ) );
+	memset( m_VertexOffsets, 0, sizeof( m_VertexOffsets ) );
+	m_pIndexBuffer = nullptr;
+	m_IndexFormat = DXGI_FORMAT_UNKNOWN;
+	m_uiIndexOffset = 0;
+	m_Topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	m_pRasterizerState = nullptr;
+	m_pBlendState = nullptr;
+	m_pDepthStencilState = nullptr;
+	m_uiStencilRef = 0;
+
+	Record( RecordedCommandType::Other, 0, 0, 1 );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::Flush()
+{
+	Record( RecordedCommandType::Other, 0, 0, 1 );
+}
+//--------------------------------------------------------------------------------
+D3D11_DEVICE_CONTEXT_TYPE STDMETHODCALLTYPE RecordingDeviceContextDX11::GetType()
+{
+	return( D3D11_DEVICE_CONTEXT_IMMEDIATE );
+}
+//--------------------------------------------------------------------------------
+UINT STDMETHODCALLTYPE RecordingDeviceContextDX11::GetContextFlags()
+{
+	return( 0 );
+}
+//--------------------------------------------------------------------------------
+HRESULT STDMETHODCALLTYPE RecordingDeviceContextDX11::FinishCommandList( BOOL RestoreDeferredContextState, ID3D11CommandList** ppCommandList )
+{
+	if ( ppCommandList != nullptr )
+		*ppCommandList = nullptr;
+
+	return( E_NOTIMPL );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::SwapDeviceContextState( ID3DDeviceContextState* pState, ID3DDeviceContextState** ppPreviousState )
+{
+	if ( ppPreviousState != nullptr )
+		*ppPreviousState = nullptr;
+}
+//--------------------------------------------------------------------------------
+// State queries.  The recorder doesn't report its bound state, so these all
+// return empty values.
+//--------------------------------------------------------------------------------
+template <class T>
+static void ClearOutputs( T** ppOutputs, UINT count )
+{
+	if ( ppOutputs != nullptr ) {
+		for ( UINT i = 0; i < count; i++ )
+			ppOutputs[i] = nullptr;
+	}
+}
+//--------------------------------------------------------------------------------
+template <class T>
+static void ClearShaderOutputs( T** ppShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances )
+{
+	if ( ppShader != nullptr ) *ppShader = nullptr;
+
+	if ( pNumClassInstances != nullptr ) {
+		ClearOutputs( ppClassInstances, *pNumClassInstances );
+		*pNumClassInstances = 0;
+	}
+}
+//--------------------------------------------------------------------------------
+static void ClearConstantBufferOutputs( UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants )
+{
+	ClearOutputs( ppConstantBuffers, NumBuffers );
+
+	for ( UINT i = 0; i < NumBuffers; i++ ) {
+		if ( pFirstConstant != nullptr ) pFirstConstant[i] = 0;
+		if ( pNumConstants != nullptr ) pNumConstants[i] = 0;
+	}
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::VSGetShader( ID3D11VertexShader** ppVertexShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances )
+{
+	ClearShaderOutputs( ppVertexShader, ppClassInstances, pNumClassInstances );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::HSGetShader( ID3D11HullShader** ppHullShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances )
+{
+	ClearShaderOutputs( ppHullShader, ppClassInstances, pNumClassInstances );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DSGetShader( ID3D11DomainShader** ppDomainShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances )
+{
+	ClearShaderOutputs( ppDomainShader, ppClassInstances, pNumClassInstances );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::GSGetShader( ID3D11GeometryShader** ppGeometryShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances )
+{
+	ClearShaderOutputs( ppGeometryShader, ppClassInstances, pNumClassInstances );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::PSGetShader( ID3D11PixelShader** ppPixelShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances )
+{
+	ClearShaderOutputs( ppPixelShader, ppClassInstances, pNumClassInstances );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::CSGetShader( ID3D11ComputeShader** ppComputeShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances )
+{
+	ClearShaderOutputs( ppComputeShader, ppClassInstances, pNumClassInstances );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::VSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers )
+{
+	ClearOutputs( ppConstantBuffers, NumBuffers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::HSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers )
+{
+	ClearOutputs( ppConstantBuffers, NumBuffers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers )
+{
+	ClearOutputs( ppConstantBuffers, NumBuffers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::GSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers )
+{
+	ClearOutputs( ppConstantBuffers, NumBuffers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::PSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers )
+{
+	ClearOutputs( ppConstantBuffers, NumBuffers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::CSGetConstantBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers )
+{
+	ClearOutputs( ppConstantBuffers, NumBuffers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::VSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants )
+{
+	ClearConstantBufferOutputs( NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::HSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants )
+{
+	ClearConstantBufferOutputs( NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants )
+{
+	ClearConstantBufferOutputs( NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::GSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants )
+{
+	ClearConstantBufferOutputs( NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::PSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants )
+{
+	ClearConstantBufferOutputs( NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::CSGetConstantBuffers1( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppConstantBuffers, UINT* pFirstConstant, UINT* pNumConstants )
+{
+	ClearConstantBufferOutputs( NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::VSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers )
+{
+	ClearOutputs( ppSamplers, NumSamplers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::HSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers )
+{
+	ClearOutputs( ppSamplers, NumSamplers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers )
+{
+	ClearOutputs( ppSamplers, NumSamplers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::GSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers )
+{
+	ClearOutputs( ppSamplers, NumSamplers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::PSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers )
+{
+	ClearOutputs( ppSamplers, NumSamplers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::CSGetSamplers( UINT StartSlot, UINT NumSamplers, ID3D11SamplerState** ppSamplers )
+{
+	ClearOutputs( ppSamplers, NumSamplers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::VSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews )
+{
+	ClearOutputs( ppShaderResourceViews, NumViews );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::HSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews )
+{
+	ClearOutputs( ppShaderResourceViews, NumViews );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::DSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews )
+{
+	ClearOutputs( ppShaderResourceViews, NumViews );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::GSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews )
+{
+	ClearOutputs( ppShaderResourceViews, NumViews );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::PSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews )
+{
+	ClearOutputs( ppShaderResourceViews, NumViews );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::CSGetShaderResources( UINT StartSlot, UINT NumViews, ID3D11ShaderResourceView** ppShaderResourceViews )
+{
+	ClearOutputs( ppShaderResourceViews, NumViews );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::CSGetUnorderedAccessViews( UINT StartSlot, UINT NumUAVs, ID3D11UnorderedAccessView** ppUnorderedAccessViews )
+{
+	ClearOutputs( ppUnorderedAccessViews, NumUAVs );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::IAGetInputLayout( ID3D11InputLayout** ppInputLayout )
+{
+	if ( ppInputLayout != nullptr ) *ppInputLayout = nullptr;
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::IAGetVertexBuffers( UINT StartSlot, UINT NumBuffers, ID3D11Buffer** ppVertexBuffers, UINT* pStrides, UINT* pOffsets )
+{
+	ClearConstantBufferOutputs( NumBuffers, ppVertexBuffers, pStrides, pOffsets );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::IAGetIndexBuffer( ID3D11Buffer** pIndexBuffer, DXGI_FORMAT* Format, UINT* Offset )
+{
+	if ( pIndexBuffer != nullptr ) *pIndexBuffer = nullptr;
+	if ( Format != nullptr ) *Format = DXGI_FORMAT_UNKNOWN;
+	if ( Offset != nullptr ) *Offset = 0;
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::IAGetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY* pTopology )
+{
+	if ( pTopology != nullptr ) *pTopology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::OMGetRenderTargets( UINT NumViews, ID3D11RenderTargetView** ppRenderTargetViews, ID3D11DepthStencilView** ppDepthStencilView )
+{
+	ClearOutputs( ppRenderTargetViews, NumViews );
+	if ( ppDepthStencilView != nullptr ) *ppDepthStencilView = nullptr;
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::OMGetRenderTargetsAndUnorderedAccessViews( UINT NumRTVs, ID3D11RenderTargetView** ppRenderTargetViews, ID3D11DepthStencilView** ppDepthStencilView, UINT UAVStartSlot, UINT NumUAVs, ID3D11UnorderedAccessView** ppUnorderedAccessViews )
+{
+	OMGetRenderTargets( NumRTVs, ppRenderTargetViews, ppDepthStencilView );
+	ClearOutputs( ppUnorderedAccessViews, NumUAVs );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::OMGetBlendState( ID3D11BlendState** ppBlendState, FLOAT BlendFactor[4], UINT* pSampleMask )
+{
+	if ( ppBlendState != nullptr ) *ppBlendState = nullptr;
+
+	if ( BlendFactor != nullptr ) {
+		for ( int i = 0; i < 4; i++ )
+			BlendFactor[i] = 1.0f;
+	}
+
+	if ( pSampleMask != nullptr ) *pSampleMask = 0xffffffff;
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::OMGetDepthStencilState( ID3D11DepthStencilState** ppDepthStencilState, UINT* pStencilRef )
+{
+	if ( ppDepthStencilState != nullptr ) *ppDepthStencilState = nullptr;
+	if ( pStencilRef != nullptr ) *pStencilRef = 0;
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::SOGetTargets( UINT NumBuffers, ID3D11Buffer** ppSOTargets )
+{
+	ClearOutputs( ppSOTargets, NumBuffers );
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::RSGetState( ID3D11RasterizerState** ppRasterizerState )
+{
+	if ( ppRasterizerState != nullptr ) *ppRasterizerState = nullptr;
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::RSGetViewports( UINT* pNumViewports, D3D11_VIEWPORT* pViewports )
+{
+	if ( pNumViewports != nullptr ) *pNumViewports = 0;
+}
+//--------------------------------------------------------------------------------
+void STDMETHODCALLTYPE RecordingDeviceContextDX11::RSGetScissorRects( UINT* pNumRects, D3D11_RECT* pRects )
+{
+	if ( pNumRects != nullptr ) *pNumRects = 0;
+}
+//--------------------------------------------------------------------------------
@@ -160,6 +160,9 @@ bool RenderApplication::ConfigureRenderingSetup()
 //--------------------------------------------------------------------------------
 void RenderApplication::ShutdownRenderingEngineComponents()
 {
+	// Streaming requests may still be using the device.
+	Streamer.CancelAll();
+
 	m_pRenderer11->Shutdown();
 	SAFE_DELETE( m_pRenderer11 );
 
@@ -11,6 +11,7 @@
 //--------------------------------------------------------------------------------
 #include "PCH.h"
 #include "RenderParameterDX11.h"
+#include "ParameterNameTable.h"
 //#include "ConstantBufferParameterDX11.h"
 //#include "MatrixParameterDX11.h"
 //#include "MatrixArrayParameterDX11.h"
@@ -23,6 +24,8 @@ using namespace Glyph3;
 //--------------------------------------------------------------------------------
 RenderParameterDX11::RenderParameterDX11()
 {
+	m_uiNameID = ParameterNameTable::InvalidID;
+
 	for ( int i = 0; i < NUM_THREADS+1; i++ ) {
 		m_auiValueID[i] = 0;
 	}
@@ -31,6 +34,7 @@ RenderParameterDX11::RenderParameterDX11()
 RenderParameterDX11::RenderParameterDX11( RenderParameterDX11& copy )
 {
 	m_sParameterName = copy.m_sParameterName;
+	m_uiNameID = copy.m_uiNameID;
 }
 //--------------------------------------------------------------------------------
 RenderParameterDX11::~RenderParameterDX11()
@@ -45,6 +49,12 @@ std::wstring& RenderParameterDX11::GetName()
 void RenderParameterDX11::SetName( const std::wstring& name )
 {
 	m_sParameterName = name;
+	m_uiNameID = ParameterNameTable::Get()->Intern( name );
+}
+//--------------------------------------------------------------------------------
+unsigned int RenderParameterDX11::GetNameID()
+{
+	return( m_uiNameID );
 }
 //--------------------------------------------------------------------------------
 void RenderParameterDX11::InitializeParameterData( void* pData )
@@ -0,0 +1,568 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "RenderQueue.h"
+#include "Entity3D.h"
+#include "Node3D.h"
+#include "RenderEffectDX11.h"
+#include "MaterialDX11.h"
+#include "Frustum3f.h"
+#include "TGrowableVertexBufferDX11.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+static const unsigned int ProgramBits = 14;
+static const unsigned int StateBits = 12;
+static const unsigned int MaterialBits = 12;
+static const unsigned int DepthBits = 24;
+static const unsigned int CullBatchSize = 64;
+static const unsigned int MinimumInstanceCount = 2;
+//--------------------------------------------------------------------------------
+static unsigned int PassRank( int pass )
+{
+	switch ( pass )
+	{
+	case Renderable::BACKGROUND:	return( 0 );
+	case Renderable::GEOMETRY:		return( 1 );
+	case Renderable::SKY:			return( 2 );
+	default:						return( 3 );
+	}
+}
+//--------------------------------------------------------------------------------
+static unsigned int QuantizeDepth( float depth )
+{
+	// The bit pattern of a non-negative float increases with its value, so the
+	// top bits of the pattern give an ordering that doesn't need a depth range.
+
+	if ( !( depth > 0.0f ) )
+		return( 0 );
+
+	unsigned int bits;
+	memcpy( &bits, &depth, sizeof( bits ) );
+
+	return( bits >> ( 31 - DepthBits ) );
+}
+//--------------------------------------------------------------------------------
+static unsigned int LimitID( unsigned int id, unsigned int bits )
+{
+	const unsigned int limit = ( 1u << bits ) - 1;
+	return( id < limit ? id : limit );
+}
+//--------------------------------------------------------------------------------
+bool RenderQueue::ProgramKey::operator<( const ProgramKey& other ) const
+{
+	return( std::lexicographical_compare( shaders, shaders + 6, other.shaders, other.shaders + 6 ) );
+}
+//--------------------------------------------------------------------------------
+bool RenderQueue::StateKey::operator<( const StateKey& other ) const
+{
+	if ( blend != other.blend )
+		return( blend < other.blend );
+
+	if ( depthStencil != other.depthStencil )
+		return( depthStencil < other.depthStencil );
+
+	return( rasterizer < other.rasterizer );
+}
+//--------------------------------------------------------------------------------
+RenderQueue::RenderQueue() :
+	m_pInstanceBuffer( nullptr )
+{
+	memset( &m_Statistics, 0, sizeof( m_Statistics ) );
+}
+//--------------------------------------------------------------------------------
+RenderQueue::~RenderQueue()
+{
+	SAFE_DELETE( m_pInstanceBuffer );
+}
+//--------------------------------------------------------------------------------
+void RenderQueue::Clear()
+{
+	m_Items.clear();
+	m_Batches.clear();
+	m_Programs.clear();
+	m_States.clear();
+	m_Materials.clear();
+
+	memset( &m_Statistics, 0, sizeof( m_Statistics ) );
+}
+//--------------------------------------------------------------------------------
+unsigned int RenderQueue::GetProgramID( RenderEffectDX11* pEffect )
+{
+	ProgramKey key;
+	key.shaders[0] = pEffect->GetVertexShader();
+	key.shaders[1] = pEffect->GetHullShader();
+	key.shaders[2] = pEffect->GetDomainShader();
+	key.shaders[3] = pEffect->GetGeometryShader();
+	key.shaders[4] = pEffect->GetPixelShader();
+	key.shaders[5] = pEffect->GetComputeShader();
+
+	auto it = m_Programs.find( key );
+
+	if ( it != m_Programs.end() )
+		return( it->second );
+
+	const unsigned int id = static_cast<unsigned int>( m_Programs.size() );
+	m_Programs[key] = id;
+
+	return( id );
+}
+//--------------------------------------------------------------------------------
+unsigned int RenderQueue::GetStateID( RenderEffectDX11* pEffect )
+{
+	StateKey key;
+	key.blend = pEffect->m_iBlendState;
+	key.depthStencil = pEffect->m_iDepthStencilState;
+	key.rasterizer = pEffect->m_iRasterizerState;
+
+	auto it = m_States.find( key );
+
+	if ( it != m_States.end() )
+		return( it->second );
+
+	const unsigned int id = static_cast<unsigned int>( m_States.size() );
+	m_States[key] = id;
+
+	return( id );
+}
+//--------------------------------------------------------------------------------
+unsigned int RenderQueue::GetMaterialID( MaterialDX11* pMaterial )
+{
+	auto it = m_Materials.find( pMaterial );
+
+	if ( it != m_Materials.end() )
+		return( it->second );
+
+	const unsigned int id = static_cast<unsigned int>( m_Materials.size() );
+	m_Materials[pMaterial] = id;
+
+	return( id );
+}
+//--------------------------------------------------------------------------------
+unsigned long long RenderQueue::MakeKey( int pass, unsigned int program, unsigned int state,
+	unsigned int material, float depth )
+{
+	const unsigned long long rank = PassRank( pass );
+	unsigned long long depthBits = QuantizeDepth( depth );
+
+	unsigned long long groups = LimitID( program, ProgramBits );
+	groups = ( groups << StateBits ) | LimitID( state, StateBits );
+	groups = ( groups << MaterialBits ) | LimitID( material, MaterialBits );
+
+	// Alpha draws are ordered by depth first, from the farthest to the nearest,
+	// while all other draws are grouped by their state first.
+
+	if ( pass == Renderable::ALPHA )
+	{
+		depthBits = ( ( 1ull << DepthBits ) - 1 ) - depthBits;
+		return( ( rank << 62 ) | ( depthBits << 38 ) | groups );
+	}
+
+	return( ( rank << 62 ) | ( groups << DepthBits ) | depthBits );
+}
+//--------------------------------------------------------------------------------
+bool RenderQueue::IsDrawable( Entity3D* pEntity, VIEWTYPE view ) const
+{
+	const Renderable& visual = pEntity->Visual;
+
+	if ( visual.Executor == nullptr || visual.Material == nullptr )
+		return( false );
+
+	const MaterialParams& params = visual.Material->Params[view];
+
+	return( params.bRender && params.pEffect != nullptr );
+}
+//--------------------------------------------------------------------------------
+void RenderQueue::Add( Entity3D* pEntity, VIEWTYPE view, const Matrix4f& viewMatrix )
+{
+	if ( !IsDrawable( pEntity, view ) )
+		return;
+
+	Renderable& visual = pEntity->Visual;
+	MaterialParams& params = visual.Material->Params[view];
+
+	Vector3f position = pEntity->Transform.WorldMatrix().GetTranslation();
+	viewMatrix.TransformPoints( &position, &position, 1 );
+
+	Item item;
+	item.pEntity = pEntity;
+	item.program = GetProgramID( params.pEffect );
+	item.state = GetStateID( params.pEffect );
+	item.material = GetMaterialID( visual.Material.get() );
+	item.key = MakeKey( visual.iPass, item.program, item.state, item.material, position.z );
+
+	m_Items.push_back( item );
+	m_Statistics.drawn++;
+}
+//--------------------------------------------------------------------------------
+void RenderQueue::Add( Node3D* pNode, VIEWTYPE view, const Matrix4f& viewMatrix, const Frustum3f* pFrustum )
+{
+	if ( pNode == nullptr )
+		return;
+
+	// The subtree bounds decide whether the children need to be tested at all.
+	// Once a node is completely inside, so is everything below it.
+
+	Sphere3f bounds;
+
+	if ( pFrustum && pNode->GetSubtreeBounds( bounds ) )
+	{
+		m_Statistics.spheresTested++;
+
+		if ( !pFrustum->Intersects( bounds ) ) {
+			m_Statistics.culled += pNode->GetSubtreeEntityCount();
+			m_Statistics.nodesCulled++;
+			return;
+		}
+
+		if ( pFrustum->Envelops( bounds ) )
+			pFrustum = nullptr;
+	}
+
+	if ( pFrustum == nullptr )
+	{
+		for ( auto pEntity : pNode->Leafs() )
+			if ( pEntity ) Add( pEntity, view, viewMatrix );
+	}
+	else
+	{
+		// Gather the bounds of the drawable entities, so that they can be tested
+		// together.  Entities without any shapes are added right away.
+
+		m_Candidates.clear();
+		m_Spheres.clear();
+
+		for ( auto pEntity : pNode->Leafs() )
+		{
+			if ( pEntity == nullptr || !IsDrawable( pEntity, view ) )
+				continue;
+
+			if ( pEntity->Shape.GetBoundingSphere( pEntity->Transform.WorldMatrix(), bounds ) ) {
+				m_Candidates.push_back( pEntity );
+				m_Spheres.push_back( bounds );
+			}
+			else {
+				Add( pEntity, view, viewMatrix );
+			}
+		}
+
+		const unsigned int count = static_cast<unsigned int>( m_Candidates.size() );
+		m_Statistics.spheresTested += count;
+
+		bool results[CullBatchSize];
+
+		for ( unsigned int begin = 0; begin < count; begin += CullBatchSize )
+		{
+			const unsigned int batch = std::min( count - begin, CullBatchSize );
+			pFrustum->Intersects( &m_Spheres[begin], batch, results );
+
+			for ( unsigned int i = 0; i < batch; i++ )
+			{
+				if ( results[i] )
+					Add( m_Candidates[begin + i], view, viewMatrix );
+				else
+					m_Statistics.culled++;
+			}
+		}
+	}
+
+	for ( auto pChild : pNode->Nodes() )
+		Add( pChild, view, viewMatrix, pFrustum );
+}
+//--------------------------------------------------------------------------------
+void RenderQueue::Sort()
+{
+	const unsigned int count = static_cast<unsigned int>( m_Items.size() );
+
+	if ( count < 2 )
+		return;
+
+	// Find the bytes that differ between keys, since only those need a pass.
+
+	unsigned long long differing = 0;
+
+	for ( unsigned int i = 1; i < count; i++ )
+		differing |= m_Items[i].key ^ m_Items[0].key;
+
+	m_Scratch.resize( count );
+
+	for ( unsigned int shift = 0; shift < 64; shift += 8 )
+	{
+		if ( ( ( differing >> shift ) & 0xff ) == 0 )
+			continue;
+
+		unsigned int offsets[256] = { 0 };
+
+		for ( auto& item : m_Items )
+			offsets[( item.key >> shift ) & 0xff]++;
+
+		unsigned int total = 0;
+
+		for ( unsigned int i = 0; i < 256; i++ ) {
+			const unsigned int bucket = offsets[i];
+			offsets[i] = total;
+			total += bucket;
+		}
+
+		// Each pass is stable, so equal keys keep the order they were added in.
+
+		for ( auto& item : m_Items )
+			m_Scratch[offsets[( item.key >> shift ) & 0xff]++] = item;
+
+		m_Items.swap( m_Scratch );
+	}
+}
+//--------------------------------------------------------------------------------
+bool RenderQueue::IsInstanceable( const Item& item, VIEWTYPE view )
+{
+	Entity3D* pEntity = item.pEntity;
+	RenderEffectDX11* pEffect = pEntity->Visual.Material->Params[view].pEffect;
+	RenderEffectDX11* pInstancedEffect = pEntity->Visual.Material->Params[view].pInstancedEffect;
+
+	if ( pInstancedEffect == nullptr )
+		return( false );
+
+	// The draws are grouped by the program and states of the regular effect,
+	// but drawn with the instanced one.  Apart from its vertex shader the 
+	// variant has to match the effect, which it no longer does if the effect's
+	// shaders were replaced after the variant was generated.
+
+	return( pInstancedEffect->GetHullShader() == pEffect->GetHullShader()
+		&& pInstancedEffect->GetDomainShader() == pEffect->GetDomainShader()
+		&& pInstancedEffect->GetGeometryShader() == pEffect->GetGeometryShader()
+		&& pInstancedEffect->GetPixelShader() == pEffect->GetPixelShader()
+		&& pInstancedEffect->GetComputeShader() == pEffect->GetComputeShader()
+		&& GetStateID( pInstancedEffect ) == item.state
+		&& pEntity->Visual.Executor->SupportsInstancing()
+		&& pEntity->Parameters.GetRenderParameterCount() == 0 );
+}
+//--------------------------------------------------------------------------------
+bool RenderQueue::IsSameGroup( const Item& a, const Item& b ) const
+{
+	return( ( a.key >> 62 ) == ( b.key >> 62 )
+		&& a.program == b.program
+		&& a.state == b.state
+		&& a.material == b.material );
+}
+//--------------------------------------------------------------------------------
+void RenderQueue::GroupByExecutor( unsigned int begin, unsigned int end )
+{
+	// Number the executors in the order they first appear, and then move the
+	// draws into that order with a counting sort, which keeps the draws of each
+	// executor in their front to back order.
+
+	m_Executors.clear();
+	m_Ranks.resize( end - begin );
+
+	for ( unsigned int i = begin; i < end; i++ )
+	{
+		PipelineExecutorDX11* pExecutor = m_Items[i].pEntity->Visual.Executor.get();
+		auto it = m_Executors.insert( std::make_pair( pExecutor, static_cast<unsigned int>( m_Executors.size() ) ) ).first;
+		m_Ranks[i - begin] = it->second;
+	}
+
+	const unsigned int groups = static_cast<unsigned int>( m_Executors.size() );
+
+	if ( groups == 1 || groups == end - begin )
+		return;
+
+	std::vector<unsigned int> offsets( groups + 1, 0 );
+
+	for ( auto rank : m_Ranks )
+		offsets[rank + 1]++;
+
+	for ( unsigned int g = 0; g < groups; g++ )
+		offsets[g + 1] += offsets[g];
+
+	m_Scratch.resize( end - begin );
+
+	for ( unsigned int i = begin; i < end; i++ )
+		m_Scratch[offsets[m_Ranks[i - begin]]++] = m_Items[i];
+
+	std::copy( m_Scratch.begin(), m_Scratch.begin() + ( end - begin ), m_Items.begin() + begin );
+}
+//--------------------------------------------------------------------------------
+void RenderQueue::BuildBatches( VIEWTYPE view )
+{
+	m_Batches.clear();
+
+	const unsigned int count = static_cast<unsigned int>( m_Items.size() );
+	const unsigned long long alphaRank = PassRank( Renderable::ALPHA );
+
+	unsigned int begin = 0;
+
+	while ( begin < count )
+	{
+		unsigned int end = begin + 1;
+
+		while ( end < count && IsSameGroup( m_Items[begin], m_Items[end] ) )
+			end++;
+
+		if ( ( m_Items[begin].key >> 62 ) != alphaRank )
+			GroupByExecutor( begin, end );
+
+		// Split the group into instanced batches of one executor, with a single
+		// draw for anything that can't be instanced.
+
+		for ( unsigned int i = begin; i < end; )
+		{
+			unsigned int next = i + 1;
+
+			if ( IsInstanceable( m_Items[i], view ) )
+			{
+				PipelineExecutorDX11* pExecutor = m_Items[i].pEntity->Visual.Executor.get();
+
+				while ( next < end
+					&& m_Items[next].pEntity->Visual.Executor.get() == pExecutor
+					&& IsInstanceable( m_Items[next], view ) )
+					next++;
+
+				if ( next - i < MinimumInstanceCount )
+					next = i + 1;
+			}
+
+			Batch batch;
+			batch.first = i;
+			batch.count = next - i;
+			batch.bInstanced = ( batch.count >= MinimumInstanceCount );
+			m_Batches.push_back( batch );
+
+			i = next;
+		}
+
+		begin = end;
+	}
+}
+//--------------------------------------------------------------------------------
+void RenderQueue::Render( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view )
+{
+	BuildBatches( view );
+
+	// The world matrices of every instanced batch are written into the instance
+	// buffer together, so that it only has to be uploaded once.
+
+	unsigned int instances = 0;
+
+	for ( auto& batch : m_Batches )
+		if ( batch.bInstanced ) instances += batch.count;
+
+	if ( instances > 0 )
+	{
+		if ( m_pInstanceBuffer == nullptr )
+			m_pInstanceBuffer = new TGrowableVertexBufferDX11<Matrix4f>();
+
+		m_pInstanceBuffer->ResetData();
+
+		if ( m_pInstanceBuffer->GetMaxElementCount() <= instances )
+			m_pInstanceBuffer->SetMaxElementCount( instances + 1 );
+
+		for ( auto& batch : m_Batches )
+		{
+			if ( !batch.bInstanced )
+				continue;
+
+			for ( unsigned int i = batch.first; i < batch.first + batch.count; i++ )
+				m_pInstanceBuffer->AddElement( m_Items[i].pEntity->Transform.WorldMatrix() );
+		}
+
+		m_pInstanceBuffer->UploadData( pPipelineManager );
+	}
+
+	unsigned int start = 0;
+
+	for ( auto& batch : m_Batches )
+	{
+		Entity3D* pEntity = m_Items[batch.first].pEntity;
+
+		if ( !batch.bInstanced ) {
+			pEntity->Render( pPipelineManager, pParamManager, view );
+			continue;
+		}
+
+		// This follows Entity3D::Render, except that the world matrix of each
+		// instance comes from the instance buffer.  The first entity's matrix is
+		// still bound for any shader that reads the regular world matrix.
+
+		Renderable& visual = pEntity->Visual;
+
+		visual.Material->SetRenderParams( pParamManager, view );
+		pParamManager->SetWorldMatrixParameter( &pEntity->Transform.WorldMatrix() );
+
+		visual.Material->Params[view].pInstancedEffect->ConfigurePipeline( pPipelineManager, pParamManager );
+		pPipelineManager->ApplyPipelineResources();
+
+		visual.Executor->ExecuteInstanced( pPipelineManager, pParamManager,
+			m_pInstanceBuffer->GetBuffer()->m_iResource, start, batch.count );
+
+		start += batch.count;
+	}
+}
+//--------------------------------------------------------------------------------
+unsigned int RenderQueue::GetBatchCount() const
+{
+	return( static_cast<unsigned int>( m_Batches.size() ) );
+}
+//--------------------------------------------------------------------------------
+const RenderQueue::Batch& RenderQueue::GetBatch( unsigned int index ) const
+{
+	return( m_Batches[index] );
+}
+//--------------------------------------------------------------------------------
+unsigned int RenderQueue::GetCount() const
+{
+	return( static_cast<unsigned int>( m_Items.size() ) );
+}
+//--------------------------------------------------------------------------------
+Entity3D* RenderQueue::GetEntity( unsigned int index ) const
+{
+	return( m_Items[index].pEntity );
+}
+//--------------------------------------------------------------------------------
+unsigned long long RenderQueue::GetKey( unsigned int index ) const
+{
+	return( m_Items[index].key );
+}
+//--------------------------------------------------------------------------------
+const CullStatistics& RenderQueue::GetStatistics() const
+{
+	return( m_Statistics );
+}
+//--------------------------------------------------------------------------------
+unsigned int RenderQueue::GetStateChangeCount() const
+{
+	// The first draw counts as a change of each, since it has to bind all of
+	// its state from scratch.
+
+	unsigned int changes = 0;
+
+	for ( unsigned int i = 0; i < m_Items.size(); i++ )
+	{
+		const Item& item = m_Items[i];
+
+		if ( i == 0 ) {
+			changes += 3;
+			continue;
+		}
+
+		const Item& previous = m_Items[i - 1];
+
+		if ( item.program != previous.program )
+			changes++;
+		if ( item.state != previous.state )
+			changes++;
+		if ( item.material != previous.material )
+			changes++;
+	}
+
+	return( changes );
+}
+//--------------------------------------------------------------------------------
@@ -17,6 +17,7 @@
 #include "VertexBufferDX11.h"
 #include "IndexBufferDX11.h"
 #include "ConstantBufferDX11.h"
+#include "ConstantBufferRingDX11.h"
 #include "StructuredBufferDX11.h"
 #include "ByteAddressBufferDX11.h"
 #include "IndirectArgsBufferDX11.h"
@@ -63,6 +64,8 @@
 #include "RenderEffectDX11.h"
 #include "GeometryDX11.h"
 #include "CommandListDX11.h"
+#include "JobSystem.h"
+#include "Profiler.h"
 
 #include "DXGIAdapter.h"
 #include "DXGIOutput.h"
@@ -94,6 +97,11 @@ using namespace Glyph3;
 //--------------------------------------------------------------------------------
 RendererDX11* RendererDX11::m_spRenderer = 0;
 //--------------------------------------------------------------------------------
+// Each pipeline writes its constant buffers into a ring of this size, and at
+// most this many frames can be in flight before Present waits for the GPU.
+static const unsigned int ConstantRingSize = 1024 * 1024;
+static const unsigned int ConstantRingFrames = 3;
+//--------------------------------------------------------------------------------
 RendererDX11::RendererDX11()
 {
 	if ( m_spRenderer == 0 )
@@ -112,6 +120,9 @@ RendererDX11::RendererDX11()
 	MultiThreadingConfig.ApplyConfiguration();
 
 	m_FeatureLevel = D3D_FEATURE_LEVEL_9_1; // Initialize this to only support 9.1...
+	m_FrameIndex = 0;
+	m_CompletedFrames = 0;
+	m_uiPayloads = 0;
 }
 //--------------------------------------------------------------------------------
 RendererDX11::~RendererDX11()
@@ -162,6 +173,11 @@ D3D_FEATURE_LEVEL RendererDX11::GetCurrentFeatureLevel()
 	return( m_FeatureLevel );
 }
 //--------------------------------------------------------------------------------
+unsigned int RendererDX11::GetPayloadCount()
+{
+	return( m_uiPayloads );
+}
+//--------------------------------------------------------------------------------
 UINT64 RendererDX11::GetAvailableVideoMemory()
 {
     // Acquire the DXGI device, then the adapter.
@@ -356,12 +372,19 @@ bool RendererDX11::Initialize( D3D_DRIVER_TYPE DriverType, D3D_FEATURE_LEVEL Fea
 	HRESULT hr1 = m_pDevice->CheckMultisampleQualityLevels( DXGI_FORMAT_R8G8B8A8_UNORM, 4, &NumQuality );
 
 
-	// Initialize the multithreading portion of the renderer.  This includes
-	// creating the threads themselves, initializing the thread payloads as well.
+	// Initialize the multithreading portion of the renderer.  The tasks are
+	// recorded on the job system's threads, and each task that is running uses
+	// one of the payloads.  There is one payload for each worker plus the main
+	// thread, which also records tasks while it waits for them.
 
-	for ( int i = 0; i < NUM_THREADS; i++ )
+	JobSystem* pJobs = JobSystem::Get();
+	m_uiPayloads = pJobs ? pJobs->GetWorkerCount() + 1 : 1;
+
+	if ( m_uiPayloads > NUM_THREADS )
+		m_uiPayloads = NUM_THREADS;
+
+	for ( unsigned int i = 0; i < m_uiPayloads; i++ )
 	{
-		// Mark each payload so that the thread knows which synchronization primitives to use.
 		g_aPayload[i].id = i;
 
 		// Create a deferred context for each thread's pipeline.
@@ -375,28 +398,39 @@ bool RendererDX11::Initialize( D3D_DRIVER_TYPE DriverType, D3D_FEATURE_LEVEL Fea
 		g_aPayload[i].pPipeline->OutputMergerStage.DesiredState.DepthStencilState.SetState( 0 );
 		g_aPayload[i].pPipeline->OutputMergerStage.DesiredState.BlendState.SetState( 0 );
 
-
-		// Create the command list.
-		g_aPayload[i].pList = new CommandListDX11();
-		
-		// Generate a new parameter manager for each thread.
+		// Generate a new parameter manager for each payload.
 		g_aPayload[i].pParamManager = new ParameterManagerDX11( i+1 );
 		g_aPayload[i].pParamManager->AttachParent( m_pParamMgr );
+	}
+
+	Log::Get().Write( L"Render tasks are recorded with " + std::to_wstring( m_uiPayloads ) + L" deferred contexts" );
 
-		// Initialize the payload data variables.
-		g_aPayload[i].bComplete = true;
-		g_aPayload[i].pTask = nullptr;
+	// Sub-allocate the constant buffers of each pipeline from a ring where the
+	// device allows it.  Otherwise every constant buffer is mapped on its own.
+	// The space of the rings is retired with an event query for each frame in
+	// flight, so the rings are only used if the queries can be created.
 
-		// Create the threads in a suspended state.
-		g_aThreadHandles[i] = 0;
-		g_aThreadHandles[i] = (HANDLE)_beginthreadex( 0, 0xfffff, _TaskThreadProc, &g_aPayload[i], CREATE_SUSPENDED, 0 );
+	D3D11_QUERY_DESC eventDesc;
+	eventDesc.Query = D3D11_QUERY_EVENT;
+	eventDesc.MiscFlags = 0;
 
-		// Create the synchronization events.
-		g_aBeginEventHandle[i] = CreateEvent( 0, FALSE, FALSE, 0 );
-		g_aEndEventHandle[i] = CreateEvent( 0, FALSE, FALSE, 0 );
+	m_vFrameQueries.resize( ConstantRingFrames );
 
-		// Start the thread up now that it has a synch object to use.
-		ResumeThread( g_aThreadHandles[i] );
+	for ( auto& query : m_vFrameQueries )
+	{
+		if ( FAILED( m_pDevice->CreateQuery( &eventDesc, query.GetAddressOf() ) ) )
+		{
+			Log::Get().Write( L"Unable to create a frame event query!" );
+			m_vFrameQueries.clear();
+			break;
+		}
+	}
+
+	if ( !m_vFrameQueries.empty() && pImmPipeline->CreateConstantBufferRing( ConstantRingSize ) ) {
+		for ( unsigned int i = 0; i < m_uiPayloads; i++ )
+			g_aPayload[i].pPipeline->CreateConstantBufferRing( ConstantRingSize );
+
+		Log::Get().Write( L"Constant buffers are sub-allocated from a ring buffer" );
 	}
 
 	return( true );
@@ -407,25 +441,31 @@ void RendererDX11::Shutdown()
 	// Print some details about the renderer's status at shutdown.
 	LogObjectPtrVector<ShaderDX11*>( m_vShaders );
 
-	// Shutdown all of the threads
+	// Release the thread payloads and command lists
+	m_TaskGraph.Wait();
+	m_TaskGraph.Clear();
+
 	for ( int i = 0; i < NUM_THREADS; i++ )
 	{
-		g_aPayload[i].bComplete = true;
-		g_aPayload[i].pTask = nullptr;
-		
 		SAFE_DELETE( g_aPayload[i].pParamManager );
 		SAFE_DELETE( g_aPayload[i].pPipeline );
-		SAFE_DELETE( g_aPayload[i].pList );
-
-		CloseHandle( g_aThreadHandles[i] );
-		CloseHandle( g_aBeginEventHandle[i] );
-		CloseHandle( g_aEndEventHandle[i] );
 	}
 
+	m_uiPayloads = 0;
+
+	for ( auto pList : m_vCommandLists )
+		delete pList;
+
+	m_vCommandLists.clear();
+
 
 	SAFE_DELETE( m_pParamMgr );
 	SAFE_DELETE( pImmPipeline );
 
+	m_vFrameQueries.clear();
+	m_FrameIndex = 0;
+	m_CompletedFrames = 0;
+
 	// Since these are all managed with smart pointers, we just empty the
 	// container and the objects will automatically be deleted.
 
@@ -473,6 +513,60 @@ void RendererDX11::Present(HWND hWnd, int SwapChain, UINT SyncInterval, UINT Pre
 	else {
 		Log::Get().Write( L"Tried to present an invalid swap chain index!" );
 	}
+
+	// Mark the end of the frame with its event query.  The command lists of the
+	// deferred contexts have been executed on the immediate context by now, so
+	// the query covers them as well.
+
+	if ( pImmPipeline->GetConstantBufferRing() == nullptr )
+		return;
+
+	const unsigned int queries = static_cast<unsigned int>( m_vFrameQueries.size() );
+
+	pImmPipeline->m_pContext->End( m_vFrameQueries[m_FrameIndex % queries].Get() );
+	m_FrameIndex++;
+
+	// Collect the frames that the GPU has finished, oldest first.  When every
+	// query is still pending, the oldest frame has to be waited for before its
+	// query can be issued again.  A failed query, e.g. after the device has
+	// been removed, is treated as finished so that this can't hang.
+
+	while ( m_CompletedFrames < m_FrameIndex )
+	{
+		const bool bWait = m_FrameIndex - m_CompletedFrames >= queries;
+		ID3D11Query* pQuery = m_vFrameQueries[m_CompletedFrames % queries].Get();
+
+		HRESULT hr = pImmPipeline->m_pContext->GetData( pQuery, nullptr, 0, bWait ? 0 : D3D11_ASYNC_GETDATA_DONOTFLUSH );
+
+		if ( hr == S_FALSE ) {
+			if ( !bWait )
+				break;
+
+			std::this_thread::yield();
+			continue;
+		}
+
+		m_CompletedFrames++;
+	}
+
+	// Start a new frame in the constant buffer rings, and free the space of the
+	// frames that have been completed.
+
+	pImmPipeline->GetConstantBufferRing()->BeginFrame( m_FrameIndex );
+
+	if ( m_CompletedFrames > 0 )
+		pImmPipeline->GetConstantBufferRing()->RetireFrames( m_CompletedFrames - 1 );
+
+	for ( unsigned int i = 0; i < m_uiPayloads; i++ ) {
+		ConstantBufferRingDX11* pRing = g_aPayload[i].pPipeline->GetConstantBufferRing();
+
+		if ( pRing ) {
+			pRing->BeginFrame( m_FrameIndex );
+
+			if ( m_CompletedFrames > 0 )
+				pRing->RetireFrames( m_CompletedFrames - 1 );
+		}
+	}
 }
 //--------------------------------------------------------------------------------
 int RendererDX11::CreateSwapChain( SwapChainConfigDX11* pConfig )
@@ -1041,7 +1135,7 @@ void RendererDX11::ResizeSwapChain( int SID, UINT width, UINT height )
 
 	this->pImmPipeline->ClearPipelineState();
 	
-	for ( int i = 0; i < NUM_THREADS; i++ ) {
+	for ( unsigned int i = 0; i < m_uiPayloads; i++ ) {
 		g_aPayload[i].pPipeline->ClearPipelineState();
 	}
 
@@ -1082,6 +1176,8 @@ int RendererDX11::LoadShader( ShaderType type, std::wstring& filename, std::wstr
 int RendererDX11::LoadShader( ShaderType type, std::wstring& filename, std::wstring& function, 
                                 std::wstring& model, const D3D_SHADER_MACRO* pDefines, bool enablelogging )
 {
+	GLYPH_PROFILE_SCOPE( "RendererDX11::LoadShader" );
+
 
 	// Check the existing list of shader files to see if there are any matches
 	// before trying to load it up again.  This will reduce the load times,
@@ -1090,7 +1186,9 @@ int RendererDX11::LoadShader( ShaderType type, std::wstring& filename, std::wstr
 	//
 	// In the case that there are any defines passed in, we skip returning the 
 	// cached shader - we assume that something is different about the shader due
-	// to the defines, so we can't just reuse a previously loaded one.
+	// to the defines, so we can't just reuse a previously loaded one.  For the
+	// same reason a shader compiled with defines is never returned for a request
+	// without them.
 	
 	for ( unsigned int i = 0; i < m_vShaders.size(); i++ )
 	{
@@ -1099,7 +1197,8 @@ int RendererDX11::LoadShader( ShaderType type, std::wstring& filename, std::wstr
 		if ( pShader->FileName.compare( filename ) == 0
 			&& pShader->Function.compare( function ) == 0
 			&& pShader->ShaderModel.compare( model ) == 0
-			&& pDefines == nullptr )
+			&& pDefines == nullptr
+			&& !pShader->HasDefines )
 		{
 			return( i );
 		}
@@ -1211,6 +1310,7 @@ int RendererDX11::LoadShader( ShaderType type, std::wstring& filename, std::wstr
 	pShaderWrapper->FileName = filename;
 	pShaderWrapper->Function = function;
 	pShaderWrapper->ShaderModel = model;
+	pShaderWrapper->HasDefines = ( pDefines != nullptr );
 
 	m_vShaders.push_back( pShaderWrapper );
 
@@ -1273,6 +1373,8 @@ int RendererDX11::CreateInputLayout( std::vector<D3D11_INPUT_ELEMENT_DESC>& elem
 //--------------------------------------------------------------------------------
 ResourcePtr RendererDX11::LoadTexture( std::wstring filename, bool sRGB )
 {
+	GLYPH_PROFILE_SCOPE( "RendererDX11::LoadTexture" );
+
 	ComPtr<ID3D11Resource> pResource;
 
 	FileSystem fs;
@@ -1615,105 +1717,122 @@ void RendererDX11::QueueTask( Task* pTask )
 	m_vQueuedTasks.push_back( pTask );
 }
 //--------------------------------------------------------------------------------
+void RendererDX11::QueueTaskDependency( Task* pTask, Task* pPrerequisite )
+{
+	m_vTaskDependencies.push_back( std::make_pair( pTask, pPrerequisite ) );
+}
+//--------------------------------------------------------------------------------
 void RendererDX11::ProcessTaskQueue( )
 {
+	GLYPH_PROFILE_SCOPE( "RendererDX11::ProcessTaskQueue" );
+
 	MultiThreadingConfig.ApplyConfiguration();
 
-	if ( MultiThreadingConfig.GetConfiguration() == false )
-	{
-		// Single-threaded processing of the render view queue
+	// Build a graph with one node for each task.  The nodes are added in the
+	// reverse of the queued order, which is the order that the graph follows
+	// wherever the dependencies don't say otherwise.
 
-		for ( int i = m_vQueuedTasks.size()-1; i >= 0; i-=NUM_THREADS )
-        {
-			for ( int j = 0; j < NUM_THREADS; j++ )
-			{
-				if ( (i-j) >= 0 )
-				{
-					//
-					pImmPipeline->BeginEvent( std::wstring( L"View Draw: ") + m_vQueuedTasks[i-j]->GetName() );
-					m_vQueuedTasks[i-j]->ExecuteTask( pImmPipeline, g_aPayload[j].pParamManager );
-					pImmPipeline->EndEvent();
-					//PIXEndEvent();
-				}
-			}
-        }
+	const unsigned int count = static_cast<unsigned int>( m_vQueuedTasks.size() );
+
+	m_TaskGraph.Clear();
+
+	for ( unsigned int i = 0; i < count; i++ )
+		m_TaskGraph.AddNode();
 
-		m_vQueuedTasks.clear();
+	for ( auto& dependency : m_vTaskDependencies )
+	{
+		auto task = std::find( m_vQueuedTasks.begin(), m_vQueuedTasks.end(), dependency.first );
+		auto prerequisite = std::find( m_vQueuedTasks.begin(), m_vQueuedTasks.end(), dependency.second );
+
+		if ( task != m_vQueuedTasks.end() && prerequisite != m_vQueuedTasks.end() && task != prerequisite )
+			m_TaskGraph.AddDependency( count - 1 - static_cast<unsigned int>( task - m_vQueuedTasks.begin() ),
+				count - 1 - static_cast<unsigned int>( prerequisite - m_vQueuedTasks.begin() ) );
 	}
-	else
+
+	JobSystem* pJobs = MultiThreadingConfig.GetConfiguration() ? JobSystem::Get() : nullptr;
+
+	if ( pJobs == nullptr || m_uiPayloads < 2 )
 	{
-		// Multi-threaded processing of the render view queue
+		// Single-threaded processing of the render view queue, directly with the
+		// immediate context.
 
-		for ( int i = m_vQueuedTasks.size()-1; i >= 0; i-=NUM_THREADS )
+		TaskGraph::NodeFunction execute = [this,count]( unsigned int node, unsigned int slot )
 		{
-			DWORD count = 0;
-
-			for ( int j = 0; j < NUM_THREADS; j++ )
-			{
-				if ( (i-j) >= 0 )
-				{
-					count++;
-					g_aPayload[j].pTask = m_vQueuedTasks[i-j];
-					SetEvent( g_aBeginEventHandle[j] );
-				}
-			}
+			GLYPH_PROFILE_SCOPE( "RendererDX11::ExecuteTask" );
 
-			WaitForMultipleObjects( count, g_aEndEventHandle, true, INFINITE );
+			Task* pTask = m_vQueuedTasks[count - 1 - node];
 
-			for ( int j = 0; count > 0; count-- )
-			{
-				pImmPipeline->ExecuteCommandList( g_aPayload[j].pList );
-				g_aPayload[j].pList->ReleaseList();
-				j++;
-			}
+			pImmPipeline->BeginEvent( std::wstring( L"View Draw: ") + pTask->GetName() );
+			pTask->ExecuteTask( pImmPipeline, g_aPayload[slot].pParamManager );
+			pImmPipeline->EndEvent();
+		};
 
-		}
+		if ( !m_TaskGraph.Execute( nullptr, 1, execute ) )
+		{
+			Log::Get().Write( L"The render task dependencies contain a cycle, they will be ignored!" );
+
+			m_TaskGraph.Clear();
+
+			for ( unsigned int i = 0; i < count; i++ )
+				m_TaskGraph.AddNode();
 
-		m_vQueuedTasks.clear();
+			m_TaskGraph.Execute( nullptr, 1, execute );
+		}
 	}
-}
-//--------------------------------------------------------------------------------
+	else
+	{
+		// Multi-threaded processing of the render view queue.  Each task is
+		// recorded into its own command list as soon as a payload is free, and
+		// the lists are played back as they become available.
 
+		while ( m_vCommandLists.size() < count )
+			m_vCommandLists.push_back( new CommandListDX11() );
 
-//--------------------------------------------------------------------------------
-// Here is the render view process for each thread.  The intention here is to 
-// have a thread perform a single render view's rendering commands to generate
-// a command list.  This list is later used by the immediate context to execute
-// the list.
-//--------------------------------------------------------------------------------
-HANDLE						g_aThreadHandles[NUM_THREADS];
-Glyph3::ThreadPayLoad		g_aPayload[NUM_THREADS];
-HANDLE						g_aBeginEventHandle[NUM_THREADS];
-HANDLE						g_aEndEventHandle[NUM_THREADS];
+		TaskGraph::NodeFunction record = [this,count]( unsigned int node, unsigned int slot )
+		{
+			GLYPH_PROFILE_SCOPE( "RendererDX11::RecordTask" );
 
+			ThreadPayLoad& payload = g_aPayload[slot];
 
-unsigned int WINAPI _TaskThreadProc( void* lpParameter )
-{
-	ThreadPayLoad* pPayload = (ThreadPayLoad*) lpParameter;
+			payload.pPipeline->m_pContext->ClearState();
+			m_vQueuedTasks[count - 1 - node]->ExecuteTask( payload.pPipeline, payload.pParamManager );
+			payload.pPipeline->GenerateCommandList( m_vCommandLists[node] );
+		};
 
-	int id = pPayload->id;
+		if ( !m_TaskGraph.Execute( pJobs, m_uiPayloads, record ) )
+		{
+			Log::Get().Write( L"The render task dependencies contain a cycle, they will be ignored!" );
 
+			m_TaskGraph.Clear();
 
-	for ( ; ; )
-	{
-		// Wait for the main thread to signal that there is a payload available.
-		WaitForSingleObject( g_aBeginEventHandle[id], INFINITE );
+			for ( unsigned int i = 0; i < count; i++ )
+				m_TaskGraph.AddNode();
 
-		pPayload->pPipeline->m_pContext->ClearState();
+			m_TaskGraph.Execute( pJobs, m_uiPayloads, record );
+		}
 
-		// Execute the render view with the provided pipeline and parameter managers.
-		pPayload->pTask->ExecuteTask( pPayload->pPipeline, pPayload->pParamManager );
+		GLYPH_PROFILE_SCOPE( "RendererDX11::ExecuteCommandLists" );
 
-		// Generate the command list.
-		pPayload->pPipeline->GenerateCommandList( pPayload->pList );
+		for ( auto node : m_TaskGraph.GetOrder() )
+		{
+			m_TaskGraph.WaitForNode( node );
 
-		// Signal to the main thread that the view has been collected into a command list.
-		SetEvent( g_aEndEventHandle[id] );
+			pImmPipeline->ExecuteCommandList( m_vCommandLists[node] );
+			m_vCommandLists[node]->ReleaseList();
+		}
+
+		m_TaskGraph.Wait();
 	}
 
-	return( 0 );
+	m_vQueuedTasks.clear();
+	m_vTaskDependencies.clear();
 }
 //--------------------------------------------------------------------------------
+// The payloads hold the deferred pipeline and parameter manager that a render
+// task is recorded with.  Only the first m_uiPayloads entries are initialized.
+//--------------------------------------------------------------------------------
+Glyph3::ThreadPayLoad		g_aPayload[NUM_THREADS];
+//--------------------------------------------------------------------------------
 Texture1dDX11* RendererDX11::GetTexture1DByIndex( int rid )
 {
 	Texture1dDX11* pResult = 0;
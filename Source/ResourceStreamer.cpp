@@ -0,0 +1,527 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "ResourceStreamer.h"
+#include "Profiler.h"
+#include "Log.h"
+#include "GlyphString.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+ResourceStreamer::ResourceStreamer( unsigned int uiReadThreads, unsigned int uiDecodeThreads ) :
+	m_bShutdown( false ),
+	m_bCancelling( false ),
+	m_uiQueued( 0 ),
+	m_uiInFlight( 0 ),
+	m_ullBytesInFlight( 0 ),
+	m_ullMemoryBudget( 256 * 1024 * 1024 ),
+	m_fFinalizeBudget( 2.0f ),
+	m_fHitchThreshold( 1000.0f / 30.0f ),
+	m_LastUpdate( 0 ),
+	m_bStreamingLastFrame( false ),
+	m_dTotalFrameTime( 0.0 ),
+	m_uiReadThreads( std::max( uiReadThreads, 1U ) ),
+	m_uiDecodeThreads( std::max( uiDecodeThreads, 1U ) )
+{
+	memset( &m_Statistics, 0, sizeof( m_Statistics ) );
+}
+//--------------------------------------------------------------------------------
+ResourceStreamer::~ResourceStreamer()
+{
+	CancelAll();
+
+	{
+		std::lock_guard<std::mutex> lock( m_Lock );
+		m_bShutdown = true;
+	}
+	m_ReadWake.notify_all();
+	m_DecodeWake.notify_all();
+
+	for ( auto& thread : m_Threads )
+		thread.join();
+}
+//--------------------------------------------------------------------------------
+bool ResourceStreamer::Submit( StreamRequestPtr pRequest, StreamPriority priority )
+{
+	if ( priority < STREAM_PRIORITY_HIGH || priority >= STREAM_PRIORITY_COUNT )
+		priority = STREAM_PRIORITY_NORMAL;
+
+	{
+		std::lock_guard<std::mutex> lock( m_Lock );
+
+		if ( !pRequest || pRequest->GetState() != STREAM_IDLE )
+			return( false );
+
+		if ( m_Threads.empty() )
+			StartThreads();
+
+		pRequest->m_Priority = priority;
+		pRequest->m_State = STREAM_QUEUED;
+
+		m_ReadQueues[priority].push_back( pRequest );
+		m_uiQueued++;
+	}
+	m_ReadWake.notify_one();
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void ResourceStreamer::StartThreads( )
+{
+	// Called with the lock held, which the new threads wait for before they look
+	// at the queues.
+
+	m_Threads.reserve( m_uiReadThreads + m_uiDecodeThreads );
+
+	for ( unsigned int i = 0; i < m_uiReadThreads; i++ )
+		m_Threads.push_back( std::thread( &ResourceStreamer::ReadThread, this ) );
+
+	for ( unsigned int i = 0; i < m_uiDecodeThreads; i++ )
+		m_Threads.push_back( std::thread( &ResourceStreamer::DecodeThread, this ) );
+}
+//--------------------------------------------------------------------------------
+bool ResourceStreamer::RunStage( StreamRequest& request, bool ( StreamRequest::*pStage )( ) )
+{
+	// An exception that escaped here would end the thread, and the requests
+	// behind this one would never finish.  The PLY loader throws its errors as
+	// pointers, which are released here as well.
+
+	try
+	{
+		return( ( request.*pStage )() );
+	}
+	catch ( std::exception* pException )
+	{
+		Log::Get().Write( L"Exception while streaming " + request.m_Filename + L": " + GlyphString::ToUnicode( pException->what() ), LOG_ERROR );
+		delete pException;
+	}
+	catch ( std::exception& exception )
+	{
+		Log::Get().Write( L"Exception while streaming " + request.m_Filename + L": " + GlyphString::ToUnicode( exception.what() ), LOG_ERROR );
+	}
+	catch ( ... )
+	{
+		Log::Get().Write( L"Exception while streaming " + request.m_Filename, LOG_ERROR );
+	}
+
+	return( false );
+}
+//--------------------------------------------------------------------------------
+void ResourceStreamer::ReadThread( )
+{
+	std::unique_lock<std::mutex> lock( m_Lock );
+
+	while ( !m_bShutdown )
+	{
+		RequestQueue* pQueue = nullptr;
+
+		for ( int p = 0; p < STREAM_PRIORITY_COUNT && !pQueue; p++ ) {
+			if ( !m_ReadQueues[p].empty() )
+				pQueue = &m_ReadQueues[p];
+		}
+
+		if ( !pQueue )
+		{
+			m_ReadWake.wait( lock );
+			continue;
+		}
+
+		StreamRequestPtr pRequest = pQueue->front();
+
+		if ( pRequest->IsCancelled() || m_bCancelling )
+		{
+			pQueue->pop_front();
+			Finish( pRequest, STREAM_CANCELLED );
+			continue;
+		}
+
+		// The cost is estimated without holding the lock, since it may have to
+		// touch the disk.  The request is taken off the queue in the meantime
+		// so that no other thread estimates it as well.
+
+		if ( !pRequest->m_bCostKnown )
+		{
+			pQueue->pop_front();
+			lock.unlock();
+
+			// A request whose estimate throws isn't charged anything, and is
+			// left to fail in the stages that follow.
+			unsigned long long cost = 0;
+
+			try {
+				cost = pRequest->EstimateMemoryCost();
+			} catch ( ... ) {
+			}
+
+			lock.lock();
+			pRequest->m_ullMemoryCost = cost;
+			pRequest->m_bCostKnown = true;
+			pQueue->push_front( pRequest );
+			continue;
+		}
+
+		// Wait for the requests in flight to release their memory if this one
+		// doesn't fit.  New requests of a higher priority go ahead when they
+		// arrive in the meantime.
+
+		if ( m_ullBytesInFlight > 0 && m_ullBytesInFlight + pRequest->m_ullMemoryCost > m_ullMemoryBudget )
+		{
+			m_ReadWake.wait( lock );
+			continue;
+		}
+
+		pQueue->pop_front();
+		m_uiQueued--;
+		m_uiInFlight++;
+		m_ullBytesInFlight += pRequest->m_ullMemoryCost;
+		pRequest->m_bCharged = true;
+		pRequest->m_State = STREAM_READING;
+
+		lock.unlock();
+
+		bool bRead = false;
+		{
+			GLYPH_PROFILE_SCOPE( "ResourceStreamer::Read" );
+			bRead = RunStage( *pRequest, &StreamRequest::Read );
+		}
+
+		lock.lock();
+
+		if ( pRequest->IsCancelled() || m_bCancelling )
+		{
+			Finish( pRequest, STREAM_CANCELLED );
+		}
+		else if ( !bRead )
+		{
+			Finish( pRequest, STREAM_FAILED );
+		}
+		else
+		{
+			pRequest->m_State = STREAM_DECODING;
+			m_DecodeQueues[pRequest->m_Priority].push_back( pRequest );
+			m_DecodeWake.notify_one();
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+void ResourceStreamer::DecodeThread( )
+{
+	// Some decoders go through COM, such as WIC for the texture formats other
+	// than DDS, so it is initialized once for the lifetime of the thread.
+
+	const HRESULT hrCom = CoInitializeEx( nullptr, COINIT_MULTITHREADED );
+
+	std::unique_lock<std::mutex> lock( m_Lock );
+
+	while ( !m_bShutdown )
+	{
+		StreamRequestPtr pRequest;
+
+		if ( !Pop( m_DecodeQueues, pRequest ) )
+		{
+			m_DecodeWake.wait( lock );
+			continue;
+		}
+
+		if ( pRequest->IsCancelled() || m_bCancelling )
+		{
+			Finish( pRequest, STREAM_CANCELLED );
+			continue;
+		}
+
+		lock.unlock();
+
+		bool bDecoded = false;
+		{
+			GLYPH_PROFILE_SCOPE( "ResourceStreamer::Decode" );
+			bDecoded = RunStage( *pRequest, &StreamRequest::Decode );
+		}
+
+		lock.lock();
+
+		if ( pRequest->IsCancelled() || m_bCancelling )
+		{
+			Finish( pRequest, STREAM_CANCELLED );
+		}
+		else if ( !bDecoded )
+		{
+			Finish( pRequest, STREAM_FAILED );
+		}
+		else
+		{
+			pRequest->m_State = STREAM_FINALIZING;
+			m_FinalizeQueues[pRequest->m_Priority].push_back( pRequest );
+			m_Progress.notify_all();
+		}
+	}
+
+	lock.unlock();
+
+	if ( SUCCEEDED( hrCom ) )
+		CoUninitialize();
+}
+//--------------------------------------------------------------------------------
+bool ResourceStreamer::FinalizeOne( )
+{
+	StreamRequestPtr pRequest;
+
+	{
+		std::lock_guard<std::mutex> lock( m_Lock );
+
+		if ( !Pop( m_FinalizeQueues, pRequest ) )
+			return( false );
+
+		if ( pRequest->IsCancelled() )
+		{
+			Finish( pRequest, STREAM_CANCELLED );
+			return( true );
+		}
+	}
+
+	bool bFinalized = false;
+	{
+		GLYPH_PROFILE_SCOPE( "ResourceStreamer::Finalize" );
+		bFinalized = RunStage( *pRequest, &StreamRequest::Finalize );
+	}
+
+	std::lock_guard<std::mutex> lock( m_Lock );
+	Finish( pRequest, bFinalized ? STREAM_COMPLETE : STREAM_FAILED );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void ResourceStreamer::Finish( const StreamRequestPtr& pRequest, StreamState state )
+{
+	// Called with the lock held.  A request that was never read is still counted
+	// as queued, and isn't charged to the memory budget.
+
+	if ( pRequest->m_bCharged )
+	{
+		m_ullBytesInFlight -= pRequest->m_ullMemoryCost;
+		m_uiInFlight--;
+		pRequest->m_bCharged = false;
+	}
+	else
+	{
+		m_uiQueued--;
+	}
+
+	std::vector<char>().swap( pRequest->m_Data );
+
+	if ( state == STREAM_COMPLETE )
+	{
+		m_Statistics.completed++;
+	}
+	else if ( state == STREAM_FAILED )
+	{
+		m_Statistics.failed++;
+		Log::Get().Write( L"Failed to stream resource: " + pRequest->m_Filename, LOG_ERROR );
+	}
+	else
+	{
+		m_Statistics.cancelled++;
+		pRequest->m_bCancelled = true;
+	}
+
+	pRequest->m_State = state;
+
+	m_ReadWake.notify_all();
+	m_Progress.notify_all();
+}
+//--------------------------------------------------------------------------------
+bool ResourceStreamer::Pop( RequestQueue* pQueues, StreamRequestPtr& pRequest )
+{
+	for ( int p = 0; p < STREAM_PRIORITY_COUNT; p++ )
+	{
+		if ( !pQueues[p].empty() )
+		{
+			pRequest = pQueues[p].front();
+			pQueues[p].pop_front();
+			return( true );
+		}
+	}
+
+	return( false );
+}
+//--------------------------------------------------------------------------------
+bool ResourceStreamer::IsEmpty( const RequestQueue* pQueues ) const
+{
+	for ( int p = 0; p < STREAM_PRIORITY_COUNT; p++ ) {
+		if ( !pQueues[p].empty() )
+			return( false );
+	}
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void ResourceStreamer::Update( )
+{
+	GLYPH_PROFILE_SCOPE( "ResourceStreamer::Update" );
+
+	const unsigned long long now = Profiler::GetTimestamp();
+	const double milliseconds = 1000.0 / Profiler::GetTimestampFrequency();
+
+	// The time since the last update is the length of the frame that just
+	// ended, which is counted when something was streaming at either end of it.
+
+	{
+		std::lock_guard<std::mutex> lock( m_Lock );
+
+		const bool bStreaming = ( m_uiQueued + m_uiInFlight ) > 0;
+
+		if ( m_LastUpdate != 0 && ( bStreaming || m_bStreamingLastFrame ) )
+		{
+			const float frameTime = static_cast<float>( ( now - m_LastUpdate ) * milliseconds );
+
+			m_Statistics.streamingFrames++;
+			m_dTotalFrameTime += frameTime;
+			m_Statistics.averageFrameTime = static_cast<float>( m_dTotalFrameTime / m_Statistics.streamingFrames );
+			m_Statistics.maximumFrameTime = std::max( m_Statistics.maximumFrameTime, frameTime );
+
+			if ( frameTime > m_fHitchThreshold )
+				m_Statistics.hitchFrames++;
+		}
+
+		m_LastUpdate = now;
+		m_bStreamingLastFrame = bStreaming;
+	}
+
+	// At least one request is finalized per frame, so that a request that takes
+	// longer than the budget can't hold up the others forever.
+
+	const unsigned long long budget = static_cast<unsigned long long>( m_fFinalizeBudget / milliseconds );
+	const unsigned long long start = Profiler::GetTimestamp();
+	unsigned long long end = start;
+	bool bFinalized = false;
+
+	while ( ( !bFinalized || end - start < budget ) && FinalizeOne() )
+	{
+		bFinalized = true;
+		end = Profiler::GetTimestamp();
+	}
+
+	std::lock_guard<std::mutex> lock( m_Lock );
+	m_Statistics.lastFinalizeTime = static_cast<float>( ( end - start ) * milliseconds );
+	m_Statistics.maximumFinalizeTime = std::max( m_Statistics.maximumFinalizeTime, m_Statistics.lastFinalizeTime );
+}
+//--------------------------------------------------------------------------------
+void ResourceStreamer::Flush( )
+{
+	std::unique_lock<std::mutex> lock( m_Lock );
+
+	while ( m_uiQueued + m_uiInFlight > 0 )
+	{
+		if ( IsEmpty( m_FinalizeQueues ) )
+		{
+			m_Progress.wait( lock );
+			continue;
+		}
+
+		lock.unlock();
+		FinalizeOne();
+		lock.lock();
+	}
+}
+//--------------------------------------------------------------------------------
+void ResourceStreamer::CancelAll( )
+{
+	std::unique_lock<std::mutex> lock( m_Lock );
+
+	m_bCancelling = true;
+
+	RequestQueue* queues[] = { m_ReadQueues, m_DecodeQueues, m_FinalizeQueues };
+
+	for ( auto pQueues : queues )
+	{
+		for ( int p = 0; p < STREAM_PRIORITY_COUNT; p++ )
+		{
+			for ( auto& pRequest : pQueues[p] )
+				Finish( pRequest, STREAM_CANCELLED );
+
+			pQueues[p].clear();
+		}
+	}
+
+	// The stages that are in progress stop at their end.  Requests that finish
+	// decoding in the meantime are cancelled here, since nothing else would
+	// finalize them.
+
+	while ( m_uiQueued + m_uiInFlight > 0 )
+	{
+		StreamRequestPtr pRequest;
+
+		if ( Pop( m_FinalizeQueues, pRequest ) )
+			Finish( pRequest, STREAM_CANCELLED );
+		else
+			m_Progress.wait( lock );
+	}
+
+	m_bCancelling = false;
+}
+//--------------------------------------------------------------------------------
+void ResourceStreamer::SetMemoryBudget( unsigned long long bytes )
+{
+	{
+		std::lock_guard<std::mutex> lock( m_Lock );
+		m_ullMemoryBudget = bytes;
+	}
+	m_ReadWake.notify_all();
+}
+//--------------------------------------------------------------------------------
+unsigned long long ResourceStreamer::GetMemoryBudget( ) const
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+	return( m_ullMemoryBudget );
+}
+//--------------------------------------------------------------------------------
+void ResourceStreamer::SetFinalizeBudget( float milliseconds )
+{
+	m_fFinalizeBudget = milliseconds;
+}
+//--------------------------------------------------------------------------------
+float ResourceStreamer::GetFinalizeBudget( ) const
+{
+	return( m_fFinalizeBudget );
+}
+//--------------------------------------------------------------------------------
+void ResourceStreamer::SetHitchThreshold( float milliseconds )
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+	m_fHitchThreshold = milliseconds;
+}
+//--------------------------------------------------------------------------------
+float ResourceStreamer::GetHitchThreshold( ) const
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+	return( m_fHitchThreshold );
+}
+//--------------------------------------------------------------------------------
+ResourceStreamer::Statistics ResourceStreamer::GetStatistics( ) const
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	Statistics statistics = m_Statistics;
+	statistics.queued = m_uiQueued;
+	statistics.inFlight = m_uiInFlight;
+	statistics.bytesInFlight = m_ullBytesInFlight;
+
+	return( statistics );
+}
+//--------------------------------------------------------------------------------
+void ResourceStreamer::ResetStatistics( )
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	memset( &m_Statistics, 0, sizeof( m_Statistics ) );
+	m_dTotalFrameTime = 0.0;
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,135 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "RingAllocator.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+RingAllocator::RingAllocator( unsigned int capacity, unsigned int alignment ) :
+	m_uiCapacity( capacity ),
+	m_uiAlignment( alignment > 0 ? alignment : 1 ),
+	m_uiHead( 0 ),
+	m_uiUsed( 0 )
+{
+	Frame frame = { 0, 0 };
+	m_Frames.push_back( frame );
+}
+//--------------------------------------------------------------------------------
+RingAllocator::~RingAllocator()
+{
+}
+//--------------------------------------------------------------------------------
+bool RingAllocator::Allocate( unsigned int size, unsigned int& offset )
+{
+	const unsigned int aligned = ( ( size + m_uiAlignment - 1 ) / m_uiAlignment ) * m_uiAlignment;
+
+	if ( aligned == 0 || aligned > m_uiCapacity || m_uiUsed == m_uiCapacity )
+		return( false );
+
+	// An empty ring can start over from the beginning, which avoids wrapping
+	// in the middle of the next frame.
+
+	if ( m_uiUsed == 0 )
+		m_uiHead = 0;
+
+	const unsigned int tail = ( m_uiHead + m_uiCapacity - m_uiUsed ) % m_uiCapacity;
+	unsigned int skipped = 0;
+
+	if ( m_uiUsed == 0 || m_uiHead >= tail )
+	{
+		// The free space is split between the end and the start of the block.
+
+		if ( aligned <= m_uiCapacity - m_uiHead ) {
+			offset = m_uiHead;
+		} else if ( aligned <= tail ) {
+			skipped = m_uiCapacity - m_uiHead;
+			offset = 0;
+		} else {
+			return( false );
+		}
+	}
+	else
+	{
+		// The free space is the gap between the head and the oldest frame.
+
+		if ( aligned > tail - m_uiHead )
+			return( false );
+
+		offset = m_uiHead;
+	}
+
+	m_uiHead = ( offset + aligned ) % m_uiCapacity;
+	m_uiUsed += skipped + aligned;
+	m_Frames.back().size += skipped + aligned;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void RingAllocator::BeginFrame( unsigned long long frame )
+{
+	assert( frame > m_Frames.back().index );
+
+	Frame entry = { frame, 0 };
+	m_Frames.push_back( entry );
+}
+//--------------------------------------------------------------------------------
+void RingAllocator::RetireFrames( unsigned long long frame )
+{
+	unsigned int count = 0;
+
+	while ( count + 1 < m_Frames.size() && m_Frames[count].index <= frame )
+	{
+		m_uiUsed -= m_Frames[count].size;
+		count++;
+	}
+
+	m_Frames.erase( m_Frames.begin(), m_Frames.begin() + count );
+}
+//--------------------------------------------------------------------------------
+void RingAllocator::Reset()
+{
+	const unsigned long long current = m_Frames.back().index;
+
+	m_Frames.clear();
+
+	Frame frame = { current, 0 };
+	m_Frames.push_back( frame );
+
+	m_uiHead = 0;
+	m_uiUsed = 0;
+}
+//--------------------------------------------------------------------------------
+unsigned long long RingAllocator::GetFrame() const
+{
+	return( m_Frames.back().index );
+}
+//--------------------------------------------------------------------------------
+unsigned int RingAllocator::GetCapacity() const
+{
+	return( m_uiCapacity );
+}
+//--------------------------------------------------------------------------------
+unsigned int RingAllocator::GetAlignment() const
+{
+	return( m_uiAlignment );
+}
+//--------------------------------------------------------------------------------
+unsigned int RingAllocator::GetUsedSize() const
+{
+	return( m_uiUsed );
+}
+//--------------------------------------------------------------------------------
+unsigned int RingAllocator::GetFramesInFlight() const
+{
+	return( static_cast<unsigned int>( m_Frames.size() ) );
+}
+//--------------------------------------------------------------------------------
@@ -13,12 +13,14 @@
 #include "Scene.h"
 #include "Log.h"
 #include "SceneGraph.h"
+#include "Profiler.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
 Scene::Scene()
 {
 	m_pRoot = new Node3D();
+	m_Hierarchy.Build( m_pRoot );
 }
 //--------------------------------------------------------------------------------
 Scene::~Scene()
@@ -38,10 +40,23 @@ Node3D* Scene::GetRoot()
 //--------------------------------------------------------------------------------
 void Scene::Update( float time )
 {
-	// Perform the udpate on the root, which will propagate through the scene
-	// and update all entities in the scene.
+	GLYPH_PROFILE_SCOPE( "Scene::Update" );
 
-	m_pRoot->Update( time );
+	// Perform the update with the flattened hierarchy, which visits the scene
+	// in the same order as a recursive update from the root but only rebuilds
+	// the transforms that have changed.
+
+	m_Hierarchy.Update( time );
+
+	// Refresh the node bounds that the render views use to cull whole subtrees.
+
+	m_Hierarchy.UpdateBounds( );
+
+	// Bring the bounding volume hierarchy up to date with the new transforms,
+	// refitting only the entities that the bounds update found to have changed.
+
+	m_Bounds.Update( m_Hierarchy.GetEntities(), m_Hierarchy.GetStructureRevision(),
+					m_Hierarchy.GetChangedEntities() );
 }
 //--------------------------------------------------------------------------------
 void Scene::Render( RendererDX11* pRenderer )
@@ -135,8 +150,68 @@ void Scene::RemoveActor( Actor* pActor )
 	if ( pParent ) pParent->DetachChild( pActor->GetNode() );
 }
 //--------------------------------------------------------------------------------
+void Scene::SetParallelUpdate( bool bParallel )
+{
+	m_Hierarchy.SetParallel( bParallel );
+}
+//--------------------------------------------------------------------------------
+void Scene::SynchronizeBounds( )
+{
+	// The structure of the graph may have changed since the last update, and
+	// the entities that have been detached may already be deleted.  Rebuilding
+	// the flattened graph doesn't update any transforms, so the next update
+	// still sees the same changes.  The entities that remain in the tree were
+	// fit by the last update, and the new ones are fit as they are inserted.
+
+	if ( m_pRoot->GetStructureRevision() != m_Hierarchy.GetStructureRevision() )
+	{
+		m_Hierarchy.Build( m_pRoot );
+		m_Bounds.Update( m_Hierarchy.GetEntities(), m_Hierarchy.GetStructureRevision(),
+						m_Hierarchy.GetChangedEntities() );
+	}
+}
+//--------------------------------------------------------------------------------
 void Scene::BuildPickRecord( Ray3f& ray, std::vector<PickRecord>& record )
 {
-	Glyph3::BuildPickRecord( m_pRoot, ray, record );
+	SynchronizeBounds( );
+
+	// Only the entities whose bounds are hit by the ray need the exact test.
+
+	std::vector<Entity3D*> set;
+	m_Bounds.QueryRay( ray, set );
+
+	for ( auto entity : set ) {
+		AddPickRecord( entity, ray, record );
+	}
+}
+//--------------------------------------------------------------------------------
+void Scene::BuildPickRecords( const std::vector<Ray3f>& rays, std::vector< std::vector<PickRecord> >& records )
+{
+	SynchronizeBounds( );
+
+	std::vector< std::vector<Entity3D*> > sets;
+	m_Bounds.QueryRays( rays, sets );
+
+	records.resize( rays.size() );
+
+	for ( unsigned int i = 0; i < rays.size(); i++ ) {
+		for ( auto entity : sets[i] ) {
+			AddPickRecord( entity, rays[i], records[i] );
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+void Scene::GetIntersectingEntities( std::vector< Entity3D* >& set, Sphere3f& bounds )
+{
+	SynchronizeBounds( );
+
+	m_Bounds.QuerySphere( bounds, set );
+}
+//--------------------------------------------------------------------------------
+void Scene::GetIntersectingEntities( std::vector< Entity3D* >& set, Frustum3f& bounds )
+{
+	SynchronizeBounds( );
+
+	m_Bounds.QueryFrustum( bounds, set );
 }
 //--------------------------------------------------------------------------------
\ No newline at end of file
@@ -17,11 +17,15 @@ using namespace Glyph3;
 void Glyph3::GetAllEntities( Node3D* node, std::vector< Entity3D* >& set ) {
 
 	set.reserve( set.size() + node->Leafs().size() );
-	set.insert( set.end(), node->Leafs().begin(), node->Leafs().end() );
 
-	// Get all of the leafs from this node, then decend to its children
+	// Get all of the leafs from this node, then decend to its children.  Empty
+	// slots in the leaf and node lists are skipped.
+	for ( auto e : node->Leafs() ) {
+		if ( e ) set.push_back( e );
+	}
+
 	for ( auto n : node->Nodes() ) {
-		GetAllEntities( n, set );
+		if ( n ) GetAllEntities( n, set );
 	}
 }
 //--------------------------------------------------------------------------------
@@ -46,59 +50,62 @@ bool Glyph3::EntityInSubTree( Node3D* node, Entity3D* entity )
 //--------------------------------------------------------------------------------
 void Glyph3::GetIntersectingEntities( Node3D* node, std::vector< Entity3D* >& set, Frustum3f& bounds )
 {
-	// TODO: THis has to be fixed!
-	//if ( bounds.Intersects( GetWorldBoundingSphere() ) )
-	//	set.push_back( this );
+	// Test the world space bounding sphere of each entity in the subtree.  
+	// Entities without any shapes have no bounds, and are never included.
+
+	std::vector<Entity3D*> entities;
+	GetAllEntities( node, entities );
+
+	for ( auto entity : entities )
+	{
+		Sphere3f sphere;
+
+		if ( entity->Shape.GetBoundingSphere( entity->Transform.WorldMatrix(), sphere ) ) {
+			if ( bounds.Intersects( sphere ) ) {
+				set.push_back( entity );
+			}
+		}
+	}
 }
 //--------------------------------------------------------------------------------
 void Glyph3::GetIntersectingEntities( Node3D* node, std::vector< Entity3D* >& set, Sphere3f& bounds )
 {
-	// TODO: THis has to be fixed!
-	//if ( bounds.Intersects( GetWorldBoundingSphere() ) )
-	//	set.push_back( this );
+	std::vector<Entity3D*> entities;
+	GetAllEntities( node, entities );
+
+	for ( auto entity : entities )
+	{
+		Sphere3f sphere;
+
+		if ( entity->Shape.GetBoundingSphere( entity->Transform.WorldMatrix(), sphere ) ) {
+			if ( bounds.Intersects( sphere ) ) {
+				set.push_back( entity );
+			}
+		}
+	}
 }
 //--------------------------------------------------------------------------------
-void Glyph3::BuildPickRecord( Node3D* node, const Ray3f& ray, std::vector<PickRecord>& record )
+void Glyph3::AddPickRecord( Entity3D* entity, const Ray3f& ray, std::vector<PickRecord>& record )
 {
-	// Get a flat list of all the entities in this node's subtree.
-	std::vector<Entity3D*> set;
-	GetAllEntities( node, set );
-
-	for ( auto& entity : set )
+	if ( entity->Shape.GetNumberOfShapes() > 0 )
 	{
-		if ( entity->Shape.GetNumberOfShapes() > 0 )
-		{
-			Matrix4f InvWorld = entity->Transform.WorldMatrix().Inverse();
-			Vector4f position = Vector4f( ray.origin, 1.0f );
-			Vector4f direction = Vector4f( ray.direction, 0.0f );
-		
-			position = InvWorld * position;
-			direction = InvWorld * direction;
+		Matrix4f InvWorld = entity->Transform.WorldMatrix().Inverse();
+		Vector4f position = Vector4f( ray.origin, 1.0f );
+		Vector4f direction = Vector4f( ray.direction, 0.0f );
+	
+		position = InvWorld * position;
+		direction = InvWorld * direction;
 
-			Ray3f ObjectRay(position.xyz(), direction.xyz());
+		Ray3f ObjectRay(position.xyz(), direction.xyz());
 
-			float fT = 10000000000.0f;
-			if ( entity->Shape.RayIntersection( ObjectRay, &fT ) )
-			{
-				PickRecord Record;
-				Record.pEntity = entity;
-				Record.fDistance = fT;
-				record.push_back( Record );
-			}
+		float fT = 10000000000.0f;
+		if ( entity->Shape.RayIntersection( ObjectRay, &fT ) )
+		{
+			PickRecord Record;
+			Record.pEntity = entity;
+			Record.fDistance = fT;
+			record.push_back( Record );
 		}
-		//else
-		//{
-		//	IntrRay3fSphere3f Intersector( ray, GetWorldBoundingSphere() );
-		//	if ( Intersector.Find() )
-		//	{
-		//		PickRecord Record;
-
-		//		Record.pEntity = this;
-		//		Record.fDistance = min( Intersector.m_afRayT[0], Intersector.m_afRayT[1] ); 
-		//		
-		//		record.push_back( Record );
-		//	}
-		//}
 	}
 }
 //--------------------------------------------------------------------------------
@@ -16,6 +16,9 @@
 #include "Node3D.h"
 #include "Log.h"
 #include "BoundsVisualizerActor.h"
+#include "RenderQueue.h"
+#include "Frustum3f.h"
+#include "Scene.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
@@ -23,7 +26,10 @@ SceneRenderTask::SceneRenderTask( ) :
 	m_pEntity( nullptr ),
 	m_pScene( nullptr ),
 	m_bDebugViewEnabled( false ),
+	m_bCullingEnabled( true ),
+	m_fCullDistance( 0.0f ),
 	m_pDebugVisualizer( new BoundsVisualizerActor() ),
+	m_pRenderQueue( new RenderQueue() ),
 	m_iViewports(),
 	m_uiViewportCount( 1 ),
 	ViewMatrix(),
@@ -41,6 +47,7 @@ SceneRenderTask::SceneRenderTask( ) :
 SceneRenderTask::~SceneRenderTask( )
 {
 	SAFE_DELETE( m_pDebugVisualizer );
+	SAFE_DELETE( m_pRenderQueue );
 }
 //--------------------------------------------------------------------------------
 void SceneRenderTask::SetRenderParams( IParameterManager* pParamManager )
@@ -150,4 +157,57 @@ bool SceneRenderTask::IsDebugViewEnabled()
 {
 	return( m_bDebugViewEnabled );
 }
-//--------------------------------------------------------------------------------
\ No newline at end of file
+//--------------------------------------------------------------------------------
+void SceneRenderTask::SetCullingEnabled( bool enable )
+{
+	m_bCullingEnabled = enable;
+}
+//--------------------------------------------------------------------------------
+bool SceneRenderTask::IsCullingEnabled()
+{
+	return( m_bCullingEnabled );
+}
+//--------------------------------------------------------------------------------
+void SceneRenderTask::SetCullDistance( float distance )
+{
+	m_fCullDistance = distance;
+}
+//--------------------------------------------------------------------------------
+float SceneRenderTask::GetCullDistance()
+{
+	return( m_fCullDistance );
+}
+//--------------------------------------------------------------------------------
+const CullStatistics& SceneRenderTask::GetCullStatistics()
+{
+	return( m_pRenderQueue->GetStatistics() );
+}
+//--------------------------------------------------------------------------------
+const RenderQueue& SceneRenderTask::GetRenderQueue()
+{
+	return( *m_pRenderQueue );
+}
+//--------------------------------------------------------------------------------
+void SceneRenderTask::RenderScene( PipelineManagerDX11* pPipelineManager, IParameterManager* pParamManager, VIEWTYPE view )
+{
+	Frustum3f frustum( ViewMatrix * ProjMatrix );
+
+	// The cull distance replaces the far plane with one at that depth in view
+	// space, which is -z_view + distance >= 0 written in world coordinates.
+
+	if ( m_fCullDistance > 0.0f )
+	{
+		Plane3f& farPlane = frustum.planes[5];
+		farPlane.a = -ViewMatrix(0,2);
+		farPlane.b = -ViewMatrix(1,2);
+		farPlane.c = -ViewMatrix(2,2);
+		farPlane.d = m_fCullDistance - ViewMatrix(3,2);
+		farPlane.Normalize();
+	}
+
+	m_pRenderQueue->Clear();
+	m_pRenderQueue->Add( m_pScene->GetRoot(), view, ViewMatrix, m_bCullingEnabled ? &frustum : nullptr );
+	m_pRenderQueue->Sort();
+	m_pRenderQueue->Render( pPipelineManager, pParamManager, view );
+}
+//--------------------------------------------------------------------------------
@@ -19,6 +19,7 @@ ShaderDX11::ShaderDX11() :
 	Function(),
 	ShaderModel(),
 	ShaderText(),
+	HasDefines( false ),
 	m_pCompiledShader( nullptr ),
 	m_pReflection( nullptr )
 {
@@ -65,9 +65,12 @@ void ShaderReflectionDX11::InitializeConstantBuffers( IParameterManager* pParamM
 			{
 				// Here we create one constant buffer for each thread that could potentially
 				// be rendering, and then set each one accordingly within the parameter 
-				// reference that we have for this buffer.
+				// reference that we have for this buffer.  Only the payloads that the
+				// renderer created can render, which may be fewer than NUM_THREADS.
 
-				for ( int thread = 0; thread < NUM_THREADS + 1; thread++ )
+				const unsigned int threads = RendererDX11::Get()->GetPayloadCount() + 1;
+
+				for ( unsigned int thread = 0; thread < threads; thread++ )
 				{
 					// Configure the buffer for the needed size and dynamic updating.
 					BufferConfigDX11 cbuffer;
@@ -179,7 +182,7 @@ void ShaderReflectionDX11::UpdateParameters( PipelineManagerDX11* pPipeline, IPa
 				// This section of the code should never be reached anymore - all CBs should
 				// be initially created when a shader is compiled if it doesn't already exist.
 				// If we do end up here, send a message about it!
-				Log::Get().Write( L"Uh oh - creating a constant buffer in the ShaderDX11::UpdateParameters functions!!!!" );
+				Log::Get().Write( L"Uh oh - creating a constant buffer in the ShaderDX11::UpdateParameters functions!!!!", LOG_WARNING );
 
 				// Configure the buffer for the needed size and dynamic updating.
 				BufferConfigDX11 cbuffer;
@@ -211,7 +214,7 @@ void ShaderReflectionDX11::UpdateParameters( PipelineManagerDX11* pPipeline, IPa
 				}
 
 			} else {
-				Log::Get().Write( L"Trying to update a constant buffer that isn't a constant buffer!" );
+				Log::Get().Write( L"Trying to update a constant buffer that isn't a constant buffer!", LOG_WARNING );
 			}
 		}
 	}
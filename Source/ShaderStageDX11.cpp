@@ -20,7 +20,8 @@ static void SetToNull( void* pArray, int num )
     memset( pArray, 0, num * ptrSize );
 }
 //--------------------------------------------------------------------------------
-ShaderStageDX11::ShaderStageDX11()
+ShaderStageDX11::ShaderStageDX11() :
+	m_pContext1( nullptr )
 {
 	// Link the two states together to monitor their changes.
 	DesiredState.SetSisterState( &CurrentState );
@@ -36,6 +37,11 @@ void ShaderStageDX11::SetFeatureLevel( D3D_FEATURE_LEVEL level )
 	m_FeatureLevel = level;
 }
 //--------------------------------------------------------------------------------
+void ShaderStageDX11::EnableConstantBufferOffsets( ID3D11DeviceContext1* pContext )
+{
+	m_pContext1 = pContext;
+}
+//--------------------------------------------------------------------------------
 void ShaderStageDX11::ClearDesiredState( )
 {
 	DesiredState.ClearState();
@@ -57,7 +63,7 @@ void ShaderStageDX11::ApplyDesiredState( ID3D11DeviceContext* pContext )
 	}
 
 	// Compare the constant buffer state and set it if necesary.
-	if ( DesiredState.ConstantBuffers.IsUpdateNeeded() ) {
+	if ( DesiredState.IsConstantBufferUpdateNeeded() ) {
 		BindConstantBuffers( pContext, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT-1 );
 	}
 
@@ -80,9 +86,9 @@ void ShaderStageDX11::ApplyDesiredState( ID3D11DeviceContext* pContext )
 			BindUnorderedAccessViews( pContext, D3D11_PS_CS_UAV_REGISTER_COUNT-1 );
 	}
 
-	// After binding everything, set the current state to the desired state.
+	// After binding everything, copy the slots that were bound into the current
+	// state.  Anything that wasn't marked already matches it.
 	
-	DesiredState.ResetUpdateFlags();
-	CurrentState = DesiredState;
+	DesiredState.CommitToSister();
 }
 //--------------------------------------------------------------------------------
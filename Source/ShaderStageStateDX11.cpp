@@ -17,6 +17,8 @@ using namespace Glyph3;
 ShaderStageStateDX11::ShaderStageStateDX11() : 
 	ShaderProgram( -1 ),
 	ConstantBuffers( nullptr ),
+	ConstantBufferOffsets( 0 ),
+	ConstantBufferSizes( D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT ),
 	SamplerStates( nullptr ),
 	ShaderResourceViews( nullptr ),
 	UnorderedAccessViews( nullptr ),
@@ -40,6 +42,8 @@ void ShaderStageStateDX11::ClearState()
 {
 	ShaderProgram.InitializeState();
 	ConstantBuffers.InitializeStates();
+	ConstantBufferOffsets.InitializeStates();
+	ConstantBufferSizes.InitializeStates();
 	SamplerStates.InitializeStates();
 	ShaderResourceViews.InitializeStates();
 	UnorderedAccessViews.InitializeStates();
@@ -51,6 +55,8 @@ void ShaderStageStateDX11::SetSisterState( ShaderStageStateDX11* pState )
 	m_pSisterState = pState;
 	ShaderProgram.SetSister( &m_pSisterState->ShaderProgram );
 	ConstantBuffers.SetSister( &m_pSisterState->ConstantBuffers );
+	ConstantBufferOffsets.SetSister( &m_pSisterState->ConstantBufferOffsets );
+	ConstantBufferSizes.SetSister( &m_pSisterState->ConstantBufferSizes );
 	SamplerStates.SetSister( &m_pSisterState->SamplerStates );
 	ShaderResourceViews.SetSister( &m_pSisterState->ShaderResourceViews );
 	UnorderedAccessViews.SetSister( &m_pSisterState->UnorderedAccessViews );
@@ -61,9 +67,63 @@ void ShaderStageStateDX11::ResetUpdateFlags( )
 {
 	ShaderProgram.ResetTracking();
 	ConstantBuffers.ResetTracking();
+	ConstantBufferOffsets.ResetTracking();
+	ConstantBufferSizes.ResetTracking();
 	SamplerStates.ResetTracking();
 	ShaderResourceViews.ResetTracking();
 	UnorderedAccessViews.ResetTracking();
 	UAVInitialCounts.ResetTracking();
 }
+//--------------------------------------------------------------------------------
+void ShaderStageStateDX11::CommitToSister( )
+{
+	ShaderProgram.CommitToSister();
+	ConstantBuffers.CommitToSister();
+	ConstantBufferOffsets.CommitToSister();
+	ConstantBufferSizes.CommitToSister();
+	SamplerStates.CommitToSister();
+	ShaderResourceViews.CommitToSister();
+	UnorderedAccessViews.CommitToSister();
+	UAVInitialCounts.CommitToSister();
+}
+//--------------------------------------------------------------------------------
+bool ShaderStageStateDX11::IsConstantBufferUpdateNeeded( ) const
+{
+	return( ConstantBuffers.IsUpdateNeeded()
+		|| ConstantBufferOffsets.IsUpdateNeeded()
+		|| ConstantBufferSizes.IsUpdateNeeded() );
+}
+//--------------------------------------------------------------------------------
+bool ShaderStageStateDX11::GetNextConstantBufferRange( unsigned int& start, unsigned int& count ) const
+{
+	const unsigned int slots = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT;
+
+	unsigned int first = start;
+
+	while ( first < slots && !ConstantBuffers.IsSlotUpdateNeeded( first )
+		&& !ConstantBufferOffsets.IsSlotUpdateNeeded( first )
+		&& !ConstantBufferSizes.IsSlotUpdateNeeded( first ) )
+		first++;
+
+	if ( first >= slots )
+		return( false );
+
+	// The following changed slots are merged in the same way as GetNextRange
+	// merges them for a single array.
+
+	unsigned int last = first;
+
+	for ( unsigned int slot = first + 1; slot < slots && slot - last - 1 <= ConstantBuffers.MergeDistance; slot++ )
+	{
+		if ( ConstantBuffers.IsSlotUpdateNeeded( slot )
+			|| ConstantBufferOffsets.IsSlotUpdateNeeded( slot )
+			|| ConstantBufferSizes.IsSlotUpdateNeeded( slot ) )
+			last = slot;
+	}
+
+	start = first;
+	count = last - first + 1;
+
+	return( true );
+}
 //--------------------------------------------------------------------------------
\ No newline at end of file
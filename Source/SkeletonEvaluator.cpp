@@ -0,0 +1,470 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "SkeletonEvaluator.h"
+#include "Matrix3f.h"
+#include <float.h>
+#if GLYPH_SSE_MATH
+#include <emmintrin.h>
+#endif
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+#if GLYPH_SSE_MATH
+//--------------------------------------------------------------------------------
+#define GLYPH_SHUFFLE( v1, v2, x, y, z, w ) _mm_shuffle_ps( v1, v2, _MM_SHUFFLE( w, z, y, x ) )
+#define GLYPH_SWIZZLE( v, x, y, z, w ) GLYPH_SHUFFLE( v, v, x, y, z, w )
+//--------------------------------------------------------------------------------
+static inline __m128 SelectSSE( __m128 mask, __m128 a, __m128 b )
+{
+	// Takes the lanes of a where the mask is set, and the lanes of b elsewhere.
+	return( _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) ) );
+}
+//--------------------------------------------------------------------------------
+static inline void SinCosSSE( __m128 angle, __m128& sine, __m128& cosine )
+{
+	// The angle is reduced to [-pi,pi], and then reflected into [-pi/2,pi/2],
+	// where minimax polynomials of degree 11 and 10 are accurate to about one
+	// unit in the last place.  These are the same approximations that are used
+	// by XMVectorSinCos.
+
+	const __m128 twoPi = _mm_set1_ps( 6.283185307f );
+	const __m128 pi = _mm_set1_ps( 3.141592654f );
+	const __m128 halfPi = _mm_set1_ps( 1.570796327f );
+	const __m128 signBit = _mm_set1_ps( -0.0f );
+	const __m128 one = _mm_set1_ps( 1.0f );
+
+	__m128 quotient = _mm_cvtepi32_ps( _mm_cvtps_epi32( _mm_mul_ps( angle, _mm_set1_ps( 0.159154943f ) ) ) );
+	__m128 x = _mm_sub_ps( angle, _mm_mul_ps( twoPi, quotient ) );
+
+	// Reflect the angles beyond pi/2 around +/-pi/2, which flips the cosine.
+	__m128 xSign = _mm_and_ps( x, signBit );
+	__m128 reflected = _mm_sub_ps( _mm_or_ps( pi, xSign ), x );
+	__m128 beyond = _mm_cmpgt_ps( _mm_andnot_ps( signBit, x ), halfPi );
+
+	x = SelectSSE( beyond, reflected, x );
+	__m128 sign = SelectSSE( beyond, _mm_set1_ps( -1.0f ), one );
+
+	__m128 x2 = _mm_mul_ps( x, x );
+
+	__m128 s = _mm_set1_ps( -2.3889859e-08f );
+	s = _mm_add_ps( _mm_mul_ps( s, x2 ), _mm_set1_ps( 2.7525562e-06f ) );
+	s = _mm_add_ps( _mm_mul_ps( s, x2 ), _mm_set1_ps( -0.00019840874f ) );
+	s = _mm_add_ps( _mm_mul_ps( s, x2 ), _mm_set1_ps( 0.0083333310f ) );
+	s = _mm_add_ps( _mm_mul_ps( s, x2 ), _mm_set1_ps( -0.16666667f ) );
+	s = _mm_add_ps( _mm_mul_ps( s, x2 ), one );
+	sine = _mm_mul_ps( s, x );
+
+	__m128 c = _mm_set1_ps( -2.6051615e-07f );
+	c = _mm_add_ps( _mm_mul_ps( c, x2 ), _mm_set1_ps( 2.4760495e-05f ) );
+	c = _mm_add_ps( _mm_mul_ps( c, x2 ), _mm_set1_ps( -0.0013888378f ) );
+	c = _mm_add_ps( _mm_mul_ps( c, x2 ), _mm_set1_ps( 0.041666638f ) );
+	c = _mm_add_ps( _mm_mul_ps( c, x2 ), _mm_set1_ps( -0.5f ) );
+	c = _mm_add_ps( _mm_mul_ps( c, x2 ), one );
+	cosine = _mm_mul_ps( c, sign );
+}
+//--------------------------------------------------------------------------------
+static inline void StoreRowsSSE( __m128 a, __m128 b, __m128 c, __m128 d, Matrix4f* pMatrices, int row )
+{
+	// The inputs hold one entry of the row for four bones each, so the transpose
+	// turns them into the rows of the four matrices.
+
+	_MM_TRANSPOSE4_PS( a, b, c, d );
+
+	_mm_storeu_ps( reinterpret_cast<float*>( &pMatrices[0] ) + 4 * row, a );
+	_mm_storeu_ps( reinterpret_cast<float*>( &pMatrices[1] ) + 4 * row, b );
+	_mm_storeu_ps( reinterpret_cast<float*>( &pMatrices[2] ) + 4 * row, c );
+	_mm_storeu_ps( reinterpret_cast<float*>( &pMatrices[3] ) + 4 * row, d );
+}
+//--------------------------------------------------------------------------------
+static inline __m128 CrossSSE( __m128 a, __m128 b )
+{
+	// The w lane of the result is always zero.
+	return( _mm_sub_ps( _mm_mul_ps( GLYPH_SWIZZLE( a, 1, 2, 0, 3 ), GLYPH_SWIZZLE( b, 2, 0, 1, 3 ) ),
+		_mm_mul_ps( GLYPH_SWIZZLE( a, 2, 0, 1, 3 ), GLYPH_SWIZZLE( b, 1, 2, 0, 3 ) ) ) );
+}
+//--------------------------------------------------------------------------------
+static inline void AffineInverseTransposeSSE( const float* pIn, float* pOut )
+{
+	// For an affine matrix with the upper 3x3 block A and the translation t, the
+	// inverse transpose is
+	//
+	//     | inv(A)^T   -inv(A)^T t^T |
+	//     |    0             1       |
+	//
+	// and the rows of inv(A)^T are the cross products of the rows of A, divided
+	// by the determinant.
+
+	__m128 r0 = _mm_loadu_ps( pIn + 0 );
+	__m128 r1 = _mm_loadu_ps( pIn + 4 );
+	__m128 r2 = _mm_loadu_ps( pIn + 8 );
+
+	__m128 c0 = CrossSSE( r1, r2 );
+	__m128 c1 = CrossSSE( r2, r0 );
+	__m128 c2 = CrossSSE( r0, r1 );
+
+	__m128 products = _mm_mul_ps( r0, c0 );
+	__m128 det = _mm_add_ps( products, GLYPH_SWIZZLE( products, 1, 2, 0, 3 ) );
+	det = _mm_add_ps( det, GLYPH_SWIZZLE( products, 2, 0, 1, 3 ) );
+	__m128 rDet = _mm_div_ps( _mm_set1_ps( 1.0f ), GLYPH_SWIZZLE( det, 0, 0, 0, 0 ) );
+
+	_mm_storeu_ps( pOut + 0, _mm_mul_ps( c0, rDet ) );
+	_mm_storeu_ps( pOut + 4, _mm_mul_ps( c1, rDet ) );
+	_mm_storeu_ps( pOut + 8, _mm_mul_ps( c2, rDet ) );
+	_mm_storeu_ps( pOut + 12, _mm_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f ) );
+
+	for ( int i = 0; i < 3; i++ )
+		pOut[4*i+3] = -( pOut[4*i+0] * pIn[12] + pOut[4*i+1] * pIn[13] + pOut[4*i+2] * pIn[14] );
+}
+//--------------------------------------------------------------------------------
+static inline __m128 SkinVertexSSE( const Matrix4f* pPalette, unsigned int paletteSize, const Vector3f& v,
+									const unsigned int* pBones, const float* pWeights, unsigned int influences,
+									bool bPoint )
+{
+	const __m128 x = _mm_set1_ps( v.x );
+	const __m128 y = _mm_set1_ps( v.y );
+	const __m128 z = _mm_set1_ps( v.z );
+
+	__m128 result = _mm_setzero_ps();
+
+	for ( unsigned int i = 0; i < influences; i++ )
+	{
+		const float weight = pWeights ? pWeights[i] : 1.0f;
+
+		if ( pBones[i] >= paletteSize || weight == 0.0f )
+			continue;
+
+		const float* pMatrix = reinterpret_cast<const float*>( &pPalette[pBones[i]] );
+
+		__m128 transformed = _mm_mul_ps( x, _mm_loadu_ps( pMatrix + 0 ) );
+		transformed = _mm_add_ps( transformed, _mm_mul_ps( y, _mm_loadu_ps( pMatrix + 4 ) ) );
+		transformed = _mm_add_ps( transformed, _mm_mul_ps( z, _mm_loadu_ps( pMatrix + 8 ) ) );
+
+		if ( bPoint )
+			transformed = _mm_add_ps( transformed, _mm_loadu_ps( pMatrix + 12 ) );
+
+		result = _mm_add_ps( result, _mm_mul_ps( _mm_set1_ps( weight ), transformed ) );
+	}
+
+	return( result );
+}
+//--------------------------------------------------------------------------------
+static void SkinVerticesSSE( const Matrix4f* pPalette, unsigned int paletteSize, const Vector3f* pIn,
+							const unsigned int* pBones, const float* pWeights, unsigned int influences,
+							Vector3f* pOut, unsigned int count, bool bPoint )
+{
+	for ( unsigned int i = 0; i < count; i++ )
+	{
+		__m128 result = SkinVertexSSE( pPalette, paletteSize, pIn[i], pBones + i * influences,
+			pWeights ? pWeights + i * influences : nullptr, influences, bPoint );
+
+		// Vector3f is only 12 bytes, so the result is stored one lane at a time.
+		_mm_store_ss( &pOut[i].x, result );
+		_mm_store_ss( &pOut[i].y, GLYPH_SWIZZLE( result, 1, 1, 1, 1 ) );
+		_mm_store_ss( &pOut[i].z, GLYPH_SWIZZLE( result, 2, 2, 2, 2 ) );
+	}
+}
+//--------------------------------------------------------------------------------
+#else
+//--------------------------------------------------------------------------------
+static Vector3f SkinVertex( const Matrix4f* pPalette, unsigned int paletteSize, const Vector3f& v,
+							const unsigned int* pBones, const float* pWeights, unsigned int influences,
+							bool bPoint )
+{
+	Vector3f result( 0.0f, 0.0f, 0.0f );
+
+	for ( unsigned int i = 0; i < influences; i++ )
+	{
+		const float weight = pWeights ? pWeights[i] : 1.0f;
+
+		if ( pBones[i] >= paletteSize || weight == 0.0f )
+			continue;
+
+		const Matrix4f& m = pPalette[pBones[i]];
+
+		for ( int iCol = 0; iCol < 3; iCol++ )
+		{
+			float value = bPoint ? m( 3, iCol ) : 0.0f;
+
+			for ( int iRow = 0; iRow < 3; iRow++ )
+				value += m( iRow, iCol ) * v[iRow];
+
+			result[iCol] += weight * value;
+		}
+	}
+
+	return( result );
+}
+//--------------------------------------------------------------------------------
+#endif // GLYPH_SSE_MATH
+//--------------------------------------------------------------------------------
+SkeletonEvaluator::SkeletonEvaluator() :
+	m_uiBoneCount( 0 )
+{
+}
+//--------------------------------------------------------------------------------
+SkeletonEvaluator::~SkeletonEvaluator()
+{
+}
+//--------------------------------------------------------------------------------
+bool SkeletonEvaluator::SetParents( const std::vector<int>& parents )
+{
+	const unsigned int count = static_cast<unsigned int>( parents.size() );
+
+	// Order the bones breadth first from the roots, so that every parent comes
+	// before its children.
+
+	std::vector<std::vector<unsigned int>> children( count );
+	std::vector<unsigned int> order;
+	order.reserve( count );
+
+	for ( unsigned int i = 0; i < count; i++ )
+	{
+		if ( parents[i] < 0 )
+			order.push_back( i );
+		else if ( static_cast<unsigned int>( parents[i] ) < count )
+			children[parents[i]].push_back( i );
+		else
+			return( false );
+	}
+
+	for ( unsigned int i = 0; i < order.size(); i++ )
+		order.insert( order.end(), children[order[i]].begin(), children[order[i]].end() );
+
+	// Any bone that wasn't reached is part of a cycle.
+
+	if ( order.size() != count )
+		return( false );
+
+	const unsigned int padded = ( count + 3 ) & ~3;
+
+	m_uiBoneCount = count;
+	m_Parents = parents;
+	m_Order.swap( order );
+
+	m_PositionX.assign( padded, 0.0f );
+	m_PositionY.assign( padded, 0.0f );
+	m_PositionZ.assign( padded, 0.0f );
+	m_RotationX.assign( padded, 0.0f );
+	m_RotationY.assign( padded, 0.0f );
+	m_RotationZ.assign( padded, 0.0f );
+	m_ScaleX.assign( padded, 1.0f );
+	m_ScaleY.assign( padded, 1.0f );
+	m_ScaleZ.assign( padded, 1.0f );
+
+	m_InverseBindPoses.assign( count, Matrix4f::Identity() );
+	m_LocalPoses.assign( padded, Matrix4f::Identity() );
+	m_GlobalPoses.assign( count, Matrix4f::Identity() );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+unsigned int SkeletonEvaluator::GetBoneCount( ) const
+{
+	return( m_uiBoneCount );
+}
+//--------------------------------------------------------------------------------
+void SkeletonEvaluator::SetLocalPose( unsigned int bone, const Vector3f& position, const Vector3f& rotation,
+									 const Vector3f& scale )
+{
+	assert( bone < m_uiBoneCount );
+
+	m_PositionX[bone] = position.x;
+	m_PositionY[bone] = position.y;
+	m_PositionZ[bone] = position.z;
+	m_RotationX[bone] = rotation.x;
+	m_RotationY[bone] = rotation.y;
+	m_RotationZ[bone] = rotation.z;
+	m_ScaleX[bone] = scale.x;
+	m_ScaleY[bone] = scale.y;
+	m_ScaleZ[bone] = scale.z;
+}
+//--------------------------------------------------------------------------------
+void SkeletonEvaluator::SetInverseBindPose( unsigned int bone, const Matrix4f& inverse )
+{
+	assert( bone < m_uiBoneCount );
+
+	m_InverseBindPoses[bone] = inverse;
+}
+//--------------------------------------------------------------------------------
+const Matrix4f& SkeletonEvaluator::GetGlobalPose( unsigned int bone ) const
+{
+	return( m_GlobalPoses[bone] );
+}
+//--------------------------------------------------------------------------------
+void SkeletonEvaluator::BuildLocalPoses( )
+{
+	// Each local matrix is Scale * Rotation * Translation, with the rotation in
+	// the Z, X, Y order of Matrix3f::Rotation.  Expanded, the rows are
+	//
+	//     sx * ( cz cy + sz sx' sy,  sz cx,  sz sx' cy - cz sy )
+	//     sy * ( cz sx' sy - sz cy,  cz cx,  sz sy + cz sx' cy )
+	//     sz * ( cx sy,              -sx',   cx cy )
+	//     ( tx, ty, tz, 1 )
+	//
+	// where sx' is the sine of the x angle, and sx is the x scale.
+
+#if GLYPH_SSE_MATH
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps( 1.0f );
+
+	for ( unsigned int i = 0; i < m_LocalPoses.size(); i += 4 )
+	{
+		__m128 sinX, cosX, sinY, cosY, sinZ, cosZ;
+		SinCosSSE( _mm_loadu_ps( &m_RotationX[i] ), sinX, cosX );
+		SinCosSSE( _mm_loadu_ps( &m_RotationY[i] ), sinY, cosY );
+		SinCosSSE( _mm_loadu_ps( &m_RotationZ[i] ), sinZ, cosZ );
+
+		const __m128 sinZsinX = _mm_mul_ps( sinZ, sinX );
+		const __m128 cosZsinX = _mm_mul_ps( cosZ, sinX );
+
+		__m128 scale = _mm_loadu_ps( &m_ScaleX[i] );
+		__m128 e0 = _mm_mul_ps( scale, _mm_add_ps( _mm_mul_ps( cosZ, cosY ), _mm_mul_ps( sinZsinX, sinY ) ) );
+		__m128 e1 = _mm_mul_ps( scale, _mm_mul_ps( sinZ, cosX ) );
+		__m128 e2 = _mm_mul_ps( scale, _mm_sub_ps( _mm_mul_ps( sinZsinX, cosY ), _mm_mul_ps( cosZ, sinY ) ) );
+		StoreRowsSSE( e0, e1, e2, zero, &m_LocalPoses[i], 0 );
+
+		scale = _mm_loadu_ps( &m_ScaleY[i] );
+		e0 = _mm_mul_ps( scale, _mm_sub_ps( _mm_mul_ps( cosZsinX, sinY ), _mm_mul_ps( sinZ, cosY ) ) );
+		e1 = _mm_mul_ps( scale, _mm_mul_ps( cosZ, cosX ) );
+		e2 = _mm_mul_ps( scale, _mm_add_ps( _mm_mul_ps( sinZ, sinY ), _mm_mul_ps( cosZsinX, cosY ) ) );
+		StoreRowsSSE( e0, e1, e2, zero, &m_LocalPoses[i], 1 );
+
+		scale = _mm_loadu_ps( &m_ScaleZ[i] );
+		e0 = _mm_mul_ps( scale, _mm_mul_ps( cosX, sinY ) );
+		e1 = _mm_mul_ps( scale, _mm_sub_ps( zero, sinX ) );
+		e2 = _mm_mul_ps( scale, _mm_mul_ps( cosX, cosY ) );
+		StoreRowsSSE( e0, e1, e2, zero, &m_LocalPoses[i], 2 );
+
+		StoreRowsSSE( _mm_loadu_ps( &m_PositionX[i] ), _mm_loadu_ps( &m_PositionY[i] ),
+			_mm_loadu_ps( &m_PositionZ[i] ), one, &m_LocalPoses[i], 3 );
+	}
+#else
+	for ( unsigned int i = 0; i < m_uiBoneCount; i++ )
+	{
+		Vector3f rotation( m_RotationX[i], m_RotationY[i], m_RotationZ[i] );
+
+		Matrix3f rot;
+		rot.Rotation( rotation );
+
+		Matrix4f& local = m_LocalPoses[i];
+		local.MakeIdentity();
+		local.SetRotation( rot );
+		local.SetTranslation( Vector3f( m_PositionX[i], m_PositionY[i], m_PositionZ[i] ) );
+		local = Matrix4f::ScaleMatrixXYZ( m_ScaleX[i], m_ScaleY[i], m_ScaleZ[i] ) * local;
+	}
+#endif
+}
+//--------------------------------------------------------------------------------
+void SkeletonEvaluator::Evaluate( const Matrix4f& root, Matrix4f* pSkinMatrices, Matrix4f* pNormalMatrices )
+{
+	BuildLocalPoses();
+
+	// The parents are always visited before their children, so each global pose
+	// only needs a single multiplication.
+
+	for ( auto bone : m_Order )
+	{
+		const int parent = m_Parents[bone];
+
+		m_GlobalPoses[bone] = m_LocalPoses[bone] * ( parent < 0 ? root : m_GlobalPoses[parent] );
+	}
+
+	for ( unsigned int i = 0; i < m_uiBoneCount; i++ )
+	{
+		pSkinMatrices[i] = m_InverseBindPoses[i] * m_GlobalPoses[i];
+
+		if ( pNormalMatrices )
+		{
+#if GLYPH_SSE_MATH
+			AffineInverseTransposeSSE( reinterpret_cast<const float*>( &pSkinMatrices[i] ),
+				reinterpret_cast<float*>( &pNormalMatrices[i] ) );
+#else
+			pNormalMatrices[i] = pSkinMatrices[i].Inverse().Transpose();
+#endif
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+void SkeletonEvaluator::SkinPoints( const Matrix4f* pPalette, unsigned int paletteSize,
+									const Vector3f* pIn, const unsigned int* pBones, const float* pWeights,
+									unsigned int influences, Vector3f* pOut, unsigned int count )
+{
+#if GLYPH_SSE_MATH
+	SkinVerticesSSE( pPalette, paletteSize, pIn, pBones, pWeights, influences, pOut, count, true );
+#else
+	for ( unsigned int i = 0; i < count; i++ )
+		pOut[i] = SkinVertex( pPalette, paletteSize, pIn[i], pBones + i * influences,
+			pWeights ? pWeights + i * influences : nullptr, influences, true );
+#endif
+}
+//--------------------------------------------------------------------------------
+void SkeletonEvaluator::SkinDirections( const Matrix4f* pPalette, unsigned int paletteSize,
+										const Vector3f* pIn, const unsigned int* pBones, const float* pWeights,
+										unsigned int influences, Vector3f* pOut, unsigned int count )
+{
+#if GLYPH_SSE_MATH
+	SkinVerticesSSE( pPalette, paletteSize, pIn, pBones, pWeights, influences, pOut, count, false );
+#else
+	for ( unsigned int i = 0; i < count; i++ )
+		pOut[i] = SkinVertex( pPalette, paletteSize, pIn[i], pBones + i * influences,
+			pWeights ? pWeights + i * influences : nullptr, influences, false );
+#endif
+}
+//--------------------------------------------------------------------------------
+bool SkeletonEvaluator::SkinBounds( const Matrix4f* pPalette, unsigned int paletteSize,
+									const Vector3f* pIn, const unsigned int* pBones, const float* pWeights,
+									unsigned int influences, unsigned int count, Vector3f& mins, Vector3f& maxs )
+{
+	if ( count == 0 )
+		return( false );
+
+#if GLYPH_SSE_MATH
+	__m128 lower = _mm_set1_ps( FLT_MAX );
+	__m128 upper = _mm_set1_ps( -FLT_MAX );
+
+	for ( unsigned int i = 0; i < count; i++ )
+	{
+		__m128 p = SkinVertexSSE( pPalette, paletteSize, pIn[i], pBones + i * influences,
+			pWeights ? pWeights + i * influences : nullptr, influences, true );
+
+		lower = _mm_min_ps( lower, p );
+		upper = _mm_max_ps( upper, p );
+	}
+
+	float lowerValues[4];
+	float upperValues[4];
+	_mm_storeu_ps( lowerValues, lower );
+	_mm_storeu_ps( upperValues, upper );
+
+	mins = Vector3f( lowerValues[0], lowerValues[1], lowerValues[2] );
+	maxs = Vector3f( upperValues[0], upperValues[1], upperValues[2] );
+#else
+	mins = Vector3f( FLT_MAX, FLT_MAX, FLT_MAX );
+	maxs = Vector3f( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+
+	for ( unsigned int i = 0; i < count; i++ )
+	{
+		Vector3f p = SkinVertex( pPalette, paletteSize, pIn[i], pBones + i * influences,
+			pWeights ? pWeights + i * influences : nullptr, influences, true );
+
+		for ( int j = 0; j < 3; j++ )
+		{
+			mins[j] = std::min( mins[j], p[j] );
+			maxs[j] = std::max( maxs[j], p[j] );
+		}
+	}
+#endif
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
@@ -16,6 +16,8 @@
 #include "GeometryGeneratorDX11.h"
 #include "MaterialGeneratorDX11.h"
 #include "MatrixArrayParameterWriterDX11.h"
+#include "JobSystem.h"
+#include "Profiler.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
@@ -23,6 +25,7 @@ SkinnedActor::SkinnedActor()
 {
 	m_pMatrices = 0;
 	m_pNormalMatrices = 0;
+	m_pSkeletonRoot = 0;
 
 	m_pGeometryEntity = new Entity3D();
 }
@@ -115,16 +118,100 @@ void SkinnedActor::SetBindPose( )
 	GetBody()->Parameters.SetMatrixArrayParameter( L"SkinMatrices", m_pMatrices, m_Bones.size() );
 	GetBody()->Parameters.SetMatrixArrayParameter( L"SkinNormalMatrices", m_pNormalMatrices, m_Bones.size() );
 
+	// Describe the skeleton to the evaluator.  The parent of each bone is found
+	// among the other bones, and the root bones must all share the same parent
+	// node, whose world matrix is then used as the root of the skeleton.
+
+	std::map<Node3D*, int> indices;
+
+	for ( unsigned int i = 0; i < m_Bones.size(); i++ )
+		indices[m_Bones[i]->GetEntity()] = static_cast<int>( i );
+
+	std::vector<int> parents( m_Bones.size(), -1 );
+	bool bShared = true;
+
+	m_pSkeletonRoot = 0;
+
+	for ( unsigned int i = 0; i < m_Bones.size(); i++ )
+	{
+		Node3D* pParent = m_Bones[i]->GetEntity()->GetParent();
+		auto parent = indices.find( pParent );
+
+		if ( parent != indices.end() )
+			parents[i] = parent->second;
+		else if ( m_pSkeletonRoot == 0 || m_pSkeletonRoot == pParent )
+			m_pSkeletonRoot = pParent;
+		else
+			bShared = false;
+	}
+
+	if ( !bShared || m_pSkeletonRoot == 0 || !m_Skeleton.SetParents( parents ) )
+	{
+		m_pSkeletonRoot = 0;
+		return;
+	}
+
+	for ( unsigned int i = 0; i < m_Bones.size(); i++ )
+		m_Skeleton.SetInverseBindPose( i, m_Bones[i]->GetInverseBindPose() );
 }
 //--------------------------------------------------------------------------------
-void SkinnedActor::SetSkinningMatrices( RendererDX11& Renderer )
+void SkinnedActor::UpdateSkinningMatrices( )
 {
-	// Update the CPU side animation matrices.
+	if ( m_pMatrices == 0 )
+		return;
+
+	if ( m_pSkeletonRoot == 0 )
+	{
+		for ( unsigned int i = 0; i < m_Bones.size(); i++ )
+		{
+			m_pMatrices[i] = m_Bones[i]->GetTransform();
+			m_pNormalMatrices[i] = m_Bones[i]->GetNormalTransform();
+		}
+
+		return;
+	}
+
+	// Gather the animated pose of each bone, and evaluate the whole skeleton in
+	// one batch.
+
 	for ( unsigned int i = 0; i < m_Bones.size(); i++ )
 	{
-		m_pMatrices[i] = m_Bones[i]->GetTransform();
-		m_pNormalMatrices[i] = m_Bones[i]->GetNormalTransform();
+		SkinnedBoneController<Node3D>* pController = m_Bones[i];
+
+		m_Skeleton.SetLocalPose( i, pController->GetPosition(), pController->GetRotation(),
+			pController->GetEntity()->Transform.Scale() );
 	}
+
+	m_Skeleton.Evaluate( m_pSkeletonRoot->Transform.WorldMatrix(), m_pMatrices, m_pNormalMatrices );
+}
+//--------------------------------------------------------------------------------
+void SkinnedActor::SetSkinningMatrices( RendererDX11& Renderer )
+{
+	GLYPH_PROFILE_SCOPE( "SkinnedActor::SetSkinningMatrices" );
+
+	UpdateSkinningMatrices();
+}
+//--------------------------------------------------------------------------------
+void SkinnedActor::SetSkinningMatrices( const std::vector<SkinnedActor*>& actors )
+{
+	GLYPH_PROFILE_SCOPE( "SkinnedActor::SetSkinningMatrices" );
+
+	// The actors don't share any state, so they are split across the job system
+	// in batches.
+
+	auto UpdateActors = [&actors]( unsigned int begin, unsigned int end )
+	{
+		for ( unsigned int i = begin; i < end; i++ )
+			actors[i]->UpdateSkinningMatrices();
+	};
+
+	const unsigned int count = static_cast<unsigned int>( actors.size() );
+	JobSystem* pJobs = JobSystem::Get();
+
+	if ( pJobs )
+		pJobs->ParallelFor( count, 16, UpdateActors );
+	else
+		UpdateActors( 0, count );
 }
 //--------------------------------------------------------------------------------
 void SkinnedActor::PlayAnimation( int index )
@@ -179,4 +266,37 @@ Entity3D* SkinnedActor::GetGeometryEntity()
 {
 	return( m_pGeometryEntity );
 }
+//--------------------------------------------------------------------------------
+bool SkinnedActor::GetSkinnedBounds( Vector3f& mins, Vector3f& maxs )
+{
+	if ( m_pMatrices == 0 )
+		return( false );
+
+	GeometryPtr pGeometry = std::dynamic_pointer_cast<GeometryDX11>( GetBody()->Visual.GetGeometry() );
+
+	if ( pGeometry == nullptr )
+		return( false );
+
+	VertexElementDX11* pPositions = pGeometry->GetElement( VertexElementDX11::PositionSemantic );
+	VertexElementDX11* pBoneIDs = pGeometry->GetElement( VertexElementDX11::BoneIDSemantic );
+	VertexElementDX11* pWeights = pGeometry->GetElement( VertexElementDX11::BoneWeightSemantic );
+
+	if ( pPositions == nullptr || pBoneIDs == nullptr || pPositions->Tuple() != 3 )
+		return( false );
+
+	// The loaders store either a single bone per vertex without weights, or up
+	// to four weighted bones.
+
+	const unsigned int influences = static_cast<unsigned int>( pBoneIDs->Tuple() );
+	const float* pWeightData = nullptr;
+
+	if ( pWeights != nullptr && pWeights->Tuple() == pBoneIDs->Tuple() )
+		pWeightData = pWeights->Get1f( 0 );
+	else if ( influences != 1 )
+		return( false );
+
+	return( SkeletonEvaluator::SkinBounds( m_pMatrices, static_cast<unsigned int>( m_Bones.size() ),
+		pPositions->Get3f( 0 ), pBoneIDs->Get1ui( 0 ), pWeightData, influences,
+		static_cast<unsigned int>( std::min( pPositions->Count(), pBoneIDs->Count() ) ), mins, maxs ) );
+}
 //--------------------------------------------------------------------------------
\ No newline at end of file
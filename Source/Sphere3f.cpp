@@ -46,6 +46,26 @@ bool Sphere3f::Envelops( const Sphere3f& test ) const
 	return( radius > test.radius + Dist.Magnitude( ) );
 }
 //--------------------------------------------------------------------------------
+void Sphere3f::Merge( const Sphere3f& other )
+{
+	// Nothing changes if one of the two already encloses the other.
+
+	Vector3f offset = other.center - center;
+	float fDistance = offset.Magnitude( );
+
+	if ( fDistance + other.radius <= radius )
+		return;
+
+	if ( fDistance + radius <= other.radius ) {
+		*this = other;
+		return;
+	}
+
+	float fRadius = 0.5f * ( fDistance + other.radius + radius );
+	center += offset * ( ( fRadius - radius ) / fDistance );
+	radius = fRadius;
+}
+//--------------------------------------------------------------------------------
 void Sphere3f::SamplePosition( Vector3f& position, float theta, float phi ) const
 {
 	position.x = radius * sinf( phi ) * cosf( theta ) + center.x;
@@ -11,6 +11,7 @@
 //--------------------------------------------------------------------------------
 #include "PCH.h"
 #include "SpriteFontLoaderDX11.h"
+#include "Profiler.h"
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
@@ -26,6 +27,8 @@ SpriteFontLoaderDX11::~SpriteFontLoaderDX11()
 //--------------------------------------------------------------------------------
 SpriteFontPtr SpriteFontLoaderDX11::LoadFont( std::wstring& fontName, float fontSize, UINT fontStyle, bool antiAliased )
 {
+	GLYPH_PROFILE_SCOPE( "SpriteFontLoaderDX11::LoadFont" );
+
 	SpriteFontPtr pFont = nullptr;
 
 	// Search our cache for existing font objects that match the requested
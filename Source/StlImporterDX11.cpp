@@ -0,0 +1,689 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "StlImporterDX11.h"
+#include "MemoryMappedFile.h"
+#include "JobSystem.h"
+#include "GlyphString.h"
+#include "Log.h"
+#include "Profiler.h"
+#include <cmath>
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+static const ptrdiff_t ChunkSize = 1 << 20;
+static const unsigned int ChunksPerBatch = 16;
+static const unsigned int PositionGrain = 4096;
+static const UINT NoPosition = ~0U;
+
+// Scaled coordinates are clamped well within the range of a long long, which
+// only matters for positions that are huge compared to the tolerance.
+static const double MaxCell = 1e15;
+//--------------------------------------------------------------------------------
+template <typename F>
+static void ForEachIndex( unsigned int count, unsigned int grain, const F& func )
+{
+	JobSystem* pJobs = JobSystem::Get();
+
+	if ( pJobs )
+		pJobs->ParallelFor( count, grain, func );
+	else
+		func( 0, count );
+}
+//--------------------------------------------------------------------------------
+static inline bool IsSpace( char c )
+{
+	return( c == ' ' || c == '\t' || c == '\r' || c == '\n' );
+}
+//--------------------------------------------------------------------------------
+static inline const char* SkipSpace( const char* p, const char* pEnd )
+{
+	while ( p < pEnd && IsSpace( *p ) )
+		p++;
+
+	return( p );
+}
+//--------------------------------------------------------------------------------
+static bool ReadKeyword( const char*& p, const char* pEnd, const char* pKeyword )
+{
+	// Consumes the next word if it is the keyword.
+
+	p = SkipSpace( p, pEnd );
+
+	const char* pWordEnd = p;
+	while ( pWordEnd < pEnd && !IsSpace( *pWordEnd ) )
+		pWordEnd++;
+
+	const size_t length = strlen( pKeyword );
+
+	if ( static_cast<size_t>( pWordEnd - p ) != length || memcmp( p, pKeyword, length ) != 0 )
+		return( false );
+
+	p = pWordEnd;
+	return( true );
+}
+//--------------------------------------------------------------------------------
+static bool ReadFloats( const char*& p, const char* pEnd, float* pValues, int count )
+{
+	for ( int i = 0; i < count; i++ )
+	{
+		p = GlyphString::ParseFloat( SkipSpace( p, pEnd ), pEnd, pValues[i] );
+
+		if ( !p || ( p < pEnd && !IsSpace( *p ) ) )
+			return( false );
+	}
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+static bool StartsBlock( const char* p, const char* pEnd )
+{
+	// Checks whether the next word starts a facet or a solid.  A keyword that
+	// doesn't match only skips the space in front of the word.
+
+	return( ReadKeyword( p, pEnd, "facet" )
+		|| ReadKeyword( p, pEnd, "solid" )
+		|| ReadKeyword( p, pEnd, "endsolid" ) );
+}
+//--------------------------------------------------------------------------------
+static inline double ScaleCoordinate( float value, double scale )
+{
+	const double scaled = value * scale;
+
+	return( std::max( -MaxCell, std::min( MaxCell, scaled ) ) );
+}
+//--------------------------------------------------------------------------------
+static inline unsigned int HashCell( const long long* pCell )
+{
+	unsigned long long key = static_cast<unsigned long long>( pCell[0] ) * 0x9e3779b97f4a7c15ull;
+	key ^= static_cast<unsigned long long>( pCell[1] ) * 0xc2b2ae3d27d4eb4full;
+	key ^= static_cast<unsigned long long>( pCell[2] ) * 0x165667b19e3779f9ull;
+
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdull;
+	key ^= key >> 33;
+
+	return( static_cast<unsigned int>( key ) );
+}
+//--------------------------------------------------------------------------------
+static inline bool SameCell( const long long* pA, const long long* pB )
+{
+	return( pA[0] == pB[0] && pA[1] == pB[1] && pA[2] == pB[2] );
+}
+//--------------------------------------------------------------------------------
+static inline float Length( const float* pVector )
+{
+	return( sqrt( pVector[0] * pVector[0] + pVector[1] * pVector[1] + pVector[2] * pVector[2] ) );
+}
+//--------------------------------------------------------------------------------
+static inline void Normalize( float* pVector )
+{
+	const float length = Length( pVector );
+
+	if ( length > 0.0f )
+	{
+		pVector[0] /= length;
+		pVector[1] /= length;
+		pVector[2] /= length;
+	}
+}
+//--------------------------------------------------------------------------------
+static VertexElementDX11* CreateElement( const std::string& semantic, int tuple, DXGI_FORMAT format,
+										int count, bool first )
+{
+	VertexElementDX11* pElement = new VertexElementDX11( tuple, count );
+	pElement->m_SemanticName = semantic;
+	pElement->m_uiSemanticIndex = 0;
+	pElement->m_Format = format;
+	pElement->m_uiInputSlot = 0;
+	pElement->m_uiAlignedByteOffset = first ? 0 : D3D11_APPEND_ALIGNED_ELEMENT;
+	pElement->m_InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	pElement->m_uiInstanceDataStepRate = 0;
+
+	return( pElement );
+}
+//--------------------------------------------------------------------------------
+StlImporterDX11::StlImporterDX11()
+{
+}
+//--------------------------------------------------------------------------------
+GeometryPtr StlImporterDX11::Load( const std::wstring& filename, float tolerance,
+								  bool smoothNormals, float creaseAngle )
+{
+	GLYPH_PROFILE_SCOPE( "StlImporterDX11::Load" );
+
+	MemoryMappedFile file;
+
+	if ( !file.Open( filename ) )
+	{
+		Log::Get().Write( L"Could not open STL file: " + filename, LOG_ERROR );
+		return( nullptr );
+	}
+
+	return( LoadFromMemory( reinterpret_cast<const char*>( file.GetData() ), file.GetSize(), filename,
+		tolerance, smoothNormals, creaseAngle ) );
+}
+//--------------------------------------------------------------------------------
+GeometryPtr StlImporterDX11::LoadFromMemory( const char* pData, size_t dataSize, const std::wstring& name,
+											float tolerance, bool smoothNormals, float creaseAngle )
+{
+	const char* pDataEnd = pData + dataSize;
+	const unsigned long long size = dataSize;
+
+	Mesh mesh;
+	mesh.tolerance = std::max( tolerance, 0.0f );
+	mesh.cellScale = ( mesh.tolerance > 0.0f ) ? 0.5 / mesh.tolerance : 0.0;
+	mesh.smoothNormals = smoothNormals;
+	mesh.slots.resize( 1024 );
+	mesh.usedSlots = 0;
+
+	for ( auto& slot : mesh.slots )
+		slot.position = NoPosition;
+
+	// A binary file has an 80 byte header, the number of facets, and 50 bytes for
+	// each facet.  The header of a binary file may start with "solid" as well,
+	// so the size is checked before the file is taken to be ASCII.
+
+	unsigned int facetCount = 0;
+	if ( size >= 84 )
+		memcpy( &facetCount, pData + 80, sizeof( facetCount ) );
+
+	const char* pText = pData;
+	const bool bSolid = ReadKeyword( pText, pDataEnd, "solid" );
+	const bool bBinary = ( size >= 84 ) && ( size == 84 + 50ull * facetCount || !bSolid );
+
+	bool bValid = true;
+
+	if ( bBinary )
+	{
+		if ( 84 + 50ull * facetCount > size )
+		{
+			bValid = false;
+		}
+		else
+		{
+			Facet facet;
+
+			for ( unsigned int i = 0; i < facetCount && bValid; i++ )
+			{
+				memcpy( facet.values, pData + 84 + 50ull * i, sizeof( facet.values ) );
+				bValid = AddFacet( mesh, facet );
+			}
+		}
+	}
+	else if ( bSolid )
+	{
+		// Split the file into chunks of about ChunkSize bytes, each of which
+		// starts at the beginning of a facet or a solid.
+
+		std::vector<const char*> splits( 1, pData );
+
+		while ( splits.back() < pDataEnd )
+		{
+			const char* pSplit = ( pDataEnd - splits.back() > ChunkSize ) ? splits.back() + ChunkSize : pDataEnd;
+
+			while ( pSplit < pDataEnd && ( *( pSplit - 1 ) != '\n' || !StartsBlock( pSplit, pDataEnd ) ) )
+				pSplit++;
+
+			splits.push_back( pSplit );
+		}
+
+		// Only a batch of chunks is parsed at a time, which bounds the number of
+		// facets that are held before they are welded.
+
+		const unsigned int chunkCount = static_cast<unsigned int>( splits.size() - 1 );
+		std::vector<Chunk> chunks( std::min( chunkCount, ChunksPerBatch ) );
+
+		for ( unsigned int first = 0; first < chunkCount && bValid; first += ChunksPerBatch )
+		{
+			const unsigned int batchSize = std::min( chunkCount - first, ChunksPerBatch );
+
+			for ( unsigned int c = 0; c < batchSize; c++ )
+			{
+				chunks[c].pBegin = splits[first+c];
+				chunks[c].pEnd = splits[first+c+1];
+				chunks[c].error = false;
+				chunks[c].facets.clear();
+			}
+
+			ForEachIndex( batchSize, 1, [&]( unsigned int begin, unsigned int end )
+			{
+				for ( unsigned int c = begin; c < end; c++ )
+					ParseChunk( chunks[c] );
+			} );
+
+			for ( unsigned int c = 0; c < batchSize && bValid; c++ )
+			{
+				bValid = !chunks[c].error;
+
+				for ( size_t i = 0; i < chunks[c].facets.size() && bValid; i++ )
+					bValid = AddFacet( mesh, chunks[c].facets[i] );
+			}
+		}
+	}
+	else
+	{
+		bValid = false;
+	}
+
+	if ( !bValid )
+	{
+		Log::Get().Write( L"STL file contains invalid data: " + name, LOG_ERROR );
+		return( nullptr );
+	}
+
+	if ( mesh.triangles.empty() )
+	{
+		Log::Get().Write( L"STL file contains no triangles: " + name, LOG_ERROR );
+		return( nullptr );
+	}
+
+	// The weld table isn't needed anymore, so release it before the vertices
+	// are built.
+
+	std::vector<Slot>().swap( mesh.slots );
+	std::vector<UINT>().swap( mesh.next );
+
+	return( BuildGeometry( mesh, creaseAngle ) );
+}
+//--------------------------------------------------------------------------------
+void StlImporterDX11::ParseChunk( Chunk& chunk )
+{
+	const char* p = chunk.pBegin;
+	const char* pEnd = chunk.pEnd;
+
+	while ( ( p = SkipSpace( p, pEnd ) ) < pEnd )
+	{
+		if ( ReadKeyword( p, pEnd, "facet" ) )
+		{
+			Facet facet;
+			float* pValues = facet.values;
+
+			const bool bFacet = ReadKeyword( p, pEnd, "normal" ) && ReadFloats( p, pEnd, pValues, 3 )
+				&& ReadKeyword( p, pEnd, "outer" ) && ReadKeyword( p, pEnd, "loop" )
+				&& ReadKeyword( p, pEnd, "vertex" ) && ReadFloats( p, pEnd, pValues + 3, 3 )
+				&& ReadKeyword( p, pEnd, "vertex" ) && ReadFloats( p, pEnd, pValues + 6, 3 )
+				&& ReadKeyword( p, pEnd, "vertex" ) && ReadFloats( p, pEnd, pValues + 9, 3 )
+				&& ReadKeyword( p, pEnd, "endloop" ) && ReadKeyword( p, pEnd, "endfacet" );
+
+			if ( !bFacet )
+			{
+				chunk.error = true;
+				return;
+			}
+
+			chunk.facets.push_back( facet );
+		}
+		else if ( ReadKeyword( p, pEnd, "solid" ) || ReadKeyword( p, pEnd, "endsolid" ) )
+		{
+			// The rest of the line is the name of the solid.
+
+			while ( p < pEnd && *p != '\n' )
+				p++;
+		}
+		else
+		{
+			chunk.error = true;
+			return;
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+bool StlImporterDX11::AddFacet( Mesh& mesh, const Facet& facet )
+{
+	for ( int i = 3; i < 12; i++ )
+	{
+		if ( !std::isfinite( facet.values[i] ) )
+			return( false );
+	}
+
+	UINT corners[3];
+
+	for ( int i = 0; i < 3; i++ )
+		corners[i] = WeldPosition( mesh, &facet.values[3 + 3 * i] );
+
+	if ( corners[0] == corners[1] || corners[1] == corners[2] || corners[2] == corners[0] )
+		return( true );
+
+	mesh.triangles.insert( mesh.triangles.end(), corners, corners + 3 );
+
+	// The face normal is computed from the welded positions, so that it agrees
+	// with the triangle that is actually drawn.  Its length is twice the area,
+	// which weights the generated normals.
+
+	const float* pA = &mesh.positions[3 * corners[0]];
+	const float* pB = &mesh.positions[3 * corners[1]];
+	const float* pC = &mesh.positions[3 * corners[2]];
+
+	const float e1[3] = { pB[0] - pA[0], pB[1] - pA[1], pB[2] - pA[2] };
+	const float e2[3] = { pC[0] - pA[0], pC[1] - pA[1], pC[2] - pA[2] };
+
+	float normal[3] =
+	{
+		e1[1] * e2[2] - e1[2] * e2[1],
+		e1[2] * e2[0] - e1[0] * e2[2],
+		e1[0] * e2[1] - e1[1] * e2[0]
+	};
+
+	if ( !mesh.smoothNormals )
+	{
+		// The normal from the file is kept when there is one, and the computed
+		// normal is only used for the files that leave it at zero.
+
+		const float* pFile = facet.values;
+		const float length = Length( pFile );
+
+		if ( length > 0.0f && std::isfinite( length ) )
+			memcpy( normal, pFile, sizeof( normal ) );
+
+		Normalize( normal );
+	}
+
+	mesh.normals.insert( mesh.normals.end(), normal, normal + 3 );
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+UINT StlImporterDX11::WeldPosition( Mesh& mesh, const float* pPosition )
+{
+	long long cell[3];
+	CellOf( mesh, pPosition, cell );
+
+	const unsigned int hash = HashCell( cell );
+	unsigned int slot = FindSlot( mesh, cell, hash );
+
+	if ( mesh.tolerance == 0.0f )
+	{
+		// Each cell is a single position.
+
+		if ( mesh.slots[slot].position != NoPosition )
+			return( mesh.slots[slot].position );
+	}
+	else
+	{
+		// Any position within the tolerance is at most half a cell away, so it
+		// is either in the same cell or in the neighbour on the side of the
+		// half of the cell that the position is in, on each axis.  The position's
+		// own cell is searched first.
+
+		long long step[3];
+
+		for ( int i = 0; i < 3; i++ )
+			step[i] = ( ScaleCoordinate( pPosition[i], mesh.cellScale ) - cell[i] < 0.5 ) ? -1 : 1;
+
+		for ( int neighbour = 0; neighbour < 8; neighbour++ )
+		{
+			long long other[3];
+
+			for ( int i = 0; i < 3; i++ )
+				other[i] = cell[i] + ( ( neighbour & ( 1 << i ) ) ? step[i] : 0 );
+
+			const unsigned int otherSlot = neighbour ? FindSlot( mesh, other, HashCell( other ) ) : slot;
+
+			for ( UINT p = mesh.slots[otherSlot].position; p != NoPosition; p = mesh.next[p] )
+			{
+				const float* pOther = &mesh.positions[3 * p];
+
+				if ( fabs( pOther[0] - pPosition[0] ) <= mesh.tolerance
+					&& fabs( pOther[1] - pPosition[1] ) <= mesh.tolerance
+					&& fabs( pOther[2] - pPosition[2] ) <= mesh.tolerance )
+				{
+					return( p );
+				}
+			}
+		}
+	}
+
+	// This is a new position, which becomes the first one of its cell.
+
+	const UINT position = static_cast<UINT>( mesh.next.size() );
+
+	mesh.positions.insert( mesh.positions.end(), pPosition, pPosition + 3 );
+	mesh.next.push_back( mesh.slots[slot].position );
+
+	if ( mesh.slots[slot].position == NoPosition )
+	{
+		mesh.slots[slot].hash = hash;
+		mesh.usedSlots++;
+	}
+
+	mesh.slots[slot].position = position;
+
+	if ( 2 * mesh.usedSlots > mesh.slots.size() )
+		GrowSlots( mesh );
+
+	return( position );
+}
+//--------------------------------------------------------------------------------
+unsigned int StlImporterDX11::FindSlot( const Mesh& mesh, const long long* pCell, unsigned int hash )
+{
+	// Returns the slot of the cell, or the empty slot where it would go.  The
+	// cell of a used slot is found again from the position that it holds.
+
+	const unsigned int mask = static_cast<unsigned int>( mesh.slots.size() - 1 );
+	unsigned int slot = hash & mask;
+
+	while ( mesh.slots[slot].position != NoPosition )
+	{
+		if ( mesh.slots[slot].hash == hash )
+		{
+			long long cell[3];
+			CellOf( mesh, &mesh.positions[3 * mesh.slots[slot].position], cell );
+
+			if ( SameCell( cell, pCell ) )
+				break;
+		}
+
+		slot = ( slot + 1 ) & mask;
+	}
+
+	return( slot );
+}
+//--------------------------------------------------------------------------------
+void StlImporterDX11::CellOf( const Mesh& mesh, const float* pPosition, long long* pCell )
+{
+	for ( int i = 0; i < 3; i++ )
+	{
+		if ( mesh.tolerance == 0.0f )
+		{
+			// The cell is the bit pattern of the position, with negative zero
+			// folded into zero.
+
+			unsigned int bits;
+			memcpy( &bits, &pPosition[i], sizeof( bits ) );
+
+			pCell[i] = ( bits & 0x7fffffff ) ? bits : 0;
+		}
+		else
+		{
+			pCell[i] = static_cast<long long>( floor( ScaleCoordinate( pPosition[i], mesh.cellScale ) ) );
+		}
+	}
+}
+//--------------------------------------------------------------------------------
+void StlImporterDX11::GrowSlots( Mesh& mesh )
+{
+	std::vector<Slot> slots( mesh.slots.size() * 2 );
+	const unsigned int mask = static_cast<unsigned int>( slots.size() - 1 );
+
+	for ( auto& slot : slots )
+		slot.position = NoPosition;
+
+	for ( auto& slot : mesh.slots )
+	{
+		if ( slot.position == NoPosition )
+			continue;
+
+		unsigned int index = slot.hash & mask;
+
+		while ( slots[index].position != NoPosition )
+			index = ( index + 1 ) & mask;
+
+		slots[index] = slot;
+	}
+
+	mesh.slots.swap( slots );
+}
+//--------------------------------------------------------------------------------
+GeometryPtr StlImporterDX11::BuildGeometry( Mesh& mesh, float creaseAngle )
+{
+	const unsigned int positionCount = static_cast<unsigned int>( mesh.positions.size() / 3 );
+	const unsigned int cornerCount = static_cast<unsigned int>( mesh.triangles.size() );
+	const unsigned int triangleCount = cornerCount / 3;
+
+	// List the corners that use each position, in the order of the triangles.
+
+	std::vector<unsigned int> firstCorner( positionCount + 1, 0 );
+	std::vector<unsigned int> corners( cornerCount );
+
+	for ( unsigned int c = 0; c < cornerCount; c++ )
+		firstCorner[mesh.triangles[c] + 1]++;
+
+	for ( unsigned int p = 0; p < positionCount; p++ )
+		firstCorner[p + 1] += firstCorner[p];
+
+	for ( unsigned int c = 0; c < cornerCount; c++ )
+		corners[firstCorner[mesh.triangles[c]]++] = c;
+
+	for ( unsigned int p = positionCount; p > 0; p-- )
+		firstCorner[p] = firstCorner[p - 1];
+
+	firstCorner[0] = 0;
+
+	// The generated normal of a corner is the sum of the face normals around
+	// its position that are within the crease angle of its own face.
+
+	std::vector<float> lengths;
+	const float cosine = cos( creaseAngle );
+
+	if ( mesh.smoothNormals )
+	{
+		lengths.resize( triangleCount );
+
+		ForEachIndex( triangleCount, PositionGrain, [&]( unsigned int begin, unsigned int end )
+		{
+			for ( unsigned int t = begin; t < end; t++ )
+				lengths[t] = Length( &mesh.normals[3 * t] );
+		} );
+	}
+
+	auto CornerNormal = [&]( unsigned int position, unsigned int corner, float* pNormal )
+	{
+		const unsigned int face = corner / 3;
+		const float* pFace = &mesh.normals[3 * face];
+
+		if ( !mesh.smoothNormals )
+		{
+			memcpy( pNormal, pFace, 3 * sizeof( float ) );
+			return;
+		}
+
+		const float limit = cosine * lengths[face];
+
+		pNormal[0] = pNormal[1] = pNormal[2] = 0.0f;
+
+		for ( unsigned int i = firstCorner[position]; i < firstCorner[position + 1]; i++ )
+		{
+			const unsigned int other = corners[i] / 3;
+			const float* pOther = &mesh.normals[3 * other];
+
+			if ( pOther[0] * pFace[0] + pOther[1] * pFace[1] + pOther[2] * pFace[2] >= limit * lengths[other] )
+			{
+				pNormal[0] += pOther[0];
+				pNormal[1] += pOther[1];
+				pNormal[2] += pOther[2];
+			}
+		}
+
+		Normalize( pNormal );
+	};
+
+	// Find the distinct normals of each position's corners, and number them in
+	// the order of the corners.  The triangle list isn't needed anymore, so it
+	// holds the number of each corner's vertex within its position until the
+	// vertices are placed, and then becomes the index list.
+
+	std::vector<UINT>& indices = mesh.triangles;
+	std::vector<unsigned int> firstVertex( positionCount + 1, 0 );
+
+	ForEachIndex( positionCount, PositionGrain, [&]( unsigned int begin, unsigned int end )
+	{
+		std::vector<float> normals;
+
+		for ( unsigned int p = begin; p < end; p++ )
+		{
+			normals.clear();
+
+			for ( unsigned int i = firstCorner[p]; i < firstCorner[p + 1]; i++ )
+			{
+				float normal[3];
+				CornerNormal( p, corners[i], normal );
+
+				const unsigned int count = static_cast<unsigned int>( normals.size() / 3 );
+				unsigned int n = 0;
+
+				while ( n < count && !( normals[3 * n] == normal[0] && normals[3 * n + 1] == normal[1] && normals[3 * n + 2] == normal[2] ) )
+					n++;
+
+				if ( n == count )
+					normals.insert( normals.end(), normal, normal + 3 );
+
+				indices[corners[i]] = n;
+			}
+
+			firstVertex[p + 1] = static_cast<unsigned int>( normals.size() / 3 );
+		}
+	} );
+
+	for ( unsigned int p = 0; p < positionCount; p++ )
+		firstVertex[p + 1] += firstVertex[p];
+
+	const int vertexCount = static_cast<int>( firstVertex[positionCount] );
+
+	VertexElementDX11* pPositions = CreateElement( VertexElementDX11::PositionSemantic, 3, DXGI_FORMAT_R32G32B32_FLOAT, vertexCount, true );
+	VertexElementDX11* pNormals = CreateElement( VertexElementDX11::NormalSemantic, 3, DXGI_FORMAT_R32G32B32_FLOAT, vertexCount, false );
+
+	// The first corner that uses each vertex writes it.
+
+	ForEachIndex( positionCount, PositionGrain, [&]( unsigned int begin, unsigned int end )
+	{
+		for ( unsigned int p = begin; p < end; p++ )
+		{
+			unsigned int written = 0;
+
+			for ( unsigned int i = firstCorner[p]; i < firstCorner[p + 1]; i++ )
+			{
+				const unsigned int corner = corners[i];
+				const int vertex = static_cast<int>( firstVertex[p] + indices[corner] );
+
+				if ( indices[corner] == written )
+				{
+					memcpy( ( *pPositions )[vertex], &mesh.positions[3 * p], 3 * sizeof( float ) );
+					CornerNormal( p, corner, ( *pNormals )[vertex] );
+					written++;
+				}
+
+				indices[corner] = vertex;
+			}
+		}
+	} );
+
+	GeometryPtr pGeometry = GeometryPtr( new GeometryDX11() );
+
+	pGeometry->AddElement( pPositions );
+	pGeometry->AddElement( pNormals );
+	pGeometry->SetPrimitiveType( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+	pGeometry->m_vIndices.swap( indices );
+
+	return( pGeometry );
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,106 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "StreamRequest.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+StreamRequest::StreamRequest( const std::wstring& filename ) :
+	m_Filename( filename ),
+	m_Priority( STREAM_PRIORITY_NORMAL ),
+	m_ullMemoryCost( 0 ),
+	m_bCostKnown( false ),
+	m_bCharged( false ),
+	m_State( STREAM_IDLE ),
+	m_bCancelled( false )
+{
+}
+//--------------------------------------------------------------------------------
+StreamRequest::~StreamRequest()
+{
+}
+//--------------------------------------------------------------------------------
+const std::wstring& StreamRequest::GetFilename( ) const
+{
+	return( m_Filename );
+}
+//--------------------------------------------------------------------------------
+StreamPriority StreamRequest::GetPriority( ) const
+{
+	return( m_Priority );
+}
+//--------------------------------------------------------------------------------
+StreamState StreamRequest::GetState( ) const
+{
+	return( static_cast<StreamState>( m_State.load() ) );
+}
+//--------------------------------------------------------------------------------
+bool StreamRequest::IsDone( ) const
+{
+	return( GetState() >= STREAM_COMPLETE );
+}
+//--------------------------------------------------------------------------------
+void StreamRequest::Cancel( )
+{
+	m_bCancelled = true;
+}
+//--------------------------------------------------------------------------------
+bool StreamRequest::IsCancelled( ) const
+{
+	return( m_bCancelled.load() );
+}
+//--------------------------------------------------------------------------------
+unsigned long long StreamRequest::GetMemoryCost( ) const
+{
+	return( m_ullMemoryCost );
+}
+//--------------------------------------------------------------------------------
+unsigned long long StreamRequest::EstimateMemoryCost( )
+{
+	return( GetFileLength( m_Filename ) );
+}
+//--------------------------------------------------------------------------------
+bool StreamRequest::Read( )
+{
+	return( LoadFile( m_Filename ) );
+}
+//--------------------------------------------------------------------------------
+unsigned long long StreamRequest::GetFileLength( const std::wstring& filename )
+{
+	std::ifstream file( filename, std::ios::in | std::ios::binary | std::ios::ate );
+
+	if ( !file.is_open() )
+		return( 0 );
+
+	return( static_cast<unsigned long long>( file.tellg() ) );
+}
+//--------------------------------------------------------------------------------
+bool StreamRequest::LoadFile( const std::wstring& filename )
+{
+	std::ifstream file( filename, std::ios::in | std::ios::binary | std::ios::ate );
+
+	if ( !file.is_open() )
+		return( false );
+
+	const std::streamoff size = file.tellg();
+
+	if ( size <= 0 )
+		return( false );
+
+	m_Data.resize( static_cast<size_t>( size ) );
+
+	file.seekg( 0 );
+	file.read( &m_Data[0], size );
+
+	return( !file.fail() );
+}
+//--------------------------------------------------------------------------------
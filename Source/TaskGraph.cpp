@@ -0,0 +1,234 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TaskGraph.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+TaskGraph::TaskGraph() :
+	m_pJobs( nullptr )
+{
+}
+//--------------------------------------------------------------------------------
+TaskGraph::~TaskGraph()
+{
+	Wait();
+}
+//--------------------------------------------------------------------------------
+unsigned int TaskGraph::AddNode( )
+{
+	assert( m_Counter.IsComplete() );
+
+	Node node;
+	node.Prerequisites = 0;
+	node.Remaining = 0;
+	node.Complete = false;
+
+	m_Nodes.push_back( node );
+
+	return( static_cast<unsigned int>( m_Nodes.size() - 1 ) );
+}
+//--------------------------------------------------------------------------------
+void TaskGraph::AddDependency( unsigned int node, unsigned int prerequisite )
+{
+	assert( m_Counter.IsComplete() );
+	assert( node < m_Nodes.size() && prerequisite < m_Nodes.size() );
+
+	std::vector<unsigned int>& dependents = m_Nodes[prerequisite].Dependents;
+
+	if ( std::find( dependents.begin(), dependents.end(), node ) == dependents.end() )
+	{
+		dependents.push_back( node );
+		m_Nodes[node].Prerequisites++;
+	}
+}
+//--------------------------------------------------------------------------------
+void TaskGraph::Clear( )
+{
+	assert( m_Counter.IsComplete() );
+
+	m_Nodes.clear();
+	m_Order.clear();
+	m_Ready.clear();
+}
+//--------------------------------------------------------------------------------
+bool TaskGraph::Sort( )
+{
+	// Kahn's algorithm, with the ready nodes kept in a heap so that the lowest
+	// index is taken whenever there is a choice.
+
+	m_Order.clear();
+	m_Ready.clear();
+
+	for ( unsigned int i = 0; i < m_Nodes.size(); i++ )
+	{
+		m_Nodes[i].Remaining = m_Nodes[i].Prerequisites;
+
+		if ( m_Nodes[i].Remaining == 0 )
+			m_Ready.push_back( i );
+	}
+
+	std::greater<unsigned int> lowest;
+
+	while ( !m_Ready.empty() )
+	{
+		std::pop_heap( m_Ready.begin(), m_Ready.end(), lowest );
+		unsigned int node = m_Ready.back();
+		m_Ready.pop_back();
+
+		m_Order.push_back( node );
+
+		for ( auto dependent : m_Nodes[node].Dependents )
+		{
+			if ( --m_Nodes[dependent].Remaining == 0 )
+			{
+				m_Ready.push_back( dependent );
+				std::push_heap( m_Ready.begin(), m_Ready.end(), lowest );
+			}
+		}
+	}
+
+	return( m_Order.size() == m_Nodes.size() );
+}
+//--------------------------------------------------------------------------------
+bool TaskGraph::Execute( JobSystem* pJobs, unsigned int slots, const NodeFunction& function )
+{
+	assert( m_Counter.IsComplete() );
+	assert( slots > 0 );
+
+	if ( !Sort() )
+		return( false );
+
+	// Without a job system, the sorted order is followed directly.
+
+	if ( pJobs == nullptr )
+	{
+		for ( auto node : m_Order )
+		{
+			function( node, 0 );
+			m_Nodes[node].Complete = true;
+		}
+
+		m_pJobs = nullptr;
+		return( true );
+	}
+
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	m_pJobs = pJobs;
+	m_Function = function;
+
+	m_Ready.clear();
+
+	for ( unsigned int i = 0; i < m_Nodes.size(); i++ )
+	{
+		m_Nodes[i].Remaining = m_Nodes[i].Prerequisites;
+		m_Nodes[i].Complete = false;
+
+		if ( m_Nodes[i].Remaining == 0 )
+			m_Ready.push_back( i );
+	}
+
+	std::make_heap( m_Ready.begin(), m_Ready.end(), std::greater<unsigned int>() );
+
+	// The slots are handed out from the back, so slot zero is used first.
+
+	m_FreeSlots.clear();
+
+	for ( unsigned int i = slots; i > 0; i-- )
+		m_FreeSlots.push_back( i - 1 );
+
+	Dispatch();
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void TaskGraph::Dispatch( )
+{
+	// Called with the lock held.  Starts as many ready nodes as there are free
+	// slots to run them with.
+
+	std::greater<unsigned int> lowest;
+
+	while ( !m_Ready.empty() && !m_FreeSlots.empty() )
+	{
+		std::pop_heap( m_Ready.begin(), m_Ready.end(), lowest );
+		unsigned int node = m_Ready.back();
+		m_Ready.pop_back();
+
+		unsigned int slot = m_FreeSlots.back();
+		m_FreeSlots.pop_back();
+
+		m_pJobs->Submit( [this, node, slot]() { RunNode( node, slot ); }, m_Counter );
+	}
+}
+//--------------------------------------------------------------------------------
+void TaskGraph::RunNode( unsigned int node, unsigned int slot )
+{
+	m_Function( node, slot );
+
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	m_Nodes[node].Complete = true;
+	m_FreeSlots.push_back( slot );
+
+	std::greater<unsigned int> lowest;
+
+	for ( auto dependent : m_Nodes[node].Dependents )
+	{
+		if ( --m_Nodes[dependent].Remaining == 0 )
+		{
+			m_Ready.push_back( dependent );
+			std::push_heap( m_Ready.begin(), m_Ready.end(), lowest );
+		}
+	}
+
+	// The dependents are submitted before this job completes, so the counter
+	// can't reach zero while there is still work left.
+
+	Dispatch();
+}
+//--------------------------------------------------------------------------------
+bool TaskGraph::IsComplete( unsigned int node )
+{
+	std::lock_guard<std::mutex> lock( m_Lock );
+
+	return( m_Nodes[node].Complete );
+}
+//--------------------------------------------------------------------------------
+void TaskGraph::WaitForNode( unsigned int node )
+{
+	assert( node < m_Nodes.size() );
+
+	while ( !IsComplete( node ) )
+	{
+		if ( m_pJobs == nullptr || !m_pJobs->ExecutePending() )
+			std::this_thread::yield();
+	}
+}
+//--------------------------------------------------------------------------------
+void TaskGraph::Wait( )
+{
+	if ( m_pJobs != nullptr )
+		m_pJobs->Wait( m_Counter );
+}
+//--------------------------------------------------------------------------------
+unsigned int TaskGraph::GetNodeCount( ) const
+{
+	return( static_cast<unsigned int>( m_Nodes.size() ) );
+}
+//--------------------------------------------------------------------------------
+const std::vector<unsigned int>& TaskGraph::GetOrder( ) const
+{
+	return( m_Order );
+}
+//--------------------------------------------------------------------------------
@@ -0,0 +1,97 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TextureStreamRequestDX11.h"
+#include "RendererDX11.h"
+#include "FileSystem.h"
+#include "Log.h"
+#include "WICTextureLoader.h"
+#include "DDSTextureLoader.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+using Microsoft::WRL::ComPtr;
+//--------------------------------------------------------------------------------
+TextureStreamRequestDX11::TextureStreamRequestDX11( const std::wstring& filename, bool sRGB ) :
+	StreamRequest( FileSystem().GetTextureFolder() + filename ),
+	m_pRenderer( RendererDX11::Get() ),
+	m_bSRGB( sRGB )
+{
+}
+//--------------------------------------------------------------------------------
+TextureStreamRequestDX11::~TextureStreamRequestDX11()
+{
+}
+//--------------------------------------------------------------------------------
+ResourcePtr TextureStreamRequestDX11::GetTexture( ) const
+{
+	return( GetState() == STREAM_COMPLETE ? m_Texture : ResourcePtr() );
+}
+//--------------------------------------------------------------------------------
+bool TextureStreamRequestDX11::Decode( )
+{
+	if ( !m_pRenderer || m_Data.empty() )
+		return( false );
+
+	std::wstring extension = m_Filename.substr( m_Filename.size() - 3, 3 );
+	std::transform( extension.begin(), extension.end(), extension.begin(), ::tolower );
+
+	const uint8_t* pData = reinterpret_cast<const uint8_t*>( &m_Data[0] );
+	ComPtr<ID3D11Resource> pResource;
+	HRESULT hr = S_OK;
+
+	if ( extension == L"dds" )
+	{
+		hr = DirectX::CreateDDSTextureFromMemory(
+			m_pRenderer->GetDevice(),
+			pData,
+			m_Data.size(),
+			pResource.GetAddressOf(),
+			nullptr );
+	}
+	else
+	{
+		// The streamer initializes COM on its decode threads, which WIC needs.
+
+		hr = DirectX::CreateWICTextureFromMemoryEx(
+			m_pRenderer->GetDevice(),
+			nullptr,
+			pData,
+			m_Data.size(),
+			0,
+			D3D11_USAGE_DEFAULT,
+			D3D11_BIND_SHADER_RESOURCE,
+			0,
+			0,
+			m_bSRGB,
+			pResource.GetAddressOf(),
+			nullptr );
+	}
+
+	// The file contents aren't needed anymore.
+	std::vector<char>().swap( m_Data );
+
+	if ( FAILED( hr ) )
+		return( false );
+
+	pResource.CopyTo( m_pTexture.GetAddressOf() );
+
+	return( m_pTexture != nullptr );
+}
+//--------------------------------------------------------------------------------
+bool TextureStreamRequestDX11::Finalize( )
+{
+	m_Texture = m_pRenderer->LoadTexture( m_pTexture.Get() );
+	m_pTexture = nullptr;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
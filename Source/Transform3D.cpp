@@ -14,7 +14,11 @@
 //--------------------------------------------------------------------------------
 using namespace Glyph3;
 //--------------------------------------------------------------------------------
-Transform3D::Transform3D()
+Transform3D::Transform3D() :
+	m_bLocalChanged( true ),
+	m_uiRevision( 0 ),
+	m_pLastParent( nullptr ),
+	m_uiLastParentRevision( 0 )
 {
 	m_vTranslation.MakeZero();
 	m_mRotation.MakeIdentity();
@@ -22,6 +26,10 @@ Transform3D::Transform3D()
 
 	m_mWorld.MakeIdentity();
 	m_mLocal.MakeIdentity();
+
+	m_vLastTranslation = m_vTranslation;
+	m_mLastRotation = m_mRotation;
+	m_vLastScale = m_vScale;
 }
 //--------------------------------------------------------------------------------
 Transform3D::~Transform3D()
@@ -43,26 +51,91 @@ Vector3f& Transform3D::Scale( )
 	return( m_vScale );
 }
 //--------------------------------------------------------------------------------
-void Transform3D::UpdateLocal( )
+bool Transform3D::UpdateLocal( )
 {
+	// Skip the rebuild if none of the components have been modified since the
+	// last time that the local matrix was built.
+
+	if ( !m_bLocalChanged
+		&& m_vTranslation == m_vLastTranslation
+		&& m_mRotation == m_mLastRotation
+		&& m_vScale == m_vLastScale )
+	{
+		return( false );
+	}
+
+	m_vLastTranslation = m_vTranslation;
+	m_mLastRotation = m_mRotation;
+	m_vLastScale = m_vScale;
+
 	// Load the local space matrix with the rotation and translation components.
 
 	m_mLocal.MakeIdentity();
 	m_mLocal.SetRotation( m_mRotation );
 	m_mLocal.SetTranslation( m_vTranslation );
 	m_mLocal = Matrix4f::ScaleMatrix( m_vScale ) * m_mLocal;
+
+	m_bLocalChanged = true;
+
+	return( true );
 }
 //--------------------------------------------------------------------------------
 void Transform3D::UpdateWorld( const Matrix4f& parent )
 {
+	// An arbitrary parent matrix can't be tracked, so the world matrix is always
+	// rebuilt.  The transform itself is recorded as the parent so that the next
+	// tracked update will also rebuild it.
+
     m_mWorld = m_mLocal * parent;
+
+	m_bLocalChanged = false;
+	m_pLastParent = this;
+	m_uiRevision++;
 }
 //--------------------------------------------------------------------------------
-void Transform3D::UpdateWorld( )
+bool Transform3D::UpdateWorld( const Transform3D& parent )
 {
+	if ( !m_bLocalChanged
+		&& m_pLastParent == &parent
+		&& m_uiLastParentRevision == parent.m_uiRevision )
+	{
+		return( false );
+	}
+
+    m_mWorld = m_mLocal * parent.m_mWorld;
+
+	m_bLocalChanged = false;
+	m_pLastParent = &parent;
+	m_uiLastParentRevision = parent.m_uiRevision;
+	m_uiRevision++;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+bool Transform3D::UpdateWorld( )
+{
+	if ( !m_bLocalChanged && m_pLastParent == nullptr )
+		return( false );
+
 	// If no parent matrix is available, then simply make the world matrix the
 	// local matrix.
     m_mWorld = m_mLocal;
+
+	m_bLocalChanged = false;
+	m_pLastParent = nullptr;
+	m_uiRevision++;
+
+	return( true );
+}
+//--------------------------------------------------------------------------------
+void Transform3D::MakeDirty( )
+{
+	m_bLocalChanged = true;
+}
+//--------------------------------------------------------------------------------
+unsigned int Transform3D::GetRevision( ) const
+{
+	return( m_uiRevision );
 }
 //--------------------------------------------------------------------------------
 const Matrix4f& Transform3D::WorldMatrix() const
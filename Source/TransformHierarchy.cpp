@@ -0,0 +1,363 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "TransformHierarchy.h"
+#include "Node3D.h"
+#include "Entity3D.h"
+#include "JobSystem.h"
+#include <functional>
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+// Subtrees are merged into batches of at least this many objects, to keep the 
+// job overhead small relative to the work in each job.
+//--------------------------------------------------------------------------------
+static const unsigned int MinimumBatchSize = 256;
+//--------------------------------------------------------------------------------
+// The state of the bounds accumulated for each object by UpdateBounds.
+//--------------------------------------------------------------------------------
+static const unsigned char BoundsEmpty = 0;
+static const unsigned char BoundsSphere = 1;
+static const unsigned char BoundsUnbounded = 2;
+//--------------------------------------------------------------------------------
+TransformHierarchy::TransformHierarchy() :
+	m_pRoot( nullptr ),
+	m_uiStructureRevision( 0 ),
+	m_uiUpdatedCount( 0 ),
+	m_bParallel( false ),
+	m_uiHeadCount( 0 ),
+	m_bBoundsValid( false )
+{
+}
+//--------------------------------------------------------------------------------
+TransformHierarchy::~TransformHierarchy()
+{
+}
+//--------------------------------------------------------------------------------
+void TransformHierarchy::Build( Node3D* pRoot )
+{
+	m_pRoot = pRoot;
+
+	m_Transforms.clear();
+	m_ParentIndices.clear();
+	m_Nodes.clear();
+	m_Entities.clear();
+	m_Batches.clear();
+	m_SubtreeEnds.clear();
+	m_ChangedEntities.clear();
+	m_uiHeadCount = 0;
+	m_bBoundsValid = false;
+
+	if ( pRoot == nullptr )
+		return;
+
+	m_uiStructureRevision = pRoot->GetStructureRevision();
+
+	// The graph is walked with an explicit stack to avoid deep recursion.  Child
+	// nodes are pushed in reverse order so that they are visited in the same 
+	// order as in Node3D::Update.
+
+	std::vector< std::pair< Node3D*, int > > stack;
+	stack.push_back( std::make_pair( pRoot, -1 ) );
+
+	// Each subtree of the root occupies a contiguous range of the arrays, so it
+	// is enough to record where each one starts.
+
+	std::vector< unsigned int > subtrees;
+
+	while ( !stack.empty() )
+	{
+		Node3D* pNode = stack.back().first;
+		int parent = stack.back().second;
+		stack.pop_back();
+
+		int index = static_cast<int>( m_Transforms.size() );
+
+		if ( parent == 0 )
+			subtrees.push_back( index );
+		AddObject( pNode, nullptr, &pNode->Transform, parent );
+
+		for ( auto pEntity : pNode->Leafs() ) {
+			if ( pEntity ) AddObject( nullptr, pEntity, &pEntity->Transform, index );
+		}
+
+		const std::vector<Node3D*>& nodes = pNode->Nodes();
+
+		for ( auto it = nodes.rbegin(); it != nodes.rend(); it++ ) {
+			if ( *it ) stack.push_back( std::make_pair( *it, index ) );
+		}
+	}
+
+	// Each subtree is a contiguous range as well, which ends where the last of
+	// its descendants does.
+
+	unsigned int count = static_cast<unsigned int>( m_Transforms.size() );
+	m_SubtreeEnds.resize( count );
+
+	for ( unsigned int i = count; i-- > 0; )
+	{
+		m_SubtreeEnds[i] = std::max( m_SubtreeEnds[i], i + 1 );
+
+		if ( m_ParentIndices[i] >= 0 )
+			m_SubtreeEnds[m_ParentIndices[i]] = std::max( m_SubtreeEnds[m_ParentIndices[i]], m_SubtreeEnds[i] );
+	}
+
+	// Merge neighboring subtrees into batches for the parallel update.
+
+	m_uiHeadCount = subtrees.empty() ? count : subtrees.front();
+
+	for ( unsigned int i = 0; i < subtrees.size(); i++ )
+	{
+		unsigned int end = ( i + 1 < subtrees.size() ) ? subtrees[i+1] : count;
+
+		if ( !m_Batches.empty() && m_Batches.back().second - m_Batches.back().first < MinimumBatchSize )
+			m_Batches.back().second = end;
+		else
+			m_Batches.push_back( std::make_pair( subtrees[i], end ) );
+	}
+}
+//--------------------------------------------------------------------------------
+void TransformHierarchy::AddObject( Node3D* pNode, Entity3D* pEntity, Transform3D* pTransform, int parent )
+{
+	m_Nodes.push_back( pNode );
+	m_Entities.push_back( pEntity );
+	m_Transforms.push_back( pTransform );
+	m_ParentIndices.push_back( parent );
+}
+//--------------------------------------------------------------------------------
+void TransformHierarchy::Update( float time )
+{
+	m_uiUpdatedCount = 0;
+
+	if ( m_pRoot == nullptr )
+		return;
+
+	if ( m_pRoot->GetStructureRevision() != m_uiStructureRevision )
+		Build( m_pRoot );
+
+	const unsigned int count = static_cast<unsigned int>( m_Transforms.size() );
+	JobSystem* pJobs = JobSystem::Get();
+
+	if ( m_bParallel && pJobs && m_Batches.size() > 1 )
+	{
+		// The root has to be finished before any of the subtrees, since they all
+		// depend on its world matrix.
+
+		m_uiUpdatedCount = UpdateRange( 0, m_uiHeadCount, time );
+
+		std::atomic<unsigned int> updated( 0 );
+
+		pJobs->ParallelFor( static_cast<unsigned int>( m_Batches.size() ), 1, 
+			[&]( unsigned int begin, unsigned int end )
+			{
+				for ( unsigned int i = begin; i < end; i++ )
+					updated += UpdateRange( m_Batches[i].first, m_Batches[i].second, time );
+			} );
+
+		m_uiUpdatedCount += updated;
+	}
+	else
+	{
+		m_uiUpdatedCount = UpdateRange( 0, count, time );
+	}
+
+	// Give the materials a chance to update themselves, as in Entity3D::Update.
+	// Materials can be shared between entities, so this is done serially.
+
+	for ( auto pEntity : m_Entities )
+	{
+		if ( pEntity && pEntity->Visual.Material != nullptr )
+			pEntity->Visual.Material->Update( time );
+	}
+}
+//--------------------------------------------------------------------------------
+unsigned int TransformHierarchy::UpdateRange( unsigned int begin, unsigned int end, float time )
+{
+	unsigned int updated = 0;
+
+	for ( unsigned int i = begin; i < end; i++ )
+	{
+		// Controllers may modify the transform, so they are updated first.  The
+		// local and world matrices are then only rebuilt if something changed.
+
+		Node3D* pNode = m_Nodes[i];
+		Entity3D* pEntity = m_Entities[i];
+
+		if ( pNode )
+			pNode->UpdateLocal( time );
+		else
+			pEntity->UpdateLocal( time );
+
+		int parent = m_ParentIndices[i];
+		Transform3D* pTransform = m_Transforms[i];
+
+		bool bChanged = ( parent < 0 ) 
+			? pTransform->UpdateWorld( ) 
+			: pTransform->UpdateWorld( *m_Transforms[parent] );
+
+		if ( bChanged )
+			updated++;
+	}
+
+	return( updated );
+}
+//--------------------------------------------------------------------------------
+void TransformHierarchy::UpdateBounds( )
+{
+	const unsigned int count = static_cast<unsigned int>( m_Transforms.size() );
+
+	// After the graph has been rebuilt, the indices refer to different objects,
+	// so everything is computed from scratch.
+
+	if ( !m_bBoundsValid )
+	{
+		m_Bounds.resize( count );
+		m_BoundsStates.assign( count, BoundsEmpty );
+		m_EntityCounts.assign( count, 0 );
+		m_BoundsRevisions.assign( count, 0 );
+		m_BoundsShapes.assign( count, -1 );
+		m_BoundsDirty.assign( count, 0 );
+	}
+
+	// Find the entities whose spheres have changed, and mark their ancestors.
+	// Marking stops at the first ancestor that is already marked, since all of
+	// the ones above it are as well.
+
+	m_DirtyNodes.clear();
+	m_ChangedEntities.clear();
+
+	for ( unsigned int i = 0; i < count; i++ )
+	{
+		Entity3D* pEntity = m_Entities[i];
+
+		if ( !pEntity )
+		{
+			if ( !m_bBoundsValid ) {
+				m_BoundsDirty[i] = 1;
+				m_DirtyNodes.push_back( i );
+			}
+			continue;
+		}
+
+		// Only entities with something to draw take part in culling.  Those
+		// without any shapes can't be bounded, so their ancestors can't be
+		// either.  The shapes of the others are still watched, since the 
+		// changed entities are also used for picking.
+
+		const unsigned int revision = m_Transforms[i]->GetRevision();
+		const int shapeCount = pEntity->Shape.GetNumberOfShapes();
+		const int shapes = ( pEntity->Visual.Executor != nullptr ) ? shapeCount : -1 - shapeCount;
+
+		if ( m_bBoundsValid && revision == m_BoundsRevisions[i] && shapes == m_BoundsShapes[i] )
+			continue;
+
+		m_BoundsRevisions[i] = revision;
+		m_BoundsShapes[i] = shapes;
+		m_ChangedEntities.push_back( pEntity );
+
+		if ( shapes < 0 )
+		{
+			m_EntityCounts[i] = 0;
+			m_BoundsStates[i] = BoundsEmpty;
+		}
+		else
+		{
+			m_EntityCounts[i] = 1;
+
+			if ( pEntity->Shape.GetBoundingSphere( m_Transforms[i]->WorldMatrix(), m_Bounds[i] ) )
+				m_BoundsStates[i] = BoundsSphere;
+			else
+				m_BoundsStates[i] = BoundsUnbounded;
+		}
+
+		for ( int parent = m_ParentIndices[i]; parent >= 0 && !m_BoundsDirty[parent]; parent = m_ParentIndices[parent] ) {
+			m_BoundsDirty[parent] = 1;
+			m_DirtyNodes.push_back( parent );
+		}
+	}
+
+	m_bBoundsValid = true;
+
+	// Children always appear after their parent, so merging the nodes from the
+	// back finishes each one before it is merged into its own parent.  The direct
+	// children of a node are found by skipping over the subtree of each one.
+
+	std::sort( m_DirtyNodes.begin(), m_DirtyNodes.end(), std::greater<unsigned int>() );
+
+	for ( auto node : m_DirtyNodes )
+	{
+		Sphere3f& bounds = m_Bounds[node];
+		unsigned char state = BoundsEmpty;
+		unsigned int entities = 0;
+
+		for ( unsigned int child = node + 1; child < m_SubtreeEnds[node]; child = m_SubtreeEnds[child] )
+		{
+			if ( m_BoundsStates[child] == BoundsEmpty )
+				continue;
+
+			entities += m_EntityCounts[child];
+
+			if ( state == BoundsEmpty ) {
+				bounds = m_Bounds[child];
+				state = m_BoundsStates[child];
+			}
+			else if ( state == BoundsSphere ) {
+				if ( m_BoundsStates[child] == BoundsSphere )
+					bounds.Merge( m_Bounds[child] );
+				else
+					state = BoundsUnbounded;
+			}
+		}
+
+		m_BoundsStates[node] = state;
+		m_EntityCounts[node] = entities;
+		m_BoundsDirty[node] = 0;
+
+		m_Nodes[node]->SetSubtreeBounds( bounds, state == BoundsSphere, entities );
+	}
+}
+//--------------------------------------------------------------------------------
+void TransformHierarchy::SetParallel( bool bParallel )
+{
+	m_bParallel = bParallel;
+}
+//--------------------------------------------------------------------------------
+bool TransformHierarchy::IsParallel( ) const
+{
+	return( m_bParallel );
+}
+//--------------------------------------------------------------------------------
+unsigned int TransformHierarchy::GetObjectCount( ) const
+{
+	return( static_cast<unsigned int>( m_Transforms.size() ) );
+}
+//--------------------------------------------------------------------------------
+unsigned int TransformHierarchy::GetUpdatedCount( ) const
+{
+	return( m_uiUpdatedCount );
+}
+//--------------------------------------------------------------------------------
+unsigned int TransformHierarchy::GetStructureRevision( ) const
+{
+	return( m_uiStructureRevision );
+}
+//--------------------------------------------------------------------------------
+const std::vector< Entity3D* >& TransformHierarchy::GetEntities( ) const
+{
+	return( m_Entities );
+}
+//--------------------------------------------------------------------------------
+const std::vector< Entity3D* >& TransformHierarchy::GetChangedEntities( ) const
+{
+	return( m_ChangedEntities );
+}
+//--------------------------------------------------------------------------------
@@ -28,6 +28,7 @@ VertexElementDX11::VertexElementDX11( int float_tuple, int elementCount )
 	m_iTuple = float_tuple;
 	m_iCount = elementCount;
 	m_pfData = new float[ m_iTuple * m_iCount ];
+	m_Packing = VertexPacking::None;
 }
 //--------------------------------------------------------------------------------
 VertexElementDX11::~VertexElementDX11()
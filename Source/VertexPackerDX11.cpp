@@ -0,0 +1,457 @@
+//--------------------------------------------------------------------------------
+// This file is a portion of the Hieroglyph 3 Rendering Engine.  It is distributed
+// under the MIT License, available in the root of this distribution and 
+// at the following URL:
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+// Copyright (c) Jason Zink 
+//--------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------
+#include "PCH.h"
+#include "VertexPackerDX11.h"
+#include "VertexElementDX11.h"
+//--------------------------------------------------------------------------------
+using namespace Glyph3;
+//--------------------------------------------------------------------------------
+static const float PaddingValues[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+//--------------------------------------------------------------------------------
+static bool IsIntegerFormat( DXGI_FORMAT format )
+{
+	switch ( format )
+	{
+	case DXGI_FORMAT_R32G32B32A32_UINT:
+	case DXGI_FORMAT_R32G32B32A32_SINT:
+	case DXGI_FORMAT_R32G32B32_UINT:
+	case DXGI_FORMAT_R32G32B32_SINT:
+	case DXGI_FORMAT_R32G32_UINT:
+	case DXGI_FORMAT_R32G32_SINT:
+	case DXGI_FORMAT_R32_UINT:
+	case DXGI_FORMAT_R32_SINT:
+		return( true );
+	default:
+		return( false );
+	}
+}
+//--------------------------------------------------------------------------------
+static bool IsSignedFormat( DXGI_FORMAT format )
+{
+	switch ( format )
+	{
+	case DXGI_FORMAT_R32G32B32A32_SINT:
+	case DXGI_FORMAT_R32G32B32_SINT:
+	case DXGI_FORMAT_R32G32_SINT:
+	case DXGI_FORMAT_R32_SINT:
+		return( true );
+	default:
+		return( false );
+	}
+}
+//--------------------------------------------------------------------------------
+static float Clamp( float value, float low, float high )
+{
+	return( value < low ? low : ( value > high ? high : value ) );
+}
+//--------------------------------------------------------------------------------
+static float SignNotZero( float value )
+{
+	return( value >= 0.0f ? 1.0f : -1.0f );
+}
+//--------------------------------------------------------------------------------
+VertexPackerDX11::VertexPackerDX11()
+{
+}
+//--------------------------------------------------------------------------------
+VertexPacking VertexPackerDX11::GetDefaultPacking( const std::string& semantic )
+{
+	if ( semantic == VertexElementDX11::PositionSemantic )
+		return( VertexPacking::HalfFloat );
+
+	if ( semantic == VertexElementDX11::NormalSemantic || semantic == VertexElementDX11::TangentSemantic )
+		return( VertexPacking::Octahedral );
+
+	if ( semantic == VertexElementDX11::TexCoordSemantic )
+		return( VertexPacking::UNorm16 );
+
+	if ( semantic == VertexElementDX11::BoneWeightSemantic )
+		return( VertexPacking::UNorm8 );
+
+	if ( semantic == VertexElementDX11::BoneIDSemantic )
+		return( VertexPacking::SInt8 );
+
+	return( VertexPacking::None );
+}
+//--------------------------------------------------------------------------------
+bool VertexPackerDX11::CanPack( VertexElementDX11* pElement, VertexPacking packing )
+{
+	if ( pElement->m_InputSlotClass != D3D11_INPUT_PER_VERTEX_DATA )
+		return( packing == VertexPacking::None );
+
+	const int tuple = pElement->Tuple();
+	const int count = pElement->Tuple() * pElement->Count();
+	const bool bInteger = IsIntegerFormat( pElement->m_Format );
+	const bool bSigned = IsSignedFormat( pElement->m_Format );
+
+	// Integer data is only allowed to be packed as integers of the same
+	// signedness, so that the shader input type doesn't change.  The other
+	// packings check that every value lies within their range.
+
+	if ( bInteger != ( packing == VertexPacking::UInt8 || packing == VertexPacking::SInt8 ) )
+		return( packing == VertexPacking::None );
+
+	if ( bInteger && bSigned != ( packing == VertexPacking::SInt8 ) )
+		return( false );
+
+	switch ( packing )
+	{
+	case VertexPacking::None:
+		return( true );
+
+	case VertexPacking::HalfFloat:
+		for ( int i = 0; i < count; i++ ) {
+			const float value = *pElement->Get1f( i );
+			if ( !( fabsf( value ) <= 65504.0f ) )
+				return( false );
+		}
+		return( true );
+
+	case VertexPacking::Octahedral:
+		return( tuple == 3 );
+
+	case VertexPacking::UNorm16:
+	case VertexPacking::UNorm8:
+		for ( int i = 0; i < count; i++ ) {
+			const float value = *pElement->Get1f( i );
+			if ( !( value >= 0.0f && value <= 1.0f ) )
+				return( false );
+		}
+		return( true );
+
+	case VertexPacking::UInt8:
+		for ( int i = 0; i < count; i++ ) {
+			const int value = *pElement->Get1i( i );
+			if ( value < 0 || value > 255 )
+				return( false );
+		}
+		return( true );
+
+	case VertexPacking::SInt8:
+		for ( int i = 0; i < count; i++ ) {
+			const int value = *pElement->Get1i( i );
+			if ( value < -128 || value > 127 )
+				return( false );
+		}
+		return( true );
+	}
+
+	return( false );
+}
+//--------------------------------------------------------------------------------
+DXGI_FORMAT VertexPackerDX11::GetFormat( VertexElementDX11* pElement, VertexPacking packing )
+{
+	const bool bWide = pElement->Tuple() > 2;
+
+	switch ( packing )
+	{
+	case VertexPacking::HalfFloat:
+		return( bWide ? DXGI_FORMAT_R16G16B16A16_FLOAT : DXGI_FORMAT_R16G16_FLOAT );
+	case VertexPacking::Octahedral:
+		return( DXGI_FORMAT_R16G16_SNORM );
+	case VertexPacking::UNorm16:
+		return( bWide ? DXGI_FORMAT_R16G16B16A16_UNORM : DXGI_FORMAT_R16G16_UNORM );
+	case VertexPacking::UNorm8:
+		return( DXGI_FORMAT_R8G8B8A8_UNORM );
+	case VertexPacking::UInt8:
+		return( DXGI_FORMAT_R8G8B8A8_UINT );
+	case VertexPacking::SInt8:
+		return( DXGI_FORMAT_R8G8B8A8_SINT );
+	default:
+		return( pElement->m_Format );
+	}
+}
+//--------------------------------------------------------------------------------
+unsigned int VertexPackerDX11::GetSize( VertexElementDX11* pElement, VertexPacking packing )
+{
+	const bool bWide = pElement->Tuple() > 2;
+
+	switch ( packing )
+	{
+	case VertexPacking::HalfFloat:
+	case VertexPacking::UNorm16:
+		return( bWide ? 8 : 4 );
+	case VertexPacking::Octahedral:
+	case VertexPacking::UNorm8:
+	case VertexPacking::UInt8:
+	case VertexPacking::SInt8:
+		return( 4 );
+	default:
+		return( pElement->SizeInBytes() );
+	}
+}
+//--------------------------------------------------------------------------------
+void VertexPackerDX11::Pack( VertexElementDX11* pElement, VertexPacking packing, int vertex, void* pDest )
+{
+	const int tuple = pElement->Tuple();
+	const float* pSource = ( *pElement )[vertex];
+
+	switch ( packing )
+	{
+	case VertexPacking::HalfFloat:
+		{
+			unsigned short* pOut = reinterpret_cast<unsigned short*>( pDest );
+			const int components = ( tuple > 2 ) ? 4 : 2;
+			for ( int i = 0; i < components; i++ )
+				pOut[i] = FloatToHalf( i < tuple ? pSource[i] : PaddingValues[i] );
+		}
+		break;
+
+	case VertexPacking::Octahedral:
+		EncodeOctahedral( pSource, reinterpret_cast<short*>( pDest ) );
+		break;
+
+	case VertexPacking::UNorm16:
+		{
+			unsigned short* pOut = reinterpret_cast<unsigned short*>( pDest );
+			const int components = ( tuple > 2 ) ? 4 : 2;
+			for ( int i = 0; i < components; i++ ) {
+				const float value = Clamp( i < tuple ? pSource[i] : PaddingValues[i], 0.0f, 1.0f );
+				pOut[i] = static_cast<unsigned short>( value * 65535.0f + 0.5f );
+			}
+		}
+		break;
+
+	case VertexPacking::UNorm8:
+		{
+			unsigned char* pOut = reinterpret_cast<unsigned char*>( pDest );
+			for ( int i = 0; i < 4; i++ ) {
+				const float value = Clamp( i < tuple ? pSource[i] : PaddingValues[i], 0.0f, 1.0f );
+				pOut[i] = static_cast<unsigned char>( value * 255.0f + 0.5f );
+			}
+		}
+		break;
+
+	case VertexPacking::UInt8:
+		{
+			const int* pIntegers = reinterpret_cast<const int*>( pSource );
+			unsigned char* pOut = reinterpret_cast<unsigned char*>( pDest );
+			for ( int i = 0; i < 4; i++ )
+				pOut[i] = static_cast<unsigned char>( i < tuple ? pIntegers[i] : static_cast<int>( PaddingValues[i] ) );
+		}
+		break;
+
+	case VertexPacking::SInt8:
+		{
+			const int* pIntegers = reinterpret_cast<const int*>( pSource );
+			signed char* pOut = reinterpret_cast<signed char*>( pDest );
+			for ( int i = 0; i < 4; i++ )
+				pOut[i] = static_cast<signed char>( i < tuple ? pIntegers[i] : static_cast<int>( PaddingValues[i] ) );
+		}
+		break;
+
+	default:
+		memcpy( pDest, pSource, pElement->SizeInBytes() );
+		break;
+	}
+}
+//--------------------------------------------------------------------------------
+void VertexPackerDX11::Unpack( const void* pSource, VertexPacking packing, int tuple, float* pDest )
+{
+	switch ( packing )
+	{
+	case VertexPacking::HalfFloat:
+		for ( int i = 0; i < tuple; i++ )
+			pDest[i] = HalfToFloat( reinterpret_cast<const unsigned short*>( pSource )[i] );
+		break;
+
+	case VertexPacking::Octahedral:
+		DecodeOctahedral( reinterpret_cast<const short*>( pSource ), pDest );
+		break;
+
+	case VertexPacking::UNorm16:
+		for ( int i = 0; i < tuple; i++ )
+			pDest[i] = reinterpret_cast<const unsigned short*>( pSource )[i] / 65535.0f;
+		break;
+
+	case VertexPacking::UNorm8:
+		for ( int i = 0; i < tuple; i++ )
+			pDest[i] = reinterpret_cast<const unsigned char*>( pSource )[i] / 255.0f;
+		break;
+
+	case VertexPacking::UInt8:
+		for ( int i = 0; i < tuple; i++ )
+			reinterpret_cast<int*>( pDest )[i] = reinterpret_cast<const unsigned char*>( pSource )[i];
+		break;
+
+	case VertexPacking::SInt8:
+		for ( int i = 0; i < tuple; i++ )
+			reinterpret_cast<int*>( pDest )[i] = reinterpret_cast<const signed char*>( pSource )[i];
+		break;
+
+	default:
+		memcpy( pDest, pSource, sizeof( float ) * tuple );
+		break;
+	}
+}
+//--------------------------------------------------------------------------------
+float VertexPackerDX11::MeasureError( VertexElementDX11* pElement, VertexPacking packing )
+{
+	const int tuple = pElement->Tuple();
+	float maxError = 0.0f;
+
+	unsigned char packed[16];
+	float unpacked[4];
+
+	for ( int v = 0; v < pElement->Count(); v++ )
+	{
+		const float* pSource = ( *pElement )[v];
+
+		Pack( pElement, packing, v, packed );
+		Unpack( packed, packing, tuple, unpacked );
+
+		if ( packing == VertexPacking::Octahedral )
+		{
+			const float length = sqrtf( pSource[0] * pSource[0] + pSource[1] * pSource[1] + pSource[2] * pSource[2] );
+
+			if ( length > 0.0f ) {
+				float cosine = ( pSource[0] * unpacked[0] + pSource[1] * unpacked[1] + pSource[2] * unpacked[2] ) / length;
+				maxError = std::max( maxError, acosf( Clamp( cosine, -1.0f, 1.0f ) ) );
+			}
+		}
+		else if ( packing == VertexPacking::UInt8 || packing == VertexPacking::SInt8 )
+		{
+			const int* pIntegers = reinterpret_cast<const int*>( pSource );
+			const int* pUnpacked = reinterpret_cast<const int*>( unpacked );
+
+			for ( int i = 0; i < tuple; i++ )
+				maxError = std::max( maxError, static_cast<float>( abs( pIntegers[i] - pUnpacked[i] ) ) );
+		}
+		else
+		{
+			for ( int i = 0; i < tuple; i++ )
+				maxError = std::max( maxError, fabsf( pSource[i] - unpacked[i] ) );
+		}
+	}
+
+	return( maxError );
+}
+//--------------------------------------------------------------------------------
+unsigned short VertexPackerDX11::FloatToHalf( float value )
+{
+	unsigned int bits;
+	memcpy( &bits, &value, sizeof( bits ) );
+
+	const unsigned int sign = ( bits >> 16 ) & 0x8000;
+	const unsigned int magnitude = bits & 0x7fffffff;
+
+	// NaN stays a NaN, and anything too large for a half becomes infinity.
+	if ( magnitude > 0x7f800000 )
+		return( static_cast<unsigned short>( sign | 0x7e00 ) );
+
+	if ( magnitude >= 0x477ff000 )
+		return( static_cast<unsigned short>( sign | 0x7c00 ) );
+
+	// Values below the smallest normal half are stored as denormals, which are
+	// found by rounding the value scaled up to the denormal step size.
+	if ( magnitude < 0x38800000 )
+	{
+		float scaled;
+		unsigned int absolute = magnitude;
+		memcpy( &scaled, &absolute, sizeof( scaled ) );
+
+		const float denormal = scaled * 16777216.0f;
+		unsigned int result = static_cast<unsigned int>( denormal );
+		const float remainder = denormal - static_cast<float>( result );
+
+		if ( remainder > 0.5f || ( remainder == 0.5f && ( result & 1 ) ) )
+			result++;
+
+		return( static_cast<unsigned short>( sign | result ) );
+	}
+
+	// Rebias the exponent and round the mantissa to nearest even.
+	const unsigned int rebased = magnitude - 0x38000000;
+	const unsigned int rounding = 0x0fff + ( ( rebased >> 13 ) & 1 );
+
+	return( static_cast<unsigned short>( sign | ( ( rebased + rounding ) >> 13 ) ) );
+}
+//--------------------------------------------------------------------------------
+float VertexPackerDX11::HalfToFloat( unsigned short value )
+{
+	const unsigned int sign = ( value & 0x8000 ) << 16;
+	const unsigned int exponent = ( value >> 10 ) & 0x1f;
+	const unsigned int mantissa = value & 0x3ff;
+
+	unsigned int bits;
+
+	if ( exponent == 0x1f )
+	{
+		bits = sign | 0x7f800000 | ( mantissa << 13 );
+	}
+	else if ( exponent == 0 )
+	{
+		// Zero or a denormal, which is converted through a float multiply.
+		float result = static_cast<float>( mantissa ) / 16777216.0f;
+		return( sign ? -result : result );
+	}
+	else
+	{
+		bits = sign | ( ( exponent + 112 ) << 23 ) | ( mantissa << 13 );
+	}
+
+	float result;
+	memcpy( &result, &bits, sizeof( result ) );
+
+	return( result );
+}
+//--------------------------------------------------------------------------------
+void VertexPackerDX11::EncodeOctahedral( const float* pVector, short* pEncoded )
+{
+	// Project onto the octahedron |x| + |y| + |z| = 1, then fold the lower
+	// half over the diagonals so that the whole sphere maps to a square.
+
+	const float sum = fabsf( pVector[0] ) + fabsf( pVector[1] ) + fabsf( pVector[2] );
+
+	float x = 0.0f;
+	float y = 0.0f;
+
+	if ( sum > 0.0f ) {
+		x = pVector[0] / sum;
+		y = pVector[1] / sum;
+
+		if ( pVector[2] < 0.0f ) {
+			const float foldedX = ( 1.0f - fabsf( y ) ) * SignNotZero( x );
+			const float foldedY = ( 1.0f - fabsf( x ) ) * SignNotZero( y );
+			x = foldedX;
+			y = foldedY;
+		}
+	}
+
+	const float encoded[2] = { x, y };
+
+	for ( int i = 0; i < 2; i++ )
+	{
+		const float scaled = Clamp( encoded[i], -1.0f, 1.0f ) * 32767.0f;
+		pEncoded[i] = static_cast<short>( scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f );
+	}
+}
+//--------------------------------------------------------------------------------
+void VertexPackerDX11::DecodeOctahedral( const short* pEncoded, float* pVector )
+{
+	// Matches the decoding that the shader performs on the snorm values.
+
+	float x = std::max( pEncoded[0] / 32767.0f, -1.0f );
+	float y = std::max( pEncoded[1] / 32767.0f, -1.0f );
+	const float z = 1.0f - fabsf( x ) - fabsf( y );
+	const float t = Clamp( -z, 0.0f, 1.0f );
+
+	x += ( x >= 0.0f ) ? -t : t;
+	y += ( y >= 0.0f ) ? -t : t;
+
+	const float length = sqrtf( x * x + y * y + z * z );
+
+	pVector[0] = x / length;
+	pVector[1] = y / length;
+	pVector[2] = z / length;
+}
+//--------------------------------------------------------------------------------
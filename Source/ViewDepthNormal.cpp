@@ -75,7 +75,7 @@ void ViewDepthNormal::ExecuteTask( PipelineManagerDX11* pPipelineManager, IParam
 		SetRenderParams( pParamManager );
 
 		// Run through the graph and render each of the entities
-		m_pScene->GetRoot()->Render( pPipelineManager, pParamManager, VT_LINEAR_DEPTH_NORMAL );
+		RenderScene( pPipelineManager, pParamManager, VT_LINEAR_DEPTH_NORMAL );
 	}
 }
 //--------------------------------------------------------------------------------
@@ -145,18 +145,6 @@ void ViewHighDynamicRange::ExecuteTask( PipelineManagerDX11* pPipelineManager, I
 {
 	if ( m_pScene )
 	{
-		// Acquire the list of entities to be included in this rendering pass.
-
-		std::vector<Entity3D*> entity_list;
-		GetAllEntities( m_pScene->GetRoot(), entity_list );
-
-		auto const transparent_check = []( Entity3D* entity) { 
-			return entity->Visual.iPass != Renderable::ALPHA;
-		};
-
-		// We use stable partition to sort, and return the first transparent entity.
-		auto const iter_first_alpha = std::stable_partition( begin( entity_list ), end( entity_list ), transparent_check );
-
 		// Render the scene into the floating point buffer.  This captures all
 		// of the light in the floating point format.
 		// Set the parameters for rendering this view
@@ -183,10 +171,8 @@ void ViewHighDynamicRange::ExecuteTask( PipelineManagerDX11* pPipelineManager, I
 		pPipelineManager->ClearPipelineResources();
 
 
-		// Now we can render all entities in the sorted order.
-		for ( auto& entity : entity_list ) {
-			entity->Render( pPipelineManager, pParamManager, VT_PERSPECTIVE );
-		}
+		// Render all of the entities, sorted by the render queue.
+		RenderScene( pPipelineManager, pParamManager, VT_PERSPECTIVE );
 
 		pPipelineManager->ClearRenderTargets();
 		pPipelineManager->ApplyRenderTargets();